@@ -168,6 +168,15 @@ if(CMAKE_COMPILER_IS_GNUCXX)
       endif()
     endif()
 
+    # sources named *.avx2.cpp are compiled with these flags and called only
+    # when the CPU reports AVX2 and FMA3 support (see ocv_glob_module_sources)
+    if(ENABLE_AVX2_DISPATCH AND NOT ENABLE_AVX2)
+      ocv_check_flag_support(CXX "-mavx2 -mfma" _varname "${OPENCV_EXTRA_CXX_FLAGS}")
+      if(${_varname})
+        set(OPENCV_AVX2_DISPATCH_FLAGS "-mavx2 -mfma")
+      endif()
+    endif()
+
     # GCC depresses SSEx instructions when -mavx is used. Instead, it generates new AVX instructions or AVX equivalence for all SSEx instructions when needed.
     if(NOT OPENCV_EXTRA_CXX_FLAGS MATCHES "-mavx")
       if(ENABLE_SSE3)
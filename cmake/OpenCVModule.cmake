@@ -624,6 +624,21 @@ macro(ocv_glob_module_sources)
   file(GLOB_RECURSE lib_srcs
        "${CMAKE_CURRENT_LIST_DIR}/src/*.cpp"
   )
+
+  # optimized code paths selected at runtime
+  file(GLOB_RECURSE lib_srcs_avx2
+       "${CMAKE_CURRENT_LIST_DIR}/src/*.avx2.cpp"
+  )
+  if(lib_srcs_avx2)
+    if(OPENCV_AVX2_DISPATCH_FLAGS)
+      set_source_files_properties(${lib_srcs_avx2} PROPERTIES COMPILE_FLAGS "${OPENCV_AVX2_DISPATCH_FLAGS}")
+      add_definitions(-DCV_TRY_AVX2=1)
+    elseif(ENABLE_AVX2)
+      add_definitions(-DCV_TRY_AVX2=1)
+    else()
+      list(REMOVE_ITEM lib_srcs ${lib_srcs_avx2})
+    endif()
+  endif()
   file(GLOB_RECURSE lib_int_hdrs
        "${CMAKE_CURRENT_LIST_DIR}/src/*.hpp"
        "${CMAKE_CURRENT_LIST_DIR}/src/*.h"
@@ -1026,12 +1041,30 @@ function(ocv_add_accuracy_tests)
         set(OPENCV_TEST_${the_module}_SOURCES ${test_srcs} ${test_hdrs})
       endif()
 
+      # tests of the instruction sets selected at runtime, built like the src/*.avx2.cpp sources
+      set(test_try_avx2 0)
+      file(GLOB_RECURSE test_srcs_avx2 "${test_path}/*.avx2.cpp")
+      if(test_srcs_avx2)
+        if(OPENCV_AVX2_DISPATCH_FLAGS)
+          set_source_files_properties(${test_srcs_avx2} PROPERTIES COMPILE_FLAGS "${OPENCV_AVX2_DISPATCH_FLAGS}")
+          set(test_try_avx2 1)
+        elseif(ENABLE_AVX2)
+          set(test_try_avx2 1)
+        else()
+          list(REMOVE_ITEM OPENCV_TEST_${the_module}_SOURCES ${test_srcs_avx2})
+          set(test_try_avx2 0)
+        endif()
+      endif()
+
       if(NOT BUILD_opencv_world)
         get_native_precompiled_header(${the_target} test_precomp.hpp)
       endif()
 
       ocv_add_executable(${the_target} ${OPENCV_TEST_${the_module}_SOURCES} ${${the_target}_pch})
       ocv_target_include_modules(${the_target} ${test_deps} "${test_path}")
+      if(test_try_avx2)
+        set_property(TARGET ${the_target} APPEND PROPERTY COMPILE_DEFINITIONS CV_TRY_AVX2=1)
+      endif()
       ocv_target_link_libraries(${the_target} ${test_deps} ${OPENCV_MODULE_${the_module}_DEPS} ${OPENCV_LINKER_LIBS})
       add_dependencies(opencv_tests ${the_target})
 
@@ -1574,6 +1574,17 @@ public:
     CV_WRAP virtual int getMode() const = 0;
     CV_WRAP virtual void setMode(int mode) = 0;
 
+    /** @brief Restricts the computation to a region of the left image.
+
+    When a non-empty ROI is set, compute() processes only the part of the stereo pair needed for
+    it (the ROI extended by the block size and by the disparity search range), and the disparity
+    outside of the ROI is set to (minDisparity-1)\*16. Since the smoothness paths start at the
+    boundary of the processed area, the result inside the ROI may slightly differ from the
+    full-image one near the ROI borders. Pass an empty rectangle to process the whole image.
+     */
+    CV_WRAP virtual Rect getROI() const = 0;
+    CV_WRAP virtual void setROI(Rect roi) = 0;
+
     /** @brief Creates StereoSGBM object
 
     @param minDisparity Minimum possible disparity value. Normally, it is zero but sometimes
@@ -1604,8 +1615,10 @@ public:
     filtering, set the parameter to a positive value, it will be implicitly multiplied by 16.
     Normally, 1 or 2 is good enough.
     @param mode Set it to StereoSGBM::MODE_HH to run the full-scale two-pass dynamic programming
-    algorithm. It will consume O(W\*H\*numDisparities) bytes, which is large for 640x480 stereo and
-    huge for HD-size pictures. By default, it is set to false .
+    algorithm. It will consume O(W\*H\*numDisparities) bytes (three 16-bit cost volumes), which is
+    large for 640x480 stereo and huge for HD-size pictures. This mode runs in parallel. The buffers are
+    kept between the calls, so processing a sequence of frames of the same size does not reallocate
+    them. By default, it is set to false .
 
     The first constructor initializes StereoSGBM with all the default parameters. So, you only have to
     set StereoSGBM::numDisparities at minimum. The second constructor enables you to set each parameter
@@ -370,6 +370,8 @@ protected:
     }
 
 
+    bool isThreadSafe() const { return true; }
+
     void computeError( InputArray _m1, InputArray _m2, InputArray _model, OutputArray _err ) const
     {
         Mat X1 = _m1.getMat(), X2 = _m2.getMat(), model = _model.getMat();
@@ -41,6 +41,8 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/hal.hpp"
+#include "opencv2/hal/intrin.hpp"
 #include "rho.h"
 #include <iostream>
 
@@ -70,6 +72,73 @@ static bool haveCollinearPoints( const Mat& m, int count )
 }
 
 
+// Normalizes the points of a sample and computes the 9x9 normal matrix of the DLT system, storing
+// its element (j, k) at LtL[(j*9 + k)*step]. T receives the normalization of m1 and the inverse
+// normalization of m2 as 3x3 matrices. Returns false for degenerate samples.
+static bool computeNormalEquations( const Mat& m1, const Mat& m2, double* LtL, int step, double* T )
+{
+    int i, j, k, count = m1.checkVector(2);
+    const Point2f* M = m1.ptr<Point2f>();
+    const Point2f* m = m2.ptr<Point2f>();
+    Point2d cM(0,0), cm(0,0), sM(0,0), sm(0,0);
+
+    for( i = 0; i < count; i++ )
+    {
+        cm.x += m[i].x; cm.y += m[i].y;
+        cM.x += M[i].x; cM.y += M[i].y;
+    }
+
+    cm.x /= count;
+    cm.y /= count;
+    cM.x /= count;
+    cM.y /= count;
+
+    for( i = 0; i < count; i++ )
+    {
+        sm.x += fabs(m[i].x - cm.x);
+        sm.y += fabs(m[i].y - cm.y);
+        sM.x += fabs(M[i].x - cM.x);
+        sM.y += fabs(M[i].y - cM.y);
+    }
+
+    if( fabs(sm.x) < DBL_EPSILON || fabs(sm.y) < DBL_EPSILON ||
+        fabs(sM.x) < DBL_EPSILON || fabs(sM.y) < DBL_EPSILON )
+        return false;
+    sm.x = count/sm.x; sm.y = count/sm.y;
+    sM.x = count/sM.x; sM.y = count/sM.y;
+
+    double Hnorm2[9] = { sM.x, 0, -cM.x*sM.x, 0, sM.y, -cM.y*sM.y, 0, 0, 1 };
+    double invHnorm[9] = { 1./sm.x, 0, cm.x, 0, 1./sm.y, cm.y, 0, 0, 1 };
+    std::copy(Hnorm2, Hnorm2 + 9, T);
+    std::copy(invHnorm, invHnorm + 9, T + 9);
+
+    double A[9][9] = {{0}};
+    for( i = 0; i < count; i++ )
+    {
+        double x = (m[i].x - cm.x)*sm.x, y = (m[i].y - cm.y)*sm.y;
+        double X = (M[i].x - cM.x)*sM.x, Y = (M[i].y - cM.y)*sM.y;
+        double Lx[] = { X, Y, 1, 0, 0, 0, -x*X, -x*Y, -x };
+        double Ly[] = { 0, 0, 0, X, Y, 1, -y*X, -y*Y, -y };
+        for( j = 0; j < 9; j++ )
+            for( k = j; k < 9; k++ )
+                A[j][k] += Lx[j]*Lx[k] + Ly[j]*Ly[k];
+    }
+    for( j = 0; j < 9; j++ )
+        for( k = 0; k < 9; k++ )
+            LtL[(j*9 + k)*step] = j <= k ? A[j][k] : A[k][j];
+    return true;
+}
+
+// undoes the normalization of the solution h0 (element j at h0[j*step]) and scales it so that H(2,2) = 1
+static void computeHomography( const double* h0, int step, const double* T, OutputArray _model )
+{
+    Matx33d H0, Hnorm2(T), invHnorm(T + 9);
+    for( int j = 0; j < 9; j++ )
+        H0.val[j] = h0[j*step];
+    Matx33d H = invHnorm*H0*Hnorm2;
+    Mat(H*(1./H(2,2))).copyTo(_model);
+}
+
 class HomographyEstimatorCallback : public PointSetRegistrator::Callback
 {
 public:
@@ -112,71 +181,49 @@ public:
 
     int runKernel( InputArray _m1, InputArray _m2, OutputArray _model ) const
     {
-        Mat m1 = _m1.getMat(), m2 = _m2.getMat();
-        int i, count = m1.checkVector(2);
-        const Point2f* M = m1.ptr<Point2f>();
-        const Point2f* m = m2.ptr<Point2f>();
-
-        double LtL[9][9], W[9][1], V[9][9];
+        double LtL[9][9], W[9][1], V[9][9], T[18];
         Mat _LtL( 9, 9, CV_64F, &LtL[0][0] );
         Mat matW( 9, 1, CV_64F, W );
         Mat matV( 9, 9, CV_64F, V );
-        Mat _H0( 3, 3, CV_64F, V[8] );
-        Mat _Htemp( 3, 3, CV_64F, V[7] );
-        Point2d cM(0,0), cm(0,0), sM(0,0), sm(0,0);
 
-        for( i = 0; i < count; i++ )
-        {
-            cm.x += m[i].x; cm.y += m[i].y;
-            cM.x += M[i].x; cM.y += M[i].y;
-        }
+        if( !computeNormalEquations( _m1.getMat(), _m2.getMat(), &LtL[0][0], 1, T ) )
+            return 0;
+        eigen( _LtL, matW, matV );
+        computeHomography( V[8], 1, T, _model );
+        return 1;
+    }
 
-        cm.x /= count;
-        cm.y /= count;
-        cM.x /= count;
-        cM.y /= count;
+    void runKernels( const Mat* ms1, const Mat* ms2, int count, Mat* models, int* nmodels ) const
+    {
+        // the 9x9 systems of the samples are stored as structure of arrays and solved together,
+        // hal::eigenBatch puts one sample into each SIMD lane
+        AutoBuffer<double> _buf(count*(81*2 + 9 + 18));
+        AutoBuffer<int> _idx(count);
+        double *LtL = _buf, *V = LtL + count*81, *W = V + count*81, *T = W + count*9;
+        int* idx = _idx;
+        int i, n = 0;
 
         for( i = 0; i < count; i++ )
         {
-            sm.x += fabs(m[i].x - cm.x);
-            sm.y += fabs(m[i].y - cm.y);
-            sM.x += fabs(M[i].x - cM.x);
-            sM.y += fabs(M[i].y - cM.y);
+            nmodels[i] = 0;
+            if( computeNormalEquations( ms1[i], ms2[i], LtL + n, count, T + n*18 ) )
+                idx[n++] = i;
         }
+        if( n == 0 )
+            return;
 
-        if( fabs(sm.x) < DBL_EPSILON || fabs(sm.y) < DBL_EPSILON ||
-            fabs(sM.x) < DBL_EPSILON || fabs(sM.y) < DBL_EPSILON )
-            return 0;
-        sm.x = count/sm.x; sm.y = count/sm.y;
-        sM.x = count/sM.x; sM.y = count/sM.y;
-
-        double invHnorm[9] = { 1./sm.x, 0, cm.x, 0, 1./sm.y, cm.y, 0, 0, 1 };
-        double Hnorm2[9] = { sM.x, 0, -cM.x*sM.x, 0, sM.y, -cM.y*sM.y, 0, 0, 1 };
-        Mat _invHnorm( 3, 3, CV_64FC1, invHnorm );
-        Mat _Hnorm2( 3, 3, CV_64FC1, Hnorm2 );
-
-        _LtL.setTo(Scalar::all(0));
-        for( i = 0; i < count; i++ )
+        size_t step = count*sizeof(double);
+        hal::eigenBatch( LtL, step, 9, W, step, V, step, n );
+        for( i = 0; i < n; i++ )
         {
-            double x = (m[i].x - cm.x)*sm.x, y = (m[i].y - cm.y)*sm.y;
-            double X = (M[i].x - cM.x)*sM.x, Y = (M[i].y - cM.y)*sM.y;
-            double Lx[] = { X, Y, 1, 0, 0, 0, -x*X, -x*Y, -x };
-            double Ly[] = { 0, 0, 0, X, Y, 1, -y*X, -y*Y, -y };
-            int j, k;
-            for( j = 0; j < 9; j++ )
-                for( k = j; k < 9; k++ )
-                    LtL[j][k] += Lx[j]*Lx[k] + Ly[j]*Ly[k];
+            // the eigenvector of the smallest eigenvalue
+            computeHomography( V + 8*9*count + i, count, T + i*18, models[idx[i]] );
+            nmodels[idx[i]] = 1;
         }
-        completeSymm( _LtL );
-
-        eigen( _LtL, matW, matV );
-        _Htemp = _invHnorm*_H0;
-        _H0 = _Htemp*_Hnorm2;
-        _H0.convertTo(_model, _H0.type(), 1./_H0.at<double>(2,2) );
-
-        return 1;
     }
 
+    bool isThreadSafe() const { return true; }
+
     void computeError( InputArray _m1, InputArray _m2, InputArray _model, OutputArray _err ) const
     {
         Mat m1 = _m1.getMat(), m2 = _m2.getMat(), model = _model.getMat();
@@ -189,7 +236,27 @@ public:
         _err.create(count, 1, CV_32F);
         float* err = _err.getMat().ptr<float>();
 
-        for( i = 0; i < count; i++ )
+        i = 0;
+#if CV_SIMD128
+        v_float32x4 h0 = v_setall_f32(Hf[0]), h1 = v_setall_f32(Hf[1]), h2 = v_setall_f32(Hf[2]);
+        v_float32x4 h3 = v_setall_f32(Hf[3]), h4 = v_setall_f32(Hf[4]), h5 = v_setall_f32(Hf[5]);
+        v_float32x4 h6 = v_setall_f32(Hf[6]), h7 = v_setall_f32(Hf[7]), one = v_setall_f32(1.f);
+        for( ; i <= count - 4; i += 4 )
+        {
+            // two zips split 4 interleaved points into the x and y coordinates
+            v_float32x4 X, Y, x, y, t0, t1;
+            v_zip(v_load(&M[i].x), v_load(&M[i+2].x), t0, t1);
+            v_zip(t0, t1, X, Y);
+            v_zip(v_load(&m[i].x), v_load(&m[i+2].x), t0, t1);
+            v_zip(t0, t1, x, y);
+
+            v_float32x4 ww = one/(h6*X + h7*Y + one);
+            v_float32x4 dx = (h0*X + h1*Y + h2)*ww - x;
+            v_float32x4 dy = (h3*X + h4*Y + h5)*ww - y;
+            v_store(err + i, dx*dx + dy*dy);
+        }
+#endif
+        for( ; i < count; i++ )
         {
             float ww = 1.f/(Hf[6]*M[i].x + Hf[7]*M[i].y + 1.f);
             float dx = (Hf[0]*M[i].x + Hf[1]*M[i].y + Hf[2])*ww - m[i].x;
@@ -669,6 +736,8 @@ public:
         return n;
     }
 
+    bool isThreadSafe() const { return true; }
+
     void computeError( InputArray _m1, InputArray _m2, InputArray _model, OutputArray _err ) const
     {
         Mat __m1 = _m1.getMat(), __m2 = _m2.getMat(), __model = _model.getMat();
@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/hal.hpp"
 #include <stdio.h>
 
 /*
@@ -77,6 +78,9 @@
 namespace cv
 {
 
+// the largest relative error of the Cholesky solution, estimated as cond(Ap)*DBL_EPSILON
+static const double LM_MAX_CHOLESKY_ERROR = 1e-8;
+
 class LMSolverImpl : public LMSolver
 {
 public:
@@ -130,7 +134,31 @@ public:
             A.copyTo(Ap);
             for( i = 0; i < lx; i++ )
                 Ap.at<double>(i, i) += lambda*D.at<double>(i);
-            solve(Ap, v, d, DECOMP_EIG);
+            // Cholesky solves the well-conditioned systems. When J is rank-deficient or nearly so
+            // and lambda is small or 0, it fails or loses precision: such systems are solved with
+            // the eigen decomposition. Ap keeps the inverse diagonal of the factor, whose spread
+            // bounds the condition number from below.
+            v.copyTo(d);
+            bool ok = hal::Cholesky(Ap.ptr<double>(), Ap.step, lx, d.ptr<double>(), d.step, 1);
+            if( ok )
+            {
+                double minDiag = DBL_MAX, maxDiag = 0;
+                for( i = 0; i < lx; i++ )
+                {
+                    double t = Ap.at<double>(i, i);
+                    minDiag = std::min(minDiag, t);
+                    maxDiag = std::max(maxDiag, t);
+                }
+                double cond = (maxDiag/minDiag)*(maxDiag/minDiag);
+                ok = cond*DBL_EPSILON < LM_MAX_CHOLESKY_ERROR;
+            }
+            if( !ok )
+            {
+                A.copyTo(Ap);
+                for( i = 0; i < lx; i++ )
+                    Ap.at<double>(i, i) += lambda*D.at<double>(i);
+                solve(Ap, v, d, DECOMP_EIG);
+            }
             subtract(x, d, xd);
             if( !cb->compute(xd, rd, noArray()) )
                 return -1;
@@ -61,6 +61,22 @@
 namespace cv
 {
 
+#if CV_TRY_AVX2
+// kernels from *.avx2.cpp, compiled with -mavx2 -mfma and selected at runtime
+namespace opt_AVX2
+{
+void aggregateRowHH(const short* C, short* S, const short* Lprev, const short* minLprev,
+                    short* Lcur, short* minLcur, int width1, int D, int P1, int P2);
+void aggregateRowHorzHH(const short* C, short* S, short* Lbuf,
+                        int width1, int D, int P1, int P2, int dx);
+}
+
+static inline bool useAVX2()
+{
+    return checkHardwareSupport(CV_CPU_AVX2) && checkHardwareSupport(CV_CPU_FMA3);
+}
+#endif
+
 int RANSACUpdateNumIters( double p, double ep, int modelPoints, int maxIters );
 
 class CV_EXPORTS LMSolver : public Algorithm
@@ -89,6 +105,16 @@ public:
         virtual int runKernel(InputArray m1, InputArray m2, OutputArray model) const = 0;
         virtual void computeError(InputArray m1, InputArray m2, InputArray model, OutputArray err) const = 0;
         virtual bool checkSubset(InputArray, InputArray, int) const { return true; }
+        // true if runKernel and computeError may be called concurrently from several threads;
+        // the hypotheses of the other callbacks are evaluated one by one
+        virtual bool isThreadSafe() const { return false; }
+        // runs the kernel on count samples at once, nmodels[i] receives what runKernel returns for
+        // the i-th one; a callback may override it to solve the samples together
+        virtual void runKernels(const Mat* ms1, const Mat* ms2, int count, Mat* models, int* nmodels) const
+        {
+            for( int i = 0; i < count; i++ )
+                nmodels[i] = runKernel(ms1[i], ms2[i], models[i]);
+        }
     };
 
     virtual void setCallback(const Ptr<PointSetRegistrator::Callback>& cb) = 0;
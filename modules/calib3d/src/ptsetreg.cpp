@@ -42,6 +42,8 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/hal.hpp"
+#include "opencv2/hal/intrin.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -73,6 +75,53 @@ int RANSACUpdateNumIters( double p, double ep, int modelPoints, int maxIters )
 }
 
 
+struct RANSACHypothesis
+{
+    RANSACHypothesis() : nmodels(0) {}
+
+    Mat ms1, ms2, model, err;
+    int nmodels;
+    Size modelSize;
+    std::vector<Mat> mask;
+    std::vector<int> goodCount;
+    std::vector<double> median;
+};
+
+class RANSACPointSetRegistrator;
+
+// estimates and scores the models of a batch of hypotheses
+class RANSACEvaluator : public ParallelLoopBody
+{
+public:
+    RANSACEvaluator( const RANSACPointSetRegistrator* _reg, const Mat& _m1, const Mat& _m2,
+                     std::vector<RANSACHypothesis>& _batch, int _bound )
+        : reg(_reg), m1(_m1), m2(_m2), batch(&_batch), bound(_bound) {}
+
+    void operator()( const Range& range ) const;
+
+protected:
+    const RANSACPointSetRegistrator* reg;
+    Mat m1, m2;
+    std::vector<RANSACHypothesis>* batch;
+    int bound;
+};
+
+// estimates the models of a batch of hypotheses and computes the median errors
+class LMeDSEvaluator : public ParallelLoopBody
+{
+public:
+    LMeDSEvaluator( const RANSACPointSetRegistrator* _reg, const Mat& _m1, const Mat& _m2,
+                    std::vector<RANSACHypothesis>& _batch )
+        : reg(_reg), m1(_m1), m2(_m2), batch(&_batch) {}
+
+    void operator()( const Range& range ) const;
+
+protected:
+    const RANSACPointSetRegistrator* reg;
+    Mat m1, m2;
+    std::vector<RANSACHypothesis>* batch;
+};
+
 class RANSACPointSetRegistrator : public PointSetRegistrator
 {
 public:
@@ -83,17 +132,30 @@ public:
         checkPartialSubsets = false;
     }
 
-    int findInliers( const Mat& m1, const Mat& m2, const Mat& model, Mat& err, Mat& mask, double thresh ) const
+    // marks the points with the error not above t*t and returns their number, the mask is preallocated
+    static int countInliers( const Mat& err, Mat& mask, double thresh )
     {
-        cb->computeError( m1, m2, model, err );
-        mask.create(err.size(), CV_8U);
-
-        CV_Assert( err.isContinuous() && err.type() == CV_32F && mask.isContinuous() && mask.type() == CV_8U);
+        CV_Assert( err.isContinuous() && err.type() == CV_32F && mask.isContinuous() && mask.type() == CV_8U &&
+                   err.total() == mask.total() );
         const float* errptr = err.ptr<float>();
         uchar* maskptr = mask.ptr<uchar>();
         float t = (float)(thresh*thresh);
-        int i, n = (int)err.total(), nz = 0;
-        for( i = 0; i < n; i++ )
+        int i = 0, n = (int)err.total(), nz = 0;
+#if CV_SIMD128
+        v_float32x4 vt = v_setall_f32(t);
+        v_int32x4 vone = v_setall_s32(1), vnz = v_setzero_s32();
+        for( ; i <= n - 16; i += 16 )
+        {
+            v_int32x4 f0 = v_reinterpret_as_s32(v_load(errptr + i) <= vt) & vone;
+            v_int32x4 f1 = v_reinterpret_as_s32(v_load(errptr + i + 4) <= vt) & vone;
+            v_int32x4 f2 = v_reinterpret_as_s32(v_load(errptr + i + 8) <= vt) & vone;
+            v_int32x4 f3 = v_reinterpret_as_s32(v_load(errptr + i + 12) <= vt) & vone;
+            vnz = vnz + ((f0 + f1) + (f2 + f3));
+            v_store(maskptr + i, v_pack_u(v_pack(f0, f1), v_pack(f2, f3)));
+        }
+        nz = v_reduce_sum(vnz);
+#endif
+        for( ; i < n; i++ )
         {
             int f = errptr[i] <= t;
             maskptr[i] = (uchar)f;
@@ -102,6 +164,37 @@ public:
         return nz;
     }
 
+    int findInliers( const Mat& m1, const Mat& m2, const Mat& model, Mat& err, Mat& mask, double thresh ) const
+    {
+        cb->computeError( m1, m2, model, err );
+        mask.create(err.size(), CV_8U);
+        return countInliers(err, mask, thresh);
+    }
+
+    // Counts the inliers of the model block by block and gives up as soon as the model cannot get
+    // more than bound inliers; then 0 is returned and the mask is not complete. Models that could
+    // not beat an earlier one are never selected, so this does not change the result.
+    int scoreModel( const Mat& m1, const Mat& m2, const Mat& model, Mat& err, Mat& mask,
+                    double thresh, int bound ) const
+    {
+        const int blockSize = 512;
+        int count = m1.rows, nz = 0;
+        if( count < blockSize*2 )
+            return findInliers(m1, m2, model, err, mask, thresh);
+
+        mask.create(count, 1, CV_8U);
+        for( int r0 = 0, r1; r0 < count; r0 = r1 )
+        {
+            r1 = count - r0 < blockSize*2 ? count : r0 + blockSize;
+            cb->computeError( m1.rowRange(r0, r1), m2.rowRange(r0, r1), model, err );
+            Mat maskBlock = mask.rowRange(r0, r1);
+            nz += countInliers(err, maskBlock, thresh);
+            if( nz + (count - r1) <= bound )
+                return 0;
+        }
+        return nz;
+    }
+
     bool getSubset( const Mat& m1, const Mat& m2,
                     Mat& ms1, Mat& ms2, RNG& rng,
                     int maxAttempts=1000 ) const
@@ -165,7 +258,7 @@ public:
     {
         bool result = false;
         Mat m1 = _m1.getMat(), m2 = _m2.getMat();
-        Mat err, mask, model, bestModel, ms1, ms2;
+        Mat bestModel;
 
         int iter, niters = MAX(maxIters, 1);
         int d1 = m1.channels() > 1 ? m1.channels() : m1.cols;
@@ -181,6 +274,12 @@ public:
         if( count < modelPoints )
             return false;
 
+        // one point per row, so that the points can be scored in blocks
+        if( m1.rows != count )
+            m1 = m1.reshape(0, count);
+        if( m2.rows != count )
+            m2 = m2.reshape(0, count);
+
         Mat bestMask0, bestMask;
 
         if( _mask.needed() )
@@ -204,37 +303,48 @@ public:
             return true;
         }
 
-        for( iter = 0; iter < niters; iter++ )
+        // The hypotheses are drawn in the same order as one by one, evaluated in parallel in batches
+        // and merged in the order of drawing, so the result does not depend on the number of threads.
+        // A batch only uses the best score of the previous ones for dropping hopeless hypotheses.
+        // Each stripe gets two hypotheses, whose models the callback may compute together.
+        int batchSize = std::max(getNumThreads(), 1)*2;
+        std::vector<RANSACHypothesis> batch(batchSize);
+        bool stop = false;
+
+        for( iter = 0; iter < niters && !stop; )
         {
-            int i, goodCount, nmodels;
-            if( count > modelPoints )
+            int b, nb = std::min(batchSize, niters - iter);
+            for( b = 0; b < nb; b++ )
             {
-                bool found = getSubset( m1, m2, ms1, ms2, rng, 10000 );
-                if( !found )
+                if( !getSubset( m1, m2, batch[b].ms1, batch[b].ms2, rng, 10000 ) )
                 {
-                    if( iter == 0 )
+                    if( iter + b == 0 )
                         return false;
+                    stop = true;
                     break;
                 }
             }
+            nb = b;
 
-            nmodels = cb->runKernel( ms1, ms2, model );
-            if( nmodels <= 0 )
-                continue;
-            CV_Assert( model.rows % nmodels == 0 );
-            Size modelSize(model.cols, model.rows/nmodels);
+            RANSACEvaluator evaluator(this, m1, m2, batch, MAX(maxGoodCount, modelPoints-1));
+            if( cb->isThreadSafe() )
+                parallel_for_(Range(0, nb), evaluator, (nb + 1)/2);
+            else
+                evaluator(Range(0, nb));
 
-            for( i = 0; i < nmodels; i++ )
+            for( b = 0; b < nb && iter < niters; b++, iter++ )
             {
-                Mat model_i = model.rowRange( i*modelSize.height, (i+1)*modelSize.height );
-                goodCount = findInliers( m1, m2, model_i, err, mask, threshold );
-
-                if( goodCount > MAX(maxGoodCount, modelPoints-1) )
+                RANSACHypothesis& h = batch[b];
+                for( int i = 0; i < h.nmodels; i++ )
                 {
-                    std::swap(mask, bestMask);
-                    model_i.copyTo(bestModel);
-                    maxGoodCount = goodCount;
-                    niters = RANSACUpdateNumIters( confidence, (double)(count - goodCount)/count, modelPoints, niters );
+                    int goodCount = h.goodCount[i];
+                    if( goodCount > MAX(maxGoodCount, modelPoints-1) )
+                    {
+                        std::swap(h.mask[i], bestMask);
+                        h.model.rowRange(i*h.modelSize.height, (i+1)*h.modelSize.height).copyTo(bestModel);
+                        maxGoodCount = goodCount;
+                        niters = RANSACUpdateNumIters( confidence, (double)(count - goodCount)/count, modelPoints, niters );
+                    }
                 }
             }
         }
@@ -267,6 +377,87 @@ public:
     int maxIters;
 };
 
+// computes the models of the hypotheses in the range with one call of the callback
+static void runKernels( const PointSetRegistrator::Callback* cb, std::vector<RANSACHypothesis>& batch,
+                        const Range& range )
+{
+    int i, n = range.size();
+    std::vector<Mat> ms1(n), ms2(n), models(n);
+    std::vector<int> nmodels(n);
+    for( i = 0; i < n; i++ )
+    {
+        RANSACHypothesis& h = batch[range.start + i];
+        ms1[i] = h.ms1;
+        ms2[i] = h.ms2;
+        models[i] = h.model;
+    }
+    cb->runKernels( &ms1[0], &ms2[0], n, &models[0], &nmodels[0] );
+    for( i = 0; i < n; i++ )
+    {
+        RANSACHypothesis& h = batch[range.start + i];
+        h.model = models[i];
+        h.nmodels = nmodels[i];
+    }
+}
+
+void RANSACEvaluator::operator()( const Range& range ) const
+{
+    runKernels( reg->cb, *batch, range );
+    for( int b = range.start; b < range.end; b++ )
+    {
+        RANSACHypothesis& h = (*batch)[b];
+        if( h.nmodels <= 0 )
+        {
+            h.nmodels = 0;
+            continue;
+        }
+        CV_Assert( h.model.rows % h.nmodels == 0 );
+        h.modelSize = Size(h.model.cols, h.model.rows/h.nmodels);
+        h.mask.resize(h.nmodels);
+        h.goodCount.resize(h.nmodels);
+
+        for( int i = 0; i < h.nmodels; i++ )
+        {
+            Mat model_i = h.model.rowRange( i*h.modelSize.height, (i+1)*h.modelSize.height );
+            h.goodCount[i] = reg->scoreModel( m1, m2, model_i, h.err, h.mask[i], reg->threshold, bound );
+        }
+    }
+}
+
+void LMeDSEvaluator::operator()( const Range& range ) const
+{
+    Mat errf;
+    runKernels( reg->cb, *batch, range );
+    for( int b = range.start; b < range.end; b++ )
+    {
+        RANSACHypothesis& h = (*batch)[b];
+        if( h.nmodels <= 0 )
+        {
+            h.nmodels = 0;
+            continue;
+        }
+        CV_Assert( h.model.rows % h.nmodels == 0 );
+        h.modelSize = Size(h.model.cols, h.model.rows/h.nmodels);
+        h.median.resize(h.nmodels);
+
+        for( int i = 0; i < h.nmodels; i++ )
+        {
+            Mat model_i = h.model.rowRange( i*h.modelSize.height, (i+1)*h.modelSize.height );
+            reg->cb->computeError( m1, m2, model_i, h.err );
+            if( h.err.depth() != CV_32F )
+                h.err.convertTo(errf, CV_32F);
+            else
+                errf = h.err;
+            int count = (int)errf.total();
+            CV_Assert( errf.isContinuous() && errf.type() == CV_32F && count > 0 );
+            std::sort(errf.ptr<int>(), errf.ptr<int>() + count);
+
+            h.median[i] = count % 2 != 0 ?
+            errf.at<float>(count/2) : (errf.at<float>(count/2-1) + errf.at<float>(count/2))*0.5;
+        }
+    }
+}
+
 class LMeDSPointSetRegistrator : public RANSACPointSetRegistrator
 {
 public:
@@ -279,7 +470,7 @@ public:
         const double outlierRatio = 0.45;
         bool result = false;
         Mat m1 = _m1.getMat(), m2 = _m2.getMat();
-        Mat ms1, ms2, err, errf, model, bestModel, mask, mask0;
+        Mat err, bestModel, mask, mask0;
 
         int d1 = m1.channels() > 1 ? m1.channels() : m1.cols;
         int d2 = m2.channels() > 1 ? m2.channels() : m2.cols;
@@ -314,45 +505,42 @@ public:
         int iter, niters = RANSACUpdateNumIters(confidence, outlierRatio, modelPoints, maxIters);
         niters = MAX(niters, 3);
 
-        for( iter = 0; iter < niters; iter++ )
+        // evaluated in parallel batches and merged in the order of drawing, like in RANSAC
+        int batchSize = std::max(getNumThreads(), 1)*2;
+        std::vector<RANSACHypothesis> batch(batchSize);
+        bool stop = false;
+
+        for( iter = 0; iter < niters && !stop; )
         {
-            int i, nmodels;
-            if( count > modelPoints )
+            int b, nb = std::min(batchSize, niters - iter);
+            for( b = 0; b < nb; b++ )
             {
-                bool found = getSubset( m1, m2, ms1, ms2, rng );
-                if( !found )
+                if( !getSubset( m1, m2, batch[b].ms1, batch[b].ms2, rng ) )
                 {
-                    if( iter == 0 )
+                    if( iter + b == 0 )
                         return false;
+                    stop = true;
                     break;
                 }
             }
+            nb = b;
 
-            nmodels = cb->runKernel( ms1, ms2, model );
-            if( nmodels <= 0 )
-                continue;
+            LMeDSEvaluator evaluator(this, m1, m2, batch);
+            if( cb->isThreadSafe() )
+                parallel_for_(Range(0, nb), evaluator, (nb + 1)/2);
+            else
+                evaluator(Range(0, nb));
 
-            CV_Assert( model.rows % nmodels == 0 );
-            Size modelSize(model.cols, model.rows/nmodels);
-
-            for( i = 0; i < nmodels; i++ )
+            for( b = 0; b < nb; b++, iter++ )
             {
-                Mat model_i = model.rowRange( i*modelSize.height, (i+1)*modelSize.height );
-                cb->computeError( m1, m2, model_i, err );
-                if( err.depth() != CV_32F )
-                    err.convertTo(errf, CV_32F);
-                else
-                    errf = err;
-                CV_Assert( errf.isContinuous() && errf.type() == CV_32F && (int)errf.total() == count );
-                std::sort(errf.ptr<int>(), errf.ptr<int>() + count);
-
-                double median = count % 2 != 0 ?
-                errf.at<float>(count/2) : (errf.at<float>(count/2-1) + errf.at<float>(count/2))*0.5;
-
-                if( median < minMedian )
+                RANSACHypothesis& h = batch[b];
+                for( int i = 0; i < h.nmodels; i++ )
                 {
-                    minMedian = median;
-                    model_i.copyTo(bestModel);
+                    if( h.median[i] < minMedian )
+                    {
+                        minMedian = h.median[i];
+                        h.model.rowRange(i*h.modelSize.height, (i+1)*h.modelSize.height).copyTo(bestModel);
+                    }
                 }
             }
         }
@@ -407,38 +595,33 @@ public:
         const Point3f* from = m1.ptr<Point3f>();
         const Point3f* to   = m2.ptr<Point3f>();
 
-        const int N = 12;
-        double buf[N*N + N + N];
-        Mat A(N, N, CV_64F, &buf[0]);
-        Mat B(N, 1, CV_64F, &buf[0] + N*N);
-        Mat X(N, 1, CV_64F, &buf[0] + N*N + N);
-        double* Adata = A.ptr<double>();
-        double* Bdata = B.ptr<double>();
-        A = Scalar::all(0);
+        // the 12x12 system is block-diagonal, with the same 4x4 block for the x, y and z rows
+        // of the model, so it is solved as a 4x4 system with 3 right-hand sides
+        double A[4][4], B[4][3];
 
-        for( int i = 0; i < (N/3); i++ )
+        for( int i = 0; i < 4; i++ )
         {
-            Bdata[i*3] = to[i].x;
-            Bdata[i*3+1] = to[i].y;
-            Bdata[i*3+2] = to[i].z;
-
-            double *aptr = Adata + i*3*N;
-            for(int k = 0; k < 3; ++k)
-            {
-                aptr[0] = from[i].x;
-                aptr[1] = from[i].y;
-                aptr[2] = from[i].z;
-                aptr[3] = 1.0;
-                aptr += 16;
-            }
+            A[i][0] = from[i].x;
+            A[i][1] = from[i].y;
+            A[i][2] = from[i].z;
+            A[i][3] = 1.0;
+
+            B[i][0] = to[i].x;
+            B[i][1] = to[i].y;
+            B[i][2] = to[i].z;
         }
 
-        solve(A, B, X, DECOMP_SVD);
-        X.reshape(1, 3).copyTo(_model);
+        if( !hal::LU(&A[0][0], sizeof(A[0]), 4, &B[0][0], sizeof(B[0]), 3) )
+            return 0;
+
+        Mat X(4, 3, CV_64F, &B[0][0]);
+        transpose(X, _model);
 
         return 1;
     }
 
+    bool isThreadSafe() const { return true; }
+
     void computeError( InputArray _m1, InputArray _m2, InputArray _model, OutputArray _err ) const
     {
         Mat m1 = _m1.getMat(), m2 = _m2.getMat(), model = _model.getMat();
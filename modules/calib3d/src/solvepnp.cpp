@@ -163,16 +163,21 @@ public:
     {
         Mat opoints = _m1.getMat(), ipoints = _m2.getMat();
 
+        // the hypotheses are estimated concurrently, so every call starts from its own copy of the guess
+        Mat _rvec = rvec.clone(), _tvec = tvec.clone();
         bool correspondence = solvePnP( _m1, _m2, cameraMatrix, distCoeffs,
-                                            rvec, tvec, useExtrinsicGuess, flags );
+                                            _rvec, _tvec, useExtrinsicGuess, flags );
 
         Mat _local_model;
-        hconcat(rvec, tvec, _local_model);
+        hconcat(_rvec, _tvec, _local_model);
         _local_model.copyTo(_model);
 
         return correspondence;
     }
 
+    // runKernel works on copies of the guess, so the hypotheses can be evaluated in parallel
+    bool isThreadSafe() const { return true; }
+
     /* Pre: True */
     /* Post: fill _err with projection errors */
     void computeError( InputArray _m1, InputArray _m2, InputArray _model, OutputArray _err ) const
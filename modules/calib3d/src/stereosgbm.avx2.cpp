@@ -0,0 +1,149 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009, Willow Garage Inc., all rights reserved.
+// Copyright (C) 2013, OpenCV Foundation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+#include <limits.h>
+#include "opencv2/hal/intrin.hpp"
+
+/*
+ AVX2 versions of the MODE_HH cost aggregation kernels from stereosgbm.cpp,
+ processing 16 disparities at once. D is a multiple of 16 there.
+ */
+
+namespace cv { namespace opt_AVX2 {
+
+static inline short reduceMin(const v_int16x16& a)
+{
+    short CV_DECL_ALIGNED(16) buf[8];
+    v_store_aligned(buf, v_min(v_get_low(a), v_get_high(a)));
+    short s0 = std::min(std::min(buf[0], buf[1]), std::min(buf[2], buf[3]));
+    short s1 = std::min(std::min(buf[4], buf[5]), std::min(buf[6], buf[7]));
+    return std::min(s0, s1);
+}
+
+void aggregateRowHH(const short* C, short* S, const short* Lprev, const short* minLprev,
+                    short* Lcur, short* minLcur, int width1, int D, int P1, int P2)
+{
+    const int NDIRS = 3, D2 = D + 16, NRD2 = D2*NDIRS;
+    v_int16x16 _P1 = v256_setall_s16((short)P1);
+
+    for( int x = 0; x < width1; x++ )
+    {
+        const short* Cp = C + x*D;
+        short* Sp = S + x*D;
+        short* Lr_p = Lcur + x*NRD2;
+        const short* Lr_p0 = Lprev + (x - 1)*NRD2;
+        const short* Lr_p1 = Lprev + x*NRD2 + D2;
+        const short* Lr_p2 = Lprev + (x + 1)*NRD2 + D2*2;
+        v_int16x16 _delta0 = v256_setall_s16((short)(minLprev[(x - 1)*NDIRS] + P2));
+        v_int16x16 _delta1 = v256_setall_s16((short)(minLprev[x*NDIRS + 1] + P2));
+        v_int16x16 _delta2 = v256_setall_s16((short)(minLprev[(x + 1)*NDIRS + 2] + P2));
+        v_int16x16 _minL0 = v256_setall_s16(SHRT_MAX), _minL1 = _minL0, _minL2 = _minL0;
+
+        for( int d = 0; d < D; d += 16 )
+        {
+            v_int16x16 Cpd = v256_load(Cp + d);
+            v_int16x16 L0 = v256_load(Lr_p0 + d), L1 = v256_load(Lr_p1 + d), L2 = v256_load(Lr_p2 + d);
+
+            L0 = v_min(v_min(L0, v256_load(Lr_p0 + d - 1) + _P1), v256_load(Lr_p0 + d + 1) + _P1);
+            L1 = v_min(v_min(L1, v256_load(Lr_p1 + d - 1) + _P1), v256_load(Lr_p1 + d + 1) + _P1);
+            L2 = v_min(v_min(L2, v256_load(Lr_p2 + d - 1) + _P1), v256_load(Lr_p2 + d + 1) + _P1);
+
+            L0 = (v_min(L0, _delta0) - _delta0) + Cpd;
+            L1 = (v_min(L1, _delta1) - _delta1) + Cpd;
+            L2 = (v_min(L2, _delta2) - _delta2) + Cpd;
+
+            v_store(Lr_p + d, L0);
+            v_store(Lr_p + d + D2, L1);
+            v_store(Lr_p + d + D2*2, L2);
+
+            _minL0 = v_min(_minL0, L0);
+            _minL1 = v_min(_minL1, L1);
+            _minL2 = v_min(_minL2, L2);
+
+            v_store(Sp + d, L0 + L1 + L2);
+        }
+
+        minLcur[x*NDIRS] = reduceMin(_minL0);
+        minLcur[x*NDIRS + 1] = reduceMin(_minL1);
+        minLcur[x*NDIRS + 2] = reduceMin(_minL2);
+    }
+}
+
+void aggregateRowHorzHH(const short* C, short* S, short* Lbuf,
+                        int width1, int D, int P1, int P2, int dx)
+{
+    const int D2 = D + 16;
+    short* Lr[2] = { Lbuf + 8, Lbuf + D2 + 8 };
+    v_int16x16 _P1 = v256_setall_s16((short)P1);
+    int minL = 0;
+
+    memset(Lbuf, 0, D2*2*sizeof(short));
+    Lr[0][-1] = Lr[0][D] = Lr[1][-1] = Lr[1][D] = SHRT_MAX;
+
+    for( int i = 0, x = dx > 0 ? 0 : width1 - 1; i < width1; i++, x += dx )
+    {
+        const short* Cp = C + x*D;
+        short* Sp = S + x*D;
+        const short* Lr_p0 = Lr[0];
+        short* Lr_p = Lr[1];
+        v_int16x16 _delta = v256_setall_s16((short)(minL + P2));
+        v_int16x16 _minL = v256_setall_s16(SHRT_MAX);
+
+        for( int d = 0; d < D; d += 16 )
+        {
+            v_int16x16 L0 = v256_load(Lr_p0 + d);
+            L0 = v_min(v_min(L0, v256_load(Lr_p0 + d - 1) + _P1), v256_load(Lr_p0 + d + 1) + _P1);
+            L0 = (v_min(L0, _delta) - _delta) + v256_load(Cp + d);
+            v_store(Lr_p + d, L0);
+            _minL = v_min(_minL, L0);
+
+            v_store(Sp + d, v256_load(Sp + d) + L0);
+        }
+        minL = reduceMin(_minL);
+
+        std::swap(Lr[0], Lr[1]);
+    }
+}
+
+}}
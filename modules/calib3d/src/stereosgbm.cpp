@@ -77,6 +77,7 @@ struct StereoSGBMParams
         speckleWindowSize = 0;
         speckleRange = 0;
         mode = StereoSGBM::MODE_SGBM;
+        roi = Rect();
     }
 
     StereoSGBMParams( int _minDisparity, int _numDisparities, int _SADWindowSize,
@@ -95,6 +96,7 @@ struct StereoSGBMParams
         speckleWindowSize = _speckleWindowSize;
         speckleRange = _speckleRange;
         mode = _mode;
+        roi = Rect();
     }
 
     int minDisparity;
@@ -108,6 +110,7 @@ struct StereoSGBMParams
     int speckleRange;
     int disp12MaxDiff;
     int mode;
+    Rect roi;
 };
 
 /*
@@ -299,6 +302,8 @@ static void calcPixelCostBT( const Mat& img1, const Mat& img2, int y,
 
  disp2cost also has the same size as img1 (or img2).
  It contains the minimum current cost, used to find the best disparity, corresponding to the minimal cost.
+
+ This is the single-pass 5-direction version (MODE_SGBM), MODE_HH is handled by computeDisparitySGBM_HH.
  */
 static void computeDisparitySGBM( const Mat& img1, const Mat& img2,
                                  Mat& disp1, const StereoSGBMParams& params,
@@ -337,8 +342,6 @@ static void computeDisparitySGBM( const Mat& img1, const Mat& img2,
     int D = maxD - minD, width1 = maxX1 - minX1;
     int INVALID_DISP = minD - 1, INVALID_DISP_SCALED = INVALID_DISP*DISP_SCALE;
     int SW2 = SADWindowSize.width/2, SH2 = SADWindowSize.height/2;
-    bool fullDP = params.mode == StereoSGBM::MODE_HH;
-    int npasses = fullDP ? 2 : 1;
     const int TAB_OFS = 256*4, TAB_SIZE = 256 + TAB_OFS*2;
     PixType clipTab[TAB_SIZE];
 
@@ -367,7 +370,7 @@ static void computeDisparitySGBM( const Mat& img1, const Mat& img2,
     // we keep pixel difference cost (C) and the summary cost over NR directions (S).
     // we also keep all the partial costs for the previous line L_r(x,d) and also min_k L_r(x, k)
     size_t costBufSize = width1*D;
-    size_t CSBufSize = costBufSize*(fullDP ? height : 1);
+    size_t CSBufSize = costBufSize;
     size_t minLrSize = (width1 + LrBorder*2)*NR2, LrSize = minLrSize*D2;
     int hsumBufNRows = SH2*2 + 2;
     size_t totalBufSize = (LrSize + minLrSize)*NLR*sizeof(CostType) + // minLr[] and Lr[]
@@ -394,431 +397,394 @@ static void computeDisparitySGBM( const Mat& img1, const Mat& img2,
     for( k = 0; k < width1*D; k++ )
         Cbuf[k] = (CostType)P2;
 
-    for( int pass = 1; pass <= npasses; pass++ )
-    {
-        int x1, y1, x2, y2, dx, dy;
+    CostType *Lr[NLR]={0}, *minLr[NLR]={0};
 
-        if( pass == 1 )
-        {
-            y1 = 0; y2 = height; dy = 1;
-            x1 = 0; x2 = width1; dx = 1;
-        }
-        else
-        {
-            y1 = height-1; y2 = -1; dy = -1;
-            x1 = width1-1; x2 = -1; dx = -1;
-        }
+    for( k = 0; k < NLR; k++ )
+    {
+        // shift Lr[k] and minLr[k] pointers, because we allocated them with the borders,
+        // and will occasionally use negative indices with the arrays
+        // we need to shift Lr[k] pointers by 1, to give the space for d=-1.
+        // however, then the alignment will be imperfect, i.e. bad for SSE,
+        // thus we shift the pointers by 8 (8*sizeof(short) == 16 - ideal alignment)
+        Lr[k] = pixDiff + costBufSize + LrSize*k + NRD2*LrBorder + 8;
+        memset( Lr[k] - LrBorder*NRD2 - 8, 0, LrSize*sizeof(CostType) );
+        minLr[k] = pixDiff + costBufSize + LrSize*NLR + minLrSize*k + NR2*LrBorder;
+        memset( minLr[k] - LrBorder*NR2, 0, minLrSize*sizeof(CostType) );
+    }
 
-        CostType *Lr[NLR]={0}, *minLr[NLR]={0};
+    for( int y = 0; y < height; y++ )
+    {
+        int x, d;
+        DispType* disp1ptr = disp1.ptr<DispType>(y);
+        CostType* C = Cbuf;
+        CostType* S = Sbuf;
 
-        for( k = 0; k < NLR; k++ )
-        {
-            // shift Lr[k] and minLr[k] pointers, because we allocated them with the borders,
-            // and will occasionally use negative indices with the arrays
-            // we need to shift Lr[k] pointers by 1, to give the space for d=-1.
-            // however, then the alignment will be imperfect, i.e. bad for SSE,
-            // thus we shift the pointers by 8 (8*sizeof(short) == 16 - ideal alignment)
-            Lr[k] = pixDiff + costBufSize + LrSize*k + NRD2*LrBorder + 8;
-            memset( Lr[k] - LrBorder*NRD2 - 8, 0, LrSize*sizeof(CostType) );
-            minLr[k] = pixDiff + costBufSize + LrSize*NLR + minLrSize*k + NR2*LrBorder;
-            memset( minLr[k] - LrBorder*NR2, 0, minLrSize*sizeof(CostType) );
-        }
+        int dy1 = y == 0 ? 0 : y + SH2, dy2 = y == 0 ? SH2 : dy1;
 
-        for( int y = y1; y != y2; y += dy )
+        for( k = dy1; k <= dy2; k++ )
         {
-            int x, d;
-            DispType* disp1ptr = disp1.ptr<DispType>(y);
-            CostType* C = Cbuf + (!fullDP ? 0 : y*costBufSize);
-            CostType* S = Sbuf + (!fullDP ? 0 : y*costBufSize);
+            CostType* hsumAdd = hsumBuf + (std::min(k, height-1) % hsumBufNRows)*costBufSize;
 
-            if( pass == 1 ) // compute C on the first pass, and reuse it on the second pass, if any.
+            if( k < height )
             {
-                int dy1 = y == 0 ? 0 : y + SH2, dy2 = y == 0 ? SH2 : dy1;
+                calcPixelCostBT( img1, img2, k, minD, maxD, pixDiff, tempBuf, clipTab, TAB_OFS, ftzero );
 
-                for( k = dy1; k <= dy2; k++ )
+                memset(hsumAdd, 0, D*sizeof(CostType));
+                for( x = 0; x <= SW2*D; x += D )
                 {
-                    CostType* hsumAdd = hsumBuf + (std::min(k, height-1) % hsumBufNRows)*costBufSize;
+                    int scale = x == 0 ? SW2 + 1 : 1;
+                    for( d = 0; d < D; d++ )
+                        hsumAdd[d] = (CostType)(hsumAdd[d] + pixDiff[x + d]*scale);
+                }
 
-                    if( k < height )
-                    {
-                        calcPixelCostBT( img1, img2, k, minD, maxD, pixDiff, tempBuf, clipTab, TAB_OFS, ftzero );
+                if( y > 0 )
+                {
+                    const CostType* hsumSub = hsumBuf + (std::max(y - SH2 - 1, 0) % hsumBufNRows)*costBufSize;
+                    const CostType* Cprev = C;
 
-                        memset(hsumAdd, 0, D*sizeof(CostType));
-                        for( x = 0; x <= SW2*D; x += D )
-                        {
-                            int scale = x == 0 ? SW2 + 1 : 1;
-                            for( d = 0; d < D; d++ )
-                                hsumAdd[d] = (CostType)(hsumAdd[d] + pixDiff[x + d]*scale);
-                        }
+                    for( x = D; x < width1*D; x += D )
+                    {
+                        const CostType* pixAdd = pixDiff + std::min(x + SW2*D, (width1-1)*D);
+                        const CostType* pixSub = pixDiff + std::max(x - (SW2+1)*D, 0);
 
-                        if( y > 0 )
+                    #if CV_SSE2
+                        if( useSIMD )
                         {
-                            const CostType* hsumSub = hsumBuf + (std::max(y - SH2 - 1, 0) % hsumBufNRows)*costBufSize;
-                            const CostType* Cprev = !fullDP || y == 0 ? C : C - costBufSize;
-
-                            for( x = D; x < width1*D; x += D )
+                            for( d = 0; d < D; d += 8 )
                             {
-                                const CostType* pixAdd = pixDiff + std::min(x + SW2*D, (width1-1)*D);
-                                const CostType* pixSub = pixDiff + std::max(x - (SW2+1)*D, 0);
-
-                            #if CV_SSE2
-                                if( useSIMD )
-                                {
-                                    for( d = 0; d < D; d += 8 )
-                                    {
-                                        __m128i hv = _mm_load_si128((const __m128i*)(hsumAdd + x - D + d));
-                                        __m128i Cx = _mm_load_si128((__m128i*)(Cprev + x + d));
-                                        hv = _mm_adds_epi16(_mm_subs_epi16(hv,
-                                                                           _mm_load_si128((const __m128i*)(pixSub + d))),
-                                                            _mm_load_si128((const __m128i*)(pixAdd + d)));
-                                        Cx = _mm_adds_epi16(_mm_subs_epi16(Cx,
-                                                                           _mm_load_si128((const __m128i*)(hsumSub + x + d))),
-                                                            hv);
-                                        _mm_store_si128((__m128i*)(hsumAdd + x + d), hv);
-                                        _mm_store_si128((__m128i*)(C + x + d), Cx);
-                                    }
-                                }
-                                else
-                            #endif
-                                {
-                                    for( d = 0; d < D; d++ )
-                                    {
-                                        int hv = hsumAdd[x + d] = (CostType)(hsumAdd[x - D + d] + pixAdd[d] - pixSub[d]);
-                                        C[x + d] = (CostType)(Cprev[x + d] + hv - hsumSub[x + d]);
-                                    }
-                                }
+                                __m128i hv = _mm_load_si128((const __m128i*)(hsumAdd + x - D + d));
+                                __m128i Cx = _mm_load_si128((__m128i*)(Cprev + x + d));
+                                hv = _mm_adds_epi16(_mm_subs_epi16(hv,
+                                                                   _mm_load_si128((const __m128i*)(pixSub + d))),
+                                                    _mm_load_si128((const __m128i*)(pixAdd + d)));
+                                Cx = _mm_adds_epi16(_mm_subs_epi16(Cx,
+                                                                   _mm_load_si128((const __m128i*)(hsumSub + x + d))),
+                                                    hv);
+                                _mm_store_si128((__m128i*)(hsumAdd + x + d), hv);
+                                _mm_store_si128((__m128i*)(C + x + d), Cx);
                             }
                         }
                         else
+                    #endif
                         {
-                            for( x = D; x < width1*D; x += D )
+                            for( d = 0; d < D; d++ )
                             {
-                                const CostType* pixAdd = pixDiff + std::min(x + SW2*D, (width1-1)*D);
-                                const CostType* pixSub = pixDiff + std::max(x - (SW2+1)*D, 0);
-
-                                for( d = 0; d < D; d++ )
-                                    hsumAdd[x + d] = (CostType)(hsumAdd[x - D + d] + pixAdd[d] - pixSub[d]);
+                                int hv = hsumAdd[x + d] = (CostType)(hsumAdd[x - D + d] + pixAdd[d] - pixSub[d]);
+                                C[x + d] = (CostType)(Cprev[x + d] + hv - hsumSub[x + d]);
                             }
                         }
                     }
-
-                    if( y == 0 )
+                }
+                else
+                {
+                    for( x = D; x < width1*D; x += D )
                     {
-                        int scale = k == 0 ? SH2 + 1 : 1;
-                        for( x = 0; x < width1*D; x++ )
-                            C[x] = (CostType)(C[x] + hsumAdd[x]*scale);
+                        const CostType* pixAdd = pixDiff + std::min(x + SW2*D, (width1-1)*D);
+                        const CostType* pixSub = pixDiff + std::max(x - (SW2+1)*D, 0);
+
+                        for( d = 0; d < D; d++ )
+                            hsumAdd[x + d] = (CostType)(hsumAdd[x - D + d] + pixAdd[d] - pixSub[d]);
                     }
                 }
-
-                // also, clear the S buffer
-                for( k = 0; k < width1*D; k++ )
-                    S[k] = 0;
             }
 
-            // clear the left and the right borders
-            memset( Lr[0] - NRD2*LrBorder - 8, 0, NRD2*LrBorder*sizeof(CostType) );
-            memset( Lr[0] + width1*NRD2 - 8, 0, NRD2*LrBorder*sizeof(CostType) );
-            memset( minLr[0] - NR2*LrBorder, 0, NR2*LrBorder*sizeof(CostType) );
-            memset( minLr[0] + width1*NR2, 0, NR2*LrBorder*sizeof(CostType) );
-
-            /*
-             [formula 13 in the paper]
-             compute L_r(p, d) = C(p, d) +
-             min(L_r(p-r, d),
-             L_r(p-r, d-1) + P1,
-             L_r(p-r, d+1) + P1,
-             min_k L_r(p-r, k) + P2) - min_k L_r(p-r, k)
-             where p = (x,y), r is one of the directions.
-             we process all the directions at once:
-             0: r=(-dx, 0)
-             1: r=(-1, -dy)
-             2: r=(0, -dy)
-             3: r=(1, -dy)
-             4: r=(-2, -dy)
-             5: r=(-1, -dy*2)
-             6: r=(1, -dy*2)
-             7: r=(2, -dy)
-             */
-            for( x = x1; x != x2; x += dx )
+            if( y == 0 )
             {
-                int xm = x*NR2, xd = xm*D2;
+                int scale = k == 0 ? SH2 + 1 : 1;
+                for( x = 0; x < width1*D; x++ )
+                    C[x] = (CostType)(C[x] + hsumAdd[x]*scale);
+            }
+        }
 
-                int delta0 = minLr[0][xm - dx*NR2] + P2, delta1 = minLr[1][xm - NR2 + 1] + P2;
-                int delta2 = minLr[1][xm + 2] + P2, delta3 = minLr[1][xm + NR2 + 3] + P2;
+        // also, clear the S buffer
+        for( k = 0; k < width1*D; k++ )
+            S[k] = 0;
+
+        // clear the left and the right borders
+        memset( Lr[0] - NRD2*LrBorder - 8, 0, NRD2*LrBorder*sizeof(CostType) );
+        memset( Lr[0] + width1*NRD2 - 8, 0, NRD2*LrBorder*sizeof(CostType) );
+        memset( minLr[0] - NR2*LrBorder, 0, NR2*LrBorder*sizeof(CostType) );
+        memset( minLr[0] + width1*NR2, 0, NR2*LrBorder*sizeof(CostType) );
+
+        /*
+         [formula 13 in the paper]
+         compute L_r(p, d) = C(p, d) +
+         min(L_r(p-r, d),
+         L_r(p-r, d-1) + P1,
+         L_r(p-r, d+1) + P1,
+         min_k L_r(p-r, k) + P2) - min_k L_r(p-r, k)
+         where p = (x,y), r is one of the directions.
+         we process all the directions at once:
+         0: r=(-1, 0)
+         1: r=(-1, -1)
+         2: r=(0, -1)
+         3: r=(1, -1)
+         4: r=(-2, -1)
+         5: r=(-1, -2)
+         6: r=(1, -2)
+         7: r=(2, -1)
+         */
+        for( x = 0; x < width1; x++ )
+        {
+            int xm = x*NR2, xd = xm*D2;
 
-                CostType* Lr_p0 = Lr[0] + xd - dx*NRD2;
-                CostType* Lr_p1 = Lr[1] + xd - NRD2 + D2;
-                CostType* Lr_p2 = Lr[1] + xd + D2*2;
-                CostType* Lr_p3 = Lr[1] + xd + NRD2 + D2*3;
+            int delta0 = minLr[0][xm - NR2] + P2, delta1 = minLr[1][xm - NR2 + 1] + P2;
+            int delta2 = minLr[1][xm + 2] + P2, delta3 = minLr[1][xm + NR2 + 3] + P2;
 
-                Lr_p0[-1] = Lr_p0[D] = Lr_p1[-1] = Lr_p1[D] =
-                Lr_p2[-1] = Lr_p2[D] = Lr_p3[-1] = Lr_p3[D] = MAX_COST;
+            CostType* Lr_p0 = Lr[0] + xd - NRD2;
+            CostType* Lr_p1 = Lr[1] + xd - NRD2 + D2;
+            CostType* Lr_p2 = Lr[1] + xd + D2*2;
+            CostType* Lr_p3 = Lr[1] + xd + NRD2 + D2*3;
 
-                CostType* Lr_p = Lr[0] + xd;
-                const CostType* Cp = C + x*D;
-                CostType* Sp = S + x*D;
+            Lr_p0[-1] = Lr_p0[D] = Lr_p1[-1] = Lr_p1[D] =
+            Lr_p2[-1] = Lr_p2[D] = Lr_p3[-1] = Lr_p3[D] = MAX_COST;
 
-            #if CV_SSE2
-                if( useSIMD )
-                {
-                    __m128i _P1 = _mm_set1_epi16((short)P1);
+            CostType* Lr_p = Lr[0] + xd;
+            const CostType* Cp = C + x*D;
+            CostType* Sp = S + x*D;
 
-                    __m128i _delta0 = _mm_set1_epi16((short)delta0);
-                    __m128i _delta1 = _mm_set1_epi16((short)delta1);
-                    __m128i _delta2 = _mm_set1_epi16((short)delta2);
-                    __m128i _delta3 = _mm_set1_epi16((short)delta3);
-                    __m128i _minL0 = _mm_set1_epi16((short)MAX_COST);
+        #if CV_SSE2
+            if( useSIMD )
+            {
+                __m128i _P1 = _mm_set1_epi16((short)P1);
 
-                    for( d = 0; d < D; d += 8 )
-                    {
-                        __m128i Cpd = _mm_load_si128((const __m128i*)(Cp + d));
-                        __m128i L0, L1, L2, L3;
+                __m128i _delta0 = _mm_set1_epi16((short)delta0);
+                __m128i _delta1 = _mm_set1_epi16((short)delta1);
+                __m128i _delta2 = _mm_set1_epi16((short)delta2);
+                __m128i _delta3 = _mm_set1_epi16((short)delta3);
+                __m128i _minL0 = _mm_set1_epi16((short)MAX_COST);
 
-                        L0 = _mm_load_si128((const __m128i*)(Lr_p0 + d));
-                        L1 = _mm_load_si128((const __m128i*)(Lr_p1 + d));
-                        L2 = _mm_load_si128((const __m128i*)(Lr_p2 + d));
-                        L3 = _mm_load_si128((const __m128i*)(Lr_p3 + d));
+                for( d = 0; d < D; d += 8 )
+                {
+                    __m128i Cpd = _mm_load_si128((const __m128i*)(Cp + d));
+                    __m128i L0, L1, L2, L3;
 
-                        L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d - 1)), _P1));
-                        L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d + 1)), _P1));
+                    L0 = _mm_load_si128((const __m128i*)(Lr_p0 + d));
+                    L1 = _mm_load_si128((const __m128i*)(Lr_p1 + d));
+                    L2 = _mm_load_si128((const __m128i*)(Lr_p2 + d));
+                    L3 = _mm_load_si128((const __m128i*)(Lr_p3 + d));
 
-                        L1 = _mm_min_epi16(L1, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p1 + d - 1)), _P1));
-                        L1 = _mm_min_epi16(L1, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p1 + d + 1)), _P1));
+                    L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d - 1)), _P1));
+                    L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d + 1)), _P1));
 
-                        L2 = _mm_min_epi16(L2, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p2 + d - 1)), _P1));
-                        L2 = _mm_min_epi16(L2, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p2 + d + 1)), _P1));
+                    L1 = _mm_min_epi16(L1, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p1 + d - 1)), _P1));
+                    L1 = _mm_min_epi16(L1, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p1 + d + 1)), _P1));
 
-                        L3 = _mm_min_epi16(L3, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p3 + d - 1)), _P1));
-                        L3 = _mm_min_epi16(L3, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p3 + d + 1)), _P1));
+                    L2 = _mm_min_epi16(L2, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p2 + d - 1)), _P1));
+                    L2 = _mm_min_epi16(L2, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p2 + d + 1)), _P1));
 
-                        L0 = _mm_min_epi16(L0, _delta0);
-                        L0 = _mm_adds_epi16(_mm_subs_epi16(L0, _delta0), Cpd);
+                    L3 = _mm_min_epi16(L3, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p3 + d - 1)), _P1));
+                    L3 = _mm_min_epi16(L3, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p3 + d + 1)), _P1));
 
-                        L1 = _mm_min_epi16(L1, _delta1);
-                        L1 = _mm_adds_epi16(_mm_subs_epi16(L1, _delta1), Cpd);
+                    L0 = _mm_min_epi16(L0, _delta0);
+                    L0 = _mm_adds_epi16(_mm_subs_epi16(L0, _delta0), Cpd);
 
-                        L2 = _mm_min_epi16(L2, _delta2);
-                        L2 = _mm_adds_epi16(_mm_subs_epi16(L2, _delta2), Cpd);
+                    L1 = _mm_min_epi16(L1, _delta1);
+                    L1 = _mm_adds_epi16(_mm_subs_epi16(L1, _delta1), Cpd);
 
-                        L3 = _mm_min_epi16(L3, _delta3);
-                        L3 = _mm_adds_epi16(_mm_subs_epi16(L3, _delta3), Cpd);
+                    L2 = _mm_min_epi16(L2, _delta2);
+                    L2 = _mm_adds_epi16(_mm_subs_epi16(L2, _delta2), Cpd);
 
-                        _mm_store_si128( (__m128i*)(Lr_p + d), L0);
-                        _mm_store_si128( (__m128i*)(Lr_p + d + D2), L1);
-                        _mm_store_si128( (__m128i*)(Lr_p + d + D2*2), L2);
-                        _mm_store_si128( (__m128i*)(Lr_p + d + D2*3), L3);
+                    L3 = _mm_min_epi16(L3, _delta3);
+                    L3 = _mm_adds_epi16(_mm_subs_epi16(L3, _delta3), Cpd);
 
-                        __m128i t0 = _mm_min_epi16(_mm_unpacklo_epi16(L0, L2), _mm_unpackhi_epi16(L0, L2));
-                        __m128i t1 = _mm_min_epi16(_mm_unpacklo_epi16(L1, L3), _mm_unpackhi_epi16(L1, L3));
-                        t0 = _mm_min_epi16(_mm_unpacklo_epi16(t0, t1), _mm_unpackhi_epi16(t0, t1));
-                        _minL0 = _mm_min_epi16(_minL0, t0);
+                    _mm_store_si128( (__m128i*)(Lr_p + d), L0);
+                    _mm_store_si128( (__m128i*)(Lr_p + d + D2), L1);
+                    _mm_store_si128( (__m128i*)(Lr_p + d + D2*2), L2);
+                    _mm_store_si128( (__m128i*)(Lr_p + d + D2*3), L3);
 
-                        __m128i Sval = _mm_load_si128((const __m128i*)(Sp + d));
+                    __m128i t0 = _mm_min_epi16(_mm_unpacklo_epi16(L0, L2), _mm_unpackhi_epi16(L0, L2));
+                    __m128i t1 = _mm_min_epi16(_mm_unpacklo_epi16(L1, L3), _mm_unpackhi_epi16(L1, L3));
+                    t0 = _mm_min_epi16(_mm_unpacklo_epi16(t0, t1), _mm_unpackhi_epi16(t0, t1));
+                    _minL0 = _mm_min_epi16(_minL0, t0);
 
-                        L0 = _mm_adds_epi16(L0, L1);
-                        L2 = _mm_adds_epi16(L2, L3);
-                        Sval = _mm_adds_epi16(Sval, L0);
-                        Sval = _mm_adds_epi16(Sval, L2);
+                    __m128i Sval = _mm_load_si128((const __m128i*)(Sp + d));
 
-                        _mm_store_si128((__m128i*)(Sp + d), Sval);
-                    }
+                    L0 = _mm_adds_epi16(L0, L1);
+                    L2 = _mm_adds_epi16(L2, L3);
+                    Sval = _mm_adds_epi16(Sval, L0);
+                    Sval = _mm_adds_epi16(Sval, L2);
 
-                    _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 8));
-                    _mm_storel_epi64((__m128i*)&minLr[0][xm], _minL0);
+                    _mm_store_si128((__m128i*)(Sp + d), Sval);
                 }
-                else
-            #endif
-                {
-                    int minL0 = MAX_COST, minL1 = MAX_COST, minL2 = MAX_COST, minL3 = MAX_COST;
 
-                    for( d = 0; d < D; d++ )
-                    {
-                        int Cpd = Cp[d], L0, L1, L2, L3;
+                _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 8));
+                _mm_storel_epi64((__m128i*)&minLr[0][xm], _minL0);
+            }
+            else
+        #endif
+            {
+                int minL0 = MAX_COST, minL1 = MAX_COST, minL2 = MAX_COST, minL3 = MAX_COST;
 
-                        L0 = Cpd + std::min((int)Lr_p0[d], std::min(Lr_p0[d-1] + P1, std::min(Lr_p0[d+1] + P1, delta0))) - delta0;
-                        L1 = Cpd + std::min((int)Lr_p1[d], std::min(Lr_p1[d-1] + P1, std::min(Lr_p1[d+1] + P1, delta1))) - delta1;
-                        L2 = Cpd + std::min((int)Lr_p2[d], std::min(Lr_p2[d-1] + P1, std::min(Lr_p2[d+1] + P1, delta2))) - delta2;
-                        L3 = Cpd + std::min((int)Lr_p3[d], std::min(Lr_p3[d-1] + P1, std::min(Lr_p3[d+1] + P1, delta3))) - delta3;
+                for( d = 0; d < D; d++ )
+                {
+                    int Cpd = Cp[d], L0, L1, L2, L3;
 
-                        Lr_p[d] = (CostType)L0;
-                        minL0 = std::min(minL0, L0);
+                    L0 = Cpd + std::min((int)Lr_p0[d], std::min(Lr_p0[d-1] + P1, std::min(Lr_p0[d+1] + P1, delta0))) - delta0;
+                    L1 = Cpd + std::min((int)Lr_p1[d], std::min(Lr_p1[d-1] + P1, std::min(Lr_p1[d+1] + P1, delta1))) - delta1;
+                    L2 = Cpd + std::min((int)Lr_p2[d], std::min(Lr_p2[d-1] + P1, std::min(Lr_p2[d+1] + P1, delta2))) - delta2;
+                    L3 = Cpd + std::min((int)Lr_p3[d], std::min(Lr_p3[d-1] + P1, std::min(Lr_p3[d+1] + P1, delta3))) - delta3;
 
-                        Lr_p[d + D2] = (CostType)L1;
-                        minL1 = std::min(minL1, L1);
+                    Lr_p[d] = (CostType)L0;
+                    minL0 = std::min(minL0, L0);
 
-                        Lr_p[d + D2*2] = (CostType)L2;
-                        minL2 = std::min(minL2, L2);
+                    Lr_p[d + D2] = (CostType)L1;
+                    minL1 = std::min(minL1, L1);
 
-                        Lr_p[d + D2*3] = (CostType)L3;
-                        minL3 = std::min(minL3, L3);
+                    Lr_p[d + D2*2] = (CostType)L2;
+                    minL2 = std::min(minL2, L2);
 
-                        Sp[d] = saturate_cast<CostType>(Sp[d] + L0 + L1 + L2 + L3);
-                    }
-                    minLr[0][xm] = (CostType)minL0;
-                    minLr[0][xm+1] = (CostType)minL1;
-                    minLr[0][xm+2] = (CostType)minL2;
-                    minLr[0][xm+3] = (CostType)minL3;
-                }
-            }
+                    Lr_p[d + D2*3] = (CostType)L3;
+                    minL3 = std::min(minL3, L3);
 
-            if( pass == npasses )
-            {
-                for( x = 0; x < width; x++ )
-                {
-                    disp1ptr[x] = disp2ptr[x] = (DispType)INVALID_DISP_SCALED;
-                    disp2cost[x] = MAX_COST;
+                    Sp[d] = saturate_cast<CostType>(Sp[d] + L0 + L1 + L2 + L3);
                 }
+                minLr[0][xm] = (CostType)minL0;
+                minLr[0][xm+1] = (CostType)minL1;
+                minLr[0][xm+2] = (CostType)minL2;
+                minLr[0][xm+3] = (CostType)minL3;
+            }
+        }
 
-                for( x = width1 - 1; x >= 0; x-- )
-                {
-                    CostType* Sp = S + x*D;
-                    int minS = MAX_COST, bestDisp = -1;
-
-                    if( npasses == 1 )
-                    {
-                        int xm = x*NR2, xd = xm*D2;
+        for( x = 0; x < width; x++ )
+        {
+            disp1ptr[x] = disp2ptr[x] = (DispType)INVALID_DISP_SCALED;
+            disp2cost[x] = MAX_COST;
+        }
 
-                        int minL0 = MAX_COST;
-                        int delta0 = minLr[0][xm + NR2] + P2;
-                        CostType* Lr_p0 = Lr[0] + xd + NRD2;
-                        Lr_p0[-1] = Lr_p0[D] = MAX_COST;
-                        CostType* Lr_p = Lr[0] + xd;
+        for( x = width1 - 1; x >= 0; x-- )
+        {
+            CostType* Sp = S + x*D;
+            int minS = MAX_COST, bestDisp = -1;
 
-                        const CostType* Cp = C + x*D;
+            int xm = x*NR2, xd = xm*D2;
 
-                    #if CV_SSE2
-                        if( useSIMD )
-                        {
-                            __m128i _P1 = _mm_set1_epi16((short)P1);
-                            __m128i _delta0 = _mm_set1_epi16((short)delta0);
+            int minL0 = MAX_COST;
+            int delta0 = minLr[0][xm + NR2] + P2;
+            CostType* Lr_p0 = Lr[0] + xd + NRD2;
+            Lr_p0[-1] = Lr_p0[D] = MAX_COST;
+            CostType* Lr_p = Lr[0] + xd;
 
-                            __m128i _minL0 = _mm_set1_epi16((short)minL0);
-                            __m128i _minS = _mm_set1_epi16(MAX_COST), _bestDisp = _mm_set1_epi16(-1);
-                            __m128i _d8 = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7), _8 = _mm_set1_epi16(8);
+            const CostType* Cp = C + x*D;
 
-                            for( d = 0; d < D; d += 8 )
-                            {
-                                __m128i Cpd = _mm_load_si128((const __m128i*)(Cp + d)), L0;
-
-                                L0 = _mm_load_si128((const __m128i*)(Lr_p0 + d));
-                                L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d - 1)), _P1));
-                                L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d + 1)), _P1));
-                                L0 = _mm_min_epi16(L0, _delta0);
-                                L0 = _mm_adds_epi16(_mm_subs_epi16(L0, _delta0), Cpd);
-
-                                _mm_store_si128((__m128i*)(Lr_p + d), L0);
-                                _minL0 = _mm_min_epi16(_minL0, L0);
-                                L0 = _mm_adds_epi16(L0, *(__m128i*)(Sp + d));
-                                _mm_store_si128((__m128i*)(Sp + d), L0);
-
-                                __m128i mask = _mm_cmpgt_epi16(_minS, L0);
-                                _minS = _mm_min_epi16(_minS, L0);
-                                _bestDisp = _mm_xor_si128(_bestDisp, _mm_and_si128(_mm_xor_si128(_bestDisp,_d8), mask));
-                                _d8 = _mm_adds_epi16(_d8, _8);
-                            }
+        #if CV_SSE2
+            if( useSIMD )
+            {
+                __m128i _P1 = _mm_set1_epi16((short)P1);
+                __m128i _delta0 = _mm_set1_epi16((short)delta0);
 
-                            short CV_DECL_ALIGNED(16) bestDispBuf[8];
-                            _mm_store_si128((__m128i*)bestDispBuf, _bestDisp);
+                __m128i _minL0 = _mm_set1_epi16((short)minL0);
+                __m128i _minS = _mm_set1_epi16(MAX_COST), _bestDisp = _mm_set1_epi16(-1);
+                __m128i _d8 = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7), _8 = _mm_set1_epi16(8);
 
-                            _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 8));
-                            _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 4));
-                            _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 2));
+                for( d = 0; d < D; d += 8 )
+                {
+                    __m128i Cpd = _mm_load_si128((const __m128i*)(Cp + d)), L0;
+
+                    L0 = _mm_load_si128((const __m128i*)(Lr_p0 + d));
+                    L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d - 1)), _P1));
+                    L0 = _mm_min_epi16(L0, _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(Lr_p0 + d + 1)), _P1));
+                    L0 = _mm_min_epi16(L0, _delta0);
+                    L0 = _mm_adds_epi16(_mm_subs_epi16(L0, _delta0), Cpd);
+
+                    _mm_store_si128((__m128i*)(Lr_p + d), L0);
+                    _minL0 = _mm_min_epi16(_minL0, L0);
+                    L0 = _mm_adds_epi16(L0, *(__m128i*)(Sp + d));
+                    _mm_store_si128((__m128i*)(Sp + d), L0);
+
+                    __m128i mask = _mm_cmpgt_epi16(_minS, L0);
+                    _minS = _mm_min_epi16(_minS, L0);
+                    _bestDisp = _mm_xor_si128(_bestDisp, _mm_and_si128(_mm_xor_si128(_bestDisp,_d8), mask));
+                    _d8 = _mm_adds_epi16(_d8, _8);
+                }
 
-                            __m128i qS = _mm_min_epi16(_minS, _mm_srli_si128(_minS, 8));
-                            qS = _mm_min_epi16(qS, _mm_srli_si128(qS, 4));
-                            qS = _mm_min_epi16(qS, _mm_srli_si128(qS, 2));
+                short CV_DECL_ALIGNED(16) bestDispBuf[8];
+                _mm_store_si128((__m128i*)bestDispBuf, _bestDisp);
 
-                            minLr[0][xm] = (CostType)_mm_cvtsi128_si32(_minL0);
-                            minS = (CostType)_mm_cvtsi128_si32(qS);
+                _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 8));
+                _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 4));
+                _minL0 = _mm_min_epi16(_minL0, _mm_srli_si128(_minL0, 2));
 
-                            qS = _mm_shuffle_epi32(_mm_unpacklo_epi16(qS, qS), 0);
-                            qS = _mm_cmpeq_epi16(_minS, qS);
-                            int idx = _mm_movemask_epi8(_mm_packs_epi16(qS, qS)) & 255;
+                __m128i qS = _mm_min_epi16(_minS, _mm_srli_si128(_minS, 8));
+                qS = _mm_min_epi16(qS, _mm_srli_si128(qS, 4));
+                qS = _mm_min_epi16(qS, _mm_srli_si128(qS, 2));
 
-                            bestDisp = bestDispBuf[LSBTab[idx]];
-                        }
-                        else
-                    #endif
-                        {
-                            for( d = 0; d < D; d++ )
-                            {
-                                int L0 = Cp[d] + std::min((int)Lr_p0[d], std::min(Lr_p0[d-1] + P1, std::min(Lr_p0[d+1] + P1, delta0))) - delta0;
+                minLr[0][xm] = (CostType)_mm_cvtsi128_si32(_minL0);
+                minS = (CostType)_mm_cvtsi128_si32(qS);
 
-                                Lr_p[d] = (CostType)L0;
-                                minL0 = std::min(minL0, L0);
+                qS = _mm_shuffle_epi32(_mm_unpacklo_epi16(qS, qS), 0);
+                qS = _mm_cmpeq_epi16(_minS, qS);
+                int idx = _mm_movemask_epi8(_mm_packs_epi16(qS, qS)) & 255;
 
-                                int Sval = Sp[d] = saturate_cast<CostType>(Sp[d] + L0);
-                                if( Sval < minS )
-                                {
-                                    minS = Sval;
-                                    bestDisp = d;
-                                }
-                            }
-                            minLr[0][xm] = (CostType)minL0;
-                        }
-                    }
-                    else
-                    {
-                        for( d = 0; d < D; d++ )
-                        {
-                            int Sval = Sp[d];
-                            if( Sval < minS )
-                            {
-                                minS = Sval;
-                                bestDisp = d;
-                            }
-                        }
-                    }
+                bestDisp = bestDispBuf[LSBTab[idx]];
+            }
+            else
+        #endif
+            {
+                for( d = 0; d < D; d++ )
+                {
+                    int L0 = Cp[d] + std::min((int)Lr_p0[d], std::min(Lr_p0[d-1] + P1, std::min(Lr_p0[d+1] + P1, delta0))) - delta0;
 
-                    for( d = 0; d < D; d++ )
-                    {
-                        if( Sp[d]*(100 - uniquenessRatio) < minS*100 && std::abs(bestDisp - d) > 1 )
-                            break;
-                    }
-                    if( d < D )
-                        continue;
-                    d = bestDisp;
-                    int _x2 = x + minX1 - d - minD;
-                    if( disp2cost[_x2] > minS )
-                    {
-                        disp2cost[_x2] = (CostType)minS;
-                        disp2ptr[_x2] = (DispType)(d + minD);
-                    }
+                    Lr_p[d] = (CostType)L0;
+                    minL0 = std::min(minL0, L0);
 
-                    if( 0 < d && d < D-1 )
+                    int Sval = Sp[d] = saturate_cast<CostType>(Sp[d] + L0);
+                    if( Sval < minS )
                     {
-                        // do subpixel quadratic interpolation:
-                        //   fit parabola into (x1=d-1, y1=Sp[d-1]), (x2=d, y2=Sp[d]), (x3=d+1, y3=Sp[d+1])
-                        //   then find minimum of the parabola.
-                        int denom2 = std::max(Sp[d-1] + Sp[d+1] - 2*Sp[d], 1);
-                        d = d*DISP_SCALE + ((Sp[d-1] - Sp[d+1])*DISP_SCALE + denom2)/(denom2*2);
+                        minS = Sval;
+                        bestDisp = d;
                     }
-                    else
-                        d *= DISP_SCALE;
-                    disp1ptr[x + minX1] = (DispType)(d + minD*DISP_SCALE);
                 }
+                minLr[0][xm] = (CostType)minL0;
+            }
 
-                for( x = minX1; x < maxX1; x++ )
-                {
-                    // we round the computed disparity both towards -inf and +inf and check
-                    // if either of the corresponding disparities in disp2 is consistent.
-                    // This is to give the computed disparity a chance to look valid if it is.
-                    int d1 = disp1ptr[x];
-                    if( d1 == INVALID_DISP_SCALED )
-                        continue;
-                    int _d = d1 >> DISP_SHIFT;
-                    int d_ = (d1 + DISP_SCALE-1) >> DISP_SHIFT;
-                    int _x = x - _d, x_ = x - d_;
-                    if( 0 <= _x && _x < width && disp2ptr[_x] >= minD && std::abs(disp2ptr[_x] - _d) > disp12MaxDiff &&
-                       0 <= x_ && x_ < width && disp2ptr[x_] >= minD && std::abs(disp2ptr[x_] - d_) > disp12MaxDiff )
-                        disp1ptr[x] = (DispType)INVALID_DISP_SCALED;
-                }
+            for( d = 0; d < D; d++ )
+            {
+                if( Sp[d]*(100 - uniquenessRatio) < minS*100 && std::abs(bestDisp - d) > 1 )
+                    break;
+            }
+            if( d < D )
+                continue;
+            d = bestDisp;
+            int _x2 = x + minX1 - d - minD;
+            if( disp2cost[_x2] > minS )
+            {
+                disp2cost[_x2] = (CostType)minS;
+                disp2ptr[_x2] = (DispType)(d + minD);
             }
 
-            // now shift the cyclic buffers
-            std::swap( Lr[0], Lr[1] );
-            std::swap( minLr[0], minLr[1] );
+            if( 0 < d && d < D-1 )
+            {
+                // do subpixel quadratic interpolation:
+                //   fit parabola into (x1=d-1, y1=Sp[d-1]), (x2=d, y2=Sp[d]), (x3=d+1, y3=Sp[d+1])
+                //   then find minimum of the parabola.
+                int denom2 = std::max(Sp[d-1] + Sp[d+1] - 2*Sp[d], 1);
+                d = d*DISP_SCALE + ((Sp[d-1] - Sp[d+1])*DISP_SCALE + denom2)/(denom2*2);
+            }
+            else
+                d *= DISP_SCALE;
+            disp1ptr[x + minX1] = (DispType)(d + minD*DISP_SCALE);
         }
+
+        for( x = minX1; x < maxX1; x++ )
+        {
+            // we round the computed disparity both towards -inf and +inf and check
+            // if either of the corresponding disparities in disp2 is consistent.
+            // This is to give the computed disparity a chance to look valid if it is.
+            int d1 = disp1ptr[x];
+            if( d1 == INVALID_DISP_SCALED )
+                continue;
+            int _d = d1 >> DISP_SHIFT;
+            int d_ = (d1 + DISP_SCALE-1) >> DISP_SHIFT;
+            int _x = x - _d, x_ = x - d_;
+            if( 0 <= _x && _x < width && disp2ptr[_x] >= minD && std::abs(disp2ptr[_x] - _d) > disp12MaxDiff &&
+               0 <= x_ && x_ < width && disp2ptr[x_] >= minD && std::abs(disp2ptr[x_] - d_) > disp12MaxDiff )
+                disp1ptr[x] = (DispType)INVALID_DISP_SCALED;
+        }
+
+        // now shift the cyclic buffers
+        std::swap( Lr[0], Lr[1] );
+        std::swap( minLr[0], minLr[1] );
     }
 }
 
@@ -1405,19 +1371,19 @@ void SGBM3WayMainLoop::operator () (const Range& range) const
 
 static void computeDisparity3WaySGBM( const Mat& img1, const Mat& img2,
                                       Mat& disp1, const StereoSGBMParams& params,
-                                      Mat* buffers, int nstripes )
+                                      Mat* buffers, Mat* dst_disp, int nstripes )
 {
     // precompute a lookup table for the raw matching cost computation:
     const int TAB_OFS = 256*4, TAB_SIZE = 256 + TAB_OFS*2;
-    PixType* clipTab = new PixType[TAB_SIZE];
+    PixType clipTab[TAB_SIZE];
     int ftzero = std::max(params.preFilterCap, 15) | 1;
     for(int k = 0; k < TAB_SIZE; k++ )
         clipTab[k] = (PixType)(std::min(std::max(k - TAB_OFS, -ftzero), ftzero) + ftzero);
 
-    // allocate separate dst_disp arrays to avoid conflicts due to stripe overlap:
+    // separate dst_disp arrays are used to avoid conflicts due to stripe overlap;
+    // they are kept by the caller, so for a fixed image size nothing is reallocated:
     int stripe_sz = (int)ceil(img1.rows/(double)nstripes);
     int stripe_overlap = (params.SADWindowSize/2+1) + (int)ceil(0.1*stripe_sz);
-    Mat* dst_disp = new Mat[nstripes];
     for(int i=0;i<nstripes;i++)
         dst_disp[i].create(stripe_sz+stripe_overlap,img1.cols,CV_16S);
 
@@ -1432,9 +1398,561 @@ static void computeDisparity3WaySGBM( const Mat& img1, const Mat& img2,
         src_row = (short*)dst_disp[i/stripe_sz].ptr(stripe_overlap+i%stripe_sz);
         memcpy(dst_row,src_row,disp1.cols*sizeof(short));
     }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+ MODE_HH: the full-scale 8-direction dynamic programming.
+
+ Unlike computeDisparitySGBM, which processes the directions in a single sweep over the rows,
+ the work is split into three stages that can run in parallel:
+
+ 1. the cost volume C(x,y,d) is computed for all the rows, in horizontal stripes;
+ 2. the paths that come from the previous row, r=(-1,-dy), (0,-dy) and (1,-dy), are accumulated
+    by two concurrent sweeps (top-down, dy=1 and bottom-up, dy=-1) into the summary cost
+    volume S. The first sweep to reach a row stores its sum there, the second one adds to it;
+ 3. the horizontal paths r=(-1,0) and r=(1,0) do not depend on other rows, so they are computed
+    together with the winner-takes-all selection, again in horizontal stripes.
+
+ Stage 2 uses at most two threads: each row depends on the previous one, and the diagonal paths
+ spread across any split of the row into column bands.
+
+ The result does not depend on the number of threads. The memory footprint is
+ 2*width*height*numDisparities*sizeof(short) plus some per-stripe buffers.
+ */
+
+// the vertical and the diagonal paths of one row; the layout of Lr rows is
+// (width1 + 2) blocks of NDIRS*D2 elements, the first and the last ones are the zero borders
+enum { HH_NDIRS = 3 };
+
+static void aggregateRowHH( const CostType* C, CostType* S,
+                            const CostType* Lprev, const CostType* minLprev,
+                            CostType* Lcur, CostType* minLcur,
+                            int width1, int D, int P1, int P2 )
+{
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::aggregateRowHH(C, S, Lprev, minLprev, Lcur, minLcur, width1, D, P1, P2);
+        return;
+    }
+#endif
+
+    const int D2 = D + 16, NRD2 = D2*HH_NDIRS;
+
+    for( int x = 0; x < width1; x++ )
+    {
+        const CostType* Cp = C + x*D;
+        CostType* Sp = S + x*D;
+        CostType* Lr_p = Lcur + x*NRD2;
+        const CostType* Lr_p0 = Lprev + (x - 1)*NRD2;
+        const CostType* Lr_p1 = Lprev + x*NRD2 + D2;
+        const CostType* Lr_p2 = Lprev + (x + 1)*NRD2 + D2*2;
+        int delta0 = minLprev[(x - 1)*HH_NDIRS] + P2;
+        int delta1 = minLprev[x*HH_NDIRS + 1] + P2;
+        int delta2 = minLprev[(x + 1)*HH_NDIRS + 2] + P2;
+        int d = 0;
+
+    #if CV_SIMD128
+        v_int16x8 _P1 = v_setall_s16((short)P1);
+        v_int16x8 _delta0 = v_setall_s16((short)delta0);
+        v_int16x8 _delta1 = v_setall_s16((short)delta1);
+        v_int16x8 _delta2 = v_setall_s16((short)delta2);
+        v_int16x8 _minL0 = v_setall_s16(SHRT_MAX), _minL1 = _minL0, _minL2 = _minL0;
+
+        for( ; d < D; d += 8 )
+        {
+            v_int16x8 Cpd = v_load(Cp + d);
+            v_int16x8 L0 = v_load(Lr_p0 + d), L1 = v_load(Lr_p1 + d), L2 = v_load(Lr_p2 + d);
+
+            L0 = v_min(v_min(L0, v_load(Lr_p0 + d - 1) + _P1), v_load(Lr_p0 + d + 1) + _P1);
+            L1 = v_min(v_min(L1, v_load(Lr_p1 + d - 1) + _P1), v_load(Lr_p1 + d + 1) + _P1);
+            L2 = v_min(v_min(L2, v_load(Lr_p2 + d - 1) + _P1), v_load(Lr_p2 + d + 1) + _P1);
+
+            L0 = (v_min(L0, _delta0) - _delta0) + Cpd;
+            L1 = (v_min(L1, _delta1) - _delta1) + Cpd;
+            L2 = (v_min(L2, _delta2) - _delta2) + Cpd;
+
+            v_store(Lr_p + d, L0);
+            v_store(Lr_p + d + D2, L1);
+            v_store(Lr_p + d + D2*2, L2);
+
+            _minL0 = v_min(_minL0, L0);
+            _minL1 = v_min(_minL1, L1);
+            _minL2 = v_min(_minL2, L2);
+
+            v_store(Sp + d, L0 + L1 + L2);
+        }
+
+        minLcur[x*HH_NDIRS] = min(_minL0);
+        minLcur[x*HH_NDIRS + 1] = min(_minL1);
+        minLcur[x*HH_NDIRS + 2] = min(_minL2);
+    #else
+        int minL0 = SHRT_MAX, minL1 = SHRT_MAX, minL2 = SHRT_MAX;
+
+        for( ; d < D; d++ )
+        {
+            int Cpd = Cp[d], L0, L1, L2;
+
+            L0 = Cpd + std::min((int)Lr_p0[d], std::min(Lr_p0[d-1] + P1, std::min(Lr_p0[d+1] + P1, delta0))) - delta0;
+            L1 = Cpd + std::min((int)Lr_p1[d], std::min(Lr_p1[d-1] + P1, std::min(Lr_p1[d+1] + P1, delta1))) - delta1;
+            L2 = Cpd + std::min((int)Lr_p2[d], std::min(Lr_p2[d-1] + P1, std::min(Lr_p2[d+1] + P1, delta2))) - delta2;
+
+            Lr_p[d] = (CostType)L0;
+            Lr_p[d + D2] = (CostType)L1;
+            Lr_p[d + D2*2] = (CostType)L2;
+
+            minL0 = std::min(minL0, L0);
+            minL1 = std::min(minL1, L1);
+            minL2 = std::min(minL2, L2);
+
+            Sp[d] = saturate_cast<CostType>(L0 + L1 + L2);
+        }
+
+        minLcur[x*HH_NDIRS] = (CostType)minL0;
+        minLcur[x*HH_NDIRS + 1] = (CostType)minL1;
+        minLcur[x*HH_NDIRS + 2] = (CostType)minL2;
+    #endif
+    }
+}
+
+// the horizontal path r=(-dx,0) of one row, added to S.
+// Lbuf should contain at least 2*(D+16) elements.
+static void aggregateRowHorzHH( const CostType* C, CostType* S,
+                                CostType* Lbuf, int width1, int D, int P1, int P2, int dx )
+{
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::aggregateRowHorzHH(C, S, Lbuf, width1, D, P1, P2, dx);
+        return;
+    }
+#endif
+
+    const int D2 = D + 16;
+    CostType* Lr[2] = { Lbuf + 8, Lbuf + D2 + 8 };
+    int minL = 0;
+
+    memset(Lbuf, 0, D2*2*sizeof(CostType));
+    Lr[0][-1] = Lr[0][D] = Lr[1][-1] = Lr[1][D] = SHRT_MAX;
+
+    for( int i = 0, x = dx > 0 ? 0 : width1 - 1; i < width1; i++, x += dx )
+    {
+        const CostType* Cp = C + x*D;
+        CostType* Sp = S + x*D;
+        const CostType* Lr_p0 = Lr[0];
+        CostType* Lr_p = Lr[1];
+        int delta = minL + P2;
+        int d = 0;
+
+    #if CV_SIMD128
+        v_int16x8 _P1 = v_setall_s16((short)P1), _delta = v_setall_s16((short)delta);
+        v_int16x8 _minL = v_setall_s16(SHRT_MAX);
+
+        for( ; d < D; d += 8 )
+        {
+            v_int16x8 L0 = v_load(Lr_p0 + d);
+            L0 = v_min(v_min(L0, v_load(Lr_p0 + d - 1) + _P1), v_load(Lr_p0 + d + 1) + _P1);
+            L0 = (v_min(L0, _delta) - _delta) + v_load(Cp + d);
+            v_store(Lr_p + d, L0);
+            _minL = v_min(_minL, L0);
+
+            v_store(Sp + d, v_load(Sp + d) + L0);
+        }
+        minL = min(_minL);
+    #else
+        int minL0 = SHRT_MAX;
+
+        for( ; d < D; d++ )
+        {
+            int L0 = Cp[d] + std::min((int)Lr_p0[d], std::min(Lr_p0[d-1] + P1, std::min(Lr_p0[d+1] + P1, delta))) - delta;
+            Lr_p[d] = (CostType)L0;
+            minL0 = std::min(minL0, L0);
+
+            Sp[d] = saturate_cast<CostType>(Sp[d] + L0);
+        }
+        minL = minL0;
+    #endif
+
+        std::swap(Lr[0], Lr[1]);
+    }
+}
+
+struct SGBMParamsHH
+{
+    SGBMParamsHH( const Mat& img1, const StereoSGBMParams& params, int _nstripes )
+    {
+        minD = params.minDisparity;
+        maxD = minD + params.numDisparities;
+        int wsz = params.SADWindowSize > 0 ? params.SADWindowSize : 5;
+        SW2 = SH2 = wsz/2;
+        ftzero = std::max(params.preFilterCap, 15) | 1;
+        uniquenessRatio = params.uniquenessRatio >= 0 ? params.uniquenessRatio : 10;
+        disp12MaxDiff = params.disp12MaxDiff > 0 ? params.disp12MaxDiff : 1;
+        P1 = params.P1 > 0 ? params.P1 : 2;
+        P2 = std::max(params.P2 > 0 ? params.P2 : 5, P1+1);
+        width = img1.cols;
+        height = img1.rows;
+        minX1 = std::max(maxD, 0);
+        maxX1 = width + std::min(minD, 0);
+        D = maxD - minD;
+        width1 = maxX1 - minX1;
+        D2 = D + 16;
+        costBufSize = (size_t)width1*D;
+        hsumBufNRows = SH2*2 + 2;
+        nstripes = _nstripes;
+
+        // the buffer layout: C, S, then the per-stripe and per-sweep scratch areas.
+        // all the sizes are rounded up to keep each area 16-byte aligned
+        stripeCostSize = alignSize(costBufSize*(hsumBufNRows + 1) + (width*16*img1.channels() + 1)/2, 8);
+        LrRowSize = (size_t)(width1 + 2)*HH_NDIRS*D2;
+        minLrRowSize = alignSize((width1 + 2)*HH_NDIRS, 8);
+        sweepSize = (LrRowSize + minLrRowSize)*2 + alignSize(costBufSize, 8);
+        stripeSelectSize = alignSize(D2*2 + width*2, 8);
+        totalSize = costBufSize*height*2 + stripeCostSize*nstripes + sweepSize*2 + stripeSelectSize*nstripes;
+    }
+
+    int minD, maxD, D, D2;
+    int SW2, SH2;
+    int ftzero, uniquenessRatio, disp12MaxDiff, P1, P2;
+    int width, height, minX1, maxX1, width1;
+    int hsumBufNRows, nstripes;
+    size_t costBufSize, stripeCostSize, LrRowSize, minLrRowSize, sweepSize, stripeSelectSize, totalSize;
+};
+
+// stage 1: the cost volume, C(x,y,d) = P2 + sum over the (clamped) rows y-SH2..y+SH2 of the horizontal sums
+struct CalcCostVolumeHH : public ParallelLoopBody
+{
+    CalcCostVolumeHH( const Mat& _img1, const Mat& _img2, const SGBMParamsHH& _p,
+                      CostType* _Cbuf, CostType* _scratch, const PixType* _clipTab, int _tabOfs )
+        : img1(&_img1), img2(&_img2), p(&_p), Cbuf(_Cbuf), scratch(_scratch), clipTab(_clipTab), tabOfs(_tabOfs) {}
+
+    void operator()( const Range& range ) const
+    {
+        const SGBMParamsHH& q = *p;
+        const int SH2 = q.SH2, height = q.height;
+        const int N = q.hsumBufNRows;
+        const size_t costBufSize = q.costBufSize;
+        const int len = (int)costBufSize;
+        AutoBuffer<int> _hsumRows(N);
+        int* hsumRows = _hsumRows;
+
+        for( int s = range.start; s < range.end; s++ )
+        {
+            CostType* hsumBuf = scratch + q.stripeCostSize*s;
+            CostType* pixDiff = hsumBuf + costBufSize*N;
+            PixType* tempBuf = (PixType*)(pixDiff + costBufSize);
+            int y0 = (int)((int64)height*s/q.nstripes), y1 = (int)((int64)height*(s + 1)/q.nstripes);
+
+            for( int i = 0; i < N; i++ )
+                hsumRows[i] = -1;
+
+            for( int y = y0; y < y1; y++ )
+            {
+                CostType* C = Cbuf + costBufSize*y;
+                int x = 0;
+
+                if( y == y0 )
+                {
+                    for( x = 0; x < len; x++ )
+                        C[x] = (CostType)q.P2;
+                    for( int k = y - SH2; k <= y + SH2; k++ )
+                    {
+                        const CostType* hsum = getHSum(std::min(std::max(k, 0), height-1),
+                                                       hsumBuf, pixDiff, tempBuf, hsumRows);
+                        x = 0;
+                    #if CV_SIMD128
+                        for( ; x <= len - 8; x += 8 )
+                            v_store(C + x, v_load(C + x) + v_load(hsum + x));
+                    #endif
+                        for( ; x < len; x++ )
+                            C[x] = (CostType)(C[x] + hsum[x]);
+                    }
+                    continue;
+                }
+
+                const CostType* hsumAdd = getHSum(std::min(y + SH2, height-1), hsumBuf, pixDiff, tempBuf, hsumRows);
+                const CostType* hsumSub = getHSum(std::max(y - SH2 - 1, 0), hsumBuf, pixDiff, tempBuf, hsumRows);
+                const CostType* Cprev = C - costBufSize;
+
+            #if CV_SIMD128
+                for( ; x <= len - 8; x += 8 )
+                    v_store(C + x, (v_load(Cprev + x) - v_load(hsumSub + x)) + v_load(hsumAdd + x));
+            #endif
+                for( ; x < len; x++ )
+                    C[x] = (CostType)(Cprev[x] + hsumAdd[x] - hsumSub[x]);
+            }
+        }
+    }
+
+    // returns the horizontal sums of the pixel costs over the window for the row k;
+    // the rows are cached in the cyclic buffer of hsumBufNRows rows
+    const CostType* getHSum( int k, CostType* hsumBuf, CostType* pixDiff, PixType* tempBuf, int* hsumRows ) const
+    {
+        const SGBMParamsHH& q = *p;
+        const int D = q.D, SW2 = q.SW2, width1 = q.width1;
+        int slot = k % q.hsumBufNRows;
+        CostType* hsum = hsumBuf + q.costBufSize*slot;
+
+        if( hsumRows[slot] == k )
+            return hsum;
+        hsumRows[slot] = k;
+
+        calcPixelCostBT( *img1, *img2, k, q.minD, q.maxD, pixDiff, tempBuf, clipTab, tabOfs, q.ftzero );
+
+        memset(hsum, 0, D*sizeof(CostType));
+        for( int x = 0; x <= SW2*D; x += D )
+        {
+            int scale = x == 0 ? SW2 + 1 : 1;
+            for( int d = 0; d < D; d++ )
+                hsum[d] = (CostType)(hsum[d] + pixDiff[x + d]*scale);
+        }
+
+        for( int x = D; x < width1*D; x += D )
+        {
+            const CostType* pixAdd = pixDiff + std::min(x + SW2*D, (width1-1)*D);
+            const CostType* pixSub = pixDiff + std::max(x - (SW2+1)*D, 0);
+            int d = 0;
+        #if CV_SIMD128
+            for( ; d < D; d += 8 )
+                v_store(hsum + x + d, (v_load(hsum + x - D + d) - v_load(pixSub + d)) + v_load(pixAdd + d));
+        #endif
+            for( ; d < D; d++ )
+                hsum[x + d] = (CostType)(hsum[x - D + d] + pixAdd[d] - pixSub[d]);
+        }
+
+        return hsum;
+    }
+
+    const Mat *img1, *img2;
+    const SGBMParamsHH* p;
+    CostType* Cbuf;
+    CostType* scratch;
+    const PixType* clipTab;
+    int tabOfs;
+};
+
+// stage 2: the top-down (range index 0) and the bottom-up (range index 1) sweeps
+struct AggregatePathsHH : public ParallelLoopBody
+{
+    AggregatePathsHH( const SGBMParamsHH& _p, const CostType* _Cbuf, CostType* _Sbuf,
+                      CostType* _scratch, int* _rowState )
+        : p(&_p), Cbuf(_Cbuf), Sbuf(_Sbuf), scratch(_scratch), rowState(_rowState) {}
+
+    void operator()( const Range& range ) const
+    {
+        const SGBMParamsHH& q = *p;
+        const int NRD2 = q.D2*HH_NDIRS;
+
+        for( int pass = range.start; pass < range.end; pass++ )
+        {
+            CostType* buf = scratch + q.sweepSize*pass;
+            CostType* Srow = buf + (q.LrRowSize + q.minLrRowSize)*2;
+            CostType *Lr[2], *minLr[2];
+
+            for( int k = 0; k < 2; k++ )
+            {
+                // Lr[k] points to the slot 0 of x=0; the +8 shift gives the room for d=-1
+                // and keeps the alignment. Each slot is padded with MAX_COST at d=-1 and d=D,
+                // these elements are never overwritten.
+                CostType* Lrow = buf + q.LrRowSize*k;
+                memset(Lrow, 0, q.LrRowSize*sizeof(CostType));
+                for( size_t i = 0; i < (size_t)(q.width1 + 2)*HH_NDIRS; i++ )
+                    Lrow[i*q.D2 + 7] = Lrow[i*q.D2 + 8 + q.D] = SHRT_MAX;
+                Lr[k] = Lrow + NRD2 + 8;
+
+                CostType* minLrow = buf + q.LrRowSize*2 + q.minLrRowSize*k;
+                memset(minLrow, 0, q.minLrRowSize*sizeof(CostType));
+                minLr[k] = minLrow + HH_NDIRS;
+            }
+
+            for( int i = 0; i < q.height; i++ )
+            {
+                int y = pass == 0 ? i : q.height - 1 - i;
+                aggregateRowHH( Cbuf + q.costBufSize*y, Srow,
+                                Lr[1], minLr[1], Lr[0], minLr[0], q.width1, q.D, q.P1, q.P2 );
+                std::swap( Lr[0], Lr[1] );
+                std::swap( minLr[0], minLr[1] );
+                mergeRow( Srow, Sbuf + q.costBufSize*y, rowState + y*2 );
+            }
+        }
+    }
+
+    // The row state is the number of sweeps that reached the row and whether the first one has
+    // stored its sum. The second sweep only waits for a store in progress, so the sweeps
+    // may also run one after another on the same thread.
+    void mergeRow( const CostType* Srow, CostType* S, int* state ) const
+    {
+        const int len = (int)p->costBufSize;
+        if( CV_XADD(state, 1) == 0 )
+        {
+            memcpy( S, Srow, len*sizeof(CostType) );
+            CV_XADD(state + 1, 1);
+            return;
+        }
+
+        while( CV_XADD(state + 1, 0) == 0 )
+            ;
+        int x = 0;
+    #if CV_SIMD128
+        for( ; x <= len - 8; x += 8 )
+            v_store(S + x, v_load(S + x) + v_load(Srow + x));
+    #endif
+        for( ; x < len; x++ )
+            S[x] = saturate_cast<CostType>(S[x] + Srow[x]);
+    }
+
+    const SGBMParamsHH* p;
+    const CostType* Cbuf;
+    CostType* Sbuf;
+    CostType* scratch;
+    int* rowState;
+};
+
+// stage 3: the horizontal paths, the final summary cost and the disparity selection
+struct SelectDisparityHH : public ParallelLoopBody
+{
+    SelectDisparityHH( const SGBMParamsHH& _p, const CostType* _Cbuf, CostType* _Sbuf,
+                       CostType* _scratch, Mat& _disp1 )
+        : p(&_p), Cbuf(_Cbuf), Sbuf(_Sbuf), scratch(_scratch), disp1(&_disp1) {}
+
+    void operator()( const Range& range ) const
+    {
+        const SGBMParamsHH& q = *p;
+        const int DISP_SHIFT = StereoMatcher::DISP_SHIFT;
+        const int DISP_SCALE = (1 << DISP_SHIFT);
+        const CostType MAX_COST = SHRT_MAX;
+        const int D = q.D, minD = q.minD, minX1 = q.minX1, maxX1 = q.maxX1, width = q.width;
+        const int INVALID_DISP_SCALED = (minD - 1)*DISP_SCALE;
+
+        for( int s = range.start; s < range.end; s++ )
+        {
+            CostType* Lbuf = scratch + q.stripeSelectSize*s;
+            CostType* disp2cost = Lbuf + q.D2*2;
+            DispType* disp2ptr = (DispType*)(disp2cost + width);
+            int y0 = (int)((int64)q.height*s/q.nstripes), y1 = (int)((int64)q.height*(s + 1)/q.nstripes);
+
+            for( int y = y0; y < y1; y++ )
+            {
+                const CostType* C = Cbuf + q.costBufSize*y;
+                CostType* S = Sbuf + q.costBufSize*y;
+                DispType* disp1ptr = disp1->ptr<DispType>(y);
+                int x, d;
+
+                aggregateRowHorzHH( C, S, Lbuf, q.width1, D, q.P1, q.P2, 1 );
+                aggregateRowHorzHH( C, S, Lbuf, q.width1, D, q.P1, q.P2, -1 );
+
+                for( x = 0; x < width; x++ )
+                {
+                    disp1ptr[x] = disp2ptr[x] = (DispType)INVALID_DISP_SCALED;
+                    disp2cost[x] = MAX_COST;
+                }
+
+                for( x = q.width1 - 1; x >= 0; x-- )
+                {
+                    const CostType* Sp = S + x*D;
+                    int minS = MAX_COST, bestDisp = -1;
 
-    delete[] clipTab;
-    delete[] dst_disp;
+                    for( d = 0; d < D; d++ )
+                    {
+                        int Sval = Sp[d];
+                        if( Sval < minS )
+                        {
+                            minS = Sval;
+                            bestDisp = d;
+                        }
+                    }
+
+                    for( d = 0; d < D; d++ )
+                    {
+                        if( Sp[d]*(100 - q.uniquenessRatio) < minS*100 && std::abs(bestDisp - d) > 1 )
+                            break;
+                    }
+                    if( d < D )
+                        continue;
+                    d = bestDisp;
+                    int _x2 = x + minX1 - d - minD;
+                    if( disp2cost[_x2] > minS )
+                    {
+                        disp2cost[_x2] = (CostType)minS;
+                        disp2ptr[_x2] = (DispType)(d + minD);
+                    }
+
+                    if( 0 < d && d < D-1 )
+                    {
+                        // do subpixel quadratic interpolation, see computeDisparitySGBM
+                        int denom2 = std::max(Sp[d-1] + Sp[d+1] - 2*Sp[d], 1);
+                        d = d*DISP_SCALE + ((Sp[d-1] - Sp[d+1])*DISP_SCALE + denom2)/(denom2*2);
+                    }
+                    else
+                        d *= DISP_SCALE;
+                    disp1ptr[x + minX1] = (DispType)(d + minD*DISP_SCALE);
+                }
+
+                for( x = minX1; x < maxX1; x++ )
+                {
+                    int d1 = disp1ptr[x];
+                    if( d1 == INVALID_DISP_SCALED )
+                        continue;
+                    int _d = d1 >> DISP_SHIFT;
+                    int d_ = (d1 + DISP_SCALE-1) >> DISP_SHIFT;
+                    int _x = x - _d, x_ = x - d_;
+                    if( 0 <= _x && _x < width && disp2ptr[_x] >= minD && std::abs(disp2ptr[_x] - _d) > q.disp12MaxDiff &&
+                       0 <= x_ && x_ < width && disp2ptr[x_] >= minD && std::abs(disp2ptr[x_] - d_) > q.disp12MaxDiff )
+                        disp1ptr[x] = (DispType)INVALID_DISP_SCALED;
+                }
+            }
+        }
+    }
+
+    const SGBMParamsHH* p;
+    const CostType* Cbuf;
+    CostType* Sbuf;
+    CostType* scratch;
+    Mat* disp1;
+};
+
+static void computeDisparitySGBM_HH( const Mat& img1, const Mat& img2,
+                                     Mat& disp1, const StereoSGBMParams& params,
+                                     Mat& buffer )
+{
+    const int ALIGN = 16;
+    const int TAB_OFS = 256*4, TAB_SIZE = 256 + TAB_OFS*2;
+    PixType clipTab[TAB_SIZE];
+
+    int nstripes = std::max(std::min(getNumThreads()*2, img1.rows), 1);
+    SGBMParamsHH p(img1, params, nstripes);
+
+    if( p.minX1 >= p.maxX1 )
+    {
+        disp1 = Scalar::all((p.minD - 1)*StereoMatcher::DISP_SCALE);
+        return;
+    }
+
+    CV_Assert( p.D % 16 == 0 );
+
+    for( int k = 0; k < TAB_SIZE; k++ )
+        clipTab[k] = (PixType)(std::min(std::max(k - TAB_OFS, -p.ftzero), p.ftzero) + p.ftzero);
+
+    // the buffer is kept by StereoSGBMImpl, so it is reallocated only when the image size,
+    // the number of disparities or the number of threads grow
+    size_t totalBufSize = p.totalSize*sizeof(CostType) + ALIGN;
+    if( buffer.empty() || !buffer.isContinuous() ||
+        buffer.cols*buffer.rows*buffer.elemSize() < totalBufSize )
+        buffer.create(1, (int)totalBufSize, CV_8U);
+
+    CostType* Cbuf = (CostType*)alignPtr(buffer.ptr(), ALIGN);
+    CostType* Sbuf = Cbuf + p.costBufSize*p.height;
+    CostType* costScratch = Sbuf + p.costBufSize*p.height;
+    CostType* sweepScratch = costScratch + p.stripeCostSize*nstripes;
+    CostType* selectScratch = sweepScratch + p.sweepSize*2;
+    AutoBuffer<int> rowState(p.height*2);
+    memset(rowState, 0, p.height*2*sizeof(int));
+
+    parallel_for_(Range(0, nstripes), CalcCostVolumeHH(img1, img2, p, Cbuf, costScratch, clipTab, TAB_OFS));
+    parallel_for_(Range(0, 2), AggregatePathsHH(p, Cbuf, Sbuf, sweepScratch, rowState));
+    parallel_for_(Range(0, nstripes), SelectDisparityHH(p, Cbuf, Sbuf, selectScratch, disp1));
 }
 
 class StereoSGBMImpl : public StereoSGBM
@@ -1465,8 +1983,36 @@ public:
         disparr.create( left.size(), CV_16S );
         Mat disp = disparr.getMat();
 
+        Rect roi = params.roi & Rect(0, 0, left.cols, left.rows);
+        if( params.roi.area() == 0 || roi == Rect(0, 0, left.cols, left.rows) )
+        {
+            computeDisparity( left, right, disp );
+            return;
+        }
+
+        // process only the part of the images needed for the ROI: it is extended by the
+        // block size and, on the left side, by the disparity search range. The pixels outside
+        // of the ROI are marked invalid.
+        int minD = params.minDisparity, maxD = minD + params.numDisparities;
+        int margin = (params.SADWindowSize > 0 ? params.SADWindowSize : 5)/2;
+        Rect srcRoi(roi.x - std::max(maxD, 0) - margin, roi.y - margin, 0, 0);
+        srcRoi.width = roi.x + roi.width + margin - std::min(minD, 0) - srcRoi.x;
+        srcRoi.height = roi.y + roi.height + margin - srcRoi.y;
+        srcRoi &= Rect(0, 0, left.cols, left.rows);
+
+        roiDisp.create( srcRoi.size(), CV_16S );
+        computeDisparity( left(srcRoi), right(srcRoi), roiDisp );
+
+        disp = Scalar::all((minD - 1)*StereoMatcher::DISP_SCALE);
+        roiDisp(roi - srcRoi.tl()).copyTo(disp(roi));
+    }
+
+    void computeDisparity( const Mat& left, const Mat& right, Mat& disp )
+    {
         if(params.mode==MODE_SGBM_3WAY)
-            computeDisparity3WaySGBM( left, right, disp, params, buffers, num_stripes );
+            computeDisparity3WaySGBM( left, right, disp, params, buffers, dst_disp, num_stripes );
+        else if(params.mode==MODE_HH)
+            computeDisparitySGBM_HH( left, right, disp, params, buffer );
         else
             computeDisparitySGBM( left, right, disp, params, buffer );
 
@@ -1510,6 +2056,9 @@ public:
     int getMode() const { return params.mode; }
     void setMode(int mode) { params.mode = mode; }
 
+    Rect getROI() const { return params.roi; }
+    void setROI(Rect roi) { params.roi = roi; }
+
     void write(FileStorage& fs) const
     {
         fs << "name" << name_
@@ -1545,11 +2094,13 @@ public:
 
     StereoSGBMParams params;
     Mat buffer;
+    Mat roiDisp;
 
     // the number of stripes is fixed, disregarding the number of threads/processors
     // to make the results fully reproducible:
     static const int num_stripes = 4;
     Mat buffers[num_stripes];
+    Mat dst_disp[num_stripes];
 
     static const char* name_;
 };
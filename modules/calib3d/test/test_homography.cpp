@@ -705,3 +705,35 @@ TEST(Calib3d_Homography, fromImages)
     ASSERT_TRUE(!H1.empty());
     ASSERT_GE(ninliers1, 80);
 }
+
+TEST(Calib3d_Homography, ransacThreadsIndependent)
+{
+    // enough points for the hypotheses to be scored in blocks
+    const int npoints = 3000;
+    RNG& rng = theRNG();
+    Matx33d H(1.2, 0.1, 15, -0.05, 0.9, -7, 1e-4, -2e-4, 1);
+    std::vector<Point2f> src(npoints), dst(npoints);
+    for( int i = 0; i < npoints; i++ )
+    {
+        src[i] = Point2f(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f));
+        Vec3d p = H*Vec3d(src[i].x, src[i].y, 1);
+        dst[i] = Point2f((float)(p[0]/p[2]), (float)(p[1]/p[2]));
+        if( i % 3 == 0 ) // outliers
+            dst[i] = Point2f(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f));
+        else
+            dst[i] += Point2f(rng.uniform(-0.5f, 0.5f), rng.uniform(-0.5f, 0.5f));
+    }
+
+    int nthreads = getNumThreads();
+    Mat H1, mask1, Hn, maskn;
+    setNumThreads(1);
+    H1 = findHomography(src, dst, RANSAC, 2.0, mask1);
+    setNumThreads(nthreads);
+    Hn = findHomography(src, dst, RANSAC, 2.0, maskn);
+
+    ASSERT_FALSE(H1.empty());
+    EXPECT_EQ(0, norm(H1, Hn, NORM_INF));
+    EXPECT_EQ(0, norm(mask1, maskn, NORM_INF));
+    EXPECT_NEAR(npoints*2/3, countNonZero(mask1), npoints/50);
+    EXPECT_LE(norm(Mat(H), H1, NORM_INF | NORM_RELATIVE), 1e-2);
+}
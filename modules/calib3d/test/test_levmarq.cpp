@@ -0,0 +1,62 @@
+#include "test_precomp.hpp"
+#include "../src/precomp.hpp"
+
+using namespace cv;
+
+namespace {
+
+// the linear least squares problem J*x = b
+class LinearCallback : public LMSolver::Callback
+{
+public:
+    LinearCallback(const Mat& _J, const Mat& _b) : J(_J), b(_b) {}
+
+    bool compute(InputArray _param, OutputArray _err, OutputArray _J) const
+    {
+        Mat param = _param.getMat();
+        Mat err = J*param - b;
+        err.copyTo(_err);
+        if( _J.needed() )
+            J.copyTo(_J);
+        return true;
+    }
+
+private:
+    Mat J, b;
+};
+
+// The normal matrix of J is singular or nearly so: once lambda becomes small the steps are solved
+// with the eigen decomposition instead of Cholesky. The solver must still reach the least squares
+// residual and return finite parameters.
+static void testNearSingular(double eps)
+{
+    RNG rng(0x1357);
+    const int n = 20;
+    Mat J(n, 3, CV_64F), b(n, 1, CV_64F);
+    rng.fill(J, RNG::UNIFORM, -1, 1);
+    rng.fill(b, RNG::UNIFORM, -1, 1);
+    for( int i = 0; i < n; i++ )
+        J.at<double>(i, 2) = J.at<double>(i, 0) + eps*rng.uniform(-1., 1.);
+
+    Mat x0;
+    solve(J, b, x0, DECOMP_SVD);
+    double minResidual = norm(J*x0 - b, NORM_L2SQR);
+
+    Mat x = Mat::zeros(3, 1, CV_64F);
+    Ptr<LMSolver> solver = createLMSolver(makePtr<LinearCallback>(J, b), 100);
+    ASSERT_GT(solver->run(x), 0);
+    ASSERT_TRUE(checkRange(x));
+    EXPECT_LE(norm(J*x - b, NORM_L2SQR), minResidual*(1 + 1e-6) + 1e-12);
+}
+
+}
+
+TEST(Calib3d_LMSolver, singular)
+{
+    testNearSingular(0);
+}
+
+TEST(Calib3d_LMSolver, near_singular)
+{
+    testNearSingular(1e-7);
+}
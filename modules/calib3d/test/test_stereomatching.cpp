@@ -784,3 +784,83 @@ protected:
 
 TEST(Calib3d_StereoBM, regression) { CV_StereoBMTest test; test.safe_run(); }
 TEST(Calib3d_StereoSGBM, regression) { CV_StereoSGBMTest test; test.safe_run(); }
+
+static void makeSyntheticStereoPair( Mat& left, Mat& right, Mat& gtDisp )
+{
+    RNG& rng = theRNG();
+    Mat base(240, 360, CV_8U);
+    rng.fill(base, RNG::UNIFORM, 0, 256);
+    GaussianBlur(base, base, Size(5, 5), 1.2);
+
+    left.create(240, 320, CV_8U);
+    right.create(240, 320, CV_8U);
+    gtDisp.create(240, 320, CV_32S);
+    for( int y = 0; y < left.rows; y++ )
+        for( int x = 0; x < left.cols; x++ )
+        {
+            int d = 8 + x/64 + (y > 80 && y < 160 && x > 120 && x < 220 ? 16 : 0);
+            gtDisp.at<int>(y, x) = d;
+            left.at<uchar>(y, x) = base.at<uchar>(y, x + 32);
+            right.at<uchar>(y, x) = base.at<uchar>(y, std::min(x + 32 + d, base.cols - 1));
+        }
+}
+
+TEST(Calib3d_StereoSGBM_HH, threadsIndependent)
+{
+    Mat left, right, gt;
+    makeSyntheticStereoPair(left, right, gt);
+
+    Ptr<StereoSGBM> sgbm = StereoSGBM::create(0, 48, 5, 8*25, 32*25, 1, 31, 10, 0, 0, StereoSGBM::MODE_HH);
+    int nthreads = getNumThreads();
+    Mat disp1, dispN;
+    setNumThreads(1);
+    sgbm->compute(left, right, disp1);
+    setNumThreads(nthreads);
+    sgbm->compute(left, right, dispN);
+    // the second call with the same size reuses the buffers
+    Mat dispN2;
+    sgbm->compute(left, right, dispN2);
+
+    EXPECT_EQ(0, cvtest::norm(disp1, dispN, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(dispN, dispN2, NORM_INF));
+
+    int good = 0, total = 0;
+    for( int y = 0; y < gt.rows; y++ )
+        for( int x = 64; x < gt.cols; x++ )
+        {
+            total++;
+            good += std::abs(dispN.at<short>(y, x) - gt.at<int>(y, x)*16) <= 16;
+        }
+    EXPECT_GT(good, total*9/10);
+}
+
+TEST(Calib3d_StereoSGBM, roi)
+{
+    Mat left, right, gt;
+    makeSyntheticStereoPair(left, right, gt);
+    Rect roi(100, 60, 150, 100);
+    int modes[] = { StereoSGBM::MODE_SGBM, StereoSGBM::MODE_HH, StereoSGBM::MODE_SGBM_3WAY };
+
+    for( int i = 0; i < 3; i++ )
+    {
+        Ptr<StereoSGBM> sgbm = StereoSGBM::create(0, 48, 5, 8*25, 32*25, 1, 31, 10, 0, 0, modes[i]);
+        Mat dispFull, dispRoi;
+        sgbm->compute(left, right, dispFull);
+        sgbm->setROI(roi);
+        EXPECT_EQ(roi, sgbm->getROI());
+        sgbm->compute(left, right, dispRoi);
+        ASSERT_EQ(dispFull.size(), dispRoi.size());
+
+        Mat outside = dispRoi.clone();
+        outside(roi).setTo(Scalar::all(-16));
+        EXPECT_EQ(0, countNonZero(outside != -16)) << "mode " << modes[i];
+
+        Mat diff;
+        absdiff(dispFull(roi), dispRoi(roi), diff);
+        EXPECT_GT(countNonZero(diff <= 16), (int)roi.area()*9/10) << "mode " << modes[i];
+
+        sgbm->setROI(Rect());
+        sgbm->compute(left, right, dispRoi);
+        EXPECT_EQ(0, cvtest::norm(dispFull, dispRoi, NORM_INF)) << "mode " << modes[i];
+    }
+}
@@ -427,6 +427,57 @@ public:
     virtual BufferPoolController* getBufferPoolController(const char* id = NULL) const;
 };
 
+/** @brief  Takes the buffers of new matrices from a per-thread pool while the object exists
+
+While a ScopedArena is alive, Mat::create called on the same thread for a matrix without an
+explicit allocator takes the buffer from the pool of the thread instead of the heap. Released
+buffers are kept in the pool, grouped by size classes, and reused by the following allocations,
+so a loop processing frames of the same size stops calling malloc after the first iteration:
+
+ \code
+ for(;;)
+ {
+     cap >> frame;
+     ScopedArena arena;
+     GaussianBlur(frame, blurred, Size(5, 5), 0);
+     ...
+ }
+ \endcode
+
+Matrices allocated from the pool may outlive the scope and be released on any thread; their
+buffers go back to the pool. Scopes may be nested. The parallel_for_ workers don't see the
+scope of the calling thread.
+
+The amount of memory kept in the pool is limited by the OPENCV_ARENA_LIMIT environment variable
+(128Mb by default) and can be managed through getAllocator()->getBufferPoolController(). The pool
+of a thread is freed when the thread exits; the matrices still allocated from it then return their
+buffers to the heap.
+*/
+class CV_EXPORTS ScopedArena
+{
+public:
+    struct CV_EXPORTS Stats
+    {
+        size_t hits; //!< allocations served from the pool
+        size_t misses; //!< allocations that went to the heap
+        size_t allocatedSize; //!< bytes handed out and not released yet
+    };
+
+    ScopedArena();
+    ~ScopedArena();
+
+    //! the pooled allocator of the calling thread; can also be assigned to Mat::allocator
+    static MatAllocator* getAllocator();
+    //! statistics of the pool of the calling thread
+    static Stats getStats();
+    //! resets the hits and misses counters of the pool of the calling thread
+    static void resetStats();
+
+private:
+    ScopedArena(const ScopedArena&);
+    ScopedArena& operator=(const ScopedArena&);
+};
+
 
 //////////////////////////////// MatCommaInitializer //////////////////////////////////
 
@@ -309,7 +309,11 @@ public:
         FORMAT_MASK = (7<<3), //!< mask for format flags
         FORMAT_AUTO = 0,      //!< flag, auto format
         FORMAT_XML  = (1<<3), //!< flag, XML format
-        FORMAT_YAML = (2<<3)  //!< flag, YAML format
+        FORMAT_YAML = (2<<3), //!< flag, YAML format
+        FORMAT_BINARY = (3<<3), //!< flag, binary format with the raw arrays stored as they are in memory
+        MMAP        = 64 //!< flag, map the binary file into memory instead of reading it; the matrices
+                         //!< read from it reference the mapped data, so the matrices read from the same
+                         //!< node share their data (see FileStorage::FileStorage)
     };
     enum
     {
@@ -331,7 +335,16 @@ public:
     file (.xml or .yml/.yaml) determines its format (XML or YAML respectively). Also you can append .gz
     to work with compressed files, for example myHugeMatrix.xml.gz. If both FileStorage::WRITE and
     FileStorage::MEMORY flags are specified, source is used just to specify the output file format (e.g.
-    mydata.xml, .yml etc.).
+    mydata.xml, .yml etc.). The binary format is written only when FileStorage::FORMAT_BINARY is
+    specified; when reading, it is recognized by the file signature. Arrays stored in the binary format
+    are not parsed: they are read directly from the loaded file.
+    With FileStorage::READ + FileStorage::MMAP a binary file is mapped into memory, and the
+    matrices read from it with operator >> are not copied: they reference the mapped file, which stays
+    mapped while any of them exists. The mapping is private, so the processes reading the same file
+    share its memory pages until they modify the matrices, and the changes are not written back.
+    Unlike the other modes, where every read returns a copy, the matrices read from the same node
+    share their data: a change made through one of them is seen in the others. Clone a matrix before
+    modifying it if the other readers must not see the change.
     @param flags Mode of operation. See  FileStorage::Mode
     @param encoding Encoding of the file. Note that UTF-16 XML encoding is not supported currently and
     you should use 8-bit encoding instead of it.
@@ -1184,8 +1197,6 @@ inline FileNode::operator String() const { String value; read(*this, value, valu
 inline FileNodeIterator FileNode::begin() const { return FileNodeIterator(fs, node); }
 inline FileNodeIterator FileNode::end() const   { return FileNodeIterator(fs, node, size()); }
 inline void FileNode::readRaw( const String& fmt, uchar* vec, size_t len ) const { begin().readRaw( fmt, vec, len ); }
-inline FileNode FileNodeIterator::operator *() const  { return FileNode(fs, (const CvFileNode*)(const void*)reader.ptr); }
-inline FileNode FileNodeIterator::operator ->() const { return FileNode(fs, (const CvFileNode*)(const void*)reader.ptr); }
 inline String::String(const FileNode& fn): cstr_(0), len_(0) { read(fn, *this, *this); }
 
 //! @endcond
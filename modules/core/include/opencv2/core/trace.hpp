@@ -0,0 +1,99 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef __OPENCV_CORE_TRACE_HPP__
+#define __OPENCV_CORE_TRACE_HPP__
+
+#include "opencv2/core/cvdef.h"
+#include "opencv2/core/cvstd.hpp"
+
+namespace cv
+{
+namespace tracing
+{
+
+//! @addtogroup core_utils
+//! @{
+
+/** @brief Region tracing of OpenCV functions.
+
+When OpenCV is built with ENABLE_TRACE, the major functions of core, imgproc and features2d, the
+stripes of parallel_for_ and the selected implementation (IPP, OpenCL) are recorded as events
+into a ring buffer of the calling thread. Recording is off by default; it is turned on by
+setEnabled or by the OPENCV_TRACE environment variable, which names the file the trace is
+written to at process exit. OPENCV_TRACE_BUFFER_SIZE sets the number of events kept per thread
+(65536 by default), older events are overwritten.
+
+The trace is written in the Chrome trace event format and can be viewed with chrome://tracing.
+ */
+
+/** @brief Returns true if events are being recorded. */
+CV_EXPORTS bool isEnabled();
+
+/** @brief Starts or stops recording of events. */
+CV_EXPORTS void setEnabled(bool flag);
+
+/** @brief Drops the events recorded so far. */
+CV_EXPORTS void reset();
+
+/** @brief Writes the recorded events to a file in the Chrome trace JSON format.
+
+Events being recorded while the function runs may be written incompletely, so it is better to call
+it when the traced code is idle.
+@return false if the file can't be opened.
+ */
+CV_EXPORTS bool dump(const String& filename);
+
+/** @brief Records a zero-length event, e.g. the implementation selected by a function. */
+CV_EXPORTS void mark(const char* name, const char* category, const char* arg = 0);
+
+/** @brief Records the time between construction and destruction of the object.
+
+name and category must point to strings living until the trace is written, e.g. literals.
+ */
+class CV_EXPORTS Region
+{
+public:
+    Region(const char* name, const char* category);
+    ~Region();
+
+private:
+    Region(const Region&);
+    Region& operator=(const Region&);
+
+    const char* name;
+    const char* category;
+    int64 start;
+};
+
+/** @brief Records an event that started at startTicks (see getTickCount) and lasted durationTicks. */
+CV_EXPORTS void complete(const char* name, const char* category, int64 startTicks, int64 durationTicks);
+
+/** @brief Records the implementation (one of CV_IMPL_* flags) selected by the function func. */
+CV_EXPORTS void markImpl(int impl, const char* func);
+
+//! @}
+
+}
+}
+
+#ifdef CV_ENABLE_TRACE
+#  define CV_TRACE_CAT2_(a, b) a ## b
+#  define CV_TRACE_CAT_(a, b) CV_TRACE_CAT2_(a, b)
+#  define CV_TRACE_REGION_(name, category) \
+       cv::tracing::Region CV_TRACE_CAT_(__cv_trace_region_, __LINE__)(name, category)
+   //! traces the enclosing function until it returns
+#  define CV_TRACE_FUNCTION() CV_TRACE_REGION_(CV_Func, "opencv")
+   //! traces the rest of the enclosing block under the given name
+#  define CV_TRACE_REGION(name) CV_TRACE_REGION_(name, "opencv")
+   //! used by CV_IMPL_ADD to record the implementation taken
+#  define CV_TRACE_IMPL(impl) \
+       if(cv::tracing::isEnabled()) { cv::tracing::markImpl(impl, CV_Func); }
+#else
+#  define CV_TRACE_FUNCTION()
+#  define CV_TRACE_REGION(name)
+#  define CV_TRACE_IMPL(impl)
+#endif
+
+#endif // __OPENCV_CORE_TRACE_HPP__
@@ -50,10 +50,16 @@
 #endif
 
 #include "opencv2/core.hpp"
+#include "opencv2/core/trace.hpp"
 
 namespace cv
 {
 
+#define CV_IMPL_PLAIN  0x01 // native CPU OpenCV implementation
+#define CV_IMPL_OCL    0x02 // OpenCL implementation
+#define CV_IMPL_IPP    0x04 // IPP implementation
+#define CV_IMPL_MT     0x10 // multithreaded implementation
+
 #ifdef CV_COLLECT_IMPL_DATA
 CV_EXPORTS void setImpl(int flags); // set implementation flags and reset storage arrays
 CV_EXPORTS void addImpl(int flag, const char* func = 0); // add implementation and function name to storage arrays
@@ -64,18 +70,14 @@ CV_EXPORTS int getImpl(std::vector<int> &impl, std::vector<String> &funName);
 CV_EXPORTS bool useCollection(); // return implementation collection state
 CV_EXPORTS void setUseCollection(bool flag); // set implementation collection state
 
-#define CV_IMPL_PLAIN  0x01 // native CPU OpenCV implementation
-#define CV_IMPL_OCL    0x02 // OpenCL implementation
-#define CV_IMPL_IPP    0x04 // IPP implementation
-#define CV_IMPL_MT     0x10 // multithreaded implementation
-
 #define CV_IMPL_ADD(impl)                                                   \
     if(cv::useCollection())                                                 \
     {                                                                       \
         cv::addImpl(impl, CV_Func);                                         \
-    }
+    }                                                                       \
+    CV_TRACE_IMPL(impl)
 #else
-#define CV_IMPL_ADD(impl)
+#define CV_IMPL_ADD(impl) CV_TRACE_IMPL(impl)
 #endif
 
 //! @addtogroup core_utils
@@ -217,7 +219,9 @@ The exact meaning of return value depends on the threading framework used by Ope
 - `C=` – The number of threads, that OpenCV will try to use for parallel regions, if before
   called setNumThreads with threads \> 0, otherwise returns the number of logical CPUs,
   available for the process.
-@sa setNumThreads, getThreadNum
+
+Inside a ParallelContext::Scope the number of threads of that context is returned.
+@sa setNumThreads, getThreadNum, ParallelContext
  */
 CV_EXPORTS_W int getNumThreads();
 
@@ -386,6 +390,72 @@ public:
 */
 CV_EXPORTS void parallel_for_(const Range& range, const ParallelLoopBody& body, double nstripes=-1.);
 
+class ParallelContext;
+
+/** @overload
+Runs the loop on the threads of ctx.
+*/
+CV_EXPORTS void parallel_for_(const Range& range, const ParallelLoopBody& body, ParallelContext& ctx, double nstripes=-1.);
+
+/** @brief Thread pool with its own number of threads and CPU affinity.
+
+parallel_for_ calls made with a context, or from a thread inside a ParallelContext::Scope for it,
+run on the threads of that context instead of the process-wide pool configured by setNumThreads.
+This way independent pipelines in one process don't compete for the same threads. Loops started
+from a loop body stay in the context of the outer loop.
+
+Separate pools are available with the built-in pthreads framework only. With other frameworks a
+context with a single thread runs the loops on the calling thread, otherwise the process-wide
+framework is used.
+ */
+class CV_EXPORTS ParallelContext
+{
+public:
+    /** @brief Creates a context and its pool; the pool threads are started on first use.
+
+    @param nthreads Number of threads running the loops, the calling thread included. Values \<= 0
+    select the default, i.e. the number of CPUs or OPENCV_FOR_THREADS_NUM when it is set.
+    @param cpus Indices of the CPUs the pool threads may run on, empty means no restriction. Only
+    supported on Linux.
+     */
+    explicit ParallelContext(int nthreads = 0, const std::vector<int>& cpus = std::vector<int>());
+    ~ParallelContext();
+
+    /** @brief Changes the number of threads of the context, see setNumThreads. */
+    void setNumThreads(int nthreads);
+    int getNumThreads() const;
+
+    const std::vector<int>& getCPUs() const;
+
+    /** @brief Returns the context of the innermost Scope alive on the calling thread, NULL if none. */
+    static ParallelContext* current();
+
+    /** @brief Makes parallel_for_ calls from the current thread use the context while the object is alive.
+     */
+    class CV_EXPORTS Scope
+    {
+    public:
+        explicit Scope(ParallelContext& ctx);
+        ~Scope();
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        ParallelContext* prev;
+    };
+
+    struct Impl;
+
+private:
+    friend void parallel_for_(const Range& range, const ParallelLoopBody& body, ParallelContext& ctx, double nstripes);
+
+    ParallelContext(const ParallelContext&);
+    ParallelContext& operator=(const ParallelContext&);
+
+    Impl* p;
+};
+
 /////////////////////////////// forEach method of cv::Mat ////////////////////////////
 template<typename _Tp, typename Functor> inline
 void Mat::forEach_impl(const Functor& operation) {
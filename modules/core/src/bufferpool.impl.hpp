@@ -23,6 +23,152 @@ public:
     virtual void freeAllReservedBuffers() { }
 };
 
+// Pool of host memory buffers grouped into size classes. A requested size is rounded up to
+// the class size (at most 25% more), so a released buffer serves any later request of the
+// same class. Buffers can be returned from any thread.
+class HostBufferPool : public BufferPoolController
+{
+public:
+    HostBufferPool(size_t _maxReservedSize)
+        : currentReservedSize(0), maxReservedSize(_maxReservedSize), reserved(MAX_CLASSES),
+          hits(0), misses(0), allocatedSize(0)
+    {
+    }
+    virtual ~HostBufferPool()
+    {
+        freeAllReservedBuffers();
+    }
+
+    uchar* allocate(size_t size)
+    {
+        size_t capacity;
+        int idx = sizeClass(size, capacity);
+        {
+            AutoLock locker(mutex_);
+            allocatedSize += capacity;
+            std::vector<uchar*>& entries = reserved[idx];
+            if (!entries.empty())
+            {
+                uchar* buffer = entries.back();
+                entries.pop_back();
+                currentReservedSize -= capacity;
+                hits++;
+                return buffer;
+            }
+            misses++;
+        }
+        return (uchar*)fastMalloc(capacity);
+    }
+
+    void release(uchar* buffer, size_t size)
+    {
+        size_t capacity;
+        int idx = sizeClass(size, capacity);
+        {
+            AutoLock locker(mutex_);
+            allocatedSize -= capacity;
+            if (currentReservedSize + capacity <= maxReservedSize)
+            {
+                reserved[idx].push_back(buffer);
+                currentReservedSize += capacity;
+                return;
+            }
+        }
+        fastFree(buffer);
+    }
+
+    void getStats(size_t& _hits, size_t& _misses, size_t& _allocatedSize) const
+    {
+        AutoLock locker(mutex_);
+        _hits = hits;
+        _misses = misses;
+        _allocatedSize = allocatedSize;
+    }
+
+    void resetStats()
+    {
+        AutoLock locker(mutex_);
+        hits = misses = 0;
+    }
+
+    virtual size_t getReservedSize() const
+    {
+        AutoLock locker(mutex_);
+        return currentReservedSize;
+    }
+    virtual size_t getMaxReservedSize() const
+    {
+        AutoLock locker(mutex_);
+        return maxReservedSize;
+    }
+    virtual void setMaxReservedSize(size_t size)
+    {
+        AutoLock locker(mutex_);
+        maxReservedSize = size;
+        // drop the largest buffers first
+        for (int idx = MAX_CLASSES - 1; idx >= 0 && currentReservedSize > maxReservedSize; idx--)
+        {
+            std::vector<uchar*>& entries = reserved[idx];
+            size_t capacity = classCapacity(idx);
+            while (!entries.empty() && currentReservedSize > maxReservedSize)
+            {
+                fastFree(entries.back());
+                entries.pop_back();
+                currentReservedSize -= capacity;
+            }
+        }
+    }
+    virtual void freeAllReservedBuffers()
+    {
+        AutoLock locker(mutex_);
+        for (size_t idx = 0; idx < reserved.size(); idx++)
+        {
+            for (size_t i = 0; i < reserved[idx].size(); i++)
+                fastFree(reserved[idx][i]);
+            reserved[idx].clear();
+        }
+        currentReservedSize = 0;
+    }
+
+protected:
+    enum { MIN_CLASS_SHIFT = 6, MAX_CLASSES = 4*(64 - MIN_CLASS_SHIFT) + 1 };
+
+    // Class 0 holds sizes up to 64 bytes; each following power of two is split into 4 classes.
+    static int sizeClass(size_t size, size_t& capacity)
+    {
+        int shift = MIN_CLASS_SHIFT;
+        if (size <= ((size_t)1 << shift))
+        {
+            capacity = (size_t)1 << shift;
+            return 0;
+        }
+        while (((size_t)1 << (shift + 1)) < size)
+            shift++;
+        size_t base = (size_t)1 << shift, step = base >> 2;
+        size_t k = (size - base + step - 1) / step; // 1..4
+        capacity = base + k*step;
+        return (int)(1 + (shift - MIN_CLASS_SHIFT)*4 + (k - 1));
+    }
+
+    static size_t classCapacity(int idx)
+    {
+        if (idx == 0)
+            return (size_t)1 << MIN_CLASS_SHIFT;
+        size_t base = (size_t)1 << (MIN_CLASS_SHIFT + (idx - 1)/4);
+        return base + ((idx - 1) % 4 + 1)*(base >> 2);
+    }
+
+    mutable Mutex mutex_;
+
+    size_t currentReservedSize;
+    size_t maxReservedSize;
+    std::vector<std::vector<uchar*> > reserved; // released buffers of each size class
+
+    size_t hits;
+    size_t misses;
+    size_t allocatedSize; // capacity of the buffers handed out and not yet released
+};
+
 } // namespace
 
 #endif // __OPENCV_CORE_BUFFER_POOL_IMPL_HPP__
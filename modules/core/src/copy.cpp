@@ -1121,6 +1121,8 @@ static bool ocl_copyMakeBorder( InputArray _src, OutputArray _dst, int top, int
 void cv::copyMakeBorder( InputArray _src, OutputArray _dst, int top, int bottom,
                          int left, int right, int borderType, const Scalar& value )
 {
+    CV_TRACE_FUNCTION();
+
     CV_Assert( top >= 0 && bottom >= 0 && left >= 0 && right >= 0 );
 
     CV_OCL_RUN(_dst.isUMat() && _src.dims() <= 2,
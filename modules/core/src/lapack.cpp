@@ -791,6 +791,8 @@ double cv::determinant( InputArray _mat )
 
 double cv::invert( InputArray _src, OutputArray _dst, int method )
 {
+    CV_TRACE_FUNCTION();
+
     bool result = false;
     Mat src = _src.getMat();
     int type = src.type();
@@ -1049,6 +1051,8 @@ double cv::invert( InputArray _src, OutputArray _dst, int method )
 
 bool cv::solve( InputArray _src, InputArray _src2arg, OutputArray _dst, int method )
 {
+    CV_TRACE_FUNCTION();
+
     bool result = true;
     Mat src = _src.getMat(), _src2 = _src2arg.getMat();
     int type = src.type();
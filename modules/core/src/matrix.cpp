@@ -45,6 +45,10 @@
 
 #include "bufferpool.impl.hpp"
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 /****************************************************************************************\
 *                           [scaled] Identity matrix initialization                      *
 \****************************************************************************************/
@@ -166,27 +170,34 @@ BufferPoolController* MatAllocator::getBufferPoolController(const char* id) cons
     return &dummy;
 }
 
-class StdMatAllocator : public MatAllocator
+// fills the automatic steps and returns the size of the buffer
+static size_t computeAllocationSize(int dims, const int* sizes, int type, void* data0, size_t* step)
 {
-public:
-    UMatData* allocate(int dims, const int* sizes, int type,
-                       void* data0, size_t* step, int /*flags*/, UMatUsageFlags /*usageFlags*/) const
+    size_t total = CV_ELEM_SIZE(type);
+    for( int i = dims-1; i >= 0; i-- )
     {
-        size_t total = CV_ELEM_SIZE(type);
-        for( int i = dims-1; i >= 0; i-- )
+        if( step )
         {
-            if( step )
+            if( data0 && step[i] != CV_AUTOSTEP )
             {
-                if( data0 && step[i] != CV_AUTOSTEP )
-                {
-                    CV_Assert(total <= step[i]);
-                    total = step[i];
-                }
-                else
-                    step[i] = total;
+                CV_Assert(total <= step[i]);
+                total = step[i];
             }
-            total *= sizes[i];
+            else
+                step[i] = total;
         }
+        total *= sizes[i];
+    }
+    return total;
+}
+
+class StdMatAllocator : public MatAllocator
+{
+public:
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, int /*flags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        size_t total = computeAllocationSize(dims, sizes, type, data0, step);
         uchar* data = data0 ? (uchar*)data0 : (uchar*)fastMalloc(total);
         UMatData* u = new UMatData(this);
         u->data = u->origdata = data;
@@ -224,6 +235,180 @@ MatAllocator* Mat::getStdAllocator()
     CV_SINGLETON_LAZY_INIT(MatAllocator, new StdMatAllocator())
 }
 
+class ArenaMatAllocator : public MatAllocator
+{
+public:
+    ArenaMatAllocator()
+        : pool(getConfigurationParameterForSize("OPENCV_ARENA_LIMIT", (size_t)128 << 20)), refcount(1)
+    {
+    }
+
+    // the thread owning the allocator holds one reference, each matrix allocated from it another one
+    void addref() const
+    {
+        CV_XADD(&refcount, 1);
+    }
+
+    void release() const
+    {
+        if(CV_XADD(&refcount, -1) == 1)
+            delete this;
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, int /*flags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        size_t total = computeAllocationSize(dims, sizes, type, data0, step);
+        uchar* data = data0 ? (uchar*)data0 : pool.allocate(total);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+        addref();
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, int /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            pool.release(u->origdata, u->size);
+            u->origdata = 0;
+        }
+        delete u;
+        release();
+    }
+
+    BufferPoolController* getBufferPoolController(const char* id) const
+    {
+        (void)id;
+        return &pool;
+    }
+
+    mutable HostBufferPool pool;
+    mutable int refcount;
+};
+
+struct ArenaTLS
+{
+    ArenaTLS() : allocator(0), depth(0) {}
+    ArenaMatAllocator* allocator;
+    int depth;
+};
+
+// number of ScopedArena objects alive in all threads; lets Mat::create skip the TLS lookup
+static volatile int activeArenas = 0;
+
+static TLSData<ArenaTLS>& getArenaTLS()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TLSData<ArenaTLS>, new TLSData<ArenaTLS>())
+}
+
+// Called when the thread exits. The reserved buffers are freed at once and the buffers of the matrices
+// still alive go to the heap when they are released; the allocator is deleted with the last of them.
+static void releaseArena(ArenaTLS* t)
+{
+    if(t && t->allocator)
+    {
+        t->allocator->pool.setMaxReservedSize(0);
+        t->allocator->release();
+        t->allocator = 0;
+    }
+}
+
+#ifdef WIN32
+void releaseThreadArena()
+{
+    releaseArena(getArenaTLS().get());
+}
+#else
+static void onArenaThreadExit(void* data)
+{
+    releaseArena((ArenaTLS*)data);
+}
+
+// the key only serves to run onArenaThreadExit in the threads that created an allocator
+static pthread_key_t getArenaExitKey()
+{
+    static pthread_key_t key;
+    static volatile bool initialized = false;
+    if(!initialized)
+    {
+        AutoLock lock(getInitializationMutex());
+        if(!initialized)
+        {
+            CV_Assert(pthread_key_create(&key, onArenaThreadExit) == 0);
+            initialized = true;
+        }
+    }
+    return key;
+}
+#endif
+
+static ArenaMatAllocator* getThreadArenaAllocator()
+{
+    ArenaTLS* t = getArenaTLS().get();
+    if(!t->allocator)
+    {
+        t->allocator = new ArenaMatAllocator();
+#ifndef WIN32
+        pthread_setspecific(getArenaExitKey(), t);
+#endif
+    }
+    return t->allocator;
+}
+
+MatAllocator* getArenaAllocator()
+{
+    if(activeArenas == 0)
+        return NULL;
+    ArenaTLS* t = getArenaTLS().get();
+    return t->depth > 0 ? t->allocator : NULL;
+}
+
+ScopedArena::ScopedArena()
+{
+    getThreadArenaAllocator();
+    getArenaTLS().get()->depth++;
+    CV_XADD(&activeArenas, 1);
+}
+
+ScopedArena::~ScopedArena()
+{
+    getArenaTLS().get()->depth--;
+    CV_XADD(&activeArenas, -1);
+}
+
+MatAllocator* ScopedArena::getAllocator()
+{
+    return getThreadArenaAllocator();
+}
+
+ScopedArena::Stats ScopedArena::getStats()
+{
+    Stats stats;
+    getThreadArenaAllocator()->pool.getStats(stats.hits, stats.misses, stats.allocatedSize);
+    return stats;
+}
+
+void ScopedArena::resetStats()
+{
+    getThreadArenaAllocator()->pool.resetStats();
+}
+
 void swap( Mat& a, Mat& b )
 {
     std::swap(a.flags, b.flags);
@@ -393,6 +578,8 @@ void Mat::create(int d, const int* _sizes, int _type)
         if( !a || a == tegra::getAllocator() )
             a = tegra::getAllocator(d, _sizes, _type);
 #endif
+        if(!a)
+            a = getArenaAllocator();
         if(!a)
             a = a0;
         try
@@ -3154,6 +3341,8 @@ static bool ipp_transpose( Mat &src, Mat &dst )
 
 void cv::transpose( InputArray _src, OutputArray _dst )
 {
+    CV_TRACE_FUNCTION();
+
     int type = _src.type(), esz = CV_ELEM_SIZE(type);
     CV_Assert( _src.dims() <= 2 && esz <= 32 );
 
@@ -3621,6 +3810,8 @@ static bool ocl_reduce(InputArray _src, OutputArray _dst,
 
 void cv::reduce(InputArray _src, OutputArray _dst, int dim, int op, int dtype)
 {
+    CV_TRACE_FUNCTION();
+
     CV_Assert( _src.dims() <= 2 );
     int op0 = op;
     int stype = _src.type(), sdepth = CV_MAT_DEPTH(stype), cn = CV_MAT_CN(stype);
@@ -137,6 +137,13 @@ namespace cv
     void parallel_for_pthreads(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes);
     size_t parallel_pthreads_get_threads_num();
     void parallel_pthreads_set_threads_num(int num);
+
+    class ThreadManager;
+    ThreadManager* parallel_pthreads_create_pool(int num, const std::vector<int>& cpus);
+    void parallel_pthreads_release_pool(ThreadManager* pool);
+    void parallel_for_pthreads(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes, ThreadManager* pool);
+    size_t parallel_pthreads_get_threads_num(ThreadManager* pool);
+    void parallel_pthreads_set_threads_num(int num, ThreadManager* pool);
 #endif
 }
 
@@ -156,6 +163,8 @@ namespace
         }
         void operator()(const cv::Range& sr) const
         {
+            CV_TRACE_REGION("parallel_for_ stripe");
+
             cv::Range r;
             r.start = (int)(wholeRange.start +
                             ((uint64)sr.start*(wholeRange.end - wholeRange.start) + nstripes/2)/nstripes);
@@ -250,8 +259,10 @@ static SchedPtr pplScheduler;
 
 /* ================================   parallel_for_  ================================ */
 
-void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
+static void parallel_for_global(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
 {
+    CV_TRACE_REGION("parallel_for_");
+
 #ifdef CV_PARALLEL_FRAMEWORK
 
     if(numThreads != 0)
@@ -327,8 +338,127 @@ void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body,
     }
 }
 
+void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
+{
+    cv::ParallelContext* ctx = cv::ParallelContext::current();
+
+    if(ctx)
+        cv::parallel_for_(range, body, *ctx, nstripes);
+    else
+        parallel_for_global(range, body, nstripes);
+}
+
+/* ================================  ParallelContext  ================================ */
+
+struct cv::ParallelContext::Impl
+{
+    Impl(int _nthreads, const std::vector<int>& _cpus) : nthreads(_nthreads), cpus(_cpus)
+    {
+#ifdef HAVE_PTHREADS_PF
+        pool = cv::parallel_pthreads_create_pool(nthreads, cpus);
+#endif
+    }
+
+    ~Impl()
+    {
+#ifdef HAVE_PTHREADS_PF
+        cv::parallel_pthreads_release_pool(pool);
+#endif
+    }
+
+    int nthreads;
+    std::vector<int> cpus;
+#ifdef HAVE_PTHREADS_PF
+    cv::ThreadManager* pool;
+#endif
+};
+
+namespace
+{
+    struct ParallelContextTLS
+    {
+        ParallelContextTLS() : ctx(0) {}
+        cv::ParallelContext* ctx;
+    };
+
+    static cv::TLSData<ParallelContextTLS>& getParallelContextTLS()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(cv::TLSData<ParallelContextTLS>, new cv::TLSData<ParallelContextTLS>())
+    }
+}
+
+cv::ParallelContext::ParallelContext(int nthreads, const std::vector<int>& cpus)
+{
+    p = new Impl(nthreads, cpus);
+}
+
+cv::ParallelContext::~ParallelContext()
+{
+    delete p;
+}
+
+void cv::ParallelContext::setNumThreads(int nthreads)
+{
+    p->nthreads = nthreads;
+#ifdef HAVE_PTHREADS_PF
+    cv::parallel_pthreads_set_threads_num(nthreads, p->pool);
+#endif
+}
+
+int cv::ParallelContext::getNumThreads() const
+{
+#ifdef HAVE_PTHREADS_PF
+    return (int)cv::parallel_pthreads_get_threads_num(p->pool);
+#else
+    return p->nthreads > 0 ? p->nthreads : cv::getNumberOfCPUs();
+#endif
+}
+
+const std::vector<int>& cv::ParallelContext::getCPUs() const
+{
+    return p->cpus;
+}
+
+cv::ParallelContext* cv::ParallelContext::current()
+{
+    return getParallelContextTLS().get()->ctx;
+}
+
+cv::ParallelContext::Scope::Scope(ParallelContext& ctx)
+{
+    ParallelContextTLS* tls = getParallelContextTLS().get();
+    prev = tls->ctx;
+    tls->ctx = &ctx;
+}
+
+cv::ParallelContext::Scope::~Scope()
+{
+    getParallelContextTLS().get()->ctx = prev;
+}
+
+void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, ParallelContext& ctx, double nstripes)
+{
+    CV_TRACE_REGION("parallel_for_");
+
+    // the chunks run by the calling thread start their nested loops in ctx too, like the pool threads
+    ParallelContext::Scope scope(ctx);
+
+#ifdef HAVE_PTHREADS_PF
+    cv::parallel_for_pthreads(range, body, nstripes, ctx.p->pool);
+#else
+    if(ctx.getNumThreads() > 1)
+        parallel_for_global(range, body, nstripes);
+    else
+        body(range);
+#endif
+}
+
 int cv::getNumThreads(void)
 {
+    cv::ParallelContext* ctx = cv::ParallelContext::current();
+    if(ctx)
+        return ctx->getNumThreads();
+
 #ifdef CV_PARALLEL_FRAMEWORK
 
     if(numThreads == 0)
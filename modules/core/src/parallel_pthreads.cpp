@@ -47,18 +47,24 @@
 #include <algorithm>
 #include <pthread.h>
 
-namespace cv
-{
+/*
+   Work-stealing scheduler behind parallel_for_.
 
-class ThreadManager;
+   Each parallel_for_ call becomes a ParallelJob whose range is split evenly between
+   the slots of the job: one per pool thread plus one for the calling thread. A thread
+   takes chunks from the front of its own slot; when the slot runs dry it steals the
+   upper half of the fullest slot. The chunk size follows the measured cost of the
+   previous chunk, so cheap iterations are batched while expensive ones stay stealable.
+
+   A parallel_for_ issued from a loop body, or by several user threads at once, becomes
+   one more job served by the same pool threads, so nesting never adds threads.
 
-enum ForThreadState
+   Besides the process-wide pool, every cv::ParallelContext owns a ThreadManager of its
+   own; loops nested into a body running on a pool thread go to that thread's pool.
+*/
+
+namespace cv
 {
-    eFTNotStarted = 0,
-    eFTStarted = 1,
-    eFTToStop = 2,
-    eFTStoped = 3
-};
 
 enum ThreadManagerPoolState
 {
@@ -68,90 +74,69 @@ enum ThreadManagerPoolState
     eTMSingleThreaded = 3
 };
 
-struct work_load
+struct work_slot
 {
-    work_load()
-    {
-        clear();
-    }
-
-    work_load(const cv::Range& range, const cv::ParallelLoopBody& body, int nstripes)
-    {
-        set(range, body, nstripes);
-    }
-
-    void set(const cv::Range& range, const cv::ParallelLoopBody& body, unsigned int nstripes)
-    {
-        m_body = &body;
-        m_range = &range;
-
-        //ensure that nstripes not larger than range length
-        m_nstripes = std::min( unsigned(m_range->end - m_range->start) , nstripes);
-
-        m_block_size = ((m_range->end - m_range->start - 1)/m_nstripes) + 1;
-
-        //ensure that nstripes not larger than blocks count, so we would never go out of range
-        m_nstripes = std::min(m_nstripes, unsigned(((m_range->end - m_range->start - 1)/m_block_size) + 1) );
-    }
-
-    const cv::ParallelLoopBody* m_body;
-    const cv::Range*            m_range;
-    unsigned int                         m_nstripes;
-    int                m_block_size;
-
-    void clear()
-    {
-        m_body = 0;
-        m_range = 0;
-        m_nstripes = 0;
-        m_block_size = 0;
-    }
+    pthread_mutex_t m_mutex;
+    volatile int    m_begin;
+    volatile int    m_end;
 };
 
-class ForThread
+class ParallelJob
 {
 public:
+    ParallelJob(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes,
+                int nslots, int64 target_ticks);
 
-    ForThread(): m_task_start(false), m_parent(0), m_state(eFTNotStarted), m_id(0)
-    {
-    }
+    ~ParallelJob();
 
-    //called from manager thread
-    bool init(size_t id, ThreadManager* parent);
+    //called from every thread taking part in the job, returns when nothing is left to claim
+    void execute(int slot);
 
-    //called from manager thread
-    void run();
+    //drops the unclaimed part of the range
+    void cancel();
 
-    //called from manager thread
-    void stop();
+    //unlocked check used to pick a job, may be stale
+    bool hasWork() const;
 
-    ~ForThread();
+    int slotsCount() const { return m_nslots; }
 
-private:
+    //pool threads currently inside execute(), guarded by the manager mutex
+    int m_workers;
 
-    //called from worker thread
-    static void* thread_loop_wrapper(void* thread_object);
+private:
+    bool claim(int slot, int chunk, cv::Range& r);
 
-    //called from worker thread
-    void execute();
+    bool steal(int slot);
 
-    //called from worker thread
-    void thread_body();
+    const cv::ParallelLoopBody* m_body;
+    int m_length;
+    int m_grain;
+    int m_nslots;
+    int64 m_target_ticks;
+    cv::AutoBuffer<work_slot, 16> m_slots;
+};
 
-    pthread_t       m_posix_thread;
-    pthread_mutex_t m_thread_mutex;
-    pthread_cond_t  m_cond_thread_task;
-    bool            m_task_start;
+class ThreadManager;
 
-    ThreadManager*  m_parent;
-    ForThreadState  m_state;
-    size_t          m_id;
+struct work_thread_t
+{
+    work_thread_t(): owner(0), value(0) { }
+    ThreadManager* owner; // pool of the thread, NULL for user threads
+    int value;            // 1-based index of the thread within the pool
 };
 
+static TLSData<work_thread_t>& getWorkThreadTls()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TLSData<work_thread_t>, new TLSData<work_thread_t>())
+}
+
 class ThreadManager
 {
 public:
-    friend class ForThread;
+    //nthreads == 0 selects the default number of threads
+    ThreadManager(size_t nthreads, const std::vector<int>& cpus);
+
+    ~ThreadManager();
 
     static ThreadManager& instance()
     {
@@ -161,7 +146,7 @@ public:
 
             if(!m_instance.ptr)
             {
-                m_instance.ptr = new ThreadManager();
+                m_instance.ptr = new ThreadManager(0, std::vector<int>());
             }
 
             pthread_mutex_unlock(&m_manager_access_mutex);
@@ -170,22 +155,6 @@ public:
         return *m_instance.ptr;
     }
 
-
-    static void stop()
-    {
-        ThreadManager& manager = instance();
-
-        if(manager.m_pool_state == eTMInited)
-        {
-            for(size_t i = 0; i < manager.m_num_threads; ++i)
-            {
-                manager.m_threads[i].stop();
-            }
-        }
-
-        manager.m_pool_state = eTMNotInited;
-    }
-
     void run(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes);
 
     size_t getNumOfThreads();
@@ -209,43 +178,49 @@ private:
         }
     };
 
-    ThreadManager();
-
-    ~ThreadManager();
+    struct thread_arg
+    {
+        ThreadManager* manager;
+        int            id;
+    };
 
-    void wait_complete();
+    //called from worker thread
+    static void* thread_loop_wrapper(void* arg);
 
-    void notify_complete();
+    //called from worker thread
+    void thread_body(int id);
 
+    //called with m_mutex locked
     bool initPool();
 
+    //called from worker thread
+    void setAffinity();
+
+    void stop();
+
+    void finish(ParallelJob& job);
+
     size_t defaultNumberOfThreads();
 
-    std::vector<ForThread> m_threads;
+    std::vector<pthread_t>  m_threads;
+    std::vector<thread_arg> m_thread_args;
     size_t m_num_threads;
+    bool   m_stop;
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t  m_cond_job_posted;
+    pthread_cond_t  m_cond_job_left;
 
-    pthread_mutex_t m_manager_task_mutex;
-    pthread_cond_t  m_cond_thread_task_complete;
-    bool            m_task_complete;
+    std::vector<ParallelJob*> m_jobs;
 
-    unsigned int m_task_position;
-    unsigned int m_num_of_completed_tasks;
+    std::vector<int> m_cpus;
+
+    int64 m_target_ticks;
 
     static pthread_mutex_t m_manager_access_mutex;
     static ptr_holder m_instance;
 
     static const char m_env_name[];
-    static const unsigned int m_default_number_of_threads;
-
-    work_load m_work_load;
-
-    struct work_thread_t
-    {
-        work_thread_t(): value(false) { }
-        bool value;
-    };
-
-    cv::TLSData<work_thread_t> m_is_work_thread;
 
     ThreadManagerPoolState m_pool_state;
 };
@@ -259,143 +234,178 @@ pthread_mutex_t ThreadManager::m_manager_access_mutex = PTHREAD_RECURSIVE_MUTEX_
 ThreadManager::ptr_holder ThreadManager::m_instance;
 const char ThreadManager::m_env_name[] = "OPENCV_FOR_THREADS_NUM";
 
-#ifdef ANDROID
-// many modern phones/tables have 4-core CPUs. Let's use no more
-// than 2 threads by default not to overheat the devices
-const unsigned int ThreadManager::m_default_number_of_threads = 2;
-#else
-const unsigned int ThreadManager::m_default_number_of_threads = 8;
-#endif
+// chunks cheaper than this are merged, chunks more expensive are split (in seconds)
+static const double PARALLEL_CHUNK_TIME = 1e-4;
 
-ForThread::~ForThread()
+ParallelJob::ParallelJob(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes,
+                         int nslots, int64 target_ticks)
+    : m_workers(0), m_body(&body), m_length(range.end - range.start), m_grain(1),
+      m_nslots(nslots), m_target_ticks(target_ticks), m_slots(nslots)
 {
-    if(m_state == eFTStarted)
-    {
-        stop();
+    //the caller asked for at most nstripes pieces, never split finer than that
+    if(nstripes > 0)
+        m_grain = std::max(1, (m_length + cvCeil(nstripes) - 1)/cvCeil(nstripes));
 
-        pthread_mutex_destroy(&m_thread_mutex);
+    int ngrains = (m_length + m_grain - 1)/m_grain;
 
-        pthread_cond_destroy(&m_cond_thread_task);
+    for(int i = 0; i < m_nslots; ++i)
+    {
+        work_slot& s = m_slots[i];
+        pthread_mutex_init(&s.m_mutex, NULL);
+        s.m_begin = range.start + (int)((int64)ngrains*i/m_nslots)*m_grain;
+        s.m_end = std::min(range.start + (int)((int64)ngrains*(i + 1)/m_nslots)*m_grain, range.end);
     }
 }
 
-bool ForThread::init(size_t id, ThreadManager* parent)
+ParallelJob::~ParallelJob()
 {
-    m_id = id;
-
-    m_parent = parent;
-
-    int res = 0;
-
-    res |= pthread_mutex_init(&m_thread_mutex, NULL);
+    for(int i = 0; i < m_nslots; ++i)
+        pthread_mutex_destroy(&m_slots[i].m_mutex);
+}
 
-    res |= pthread_cond_init(&m_cond_thread_task, NULL);
+bool ParallelJob::hasWork() const
+{
+    for(int i = 0; i < m_nslots; ++i)
+        if(m_slots[i].m_begin < m_slots[i].m_end)
+            return true;
+    return false;
+}
 
-    if(!res)
+void ParallelJob::cancel()
+{
+    for(int i = 0; i < m_nslots; ++i)
     {
-        res = pthread_create(&m_posix_thread, NULL, thread_loop_wrapper, (void*)this);
+        work_slot& s = m_slots[i];
+        pthread_mutex_lock(&s.m_mutex);
+        s.m_end = s.m_begin;
+        pthread_mutex_unlock(&s.m_mutex);
     }
-
-
-    return res == 0;
 }
 
-void ForThread::stop()
+bool ParallelJob::claim(int slot, int chunk, cv::Range& r)
 {
-    if(m_state == eFTStarted)
-    {
-        m_state = eFTToStop;
+    work_slot& s = m_slots[slot];
+
+    pthread_mutex_lock(&s.m_mutex);
 
-        run();
+    int remaining = s.m_end - s.m_begin;
+    bool res = remaining > 0;
 
-        pthread_join(m_posix_thread, NULL);
+    if(res)
+    {
+        //keep at least a half of the slot available for stealing
+        int n = std::min(chunk, std::max(remaining/2/m_grain*m_grain, m_grain));
+        r.start = s.m_begin;
+        r.end = std::min(s.m_begin + n, (int)s.m_end);
+        s.m_begin = r.end;
     }
 
-    m_state = eFTStoped;
+    pthread_mutex_unlock(&s.m_mutex);
+
+    return res;
 }
 
-void ForThread::run()
+bool ParallelJob::steal(int slot)
 {
-    pthread_mutex_lock(&m_thread_mutex);
+    int victim = -1, best = 0;
 
-    m_task_start = true;
-
-    pthread_cond_signal(&m_cond_thread_task);
+    for(int i = 1; i < m_nslots; ++i)
+    {
+        int j = (slot + i) % m_nslots;
+        int remaining = m_slots[j].m_end - m_slots[j].m_begin;
+        if(remaining > best)
+        {
+            best = remaining;
+            victim = j;
+        }
+    }
 
-    pthread_mutex_unlock(&m_thread_mutex);
-}
+    if(victim < 0)
+        return false;
 
-void* ForThread::thread_loop_wrapper(void* thread_object)
-{
-    ((ForThread*)thread_object)->thread_body();
-    return 0;
-}
+    work_slot& v = m_slots[victim];
+    int begin = 0, end = 0;
 
-void ForThread::execute()
-{
-    unsigned int m_current_pos = CV_XADD(&m_parent->m_task_position, 1);
+    pthread_mutex_lock(&v.m_mutex);
 
-    work_load& load = m_parent->m_work_load;
+    int remaining = v.m_end - v.m_begin;
 
-    while(m_current_pos < load.m_nstripes)
+    if(remaining > 0)
     {
-        int start = load.m_range->start + m_current_pos*load.m_block_size;
-        int end = std::min(start + load.m_block_size, load.m_range->end);
+        int ngrains = (remaining + m_grain - 1)/m_grain;
+        end = v.m_end;
+        begin = ngrains > 1 ? v.m_begin + (ngrains - ngrains/2)*m_grain : v.m_begin;
+        v.m_end = begin;
+    }
 
-        load.m_body->operator()(cv::Range(start, end));
+    pthread_mutex_unlock(&v.m_mutex);
 
-        m_current_pos = CV_XADD(&m_parent->m_task_position, 1);
+    if(begin < end)
+    {
+        work_slot& s = m_slots[slot];
+        pthread_mutex_lock(&s.m_mutex);
+        s.m_begin = begin;
+        s.m_end = end;
+        pthread_mutex_unlock(&s.m_mutex);
     }
+
+    //if the victim was emptied by someone else meanwhile, just look again
+    return true;
 }
 
-void ForThread::thread_body()
+void ParallelJob::execute(int slot)
 {
-    m_parent->m_is_work_thread.get()->value = true;
+    int chunk = m_grain;
+    cv::Range r;
 
-    pthread_mutex_lock(&m_thread_mutex);
+    for(;;)
+    {
+        if(!claim(slot, chunk, r))
+        {
+            if(!steal(slot))
+                break;
+            continue;
+        }
 
-    m_state = eFTStarted;
+        int64 t0 = cv::getTickCount();
 
-    while(m_state == eFTStarted)
-    {
-        //to handle spurious wakeups
-        while( !m_task_start && m_state != eFTToStop )
-            pthread_cond_wait(&m_cond_thread_task, &m_thread_mutex);
+        m_body->operator()(r);
 
-        if(m_state == eFTStarted)
-        {
-            execute();
+        int64 t = cv::getTickCount() - t0;
 
-            m_task_start = false;
+#ifdef CV_ENABLE_TRACE
+        if(cv::tracing::isEnabled())
+            cv::tracing::complete("parallel_for_ stripe", "opencv", t0, t);
+#endif
 
-            m_parent->notify_complete();
-        }
+        if(t < m_target_ticks/2)
+            chunk = std::min(chunk, m_length/2) * 2;
+        else if(t > m_target_ticks*2)
+            chunk = std::max(chunk/2, m_grain);
     }
-
-    pthread_mutex_unlock(&m_thread_mutex);
 }
 
-ThreadManager::ThreadManager(): m_num_threads(0), m_task_complete(false), m_num_of_completed_tasks(0), m_pool_state(eTMNotInited)
+ThreadManager::ThreadManager(size_t nthreads, const std::vector<int>& cpus):
+    m_num_threads(0), m_stop(false), m_cpus(cpus), m_pool_state(eTMNotInited)
 {
+    m_target_ticks = std::max((int64)1, (int64)(cv::getTickFrequency()*PARALLEL_CHUNK_TIME));
+
     int res = 0;
 
-    res |= pthread_mutex_init(&m_manager_task_mutex, NULL);
+    res |= pthread_mutex_init(&m_mutex, NULL);
+
+    res |= pthread_cond_init(&m_cond_job_posted, NULL);
 
-    res |= pthread_cond_init(&m_cond_thread_task_complete, NULL);
+    res |= pthread_cond_init(&m_cond_job_left, NULL);
 
     if(!res)
     {
-        setNumOfThreads(defaultNumberOfThreads());
-
-        m_task_position = 0;
+        setNumOfThreads(nthreads);
     }
     else
     {
         m_num_threads = 1;
         m_pool_state = eTMFailedToInit;
-        m_task_position = 0;
-
-        //print error;
     }
 }
 
@@ -403,119 +413,202 @@ ThreadManager::~ThreadManager()
 {
     stop();
 
-    pthread_mutex_destroy(&m_manager_task_mutex);
+    pthread_mutex_destroy(&m_mutex);
 
-    pthread_cond_destroy(&m_cond_thread_task_complete);
+    pthread_cond_destroy(&m_cond_job_posted);
 
-    pthread_mutex_destroy(&m_manager_access_mutex);
+    pthread_cond_destroy(&m_cond_job_left);
 }
 
-void ThreadManager::run(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
+void* ThreadManager::thread_loop_wrapper(void* arg)
 {
-    bool is_work_thread = m_is_work_thread.get()->value;
+    thread_arg* a = (thread_arg*)arg;
+    a->manager->thread_body(a->id);
+    return 0;
+}
 
-    if( (getNumOfThreads() > 1) && !is_work_thread &&
-        (range.end - range.start > 1) && (nstripes <= 0 || nstripes >= 1.5) )
+void ThreadManager::setAffinity()
+{
+#if defined __linux__ && defined CPU_SET && !defined ANDROID
+    if(!m_cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        for(size_t i = 0; i < m_cpus.size(); ++i)
+        {
+            if(m_cpus[i] >= 0 && m_cpus[i] < CPU_SETSIZE)
+                CPU_SET(m_cpus[i], &set);
+        }
+
+        //not fatal, the thread keeps the inherited mask
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+}
+
+void ThreadManager::thread_body(int id)
+{
+    work_thread_t* tls = getWorkThreadTls().get();
+    tls->owner = this;
+    tls->value = id + 1;
+
+    setAffinity();
+
+    pthread_mutex_lock(&m_mutex);
+
+    while(!m_stop)
     {
-        int res = pthread_mutex_trylock(&m_manager_access_mutex);
+        //the most recent job first: it is usually a nested loop blocking an outer one
+        ParallelJob* job = 0;
 
-        if(!res)
+        for(size_t i = m_jobs.size(); i > 0; --i)
         {
-            if(initPool())
+            if(m_jobs[i - 1]->hasWork())
             {
-                if(nstripes < 1) nstripes = 4*m_threads.size();
+                job = m_jobs[i - 1];
+                break;
+            }
+        }
+
+        if(!job)
+        {
+            pthread_cond_wait(&m_cond_job_posted, &m_mutex);
+            continue;
+        }
+
+        job->m_workers++;
+
+        pthread_mutex_unlock(&m_mutex);
+
+        job->execute((id + 1) % job->slotsCount());
+
+        pthread_mutex_lock(&m_mutex);
+
+        if(--job->m_workers == 0)
+            pthread_cond_broadcast(&m_cond_job_left);
+    }
+
+    pthread_mutex_unlock(&m_mutex);
+}
 
-                double max_stripes = 4*m_threads.size();
+void ThreadManager::run(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
+{
+    if( (getNumOfThreads() > 1) &&
+        (range.end - range.start > 1) && (nstripes <= 0 || nstripes >= 1.5) )
+    {
+        pthread_mutex_lock(&m_mutex);
 
-                nstripes = std::min(nstripes, max_stripes);
+        bool res = initPool();
 
-                pthread_mutex_lock(&m_manager_task_mutex);
+        int nslots = (int)m_threads.size() + 1;
 
-                m_num_of_completed_tasks = 0;
+        pthread_mutex_unlock(&m_mutex);
 
-                m_task_position = 0;
+        if(res && nslots > 1)
+        {
+            ParallelJob job(range, body, nstripes, nslots, m_target_ticks);
+
+            pthread_mutex_lock(&m_mutex);
 
-                m_task_complete = false;
+            m_jobs.push_back(&job);
 
-                m_work_load.set(range, body, cvCeil(nstripes));
+            pthread_cond_broadcast(&m_cond_job_posted);
 
-                for(size_t i = 0; i < m_threads.size(); ++i)
-                {
-                    m_threads[i].run();
-                }
+            pthread_mutex_unlock(&m_mutex);
 
-                wait_complete();
+            try
+            {
+                job.execute(0);
             }
-            else
+            catch(...)
             {
-                //print error
-                body(range);
+                job.cancel();
+                finish(job);
+                throw;
             }
+
+            finish(job);
+
+            return;
         }
-        else
-        {
-            body(range);
-        }
-    }
-    else
-    {
-        body(range);
     }
+
+    body(range);
 }
 
-void ThreadManager::wait_complete()
+void ThreadManager::finish(ParallelJob& job)
 {
-    //to handle spurious wakeups
-    while(!m_task_complete)
-        pthread_cond_wait(&m_cond_thread_task_complete, &m_manager_task_mutex);
+    pthread_mutex_lock(&m_mutex);
 
-    pthread_mutex_unlock(&m_manager_task_mutex);
+    m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), &job));
 
-    pthread_mutex_unlock(&m_manager_access_mutex);
+    //everything is claimed by now, wait for the chunks still running in the pool
+    while(job.m_workers > 0)
+        pthread_cond_wait(&m_cond_job_left, &m_mutex);
+
+    pthread_mutex_unlock(&m_mutex);
 }
 
-void ThreadManager::notify_complete()
+bool ThreadManager::initPool()
 {
+    if(m_pool_state != eTMNotInited || m_num_threads == 1)
+        return m_pool_state != eTMFailedToInit;
+
+    if(m_stop)
+        return false;
+
+    size_t n = m_num_threads - 1;
 
-    unsigned int comp = CV_XADD(&m_num_of_completed_tasks, 1);
+    m_thread_args.resize(n);
+    m_threads.reserve(n);
 
-    if(comp == (m_num_threads - 1))
+    for(size_t i = 0; i < n; ++i)
     {
-        pthread_mutex_lock(&m_manager_task_mutex);
+        pthread_t thread;
 
-        m_task_complete = true;
+        m_thread_args[i].manager = this;
+        m_thread_args[i].id = (int)i;
 
-        pthread_cond_signal(&m_cond_thread_task_complete);
+        if(pthread_create(&thread, NULL, thread_loop_wrapper, (void*)&m_thread_args[i]) != 0)
+            break;
 
-        pthread_mutex_unlock(&m_manager_task_mutex);
+        m_threads.push_back(thread);
     }
+
+    //the pool works with whatever number of threads could be started
+    m_pool_state = eTMInited;
+
+    return true;
 }
 
-bool ThreadManager::initPool()
+void ThreadManager::stop()
 {
-    if(m_pool_state != eTMNotInited || m_num_threads == 1)
-        return true;
+    std::vector<pthread_t> threads;
 
-    m_threads.resize(m_num_threads);
+    pthread_mutex_lock(&m_mutex);
 
-    bool res = true;
+    m_stop = true;
 
-    for(size_t i = 0; i < m_threads.size(); ++i)
-    {
-        res |= m_threads[i].init(i, this);
-    }
+    threads.swap(m_threads);
 
-    if(res)
-    {
-        m_pool_state = eTMInited;
-    }
-    else
+    pthread_cond_broadcast(&m_cond_job_posted);
+
+    pthread_mutex_unlock(&m_mutex);
+
+    for(size_t i = 0; i < threads.size(); ++i)
     {
-        //TODO: join threads?
-        m_pool_state = eTMFailedToInit;
+        pthread_join(threads[i], NULL);
     }
 
-    return res;
+    pthread_mutex_lock(&m_mutex);
+
+    m_stop = false;
+
+    if(m_pool_state == eTMInited)
+        m_pool_state = eTMNotInited;
+
+    pthread_mutex_unlock(&m_mutex);
 }
 
 size_t ThreadManager::getNumOfThreads()
@@ -525,6 +618,10 @@ size_t ThreadManager::getNumOfThreads()
 
 void ThreadManager::setNumOfThreads(size_t n)
 {
+    //a pool thread can't join itself, the pool is resized from other threads only
+    if(getWorkThreadTls().get()->owner == this)
+        return;
+
     int res = pthread_mutex_lock(&m_manager_access_mutex);
 
     if(!res)
@@ -536,22 +633,11 @@ void ThreadManager::setNumOfThreads(size_t n)
 
         if(n != m_num_threads && m_pool_state != eTMFailedToInit)
         {
-            if(m_pool_state == eTMInited)
-            {
-                stop();
-                m_threads.clear();
-            }
+            stop();
 
             m_num_threads = n;
 
-            if(m_num_threads == 1)
-            {
-                m_pool_state = eTMSingleThreaded;
-            }
-            else
-            {
-                m_pool_state = eTMNotInited;
-            }
+            m_pool_state = m_num_threads == 1 ? eTMSingleThreaded : eTMNotInited;
         }
 
         pthread_mutex_unlock(&m_manager_access_mutex);
@@ -560,7 +646,13 @@ void ThreadManager::setNumOfThreads(size_t n)
 
 size_t ThreadManager::defaultNumberOfThreads()
 {
-    unsigned int result = m_default_number_of_threads;
+#ifdef ANDROID
+    // many modern phones/tables have 4-core CPUs. Let's use no more
+    // than 2 threads by default not to overheat the devices
+    unsigned int result = 2;
+#else
+    unsigned int result = (unsigned int)std::max(cv::getNumberOfCPUs(), 1);
+#endif
 
     char * env = getenv(m_env_name);
 
@@ -579,9 +671,22 @@ void parallel_for_pthreads(const cv::Range& range, const cv::ParallelLoopBody& b
 size_t parallel_pthreads_get_threads_num();
 void parallel_pthreads_set_threads_num(int num);
 
+ThreadManager* parallel_pthreads_create_pool(int num, const std::vector<int>& cpus);
+void parallel_pthreads_release_pool(ThreadManager* pool);
+void parallel_for_pthreads(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes, ThreadManager* pool);
+size_t parallel_pthreads_get_threads_num(ThreadManager* pool);
+void parallel_pthreads_set_threads_num(int num, ThreadManager* pool);
+
+//pool the current thread belongs to, the process-wide one for user threads
+static ThreadManager& currentPool()
+{
+    ThreadManager* pool = getWorkThreadTls().get()->owner;
+    return pool ? *pool : ThreadManager::instance();
+}
+
 size_t parallel_pthreads_get_threads_num()
 {
-    return ThreadManager::instance().getNumOfThreads();
+    return currentPool().getNumOfThreads();
 }
 
 void parallel_pthreads_set_threads_num(int num)
@@ -598,7 +703,32 @@ void parallel_pthreads_set_threads_num(int num)
 
 void parallel_for_pthreads(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
 {
-    ThreadManager::instance().run(range, body, nstripes);
+    currentPool().run(range, body, nstripes);
+}
+
+ThreadManager* parallel_pthreads_create_pool(int num, const std::vector<int>& cpus)
+{
+    return new ThreadManager(size_t(std::max(num, 0)), cpus);
+}
+
+void parallel_pthreads_release_pool(ThreadManager* pool)
+{
+    delete pool;
+}
+
+void parallel_for_pthreads(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes, ThreadManager* pool)
+{
+    pool->run(range, body, nstripes);
+}
+
+size_t parallel_pthreads_get_threads_num(ThreadManager* pool)
+{
+    return pool->getNumOfThreads();
+}
+
+void parallel_pthreads_set_threads_num(int num, ThreadManager* pool)
+{
+    pool->setNumOfThreads(size_t(std::max(num, 0)));
 }
 
 }
@@ -67,6 +67,15 @@
 #  include <zlib.h>
 #endif
 
+#if defined WIN32 || defined _WIN32 || defined WINCE
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 /****************************************************************************************\
 *                            Common macros and type definitions                          *
 \****************************************************************************************/
@@ -172,6 +181,98 @@ typedef struct CvFileMapNode
 }
 CvFileMapNode;
 
+// A sequence of numbers read from the binary storage. Its nodes are not created while the file
+// is loaded: `total` is the number of the numbers, which stay in the loaded file and are copied or
+// converted from there at once. The nodes are created when the elements are first accessed one by
+// one (see icvFSCreateRawNodes); until then the sequence has no blocks.
+typedef struct CvFileRawSeq
+{
+    CV_SEQUENCE_FIELDS()
+    const uchar* raw_data;
+    int raw_depth;
+    int has_nodes;
+}
+CvFileRawSeq;
+
+#define CV_NODE_SEQ_RAW 512
+#define CV_NODE_SEQ_IS_RAW(seq) (((seq)->flags & CV_NODE_SEQ_RAW) != 0)
+
+// A binary storage file mapped into memory with CV_STORAGE_MMAP. The mapping is private, so the
+// processes mapping the same file share its pages until they modify them. It is referenced by the
+// storage and by the matrices read from it, and is unmapped when the last of them is released.
+typedef struct CvFileMapping
+{
+    int refcount;
+    uchar* data;
+    size_t size;
+}
+CvFileMapping;
+
+static CvFileMapping*
+icvMapFile( const char* filename )
+{
+    uchar* data = 0;
+    size_t size = 0;
+#if defined WINRT
+    (void)filename;
+#elif defined WIN32 || defined _WIN32 || defined WINCE
+    HANDLE file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, 0 );
+    if( file == INVALID_HANDLE_VALUE )
+        return 0;
+    LARGE_INTEGER file_size;
+    if( GetFileSizeEx( file, &file_size ) && file_size.QuadPart > 0 &&
+        (uint64)file_size.QuadPart <= (uint64)(size_t)-1 )
+    {
+        HANDLE mapping = CreateFileMappingA( file, 0, PAGE_WRITECOPY, 0, 0, 0 );
+        if( mapping )
+        {
+            data = (uchar*)MapViewOfFile( mapping, FILE_MAP_COPY, 0, 0, 0 );
+            size = (size_t)file_size.QuadPart;
+            CloseHandle( mapping );
+        }
+    }
+    CloseHandle( file );
+#else
+    int fd = open( filename, O_RDONLY );
+    if( fd < 0 )
+        return 0;
+    struct stat st;
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        void* ptr = mmap( 0, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+        if( ptr != MAP_FAILED )
+        {
+            data = (uchar*)ptr;
+            size = (size_t)st.st_size;
+        }
+    }
+    close( fd );
+#endif
+    if( !data )
+        return 0;
+
+    CvFileMapping* mapping = (CvFileMapping*)cvAlloc( sizeof(*mapping) );
+    mapping->refcount = 1;
+    mapping->data = data;
+    mapping->size = size;
+    return mapping;
+}
+
+static void
+icvReleaseFileMapping( CvFileMapping* mapping )
+{
+    if( !mapping || CV_XADD( &mapping->refcount, -1 ) != 1 )
+        return;
+#if defined WINRT
+#elif defined WIN32 || defined _WIN32 || defined WINCE
+    UnmapViewOfFile( mapping->data );
+#else
+    munmap( mapping->data, mapping->size );
+#endif
+    cvFree( &mapping );
+}
+
 typedef struct CvXMLStackRecord
 {
     CvMemStoragePos pos;
@@ -238,6 +339,12 @@ typedef struct CvFileStorage
     size_t strbufsize, strbufpos;
     std::deque<char>* outbuf;
 
+    uchar* bindata; // contents of the binary storage, referenced by the raw sequences
+    CvFileMapping* mapping; // the mapped binary file, if bindata points into it
+    size_t binpos; // number of bytes written to the binary storage
+    CvSeq* raw_seqs; // the raw sequences of the binary storage
+    int raw_nodes_created; // set once the nodes of all of them are created for the C API
+
     bool is_opened;
 }
 CvFileStorage;
@@ -330,6 +437,9 @@ static void icvRewind( CvFileStorage* fs )
 #define CV_YML_INDENT_FLOW  1
 #define CV_FS_MAX_LEN 4096
 
+static const char icvTypeSymbol[] = "ucwsifdr";
+#define CV_FS_MAX_FMT_PAIRS  128
+
 #define CV_FILE_STORAGE ('Y' + ('A' << 8) + ('M' << 16) + ('L' << 24))
 #define CV_IS_FILE_STORAGE(fs) ((fs) != 0 && (fs)->flags == CV_FILE_STORAGE)
 
@@ -509,6 +619,9 @@ icvFSFlush( CvFileStorage* fs )
 }
 
 
+static void
+icvBinEndStream( CvFileStorage* fs );
+
 static void
 icvClose( CvFileStorage* fs, cv::String* out )
 {
@@ -527,9 +640,14 @@ icvClose( CvFileStorage* fs, cv::String* out )
                 while( fs->write_stack->total > 0 )
                     cvEndWriteStruct(fs);
             }
-            icvFSFlush(fs);
-            if( fs->fmt == CV_STORAGE_FORMAT_XML )
-                icvPuts( fs, "</opencv_storage>\n" );
+            if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+                icvBinEndStream(fs);
+            else
+            {
+                icvFSFlush(fs);
+                if( fs->fmt == CV_STORAGE_FORMAT_XML )
+                    icvPuts( fs, "</opencv_storage>\n" );
+            }
         }
 
         icvCloseFile(fs);
@@ -558,6 +676,10 @@ cvReleaseFileStorage( CvFileStorage** p_fs )
 
         cvReleaseMemStorage( &fs->strstorage );
         cvFree( &fs->buffer_start );
+        if( fs->mapping )
+            icvReleaseFileMapping( fs->mapping );
+        else
+            cvFree( &fs->bindata );
         cvReleaseMemStorage( &fs->memstorage );
 
         if( fs->outbuf )
@@ -620,10 +742,13 @@ cvGetHashedKey( CvFileStorage* fs, const char* str, int len, int create_missing
 }
 
 
-CV_IMPL CvFileNode*
-cvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
-               const CvStringHashNode* key,
-               int create_missing )
+static void icvFSCreateRawNodes( CvSeq* seq );
+static void icvFSCreateAllRawNodes( const CvFileStorage* fs );
+
+static CvFileNode*
+icvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
+                const CvStringHashNode* key,
+                int create_missing )
 {
     CvFileNode* value = 0;
     int k = 0, attempts = 1;
@@ -695,8 +820,8 @@ cvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
 }
 
 
-CV_IMPL CvFileNode*
-cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const char* str )
+static CvFileNode*
+icvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const char* str )
 {
     CvFileNode* value = 0;
     int i, len, tab_size;
@@ -766,8 +891,8 @@ cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const
 }
 
 
-CV_IMPL CvFileNode*
-cvGetRootFileNode( const CvFileStorage* fs, int stream_index )
+static CvFileNode*
+icvGetRootFileNode( const CvFileStorage* fs, int stream_index )
 {
     CV_CHECK_FILE_STORAGE(fs);
 
@@ -777,6 +902,47 @@ cvGetRootFileNode( const CvFileStorage* fs, int stream_index )
     return (CvFileNode*)cvGetSeqElem( fs->roots, stream_index );
 }
 
+static inline int
+icvReadIntByName( const CvFileStorage* fs, const CvFileNode* map, const char* name, int default_value )
+{
+    return cvReadInt( icvGetFileNodeByName( fs, map, name ), default_value );
+}
+
+static inline const char*
+icvReadStringByName( const CvFileStorage* fs, const CvFileNode* map, const char* name, const char* default_value )
+{
+    return cvReadString( icvGetFileNodeByName( fs, map, name ), default_value );
+}
+
+// The C API may walk any sequence it gets a node of, so the nodes of all the raw sequences are
+// created once it looks a node up. The storage is read through the icv* functions above internally.
+
+CV_IMPL CvFileNode*
+cvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
+               const CvStringHashNode* key,
+               int create_missing )
+{
+    if( CV_IS_FILE_STORAGE(fs) )
+        icvFSCreateAllRawNodes( fs );
+    return icvGetFileNode( fs, _map_node, key, create_missing );
+}
+
+CV_IMPL CvFileNode*
+cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const char* str )
+{
+    if( CV_IS_FILE_STORAGE(fs) )
+        icvFSCreateAllRawNodes( fs );
+    return icvGetFileNodeByName( fs, _map_node, str );
+}
+
+CV_IMPL CvFileNode*
+cvGetRootFileNode( const CvFileStorage* fs, int stream_index )
+{
+    if( CV_IS_FILE_STORAGE(fs) )
+        icvFSCreateAllRawNodes( fs );
+    return icvGetRootFileNode( fs, stream_index );
+}
+
 
 /* returns the sequence element by its index */
 /*CV_IMPL CvFileNode*
@@ -920,9 +1086,93 @@ icvProcessSpecialDouble( CvFileStorage* fs, char* buf, double* value, char** end
 }
 
 
+// Parses the decimal numbers with at most 15 significant digits and a small exponent.
+// Both the mantissa and the power of 10 are exact doubles then, so the single multiplication
+// or division gives the correctly rounded value, the same as strtod returns.
+static bool icvParseDecimal( char* ptr, char** endptr, double* value )
+{
+    static const double pow10[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    char* p = ptr;
+    bool neg = *p == '-';
+    int64 m = 0;
+    int digits = 0, ndigits = 0, exp10 = 0;
+
+    p += *p == '-' || *p == '+';
+    for( ; cv_isdigit(*p); p++, ndigits++ )
+    {
+        if( m != 0 || *p != '0' )
+            digits++;
+        m = m*10 + (*p - '0');
+        if( digits > 15 )
+            return false;
+    }
+    if( *p == '.' )
+    {
+        for( p++; cv_isdigit(*p); p++, ndigits++, exp10-- )
+        {
+            if( m != 0 || *p != '0' )
+                digits++;
+            m = m*10 + (*p - '0');
+            if( digits > 15 )
+                return false;
+        }
+    }
+    if( ndigits == 0 )
+        return false;
+    if( *p == 'e' || *p == 'E' )
+    {
+        char* q = p + 1;
+        bool eneg = *q == '-';
+        int e = 0;
+        q += *q == '-' || *q == '+';
+        if( !cv_isdigit(*q) )
+            return false;
+        for( ; cv_isdigit(*q) && e < 1000; q++ )
+            e = e*10 + (*q - '0');
+        exp10 += eneg ? -e : e;
+        p = q;
+    }
+    // hexadecimal numbers, inf, nan and the long exponents are left to strtod
+    if( cv_isalnum(*p) || *p == '.' || exp10 < -22 || exp10 > 22 )
+        return false;
+
+    double v = (double)m;
+    v = exp10 < 0 ? v / pow10[-exp10] : v * pow10[exp10];
+    *value = neg ? -v : v;
+    *endptr = p;
+    return true;
+}
+
+// decimal numbers of up to 9 digits are converted in place; the others go to strtol,
+// which also handles the octal and hexadecimal ones
+static int icv_strtol( char* ptr, char** endptr )
+{
+    char* p = ptr + (*ptr == '-' || *ptr == '+');
+    if( *p != '0' || !cv_isalnum(p[1]) )
+    {
+        int val = 0, n = 0;
+        for( ; n < 10 && cv_isdigit(p[n]); n++ )
+            val = val*10 + (p[n] - '0');
+        if( n > 0 && n < 10 )
+        {
+            *endptr = p + n;
+            return *ptr == '-' ? -val : val;
+        }
+    }
+    return (int)strtol( ptr, endptr, 0 );
+}
+
 static double icv_strtod( CvFileStorage* fs, char* ptr, char** endptr )
 {
-    double fval = strtod( ptr, endptr );
+    double fval;
+    if( icvParseDecimal( ptr, endptr, &fval ) )
+        return fval;
+
+    fval = strtod( ptr, endptr );
     if( **endptr == '.' )
     {
         char* dot_pos = *endptr;
@@ -1021,7 +1271,7 @@ icvYMLParseKey( CvFileStorage* fs, char* ptr,
         CV_PARSE_ERROR( "An empty key" );
 
     str_hash_node = cvGetHashedKey( fs, ptr, (int)(endptr - ptr), 1 );
-    *value_placeholder = cvGetFileNode( fs, map_node, str_hash_node, 1 );
+    *value_placeholder = icvGetFileNode( fs, map_node, str_hash_node, 1 );
     ptr = saveptr;
 
     return ptr;
@@ -1119,7 +1369,7 @@ force_real:
         else
         {
 force_int:
-            ival = (int)strtol( ptr, &endptr, 0 );
+            ival = icv_strtol( ptr, &endptr );
             node->tag = CV_NODE_INT;
             node->data.i = ival;
         }
@@ -1893,7 +2143,7 @@ icvXMLParseValue( CvFileStorage* fs, char* ptr, CvFileNode* node,
             if( is_noname )
                 elem = (CvFileNode*)cvSeqPush( node->data.seq, 0 );
             else
-                elem = cvGetFileNode( fs, node, key, 1 );
+                elem = icvGetFileNode( fs, node, key, 1 );
 
             ptr = icvXMLParseValue( fs, ptr, elem, elem_type);
             if( !is_noname )
@@ -1939,7 +2189,7 @@ icvXMLParseValue( CvFileStorage* fs, char* ptr, CvFileNode* node,
                 }
                 else
                 {
-                    ival = (int)strtol( ptr, &endptr, 0 );
+                    ival = icv_strtol( ptr, &endptr );
                     elem->tag = CV_NODE_INT;
                     elem->data.i = ival;
                 }
@@ -2643,12 +2893,594 @@ icvXMLWriteComment( CvFileStorage* fs, const char* comment, int eol_comment )
 }
 
 
+/****************************************************************************************\
+*                                     Binary Storage                                     *
+\****************************************************************************************/
+
+/*
+ The binary storage is the signature followed by the streams. A stream is the top-level map or
+ sequence. Each node is stored as its tag byte, the key (when the parent is a map) and the value:
+
+   'i'      - 32-bit integer;
+   'r'      - 64-bit floating-point number;
+   's'      - string: 32-bit length and the characters;
+   '{', '[' - map or sequence: the type name (a string, empty for the untyped collections),
+              the elements and the closing '}' or ']';
+   'a'      - the data written by cvWriteRawData (sequence elements only): the format string,
+              32-bit number of records and 64-bit size of the data. The data starts at the next
+              multiple of 64 bytes from the beginning of the storage and holds the records packed,
+              without the alignment gaps. References ('r' format) are stored as 32-bit integers.
+
+ All the numbers are little-endian.
+*/
+
+#define CV_BIN_SIGNATURE "%OCVBIN:1.0\n"
+#define CV_BIN_SIGNATURE_LEN 12
+#define CV_BIN_DATA_ALIGN 64
+// shorter arrays are converted to the nodes when the storage is loaded
+#define CV_BIN_MIN_RAW_SEQ 256
+
+static int
+icvDecodeFormat( const char* dt, int* fmt_pairs, int max_len );
+
+static bool icvIsBigEndian()
+{
+    const int one = 1;
+    return *(const uchar*)&one == 0;
+}
+
+static void
+icvBinPutBytes( CvFileStorage* fs, const void* data, size_t len )
+{
+    const char* ptr = (const char*)data;
+    if( fs->outbuf )
+        fs->outbuf->insert( fs->outbuf->end(), ptr, ptr + len );
+    else if( fs->file )
+        fwrite( ptr, 1, len, fs->file );
+#if USE_ZLIB
+    else if( fs->gzfile )
+    {
+        for( size_t ofs = 0; ofs < len; ofs += 1 << 30 )
+            gzwrite( fs->gzfile, ptr + ofs, (unsigned)std::min(len - ofs, (size_t)1 << 30) );
+    }
+#endif
+    else
+        CV_Error( CV_StsError, "The storage is not opened" );
+    fs->binpos += len;
+}
+
+static void
+icvBinPutU32( CvFileStorage* fs, unsigned val )
+{
+    uchar buf[] = { (uchar)val, (uchar)(val >> 8), (uchar)(val >> 16), (uchar)(val >> 24) };
+    icvBinPutBytes( fs, buf, sizeof(buf) );
+}
+
+static void
+icvBinPutU64( CvFileStorage* fs, uint64 val )
+{
+    icvBinPutU32( fs, (unsigned)val );
+    icvBinPutU32( fs, (unsigned)(val >> 32) );
+}
+
+static void
+icvBinPutString( CvFileStorage* fs, const char* str )
+{
+    size_t len = str ? strlen(str) : 0;
+    icvBinPutU32( fs, (unsigned)len );
+    icvBinPutBytes( fs, str, len );
+}
+
+// writes the tag and the key of a node; the first node of a stream starts the top-level collection
+static void
+icvBinWriteNode( CvFileStorage* fs, const char* key, char tag )
+{
+    int struct_flags = fs->struct_flags;
+
+    if( key && key[0] == '\0' )
+        key = 0;
+
+    if( CV_NODE_IS_COLLECTION(struct_flags) )
+    {
+        if( (CV_NODE_IS_MAP(struct_flags) ^ (key != 0)) )
+            CV_Error( CV_StsBadArg, "An attempt to add element without a key to a map, "
+                                    "or add element with key to sequence" );
+    }
+
+    if( key )
+    {
+        // the keys are restricted as in YAML, so the storage can be converted to the text formats
+        int i, keylen = (int)strlen(key);
+        if( keylen > CV_FS_MAX_LEN )
+            CV_Error( CV_StsBadArg, "The key is too long" );
+
+        if( !cv_isalpha(key[0]) && key[0] != '_' )
+            CV_Error( CV_StsBadArg, "Key must start with a letter or _" );
+
+        for( i = 0; i < keylen; i++ )
+        {
+            char c = key[i];
+            if( !cv_isalnum(c) && c != '-' && c != '_' && c != ' ' )
+                CV_Error( CV_StsBadArg, "Key names may only contain alphanumeric characters [a-zA-Z0-9], '-', '_' and ' '" );
+        }
+    }
+
+    if( !CV_NODE_IS_COLLECTION(struct_flags) )
+    {
+        fs->is_first = 0;
+        struct_flags = key ? CV_NODE_MAP : CV_NODE_SEQ;
+        icvBinPutBytes( fs, key ? "{" : "[", 1 );
+        icvBinPutString( fs, 0 );
+    }
+
+    icvBinPutBytes( fs, &tag, 1 );
+    if( key )
+        icvBinPutString( fs, key );
+    fs->struct_flags = struct_flags;
+}
+
+static void
+icvBinStartWriteStruct( CvFileStorage* fs, const char* key, int struct_flags,
+                        const char* type_name CV_DEFAULT(0))
+{
+    int parent_flags;
+
+    struct_flags &= CV_NODE_TYPE_MASK;
+    if( !CV_NODE_IS_COLLECTION(struct_flags))
+        CV_Error( CV_StsBadArg,
+        "Some collection type - CV_NODE_SEQ or CV_NODE_MAP, must be specified" );
+
+    icvBinWriteNode( fs, key, CV_NODE_IS_MAP(struct_flags) ? '{' : '[' );
+    icvBinPutString( fs, type_name );
+
+    parent_flags = fs->struct_flags;
+    cvSeqPush( fs->write_stack, &parent_flags );
+    fs->struct_flags = struct_flags;
+}
+
+static void
+icvBinEndWriteStruct( CvFileStorage* fs )
+{
+    int parent_flags = 0;
+
+    if( fs->write_stack->total == 0 )
+        CV_Error( CV_StsError, "EndWriteStruct w/o matching StartWriteStruct" );
+
+    icvBinPutBytes( fs, CV_NODE_IS_MAP(fs->struct_flags) ? "}" : "]", 1 );
+    cvSeqPop( fs->write_stack, &parent_flags );
+    fs->struct_flags = parent_flags;
+}
+
+// closes the open collections, including the top-level one
+static void
+icvBinEndStream( CvFileStorage* fs )
+{
+    while( fs->write_stack->total > 0 )
+        icvBinEndWriteStruct( fs );
+
+    if( CV_NODE_IS_COLLECTION(fs->struct_flags) )
+        icvBinPutBytes( fs, CV_NODE_IS_MAP(fs->struct_flags) ? "}" : "]", 1 );
+    fs->struct_flags = CV_NODE_EMPTY;
+}
+
+static void
+icvBinStartNextStream( CvFileStorage* fs )
+{
+    if( !fs->is_first )
+    {
+        icvBinEndStream( fs );
+        fs->is_first = 1;
+    }
+}
+
+static void
+icvBinWriteInt( CvFileStorage* fs, const char* key, int value )
+{
+    icvBinWriteNode( fs, key, 'i' );
+    icvBinPutU32( fs, (unsigned)value );
+}
+
+static void
+icvBinWriteReal( CvFileStorage* fs, const char* key, double value )
+{
+    union { double f; uint64 u; } v;
+    v.f = value;
+    icvBinWriteNode( fs, key, 'r' );
+    icvBinPutU64( fs, v.u );
+}
+
+static void
+icvBinWriteString( CvFileStorage* fs, const char* key,
+                   const char* str, int /*quote*/ CV_DEFAULT(0))
+{
+    if( !str )
+        CV_Error( CV_StsNullPtr, "Null string pointer" );
+
+    if( strlen(str) > CV_FS_MAX_LEN )
+        CV_Error( CV_StsBadArg, "The written string is too long" );
+
+    icvBinWriteNode( fs, key, 's' );
+    icvBinPutString( fs, str );
+}
+
+// comments are not stored in the binary format
+static void
+icvBinWriteComment( CvFileStorage*, const char*, int )
+{
+}
+
+
+static void
+icvBinCheckSize( CvFileStorage* fs, const uchar* ptr, const uchar* end, size_t size )
+{
+    if( (size_t)(end - ptr) < size )
+        CV_PARSE_ERROR( "Unexpected end of the binary data" );
+}
+
+static unsigned
+icvBinGetU32( CvFileStorage* fs, const uchar*& ptr, const uchar* end )
+{
+    icvBinCheckSize( fs, ptr, end, 4 );
+    unsigned val = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((unsigned)ptr[3] << 24);
+    ptr += 4;
+    return val;
+}
+
+static uint64
+icvBinGetU64( CvFileStorage* fs, const uchar*& ptr, const uchar* end )
+{
+    uint64 lo = icvBinGetU32( fs, ptr, end );
+    uint64 hi = icvBinGetU32( fs, ptr, end );
+    return lo | (hi << 32);
+}
+
+static const char*
+icvBinGetString( CvFileStorage* fs, const uchar*& ptr, const uchar* end, int* len )
+{
+    unsigned n = icvBinGetU32( fs, ptr, end );
+    icvBinCheckSize( fs, ptr, end, n );
+    const char* str = (const char*)ptr;
+    ptr += n;
+    *len = (int)n;
+    return str;
+}
+
+// appends the numbers of the packed records to the sequence as the nodes
+static void
+icvBinPushRawNodes( CvSeq* seq, const uchar* data, const int* fmt_pairs, int fmt_pair_count, int count )
+{
+    for( ; count > 0; count-- )
+    {
+        for( int k = 0; k < fmt_pair_count; k++ )
+        {
+            int elem_type = fmt_pairs[k*2+1];
+            int elem_size = CV_ELEM_SIZE(elem_type);
+
+            for( int i = 0; i < fmt_pairs[k*2]; i++, data += elem_size )
+            {
+                union { uchar u; schar c; ushort w; short s; int i; float f; double d; } v;
+                CvFileNode* node = (CvFileNode*)cvSeqPush( seq, 0 );
+
+                memcpy( &v, data, elem_size );
+                node->info = 0;
+                node->tag = elem_type < CV_32F ? CV_NODE_INT : CV_NODE_REAL;
+                switch( elem_type )
+                {
+                case CV_8U: node->data.i = v.u; break;
+                case CV_8S: node->data.i = v.c; break;
+                case CV_16U: node->data.i = v.w; break;
+                case CV_16S: node->data.i = v.s; break;
+                case CV_32S: node->data.i = v.i; break;
+                case CV_32F: node->data.f = v.f; break;
+                default: node->data.f = v.d;
+                }
+            }
+        }
+    }
+}
+
+static cv::Mutex rawSeqMutex;
+
+// Creates the nodes of a raw sequence the first time they are needed, i.e. when its elements are
+// accessed one by one. The nodes are pushed into a separate sequence and its blocks are attached
+// at once, so `total` does not change and the threads reading the numbers are not disturbed.
+static void
+icvFSCreateRawNodes( CvSeq* seq )
+{
+    CvFileRawSeq* raw = (CvFileRawSeq*)seq;
+    if( !CV_NODE_SEQ_IS_RAW(seq) || CV_XADD(&raw->has_nodes, 0) != 0 )
+        return;
+
+    cv::AutoLock lock(rawSeqMutex);
+    if( raw->has_nodes )
+        return;
+
+    int fmt_pairs[] = { 1, raw->raw_depth };
+    CvSeq* nodes = cvCreateSeq( 0, sizeof(CvSeq), sizeof(CvFileNode), seq->storage );
+    icvBinPushRawNodes( nodes, raw->raw_data, fmt_pairs, 1, seq->total );
+    seq->first = nodes->first;
+    seq->ptr = nodes->ptr;
+    seq->block_max = nodes->block_max;
+    seq->delta_elems = nodes->delta_elems;
+    seq->free_blocks = nodes->free_blocks;
+    CV_XADD(&raw->has_nodes, 1);
+}
+
+static void
+icvFSCreateAllRawNodes( const CvFileStorage* _fs )
+{
+    CvFileStorage* fs = (CvFileStorage*)_fs;
+    if( !fs->raw_seqs || CV_XADD(&fs->raw_nodes_created, 0) != 0 )
+        return;
+
+    for( int i = 0; i < fs->raw_seqs->total; i++ )
+        icvFSCreateRawNodes( *(CvSeq**)cvGetSeqElem( fs->raw_seqs, i ) );
+    CV_XADD(&fs->raw_nodes_created, 1);
+}
+
+static const uchar*
+icvBinParseRawData( CvFileStorage* fs, const uchar* ptr, const uchar* end, CvSeq* seq, int closing )
+{
+    int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2], k, len, fmt_pair_count, count;
+    int depth = -1, record_size = 0, record_len = 0;
+    char dt[CV_FS_MAX_FMT_PAIRS*4];
+    const char* dtstr = icvBinGetString( fs, ptr, end, &len );
+
+    if( len >= (int)sizeof(dt) )
+        CV_PARSE_ERROR( "Too long data type specification" );
+    memcpy( dt, dtstr, len );
+    dt[len] = '\0';
+    fmt_pair_count = icvDecodeFormat( dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+
+    count = (int)icvBinGetU32( fs, ptr, end );
+    uint64 size = icvBinGetU64( fs, ptr, end );
+
+    for( k = 0; k < fmt_pair_count; k++ )
+    {
+        int elem_type = fmt_pairs[k*2+1];
+        if( elem_type == CV_USRTYPE1 )
+            CV_PARSE_ERROR( "Invalid raw data type" );
+        depth = k == 0 || depth == elem_type ? elem_type : -1;
+        record_size += fmt_pairs[k*2]*CV_ELEM_SIZE(elem_type);
+        record_len += fmt_pairs[k*2];
+    }
+    if( fmt_pair_count == 0 || count < 0 || size != (uint64)record_size*count ||
+        (uint64)record_len*count > INT_MAX )
+        CV_PARSE_ERROR( "Invalid raw data block" );
+
+    size_t pad = (CV_BIN_DATA_ALIGN - (ptr - fs->bindata) % CV_BIN_DATA_ALIGN) % CV_BIN_DATA_ALIGN;
+    icvBinCheckSize( fs, ptr, end, pad + (size_t)size );
+    uchar* data = fs->bindata + (ptr - fs->bindata) + pad;
+    ptr += pad + size;
+
+    if( icvIsBigEndian() )
+    {
+        uchar* p = data;
+        for( int i = 0; i < count; i++ )
+            for( k = 0; k < fmt_pair_count; k++ )
+            {
+                int elem_size = CV_ELEM_SIZE(fmt_pairs[k*2+1]);
+                for( int j = 0; j < fmt_pairs[k*2]; j++, p += elem_size )
+                    std::reverse( p, p + elem_size );
+            }
+    }
+
+    // a sequence that consists of one long array of numbers of the same type keeps them
+    // in the storage until its elements are accessed
+    if( depth >= 0 && seq->total == 0 && record_len*count >= CV_BIN_MIN_RAW_SEQ &&
+        ptr < end && *ptr == closing )
+    {
+        CvFileRawSeq* raw = (CvFileRawSeq*)seq;
+        raw->raw_data = data;
+        raw->raw_depth = depth;
+        seq->total = record_len*count;
+        seq->flags |= CV_NODE_SEQ_RAW;
+        if( !fs->raw_seqs )
+            fs->raw_seqs = cvCreateSeq( 0, sizeof(CvSeq), sizeof(CvSeq*), fs->memstorage );
+        cvSeqPush( fs->raw_seqs, &seq );
+    }
+    else
+        icvBinPushRawNodes( seq, data, fmt_pairs, fmt_pair_count, count );
+
+    return ptr;
+}
+
+static const uchar*
+icvBinParseCollection( CvFileStorage* fs, const uchar* ptr, const uchar* end, int tag, CvFileNode* node );
+
+static const uchar*
+icvBinParseNode( CvFileStorage* fs, const uchar* ptr, const uchar* end, int tag, CvFileNode* node )
+{
+    int len;
+    const char* str;
+    union { double f; uint64 u; } v;
+
+    switch( tag )
+    {
+    case 'i':
+        node->tag = CV_NODE_INT;
+        node->data.i = (int)icvBinGetU32( fs, ptr, end );
+        break;
+    case 'r':
+        v.u = icvBinGetU64( fs, ptr, end );
+        node->tag = CV_NODE_REAL;
+        node->data.f = v.f;
+        break;
+    case 's':
+        str = icvBinGetString( fs, ptr, end, &len );
+        node->tag = CV_NODE_STRING;
+        node->data.str = cvMemStorageAllocString( fs->memstorage, str, len );
+        break;
+    case '{':
+    case '[':
+        ptr = icvBinParseCollection( fs, ptr, end, tag, node );
+        break;
+    default:
+        CV_PARSE_ERROR( "Unknown node type" );
+    }
+
+    return ptr;
+}
+
+static const uchar*
+icvBinParseCollection( CvFileStorage* fs, const uchar* ptr, const uchar* end, int tag, CvFileNode* node )
+{
+    int len, is_map = tag == '{', is_simple = 1;
+    int closing = is_map ? '}' : ']';
+    const char* type_name = icvBinGetString( fs, ptr, end, &len );
+
+    if( len > 0 )
+    {
+        char buf[CV_FS_MAX_LEN + 1];
+        if( len > CV_FS_MAX_LEN )
+            CV_PARSE_ERROR( "Too long type name" );
+        memcpy( buf, type_name, len );
+        buf[len] = '\0';
+        node->info = cvFindType( buf );
+    }
+
+    tag = (is_map ? CV_NODE_MAP : CV_NODE_SEQ) | (node->info ? CV_NODE_USER : 0);
+    if( is_map )
+        icvFSCreateCollection( fs, tag, node );
+    else
+    {
+        // the sequence may keep its numbers in the storage (see icvBinParseRawData)
+        CvFileRawSeq* seq = (CvFileRawSeq*)cvCreateSeq( 0, sizeof(CvFileRawSeq),
+                                                        sizeof(CvFileNode), fs->memstorage );
+        seq->raw_data = 0;
+        seq->raw_depth = 0;
+        seq->has_nodes = 0;
+        cvSetSeqBlockSize( (CvSeq*)seq, 8 );
+        node->tag = tag;
+        node->data.seq = (CvSeq*)seq;
+    }
+
+    for(;;)
+    {
+        CvFileNode* elem;
+
+        icvBinCheckSize( fs, ptr, end, 1 );
+        int c = *ptr++;
+        if( c == closing )
+            break;
+        if( c == '}' || c == ']' )
+            CV_PARSE_ERROR( "The wrong closing bracket" );
+
+        if( c == 'a' )
+        {
+            if( is_map )
+                CV_PARSE_ERROR( "Raw data may only be stored in a sequence" );
+            ptr = icvBinParseRawData( fs, ptr, end, node->data.seq, closing );
+            continue;
+        }
+
+        if( is_map )
+        {
+            const char* key = icvBinGetString( fs, ptr, end, &len );
+            if( len == 0 )
+                CV_PARSE_ERROR( "Empty key" );
+            elem = icvGetFileNode( fs, node, cvGetHashedKey( fs, key, len, 1 ), 1 );
+        }
+        else
+            elem = (CvFileNode*)cvSeqPush( node->data.seq, 0 );
+
+        memset( elem, 0, sizeof(*elem) );
+        ptr = icvBinParseNode( fs, ptr, end, c, elem );
+        if( is_map )
+            elem->tag |= CV_NODE_NAMED;
+        is_simple &= !CV_NODE_IS_COLLECTION(elem->tag);
+    }
+
+    if( !is_map )
+        node->data.seq->flags |= is_simple ? CV_NODE_SEQ_SIMPLE : 0;
+
+    return ptr;
+}
+
+// reads the whole storage into memory or maps it there; the raw sequences refer to it
+// until the storage is released
+static size_t
+icvBinLoad( CvFileStorage* fs, bool map )
+{
+    size_t size = 0;
+
+    if( map && fs->file && (fs->mapping = icvMapFile( fs->filename )) != 0 )
+    {
+        fs->bindata = fs->mapping->data;
+        size = fs->mapping->size;
+    }
+    else if( fs->strbuf )
+    {
+        size = fs->strbufsize;
+        fs->bindata = (uchar*)cvAlloc( size + 1 );
+        memcpy( fs->bindata, fs->strbuf, size );
+    }
+    else if( fs->file )
+    {
+        // the file has been opened in the text mode to check the signature
+        fs->file = freopen( fs->filename, "rb", fs->file );
+        if( !fs->file )
+            CV_Error( CV_StsError, "Could not reopen the binary file storage" );
+        fseek( fs->file, 0, SEEK_END );
+        size = (size_t)ftell( fs->file );
+        fseek( fs->file, 0, SEEK_SET );
+        fs->bindata = (uchar*)cvAlloc( size + 1 );
+        if( fread( fs->bindata, 1, size, fs->file ) != size )
+            CV_PARSE_ERROR( "Could not read the file" );
+    }
+#if USE_ZLIB
+    else if( fs->gzfile )
+    {
+        std::vector<uchar> buf;
+        const int chunk_size = 1 << 20;
+        int n;
+        gzrewind( fs->gzfile );
+        do
+        {
+            buf.resize( size + chunk_size );
+            n = gzread( fs->gzfile, &buf[size], chunk_size );
+            if( n < 0 )
+                CV_PARSE_ERROR( "Could not read the file" );
+            size += n;
+        }
+        while( n == chunk_size );
+        fs->bindata = (uchar*)cvAlloc( size + 1 );
+        memcpy( fs->bindata, &buf[0], size );
+    }
+#endif
+
+    if( size < CV_BIN_SIGNATURE_LEN || memcmp( fs->bindata, CV_BIN_SIGNATURE, CV_BIN_SIGNATURE_LEN ) != 0 )
+        CV_PARSE_ERROR( "Invalid binary file storage" );
+    return size;
+}
+
+static void
+icvBinParse( CvFileStorage* fs, bool map )
+{
+    size_t size = icvBinLoad( fs, map );
+    const uchar* ptr = fs->bindata + CV_BIN_SIGNATURE_LEN, *end = fs->bindata + size;
+
+    while( ptr < end )
+    {
+        int tag = *ptr++;
+        if( tag != '{' && tag != '[' )
+            CV_PARSE_ERROR( "The stream should be a map or a sequence" );
+
+        CvFileNode* root = (CvFileNode*)cvSeqPush( fs->roots, 0 );
+        memset( root, 0, sizeof(*root) );
+        ptr = icvBinParseCollection( fs, ptr, end, tag, root );
+    }
+}
+
+
 /****************************************************************************************\
 *                              Common High-Level Functions                               *
 \****************************************************************************************/
 
-CV_IMPL CvFileStorage*
-cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, const char* encoding )
+// srclen is the length of the filename or, with CV_STORAGE_MEMORY, of the data to read,
+// which may contain zeros in the binary format
+static CvFileStorage*
+icvOpenFileStorage( const char* filename, size_t srclen, CvMemStorage* dststorage, int flags, const char* encoding )
 {
     CvFileStorage* fs = 0;
     int default_block_size = 1 << 18;
@@ -2665,10 +3497,12 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
         mem = true;
     }
     else
-        fnamelen = strlen(filename);
+        fnamelen = srclen;
 
     if( mem && append )
         CV_Error( CV_StsBadFlag, "CV_STORAGE_APPEND and CV_STORAGE_MEMORY are not currently compatible" );
+    if( append && (flags & CV_STORAGE_FORMAT_MASK) == CV_STORAGE_FORMAT_BINARY )
+        CV_Error( CV_StsNotImplemented, "Appending data to binary file storage is not implemented" );
 
     fs = (CvFileStorage*)cvAlloc( sizeof(*fs) );
     memset( fs, 0, sizeof(*fs));
@@ -2703,7 +3537,8 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
 
         if( !isGZ )
         {
-            fs->file = fopen(fs->filename, !fs->write_mode ? "rt" : !append ? "wt" : "a+t" );
+            bool binary = (flags & CV_STORAGE_FORMAT_MASK) == CV_STORAGE_FORMAT_BINARY;
+            fs->file = fopen(fs->filename, !fs->write_mode ? "rt" : append ? "a+t" : binary ? "wb" : "wt" );
             if( !fs->file )
                 goto _exit_;
         }
@@ -2829,6 +3664,17 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
             fs->write_comment = icvXMLWriteComment;
             fs->start_next_stream = icvXMLStartNextStream;
         }
+        else if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+        {
+            icvBinPutBytes( fs, CV_BIN_SIGNATURE, CV_BIN_SIGNATURE_LEN );
+            fs->start_write_struct = icvBinStartWriteStruct;
+            fs->end_write_struct = icvBinEndWriteStruct;
+            fs->write_int = icvBinWriteInt;
+            fs->write_real = icvBinWriteReal;
+            fs->write_string = icvBinWriteString;
+            fs->write_comment = icvBinWriteComment;
+            fs->start_next_stream = icvBinStartNextStream;
+        }
         else
         {
             if( !append )
@@ -2857,7 +3703,28 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
         char buf[16];
         icvGets( fs, buf, sizeof(buf)-2 );
         fs->fmt = strncmp( buf, yaml_signature, strlen(yaml_signature) ) == 0 ?
-            CV_STORAGE_FORMAT_YAML : CV_STORAGE_FORMAT_XML;
+            CV_STORAGE_FORMAT_YAML : strncmp( buf, CV_BIN_SIGNATURE, CV_BIN_SIGNATURE_LEN ) == 0 ?
+            CV_STORAGE_FORMAT_BINARY : CV_STORAGE_FORMAT_XML;
+
+        if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+        {
+            fs->str_hash = cvCreateMap( 0, sizeof(CvStringHash),
+                            sizeof(CvStringHashNode), fs->memstorage, 256 );
+
+            fs->roots = cvCreateSeq( 0, sizeof(CvSeq),
+                            sizeof(CvFileNode), fs->memstorage );
+            try
+            {
+                icvBinParse( fs, (flags & CV_STORAGE_MMAP) != 0 );
+            }
+            catch (...)
+            {
+                cvReleaseFileStorage( &fs );
+                throw;
+            }
+            fs->is_opened = true;
+            goto _exit_;
+        }
 
         if( !isGZ )
         {
@@ -2926,6 +3793,13 @@ _exit_:
 }
 
 
+CV_IMPL CvFileStorage*
+cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, const char* encoding )
+{
+    return icvOpenFileStorage( filename, filename ? strlen(filename) : 0, dststorage, flags, encoding );
+}
+
+
 CV_IMPL void
 cvStartWriteStruct( CvFileStorage* fs, const char* key, int struct_flags,
                     const char* type_name, CvAttrList /*attributes*/ )
@@ -2983,9 +3857,6 @@ cvStartNextStream( CvFileStorage* fs )
 }
 
 
-static const char icvTypeSymbol[] = "ucwsifdr";
-#define CV_FS_MAX_FMT_PAIRS  128
-
 static char*
 icvEncodeFormat( int elem_type, char* dt )
 {
@@ -3090,6 +3961,87 @@ icvDecodeSimpleFormat( const char* dt )
 }
 
 
+// writes the records of the binary storage data block; see the format description above
+static void
+icvBinWriteRawData( CvFileStorage* fs, const char* data0, int len,
+                    const int* fmt_pairs, int fmt_pair_count )
+{
+    static const uchar zeros[CV_BIN_DATA_ALIGN] = {0};
+    char dt[CV_FS_MAX_FMT_PAIRS*4];
+    int k, offset = 0, record_size = 0, max_elem_size = 1;
+    bool swap = icvIsBigEndian();
+    // whether the records are stored as they are in memory
+    bool copy = !swap;
+
+    dt[0] = '\0';
+    for( k = 0; k < fmt_pair_count; k++ )
+    {
+        int count = fmt_pairs[k*2], elem_type = fmt_pairs[k*2+1];
+        int elem_size = CV_ELEM_SIZE(elem_type);
+        int stored_type = elem_type == CV_USRTYPE1 ? CV_32S : elem_type;
+
+        sprintf( dt + strlen(dt), "%d%c", count, icvTypeSymbol[stored_type] );
+        copy &= stored_type == elem_type && cvAlign( offset, elem_size ) == offset;
+        offset = cvAlign( offset, elem_size ) + count*elem_size;
+        record_size += count*CV_ELEM_SIZE(stored_type);
+        max_elem_size = MAX( max_elem_size, elem_size );
+    }
+    copy &= len == 1 || offset % max_elem_size == 0;
+
+    icvBinWriteNode( fs, 0, 'a' );
+    icvBinPutString( fs, dt );
+    icvBinPutU32( fs, (unsigned)len );
+    icvBinPutU64( fs, (uint64)record_size*len );
+    icvBinPutBytes( fs, zeros, (CV_BIN_DATA_ALIGN - fs->binpos % CV_BIN_DATA_ALIGN) % CV_BIN_DATA_ALIGN );
+
+    if( copy )
+    {
+        icvBinPutBytes( fs, data0, (size_t)record_size*len );
+        return;
+    }
+
+    uchar buf[1 << 12];
+    size_t buf_len = 0;
+
+    for( offset = 0; len > 0; len-- )
+    {
+        for( k = 0; k < fmt_pair_count; k++ )
+        {
+            int elem_type = fmt_pairs[k*2+1];
+            int elem_size = CV_ELEM_SIZE(elem_type);
+
+            offset = cvAlign( offset, elem_size );
+            for( int i = 0; i < fmt_pairs[k*2]; i++, offset += elem_size )
+            {
+                uchar* ptr = buf + buf_len;
+                int stored_size = elem_size;
+
+                if( elem_type == CV_USRTYPE1 ) /* reference */
+                {
+                    size_t ref;
+                    memcpy( &ref, data0 + offset, sizeof(ref) );
+                    int ival = (int)ref;
+                    memcpy( ptr, &ival, sizeof(ival) );
+                    stored_size = sizeof(ival);
+                }
+                else
+                    memcpy( ptr, data0 + offset, elem_size );
+
+                if( swap )
+                    std::reverse( ptr, ptr + stored_size );
+                buf_len += stored_size;
+                if( buf_len + sizeof(double) > sizeof(buf) )
+                {
+                    icvBinPutBytes( fs, buf, buf_len );
+                    buf_len = 0;
+                }
+            }
+        }
+    }
+    icvBinPutBytes( fs, buf, buf_len );
+}
+
+
 CV_IMPL void
 cvWriteRawData( CvFileStorage* fs, const void* _data, int len, const char* dt )
 {
@@ -3111,6 +4063,12 @@ cvWriteRawData( CvFileStorage* fs, const void* _data, int len, const char* dt )
     if( !data0 )
         CV_Error( CV_StsNullPtr, "Null data pointer" );
 
+    if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+    {
+        icvBinWriteRawData( fs, data0, len, fmt_pairs, fmt_pair_count );
+        return;
+    }
+
     if( fmt_pair_count == 1 )
     {
         fmt_pairs[0] *= len;
@@ -3185,6 +4143,62 @@ cvWriteRawData( CvFileStorage* fs, const void* _data, int len, const char* dt )
 }
 
 
+static void
+icvConvertRawScalars( const uchar* src, int src_depth, char* dst, int dst_type, int count )
+{
+    if( dst_type == CV_USRTYPE1 ) /* reference */
+    {
+        std::vector<int> buf(count);
+        cv::Mat(1, count, src_depth, (void*)src).convertTo(cv::Mat(1, count, CV_32S, &buf[0]), CV_32S);
+        for( int i = 0; i < count; i++ )
+            ((size_t*)dst)[i] = buf[i];
+    }
+    else if( src_depth == dst_type )
+        memcpy( dst, src, (size_t)count*CV_ELEM_SIZE(src_depth) );
+    else
+        cv::Mat(1, count, src_depth, (void*)src).convertTo(cv::Mat(1, count, dst_type, dst), dst_type);
+}
+
+// reads len numbers starting from the element ofs of a sequence that keeps them in the storage
+static void
+icvReadRawSeqData( const CvFileRawSeq* seq, int ofs, int len, char* data0, const char* dt )
+{
+    int fmt_pairs[CV_FS_MAX_FMT_PAIRS*2], k = 0, fmt_pair_count;
+    int offset = 0, count = 0, src_elem_size = CV_ELEM_SIZE(seq->raw_depth);
+    const uchar* src = seq->raw_data + (size_t)ofs*src_elem_size;
+
+    if( ofs < 0 || len < 0 || ofs + len > seq->total )
+        CV_Error( CV_StsOutOfRange, "The slice is out of the sequence" );
+    if( len == 0 )
+        return;
+
+    fmt_pair_count = icvDecodeFormat( dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS );
+    // the numbers of the simple records are converted at once
+    if( fmt_pair_count == 1 && len % fmt_pairs[0] == 0 && len > 0 )
+        fmt_pairs[0] = len;
+
+    while( len > 0 )
+    {
+        for( k = 0; k < fmt_pair_count && len > 0; k++ )
+        {
+            int elem_type = fmt_pairs[k*2+1];
+            int elem_size = CV_ELEM_SIZE(elem_type);
+
+            count = MIN( fmt_pairs[k*2], len );
+            offset = cvAlign( offset, elem_size );
+            icvConvertRawScalars( src, seq->raw_depth, data0 + offset, elem_type, count );
+            src += count*src_elem_size;
+            offset += count*elem_size;
+            len -= count;
+        }
+    }
+
+    if( k != fmt_pair_count || count != fmt_pairs[k*2-2] )
+        CV_Error( CV_StsBadSize,
+        "The sequence slice does not fit an integer number of records" );
+}
+
+
 CV_IMPL void
 cvStartReadRawData( const CvFileStorage* fs, const CvFileNode* src, CvSeqReader* reader )
 {
@@ -3205,6 +4219,7 @@ cvStartReadRawData( const CvFileStorage* fs, const CvFileNode* src, CvSeqReader*
     }
     else if( node_type == CV_NODE_SEQ )
     {
+        icvFSCreateRawNodes( src->data.seq );
         cvStartReadSeq( src->data.seq, reader, 0 );
     }
     else if( node_type == CV_NODE_NONE )
@@ -3374,6 +4389,13 @@ cvReadRawData( const CvFileStorage* fs, const CvFileNode* src,
     if( !src || !data )
         CV_Error( CV_StsNullPtr, "Null pointers to source file node or destination array" );
 
+    if( CV_NODE_IS_SEQ(src->tag) && CV_NODE_SEQ_IS_RAW(src->data.seq) )
+    {
+        CV_CHECK_FILE_STORAGE( fs );
+        icvReadRawSeqData( (const CvFileRawSeq*)src->data.seq, 0, src->data.seq->total, (char*)data, dt );
+        return;
+    }
+
     cvStartReadRawData( fs, src, &reader );
     cvReadRawDataSlice( fs, &reader, CV_NODE_IS_SEQ(src->tag) ?
                         src->data.seq->total : 1, data, dt );
@@ -3386,6 +4408,14 @@ icvWriteFileNode( CvFileStorage* fs, const char* name, const CvFileNode* node );
 static void
 icvWriteCollection( CvFileStorage* fs, const CvFileNode* node )
 {
+    if( CV_NODE_IS_SEQ(node->tag) && CV_NODE_SEQ_IS_RAW(node->data.seq) )
+    {
+        const CvFileRawSeq* seq = (const CvFileRawSeq*)node->data.seq;
+        char dt[] = { icvTypeSymbol[seq->raw_depth], '\0' };
+        cvWriteRawData( fs, seq->raw_data, seq->total, dt );
+        return;
+    }
+
     int i, total = node->data.seq->total;
     int elem_size = node->data.seq->elem_size;
     int is_map = CV_NODE_IS_MAP(node->tag);
@@ -3547,16 +4577,16 @@ icvReadMat( CvFileStorage* fs, CvFileNode* node )
     CvFileNode* data;
     int rows, cols, elem_type;
 
-    rows = cvReadIntByName( fs, node, "rows", -1 );
-    cols = cvReadIntByName( fs, node, "cols", -1 );
-    dt = cvReadStringByName( fs, node, "dt", 0 );
+    rows = icvReadIntByName( fs, node, "rows", -1 );
+    cols = icvReadIntByName( fs, node, "cols", -1 );
+    dt = icvReadStringByName( fs, node, "dt", 0 );
 
     if( rows < 0 || cols < 0 || !dt )
         CV_Error( CV_StsError, "Some of essential matrix attributes are absent" );
 
     elem_type = icvDecodeSimpleFormat( dt );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The matrix data is not found in file storage" );
 
@@ -3633,8 +4663,8 @@ icvReadMatND( CvFileStorage* fs, CvFileNode* node )
     int sizes[CV_MAX_DIM], dims, elem_type;
     int i, total_size;
 
-    sizes_node = cvGetFileNodeByName( fs, node, "sizes" );
-    dt = cvReadStringByName( fs, node, "dt", 0 );
+    sizes_node = icvGetFileNodeByName( fs, node, "sizes" );
+    dt = icvReadStringByName( fs, node, "dt", 0 );
 
     if( !sizes_node || !dt )
         CV_Error( CV_StsError, "Some of essential matrix attributes are absent" );
@@ -3648,7 +4678,7 @@ icvReadMatND( CvFileStorage* fs, CvFileNode* node )
     cvReadRawData( fs, sizes_node, sizes, "i" );
     elem_type = icvDecodeSimpleFormat( dt );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The matrix data is not found in file storage" );
 
@@ -3786,8 +4816,8 @@ icvReadSparseMat( CvFileStorage* fs, CvFileNode* node )
     int sizes[CV_MAX_DIM_HEAP], dims, elem_type, cn;
     int i;
 
-    sizes_node = cvGetFileNodeByName( fs, node, "sizes" );
-    dt = cvReadStringByName( fs, node, "dt", 0 );
+    sizes_node = icvGetFileNodeByName( fs, node, "sizes" );
+    dt = icvReadStringByName( fs, node, "dt", 0 );
 
     if( !sizes_node || !dt )
         CV_Error( CV_StsError, "Some of essential matrix attributes are absent" );
@@ -3801,7 +4831,7 @@ icvReadSparseMat( CvFileStorage* fs, CvFileNode* node )
     cvReadRawData( fs, sizes_node, sizes, "i" );
     elem_type = icvDecodeSimpleFormat( dt );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data || !CV_NODE_IS_SEQ(data->tag) )
         CV_Error( CV_StsError, "The matrix data is not found in file storage" );
 
@@ -3924,20 +4954,20 @@ icvReadImage( CvFileStorage* fs, CvFileNode* node )
     int y, width, height, elem_type, coi, depth;
     const char* origin, *data_order;
 
-    width = cvReadIntByName( fs, node, "width", 0 );
-    height = cvReadIntByName( fs, node, "height", 0 );
-    dt = cvReadStringByName( fs, node, "dt", 0 );
-    origin = cvReadStringByName( fs, node, "origin", 0 );
+    width = icvReadIntByName( fs, node, "width", 0 );
+    height = icvReadIntByName( fs, node, "height", 0 );
+    dt = icvReadStringByName( fs, node, "dt", 0 );
+    origin = icvReadStringByName( fs, node, "origin", 0 );
 
     if( width == 0 || height == 0 || dt == 0 || origin == 0 )
         CV_Error( CV_StsError, "Some of essential image attributes are absent" );
 
     elem_type = icvDecodeSimpleFormat( dt );
-    data_order = cvReadStringByName( fs, node, "layout", "interleaved" );
+    data_order = icvReadStringByName( fs, node, "layout", "interleaved" );
     if( strcmp( data_order, "interleaved" ) != 0 )
         CV_Error( CV_StsError, "Only interleaved images can be read" );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The image data is not found in file storage" );
 
@@ -3948,14 +4978,14 @@ icvReadImage( CvFileStorage* fs, CvFileNode* node )
     depth = cvIplDepth(elem_type);
     image = cvCreateImage( cvSize(width,height), depth, CV_MAT_CN(elem_type) );
 
-    roi_node = cvGetFileNodeByName( fs, node, "roi" );
+    roi_node = icvGetFileNodeByName( fs, node, "roi" );
     if( roi_node )
     {
-        roi.x = cvReadIntByName( fs, roi_node, "x", 0 );
-        roi.y = cvReadIntByName( fs, roi_node, "y", 0 );
-        roi.width = cvReadIntByName( fs, roi_node, "width", 0 );
-        roi.height = cvReadIntByName( fs, roi_node, "height", 0 );
-        coi = cvReadIntByName( fs, roi_node, "coi", 0 );
+        roi.x = icvReadIntByName( fs, roi_node, "x", 0 );
+        roi.y = icvReadIntByName( fs, roi_node, "y", 0 );
+        roi.width = icvReadIntByName( fs, roi_node, "width", 0 );
+        roi.height = icvReadIntByName( fs, roi_node, "height", 0 );
+        coi = icvReadIntByName( fs, roi_node, "coi", 0 );
 
         cvSetImageROI( image, roi );
         cvSetImageCOI( image, coi );
@@ -4212,9 +5242,9 @@ icvReadSeq( CvFileStorage* fs, CvFileNode* node )
     const char* dt;
     char* endptr = 0;
 
-    flags_str = cvReadStringByName( fs, node, "flags", 0 );
-    total = cvReadIntByName( fs, node, "count", -1 );
-    dt = cvReadStringByName( fs, node, "dt", 0 );
+    flags_str = icvReadStringByName( fs, node, "flags", 0 );
+    total = icvReadIntByName( fs, node, "count", -1 );
+    dt = icvReadStringByName( fs, node, "dt", 0 );
 
     if( !flags_str || total == -1 || !dt )
         CV_Error( CV_StsError, "Some of essential sequence attributes are absent" );
@@ -4263,15 +5293,15 @@ icvReadSeq( CvFileStorage* fs, CvFileNode* node )
         }
     }
 
-    header_dt = cvReadStringByName( fs, node, "header_dt", 0 );
-    header_node = cvGetFileNodeByName( fs, node, "header_user_data" );
+    header_dt = icvReadStringByName( fs, node, "header_dt", 0 );
+    header_node = icvGetFileNodeByName( fs, node, "header_user_data" );
 
     if( (header_dt != 0) ^ (header_node != 0) )
         CV_Error( CV_StsError,
         "One of \"header_dt\" and \"header_user_data\" is there, while the other is not" );
 
-    rect_node = cvGetFileNodeByName( fs, node, "rect" );
-    origin_node = cvGetFileNodeByName( fs, node, "origin" );
+    rect_node = icvGetFileNodeByName( fs, node, "rect" );
+    origin_node = icvGetFileNodeByName( fs, node, "origin" );
 
     if( (header_node != 0) + (rect_node != 0) + (origin_node != 0) > 1 )
         CV_Error( CV_StsError, "Only one of \"header_user_data\", \"rect\" and \"origin\" tags may occur" );
@@ -4295,17 +5325,17 @@ icvReadSeq( CvFileStorage* fs, CvFileNode* node )
     else if( rect_node )
     {
         CvPoint2DSeq* point_seq = (CvPoint2DSeq*)seq;
-        point_seq->rect.x = cvReadIntByName( fs, rect_node, "x", 0 );
-        point_seq->rect.y = cvReadIntByName( fs, rect_node, "y", 0 );
-        point_seq->rect.width = cvReadIntByName( fs, rect_node, "width", 0 );
-        point_seq->rect.height = cvReadIntByName( fs, rect_node, "height", 0 );
-        point_seq->color = cvReadIntByName( fs, node, "color", 0 );
+        point_seq->rect.x = icvReadIntByName( fs, rect_node, "x", 0 );
+        point_seq->rect.y = icvReadIntByName( fs, rect_node, "y", 0 );
+        point_seq->rect.width = icvReadIntByName( fs, rect_node, "width", 0 );
+        point_seq->rect.height = icvReadIntByName( fs, rect_node, "height", 0 );
+        point_seq->color = icvReadIntByName( fs, node, "color", 0 );
     }
     else if( origin_node )
     {
         CvChain* chain = (CvChain*)seq;
-        chain->origin.x = cvReadIntByName( fs, origin_node, "x", 0 );
-        chain->origin.y = cvReadIntByName( fs, origin_node, "y", 0 );
+        chain->origin.x = icvReadIntByName( fs, origin_node, "x", 0 );
+        chain->origin.y = icvReadIntByName( fs, origin_node, "y", 0 );
     }
 
     cvSeqPushMulti( seq, 0, total, 0 );
@@ -4314,7 +5344,7 @@ icvReadSeq( CvFileStorage* fs, CvFileNode* node )
     for( i = 0; i < fmt_pair_count; i += 2 )
         items_per_elem += fmt_pairs[i];
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The image data is not found in file storage" );
 
@@ -4339,7 +5369,7 @@ static void*
 icvReadSeqTree( CvFileStorage* fs, CvFileNode* node )
 {
     void* ptr = 0;
-    CvFileNode *sequences_node = cvGetFileNodeByName( fs, node, "sequences" );
+    CvFileNode *sequences_node = icvGetFileNodeByName( fs, node, "sequences" );
     CvSeq* sequences;
     CvSeq* root = 0;
     CvSeq* parent = 0;
@@ -4362,7 +5392,7 @@ icvReadSeqTree( CvFileStorage* fs, CvFileNode* node )
         CvSeq* seq;
         int level;
         seq = (CvSeq*)cvRead( fs, elem );
-        level = cvReadIntByName( fs, elem, "level", -1 );
+        level = icvReadIntByName( fs, elem, "level", -1 );
         if( level < 0 )
             CV_Error( CV_StsParseError, "All the sequence tree nodes should contain \"level\" field" );
         if( !root )
@@ -4579,11 +5609,11 @@ icvReadGraph( CvFileStorage* fs, CvFileNode* node )
     const char* edge_dt;
     char* endptr = 0;
 
-    flags_str = cvReadStringByName( fs, node, "flags", 0 );
-    vtx_dt = cvReadStringByName( fs, node, "vertex_dt", 0 );
-    edge_dt = cvReadStringByName( fs, node, "edge_dt", 0 );
-    vtx_count = cvReadIntByName( fs, node, "vertex_count", -1 );
-    edge_count = cvReadIntByName( fs, node, "edge_count", -1 );
+    flags_str = icvReadStringByName( fs, node, "flags", 0 );
+    vtx_dt = icvReadStringByName( fs, node, "vertex_dt", 0 );
+    edge_dt = icvReadStringByName( fs, node, "edge_dt", 0 );
+    vtx_count = icvReadIntByName( fs, node, "vertex_count", -1 );
+    edge_count = icvReadIntByName( fs, node, "edge_count", -1 );
 
     if( !flags_str || vtx_count == -1 || edge_count == -1 || !edge_dt )
         CV_Error( CV_StsError, "Some of essential graph attributes are absent" );
@@ -4609,8 +5639,8 @@ icvReadGraph( CvFileStorage* fs, CvFileNode* node )
             flags |= CV_GRAPH_FLAG_ORIENTED;
     }
 
-    header_dt = cvReadStringByName( fs, node, "header_dt", 0 );
-    header_node = cvGetFileNodeByName( fs, node, "header_user_data" );
+    header_dt = icvReadStringByName( fs, node, "header_dt", 0 );
+    header_node = icvGetFileNodeByName( fs, node, "header_user_data" );
 
     if( (header_dt != 0) ^ (header_node != 0) )
         CV_Error( CV_StsError,
@@ -4673,8 +5703,8 @@ icvReadGraph( CvFileStorage* fs, CvFileNode* node )
     read_buf = (char*)cvAlloc( read_buf_size );
     vtx_buf = (CvGraphVtx**)cvAlloc( vtx_count * sizeof(vtx_buf[0]) );
 
-    vtx_node = cvGetFileNodeByName( fs, node, "vertices" );
-    edge_node = cvGetFileNodeByName( fs, node, "edges" );
+    vtx_node = icvGetFileNodeByName( fs, node, "vertices" );
+    edge_node = icvGetFileNodeByName( fs, node, "edges" );
     if( !edge_node )
         CV_Error( CV_StsBadArg, "No edges data" );
     if( vtx_dt && !vtx_node )
@@ -5043,7 +6073,7 @@ cvLoad( const char* filename, CvMemStorage* memstorage,
 
     if( name )
     {
-        node = cvGetFileNodeByName( *fs, 0, name );
+        node = icvGetFileNodeByName( *fs, 0, name );
     }
     else
     {
@@ -5160,8 +6190,8 @@ FileStorage::~FileStorage()
 bool FileStorage::open(const String& filename, int flags, const String& encoding)
 {
     release();
-    fs.reset(cvOpenFileStorage( filename.c_str(), 0, flags,
-                                !encoding.empty() ? encoding.c_str() : 0));
+    fs.reset(icvOpenFileStorage( filename.c_str(), filename.size(), 0, flags,
+                                 !encoding.empty() ? encoding.c_str() : 0));
     bool ok = isOpened();
     state = ok ? NAME_EXPECTED + INSIDE_MAP : UNDEFINED;
     return ok;
@@ -5191,7 +6221,7 @@ String FileStorage::releaseAndGetString()
 
 FileNode FileStorage::root(int streamidx) const
 {
-    return isOpened() ? FileNode(fs, cvGetRootFileNode(fs, streamidx)) : FileNode();
+    return isOpened() ? FileNode(fs, icvGetRootFileNode(fs, streamidx)) : FileNode();
 }
 
 FileStorage& operator << (FileStorage& fs, const String& str)
@@ -5274,26 +6304,28 @@ void FileStorage::writeObj( const String& name, const void* obj )
 
 FileNode FileStorage::operator[](const String& nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, 0, nodename.c_str()));
+    return FileNode(fs, icvGetFileNodeByName(fs, 0, nodename.c_str()));
 }
 
 FileNode FileStorage::operator[](const char* nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, 0, nodename));
+    return FileNode(fs, icvGetFileNodeByName(fs, 0, nodename));
 }
 
 FileNode FileNode::operator[](const String& nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, node, nodename.c_str()));
+    return FileNode(fs, icvGetFileNodeByName(fs, node, nodename.c_str()));
 }
 
 FileNode FileNode::operator[](const char* nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, node, nodename));
+    return FileNode(fs, icvGetFileNodeByName(fs, node, nodename));
 }
 
 FileNode FileNode::operator[](int i) const
 {
+    if( isSeq() )
+        icvFSCreateRawNodes( node->data.seq );
     return isSeq() ? FileNode(fs, (CvFileNode*)cvGetSeqElem(node->data.seq, i)) :
         i == 0 ? *this : FileNode();
 }
@@ -5329,7 +6361,12 @@ FileNodeIterator::FileNodeIterator(const CvFileStorage* _fs,
         container = _node;
         if( !(_node->tag & FileNode::USER) && (node_type == FileNode::SEQ || node_type == FileNode::MAP) )
         {
-            cvStartReadSeq( _node->data.seq, (CvSeqReader*)&reader );
+            // the numbers of a raw sequence are read directly until an element is accessed
+            if( node_type == FileNode::SEQ && CV_NODE_SEQ_IS_RAW(_node->data.seq) &&
+                CV_XADD(&((CvFileRawSeq*)_node->data.seq)->has_nodes, 0) == 0 )
+                memset( &reader, 0, sizeof(reader) );
+            else
+                cvStartReadSeq( _node->data.seq, (CvSeqReader*)&reader );
             remaining = FileNode(_fs, _node).size();
         }
         else
@@ -5357,6 +6394,25 @@ FileNodeIterator::FileNodeIterator(const FileNodeIterator& it)
     remaining = it.remaining;
 }
 
+FileNode FileNodeIterator::operator *() const
+{
+    if( container && !reader.seq && !reader.ptr )
+    {
+        // the elements of the raw sequence are needed: create them and read them as usual
+        CvSeq* seq = container->data.seq;
+        SeqReader& r = const_cast<SeqReader&>(reader);
+        icvFSCreateRawNodes( seq );
+        cvStartReadSeq( seq, (CvSeqReader*)&r );
+        cvSetSeqReaderPos( (CvSeqReader*)&r, (int)(seq->total - remaining) );
+    }
+    return FileNode(fs, (const CvFileNode*)(const void*)reader.ptr);
+}
+
+FileNode FileNodeIterator::operator ->() const
+{
+    return operator *();
+}
+
 FileNodeIterator& FileNodeIterator::operator ++()
 {
     if( remaining > 0 )
@@ -5435,7 +6491,16 @@ FileNodeIterator& FileNodeIterator::readRaw( const String& fmt, uchar* vec, size
         CV_Assert( elem_size > 0 );
         size_t count = std::min(remaining, maxCount);
 
-        if( reader.seq )
+        if( CV_NODE_IS_SEQ(container->tag) && CV_NODE_SEQ_IS_RAW(container->data.seq) )
+        {
+            // the numbers are converted from the storage at once, the nodes are skipped
+            const CvFileRawSeq* seq = (const CvFileRawSeq*)container->data.seq;
+            icvReadRawSeqData( seq, (int)(seq->total - remaining), (int)count, (char*)vec, fmt.c_str() );
+            if( reader.seq )
+                cvSetSeqReaderPos( (CvSeqReader*)&reader, (int)count, 1 );
+            remaining -= count;
+        }
+        else if( reader.seq )
         {
             cvReadRawDataSlice( fs, (CvSeqReader*)&reader, (int)count, vec, fmt.c_str() );
             remaining -= count*cn;
@@ -5526,6 +6591,94 @@ internal::WriteStructContext::~WriteStructContext()
 }
 
 
+// owns the matrices that reference a mapped binary storage
+class FileMappingAllocator : public MatAllocator
+{
+public:
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data, size_t* step, int flags, UMatUsageFlags usageFlags) const
+    {
+        return Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(UMatData* u, int accessFlags, UMatUsageFlags usageFlags) const
+    {
+        return Mat::getStdAllocator()->allocate(u, accessFlags, usageFlags);
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        icvReleaseFileMapping((CvFileMapping*)u->userdata);
+        delete u;
+    }
+};
+
+static MatAllocator* getFileMappingAllocator()
+{
+    CV_SINGLETON_LAZY_INIT(MatAllocator, new FileMappingAllocator())
+}
+
+// makes mat reference the data of the matrix node in the mapped storage;
+// returns false if the node data has not been left in the file as one array
+static bool readMappedMat( const CvFileStorage* fs, const CvFileNode* node, Mat& mat )
+{
+    if( !fs->mapping || !CV_NODE_IS_MAP(node->tag) || !node->info )
+        return false;
+
+    int dims, sizes[CV_MAX_DIM];
+    if( strcmp(node->info->type_name, CV_TYPE_NAME_MAT) == 0 )
+    {
+        dims = 2;
+        sizes[0] = icvReadIntByName( fs, node, "rows", -1 );
+        sizes[1] = icvReadIntByName( fs, node, "cols", -1 );
+    }
+    else if( strcmp(node->info->type_name, CV_TYPE_NAME_MATND) == 0 )
+    {
+        const CvFileNode* sizes_node = icvGetFileNodeByName( fs, node, "sizes" );
+        if( !sizes_node || !CV_NODE_IS_SEQ(sizes_node->tag) )
+            return false;
+        dims = sizes_node->data.seq->total;
+        if( dims <= 0 || dims > CV_MAX_DIM )
+            return false;
+        cvReadRawData( fs, sizes_node, sizes, "i" );
+    }
+    else
+        return false;
+
+    const char* dt = icvReadStringByName( fs, node, "dt", 0 );
+    const CvFileNode* data = icvGetFileNodeByName( fs, node, "data" );
+    if( !dt || !data || !CV_NODE_IS_SEQ(data->tag) || !CV_NODE_SEQ_IS_RAW(data->data.seq) )
+        return false;
+
+    int type = icvDecodeSimpleFormat( dt );
+    const CvFileRawSeq* seq = (const CvFileRawSeq*)data->data.seq;
+    size_t total = CV_MAT_CN(type);
+    for( int i = 0; i < dims; i++ )
+    {
+        if( sizes[i] < 0 )
+            return false;
+        total *= sizes[i];
+    }
+    if( seq->raw_depth != CV_MAT_DEPTH(type) || total != (size_t)seq->total )
+        return false;
+
+    Mat m(dims, sizes, type, (void*)seq->raw_data);
+    UMatData* u = new UMatData(getFileMappingAllocator());
+    u->data = u->origdata = m.data;
+    u->size = total*CV_ELEM_SIZE1(type);
+    u->userdata = fs->mapping;
+    CV_XADD(&fs->mapping->refcount, 1);
+    u->refcount = 1;
+    m.u = u;
+    mat = m;
+    return true;
+}
+
 void read( const FileNode& node, Mat& mat, const Mat& default_mat )
 {
     if( node.empty() )
@@ -5533,6 +6686,8 @@ void read( const FileNode& node, Mat& mat, const Mat& default_mat )
         default_mat.copyTo(mat);
         return;
     }
+    if( readMappedMat(node.fs, *node, mat) )
+        return;
     void* obj = cvRead((CvFileStorage*)node.fs, (CvFileNode*)*node);
     if(CV_IS_MAT_HDR_Z(obj))
     {
@@ -281,6 +281,16 @@ struct CoreTLSData
 
 TLSData<CoreTLSData>& getCoreTlsData();
 
+// reads a size from the environment variable, "KB" and "MB" suffixes are accepted
+size_t getConfigurationParameterForSize(const char* name, size_t defaultValue);
+
+// pooled allocator of the calling thread if a ScopedArena is active, NULL otherwise
+MatAllocator* getArenaAllocator();
+#ifdef WIN32
+// frees the pool of the calling thread, called when the thread exits
+void releaseThreadArena();
+#endif
+
 #if defined(BUILD_SHARED_LIBS)
 #if defined WIN32 || defined _WIN32 || defined WINCE
 #define CL_RUNTIME_EXPORT __declspec(dllexport)
@@ -1192,6 +1192,8 @@ static bool ipp_sum(Mat &src, Scalar &_res)
 
 cv::Scalar cv::sum( InputArray _src )
 {
+    CV_TRACE_FUNCTION();
+
 #if defined HAVE_OPENCL || defined HAVE_IPP
     Scalar _res;
 #endif
@@ -1338,6 +1340,8 @@ static bool ipp_countNonZero( Mat &src, int &res )
 
 int cv::countNonZero( InputArray _src )
 {
+    CV_TRACE_FUNCTION();
+
     int type = _src.type(), cn = CV_MAT_CN(type);
     CV_Assert( cn == 1 );
 
@@ -1370,6 +1374,8 @@ int cv::countNonZero( InputArray _src )
 
 cv::Scalar cv::mean( InputArray _src, InputArray _mask )
 {
+    CV_TRACE_FUNCTION();
+
     Mat src = _src.getMat(), mask = _mask.getMat();
     CV_Assert( mask.empty() || mask.type() == CV_8U );
 
@@ -1750,6 +1756,8 @@ static bool ipp_meanStdDev(Mat& src, OutputArray _mean, OutputArray _sdv, Mat& m
 
 void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray _mask )
 {
+    CV_TRACE_FUNCTION();
+
     CV_OCL_RUN(OCL_PERFORMANCE_CHECK(_src.isUMat()) && _src.dims() <= 2,
                ocl_meanStdDev(_src, _mean, _sdv, _mask))
 
@@ -2312,6 +2320,8 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
                    double* maxVal, int* minIdx, int* maxIdx,
                    InputArray _mask)
 {
+    CV_TRACE_FUNCTION();
+
     int type = _src.type(), depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
     CV_Assert( (cn == 1 && (_mask.empty() || _mask.type() == CV_8U)) ||
         (cn > 1 && _mask.empty() && !minIdx && !maxIdx) );
@@ -2813,6 +2823,8 @@ static bool ipp_norm(Mat &src, int normType, Mat &mask, double &result)
 
 double cv::norm( InputArray _src, int normType, InputArray _mask )
 {
+    CV_TRACE_FUNCTION();
+
     normType &= NORM_TYPE_MASK;
     CV_Assert( normType == NORM_INF || normType == NORM_L1 ||
                normType == NORM_L2 || normType == NORM_L2SQR ||
@@ -3314,6 +3326,8 @@ static bool ipp_norm(InputArray _src1, InputArray _src2, int normType, InputArra
 
 double cv::norm( InputArray _src1, InputArray _src2, int normType, InputArray _mask )
 {
+    CV_TRACE_FUNCTION();
+
     CV_Assert( _src1.sameSize(_src2) && _src1.type() == _src2.type() );
 
 #if defined HAVE_OPENCL || defined HAVE_IPP
@@ -3605,27 +3619,35 @@ static void batchDistL2_8u32f(const uchar* src1, const uchar* src2, size_t step2
     batchDistL2_<uchar, float>(src1, src2, step2, nvecs, len, dist, mask);
 }
 
+// float descriptors go through the hal kernels, which have SSE and AVX2/FMA paths
 static void batchDistL1_32f(const float* src1, const float* src2, size_t step2,
                              int nvecs, int len, float* dist, const uchar* mask)
 {
-    batchDistL1_<float, float>(src1, src2, step2, nvecs, len, dist, mask);
+    step2 /= sizeof(src2[0]);
+    for( int i = 0; i < nvecs; i++ )
+        dist[i] = !mask || mask[i] ? hal::normL1_(src1, src2 + step2*i, len) : FLT_MAX;
 }
 
 static void batchDistL2Sqr_32f(const float* src1, const float* src2, size_t step2,
                                 int nvecs, int len, float* dist, const uchar* mask)
 {
-    batchDistL2Sqr_<float, float>(src1, src2, step2, nvecs, len, dist, mask);
+    step2 /= sizeof(src2[0]);
+    for( int i = 0; i < nvecs; i++ )
+        dist[i] = !mask || mask[i] ? hal::normL2Sqr_(src1, src2 + step2*i, len) : FLT_MAX;
 }
 
 static void batchDistL2_32f(const float* src1, const float* src2, size_t step2,
                              int nvecs, int len, float* dist, const uchar* mask)
 {
-    batchDistL2_<float, float>(src1, src2, step2, nvecs, len, dist, mask);
+    step2 /= sizeof(src2[0]);
+    for( int i = 0; i < nvecs; i++ )
+        dist[i] = !mask || mask[i] ? std::sqrt(hal::normL2Sqr_(src1, src2 + step2*i, len)) : FLT_MAX;
 }
 
 typedef void (*BatchDistFunc)(const uchar* src1, const uchar* src2, size_t step2,
                               int nvecs, int len, uchar* dist, const uchar* mask);
 
+enum { BATCH_DIST_QUERY_BLOCK = 32, BATCH_DIST_TILE_BYTES = 1 << 17 };
 
 struct BatchDistInvoker : public ParallelLoopBody
 {
@@ -3644,39 +3666,61 @@ struct BatchDistInvoker : public ParallelLoopBody
         func = _func;
     }
 
+    // The query rows are processed in blocks of BATCH_DIST_QUERY_BLOCK, and the train set
+    // is walked in tiles of about BATCH_DIST_TILE_BYTES, so that each train tile is loaded
+    // into the cache once per query block rather than once per query. For every query
+    // the tiles are still visited in the increasing order, so the top-K lists
+    // (and the ties in them) are exactly the same as with the plain row-by-row scan.
     void operator()(const Range& range) const
     {
-        AutoBuffer<int> buf(src2->rows);
+        int ntrain = src2->rows;
+        int tileRows = std::max((int)(BATCH_DIST_TILE_BYTES / std::max(src2->step[0], (size_t)1)), 16);
+        tileRows = std::min(tileRows, std::max(ntrain, 1));
+        size_t esz = dist->elemSize();
+
+        AutoBuffer<int> buf(tileRows);
         int* bufptr = buf;
 
-        for( int i = range.start; i < range.end; i++ )
+        for( int i0 = range.start; i0 < range.end; i0 += BATCH_DIST_QUERY_BLOCK )
         {
-            func(src1->ptr(i), src2->ptr(), src2->step, src2->rows, src2->cols,
-                 K > 0 ? (uchar*)bufptr : dist->ptr(i), mask->data ? mask->ptr(i) : 0);
+            int i1 = std::min(i0 + BATCH_DIST_QUERY_BLOCK, range.end);
 
-            if( K > 0 )
+            for( int j0 = 0; j0 < ntrain; j0 += tileRows )
             {
-                int* nidxptr = nidx->ptr<int>(i);
-                // since positive float's can be compared just like int's,
-                // we handle both CV_32S and CV_32F cases with a single branch
-                int* distptr = (int*)dist->ptr(i);
+                int nj = std::min(tileRows, ntrain - j0);
 
-                int j, k;
+                for( int i = i0; i < i1; i++ )
+                {
+                    func(src1->ptr(i), src2->ptr(j0), src2->step, nj, src2->cols,
+                         K > 0 ? (uchar*)bufptr : dist->ptr(i) + j0*esz,
+                         mask->data ? mask->ptr(i) + j0 : 0);
 
-                for( j = 0; j < src2->rows; j++ )
+                    if( K > 0 )
+                        updateTopK(bufptr, nj, j0 + update, dist->ptr<int>(i), nidx->ptr<int>(i));
+                }
+            }
+        }
+    }
+
+    // since positive float's can be compared just like int's,
+    // we handle both CV_32S and CV_32F cases with a single branch
+    void updateTopK(const int* d, int n, int idx0, int* distptr, int* nidxptr) const
+    {
+        int j, k, dmax = distptr[K-1];
+
+        for( j = 0; j < n; j++ )
+        {
+            int dj = d[j];
+            if( dj < dmax )
+            {
+                for( k = K-2; k >= 0 && distptr[k] > dj; k-- )
                 {
-                    int d = bufptr[j];
-                    if( d < distptr[K-1] )
-                    {
-                        for( k = K-2; k >= 0 && distptr[k] > d; k-- )
-                        {
-                            nidxptr[k+1] = nidxptr[k];
-                            distptr[k+1] = distptr[k];
-                        }
-                        nidxptr[k+1] = j + update;
-                        distptr[k+1] = d;
-                    }
+                    nidxptr[k+1] = nidxptr[k];
+                    distptr[k+1] = distptr[k];
                 }
+                nidxptr[k+1] = j + idx0;
+                distptr[k+1] = dj;
+                dmax = distptr[K-1];
             }
         }
     }
@@ -3800,8 +3844,10 @@ void cv::batchDistance( InputArray _src1, InputArray _src2,
                   ("The combination of type=%d, dtype=%d and normType=%d is not supported",
                    type, dtype, normType));
 
+    // one stripe per block of queries, see BatchDistInvoker
     parallel_for_(Range(0, src1.rows),
-                  BatchDistInvoker(src1, src2, dist, nidx, K, mask, update, func));
+                  BatchDistInvoker(src1, src2, dist, nidx, K, mask, update, func),
+                  (src1.rows + BATCH_DIST_QUERY_BLOCK - 1)/BATCH_DIST_QUERY_BLOCK);
 }
 
 
@@ -0,0 +1,248 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <stdio.h>
+
+namespace cv
+{
+namespace tracing
+{
+
+struct TraceEvent
+{
+    const char* name;
+    const char* category;
+    const char* arg;
+    int64 start;
+    int64 duration; // -1 for instant events
+};
+
+// Events of one thread. Only the owning thread writes into it, so recording needs no locks.
+struct TraceBuffer
+{
+    TraceBuffer(int _tid, size_t capacity, int _epoch)
+        : tid(_tid), events(capacity), next(0), count(0), epoch(_epoch) {}
+
+    void add(const char* name, const char* category, const char* arg, int64 start, int64 duration)
+    {
+        TraceEvent& e = events[next];
+        e.name = name;
+        e.category = category;
+        e.arg = arg;
+        e.start = start;
+        e.duration = duration;
+        next = next + 1 < events.size() ? next + 1 : 0;
+        count = std::min(count + 1, events.size());
+    }
+
+    int tid;
+    std::vector<TraceEvent> events;
+    size_t next;
+    size_t count;
+    int epoch; // the events are dropped when it differs from TraceStorage::epoch
+};
+
+struct TraceTLS
+{
+    TraceTLS() : buffer(0) {}
+    TraceBuffer* buffer;
+};
+
+class TraceStorage
+{
+public:
+    TraceStorage() : enabled(false), capacity(1 << 16), baseTicks(getTickCount()), epoch(0)
+    {
+        const char* size = getenv("OPENCV_TRACE_BUFFER_SIZE");
+        if (size)
+            capacity = std::max(atoi(size), 16);
+
+        const char* path = getenv("OPENCV_TRACE");
+        if (path && *path)
+        {
+            exitDumpPath = path;
+            enabled = true;
+        }
+    }
+
+    // buffers outlive their threads, so events of finished threads are written too
+    TraceBuffer* getBuffer()
+    {
+        TraceTLS* t = tls.get();
+        if (!t->buffer)
+        {
+            AutoLock lock(mutex);
+            t->buffer = new TraceBuffer((int)buffers.size(), capacity, epoch);
+            buffers.push_back(t->buffer);
+        }
+        return t->buffer;
+    }
+
+    void record(const char* name, const char* category, const char* arg, int64 start, int64 duration)
+    {
+        TraceBuffer* b = getBuffer();
+        // reset() only bumps the epoch, the buffer is cleared by its own thread
+        int e = epoch;
+        if (b->epoch != e)
+        {
+            b->next = b->count = 0;
+            b->epoch = e;
+        }
+        b->add(name, category, arg, start, duration);
+    }
+
+    volatile bool enabled;
+    size_t capacity;
+    int64 baseTicks;
+    String exitDumpPath;
+    volatile int epoch;
+
+    Mutex mutex;
+    std::vector<TraceBuffer*> buffers;
+    TLSData<TraceTLS> tls;
+};
+
+// never destroyed: events may still be recorded by threads running during static destruction
+static TraceStorage& getTraceStorage()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TraceStorage, new TraceStorage())
+}
+
+static void writeString(FILE* f, const char* str)
+{
+    fputc('"', f);
+    for (; str && *str; str++)
+    {
+        char c = *str;
+        if (c == '"' || c == '\\')
+            fputc('\\', f);
+        if ((unsigned char)c >= ' ')
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+bool isEnabled()
+{
+    return getTraceStorage().enabled;
+}
+
+void setEnabled(bool flag)
+{
+    getTraceStorage().enabled = flag;
+}
+
+void reset()
+{
+    CV_XADD(&getTraceStorage().epoch, 1);
+}
+
+void complete(const char* name, const char* category, int64 startTicks, int64 durationTicks)
+{
+    TraceStorage& storage = getTraceStorage();
+    if (storage.enabled)
+        storage.record(name, category, 0, startTicks, durationTicks);
+}
+
+void mark(const char* name, const char* category, const char* arg)
+{
+    TraceStorage& storage = getTraceStorage();
+    if (storage.enabled)
+        storage.record(name, category, arg, getTickCount(), -1);
+}
+
+void markImpl(int impl, const char* func)
+{
+    const char* name = (impl & CV_IMPL_OCL) ? "OpenCL" :
+                       (impl & CV_IMPL_IPP) ? "IPP" :
+                       (impl & CV_IMPL_MT) ? "plain (multithreaded)" : "plain";
+    mark(name, "impl", func);
+}
+
+Region::Region(const char* _name, const char* _category)
+    : name(_name), category(_category), start(0)
+{
+    if (getTraceStorage().enabled)
+        start = getTickCount();
+}
+
+Region::~Region()
+{
+    if (start != 0)
+        complete(name, category, start, getTickCount() - start);
+}
+
+bool dump(const String& filename)
+{
+    TraceStorage& storage = getTraceStorage();
+    FILE* f = fopen(filename.c_str(), "wt");
+    if (!f)
+        return false;
+
+    double usPerTick = 1e6/getTickFrequency();
+    bool first = true;
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+
+    AutoLock lock(storage.mutex);
+    for (size_t i = 0; i < storage.buffers.size(); i++)
+    {
+        const TraceBuffer& b = *storage.buffers[i];
+        size_t n = b.events.size();
+        if (b.epoch != storage.epoch)
+            continue; // reset since the last event of the thread
+
+        // oldest event first
+        for (size_t k = 0; k < b.count; k++)
+        {
+            const TraceEvent& e = b.events[(b.next + n - b.count + k) % n];
+
+            fputs(first ? "\n{\"name\":" : ",\n{\"name\":", f);
+            first = false;
+            writeString(f, e.name);
+            fputs(",\"cat\":", f);
+            writeString(f, e.category);
+            fprintf(f, ",\"pid\":1,\"tid\":%d,\"ts\":%.3f", b.tid, (e.start - storage.baseTicks)*usPerTick);
+            if (e.duration >= 0)
+                fprintf(f, ",\"ph\":\"X\",\"dur\":%.3f", e.duration*usPerTick);
+            else
+                fputs(",\"ph\":\"i\",\"s\":\"t\"", f);
+            if (e.arg)
+            {
+                fputs(",\"args\":{\"func\":", f);
+                writeString(f, e.arg);
+                fputc('}', f);
+            }
+            fputc('}', f);
+        }
+    }
+
+    fputs("\n]}\n", f);
+    fclose(f);
+    return true;
+}
+
+namespace
+{
+    // writes the trace requested by OPENCV_TRACE at exit
+    struct TraceExitDump
+    {
+        ~TraceExitDump()
+        {
+            TraceStorage& storage = getTraceStorage();
+            if (!storage.exitDumpPath.empty())
+            {
+                storage.enabled = false;
+                dump(storage.exitDumpPath);
+            }
+        }
+    };
+
+    static TraceExitDump traceExitDump;
+}
+
+}
+}
@@ -193,3 +193,83 @@ TEST(Core_HAL, mat_decomp)
                min_hal_t*1e6/freq, min_ocv_t*1e6/freq);
     }
 }
+
+TEST(Core_HAL, mat_decomp_batch)
+{
+    const int sizes[] = { 2, 3, 4, 6, 9, 12 };
+    const int count = 11; // not a multiple of the SIMD width
+
+    for( int hcase = 0; hcase < 12; hcase++ )
+    {
+        int depth = hcase % 2 == 0 ? CV_32F : CV_64F;
+        int m = sizes[hcase / 2];
+        double eps = depth == CV_32F ? 1e-3 : 1e-9;
+
+        // every row of the SoA matrices holds one element of all the matrices
+        Mat a(m*m, count, depth), b(m, count, depth), spd(m*m, count, depth);
+        Mat x, w(m, count, depth), v(m*m, count, depth), sw(m, count, depth), u(m*m, count, depth), vt(m*m, count, depth);
+        std::vector<Mat> A(count), S(count);
+        for( int k = 0; k < count; k++ )
+        {
+            Mat ak(m, m, depth);
+            randu(ak, -1, 1);
+            A[k] = ak;
+            S[k] = ak*ak.t() + Mat::eye(m, m, depth)*0.1;
+            ak.reshape(1, m*m).copyTo(a.col(k));
+            S[k].reshape(1, m*m).copyTo(spd.col(k));
+        }
+        randu(b, -1, 1);
+
+        Mat a1 = a.clone(), s1 = spd.clone(), bx = b.clone(), bc = b.clone();
+        std::vector<int> luinfo(count), cholinfo(count);
+        Mat s2 = spd.clone(), a2 = a.clone();
+        if( depth == CV_32F )
+        {
+            hal::LUBatch(a1.ptr<float>(), a1.step, m, bx.ptr<float>(), bx.step, 1, count, &luinfo[0]);
+            hal::CholeskyBatch(s1.ptr<float>(), s1.step, m, bc.ptr<float>(), bc.step, 1, count, &cholinfo[0]);
+            hal::eigenBatch(s2.ptr<float>(), s2.step, m, w.ptr<float>(), w.step, v.ptr<float>(), v.step, count);
+            hal::SVDBatch(a2.ptr<float>(), a2.step, m, m, sw.ptr<float>(), sw.step,
+                          u.ptr<float>(), u.step, vt.ptr<float>(), vt.step, count);
+        }
+        else
+        {
+            hal::LUBatch(a1.ptr<double>(), a1.step, m, bx.ptr<double>(), bx.step, 1, count, &luinfo[0]);
+            hal::CholeskyBatch(s1.ptr<double>(), s1.step, m, bc.ptr<double>(), bc.step, 1, count, &cholinfo[0]);
+            hal::eigenBatch(s2.ptr<double>(), s2.step, m, w.ptr<double>(), w.step, v.ptr<double>(), v.step, count);
+            hal::SVDBatch(a2.ptr<double>(), a2.step, m, m, sw.ptr<double>(), sw.step,
+                          u.ptr<double>(), u.step, vt.ptr<double>(), vt.step, count);
+        }
+
+        for( int k = 0; k < count; k++ )
+        {
+            Mat bk = b.col(k).clone(), x0, xc0, w0, v0, sw0;
+            solve(A[k], bk, x0, DECOMP_LU);
+            solve(S[k], bk, xc0, DECOMP_CHOLESKY);
+            eigen(S[k], w0, v0);
+            SVD::compute(A[k], sw0, SVD::NO_UV);
+            double scale = std::max(norm(x0, NORM_INF), 1.);
+
+            EXPECT_NE(0, luinfo[k]);
+            EXPECT_EQ(1, cholinfo[k]);
+            EXPECT_LE(norm(bx.col(k), x0, NORM_INF), eps*scale*10) << "LU, m=" << m << ", k=" << k;
+            EXPECT_LE(norm(bc.col(k), xc0, NORM_INF), eps*std::max(norm(xc0, NORM_INF), 1.))
+                << "Cholesky, m=" << m << ", k=" << k;
+            EXPECT_LE(norm(w.col(k), w0, NORM_INF), eps*norm(w0, NORM_INF)) << "eigen, m=" << m << ", k=" << k;
+            EXPECT_LE(norm(sw.col(k), sw0, NORM_INF), eps*norm(sw0, NORM_INF)) << "SVD, m=" << m << ", k=" << k;
+
+            // the vectors may differ in sign from the reference ones, so check the definitions instead
+            Mat vk = v.col(k).clone().reshape(1, m), uk = u.col(k).clone().reshape(1, m);
+            Mat vtk = vt.col(k).clone().reshape(1, m), wk = w.col(k).clone(), swk = sw.col(k).clone();
+            EXPECT_LE(norm(vk*S[k]*vk.t(), Mat::diag(wk), NORM_INF), eps*norm(w0, NORM_INF)*m);
+            EXPECT_LE(norm(uk*Mat::diag(swk)*vtk, A[k], NORM_INF), eps*m);
+        }
+
+        // singular matrices are reported in info
+        Mat z = Mat::zeros(m*m, count, depth);
+        if( depth == CV_32F )
+            hal::LUBatch(z.ptr<float>(), z.step, m, 0, 0, 0, count, &luinfo[0]);
+        else
+            hal::LUBatch(z.ptr<double>(), z.step, m, 0, 0, 0, count, &luinfo[0]);
+        EXPECT_EQ(count, (int)std::count(luinfo.begin(), luinfo.end(), 0));
+    }
+}
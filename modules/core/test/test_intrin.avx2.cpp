@@ -0,0 +1,293 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2015, OpenCV Foundation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the OpenCV Foundation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+// Built with the AVX2 dispatch flags, like the src/*.avx2.cpp files of the modules. The checks use
+// plain arrays only, so that no inline function shared with the baseline code is compiled here.
+
+#include "opencv2/hal/defs.h"
+#include "opencv2/hal/intrin.hpp"
+#include <math.h>
+
+namespace opt_AVX2
+{
+
+using namespace cv;
+
+#define CHECK_INTRIN(cond, name) if( !(cond) ) return name
+
+static short sat16(int v) { return (short)(v < -32768 ? -32768 : v > 32767 ? 32767 : v); }
+static uchar sat8(int v) { return (uchar)(v < 0 ? 0 : v > 255 ? 255 : v); }
+
+static const char* checkInt32()
+{
+    int a[8], b[8], r[8], r2[8];
+    for( int i = 0; i < 8; i++ )
+    {
+        a[i] = i*1000 - 3500;
+        b[i] = 7 - i*3;
+    }
+    v_int32x8 va = v256_load(a), vb = v256_load(b);
+
+    v_store(r, va + vb);
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == a[i] + b[i], "v_int32x8 +");
+    v_store(r, va - vb);
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == a[i] - b[i], "v_int32x8 -");
+    v_store(r, va * vb);
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == a[i] * b[i], "v_int32x8 *");
+    v_store(r, v_min(va, vb));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (a[i] < b[i] ? a[i] : b[i]), "v_min(v_int32x8)");
+    v_store(r, v_select(va > vb, va, vb));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (a[i] > b[i] ? a[i] : b[i]), "v_select(v_int32x8)");
+    v_store(r, va >> 3);
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (a[i] >> 3), "v_int32x8 >>");
+    v_store(r, v_shl<2>(va));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == a[i]*4, "v_shl(v_int32x8)");
+
+    int sum = 0, mask = 0;
+    for( int i = 0; i < 8; i++ )
+    {
+        sum += a[i];
+        mask |= (a[i] < 0) << i;
+    }
+    CHECK_INTRIN(v_reduce_sum(va) == sum, "v_reduce_sum(v_int32x8)");
+    CHECK_INTRIN(v_reduce_min(va) == a[0] && v_reduce_max(va) == a[7], "v_reduce_min/max(v_int32x8)");
+    CHECK_INTRIN(v_signmask(va) == mask, "v_signmask(v_int32x8)");
+    CHECK_INTRIN(v_check_any(va < vb) && !v_check_all(va < vb), "v_check_any/all(v_int32x8)");
+
+    v_store(r, v_extract<3>(va, vb));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (i + 3 < 8 ? a[i + 3] : b[i - 5]), "v_extract(v_int32x8)");
+    v_store(r, v_combine_low(va, vb));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (i < 4 ? a[i] : b[i - 4]), "v_combine_low(v_int32x8)");
+    v_store(r, v_combine_high(va, vb));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (i < 4 ? a[i + 4] : b[i]), "v_combine_high(v_int32x8)");
+
+    v_int32x8 z0, z1;
+    v_zip(va, vb, z0, z1);
+    v_store(r, z0);
+    v_store(r2, z1);
+    for( int i = 0; i < 8; i++ )
+        CHECK_INTRIN(r[i] == (i % 2 ? b[i/2] : a[i/2]) && r2[i] == (i % 2 ? b[i/2 + 4] : a[i/2 + 4]),
+                     "v_zip(v_int32x8)");
+
+    v_int64x4 w0, w1;
+    v_expand(va, w0, w1);
+    int64 w[8];
+    v_store(w, w0);
+    v_store(w + 4, w1);
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(w[i] == a[i], "v_expand(v_int32x8)");
+    return 0;
+}
+
+static const char* checkInt16()
+{
+    short a[16], b[16], r[16];
+    int p[16];
+    for( int i = 0; i < 16; i++ )
+    {
+        a[i] = (short)(i*4000 - 30000);
+        b[i] = (short)(i*i*17 - 1000);
+    }
+    v_int16x16 va = v256_load(a), vb = v256_load(b);
+
+    v_store(r, va + vb);
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(r[i] == sat16(a[i] + b[i]), "v_int16x16 +");
+    v_store(r, va - vb);
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(r[i] == sat16(a[i] - b[i]), "v_int16x16 -");
+    v_store(r, v_max(va, vb));
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(r[i] == (a[i] > b[i] ? a[i] : b[i]), "v_max(v_int16x16)");
+
+    v_int32x8 c, d;
+    v_mul_expand(va, vb, c, d);
+    v_store(p, c);
+    v_store(p + 8, d);
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(p[i] == a[i]*b[i], "v_mul_expand(v_int16x16)");
+    v_store(p, v_dotprod(va, vb));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(p[i] == a[i*2]*b[i*2] + a[i*2+1]*b[i*2+1], "v_dotprod(v_int16x16)");
+
+    int mask = 0;
+    for( int i = 0; i < 16; i++ )
+        mask |= (a[i] < 0) << i;
+    CHECK_INTRIN(v_signmask(va) == mask, "v_signmask(v_int16x16)");
+
+    v_int32x8 e0, e1;
+    v_expand(va, e0, e1);
+    v_store(p, e0);
+    v_store(p + 8, e1);
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(p[i] == a[i], "v_expand(v_int16x16)");
+    v_store(r, v_pack(e1, e0));
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(r[i] == a[(i + 8) % 16], "v_pack(v_int32x8)");
+
+    uchar u[32];
+    v_store(u, v_pack_u(va, vb));
+    for( int i = 0; i < 32; i++ )
+        CHECK_INTRIN(u[i] == sat8(i < 16 ? a[i] : b[i - 16]), "v_pack_u(v_int16x16)");
+    return 0;
+}
+
+static const char* checkUInt8()
+{
+    uchar a[32], b[32], r[32], c[96];
+    for( int i = 0; i < 32; i++ )
+    {
+        a[i] = (uchar)(i*9);
+        b[i] = (uchar)(255 - i*5);
+    }
+    v_uint8x32 va = v256_load(a), vb = v256_load(b);
+
+    v_store(r, va + vb);
+    for( int i = 0; i < 32; i++ ) CHECK_INTRIN(r[i] == sat8(a[i] + b[i]), "v_uint8x32 +");
+    v_store(r, va - vb);
+    for( int i = 0; i < 32; i++ ) CHECK_INTRIN(r[i] == sat8(a[i] - b[i]), "v_uint8x32 -");
+    v_store(r, v_absdiff(va, vb));
+    for( int i = 0; i < 32; i++ ) CHECK_INTRIN(r[i] == (a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]), "v_absdiff(v_uint8x32)");
+    v_store(r, va == vb);
+    for( int i = 0; i < 32; i++ ) CHECK_INTRIN(r[i] == (a[i] == b[i] ? 255 : 0), "v_uint8x32 ==");
+
+    unsigned mask = 0;
+    for( int i = 0; i < 32; i++ )
+        mask |= (unsigned)(a[i] >= 128) << i;
+    CHECK_INTRIN((unsigned)v_signmask(va) == mask, "v_signmask(v_uint8x32)");
+
+    ushort w[32];
+    v_uint16x16 w0, w1;
+    v_expand(va, w0, w1);
+    v_store(w, w0);
+    v_store(w + 16, w1);
+    for( int i = 0; i < 32; i++ ) CHECK_INTRIN(w[i] == a[i], "v_expand(v_uint8x32)");
+    v_store(w, v256_load_expand(b));
+    for( int i = 0; i < 16; i++ ) CHECK_INTRIN(w[i] == b[i], "v256_load_expand(uchar)");
+    unsigned q[8];
+    v_store(q, v256_load_expand_q(a + 3));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(q[i] == a[i + 3], "v256_load_expand_q(uchar)");
+
+    for( int i = 0; i < 96; i++ )
+        c[i] = (uchar)(i*7 + 1);
+    v_uint8x32 c0, c1, c2;
+    v_load_deinterleave(c, c0, c1, c2);
+    v_store(r, c1);
+    for( int i = 0; i < 32; i++ ) CHECK_INTRIN(r[i] == c[i*3 + 1], "v_load_deinterleave(v_uint8x32)");
+    uchar d[96];
+    v_store_interleave(d, c2, c1, c0);
+    for( int i = 0; i < 32; i++ )
+        CHECK_INTRIN(d[i*3] == c[i*3 + 2] && d[i*3 + 1] == c[i*3 + 1] && d[i*3 + 2] == c[i*3],
+                     "v_store_interleave(v_uint8x32)");
+    return 0;
+}
+
+static const char* checkFloat32()
+{
+    float CV_DECL_ALIGNED(32) a[8];
+    float b[8], r[8];
+    int ri[8];
+    for( int i = 0; i < 8; i++ )
+    {
+        a[i] = i*1.37f - 5.2f;
+        b[i] = 2.5f - i*0.61f;
+    }
+    v_float32x8 va = v256_load_aligned(a), vb = v256_load(b), vc = v256_setall_f32(0.75f);
+
+    v_store(r, v_muladd(va, vb, vc));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(fabs(r[i] - (a[i]*b[i] + 0.75f)) < 1e-5f, "v_muladd(v_float32x8)");
+    v_store(r, va / vb);
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(fabs(r[i] - a[i]/b[i]) <= 1e-6f*fabs(a[i]/b[i]), "v_float32x8 /");
+    v_store(r, v_sqrt(v_abs(va)));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(fabs(r[i] - sqrt(fabs(a[i]))) < 1e-5f, "v_sqrt(v_float32x8)");
+    v_store(r, v_magnitude(va, vb));
+    for( int i = 0; i < 8; i++ )
+        CHECK_INTRIN(fabs(r[i] - sqrt(a[i]*a[i] + b[i]*b[i])) < 1e-5f, "v_magnitude(v_float32x8)");
+
+    v_store(ri, v_round(va));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(ri[i] == (int)floor(a[i] + 0.5f), "v_round(v_float32x8)");
+    v_store(ri, v_floor(va));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(ri[i] == (int)floor(a[i]), "v_floor(v_float32x8)");
+    v_store(ri, v_ceil(va));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(ri[i] == (int)ceil(a[i]), "v_ceil(v_float32x8)");
+    v_store(ri, v_trunc(va));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(ri[i] == (int)a[i], "v_trunc(v_float32x8)");
+    v_store(r, v_cvt_f32(v_trunc(va)));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == (float)(int)a[i], "v_cvt_f32(v_int32x8)");
+
+    float sum = 0.f;
+    for( int i = 0; i < 8; i++ )
+        sum += a[i];
+    CHECK_INTRIN(fabs(v_reduce_sum(va) - sum) < 1e-5f, "v_reduce_sum(v_float32x8)");
+    CHECK_INTRIN(v_reduce_max(va) == a[7] && v_reduce_min(vb) == b[7], "v_reduce_min/max(v_float32x8)");
+    CHECK_INTRIN(v_signmask(va) == 0x0f, "v_signmask(v_float32x8)");
+
+    double d[8];
+    v_store(d, v_cvt_f64(va));
+    v_store(d + 4, v_cvt_f64_high(va));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(d[i] == (double)a[i], "v_cvt_f64(v_float32x8)");
+    v_float64x4 da = v256_load(d), db = v256_load(d + 4);
+    CHECK_INTRIN(fabs(v_reduce_sum(da + db) - sum) < 1e-5, "v_reduce_sum(v_float64x4)");
+    v_store(r, v_cvt_f32(db, da));
+    for( int i = 0; i < 8; i++ ) CHECK_INTRIN(r[i] == a[(i + 4) % 8], "v_cvt_f32(v_float64x4)");
+
+    // both 128-bit halves hold an independent 4x4 block
+    float m[32], t[32];
+    for( int i = 0; i < 32; i++ )
+        m[i] = (float)i;
+    v_float32x8 m0 = v256_load(m), m1 = v256_load(m + 8), m2 = v256_load(m + 16), m3 = v256_load(m + 24);
+    v_float32x8 t0, t1, t2, t3;
+    v_transpose4x4(m0, m1, m2, m3, t0, t1, t2, t3);
+    v_store(t, t0);
+    v_store(t + 8, t1);
+    v_store(t + 16, t2);
+    v_store(t + 24, t3);
+    for( int i = 0; i < 4; i++ )
+        for( int j = 0; j < 4; j++ )
+            CHECK_INTRIN(t[i*8 + j] == m[j*8 + i] && t[i*8 + j + 4] == m[j*8 + i + 4], "v_transpose4x4(v_float32x8)");
+    return 0;
+}
+
+const char* testIntrinsics()
+{
+    const char* failed = checkInt32();
+    if( !failed )
+        failed = checkInt16();
+    if( !failed )
+        failed = checkUInt8();
+    if( !failed )
+        failed = checkFloat32();
+    return failed;
+}
+
+}
@@ -91,7 +91,7 @@ protected:
             {-1000000, 1000000}, {-10, 10}, {-10, 10}};
         RNG& rng = ts->get_rng();
         RNG rng0;
-        test_case_count = 4;
+        test_case_count = 6;
         int progress = 0;
         MemStorage storage(cvCreateMemStorage(0));
 
@@ -102,10 +102,13 @@ protected:
 
             cvClearMemStorage(storage);
 
-            bool mem = (idx % 4) >= 2;
-            string filename = tempfile(idx % 2 ? ".yml" : ".xml");
+            bool mem = idx >= 3;
+            int fmt = idx % 3 == 0 ? FileStorage::FORMAT_XML :
+                      idx % 3 == 1 ? FileStorage::FORMAT_YAML : FileStorage::FORMAT_BINARY;
+            string filename = tempfile(fmt == FileStorage::FORMAT_XML ? ".xml" :
+                                       fmt == FileStorage::FORMAT_YAML ? ".yml" : ".bin");
 
-            FileStorage fs(filename, FileStorage::WRITE + (mem ? FileStorage::MEMORY : 0));
+            FileStorage fs(filename, FileStorage::WRITE + fmt + (mem ? FileStorage::MEMORY : 0));
 
             int test_int = (int)cvtest::randInt(rng);
             double test_real = (cvtest::randInt(rng)%2?1:-1)*exp(cvtest::randReal(rng)*18-9);
@@ -566,3 +569,191 @@ TEST(Core_InputOutput, FileStorage)
     sprintf(arr, "sprintf is hell %d", 666);
     EXPECT_NO_THROW(f << arr);
 }
+
+TEST(Core_InputOutput, FileStorage_binary)
+{
+    Mat mat(480, 640, CV_32FC3), roi;
+    theRNG().fill(mat, RNG::UNIFORM, -1000, 1000);
+    roi = mat(Rect(10, 20, 300, 200));
+    vector<int> ivec(1000);
+    for( size_t i = 0; i < ivec.size(); i++ )
+        ivec[i] = (int)(i*i) - 30000;
+
+    FileStorage fs(".bin", FileStorage::WRITE + FileStorage::MEMORY + FileStorage::FORMAT_BINARY);
+    fs << "mat" << mat << "roi" << roi << "ivec" << ivec;
+    fs << "params" << "{" << "name" << "binary" << "scale" << 0.125 << "points" << "[:" << 1 << 2 << 3 << "]" << "}";
+    string content = fs.releaseAndGetString();
+    ASSERT_EQ(0, content.compare(0, 7, "%OCVBIN"));
+
+    ASSERT_TRUE(fs.open(content, FileStorage::READ + FileStorage::MEMORY));
+    // the long arrays are complete sequences for the C API as well
+    const CvFileNode* ivec_c = cvGetFileNodeByName(*fs, 0, "ivec");
+    ASSERT_TRUE(ivec_c != 0 && CV_NODE_IS_SEQ(ivec_c->tag));
+    ASSERT_EQ((int)ivec.size(), ivec_c->data.seq->total);
+    EXPECT_EQ(ivec[700], ((const CvFileNode*)cvGetSeqElem(ivec_c->data.seq, 700))->data.i);
+
+    Mat mat2, roi2;
+    fs["mat"] >> mat2;
+    fs["roi"] >> roi2;
+    EXPECT_EQ(0, cvtest::norm(mat, mat2, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(roi, roi2, NORM_INF));
+
+    FileNode params = fs["params"];
+    EXPECT_EQ("binary", (string)params["name"]);
+    EXPECT_EQ(0.125, (double)params["scale"]);
+    EXPECT_EQ(3, (int)params["points"][2]);
+
+    // the binary storage is converted to YAML
+    FileStorage yml(".yml", FileStorage::WRITE + FileStorage::MEMORY);
+    cvWriteFileNode(*yml, "ivec", *fs["ivec"], 0);
+    cvWriteFileNode(*yml, "params", *params, 0);
+    FileStorage fs2(yml.releaseAndGetString(), FileStorage::READ + FileStorage::MEMORY);
+    vector<int> ivec2;
+    fs2["ivec"] >> ivec2;
+    EXPECT_TRUE(ivec == ivec2);
+    EXPECT_EQ(0.125, (double)fs2["params"]["scale"]);
+
+    // the array is read both directly and through the nodes
+    FileNode ivec_node = fs["ivec"];
+    vector<float> fvec;
+    ivec_node >> ivec2;
+    ivec_node >> fvec;
+    EXPECT_TRUE(ivec == ivec2);
+    ASSERT_EQ(ivec.size(), fvec.size());
+    EXPECT_EQ(ivec[999], (int)fvec[999]);
+    FileNodeIterator it = ivec_node.begin();
+    it += 500;
+    EXPECT_EQ(ivec[500], (int)*it);
+    int part[100];
+    it.readRaw("i", (uchar*)part, 100);
+    EXPECT_EQ(ivec[599], part[99]);
+    EXPECT_EQ(ivec[600], (int)*it);
+    EXPECT_EQ(ivec[10], (int)ivec_node[10]);
+    ivec_node >> ivec2;
+    EXPECT_TRUE(ivec == ivec2);
+}
+
+namespace {
+
+// reads the elements of a raw sequence one by one from several threads
+class ReadRawSeqElems : public ParallelLoopBody
+{
+public:
+    ReadRawSeqElems(const FileNode& _node, const vector<int>& _expected, int* _errors)
+        : node(_node), expected(_expected), errors(_errors) {}
+
+    void operator()(const Range& range) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            if( (int)node[i] != expected[i] )
+                CV_XADD(errors, 1);
+        }
+    }
+
+private:
+    FileNode node;
+    const vector<int>& expected;
+    int* errors;
+};
+
+}
+
+TEST(Core_InputOutput, FileStorage_binary_lazy_nodes)
+{
+    vector<int> ivec(100000), ivec2;
+    for( size_t i = 0; i < ivec.size(); i++ )
+        ivec[i] = (int)i*7 - 1000;
+    Mat mat(200, 300, CV_32F), mat2;
+    theRNG().fill(mat, RNG::UNIFORM, -1, 1);
+
+    FileStorage fs(".bin", FileStorage::WRITE + FileStorage::MEMORY + FileStorage::FORMAT_BINARY);
+    fs << "ivec" << ivec << "ivec2" << ivec << "mat" << mat;
+    string content = fs.releaseAndGetString();
+
+    // loading and reading the arrays at once creates no nodes for their elements
+    ASSERT_TRUE(fs.open(content, FileStorage::READ + FileStorage::MEMORY));
+    FileNode ivec_node = fs["ivec"];
+    const CvSeq* seq = ivec_node.node->data.seq;
+    ASSERT_EQ((int)ivec.size(), seq->total);
+    EXPECT_TRUE(seq->first == 0);
+    ivec_node >> ivec2;
+    fs["mat"] >> mat2;
+    int part[10];
+    ivec_node.begin().readRaw("i", (uchar*)part, 10);
+    EXPECT_TRUE(ivec == ivec2);
+    EXPECT_EQ(0, cvtest::norm(mat, mat2, NORM_INF));
+    EXPECT_EQ(ivec[9], part[9]);
+    EXPECT_TRUE(seq->first == 0);
+    EXPECT_TRUE(fs["mat"]["data"].node->data.seq->first == 0);
+
+    // the nodes are created once, when the elements are accessed one by one from any thread
+    int errors = 0;
+    parallel_for_(Range(0, (int)ivec.size()), ReadRawSeqElems(ivec_node, ivec, &errors), 16);
+    EXPECT_EQ(0, errors);
+    EXPECT_TRUE(seq->first != 0);
+    EXPECT_EQ((int)ivec.size(), seq->total);
+    EXPECT_TRUE(fs["ivec2"].node->data.seq->first == 0);
+
+    // the C API gets all of them as soon as it looks a node up
+    const CvFileNode* ivec2_c = cvGetFileNodeByName(*fs, 0, "ivec2");
+    ASSERT_TRUE(ivec2_c != 0 && ivec2_c->data.seq->first != 0);
+    EXPECT_EQ(ivec[12345], ((const CvFileNode*)cvGetSeqElem(ivec2_c->data.seq, 12345))->data.i);
+}
+
+TEST(Core_InputOutput, FileStorage_mmap)
+{
+    Mat mat(300, 200, CV_16SC2), small(3, 3, CV_64F);
+    int sizes[] = { 10, 20, 30 };
+    Mat nd(3, sizes, CV_8U);
+    theRNG().fill(mat, RNG::UNIFORM, -1000, 1000);
+    theRNG().fill(small, RNG::UNIFORM, -1, 1);
+    theRNG().fill(nd, RNG::UNIFORM, 0, 256);
+
+    string filename = tempfile(".bin");
+    FileStorage fs(filename, FileStorage::WRITE + FileStorage::FORMAT_BINARY);
+    fs << "mat" << mat << "small" << small << "nd" << nd;
+    fs.release();
+
+    Mat mat2, mat3, small2, nd2;
+    ASSERT_TRUE(fs.open(filename, FileStorage::READ + FileStorage::MMAP));
+    fs["mat"] >> mat2;
+    fs["mat"] >> mat3;
+    fs["small"] >> small2;
+    fs["nd"] >> nd2;
+    fs.release();
+
+    // the large matrices reference the mapped file, which outlives the storage; the matrices
+    // read from the same node share the data (see FileStorage::MMAP)
+    EXPECT_EQ(mat2.data, mat3.data);
+    EXPECT_EQ(0, cvtest::norm(mat, mat2, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(small, small2, NORM_INF));
+    ASSERT_EQ(3, nd2.dims);
+    EXPECT_EQ(0, cvtest::norm(nd, nd2, NORM_INF));
+
+    // the mapping is private
+    mat2.setTo(Scalar::all(0));
+    mat3.release();
+    ASSERT_TRUE(fs.open(filename, FileStorage::READ));
+    fs["mat"] >> mat3;
+    EXPECT_EQ(0, cvtest::norm(mat, mat3, NORM_INF));
+    fs.release();
+
+    mat2.release();
+    nd2.release();
+    remove(filename.c_str());
+}
+
+TEST(Core_InputOutput, FileStorage_numbers)
+{
+    const char* content =
+        "%YAML:1.0\n"
+        "values: [ 0.1, -2.5e-3, 1e22, 1234567890.12345678, 7.0e-300, 0x10, 010, -2147483647, .5, 3. ]\n";
+    double expected[] = { 0.1, -2.5e-3, 1e22, 1234567890.12345678, 7.0e-300, 16, 8, -2147483647, 0.5, 3 };
+
+    FileStorage fs(content, FileStorage::READ + FileStorage::MEMORY);
+    FileNode values = fs["values"];
+    ASSERT_EQ((size_t)10, values.size());
+    for( int i = 0; i < 10; i++ )
+        EXPECT_EQ(expected[i], (double)values[i]) << "i=" << i;
+}
@@ -1472,3 +1472,60 @@ TEST(Core_Mat_vector, copyTo_roi_row)
     EXPECT_EQ(4, (int)dst2[3]);
     EXPECT_EQ(5, (int)dst2[4]);
 }
+
+TEST(Core_ScopedArena, reuse)
+{
+    Mat outside;
+    uchar* first = 0;
+    {
+        ScopedArena arena;
+        ScopedArena::resetStats();
+
+        Mat m(480, 640, CV_8UC3);
+        first = m.data;
+        m.release();
+
+        // a slightly smaller buffer falls into the same size class
+        Mat m2(480, 638, CV_8UC3);
+        EXPECT_EQ(first, m2.data);
+        m2.setTo(Scalar::all(1));
+
+        ScopedArena::Stats stats = ScopedArena::getStats();
+        EXPECT_EQ((size_t)1, stats.hits);
+        EXPECT_EQ((size_t)1, stats.misses);
+        EXPECT_LE((size_t)480*640*3, stats.allocatedSize);
+
+        outside = m2; // released after the scope ends
+    }
+
+    Mat heap(480, 640, CV_8UC3);
+    EXPECT_NE(first, heap.data);
+    EXPECT_EQ(1, (int)outside.at<Vec3b>(479, 637)[2]);
+
+    BufferPoolController* c = ScopedArena::getAllocator()->getBufferPoolController();
+    size_t reserved = c->getReservedSize();
+    outside.release();
+    EXPECT_LT(reserved, c->getReservedSize());
+    EXPECT_EQ((size_t)0, ScopedArena::getStats().allocatedSize);
+
+    c->freeAllReservedBuffers();
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+}
+
+TEST(Core_ScopedArena, maxReservedSize)
+{
+    BufferPoolController* c = ScopedArena::getAllocator()->getBufferPoolController();
+    size_t maxSize = c->getMaxReservedSize();
+    c->setMaxReservedSize(1 << 20);
+    {
+        ScopedArena arena;
+        Mat small(100, 100, CV_8U), big(2000, 1000, CV_8U);
+        EXPECT_TRUE(big.u->currAllocator == ScopedArena::getAllocator());
+    }
+    EXPECT_GE((size_t)1 << 20, c->getReservedSize());
+    EXPECT_LT((size_t)0, c->getReservedSize());
+
+    c->setMaxReservedSize(0);
+    EXPECT_EQ((size_t)0, c->getReservedSize());
+    c->setMaxReservedSize(maxSize);
+}
@@ -1,5 +1,7 @@
 #include "test_precomp.hpp"
 
+#include <fstream>
+
 using namespace cv;
 using namespace std;
 
@@ -138,3 +140,48 @@ TEST(Core_String, find_last_of__with__empty_string)
     // npos is not exported: EXPECT_EQ(cv::String::npos, p);
     EXPECT_EQ(std::string::npos, p);
 }
+
+#ifdef CV_ENABLE_TRACE
+static string readTrace()
+{
+    string name = cv::tempfile(".json");
+    EXPECT_TRUE(cv::tracing::dump(name));
+
+    std::ifstream f(name.c_str());
+    string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    remove(name.c_str());
+    return content;
+}
+
+TEST(Core_Trace, regions)
+{
+    bool enabled = cv::tracing::isEnabled();
+    cv::tracing::reset();
+    cv::tracing::setEnabled(true);
+    {
+        cv::tracing::Region region("test_region", "test");
+        Mat a(64, 64, CV_8U, Scalar(1)), b;
+        cv::add(a, a, b);
+    }
+    cv::tracing::setEnabled(enabled);
+
+    string trace = readTrace();
+    EXPECT_NE(string::npos, trace.find("\"traceEvents\""));
+    EXPECT_NE(string::npos, trace.find("{\"name\":\"test_region\",\"cat\":\"test\""));
+    EXPECT_NE(string::npos, trace.find("{\"name\":\"add\""));
+}
+
+TEST(Core_Trace, disabled)
+{
+    bool enabled = cv::tracing::isEnabled();
+    cv::tracing::reset();
+    cv::tracing::setEnabled(false);
+    {
+        cv::tracing::Region region("test_region", "test");
+    }
+    cv::tracing::setEnabled(enabled);
+
+    EXPECT_EQ(string::npos, readTrace().find("test_region"));
+}
+#endif
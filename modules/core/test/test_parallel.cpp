@@ -0,0 +1,232 @@
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+class CountingLoopBody : public ParallelLoopBody
+{
+public:
+    CountingLoopBody(vector<int>& _hits, int _heavyEvery)
+        : hits(&_hits), heavyEvery(_heavyEvery), active(0), maxActive(0) {}
+
+    void operator()(const Range& r) const
+    {
+        {
+            AutoLock lock(mutex);
+            maxActive = std::max(maxActive, ++active);
+        }
+
+        for (int i = r.start; i < r.end; i++)
+        {
+            CV_XADD(&(*hits)[i], 1);
+            // uneven workload: a few iterations are much more expensive
+            if (heavyEvery > 0 && i % heavyEvery == 0)
+            {
+                volatile double s = 0;
+                for (int k = 0; k < 20000; k++)
+                    s += std::sqrt((double)k);
+            }
+        }
+
+        AutoLock lock(mutex);
+        active--;
+    }
+
+    vector<int>* hits;
+    int heavyEvery;
+    mutable Mutex mutex;
+    mutable int active;
+    mutable int maxActive;
+};
+
+class NestedLoopBody : public ParallelLoopBody
+{
+public:
+    NestedLoopBody(vector<int>& _hits, int _inner) : hits(&_hits), inner(_inner) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            vector<int> innerHits(inner, 0);
+            CountingLoopBody body(innerHits, 0);
+            parallel_for_(Range(0, inner), body);
+            for (int j = 0; j < inner; j++)
+                CV_XADD(&(*hits)[i], innerHits[j]);
+        }
+    }
+
+    vector<int>* hits;
+    int inner;
+};
+
+}
+
+TEST(Core_Parallel, each_index_once)
+{
+    const int n = 10007;
+    double stripes[] = { -1, 1, 2, 3, 17, 1000, 1e6 };
+
+    for (size_t s = 0; s < sizeof(stripes)/sizeof(stripes[0]); s++)
+    {
+        vector<int> hits(n, 0);
+        CountingLoopBody body(hits, 0);
+        parallel_for_(Range(0, n), body, stripes[s]);
+        for (int i = 0; i < n; i++)
+            ASSERT_EQ(1, hits[i]) << "nstripes=" << stripes[s] << " i=" << i;
+    }
+}
+
+TEST(Core_Parallel, uneven_workload)
+{
+    const int n = 4096;
+    vector<int> hits(n, 0);
+    CountingLoopBody body(hits, 97);
+    parallel_for_(Range(0, n), body);
+
+    for (int i = 0; i < n; i++)
+        ASSERT_EQ(1, hits[i]) << "i=" << i;
+    EXPECT_LE(body.maxActive, std::max(getNumThreads(), 1));
+}
+
+TEST(Core_Parallel, nested)
+{
+    const int outer = 64, inner = 1000;
+    vector<int> hits(outer, 0);
+    NestedLoopBody body(hits, inner);
+    parallel_for_(Range(0, outer), body);
+
+    for (int i = 0; i < outer; i++)
+        ASSERT_EQ(inner, hits[i]) << "i=" << i;
+}
+
+TEST(Core_Parallel, setNumThreads)
+{
+    int nthreads = getNumThreads();
+    const int n = 1000;
+
+    for (int t = 1; t <= 4; t++)
+    {
+        setNumThreads(t);
+        vector<int> hits(n, 0);
+        CountingLoopBody body(hits, 0);
+        parallel_for_(Range(0, n), body);
+        for (int i = 0; i < n; i++)
+            ASSERT_EQ(1, hits[i]) << "threads=" << t << " i=" << i;
+    }
+
+    setNumThreads(nthreads);
+}
+
+TEST(Core_Parallel, context)
+{
+    const int n = 5000;
+    ParallelContext ctx(3, vector<int>(1, 0));
+    EXPECT_EQ(3, ctx.getNumThreads());
+    EXPECT_EQ(1u, ctx.getCPUs().size());
+
+    vector<int> hits(n, 0);
+    CountingLoopBody body(hits, 97);
+    parallel_for_(Range(0, n), body, ctx);
+
+    for (int i = 0; i < n; i++)
+        ASSERT_EQ(1, hits[i]) << "i=" << i;
+    EXPECT_LE(body.maxActive, 3);
+}
+
+TEST(Core_Parallel, context_scope)
+{
+    ParallelContext ctx(2);
+    EXPECT_TRUE(ParallelContext::current() == NULL);
+    {
+        ParallelContext::Scope scope(ctx);
+        EXPECT_EQ(&ctx, ParallelContext::current());
+        EXPECT_EQ(2, getNumThreads());
+
+        const int outer = 16, inner = 500;
+        vector<int> hits(outer, 0);
+        NestedLoopBody body(hits, inner);
+        parallel_for_(Range(0, outer), body);
+
+        for (int i = 0; i < outer; i++)
+            ASSERT_EQ(inner, hits[i]) << "i=" << i;
+    }
+    EXPECT_TRUE(ParallelContext::current() == NULL);
+}
+
+namespace {
+
+// records the number of threads the nested loops of each chunk would get
+class NumThreadsLoopBody : public ParallelLoopBody
+{
+public:
+    NumThreadsLoopBody(vector<int>& _nthreads) : nthreads(&_nthreads) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; i++)
+            (*nthreads)[i] = getNumThreads();
+    }
+
+    vector<int>* nthreads;
+};
+
+}
+
+TEST(Core_Parallel, context_nested_from_caller)
+{
+    int prevThreads = getNumThreads();
+    setNumThreads(2);
+    {
+        const int n = 200;
+        ParallelContext ctx(3);
+        vector<int> nthreads(n, 0);
+        NumThreadsLoopBody body(nthreads);
+        // one chunk per index, so that the calling thread runs some of them itself
+        parallel_for_(Range(0, n), body, ctx, n);
+
+        for (int i = 0; i < n; i++)
+            ASSERT_EQ(3, nthreads[i]) << "i=" << i;
+        EXPECT_TRUE(ParallelContext::current() == NULL);
+    }
+    setNumThreads(prevThreads);
+}
+
+namespace {
+
+class ContextLoopBody : public ParallelLoopBody
+{
+public:
+    ContextLoopBody(ParallelContext* _ctx, vector<int>* _hits) : ctx(_ctx), hits(_hits) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; i++)
+        {
+            CountingLoopBody body(hits[i], 0);
+            parallel_for_(Range(0, (int)hits[i].size()), body, ctx[i]);
+        }
+    }
+
+    ParallelContext* ctx;
+    vector<int>* hits;
+};
+
+}
+
+TEST(Core_Parallel, concurrent_contexts)
+{
+    ParallelContext ctx[2];
+    ctx[0].setNumThreads(2);
+    ctx[1].setNumThreads(3);
+    vector<int> hits[2] = { vector<int>(3000, 0), vector<int>(7000, 0) };
+
+    ContextLoopBody body(ctx, hits);
+    parallel_for_(Range(0, 2), body, 2);
+
+    for (int k = 0; k < 2; k++)
+        for (size_t i = 0; i < hits[k].size(); i++)
+            ASSERT_EQ(1, hits[k][i]) << "context=" << k << " i=" << i;
+}
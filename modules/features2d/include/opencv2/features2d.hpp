@@ -922,6 +922,9 @@ protected:
 
         // Vector of matrices "descriptors" will be merged to one matrix "mergedDescriptors" here.
         void set( const std::vector<Mat>& descriptors );
+        // Descriptors of more images are appended as separate blocks, so the merged matrix
+        // (and an index built on top of it) stays where it is.
+        void append( const std::vector<Mat>& descriptors );
         virtual void clear();
 
         const Mat& getDescriptors() const;
@@ -934,6 +937,7 @@ protected:
     protected:
         Mat mergedDescriptors;
         std::vector<int> startIdxs;
+        std::vector<Mat> appendedDescriptors;
     };
 
     //! In fact the matching is implemented only by the following two methods. These methods suppose
@@ -1029,6 +1033,8 @@ protected:
     virtual void radiusMatchImpl( InputArray queryDescriptors, std::vector<std::vector<DMatch> >& matches, float maxDistance,
         InputArrayOfArrays masks=noArray(), bool compactResult=false );
 
+    bool addPointsToIndex();
+
     Ptr<flann::IndexParams> indexParams;
     Ptr<flann::SearchParams> searchParams;
     Ptr<flann::Index> flannIndex;
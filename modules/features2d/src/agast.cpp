@@ -7511,6 +7511,8 @@ Ptr<AgastFeatureDetector> AgastFeatureDetector::create( int threshold, bool nonm
 
 void AGAST(InputArray _img, std::vector<KeyPoint>& keypoints, int threshold, bool nonmax_suppression, int type)
 {
+    CV_TRACE_FUNCTION();
+
     // detect
     switch(type) {
       case AgastFeatureDetector::AGAST_5_8:
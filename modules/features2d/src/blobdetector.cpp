@@ -303,6 +303,8 @@ void SimpleBlobDetectorImpl::findBlobs(InputArray _image, InputArray _binaryImag
 
 void SimpleBlobDetectorImpl::detect(InputArray image, std::vector<cv::KeyPoint>& keypoints, InputArray)
 {
+    CV_TRACE_FUNCTION();
+
     //TODO: support mask
     keypoints.clear();
     Mat grayscaleImage;
@@ -60,6 +60,8 @@ void Feature2D::detect( InputArray image,
                         std::vector<KeyPoint>& keypoints,
                         InputArray mask )
 {
+    CV_TRACE_FUNCTION();
+
     if( image.empty() )
     {
         keypoints.clear();
@@ -102,6 +104,8 @@ void Feature2D::compute( InputArray image,
                          std::vector<KeyPoint>& keypoints,
                          OutputArray descriptors )
 {
+    CV_TRACE_FUNCTION();
+
     if( image.empty() )
     {
         descriptors.release();
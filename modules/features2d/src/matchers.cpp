@@ -400,7 +400,10 @@ DescriptorMatcher::DescriptorCollection::DescriptorCollection()
 DescriptorMatcher::DescriptorCollection::DescriptorCollection( const DescriptorCollection& collection )
 {
     mergedDescriptors = collection.mergedDescriptors.clone();
-    std::copy( collection.startIdxs.begin(), collection.startIdxs.begin(), startIdxs.begin() );
+    startIdxs = collection.startIdxs;
+    appendedDescriptors.resize( collection.appendedDescriptors.size() );
+    std::transform( collection.appendedDescriptors.begin(), collection.appendedDescriptors.end(),
+                    appendedDescriptors.begin(), clone_op );
 }
 
 DescriptorMatcher::DescriptorCollection::~DescriptorCollection()
@@ -455,10 +458,33 @@ void DescriptorMatcher::DescriptorCollection::set( const std::vector<Mat>& descr
     }
 }
 
+void DescriptorMatcher::DescriptorCollection::append( const std::vector<Mat>& descriptors )
+{
+    if( startIdxs.empty() )
+    {
+        set( descriptors );
+        return;
+    }
+
+    for( size_t i = 0; i < descriptors.size(); i++ )
+    {
+        const Mat& d = descriptors[i];
+        if( !d.empty() )
+        {
+            const Mat& ref = !mergedDescriptors.empty() ? mergedDescriptors :
+                             !appendedDescriptors.empty() ? appendedDescriptors.back() : d;
+            CV_Assert( d.cols == ref.cols && d.type() == ref.type() );
+        }
+        startIdxs.push_back( size() );
+        appendedDescriptors.push_back( d );
+    }
+}
+
 void DescriptorMatcher::DescriptorCollection::clear()
 {
     startIdxs.clear();
     mergedDescriptors.release();
+    appendedDescriptors.clear();
 }
 
 const Mat DescriptorMatcher::DescriptorCollection::getDescriptor( int imgIdx, int localDescIdx ) const
@@ -478,7 +504,13 @@ const Mat& DescriptorMatcher::DescriptorCollection::getDescriptors() const
 const Mat DescriptorMatcher::DescriptorCollection::getDescriptor( int globalDescIdx ) const
 {
     CV_Assert( globalDescIdx < size() );
-    return mergedDescriptors.row( globalDescIdx );
+    if( globalDescIdx < mergedDescriptors.rows )
+        return mergedDescriptors.row( globalDescIdx );
+
+    int imgIdx, localDescIdx;
+    getLocalIdx( globalDescIdx, imgIdx, localDescIdx );
+    int firstAppended = (int)(startIdxs.size() - appendedDescriptors.size());
+    return appendedDescriptors[imgIdx - firstAppended].row( localDescIdx );
 }
 
 void DescriptorMatcher::DescriptorCollection::getLocalIdx( int globalDescIdx, int& imgIdx, int& localDescIdx ) const
@@ -492,7 +524,9 @@ void DescriptorMatcher::DescriptorCollection::getLocalIdx( int globalDescIdx, in
 
 int DescriptorMatcher::DescriptorCollection::size() const
 {
-    return mergedDescriptors.rows;
+    if( appendedDescriptors.empty() )
+        return mergedDescriptors.rows;
+    return startIdxs.back() + appendedDescriptors.back().rows;
 }
 
 /*
@@ -718,6 +752,8 @@ static bool ocl_knnMatch(InputArray query, InputArray _train, std::vector< std::
 void BFMatcher::knnMatchImpl( InputArray _queryDescriptors, std::vector<std::vector<DMatch> >& matches, int knn,
                              InputArrayOfArrays _masks, bool compactResult )
 {
+    CV_TRACE_FUNCTION();
+
     int trainDescType = trainDescCollection.empty() ? utrainDescCollection[0].type() : trainDescCollection[0].type();
     CV_Assert( _queryDescriptors.type() == trainDescType );
 
@@ -865,6 +901,8 @@ static bool ocl_radiusMatch(InputArray query, InputArray _train, std::vector< st
 void BFMatcher::radiusMatchImpl( InputArray _queryDescriptors, std::vector<std::vector<DMatch> >& matches,
                                 float maxDistance, InputArrayOfArrays _masks, bool compactResult )
 {
+    CV_TRACE_FUNCTION();
+
     int trainDescType = trainDescCollection.empty() ? utrainDescCollection[0].type() : trainDescCollection[0].type();
     CV_Assert( _queryDescriptors.type() == trainDescType );
 
@@ -1048,15 +1086,53 @@ void FlannBasedMatcher::train()
         // FIXIT: Workaround for 'utrainDescCollection' issue (PR #2142)
         if (!utrainDescCollection.empty())
         {
-            CV_Assert(trainDescCollection.size() == 0);
-            for (size_t i = 0; i < utrainDescCollection.size(); ++i)
+            CV_Assert(trainDescCollection.size() <= utrainDescCollection.size());
+            for (size_t i = trainDescCollection.size(); i < utrainDescCollection.size(); ++i)
                 trainDescCollection.push_back(utrainDescCollection[i].getMat(ACCESS_READ));
         }
+
+        if( flannIndex && mergedDescriptors.size() > 0 && addPointsToIndex() )
+            return;
+
         mergedDescriptors.set( trainDescCollection );
         flannIndex = makePtr<flann::Index>( mergedDescriptors.getDescriptors(), *indexParams );
     }
 }
 
+// Feeds the images added since the last train() to the existing index instead of rebuilding it.
+bool FlannBasedMatcher::addPointsToIndex()
+{
+    cvflann::flann_algorithm_t algo = flannIndex->getAlgorithm();
+    if( algo != cvflann::FLANN_INDEX_KDTREE && algo != cvflann::FLANN_INDEX_KMEANS &&
+        algo != cvflann::FLANN_INDEX_COMPOSITE && algo != cvflann::FLANN_INDEX_LSH &&
+        algo != cvflann::FLANN_INDEX_IVFPQ && algo != cvflann::FLANN_INDEX_HNSW &&
+        algo != cvflann::FLANN_INDEX_LINEAR )
+        return false;
+
+    size_t first = 0;
+    for( int count = 0; first < trainDescCollection.size() && count < mergedDescriptors.size(); first++ )
+        count += trainDescCollection[first].rows;
+    if( first == trainDescCollection.size() )
+        return false;
+
+    std::vector<Mat> descriptors;
+    for( size_t i = first; i < trainDescCollection.size(); i++ )
+    {
+        // the index keeps pointers into the data, so it is copied as set() copies the first
+        // descriptors: the caller may free or modify its matrices after train()
+        descriptors.push_back( trainDescCollection[i].clone() );
+    }
+    mergedDescriptors.append( descriptors );
+
+    // the queries keep using the current index while it is rebuilt in the background
+    for( size_t i = 0; i < descriptors.size(); i++ )
+    {
+        if( !descriptors[i].empty() )
+            flannIndex->addPoints( descriptors[i], 2.f, true );
+    }
+    return true;
+}
+
 void FlannBasedMatcher::read( const FileNode& fn)
 {
      if (!indexParams)
@@ -1294,6 +1370,8 @@ void FlannBasedMatcher::convertToDMatches( const DescriptorCollection& collectio
 void FlannBasedMatcher::knnMatchImpl( InputArray _queryDescriptors, std::vector<std::vector<DMatch> >& matches, int knn,
                                      InputArrayOfArrays /*masks*/, bool /*compactResult*/ )
 {
+    CV_TRACE_FUNCTION();
+
     Mat queryDescriptors = _queryDescriptors.getMat();
     Mat indices( queryDescriptors.rows, knn, CV_32SC1 );
     Mat dists( queryDescriptors.rows, knn, CV_32FC1);
@@ -1305,17 +1383,16 @@ void FlannBasedMatcher::knnMatchImpl( InputArray _queryDescriptors, std::vector<
 void FlannBasedMatcher::radiusMatchImpl( InputArray _queryDescriptors, std::vector<std::vector<DMatch> >& matches, float maxDistance,
                                          InputArrayOfArrays /*masks*/, bool /*compactResult*/ )
 {
+    CV_TRACE_FUNCTION();
+
     Mat queryDescriptors = _queryDescriptors.getMat();
     const int count = mergedDescriptors.size(); // TODO do count as param?
     Mat indices( queryDescriptors.rows, count, CV_32SC1, Scalar::all(-1) );
     Mat dists( queryDescriptors.rows, count, CV_32FC1, Scalar::all(-1) );
-    for( int qIdx = 0; qIdx < queryDescriptors.rows; qIdx++ )
-    {
-        Mat queryDescriptorsRow = queryDescriptors.row(qIdx);
-        Mat indicesRow = indices.row(qIdx);
-        Mat distsRow = dists.row(qIdx);
-        flannIndex->radiusSearch( queryDescriptorsRow, indicesRow, distsRow, maxDistance*maxDistance, count, *searchParams );
-    }
+    if( !queryDescriptors.isContinuous() )
+        queryDescriptors = queryDescriptors.clone();
+    // all the queries at once, the index searches them in parallel
+    flannIndex->radiusSearch( queryDescriptors, indices, dists, maxDistance*maxDistance, count, *searchParams );
 
     convertToDMatches( mergedDescriptors, indices, dists, matches );
 }
@@ -1019,6 +1019,8 @@ extractMSER_8uC3( const Mat& src,
 
 void MSER_Impl::detectRegions( InputArray _src, vector<vector<Point> >& msers, vector<Rect>& bboxes )
 {
+    CV_TRACE_FUNCTION();
+
     Mat src = _src.getMat();
     size_t npix = src.total();
 
@@ -552,3 +552,154 @@ TEST( Features2d_DMatch, read_write )
     String str = fs.releaseAndGetString();
     ASSERT_NE( strstr(str.c_str(), "4.5"), (char*)0 );
 }
+
+// the train sets are larger than one cache tile of the brute-force matcher,
+// and the binary descriptor sizes do not divide the SIMD width
+static void checkKnnMatchAgainstNaive( const Mat& query, const Mat& train, int normType, int k, float eps )
+{
+    BFMatcher matcher( normType );
+    vector<vector<DMatch> > matches;
+    matcher.knnMatch( query, train, matches, k );
+    ASSERT_EQ( query.rows, (int)matches.size() );
+
+    for( int i = 0; i < query.rows; i++ )
+    {
+        vector<pair<double, int> > ref;
+        for( int j = 0; j < train.rows; j++ )
+            ref.push_back( make_pair(norm(query.row(i), train.row(j), normType), j) );
+        std::stable_sort( ref.begin(), ref.end() );
+
+        ASSERT_EQ( k, (int)matches[i].size() );
+        for( int j = 0; j < k; j++ )
+        {
+            EXPECT_EQ( i, matches[i][j].queryIdx );
+            EXPECT_NEAR( ref[j].first, matches[i][j].distance, eps*std::max(ref[j].first, 1.) );
+            if( eps == 0 )
+                EXPECT_EQ( ref[j].second, matches[i][j].trainIdx );
+        }
+    }
+}
+
+TEST( Features2d_BFMatcher, knnMatch_tiled )
+{
+    RNG& rng = theRNG();
+    for( int cols = 32; cols <= 61; cols += 29 )
+    {
+        Mat query( 70, cols, CV_8U ), train( 5000, cols, CV_8U );
+        rng.fill( query, RNG::UNIFORM, 0, 256 );
+        rng.fill( train, RNG::UNIFORM, 0, 256 );
+        checkKnnMatchAgainstNaive( query, train, NORM_HAMMING, 4, 0.f );
+        checkKnnMatchAgainstNaive( query, train, NORM_HAMMING2, 2, 0.f );
+    }
+
+    Mat query( 40, 128, CV_32F ), train( 1500, 128, CV_32F );
+    rng.fill( query, RNG::UNIFORM, 0, 1 );
+    rng.fill( train, RNG::UNIFORM, 0, 1 );
+    checkKnnMatchAgainstNaive( query, train, NORM_L2, 3, 1e-5f );
+    checkKnnMatchAgainstNaive( query, train, NORM_L1, 3, 1e-5f );
+}
+
+// train() after add() grows the existing index instead of rebuilding it
+TEST( Features2d_FlannBasedMatcher, incrementalTrain )
+{
+    RNG& rng = theRNG();
+    const int dims = 16;
+    vector<Mat> images;
+    for( int i = 0; i < 4; i++ )
+    {
+        Mat d( 100 + 20*i, dims, CV_32F );
+        rng.fill( d, RNG::UNIFORM, 0, 1 );
+        images.push_back( d );
+    }
+    // a non-continuous block
+    Mat wide( 90, dims*2, CV_32F );
+    rng.fill( wide, RNG::UNIFORM, 0, 1 );
+    images.push_back( wide.colRange(0, dims) );
+
+    FlannBasedMatcher matcher( makePtr<flann::KDTreeIndexParams>(2), makePtr<flann::SearchParams>(10000) );
+    matcher.add( vector<Mat>(images.begin(), images.begin() + 2) );
+    matcher.train();
+    matcher.add( vector<Mat>(1, images[2]) );
+    matcher.train();
+    matcher.add( vector<Mat>(images.begin() + 3, images.end()) );
+    matcher.train();
+
+    for( int imgIdx = 0; imgIdx < (int)images.size(); imgIdx++ )
+    {
+        vector<DMatch> matches;
+        matcher.match( images[imgIdx].clone(), matches );
+        ASSERT_EQ( images[imgIdx].rows, (int)matches.size() );
+        for( int i = 0; i < (int)matches.size(); i++ )
+        {
+            EXPECT_EQ( imgIdx, matches[i].imgIdx );
+            EXPECT_EQ( i, matches[i].trainIdx );
+            EXPECT_EQ( 0.f, matches[i].distance );
+        }
+    }
+}
+
+TEST( Features2d_FlannBasedMatcher, ivfpq )
+{
+    RNG& rng = theRNG();
+    const int dims = 16;
+    vector<Mat> images;
+    for( int i = 0; i < 3; i++ )
+    {
+        Mat d( 200, dims, CV_32F );
+        rng.fill( d, RNG::UNIFORM, 0, 1 );
+        images.push_back( d );
+    }
+
+    // the descriptors are only kept as codes, so a few matches may be wrong
+    FlannBasedMatcher matcher( makePtr<flann::IVFPQIndexParams>(16, 8), makePtr<flann::SearchParams>(-1) );
+    matcher.add( vector<Mat>(images.begin(), images.begin() + 2) );
+    matcher.train();
+    matcher.add( vector<Mat>(1, images[2]) );
+    matcher.train();
+
+    int correct = 0, total = 0;
+    for( int imgIdx = 0; imgIdx < (int)images.size(); imgIdx++ )
+    {
+        vector<DMatch> matches;
+        matcher.match( images[imgIdx], matches );
+        ASSERT_EQ( images[imgIdx].rows, (int)matches.size() );
+        for( int i = 0; i < (int)matches.size(); i++ )
+            correct += matches[i].imgIdx == imgIdx && matches[i].trainIdx == i;
+        total += (int)matches.size();
+    }
+    EXPECT_GT( correct, total * 0.95 );
+}
+
+TEST( Features2d_FlannBasedMatcher, hnsw )
+{
+    RNG& rng = theRNG();
+    const int dims = 16;
+    vector<Mat> images;
+    for( int i = 0; i < 3; i++ )
+    {
+        Mat d( 300, dims, CV_32F );
+        rng.fill( d, RNG::UNIFORM, 0, 1 );
+        images.push_back( d );
+    }
+
+    // the points of the second train() are inserted into the graph
+    FlannBasedMatcher matcher( makePtr<flann::HNSWIndexParams>(8, 50), makePtr<flann::SearchParams>(32) );
+    matcher.add( vector<Mat>(images.begin(), images.begin() + 2) );
+    matcher.train();
+    matcher.add( vector<Mat>(1, images[2]) );
+    matcher.train();
+
+    for( int imgIdx = 0; imgIdx < (int)images.size(); imgIdx++ )
+    {
+        vector<vector<DMatch> > matches;
+        matcher.knnMatch( images[imgIdx], matches, 2 );
+        ASSERT_EQ( images[imgIdx].rows, (int)matches.size() );
+        for( int i = 0; i < (int)matches.size(); i++ )
+        {
+            ASSERT_EQ( 2, (int)matches[i].size() );
+            EXPECT_EQ( imgIdx, matches[i][0].imgIdx );
+            EXPECT_EQ( i, matches[i][0].trainIdx );
+            EXPECT_LE( matches[i][0].distance, matches[i][1].distance );
+        }
+    }
+}
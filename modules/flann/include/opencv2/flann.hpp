@@ -177,6 +177,35 @@ public:
                 unsigned int multi_probe_level );
         };
         @endcode
+        - **IVFPQIndexParams** When passing an object of this type the index created is an inverted
+        file with product quantization: the points are split into lists by a k-means quantizer and only
+        the codes of their residuals are kept, subquantizers bytes per point, so the distances found are
+        approximate. The search visits the lists with the closest centers until checks points are
+        compared. Only for the distances that sum over the dimensions, like L2 and L1. :
+        @code
+        struct IVFPQIndexParams : public IndexParams
+        {
+            IVFPQIndexParams(
+                int lists = 256,
+                int subquantizers = 16,
+                int iterations = 11 );
+        };
+        @endcode
+        - **HNSWIndexParams** When passing an object of this type the index created is a hierarchical
+        navigable small world graph (by Yu. A. Malkov, D. A. Yashunin, Efficient and robust approximate
+        nearest neighbor search using Hierarchical Navigable Small World graphs, PAMI 2018): each point
+        is linked to up to 2*neighbors close points, and to fewer, farther ones in the sparser upper
+        layers. The search descends the layers greedily and then keeps the checks closest points of a
+        best-first search of the graph, so checks must be at least the number of neighbours wanted.
+        Works with any distance. :
+        @code
+        struct HNSWIndexParams : public IndexParams
+        {
+            HNSWIndexParams(
+                int neighbors = 16,
+                int ef_construction = 100 );
+        };
+        @endcode
         - **AutotunedIndexParams** When passing an object of this type the index created is
         automatically tuned to offer the best performance, by choosing the optimal index type
         (randomized kd-trees, hierarchical kmeans, linear) and parameters for the dataset provided. :
@@ -217,11 +246,33 @@ public:
                        std::vector<DistanceType>& dists, int knn, const ::cvflann::SearchParams& params);
         void knnSearch(const Mat& queries, Mat& indices, Mat& dists, int knn, const ::cvflann::SearchParams& params);
 
+        /** @brief Performs a radius nearest neighbor search using the index.
+
+        The Mat overload takes one query per row and fills one row of indices and dists per query; like
+        knnSearch, it searches the queries in parallel. Returns the number of neighbors found, summed over
+        the queries.
+         */
         int radiusSearch(const std::vector<ElementType>& query, std::vector<int>& indices,
                          std::vector<DistanceType>& dists, DistanceType radius, const ::cvflann::SearchParams& params);
         int radiusSearch(const Mat& query, Mat& indices, Mat& dists,
                          DistanceType radius, const ::cvflann::SearchParams& params);
 
+        /** @brief Adds points to the index without rebuilding it (KDTree, KMeans, Composite, LSH,
+        IVF-PQ, HNSW and Linear indices).
+
+        @param features Matrix of the same type and width as the dataset, one point per row. The
+        data is not copied, it must stay valid while the index is used. The points get the indices
+        size(), size()+1, ...
+        @param rebuildThreshold The index is rebuilt from scratch once it has grown by this factor
+        since it was last built.
+         */
+        void addPoints(const Mat& features, float rebuildThreshold = 2);
+
+        /** @brief Removes the point with the given index from the index. The indices of the other
+        points do not change.
+         */
+        void removePoint(int idx) { nnIndex->removePoint(idx); }
+
         void save(String filename) { nnIndex->save(filename); }
 
         int veclen() const { return nnIndex->veclen(); }
@@ -267,6 +318,16 @@ GenericIndex<Distance>::~GenericIndex()
     delete nnIndex;
 }
 
+template <typename Distance>
+void GenericIndex<Distance>::addPoints(const Mat& features, float rebuildThreshold)
+{
+    CV_Assert(features.type() == CvType<ElementType>::type());
+    CV_Assert(features.isContinuous());
+    ::cvflann::Matrix<ElementType> m_features((ElementType*)features.ptr<ElementType>(0), features.rows, features.cols);
+
+    nnIndex->addPoints(m_features, rebuildThreshold);
+}
+
 template <typename Distance>
 void GenericIndex<Distance>::knnSearch(const std::vector<ElementType>& query, std::vector<int>& indices, std::vector<DistanceType>& dists, int knn, const ::cvflann::SearchParams& searchParams)
 {
@@ -40,6 +40,8 @@
 #include "linear_index.h"
 #include "hierarchical_clustering_index.h"
 #include "lsh_index.h"
+#include "ivfpq_index.h"
+#include "hnsw_index.h"
 #include "autotuned_index.h"
 
 
@@ -79,6 +81,12 @@ struct index_creator
         case FLANN_INDEX_LSH:
             nnIndex = new LshIndex<Distance>(dataset, params, distance);
             break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
+        case FLANN_INDEX_IVFPQ:
+            nnIndex = new IVFPQIndex<Distance>(dataset, params, distance);
+            break;
         default:
             throw FLANNException("Unknown index type");
         }
@@ -108,6 +116,9 @@ struct index_creator<False,VectorSpace,Distance>
         case FLANN_INDEX_LSH:
             nnIndex = new LshIndex<Distance>(dataset, params, distance);
             break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
         default:
             throw FLANNException("Unknown index type");
         }
@@ -134,6 +145,9 @@ struct index_creator<False,False,Distance>
         case FLANN_INDEX_LSH:
             nnIndex = new LshIndex<Distance>(dataset, params, distance);
             break;
+        case FLANN_INDEX_HNSW:
+            nnIndex = new HNSWIndex<Distance>(dataset, params, distance);
+            break;
         default:
             throw FLANNException("Unknown index type");
         }
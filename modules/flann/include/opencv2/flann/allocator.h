@@ -106,6 +106,14 @@ public:
      * Destructor. Frees all the memory allocated in this pool.
      */
     ~PooledAllocator()
+    {
+        free();
+    }
+
+    /**
+     * Frees all the memory allocated in this pool, so that it can be reused.
+     */
+    void free()
     {
         void* prev;
 
@@ -114,6 +122,36 @@ public:
             ::free(base);
             base = prev;
         }
+        remaining = 0;
+        usedMemory = 0;
+        wastedMemory = 0;
+    }
+
+    /**
+     * Takes over the memory of another pool, e.g. one filled by another thread;
+     * the other pool is left empty.
+     */
+    void merge(PooledAllocator& other)
+    {
+        if (other.base == NULL) return;
+
+        /* Chain our blocks behind the oldest block of the other pool. */
+        void* oldest = other.base;
+        while (*((void**) oldest) != NULL) {
+            oldest = *((void**) oldest);
+        }
+        *((void**) oldest) = base;
+        base = other.base;
+
+        wastedMemory += remaining + other.wastedMemory;
+        usedMemory += other.usedMemory;
+        remaining = other.remaining;
+        loc = other.loc;
+
+        other.base = NULL;
+        other.remaining = 0;
+        other.usedMemory = 0;
+        other.wastedMemory = 0;
     }
 
     /**
@@ -141,6 +141,29 @@ public:
         kdtree_index_->buildIndex();
     }
 
+    /**
+     * \brief Adds the points to both of the indices
+     */
+    void addPoints(const Matrix<ElementType>& points, float rebuild_threshold = 2)
+    {
+        kmeans_index_->addPoints(points, rebuild_threshold);
+        kdtree_index_->addPoints(points, rebuild_threshold);
+    }
+
+    /**
+     * \brief Removes the point from both of the indices
+     */
+    void removePoint(size_t id)
+    {
+        kmeans_index_->removePoint(id);
+        kdtree_index_->removePoint(id);
+    }
+
+    bool isRemoved(size_t id) const
+    {
+        return kdtree_index_->isRemoved(id);
+    }
+
     /**
      * \brief Saves the index to a stream
      * \param stream The stream to save the index to
@@ -87,6 +87,8 @@ enum flann_algorithm_t
     FLANN_INDEX_KDTREE_SINGLE = 4,
     FLANN_INDEX_HIERARCHICAL = 5,
     FLANN_INDEX_LSH = 6,
+    FLANN_INDEX_IVFPQ = 7,
+    FLANN_INDEX_HNSW = 8,
     FLANN_INDEX_SAVED = 254,
     FLANN_INDEX_AUTOTUNED = 255,
 
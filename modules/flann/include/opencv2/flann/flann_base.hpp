@@ -82,13 +82,16 @@ NNIndex<Distance>* load_saved_index(const Matrix<typename Distance::ElementType>
     if (header.data_type != Datatype<ElementType>::type()) {
         throw FLANNException("Datatype of saved index is different than of the one to be created.");
     }
-    if ((size_t(header.rows) != dataset.rows)||(size_t(header.cols) != dataset.cols)) {
+    // the IVF-PQ index keeps the codes of the points, it can be loaded without them
+    bool no_data = dataset.data == NULL && header.index_type == FLANN_INDEX_IVFPQ;
+    if (!no_data && ((size_t(header.rows) != dataset.rows)||(size_t(header.cols) != dataset.cols))) {
         throw FLANNException("The index saved belongs to a different dataset");
     }
 
     IndexParams params;
     params["algorithm"] = header.index_type;
-    NNIndex<Distance>* nnIndex = create_index_by_type<Distance>(dataset, params, distance);
+    NNIndex<Distance>* nnIndex = create_index_by_type<Distance>(
+            no_data ? Matrix<ElementType>(NULL, header.rows, header.cols) : dataset, params, distance);
     nnIndex->loadIndex(fin);
     fclose(fin);
 
@@ -162,6 +165,21 @@ public:
         nnIndex_->loadIndex(stream);
     }
 
+    virtual void addPoints(const Matrix<ElementType>& points, float rebuild_threshold = 2)
+    {
+        nnIndex_->addPoints(points, rebuild_threshold);
+    }
+
+    virtual void removePoint(size_t id)
+    {
+        nnIndex_->removePoint(id);
+    }
+
+    virtual bool isRemoved(size_t id) const
+    {
+        return nnIndex_->isRemoved(id);
+    }
+
     /**
      * \returns number of features in this index.
      */
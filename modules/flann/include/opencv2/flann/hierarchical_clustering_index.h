@@ -86,7 +86,7 @@ public:
 private:
 
 
-    typedef void (HierarchicalClusteringIndex::* centersAlgFunction)(int, int*, int, int*, int&);
+    typedef void (HierarchicalClusteringIndex::* centersAlgFunction)(int, int*, int, int*, int&, cv::RNG&);
 
     /**
      * The function used for choosing the cluster centers.
@@ -105,9 +105,9 @@ private:
      *     indices_length = length of indices vector
      *
      */
-    void chooseCentersRandom(int k, int* dsindices, int indices_length, int* centers, int& centers_length)
+    void chooseCentersRandom(int k, int* dsindices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
-        UniqueRandom r(indices_length);
+        UniqueRandom r(indices_length, rng);
 
         int index;
         for (index=0; index<k; ++index) {
@@ -146,11 +146,11 @@ private:
      *     indices = indices in the dataset
      * Returns:
      */
-    void chooseCentersGonzales(int k, int* dsindices, int indices_length, int* centers, int& centers_length)
+    void chooseCentersGonzales(int k, int* dsindices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
         int n = indices_length;
 
-        int rnd = rand_int(n);
+        int rnd = rand_int(rng, n);
         assert(rnd >=0 && rnd < n);
 
         centers[0] = dsindices[rnd];
@@ -197,7 +197,7 @@ private:
      *     indices = indices in the dataset
      * Returns:
      */
-    void chooseCentersKMeanspp(int k, int* dsindices, int indices_length, int* centers, int& centers_length)
+    void chooseCentersKMeanspp(int k, int* dsindices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
         int n = indices_length;
 
@@ -205,7 +205,7 @@ private:
         DistanceType* closestDistSq = new DistanceType[n];
 
         // Choose one random center and set the closestDistSq values
-        int index = rand_int(n);
+        int index = rand_int(rng, n);
         assert(index >=0 && index < n);
         centers[0] = dsindices[index];
 
@@ -231,7 +231,7 @@ private:
 
                 // Choose our center - have to be slightly careful to return a valid answer even accounting
                 // for possible rounding errors
-                double randVal = rand_double(currentPot);
+                double randVal = rand_double(rng, currentPot);
                 for (index = 0; index < n-1; index++) {
                     if (randVal <= closestDistSq[index]) break;
                     else randVal -= closestDistSq[index];
@@ -283,7 +283,7 @@ private:
      *     indices = indices in the dataset
      * Returns:
      */
-    void GroupWiseCenterChooser(int k, int* dsindices, int indices_length, int* centers, int& centers_length)
+    void GroupWiseCenterChooser(int k, int* dsindices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
         const float kSpeedUpFactor = 1.3f;
 
@@ -292,7 +292,7 @@ private:
         DistanceType* closestDistSq = new DistanceType[n];
 
         // Choose one random center and set the closestDistSq values
-        int index = rand_int(n);
+        int index = rand_int(rng, n);
         assert(index >=0 && index < n);
         centers[0] = dsindices[index];
 
@@ -469,14 +469,18 @@ public:
 
         free_elements();
 
+        std::vector<int> counts(trees_, (int)size_);
+        std::vector<uint64> seeds(trees_);
         for (int i=0; i<trees_; ++i) {
             indices[i] = new int[size_];
             for (size_t j=0; j<size_; ++j) {
                 indices[i][j] = (int)j;
             }
             root[i] = pool.allocate<Node>();
-            computeClustering(root[i], indices[i], (int)size_, branching_,0);
+            seeds[i] = (uint64)rand_int() + 1;
         }
+        // the trees are built in parallel, each one with a random number generator of its own
+        cv::parallel_for_(cv::Range(0, trees_), ClusteringInvoker(this, root, indices, &counts[0], &seeds[0], branching_, 0));
     }
 
 
@@ -649,24 +653,94 @@ private:
 
 
 
+    /**
+     * Finds the closest center of each point. The points are processed in parallel,
+     * each one only writes its own label and distance.
+     */
+    class LabelsInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        LabelsInvoker(const HierarchicalClusteringIndex* _index, const int* _dsindices, const int* _centers,
+                      int _centers_length, int* _labels, DistanceType* _dists)
+            : index(_index), dsindices(_dsindices), centers(_centers), centers_length(_centers_length),
+              labels(_labels), dists(_dists)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            for (int i = range.start; i < range.end; ++i) {
+                ElementType* point = index->dataset[dsindices[i]];
+                DistanceType dist = index->distance(point, index->dataset[centers[0]], index->veclen_);
+                labels[i] = 0;
+                for (int j=1; j<centers_length; ++j) {
+                    DistanceType new_dist = index->distance(point, index->dataset[centers[j]], index->veclen_);
+                    if (dist>new_dist) {
+                        labels[i] = j;
+                        dist = new_dist;
+                    }
+                }
+                dists[i] = dist;
+            }
+        }
+
+    private:
+        const HierarchicalClusteringIndex* index;
+        const int* dsindices;
+        const int* centers;
+        int centers_length;
+        int* labels;
+        DistanceType* dists;
+    };
+
     void computeLabels(int* dsindices, int indices_length,  int* centers, int centers_length, int* labels, DistanceType& cost)
     {
+        cv::AutoBuffer<DistanceType> dists(indices_length);
+        cv::parallel_for_(cv::Range(0, indices_length),
+                          LabelsInvoker(this, dsindices, centers, centers_length, labels, dists));
         cost = 0;
         for (int i=0; i<indices_length; ++i) {
-            ElementType* point = dataset[dsindices[i]];
-            DistanceType dist = distance(point, dataset[centers[0]], veclen_);
-            labels[i] = 0;
-            for (int j=1; j<centers_length; ++j) {
-                DistanceType new_dist = distance(point, dataset[centers[j]], veclen_);
-                if (dist>new_dist) {
-                    labels[i] = j;
-                    dist = new_dist;
-                }
-            }
-            cost += dist;
+            cost += dists[i];
         }
     }
 
+    /**
+     * Clusters the given nodes in parallel. Each subtree is allocated from a pool
+     * of its own, which is handed over to the index pool once the subtree is complete,
+     * and uses a random number generator of its own, initialized with the given seed.
+     */
+    class ClusteringInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        ClusteringInvoker(HierarchicalClusteringIndex* _index, NodePtr* _nodes, int* const* _dsindices,
+                          const int* _count, const uint64* _seeds, int _branching, int _level)
+            : index(_index), nodes(_nodes), dsindices(_dsindices), count(_count), seeds(_seeds),
+              branching(_branching), level(_level)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            for (int i = range.start; i < range.end; ++i) {
+                PooledAllocator allocator;
+                cv::RNG rng(seeds[i]);
+                index->computeClustering(nodes[i], dsindices[i], count[i], branching, level, allocator, rng);
+
+                cv::AutoLock lock(index->pool_mutex);
+                index->pool.merge(allocator);
+            }
+        }
+
+    private:
+        HierarchicalClusteringIndex* index;
+        NodePtr* nodes;
+        int* const* dsindices;
+        const int* count;
+        const uint64* seeds;
+        int branching;
+        int level;
+    };
+
     /**
      * The method responsible with actually doing the recursive hierarchical
      * clustering
@@ -675,10 +749,13 @@ private:
      *     node = the node to cluster
      *     indices = indices of the points belonging to the current node
      *     branching = the branching factor to use in the clustering
+     *     allocator = the allocator for the new nodes
+     *     rng = the random number generator of this subtree
      *
      * TODO: for 1-sized clusters don't store a cluster center (it's the same as the single cluster point)
      */
-    void computeClustering(NodePtr node, int* dsindices, int indices_length, int branching, int level)
+    void computeClustering(NodePtr node, int* dsindices, int indices_length, int branching, int level,
+                           PooledAllocator& allocator, cv::RNG& rng)
     {
         node->size = indices_length;
         node->level = level;
@@ -694,7 +771,7 @@ private:
         std::vector<int> labels(indices_length);
 
         int centers_length;
-        (this->*chooseCenters)(branching, dsindices, indices_length, &centers[0], centers_length);
+        (this->*chooseCenters)(branching, dsindices, indices_length, &centers[0], centers_length, rng);
 
         if (centers_length<branching) {
             node->indices = dsindices;
@@ -708,7 +785,9 @@ private:
         DistanceType cost;
         computeLabels(dsindices, indices_length, &centers[0], centers_length, &labels[0], cost);
 
-        node->childs = pool.allocate<NodePtr>(branching);
+        node->childs = allocator.allocate<NodePtr>(branching);
+        std::vector<int*> child_indices(branching);
+        std::vector<int> child_count(branching);
         int start = 0;
         int end = start;
         for (int i=0; i<branching; ++i) {
@@ -720,12 +799,29 @@ private:
                 }
             }
 
-            node->childs[i] = pool.allocate<Node>();
+            node->childs[i] = allocator.allocate<Node>();
             node->childs[i]->pivot = centers[i];
             node->childs[i]->indices = NULL;
-            computeClustering(node->childs[i],dsindices+start, end-start, branching, level+1);
+            child_indices[i] = dsindices+start;
+            child_count[i] = end-start;
             start=end;
         }
+
+        if (indices_length >= PARALLEL_CLUSTERING_MIN) {
+            // the clusters are independent of each other
+            std::vector<uint64> seeds(branching);
+            for (int i=0; i<branching; ++i) {
+                seeds[i] = rng.next();
+            }
+            cv::parallel_for_(cv::Range(0, branching),
+                              ClusteringInvoker(this, node->childs, &child_indices[0], &child_count[0], &seeds[0],
+                                                branching, level+1));
+        }
+        else {
+            for (int i=0; i<branching; ++i) {
+                computeClustering(node->childs[i], child_indices[i], child_count[i], branching, level+1, allocator, rng);
+            }
+        }
     }
 
 
@@ -828,12 +924,18 @@ private:
      * number small of memory allocations.
      */
     PooledAllocator pool;
+    cv::Mutex pool_mutex;
 
     /**
      * Memory occupied by the index.
      */
     int memoryCounter;
 
+    /**
+     * The children of a node with at least PARALLEL_CLUSTERING_MIN points are clustered in parallel.
+     */
+    enum { PARALLEL_CLUSTERING_MIN = 1 << 12 };
+
     /** index parameters */
     int branching_;
     int trees_;
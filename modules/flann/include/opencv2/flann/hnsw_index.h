@@ -0,0 +1,744 @@
+/***********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ * Copyright 2008-2009  Marius Muja (mariusm@cs.ubc.ca). All rights reserved.
+ * Copyright 2008-2009  David G. Lowe (lowe@cs.ubc.ca). All rights reserved.
+ *
+ * THE BSD LICENSE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#ifndef OPENCV_FLANN_HNSW_INDEX_H_
+#define OPENCV_FLANN_HNSW_INDEX_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "general.h"
+#include "nn_index.h"
+#include "dist.h"
+#include "matrix.h"
+#include "result_set.h"
+#include "saving.h"
+#include "dynamic_bitset.h"
+
+
+namespace cvflann
+{
+
+struct HNSWIndexParams : public IndexParams
+{
+    HNSWIndexParams(int neighbors = 16, int ef_construction = 100)
+    {
+        (*this)["algorithm"] = FLANN_INDEX_HNSW;
+        // number of links of a point in the upper layers of the graph, there are twice as many in the bottom layer
+        (*this)["neighbors"] = neighbors;
+        // size of the candidate list of the search for the neighbours of an inserted point
+        (*this)["ef_construction"] = ef_construction;
+    }
+};
+
+/**
+ * Vectorized versions of the L2 (squared), L1 and Hamming distances of dist.h, they
+ * use the SSE/AVX2 kernels of the HAL.
+ */
+CV_EXPORTS float graph_l2_distance(const float* a, const float* b, int n);
+CV_EXPORTS float graph_l1_distance(const float* a, const float* b, int n);
+CV_EXPORTS int graph_hamming_distance(const unsigned char* a, const unsigned char* b, int n);
+
+/**
+ * Computes the distance between two points of the graph, or a query and a point.
+ * The L2 and L1 distances of the float indices and the Hamming distance use the
+ * vectorized kernels above.
+ */
+template<typename Distance>
+struct GraphDistance
+{
+    typedef typename Distance::ElementType ElementType;
+    typedef typename Distance::ResultType DistanceType;
+
+    static DistanceType compute(const Distance& distance, const ElementType* a, const ElementType* b, size_t n)
+    {
+        return distance(a, b, n);
+    }
+};
+
+template<>
+struct GraphDistance< L2<float> >
+{
+    static float compute(const L2<float>&, const float* a, const float* b, size_t n)
+    {
+        return graph_l2_distance(a, b, (int)n);
+    }
+};
+
+template<>
+struct GraphDistance< L1<float> >
+{
+    static float compute(const L1<float>&, const float* a, const float* b, size_t n)
+    {
+        return graph_l1_distance(a, b, (int)n);
+    }
+};
+
+template<>
+struct GraphDistance< Hamming<unsigned char> >
+{
+    static int compute(const Hamming<unsigned char>&, const unsigned char* a, const unsigned char* b, size_t n)
+    {
+        return graph_hamming_distance(a, b, (int)n);
+    }
+};
+
+template<>
+struct GraphDistance<HammingLUT>
+{
+    static int compute(const HammingLUT&, const unsigned char* a, const unsigned char* b, size_t n)
+    {
+        return graph_hamming_distance(a, b, (int)n);
+    }
+};
+
+
+/**
+ * Hierarchical navigable small world graph index (HNSW)
+ *
+ * Every point is a node of the bottom layer of a proximity graph, linked to up to 2*neighbors
+ * close points; a point is also a node of the upper layers up to a random level, with an
+ * exponentially decreasing probability, where it has up to neighbors links. The search
+ * descends greedily from the entry point through the upper layers, which have few and far
+ * apart nodes, then explores the bottom layer with a best-first search keeping the checks
+ * closest points found so far. The links of a point are chosen among the closest points
+ * found by the same search when it is inserted, keeping diverse directions.
+ *
+ * The points are inserted in parallel, the links of a node are guarded by a pool of locks.
+ * Any distance can be used. The removed points stay in the graph to keep it connected, the
+ * search goes through them but does not return them.
+ * Malkov, Yashunin - Efficient and robust approximate nearest neighbor search using
+ * Hierarchical Navigable Small World graphs, PAMI 2018
+ */
+template <typename Distance>
+class HNSWIndex : public NNIndex<Distance>
+{
+public:
+    typedef typename Distance::ElementType ElementType;
+    typedef typename Distance::ResultType DistanceType;
+
+    /**
+     * Index constructor
+     *
+     * Params:
+     *          inputData = dataset with the input features
+     *          params = parameters passed to the HNSW algorithm
+     */
+    HNSWIndex(const Matrix<ElementType>& inputData, const IndexParams& params = HNSWIndexParams(),
+              Distance d = Distance())
+        : index_params_(params), rng_(0x5eed), distance_(d)
+    {
+        size_ = inputData.rows;
+        veclen_ = inputData.cols;
+
+        points_.resize(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            points_[i] = inputData[i];
+        }
+        removed_points_.resize(size_);
+        removed_points_.reset();
+        removed_count_ = 0;
+
+        neighbors_ = get_param(params,"neighbors",16);
+        ef_construction_ = get_param(params,"ef_construction",100);
+        setLevelFactor();
+        entry_point_ = -1;
+        max_level_ = -1;
+    }
+
+    HNSWIndex(const HNSWIndex&);
+    HNSWIndex& operator=(const HNSWIndex&);
+
+    virtual ~HNSWIndex()
+    {
+        for (size_t i = 0; i < visited_pool_.size(); ++i) {
+            delete visited_pool_[i];
+        }
+    }
+
+    flann_algorithm_t getType() const
+    {
+        return FLANN_INDEX_HNSW;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t veclen() const
+    {
+        return veclen_;
+    }
+
+    /**
+     * Computes the index memory usage
+     * Returns: memory used by the index
+     */
+    int usedMemory() const
+    {
+        size_t mem = points_.capacity()*sizeof(ElementType*) + levels_.capacity()*sizeof(int) +
+                     links0_.capacity()*sizeof(int) + upper_links_.capacity()*sizeof(std::vector<int>);
+        for (size_t i = 0; i < upper_links_.size(); ++i) {
+            mem += upper_links_[i].capacity()*sizeof(int);
+        }
+        return (int)mem;
+    }
+
+    /**
+     * Builds the graph, inserting the points in parallel.
+     */
+    void buildIndex()
+    {
+        if (neighbors_<2) {
+            throw FLANNException("The number of neighbors must be at least 2");
+        }
+        entry_point_ = -1;
+        max_level_ = -1;
+        levels_.clear();
+        links0_.clear();
+        upper_links_.clear();
+
+        insertPoints(0);
+    }
+
+    /**
+     * Inserts the points into the graph like the build does, the index is never rebuilt.
+     */
+    void addPoints(const Matrix<ElementType>& points, float /*rebuild_threshold*/ = 2)
+    {
+        assert(points.cols == veclen_);
+        size_t old_size = size_;
+        size_ += points.rows;
+        for (size_t i = 0; i < points.rows; ++i) {
+            points_.push_back(points[i]);
+        }
+        removed_points_.resize(size_);
+
+        insertPoints(old_size);
+    }
+
+    void removePoint(size_t id)
+    {
+        if (id >= size_) {
+            throw FLANNException("Invalid id of the point to remove");
+        }
+        if (!removed_points_.test(id)) {
+            removed_points_.set(id);
+            removed_count_++;
+        }
+    }
+
+    bool isRemoved(size_t id) const
+    {
+        return id < removed_points_.size() && removed_points_.test(id);
+    }
+
+    void saveIndex(FILE* stream)
+    {
+        save_value(stream, neighbors_);
+        save_value(stream, ef_construction_);
+        save_value(stream, entry_point_);
+        save_value(stream, max_level_);
+        if (size_ > 0) {
+            save_value(stream, levels_[0], size_);
+            save_value(stream, links0_[0], links0_.size());
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            if (levels_[i] > 0) {
+                save_value(stream, upper_links_[i][0], upper_links_[i].size());
+            }
+        }
+        save_removed_points(stream, removed_points_, removed_count_);
+    }
+
+    void loadIndex(FILE* stream)
+    {
+        load_value(stream, neighbors_);
+        load_value(stream, ef_construction_);
+        load_value(stream, entry_point_);
+        load_value(stream, max_level_);
+        setLevelFactor();
+
+        levels_.resize(size_);
+        links0_.resize(size_*(2*neighbors_+1));
+        upper_links_.assign(size_, std::vector<int>());
+        if (size_ > 0) {
+            load_value(stream, levels_[0], size_);
+            load_value(stream, links0_[0], links0_.size());
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            if (levels_[i] > 0) {
+                upper_links_[i].resize(levels_[i]*(neighbors_+1));
+                load_value(stream, upper_links_[i][0], upper_links_[i].size());
+            }
+        }
+        removed_count_ = load_removed_points(stream, removed_points_, size_);
+
+        index_params_["algorithm"] = getType();
+        index_params_["neighbors"] = neighbors_;
+        index_params_["ef_construction"] = ef_construction_;
+    }
+
+    /**
+     * Find set of nearest neighbors to vec. Their indices are stored inside
+     * the result object.
+     *
+     * Params:
+     *     result = the result object in which the indices of the nearest-neighbors are stored
+     *     vec = the vector for which to search the nearest neighbors
+     *     searchParams = parameters that influence the search algorithm (checks: size of the
+     *                    candidate list of the search in the bottom layer, at least the number
+     *                    of neighbours wanted)
+     */
+    void findNeighbors(ResultSet<DistanceType>& result, const ElementType* vec, const SearchParams& searchParams)
+    {
+        if (entry_point_ < 0) return;
+        int checks = get_param(searchParams,"checks",32);
+        size_t ef = checks < 0 ? size_ : (size_t)std::max(checks, 1);
+
+        int ep = entry_point_;
+        DistanceType ep_dist = distance(vec, points_[ep]);
+        for (int layer = max_level_; layer > 0; --layer) {
+            greedySearch(vec, ep, ep_dist, layer, false);
+        }
+
+        MaxQueue found;
+        VisitedList* visited = acquireVisitedList();
+        searchLayer(vec, ep, ep_dist, ef, 0, false, removed_count_ > 0, *visited, found);
+        releaseVisitedList(visited);
+
+        for (; !found.empty(); found.pop()) {
+            result.addPoint(found.top().first, found.top().second);
+        }
+    }
+
+    IndexParams getParameters() const
+    {
+        return index_params_;
+    }
+
+private:
+    typedef std::pair<DistanceType, int> Neighbor;
+    typedef std::priority_queue<Neighbor> MaxQueue;
+    typedef std::priority_queue<Neighbor, std::vector<Neighbor>, std::greater<Neighbor> > MinQueue;
+
+    enum
+    {
+        /**
+         * Number of locks guarding the links, the lock of a node is chosen by its id
+         */
+        LINK_LOCKS = 1024
+    };
+
+    /**
+     * Marks the nodes visited by a search. A search uses the next mark, so the marks
+     * only need to be cleared when they wrap around.
+     */
+    struct VisitedList
+    {
+        VisitedList() : mark(0) {}
+
+        void reset(size_t count)
+        {
+            if (marks.size() < count) {
+                marks.assign(count, 0);
+                mark = 0;
+            }
+            if (++mark == 0) {
+                std::fill(marks.begin(), marks.end(), (unsigned short)0);
+                mark = 1;
+            }
+        }
+
+        bool test(int id) const { return marks[id] == mark; }
+        void set(int id) { marks[id] = mark; }
+
+        std::vector<unsigned short> marks;
+        unsigned short mark;
+    };
+
+    /**
+     * Inserts a range of points into the graph.
+     */
+    class InsertInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        InsertInvoker(HNSWIndex* _index, const int* _ids) : index(_index), ids(_ids)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            for (int i = range.start; i < range.end; ++i) {
+                index->insertPoint(ids[i]);
+            }
+        }
+
+    private:
+        HNSWIndex* index;
+        const int* ids;
+    };
+
+    void setLevelFactor()
+    {
+        level_factor_ = 1.0/std::log((double)std::max(neighbors_, 2));
+    }
+
+    DistanceType distance(const ElementType* a, const ElementType* b) const
+    {
+        return GraphDistance<Distance>::compute(distance_, a, b, veclen_);
+    }
+
+    /**
+     * The links of a node in a layer: the count followed by the ids of the linked nodes.
+     */
+    int* getLinks(int id, int layer)
+    {
+        if (layer == 0) return &links0_[(size_t)id*(2*neighbors_+1)];
+        return &upper_links_[id][(layer-1)*(neighbors_+1)];
+    }
+
+    /**
+     * Returns the links of a node; while the graph is built they are copied to buf
+     * under the lock of the node.
+     */
+    const int* readLinks(int id, int layer, bool locked, int* buf)
+    {
+        int* links = getLinks(id, layer);
+        if (!locked) return links;
+        cv::AutoLock lock(link_locks_[id % LINK_LOCKS]);
+        memcpy(buf, links, (links[0]+1)*sizeof(int));
+        return buf;
+    }
+
+    VisitedList* acquireVisitedList()
+    {
+        VisitedList* visited;
+        {
+            cv::AutoLock lock(visited_mutex_);
+            if (visited_pool_.empty()) {
+                visited = new VisitedList;
+            }
+            else {
+                visited = visited_pool_.back();
+                visited_pool_.pop_back();
+            }
+        }
+        return visited;
+    }
+
+    void releaseVisitedList(VisitedList* visited)
+    {
+        cv::AutoLock lock(visited_mutex_);
+        visited_pool_.push_back(visited);
+    }
+
+    /**
+     * Draws the levels of the points from first on, allocates their links and inserts
+     * the points that are not removed. The first point of an empty graph is inserted
+     * alone, it becomes the entry point.
+     */
+    void insertPoints(size_t first)
+    {
+        levels_.resize(size_);
+        links0_.resize(size_*(2*neighbors_+1), 0);
+        upper_links_.resize(size_);
+
+        std::vector<int> ids;
+        for (size_t i = first; i < size_; ++i) {
+            levels_[i] = (int)(-std::log(1. - rng_.uniform(0., 1.))*level_factor_);
+            upper_links_[i].assign(levels_[i]*(neighbors_+1), 0);
+            if (removed_count_ == 0 || !removed_points_.test(i)) ids.push_back((int)i);
+        }
+        if (ids.empty()) return;
+
+        int start = 0;
+        if (entry_point_ < 0) {
+            entry_point_ = ids[0];
+            max_level_ = levels_[ids[0]];
+            start = 1;
+        }
+        cv::parallel_for_(cv::Range(start, (int)ids.size()), InsertInvoker(this, &ids[0]));
+    }
+
+    /**
+     * Inserts a point: finds its closest nodes in each of its layers and links them both ways.
+     * A point with a level above the top of the graph becomes the entry point, the global lock
+     * is held during its insertion.
+     */
+    void insertPoint(int id)
+    {
+        int level = levels_[id];
+        entry_mutex_.lock();
+        int ep = entry_point_;
+        int top = max_level_;
+        if (level <= top) entry_mutex_.unlock();
+
+        const ElementType* vec = points_[id];
+        DistanceType ep_dist = distance(vec, points_[ep]);
+        for (int layer = top; layer > level; --layer) {
+            greedySearch(vec, ep, ep_dist, layer, true);
+        }
+
+        VisitedList* visited = acquireVisitedList();
+        for (int layer = std::min(level, top); layer >= 0; --layer) {
+            MaxQueue found;
+            searchLayer(vec, ep, ep_dist, ef_construction_, layer, true, false, *visited, found);
+            connect(id, layer, found, ep, ep_dist);
+        }
+        releaseVisitedList(visited);
+
+        if (level > top) {
+            entry_point_ = id;
+            max_level_ = level;
+            entry_mutex_.unlock();
+        }
+    }
+
+    /**
+     * Moves ep to the closest node of the layer reachable by following the links to closer nodes.
+     */
+    void greedySearch(const ElementType* vec, int& ep, DistanceType& ep_dist, int layer, bool locked)
+    {
+        cv::AutoBuffer<int> buf(neighbors_+1);
+        for (bool changed = true; changed; ) {
+            changed = false;
+            const int* links = readLinks(ep, layer, locked, buf);
+            for (int j = 1; j <= links[0]; ++j) {
+                DistanceType dist = distance(vec, points_[links[j]]);
+                if (dist < ep_dist) {
+                    ep_dist = dist;
+                    ep = links[j];
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * Best-first search of a layer from ep, found gets the ef closest nodes reached (the removed
+     * nodes are explored but not kept when skip_removed is set).
+     */
+    void searchLayer(const ElementType* vec, int ep, DistanceType ep_dist, size_t ef, int layer, bool locked,
+                     bool skip_removed, VisitedList& visited, MaxQueue& found)
+    {
+        cv::AutoBuffer<int> buf(2*neighbors_+1);
+        MinQueue candidates;
+
+        visited.reset(size_);
+        visited.set(ep);
+        candidates.push(Neighbor(ep_dist, ep));
+        if (!skip_removed || !removed_points_.test(ep)) found.push(Neighbor(ep_dist, ep));
+        DistanceType bound = found.empty() ? (std::numeric_limits<DistanceType>::max)() : found.top().first;
+
+        while (!candidates.empty()) {
+            Neighbor current = candidates.top();
+            if (current.first > bound && found.size() >= ef) break;
+            candidates.pop();
+
+            const int* links = readLinks(current.second, layer, locked, buf);
+            for (int j = 1; j <= links[0]; ++j) {
+                int id = links[j];
+                if (visited.test(id)) continue;
+                visited.set(id);
+
+                DistanceType dist = distance(vec, points_[id]);
+                if (found.size() < ef || dist < bound) {
+                    candidates.push(Neighbor(dist, id));
+                    if (!skip_removed || !removed_points_.test(id)) {
+                        found.push(Neighbor(dist, id));
+                        if (found.size() > ef) found.pop();
+                        bound = found.top().first;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Keeps at most count of the candidates (sorted by increasing distance): a candidate is
+     * dropped when it is closer to an already kept one than to the point, so that the links
+     * go in different directions.
+     */
+    void selectNeighbors(std::vector<Neighbor>& candidates, size_t count)
+    {
+        if (candidates.size() <= count) return;
+
+        std::vector<Neighbor> selected;
+        for (size_t i = 0; i < candidates.size() && selected.size() < count; ++i) {
+            const ElementType* vec = points_[candidates[i].second];
+            bool keep = true;
+            for (size_t j = 0; j < selected.size() && keep; ++j) {
+                keep = distance(vec, points_[selected[j].second]) >= candidates[i].first;
+            }
+            if (keep) selected.push_back(candidates[i]);
+        }
+        candidates.swap(selected);
+    }
+
+    /**
+     * Links the point to the nodes selected among the found ones, and the nodes back to the point,
+     * pruning the links of the nodes that are full. ep is moved to the closest node found.
+     */
+    void connect(int id, int layer, MaxQueue& found, int& ep, DistanceType& ep_dist)
+    {
+        std::vector<Neighbor> candidates;
+        for (; !found.empty(); found.pop()) {
+            if (found.top().second != id) candidates.push_back(found.top());
+        }
+        if (candidates.empty()) return;
+        std::reverse(candidates.begin(), candidates.end());
+        ep = candidates[0].second;
+        ep_dist = candidates[0].first;
+
+        selectNeighbors(candidates, neighbors_);
+
+        const ElementType* vec = points_[id];
+        int max_links = layer == 0 ? 2*neighbors_ : neighbors_;
+        std::vector<Neighbor> pruned;
+        {
+            // a point inserted concurrently may have reached this one through the layer above
+            // and linked to it already: those links are kept, so that it stays reachable
+            cv::AutoLock lock(link_locks_[id % LINK_LOCKS]);
+            int* links = getLinks(id, layer);
+            pruned = candidates;
+            for (int j = 1; j <= links[0]; ++j) {
+                size_t k = 0;
+                while (k < candidates.size() && candidates[k].second != links[j]) ++k;
+                if (k == candidates.size()) {
+                    pruned.push_back(Neighbor(distance(vec, points_[links[j]]), links[j]));
+                }
+            }
+            if ((int)pruned.size() > max_links) {
+                std::sort(pruned.begin(), pruned.end());
+                selectNeighbors(pruned, max_links);
+            }
+            links[0] = (int)pruned.size();
+            for (size_t j = 0; j < pruned.size(); ++j) {
+                links[j+1] = pruned[j].second;
+            }
+        }
+
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            int node = candidates[i].second;
+            cv::AutoLock lock(link_locks_[node % LINK_LOCKS]);
+            int* links = getLinks(node, layer);
+            if (links[0] < max_links) {
+                links[++links[0]] = id;
+                continue;
+            }
+
+            const ElementType* node_vec = points_[node];
+            pruned.assign(1, Neighbor(distance(node_vec, vec), id));
+            for (int j = 1; j <= links[0]; ++j) {
+                pruned.push_back(Neighbor(distance(node_vec, points_[links[j]]), links[j]));
+            }
+            std::sort(pruned.begin(), pruned.end());
+            selectNeighbors(pruned, max_links);
+            links[0] = (int)pruned.size();
+            for (size_t j = 0; j < pruned.size(); ++j) {
+                links[j+1] = pruned[j].second;
+            }
+        }
+    }
+
+private:
+    IndexParams index_params_;
+
+    /**
+     * Number of points, including the removed ones
+     */
+    size_t size_;
+
+    size_t veclen_;
+
+    /**
+     * Array of pointers to the points, the added points are appended
+     */
+    std::vector<ElementType*> points_;
+
+    /**
+     * Max number of links of a node in the upper layers, twice as many in the bottom one
+     */
+    int neighbors_;
+
+    int ef_construction_;
+
+    /**
+     * The levels are drawn as floor(-ln(uniform(0,1))*level_factor_)
+     */
+    double level_factor_;
+    cv::RNG rng_;
+
+    /**
+     * Top layer of the graph and the node the searches start from
+     */
+    int max_level_;
+    int entry_point_;
+
+    /**
+     * Level of each node, its links in the bottom layer (2*neighbors_+1 ints per node) and in
+     * the upper layers (neighbors_+1 ints per layer above the bottom one)
+     */
+    std::vector<int> levels_;
+    std::vector<int> links0_;
+    std::vector<std::vector<int> > upper_links_;
+
+    /**
+     * Locks of the links while the graph is built, and of the entry point
+     */
+    cv::Mutex link_locks_[LINK_LOCKS];
+    cv::Mutex entry_mutex_;
+
+    std::vector<VisitedList*> visited_pool_;
+    cv::Mutex visited_mutex_;
+
+    /**
+     * The points removed from the index, they are skipped by the search
+     */
+    DynamicBitset removed_points_;
+    size_t removed_count_;
+
+    /**
+     * The distance
+     */
+    Distance distance_;
+};
+
+}
+
+#endif //OPENCV_FLANN_HNSW_INDEX_H_
@@ -0,0 +1,632 @@
+/***********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ * Copyright 2008-2009  Marius Muja (mariusm@cs.ubc.ca). All rights reserved.
+ * Copyright 2008-2009  David G. Lowe (lowe@cs.ubc.ca). All rights reserved.
+ *
+ * THE BSD LICENSE
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *************************************************************************/
+
+#ifndef OPENCV_FLANN_IVFPQ_INDEX_H_
+#define OPENCV_FLANN_IVFPQ_INDEX_H_
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include "general.h"
+#include "nn_index.h"
+#include "dist.h"
+#include "matrix.h"
+#include "result_set.h"
+#include "saving.h"
+#include "logger.h"
+#include "dynamic_bitset.h"
+
+
+namespace cvflann
+{
+
+struct IVFPQIndexParams : public IndexParams
+{
+    IVFPQIndexParams(int lists = 256, int subquantizers = 16, int iterations = 11)
+    {
+        (*this)["algorithm"] = FLANN_INDEX_IVFPQ;
+        // number of inverted lists, i.e. of centers of the coarse quantizer
+        (*this)["lists"] = lists;
+        // number of sub-vectors a point is split into, each one is encoded in a byte
+        (*this)["subquantizers"] = subquantizers;
+        // max iterations of the kmeans clusterings training the quantizers
+        (*this)["iterations"] = iterations;
+    }
+};
+
+/** Number of codewords of a sub-quantizer, the distance tables have this many entries per sub-vector */
+const int PQ_CODEWORDS = 256;
+
+/**
+ * Fills the distance table of a sub-quantizer: table[j] is the squared L2 distance between the
+ * query sub-vector and the j-th codeword. The codebook is stored transposed, as dims rows of
+ * count values.
+ */
+CV_EXPORTS void pq_l2_table(const float* query, const float* codebook_t, int dims, int count, float* table);
+
+/** Same as pq_l2_table for the L1 distance */
+CV_EXPORTS void pq_l1_table(const float* query, const float* codebook_t, int dims, int count, float* table);
+
+/**
+ * Computes the asymmetric distances of count encoded points of m bytes each:
+ * dists[i] is the sum of tables[j*PQ_CODEWORDS + codes[i*m + j]] over the sub-quantizers j.
+ */
+CV_EXPORTS void pq_scan(const float* tables, const unsigned char* codes, int m, int count, float* dists);
+
+/**
+ * Computes the distances of a query sub-vector to the codewords of a sub-quantizer. The L2 and L1
+ * distances of the float indices use the vectorized kernels above.
+ */
+template<typename Distance>
+struct PQDistanceTable
+{
+    static void compute(const Distance& distance, const float* query, const float* codebook,
+                        const float* /*codebook_t*/, int dims, int count, float* table)
+    {
+        for (int j = 0; j < count; ++j) {
+            table[j] = (float)distance(query, codebook + j*dims, dims);
+        }
+    }
+};
+
+template<>
+struct PQDistanceTable< L2<float> >
+{
+    static void compute(const L2<float>&, const float* query, const float* /*codebook*/,
+                        const float* codebook_t, int dims, int count, float* table)
+    {
+        pq_l2_table(query, codebook_t, dims, count, table);
+    }
+};
+
+template<>
+struct PQDistanceTable< L1<float> >
+{
+    static void compute(const L1<float>&, const float* query, const float* /*codebook*/,
+                        const float* codebook_t, int dims, int count, float* table)
+    {
+        pq_l1_table(query, codebook_t, dims, count, table);
+    }
+};
+
+
+/**
+ * Inverted file index with product quantization (IVF-PQ)
+ *
+ * A coarse kmeans quantizer splits the points into inverted lists. In each list a point is only
+ * stored as the codes of its residual (the point minus the center of the list): the residual is
+ * split into sub-vectors and each sub-vector is replaced by the index of the closest codeword of
+ * its sub-quantizer, a byte. The search visits the lists with the closest centers and computes
+ * the distances to the points of a list from tables of the distances between the query residual
+ * and the codewords (asymmetric distance computation), so the distances are approximate.
+ *
+ * The index does not keep the points, a point takes subquantizers bytes plus its id. The distance
+ * must be a sum over the dimensions that depends on the difference of the points, like L2 and L1.
+ * Jegou, Douze, Schmid - Product Quantization for Nearest Neighbor Search, PAMI 2011
+ */
+template <typename Distance>
+class IVFPQIndex : public NNIndex<Distance>
+{
+public:
+    typedef typename Distance::ElementType ElementType;
+    typedef typename Distance::ResultType DistanceType;
+
+    /**
+     * Index constructor
+     *
+     * Params:
+     *          inputData = dataset with the input features, only used by buildIndex()
+     *          params = parameters passed to the IVF-PQ algorithm
+     */
+    IVFPQIndex(const Matrix<ElementType>& inputData, const IndexParams& params = IVFPQIndexParams(),
+               Distance d = Distance())
+        : dataset_(inputData), index_params_(params), distance_(d)
+    {
+        size_ = dataset_.rows;
+        veclen_ = dataset_.cols;
+        removed_points_.resize(size_);
+        removed_points_.reset();
+        removed_count_ = 0;
+
+        lists_ = get_param(params,"lists",256);
+        m_ = get_param(params,"subquantizers",16);
+        iterations_ = get_param(params,"iterations",11);
+        ksub_ = 0;
+        setSubvectors();
+    }
+
+    IVFPQIndex(const IVFPQIndex&);
+    IVFPQIndex& operator=(const IVFPQIndex&);
+
+    flann_algorithm_t getType() const
+    {
+        return FLANN_INDEX_IVFPQ;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t veclen() const
+    {
+        return veclen_;
+    }
+
+    /**
+     * Computes the index memory usage
+     * Returns: memory used by the index
+     */
+    int usedMemory() const
+    {
+        size_t mem = (coarse_centers_.size() + codebooks_.size()*2)*sizeof(float);
+        for (size_t l = 0; l < list_ids_.size(); ++l) {
+            mem += list_ids_[l].capacity()*sizeof(int) + list_codes_[l].capacity();
+        }
+        return (int)mem;
+    }
+
+    /**
+     * Trains the quantizers on the dataset and encodes its points. The points added
+     * afterwards are only encoded with the trained quantizers.
+     */
+    void buildIndex()
+    {
+        if (dataset_.data == NULL && dataset_.rows > 0) {
+            throw FLANNException("The index was loaded without its dataset and cannot be rebuilt");
+        }
+        size_ = dataset_.rows;
+        removed_points_.resize(size_);
+        coarse_centers_.clear();
+        list_ids_.clear();
+        list_codes_.clear();
+
+        train(dataset_, 0);
+        encodePoints(dataset_, 0);
+    }
+
+    /**
+     * Encodes the points with the trained quantizers, the index is never rebuilt. Unlike the other
+     * indices, the points are not referenced afterwards.
+     */
+    void addPoints(const Matrix<ElementType>& points, float /*rebuild_threshold*/ = 2)
+    {
+        assert(points.cols == veclen_);
+        size_t first_id = size_;
+        size_ += points.rows;
+        removed_points_.resize(size_);
+
+        if (coarse_centers_.empty()) {
+            train(points, first_id);
+        }
+        encodePoints(points, first_id);
+    }
+
+    void removePoint(size_t id)
+    {
+        if (id >= size_) {
+            throw FLANNException("Invalid id of the point to remove");
+        }
+        if (!removed_points_.test(id)) {
+            removed_points_.set(id);
+            removed_count_++;
+        }
+    }
+
+    bool isRemoved(size_t id) const
+    {
+        return id < removed_points_.size() && removed_points_.test(id);
+    }
+
+    void saveIndex(FILE* stream)
+    {
+        save_value(stream, lists_);
+        save_value(stream, m_);
+        save_value(stream, iterations_);
+        save_value(stream, ksub_);
+
+        int centers = (int)(coarse_centers_.size()/veclen_);
+        save_value(stream, centers);
+        if (centers > 0) {
+            save_value(stream, coarse_centers_[0], (int)coarse_centers_.size());
+            save_value(stream, codebooks_[0], (int)codebooks_.size());
+        }
+        for (int l = 0; l < centers; ++l) {
+            size_t count = list_ids_[l].size();
+            save_value(stream, count);
+            if (count > 0) {
+                save_value(stream, list_ids_[l][0], count);
+                save_value(stream, list_codes_[l][0], count*m_);
+            }
+        }
+        save_removed_points(stream, removed_points_, removed_count_);
+    }
+
+    void loadIndex(FILE* stream)
+    {
+        load_value(stream, lists_);
+        load_value(stream, m_);
+        load_value(stream, iterations_);
+        load_value(stream, ksub_);
+        setSubvectors();
+
+        int centers;
+        load_value(stream, centers);
+        coarse_centers_.resize(centers*veclen_);
+        codebooks_.resize(centers > 0 ? PQ_CODEWORDS*veclen_ : 0);
+        if (centers > 0) {
+            load_value(stream, coarse_centers_[0], coarse_centers_.size());
+            load_value(stream, codebooks_[0], codebooks_.size());
+        }
+        transposeCodebooks();
+
+        list_ids_.assign(centers, std::vector<int>());
+        list_codes_.assign(centers, std::vector<unsigned char>());
+        for (int l = 0; l < centers; ++l) {
+            size_t count;
+            load_value(stream, count);
+            if (count > 0) {
+                list_ids_[l].resize(count);
+                list_codes_[l].resize(count*m_);
+                load_value(stream, list_ids_[l][0], count);
+                load_value(stream, list_codes_[l][0], count*m_);
+            }
+        }
+        removed_count_ = load_removed_points(stream, removed_points_, size_);
+
+        index_params_["algorithm"] = getType();
+        index_params_["lists"] = lists_;
+        index_params_["subquantizers"] = m_;
+        index_params_["iterations"] = iterations_;
+    }
+
+    /**
+     * Find set of nearest neighbors to vec. Their indices are stored inside
+     * the result object.
+     *
+     * Params:
+     *     result = the result object in which the indices of the nearest-neighbors are stored
+     *     vec = the vector for which to search the nearest neighbors
+     *     searchParams = parameters that influence the search algorithm (checks: the lists with
+     *                    the closest centers are visited until this many points are checked)
+     */
+    void findNeighbors(ResultSet<DistanceType>& result, const ElementType* vec, const SearchParams& searchParams)
+    {
+        int maxChecks = get_param(searchParams,"checks",32);
+        int centers = (int)list_ids_.size();
+        if (centers == 0) return;
+
+        std::vector<std::pair<DistanceType,int> > order(centers);
+        for (int l = 0; l < centers; ++l) {
+            order[l] = std::make_pair(distance_(vec, &coarse_centers_[l*veclen_], veclen_), l);
+        }
+        std::sort(order.begin(), order.end());
+
+        cv::AutoBuffer<float> buf(veclen_ + PQ_CODEWORDS*m_);
+        float* residual = buf;
+        float* tables = residual + veclen_;
+        cv::AutoBuffer<float> dists;
+
+        int checks = 0;
+        for (int l = 0; l < centers; ++l) {
+            if (maxChecks >= 0 && checks >= maxChecks && result.full()) break;
+
+            int list = order[l].second;
+            int count = (int)list_ids_[list].size();
+            if (count == 0) continue;
+
+            computeTables(vec, list, residual, tables);
+            dists.allocate(count);
+            pq_scan(tables, &list_codes_[list][0], m_, count, dists);
+
+            const int* ids = &list_ids_[list][0];
+            for (int i = 0; i < count; ++i) {
+                if (removed_count_ > 0 && removed_points_.test(ids[i])) continue;
+                result.addPoint((DistanceType)dists[i], ids[i]);
+            }
+            checks += count;
+        }
+    }
+
+    IndexParams getParameters() const
+    {
+        return index_params_;
+    }
+
+private:
+    enum
+    {
+        /**
+         * The quantizers are trained on at most this many points per center
+         */
+        TRAINING_POINTS_PER_CENTER = 64,
+        /**
+         * The points are encoded in batches of this size, to bound the temporary memory
+         */
+        ENCODE_BATCH = 1 << 16
+    };
+
+    /**
+     * Encodes a range of points: finds the closest coarse center of each point and the
+     * codewords closest to the sub-vectors of its residual.
+     */
+    class EncodeInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        EncodeInvoker(const IVFPQIndex* _index, const ElementType* const* _points, int* _labels, unsigned char* _codes)
+            : index(_index), points(_points), labels(_labels), codes(_codes)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            for (int i = range.start; i < range.end; ++i) {
+                labels[i] = index->encode(points[i], codes + (size_t)i*index->m_);
+            }
+        }
+
+    private:
+        const IVFPQIndex* index;
+        const ElementType* const* points;
+        int* labels;
+        unsigned char* codes;
+    };
+
+    /**
+     * Splits the dimensions into m_ sub-vectors of (almost) equal size.
+     */
+    void setSubvectors()
+    {
+        sub_offsets_.clear();
+        if (m_<1 || (size_t)m_>veclen_) return;
+        sub_offsets_.resize(m_+1);
+        for (int j = 0; j <= m_; ++j) {
+            sub_offsets_[j] = (int)(j*veclen_/m_);
+        }
+    }
+
+    /**
+     * Trains the coarse quantizer and the sub-quantizers of the residuals with kmeans on a
+     * sample of the points that are not removed.
+     */
+    void train(const Matrix<ElementType>& points, size_t first_id)
+    {
+        if (lists_<1) {
+            throw FLANNException("The number of lists must be at least 1");
+        }
+        if (m_<1 || (size_t)m_>veclen_) {
+            throw FLANNException("The number of subquantizers must be between 1 and the dimensionality of the data");
+        }
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < points.rows; ++i) {
+            if (removed_count_ == 0 || !removed_points_.test(first_id + i)) rows.push_back(i);
+        }
+        if (rows.empty()) return;
+
+        size_t max_samples = (size_t)std::max(lists_, PQ_CODEWORDS)*TRAINING_POINTS_PER_CENTER;
+        size_t step = (rows.size() + max_samples - 1)/max_samples;
+        int n = (int)((rows.size() + step - 1)/step);
+
+        cv::Mat samples(n, (int)veclen_, CV_32F);
+        for (int i = 0; i < n; ++i) {
+            const ElementType* row = points[rows[i*step]];
+            float* sample = samples.ptr<float>(i);
+            for (size_t d = 0; d < veclen_; ++d) sample[d] = (float)row[d];
+        }
+
+        cv::TermCriteria criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, std::max(iterations_, 1), 1e-4);
+        cv::Mat labels, centers;
+        cv::kmeans(samples, std::min(lists_, n), labels, criteria, 1, cv::KMEANS_PP_CENTERS, centers);
+        coarse_centers_.assign(centers.ptr<float>(), centers.ptr<float>() + centers.total());
+        list_ids_.assign(centers.rows, std::vector<int>());
+        list_codes_.assign(centers.rows, std::vector<unsigned char>());
+
+        for (int i = 0; i < n; ++i) {
+            float* sample = samples.ptr<float>(i);
+            const float* center = centers.ptr<float>(labels.at<int>(i));
+            for (size_t d = 0; d < veclen_; ++d) sample[d] -= center[d];
+        }
+
+        ksub_ = std::min(PQ_CODEWORDS, n);
+        codebooks_.assign(PQ_CODEWORDS*veclen_, 0.f);
+        for (int j = 0; j < m_; ++j) {
+            cv::Mat sub = samples.colRange(sub_offsets_[j], sub_offsets_[j+1]).clone();
+            cv::kmeans(sub, ksub_, labels, criteria, 1, cv::KMEANS_PP_CENTERS, centers);
+            std::copy(centers.ptr<float>(), centers.ptr<float>() + centers.total(),
+                      codebooks_.begin() + PQ_CODEWORDS*sub_offsets_[j]);
+        }
+        transposeCodebooks();
+    }
+
+    /**
+     * The table kernels read the codewords dimension by dimension.
+     */
+    void transposeCodebooks()
+    {
+        codebooks_t_.resize(codebooks_.size());
+        for (int j = 0; j < m_ && !codebooks_.empty(); ++j) {
+            int dims = sub_offsets_[j+1] - sub_offsets_[j];
+            const float* codebook = &codebooks_[PQ_CODEWORDS*sub_offsets_[j]];
+            float* codebook_t = &codebooks_t_[PQ_CODEWORDS*sub_offsets_[j]];
+            for (int k = 0; k < ksub_; ++k) {
+                for (int d = 0; d < dims; ++d) {
+                    codebook_t[d*ksub_ + k] = codebook[k*dims + d];
+                }
+            }
+        }
+    }
+
+    /**
+     * Encodes the points that are not removed and appends them to their lists.
+     */
+    void encodePoints(const Matrix<ElementType>& points, size_t first_id)
+    {
+        if (coarse_centers_.empty()) return;
+
+        std::vector<const ElementType*> batch;
+        std::vector<int> ids, labels;
+        std::vector<unsigned char> codes;
+        for (size_t start = 0; start < points.rows; start += ENCODE_BATCH) {
+            size_t end = std::min(start + (size_t)ENCODE_BATCH, points.rows);
+            batch.clear();
+            ids.clear();
+            for (size_t i = start; i < end; ++i) {
+                if (removed_count_ > 0 && removed_points_.test(first_id + i)) continue;
+                batch.push_back(points[i]);
+                ids.push_back((int)(first_id + i));
+            }
+            if (batch.empty()) continue;
+
+            labels.resize(batch.size());
+            codes.resize(batch.size()*m_);
+            cv::parallel_for_(cv::Range(0, (int)batch.size()),
+                              EncodeInvoker(this, &batch[0], &labels[0], &codes[0]));
+
+            for (size_t i = 0; i < batch.size(); ++i) {
+                list_ids_[labels[i]].push_back(ids[i]);
+                list_codes_[labels[i]].insert(list_codes_[labels[i]].end(),
+                                              codes.begin() + i*m_, codes.begin() + (i+1)*m_);
+            }
+        }
+    }
+
+    /**
+     * Returns the list of the closest coarse center and fills the codes of the residual.
+     */
+    int encode(const ElementType* vec, unsigned char* code) const
+    {
+        int centers = (int)list_ids_.size();
+        int label = 0;
+        DistanceType best_dist = distance_(vec, &coarse_centers_[0], veclen_);
+        for (int l = 1; l < centers; ++l) {
+            DistanceType dist = distance_(vec, &coarse_centers_[l*veclen_], veclen_);
+            if (dist < best_dist) {
+                best_dist = dist;
+                label = l;
+            }
+        }
+
+        cv::AutoBuffer<float> buf(veclen_ + PQ_CODEWORDS*m_);
+        float* residual = buf;
+        float* tables = residual + veclen_;
+        computeTables(vec, label, residual, tables);
+        for (int j = 0; j < m_; ++j) {
+            const float* table = tables + j*PQ_CODEWORDS;
+            code[j] = (unsigned char)(std::min_element(table, table + ksub_) - table);
+        }
+        return label;
+    }
+
+    /**
+     * Computes the residual of vec to the center of the list and the distances of its
+     * sub-vectors to the codewords, PQ_CODEWORDS entries per sub-quantizer.
+     */
+    void computeTables(const ElementType* vec, int list, float* residual, float* tables) const
+    {
+        const float* center = &coarse_centers_[list*veclen_];
+        for (size_t d = 0; d < veclen_; ++d) {
+            residual[d] = (float)vec[d] - center[d];
+        }
+        for (int j = 0; j < m_; ++j) {
+            int offset = sub_offsets_[j];
+            PQDistanceTable<Distance>::compute(distance_, residual + offset, &codebooks_[PQ_CODEWORDS*offset],
+                                               &codebooks_t_[PQ_CODEWORDS*offset], sub_offsets_[j+1] - offset,
+                                               ksub_, tables + j*PQ_CODEWORDS);
+        }
+    }
+
+private:
+    /**
+     * The dataset used by this index
+     */
+    const Matrix<ElementType> dataset_;
+
+    IndexParams index_params_;
+
+    /**
+     * Number of ids, including the removed points
+     */
+    size_t size_;
+
+    size_t veclen_;
+
+    /**
+     * Number of inverted lists requested, there are fewer of them if there are not enough points
+     */
+    int lists_;
+
+    /**
+     * Number of sub-quantizers and the first dimension of each sub-vector
+     */
+    int m_;
+    std::vector<int> sub_offsets_;
+
+    /**
+     * Number of codewords of the sub-quantizers
+     */
+    int ksub_;
+
+    int iterations_;
+
+    /**
+     * Centers of the lists, one row of veclen_ values per list
+     */
+    std::vector<float> coarse_centers_;
+
+    /**
+     * Codewords of the sub-quantizers, those of the sub-vector starting at the dimension d
+     * start at PQ_CODEWORDS*d; codebooks_t_ has the same codebooks transposed
+     */
+    std::vector<float> codebooks_;
+    std::vector<float> codebooks_t_;
+
+    /**
+     * Ids and codes (m_ bytes per point) of the points of each list
+     */
+    std::vector<std::vector<int> > list_ids_;
+    std::vector<std::vector<unsigned char> > list_codes_;
+
+    /**
+     * The points removed from the index, they are skipped by the search
+     */
+    DynamicBitset removed_points_;
+    size_t removed_count_;
+
+    /**
+     * The distance
+     */
+    Distance distance_;
+};
+
+}
+
+#endif //OPENCV_FLANN_IVFPQ_INDEX_H_
@@ -83,22 +83,22 @@ public:
      */
     KDTreeIndex(const Matrix<ElementType>& inputData, const IndexParams& params = KDTreeIndexParams(),
                 Distance d = Distance() ) :
-        dataset_(inputData), index_params_(params), distance_(d)
+        index_params_(params), distance_(d)
     {
-        size_ = dataset_.rows;
-        veclen_ = dataset_.cols;
+        size_ = inputData.rows;
+        veclen_ = inputData.cols;
 
         trees_ = get_param(index_params_,"trees",4);
         tree_roots_ = new NodePtr[trees_];
 
-        // Create a permutable array of indices to the input vectors.
-        vind_.resize(size_);
+        points_.resize(size_);
         for (size_t i = 0; i < size_; ++i) {
-            vind_[i] = int(i);
+            points_[i] = inputData[i];
         }
-
-        mean_ = new DistanceType[veclen_];
-        var_ = new DistanceType[veclen_];
+        removed_points_.resize(size_);
+        removed_points_.reset();
+        removed_count_ = 0;
+        size_at_build_ = 0;
     }
 
 
@@ -113,8 +113,6 @@ public:
         if (tree_roots_!=NULL) {
             delete[] tree_roots_;
         }
-        delete[] mean_;
-        delete[] var_;
     }
 
     /**
@@ -122,14 +120,89 @@ public:
      */
     void buildIndex()
     {
-        /* Construct the randomized trees. */
+        pool_.free();
+
+        // Create a permutable array of indices to the input vectors.
+        vind_.clear();
+        for (size_t i = 0; i < size_; ++i) {
+            if (removed_count_ == 0 || !removed_points_.test(i)) vind_.push_back(int(i));
+        }
+
+        size_at_build_ = size_;
+        if (vind_.empty()) {
+            for (int i = 0; i < trees_; i++) {
+                tree_roots_[i] = NULL;
+            }
+            return;
+        }
+
+        /* Construct the randomized trees in parallel, each one dividing its own
+           random permutation of the vectors to allow for unbiased sampling.
+           Every tree gets a random number generator of its own, seeded here. */
+        int count = int(vind_.size());
+        std::vector<int> ind((size_t)trees_*count);
+        std::vector<NodePtr*> nodes(trees_);
+        std::vector<int*> tree_ind(trees_);
+        std::vector<int> counts(trees_, count);
+        std::vector<uint64> seeds(trees_);
         for (int i = 0; i < trees_; i++) {
-            /* Randomize the order of vectors to allow for unbiased sampling. */
-            std::random_shuffle(vind_.begin(), vind_.end());
-            tree_roots_[i] = divideTree(&vind_[0], int(size_) );
+            tree_ind[i] = &ind[(size_t)i*count];
+            std::copy(vind_.begin(), vind_.end(), tree_ind[i]);
+            std::random_shuffle(tree_ind[i], tree_ind[i] + count);
+            nodes[i] = &tree_roots_[i];
+            seeds[i] = (uint64)rand_int() + 1;
+        }
+        cv::parallel_for_(cv::Range(0, trees_), DivideTreeInvoker(this, &nodes[0], &tree_ind[0], &counts[0], &seeds[0]));
+    }
+
+    /**
+     * Inserts the points into the existing trees: the leaf a new point falls into is
+     * split along the dimension in which the two points differ most.
+     */
+    void addPoints(const Matrix<ElementType>& points, float rebuild_threshold = 2)
+    {
+        assert(points.cols == veclen_);
+        size_t old_size = size_;
+        size_ += points.rows;
+        for (size_t i = 0; i < points.rows; ++i) {
+            points_.push_back(points[i]);
+        }
+        removed_points_.resize(size_);
+
+        if (rebuild_threshold > 1 && size_at_build_*rebuild_threshold < size_) {
+            buildIndex();
+            return;
+        }
+        for (size_t i = old_size; i < size_; ++i) {
+            for (int j = 0; j < trees_; ++j) {
+                if (tree_roots_[j] == NULL) {
+                    tree_roots_[j] = pool_.allocate<Node>();
+                    tree_roots_[j]->child1 = tree_roots_[j]->child2 = NULL;
+                    tree_roots_[j]->divfeat = int(i);
+                }
+                else {
+                    addPointToTree(tree_roots_[j], int(i));
+                }
+            }
         }
     }
 
+    void removePoint(size_t id)
+    {
+        if (id >= size_) {
+            throw FLANNException("Invalid id of the point to remove");
+        }
+        if (!removed_points_.test(id)) {
+            removed_points_.set(id);
+            removed_count_++;
+        }
+    }
+
+    bool isRemoved(size_t id) const
+    {
+        return id < removed_points_.size() && removed_points_.test(id);
+    }
+
 
     flann_algorithm_t getType() const
     {
@@ -143,6 +216,7 @@ public:
         for (int i=0; i<trees_; ++i) {
             save_tree(stream, tree_roots_[i]);
         }
+        save_removed_points(stream, removed_points_, removed_count_);
     }
 
 
@@ -157,9 +231,11 @@ public:
         for (int i=0; i<trees_; ++i) {
             load_tree(stream,tree_roots_[i]);
         }
+        removed_count_ = load_removed_points(stream, removed_points_, size_);
+        size_at_build_ = size_;
 
         index_params_["algorithm"] = getType();
-        index_params_["trees"] = tree_roots_;
+        index_params_["trees"] = trees_;
     }
 
     /**
@@ -184,7 +260,7 @@ public:
      */
     int usedMemory() const
     {
-        return int(pool_.usedMemory+pool_.wastedMemory+dataset_.rows*sizeof(int));  // pool memory and vind array memory
+        return int(pool_.usedMemory+pool_.wastedMemory+vind_.size()*sizeof(int));  // pool memory and vind array memory
     }
 
     /**
@@ -264,18 +340,55 @@ private:
     }
 
 
+    /**
+     * Builds the subtrees of the given vector lists in parallel. Each subtree is allocated
+     * from a pool of its own, which is handed over to pool_ once the subtree is complete,
+     * and uses a random number generator of its own, initialized with the given seed.
+     */
+    class DivideTreeInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        DivideTreeInvoker(KDTreeIndex* _index, NodePtr* const* _nodes, int* const* _ind, const int* _count,
+                          const uint64* _seeds)
+            : index(_index), nodes(_nodes), ind(_ind), count(_count), seeds(_seeds)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            for (int i = range.start; i < range.end; ++i) {
+                PooledAllocator pool;
+                cv::RNG rng(seeds[i]);
+                *nodes[i] = index->divideTree(ind[i], count[i], pool, rng);
+
+                cv::AutoLock lock(index->pool_mutex_);
+                index->pool_.merge(pool);
+            }
+        }
+
+    private:
+        KDTreeIndex* index;
+        NodePtr* const* nodes;
+        int* const* ind;
+        const int* count;
+        const uint64* seeds;
+    };
+
     /**
      * Create a tree node that subdivides the list of vecs from vind[first]
-     * to vind[last].  The routine is called recursively on each sublist.
+     * to vind[last].  The routine is called recursively on each sublist,
+     * in parallel for the large ones.
      * Place a pointer to this new tree node in the location pTree.
      *
      * Params: pTree = the new node to create
      *                  first = index of the first vector
      *                  last = index of the last vector
+     *                  pool = the allocator for the new nodes
+     *                  rng = the random number generator of this subtree
      */
-    NodePtr divideTree(int* ind, int count)
+    NodePtr divideTree(int* ind, int count, PooledAllocator& pool, cv::RNG& rng)
     {
-        NodePtr node = pool_.allocate<Node>(); // allocate memory
+        NodePtr node = pool.allocate<Node>(); // allocate memory
 
         /* If too few exemplars remain, then make this a leaf node. */
         if ( count == 1) {
@@ -286,53 +399,103 @@ private:
             int idx;
             int cutfeat;
             DistanceType cutval;
-            meanSplit(ind, count, idx, cutfeat, cutval);
+            meanSplit(ind, count, idx, cutfeat, cutval, rng);
 
             node->divfeat = cutfeat;
             node->divval = cutval;
-            node->child1 = divideTree(ind, idx);
-            node->child2 = divideTree(ind+idx, count-idx);
+            if (count >= PARALLEL_SPLIT_MIN) {
+                NodePtr* nodes[2] = { &node->child1, &node->child2 };
+                int* inds[2] = { ind, ind+idx };
+                int counts[2] = { idx, count-idx };
+                uint64 seeds[2] = { rng.next(), rng.next() };
+                cv::parallel_for_(cv::Range(0, 2), DivideTreeInvoker(this, nodes, inds, counts, seeds));
+            }
+            else {
+                node->child1 = divideTree(ind, idx, pool, rng);
+                node->child2 = divideTree(ind+idx, count-idx, pool, rng);
+            }
         }
 
         return node;
     }
 
 
+    void addPointToTree(NodePtr node, int ind)
+    {
+        ElementType* point = points_[ind];
+
+        /* Descend the same way the search does. */
+        while ((node->child1 != NULL) || (node->child2 != NULL)) {
+            node = (point[node->divfeat] < node->divval) ? node->child1 : node->child2;
+        }
+
+        ElementType* leaf_point = points_[node->divfeat];
+        int cutfeat = 0;
+        DistanceType max_span = 0;
+        for (size_t k = 0; k < veclen_; ++k) {
+            DistanceType span = (DistanceType)point[k] - (DistanceType)leaf_point[k];
+            if (span < 0) span = -span;
+            if (span > max_span) {
+                max_span = span;
+                cutfeat = int(k);
+            }
+        }
+
+        NodePtr left = pool_.allocate<Node>();
+        NodePtr right = pool_.allocate<Node>();
+        left->child1 = left->child2 = right->child1 = right->child2 = NULL;
+        bool new_is_left = point[cutfeat] < leaf_point[cutfeat];
+        left->divfeat = new_is_left ? ind : node->divfeat;
+        right->divfeat = new_is_left ? node->divfeat : ind;
+
+        node->divfeat = cutfeat;
+        node->divval = ((DistanceType)point[cutfeat] + (DistanceType)leaf_point[cutfeat])/2;
+        if (!(points_[left->divfeat][cutfeat] < node->divval)) {
+            // the two values are equal or adjacent integers: split at the larger one
+            node->divval = (DistanceType)points_[right->divfeat][cutfeat];
+        }
+        node->child1 = left;
+        node->child2 = right;
+    }
+
     /**
      * Choose which feature to use in order to subdivide this set of vectors.
      * Make a random choice among those with the highest variance, and use
      * its variance as the threshold value.
      */
-    void meanSplit(int* ind, int count, int& index, int& cutfeat, DistanceType& cutval)
+    void meanSplit(int* ind, int count, int& index, int& cutfeat, DistanceType& cutval, cv::RNG& rng)
     {
-        memset(mean_,0,veclen_*sizeof(DistanceType));
-        memset(var_,0,veclen_*sizeof(DistanceType));
+        cv::AutoBuffer<DistanceType> buf(veclen_*2);
+        DistanceType* mean = buf;
+        DistanceType* var = mean + veclen_;
+        memset(mean,0,veclen_*sizeof(DistanceType));
+        memset(var,0,veclen_*sizeof(DistanceType));
 
         /* Compute mean values.  Only the first SAMPLE_MEAN values need to be
             sampled to get a good estimate.
          */
         int cnt = std::min((int)SAMPLE_MEAN+1, count);
         for (int j = 0; j < cnt; ++j) {
-            ElementType* v = dataset_[ind[j]];
+            ElementType* v = points_[ind[j]];
             for (size_t k=0; k<veclen_; ++k) {
-                mean_[k] += v[k];
+                mean[k] += v[k];
             }
         }
         for (size_t k=0; k<veclen_; ++k) {
-            mean_[k] /= cnt;
+            mean[k] /= cnt;
         }
 
         /* Compute variances (no need to divide by count). */
         for (int j = 0; j < cnt; ++j) {
-            ElementType* v = dataset_[ind[j]];
+            ElementType* v = points_[ind[j]];
             for (size_t k=0; k<veclen_; ++k) {
-                DistanceType dist = v[k] - mean_[k];
-                var_[k] += dist * dist;
+                DistanceType dist = v[k] - mean[k];
+                var[k] += dist * dist;
             }
         }
         /* Select one of the highest variance indices at random. */
-        cutfeat = selectDivision(var_);
-        cutval = mean_[cutfeat];
+        cutfeat = selectDivision(var, rng);
+        cutval = mean[cutfeat];
 
         int lim1, lim2;
         planeSplit(ind, count, cutfeat, cutval, lim1, lim2);
@@ -352,7 +515,7 @@ private:
      * Select the top RAND_DIM largest values from v and return the index of
      * one of these selected at random.
      */
-    int selectDivision(DistanceType* v)
+    int selectDivision(DistanceType* v, cv::RNG& rng)
     {
         int num = 0;
         size_t topind[RAND_DIM];
@@ -376,7 +539,7 @@ private:
             }
         }
         /* Select a random integer in range [0,num-1], and return that index. */
-        int rnd = rand_int(num);
+        int rnd = rand_int(rng, num);
         return (int)topind[rnd];
     }
 
@@ -396,16 +559,16 @@ private:
         int left = 0;
         int right = count-1;
         for (;; ) {
-            while (left<=right && dataset_[ind[left]][cutfeat]<cutval) ++left;
-            while (left<=right && dataset_[ind[right]][cutfeat]>=cutval) --right;
+            while (left<=right && points_[ind[left]][cutfeat]<cutval) ++left;
+            while (left<=right && points_[ind[right]][cutfeat]>=cutval) --right;
             if (left>right) break;
             std::swap(ind[left], ind[right]); ++left; --right;
         }
         lim1 = left;
         right = count-1;
         for (;; ) {
-            while (left<=right && dataset_[ind[left]][cutfeat]<=cutval) ++left;
-            while (left<=right && dataset_[ind[right]][cutfeat]>cutval) --right;
+            while (left<=right && points_[ind[left]][cutfeat]<=cutval) ++left;
+            while (left<=right && points_[ind[right]][cutfeat]>cutval) --right;
             if (left>right) break;
             std::swap(ind[left], ind[right]); ++left; --right;
         }
@@ -423,7 +586,7 @@ private:
         if (trees_ > 1) {
             fprintf(stderr,"It doesn't make any sense to use more than one tree for exact search");
         }
-        if (trees_>0) {
+        if (trees_>0 && tree_roots_[0] != NULL) {
             searchLevelExact(result, vec, tree_roots_[0], 0.0, epsError);
         }
         assert(result.full());
@@ -445,7 +608,9 @@ private:
 
         /* Search once through each tree down to root. */
         for (i = 0; i < trees_; ++i) {
-            searchLevel(result, vec, tree_roots_[i], 0, checkCount, maxCheck, epsError, heap, checked);
+            if (tree_roots_[i] != NULL) {
+                searchLevel(result, vec, tree_roots_[i], 0, checkCount, maxCheck, epsError, heap, checked);
+            }
         }
 
         /* Keep searching other branches from heap until finished. */
@@ -481,9 +646,10 @@ private:
             int index = node->divfeat;
             if ( checked.test(index) || ((checkCount>=maxCheck)&& result_set.full()) ) return;
             checked.set(index);
+            if (removed_count_ > 0 && removed_points_.test(index)) return;
             checkCount++;
 
-            DistanceType dist = distance_(dataset_[index], vec, veclen_);
+            DistanceType dist = distance_(points_[index], vec, veclen_);
             result_set.addPoint(dist,index);
 
             return;
@@ -521,7 +687,8 @@ private:
         /* If this is a leaf node, then do check and return. */
         if ((node->child1 == NULL)&&(node->child2 == NULL)) {
             int index = node->divfeat;
-            DistanceType dist = distance_(dataset_[index], vec, veclen_);
+            if (removed_count_ > 0 && removed_points_.test(index)) return;
+            DistanceType dist = distance_(points_[index], vec, veclen_);
             result_set.addPoint(dist,index);
             return;
         }
@@ -568,7 +735,12 @@ private:
          * selected at random from among the top RAND_DIM dimensions with the
          * highest variance.  A value of 5 works well.
          */
-        RAND_DIM=5
+        RAND_DIM=5,
+        /**
+         * The two halves of a list of at least PARALLEL_SPLIT_MIN vectors
+         * are divided in parallel.
+         */
+        PARALLEL_SPLIT_MIN = 1 << 14
     };
 
 
@@ -583,9 +755,20 @@ private:
     std::vector<int> vind_;
 
     /**
-     * The dataset used by this index
+     * The points used by this index: the rows of the dataset followed by the added points
      */
-    const Matrix<ElementType> dataset_;
+    std::vector<ElementType*> points_;
+
+    /**
+     * The points removed from the index, they are skipped by the search
+     */
+    DynamicBitset removed_points_;
+    size_t removed_count_;
+
+    /**
+     * Number of points when the trees were built
+     */
+    size_t size_at_build_;
 
     IndexParams index_params_;
 
@@ -593,10 +776,6 @@ private:
     size_t veclen_;
 
 
-    DistanceType* mean_;
-    DistanceType* var_;
-
-
     /**
      * Array of k-d trees used to find neighbours.
      */
@@ -610,6 +789,7 @@ private:
      * number small of memory allocations.
      */
     PooledAllocator pool_;
+    cv::Mutex pool_mutex_;
 
     Distance distance_;
 
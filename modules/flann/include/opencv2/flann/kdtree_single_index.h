@@ -217,11 +217,8 @@ public:
         assert(int(indices.cols) >= knn);
         assert(int(dists.cols) >= knn);
 
-        KNNSimpleResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.init(indices[i], dists[i]);
-            findNeighbors(resultSet, queries[i], params);
-        }
+        // the queries are searched in parallel
+        cv::parallel_for_(cv::Range(0, (int)queries.rows), KnnSearchInvoker(this, queries, indices, dists, knn, params));
     }
 
     IndexParams getParameters() const
@@ -249,6 +246,35 @@ public:
 
 private:
 
+    class KnnSearchInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        KnnSearchInvoker(KDTreeSingleIndex* _index, const Matrix<ElementType>& _queries, Matrix<int>& _indices,
+                         Matrix<DistanceType>& _dists, int _knn, const SearchParams& _params)
+            : index(_index), queries(_queries), indices(_indices), dists(_dists), knn(_knn), params(_params)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            KNNSimpleResultSet<DistanceType> resultSet(knn);
+            for (int i = range.start; i < range.end; i++) {
+                resultSet.init(indices[i], dists[i]);
+                index->findNeighbors(resultSet, queries[i], params);
+            }
+        }
+
+    private:
+        KDTreeSingleIndex* index;
+        const Matrix<ElementType>& queries;
+        Matrix<int>& indices;
+        Matrix<DistanceType>& dists;
+        int knn;
+        const SearchParams& params;
+
+        KnnSearchInvoker& operator=(const KnnSearchInvoker&);
+    };
+
 
     /*--------------------- Internal Data Structures --------------------------*/
     struct Node
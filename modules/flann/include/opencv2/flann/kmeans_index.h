@@ -47,6 +47,7 @@
 #include "random.h"
 #include "saving.h"
 #include "logger.h"
+#include "dynamic_bitset.h"
 
 
 namespace cvflann
@@ -85,7 +86,7 @@ public:
 
 
 
-    typedef void (KMeansIndex::* centersAlgFunction)(int, int*, int, int*, int&);
+    typedef void (KMeansIndex::* centersAlgFunction)(int, int*, int, int*, int&, cv::RNG&);
 
     /**
      * The function used for choosing the cluster centers.
@@ -104,9 +105,9 @@ public:
      *     indices_length = length of indices vector
      *
      */
-    void chooseCentersRandom(int k, int* indices, int indices_length, int* centers, int& centers_length)
+    void chooseCentersRandom(int k, int* indices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
-        UniqueRandom r(indices_length);
+        UniqueRandom r(indices_length, rng);
 
         int index;
         for (index=0; index<k; ++index) {
@@ -123,7 +124,7 @@ public:
                 centers[index] = indices[rnd];
 
                 for (int j=0; j<index; ++j) {
-                    DistanceType sq = distance_(dataset_[centers[index]], dataset_[centers[j]], dataset_.cols);
+                    DistanceType sq = distance_(points_[centers[index]], points_[centers[j]], veclen_);
                     if (sq<1e-16) {
                         duplicate = true;
                     }
@@ -145,11 +146,11 @@ public:
      *     indices = indices in the dataset
      * Returns:
      */
-    void chooseCentersGonzales(int k, int* indices, int indices_length, int* centers, int& centers_length)
+    void chooseCentersGonzales(int k, int* indices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
         int n = indices_length;
 
-        int rnd = rand_int(n);
+        int rnd = rand_int(rng, n);
         assert(rnd >=0 && rnd < n);
 
         centers[0] = indices[rnd];
@@ -160,9 +161,9 @@ public:
             int best_index = -1;
             DistanceType best_val = 0;
             for (int j=0; j<n; ++j) {
-                DistanceType dist = distance_(dataset_[centers[0]],dataset_[indices[j]],dataset_.cols);
+                DistanceType dist = distance_(points_[centers[0]],points_[indices[j]],veclen_);
                 for (int i=1; i<index; ++i) {
-                    DistanceType tmp_dist = distance_(dataset_[centers[i]],dataset_[indices[j]],dataset_.cols);
+                    DistanceType tmp_dist = distance_(points_[centers[i]],points_[indices[j]],veclen_);
                     if (tmp_dist<dist) {
                         dist = tmp_dist;
                     }
@@ -196,7 +197,7 @@ public:
      *     indices = indices in the dataset
      * Returns:
      */
-    void chooseCentersKMeanspp(int k, int* indices, int indices_length, int* centers, int& centers_length)
+    void chooseCentersKMeanspp(int k, int* indices, int indices_length, int* centers, int& centers_length, cv::RNG& rng)
     {
         int n = indices_length;
 
@@ -204,12 +205,12 @@ public:
         DistanceType* closestDistSq = new DistanceType[n];
 
         // Choose one random center and set the closestDistSq values
-        int index = rand_int(n);
+        int index = rand_int(rng, n);
         assert(index >=0 && index < n);
         centers[0] = indices[index];
 
         for (int i = 0; i < n; i++) {
-            closestDistSq[i] = distance_(dataset_[indices[i]], dataset_[indices[index]], dataset_.cols);
+            closestDistSq[i] = distance_(points_[indices[i]], points_[indices[index]], veclen_);
             closestDistSq[i] = ensureSquareDistance<Distance>( closestDistSq[i] );
             currentPot += closestDistSq[i];
         }
@@ -228,7 +229,7 @@ public:
 
                 // Choose our center - have to be slightly careful to return a valid answer even accounting
                 // for possible rounding errors
-                double randVal = rand_double(currentPot);
+                double randVal = rand_double(rng, currentPot);
                 for (index = 0; index < n-1; index++) {
                     if (randVal <= closestDistSq[index]) break;
                     else randVal -= closestDistSq[index];
@@ -237,7 +238,7 @@ public:
                 // Compute the new potential
                 double newPot = 0;
                 for (int i = 0; i < n; i++) {
-                    DistanceType dist = distance_(dataset_[indices[i]], dataset_[indices[index]], dataset_.cols);
+                    DistanceType dist = distance_(points_[indices[i]], points_[indices[index]], veclen_);
                     newPot += std::min( ensureSquareDistance<Distance>(dist), closestDistSq[i] );
                 }
 
@@ -252,7 +253,7 @@ public:
             centers[centerCount] = indices[bestNewIndex];
             currentPot = bestNewPot;
             for (int i = 0; i < n; i++) {
-                DistanceType dist = distance_(dataset_[indices[i]], dataset_[indices[bestNewIndex]], dataset_.cols);
+                DistanceType dist = distance_(points_[indices[i]], points_[indices[bestNewIndex]], veclen_);
                 closestDistSq[i] = std::min( ensureSquareDistance<Distance>(dist), closestDistSq[i] );
             }
         }
@@ -271,23 +272,24 @@ public:
         return FLANN_INDEX_KMEANS;
     }
 
+    /**
+     * Finds the closest center of each point. The points are processed in parallel,
+     * each one only writes its own label and distance.
+     */
     class KMeansDistanceComputer : public cv::ParallelLoopBody
     {
     public:
-        KMeansDistanceComputer(Distance _distance, const Matrix<ElementType>& _dataset,
+        KMeansDistanceComputer(Distance _distance, const std::vector<ElementType*>& _points,
             const int _branching, const int* _indices, const Matrix<double>& _dcenters, const size_t _veclen,
-            int* _count, int* _belongs_to, std::vector<DistanceType>& _radiuses, bool& _converged, cv::Mutex& _mtx)
+            int* _labels, DistanceType* _sq_dists)
             : distance(_distance)
-            , dataset(_dataset)
+            , points(_points)
             , branching(_branching)
             , indices(_indices)
             , dcenters(_dcenters)
             , veclen(_veclen)
-            , count(_count)
-            , belongs_to(_belongs_to)
-            , radiuses(_radiuses)
-            , converged(_converged)
-            , mtx(_mtx)
+            , labels(_labels)
+            , sq_dists(_sq_dists)
         {
         }
 
@@ -298,41 +300,29 @@ public:
 
             for( int i = begin; i<end; ++i)
             {
-                DistanceType sq_dist = distance(dataset[indices[i]], dcenters[0], veclen);
+                DistanceType sq_dist = distance(points[indices[i]], dcenters[0], veclen);
                 int new_centroid = 0;
                 for (int j=1; j<branching; ++j) {
-                    DistanceType new_sq_dist = distance(dataset[indices[i]], dcenters[j], veclen);
+                    DistanceType new_sq_dist = distance(points[indices[i]], dcenters[j], veclen);
                     if (sq_dist>new_sq_dist) {
                         new_centroid = j;
                         sq_dist = new_sq_dist;
                     }
                 }
-                if (sq_dist > radiuses[new_centroid]) {
-                    radiuses[new_centroid] = sq_dist;
-                }
-                if (new_centroid != belongs_to[i]) {
-                    count[belongs_to[i]]--;
-                    count[new_centroid]++;
-                    belongs_to[i] = new_centroid;
-                    mtx.lock();
-                    converged = false;
-                    mtx.unlock();
-                }
+                labels[i] = new_centroid;
+                sq_dists[i] = sq_dist;
             }
         }
 
     private:
         Distance distance;
-        const Matrix<ElementType>& dataset;
+        const std::vector<ElementType*>& points;
         const int branching;
         const int* indices;
         const Matrix<double>& dcenters;
         const size_t veclen;
-        int* count;
-        int* belongs_to;
-        std::vector<DistanceType>& radiuses;
-        bool& converged;
-        cv::Mutex& mtx;
+        int* labels;
+        DistanceType* sq_dists;
         KMeansDistanceComputer& operator=( const KMeansDistanceComputer & ) { return *this; }
     };
 
@@ -345,12 +335,21 @@ public:
      */
     KMeansIndex(const Matrix<ElementType>& inputData, const IndexParams& params = KMeansIndexParams(),
                 Distance d = Distance())
-        : dataset_(inputData), index_params_(params), root_(NULL), indices_(NULL), distance_(d)
+        : index_params_(params), root_(NULL), indices_(NULL), distance_(d)
     {
         memoryCounter_ = 0;
 
-        size_ = dataset_.rows;
-        veclen_ = dataset_.cols;
+        size_ = inputData.rows;
+        veclen_ = inputData.cols;
+
+        points_.resize(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            points_[i] = inputData[i];
+        }
+        removed_points_.resize(size_);
+        removed_points_.reset();
+        removed_count_ = 0;
+        size_at_build_ = 0;
 
         branching_ = get_param(params,"branching",32);
         iterations_ = get_param(params,"iterations",11);
@@ -435,19 +434,77 @@ public:
             throw FLANNException("Branching factor must be at least 2");
         }
 
+        if (root_ != NULL) {
+            free_centers(root_);
+        }
+        pool_.free();
+        leaf_indices_.clear();
+        memoryCounter_ = 0;
+        delete[] indices_;
+
+        // the removed points are kept at the end, outside of the tree
         indices_ = new int[size_];
+        int count = 0;
         for (size_t i=0; i<size_; ++i) {
-            indices_[i] = int(i);
+            if (removed_count_ == 0 || !removed_points_.test(i)) indices_[count++] = int(i);
+        }
+        for (size_t i=0; i<size_ && removed_count_ > 0; ++i) {
+            if (removed_points_.test(i)) indices_[count++] = int(i);
         }
 
         root_ = pool_.allocate<KMeansNode>();
-        computeNodeStatistics(root_, indices_, (int)size_);
-        computeClustering(root_, indices_, (int)size_, branching_,0);
+        int indices_length = (int)(size_ - removed_count_);
+        computeNodeStatistics(root_, indices_, indices_length);
+        cv::RNG rng((uint64)rand_int() + 1);
+        computeClustering(root_, indices_, indices_length, branching_, 0, pool_, rng);
+        size_at_build_ = size_;
+    }
+
+    /**
+     * Inserts the points into the existing tree: a point goes down to the leaf with the
+     * closest centers, and a leaf that becomes larger than the branching factor is clustered.
+     */
+    void addPoints(const Matrix<ElementType>& points, float rebuild_threshold = 2)
+    {
+        assert(points.cols == veclen_);
+        size_t old_size = size_;
+        size_ += points.rows;
+        for (size_t i = 0; i < points.rows; ++i) {
+            points_.push_back(points[i]);
+        }
+        removed_points_.resize(size_);
+
+        if (root_ == NULL || (rebuild_threshold > 1 && size_at_build_*rebuild_threshold < size_)) {
+            buildIndex();
+            return;
+        }
+        for (size_t i = old_size; i < size_; ++i) {
+            addPointToTree(root_, int(i), distance_(points_[i], root_->pivot, veclen_));
+        }
+    }
+
+    void removePoint(size_t id)
+    {
+        if (id >= size_) {
+            throw FLANNException("Invalid id of the point to remove");
+        }
+        if (!removed_points_.test(id)) {
+            removed_points_.set(id);
+            removed_count_++;
+        }
+    }
+
+    bool isRemoved(size_t id) const
+    {
+        return id < removed_points_.size() && removed_points_.test(id);
     }
 
 
     void saveIndex(FILE* stream)
     {
+        if (!leaf_indices_.empty()) {
+            compactIndices();
+        }
         save_value(stream, branching_);
         save_value(stream, iterations_);
         save_value(stream, memoryCounter_);
@@ -455,6 +512,7 @@ public:
         save_value(stream, *indices_, (int)size_);
 
         save_tree(stream, root_);
+        save_removed_points(stream, removed_points_, removed_count_);
     }
 
 
@@ -474,6 +532,8 @@ public:
             free_centers(root_);
         }
         load_tree(stream, root_);
+        removed_count_ = load_removed_points(stream, removed_points_, size_);
+        size_at_build_ = size_;
 
         index_params_["algorithm"] = getType();
         index_params_["branching"] = branching_;
@@ -673,22 +733,22 @@ private:
 
         memset(mean,0,veclen_*sizeof(DistanceType));
 
-        for (size_t i=0; i<size_; ++i) {
-            ElementType* vec = dataset_[indices[i]];
+        for (int i=0; i<indices_length; ++i) {
+            ElementType* vec = points_[indices[i]];
             for (size_t j=0; j<veclen_; ++j) {
                 mean[j] += vec[j];
             }
             variance += distance_(vec, ZeroIterator<ElementType>(), veclen_);
         }
         for (size_t j=0; j<veclen_; ++j) {
-            mean[j] /= size_;
+            mean[j] /= indices_length;
         }
-        variance /= size_;
+        variance /= indices_length;
         variance -= distance_(mean, ZeroIterator<ElementType>(), veclen_);
 
         DistanceType tmp = 0;
         for (int i=0; i<indices_length; ++i) {
-            tmp = distance_(mean, dataset_[indices[i]], veclen_);
+            tmp = distance_(mean, points_[indices[i]], veclen_);
             if (tmp>radius) {
                 radius = tmp;
             }
@@ -700,6 +760,115 @@ private:
     }
 
 
+    void addPointToTree(KMeansNodePtr node, int index, DistanceType dist_to_pivot)
+    {
+        ElementType* point = points_[index];
+        if (dist_to_pivot > node->radius) {
+            node->radius = dist_to_pivot;
+        }
+        node->size++;
+
+        if (node->childs == NULL) {
+            // the leaves built by computeClustering() share indices_, so a leaf gets
+            // its own list of indices when the first point is added to it
+            std::vector<int>& leaf = leaf_indices_[node];
+            if (leaf.empty()) {
+                leaf.assign(node->indices, node->indices + node->size - 1);
+            }
+            leaf.push_back(index);
+            node->indices = &leaf[0];
+            if (node->size >= branching_) {
+                // the list is not modified after that, the children point into it
+                cv::RNG rng((uint64)rand_int() + 1);
+                computeClustering(node, node->indices, node->size, branching_, node->level, pool_, rng);
+            }
+        }
+        else {
+            int closest = 0;
+            DistanceType dist = distance_(point, node->childs[0]->pivot, veclen_);
+            for (int i = 1; i < branching_; ++i) {
+                DistanceType d = distance_(point, node->childs[i]->pivot, veclen_);
+                if (d < dist) {
+                    dist = d;
+                    closest = i;
+                }
+            }
+            addPointToTree(node->childs[closest], index, dist);
+        }
+    }
+
+    /**
+     * Gathers the indices of all the leaves into a single indices_ array again,
+     * which is the layout saveIndex() writes.
+     */
+    void compactIndices()
+    {
+        int* indices = new int[size_];
+        DynamicBitset in_tree(size_);
+        int count = 0;
+        compactLeafIndices(root_, indices, count, in_tree);
+        for (size_t i = 0; i < size_; ++i) {
+            if (!in_tree.test(i)) indices[count++] = int(i);
+        }
+        delete[] indices_;
+        indices_ = indices;
+        leaf_indices_.clear();
+    }
+
+    void compactLeafIndices(KMeansNodePtr node, int* indices, int& count, DynamicBitset& in_tree)
+    {
+        if (node->childs == NULL) {
+            for (int i = 0; i < node->size; ++i) {
+                indices[count + i] = node->indices[i];
+                in_tree.set(node->indices[i]);
+            }
+            node->indices = indices + count;
+            count += node->size;
+        }
+        else {
+            for (int i = 0; i < branching_; ++i) {
+                compactLeafIndices(node->childs[i], indices, count, in_tree);
+            }
+        }
+    }
+
+    /**
+     * Clusters the children of a node in parallel. Each subtree is allocated from a pool
+     * of its own, which is handed over to pool_ once the subtree is complete, and uses
+     * a random number generator of its own, initialized with the given seed.
+     */
+    class KMeansClusteringInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        KMeansClusteringInvoker(KMeansIndex* _index, KMeansNodePtr* _nodes, int* const* _indices,
+                                const int* _count, const uint64* _seeds, int _branching, int _level)
+            : index(_index), nodes(_nodes), indices(_indices), count(_count), seeds(_seeds),
+              branching(_branching), level(_level)
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            for (int i = range.start; i < range.end; ++i) {
+                PooledAllocator pool;
+                cv::RNG rng(seeds[i]);
+                index->computeClustering(nodes[i], indices[i], count[i], branching, level, pool, rng);
+
+                cv::AutoLock lock(index->pool_mutex_);
+                index->pool_.merge(pool);
+            }
+        }
+
+    private:
+        KMeansIndex* index;
+        KMeansNodePtr* nodes;
+        int* const* indices;
+        const int* count;
+        const uint64* seeds;
+        int branching;
+        int level;
+    };
+
     /**
      * The method responsible with actually doing the recursive hierarchical
      * clustering
@@ -708,10 +877,13 @@ private:
      *     node = the node to cluster
      *     indices = indices of the points belonging to the current node
      *     branching = the branching factor to use in the clustering
+     *     pool = the allocator for the new nodes
+     *     rng = the random number generator of this subtree
      *
      * TODO: for 1-sized clusters don't store a cluster center (it's the same as the single cluster point)
      */
-    void computeClustering(KMeansNodePtr node, int* indices, int indices_length, int branching, int level)
+    void computeClustering(KMeansNodePtr node, int* indices, int indices_length, int branching, int level,
+                           PooledAllocator& pool, cv::RNG& rng)
     {
         node->size = indices_length;
         node->level = level;
@@ -726,7 +898,7 @@ private:
         cv::AutoBuffer<int> centers_idx_buf(branching);
         int* centers_idx = (int*)centers_idx_buf;
         int centers_length;
-        (this->*chooseCenters)(branching, indices, indices_length, centers_idx, centers_length);
+        (this->*chooseCenters)(branching, indices, indices_length, centers_idx, centers_length, rng);
 
         if (centers_length<branching) {
             node->indices = indices;
@@ -739,7 +911,7 @@ private:
         cv::AutoBuffer<double> dcenters_buf(branching*veclen_);
         Matrix<double> dcenters((double*)dcenters_buf,branching,veclen_);
         for (int i=0; i<centers_length; ++i) {
-            ElementType* vec = dataset_[centers_idx[i]];
+            ElementType* vec = points_[centers_idx[i]];
             for (size_t k=0; k<veclen_; ++k) {
                 dcenters[i][k] = double(vec[k]);
             }
@@ -756,19 +928,16 @@ private:
         //	assign points to clusters
         cv::AutoBuffer<int> belongs_to_buf(indices_length);
         int* belongs_to = (int*)belongs_to_buf;
-        for (int i=0; i<indices_length; ++i) {
+        cv::AutoBuffer<int> new_centroids_buf(indices_length);
+        int* new_centroids = (int*)new_centroids_buf;
+        cv::AutoBuffer<DistanceType> sq_dists_buf(indices_length);
+        DistanceType* sq_dists = (DistanceType*)sq_dists_buf;
 
-            DistanceType sq_dist = distance_(dataset_[indices[i]], dcenters[0], veclen_);
-            belongs_to[i] = 0;
-            for (int j=1; j<branching; ++j) {
-                DistanceType new_sq_dist = distance_(dataset_[indices[i]], dcenters[j], veclen_);
-                if (sq_dist>new_sq_dist) {
-                    belongs_to[i] = j;
-                    sq_dist = new_sq_dist;
-                }
-            }
-            if (sq_dist>radiuses[belongs_to[i]]) {
-                radiuses[belongs_to[i]] = sq_dist;
+        parallel_for_(cv::Range(0, indices_length),
+                      KMeansDistanceComputer(distance_, points_, branching, indices, dcenters, veclen_, belongs_to, sq_dists));
+        for (int i=0; i<indices_length; ++i) {
+            if (sq_dists[i]>radiuses[belongs_to[i]]) {
+                radiuses[belongs_to[i]] = sq_dists[i];
             }
             count[belongs_to[i]]++;
         }
@@ -785,7 +954,7 @@ private:
                 radiuses[i] = 0;
             }
             for (int i=0; i<indices_length; ++i) {
-                ElementType* vec = dataset_[indices[i]];
+                ElementType* vec = points_[indices[i]];
                 double* center = dcenters[belongs_to[i]];
                 for (size_t k=0; k<veclen_; ++k) {
                     center[k] += vec[k];
@@ -799,9 +968,20 @@ private:
             }
 
             // reassign points to clusters
-            cv::Mutex mtx;
-            KMeansDistanceComputer invoker(distance_, dataset_, branching, indices, dcenters, veclen_, count, belongs_to, radiuses, converged, mtx);
-            parallel_for_(cv::Range(0, (int)indices_length), invoker);
+            parallel_for_(cv::Range(0, indices_length),
+                          KMeansDistanceComputer(distance_, points_, branching, indices, dcenters, veclen_, new_centroids, sq_dists));
+            for (int i=0; i<indices_length; ++i) {
+                int new_centroid = new_centroids[i];
+                if (sq_dists[i] > radiuses[new_centroid]) {
+                    radiuses[new_centroid] = sq_dists[i];
+                }
+                if (new_centroid != belongs_to[i]) {
+                    count[belongs_to[i]]--;
+                    count[new_centroid]++;
+                    belongs_to[i] = new_centroid;
+                    converged = false;
+                }
+            }
 
             for (int i=0; i<branching; ++i) {
                 // if one cluster converges to an empty cluster,
@@ -815,7 +995,7 @@ private:
                     for (int k=0; k<indices_length; ++k) {
                         if (belongs_to[k]==j) {
                             // for cluster j, we move the furthest element from the center to the empty cluster i
-                            if ( distance_(dataset_[indices[k]], dcenters[j], veclen_) == radiuses[j] ) {
+                            if ( distance_(points_[indices[k]], dcenters[j], veclen_) == radiuses[j] ) {
                                 belongs_to[k] = i;
                                 count[j]--;
                                 count[i]++;
@@ -833,15 +1013,17 @@ private:
 
         for (int i=0; i<branching; ++i) {
             centers[i] = new DistanceType[veclen_];
-            memoryCounter_ += (int)(veclen_*sizeof(DistanceType));
             for (size_t k=0; k<veclen_; ++k) {
                 centers[i][k] = (DistanceType)dcenters[i][k];
             }
         }
+        CV_XADD(&memoryCounter_, (int)(branching*veclen_*sizeof(DistanceType)));
 
 
         // compute kmeans clustering for each of the resulting clusters
-        node->childs = pool_.allocate<KMeansNodePtr>(branching);
+        node->childs = pool.allocate<KMeansNodePtr>(branching);
+        cv::AutoBuffer<int*> child_indices(branching);
+        cv::AutoBuffer<int> child_count(branching);
         int start = 0;
         int end = start;
         for (int c=0; c<branching; ++c) {
@@ -851,7 +1033,7 @@ private:
             DistanceType mean_radius =0;
             for (int i=0; i<indices_length; ++i) {
                 if (belongs_to[i]==c) {
-                    DistanceType d = distance_(dataset_[indices[i]], ZeroIterator<ElementType>(), veclen_);
+                    DistanceType d = distance_(points_[indices[i]], ZeroIterator<ElementType>(), veclen_);
                     variance += d;
                     mean_radius += sqrt(d);
                     std::swap(indices[i],indices[end]);
@@ -863,15 +1045,32 @@ private:
             mean_radius /= s;
             variance -= distance_(centers[c], ZeroIterator<ElementType>(), veclen_);
 
-            node->childs[c] = pool_.allocate<KMeansNode>();
+            node->childs[c] = pool.allocate<KMeansNode>();
             node->childs[c]->radius = radiuses[c];
             node->childs[c]->pivot = centers[c];
             node->childs[c]->variance = variance;
             node->childs[c]->mean_radius = mean_radius;
             node->childs[c]->indices = NULL;
-            computeClustering(node->childs[c],indices+start, end-start, branching, level+1);
+            child_indices[c] = indices+start;
+            child_count[c] = end-start;
             start=end;
         }
+        delete[] centers;
+
+        if (indices_length >= PARALLEL_CLUSTERING_MIN) {
+            // the clusters are independent of each other
+            cv::AutoBuffer<uint64> seeds(branching);
+            for (int c=0; c<branching; ++c) {
+                seeds[c] = rng.next();
+            }
+            cv::parallel_for_(cv::Range(0, branching),
+                              KMeansClusteringInvoker(this, node->childs, child_indices, child_count, seeds, branching, level+1));
+        }
+        else {
+            for (int c=0; c<branching; ++c) {
+                computeClustering(node->childs[c], child_indices[c], child_count[c], branching, level+1, pool, rng);
+            }
+        }
     }
 
 
@@ -914,7 +1113,8 @@ private:
             checks += node->size;
             for (int i=0; i<node->size; ++i) {
                 int index = node->indices[i];
-                DistanceType dist = distance_(dataset_[index], vec, veclen_);
+                if (removed_count_ > 0 && removed_points_.test(index)) continue;
+                DistanceType dist = distance_(points_[index], vec, veclen_);
                 result.addPoint(dist, index);
             }
         }
@@ -987,7 +1187,8 @@ private:
         if (node->childs==NULL) {
             for (int i=0; i<node->size; ++i) {
                 int index = node->indices[i];
-                DistanceType dist = distance_(dataset_[index], vec, veclen_);
+                if (removed_count_ > 0 && removed_points_.test(index)) continue;
+                DistanceType dist = distance_(points_[index], vec, veclen_);
                 result.addPoint(dist, index);
             }
         }
@@ -1119,9 +1320,25 @@ private:
     float cb_index_;
 
     /**
-     * The dataset used by this index
+     * The points used by this index: the rows of the dataset followed by the added points
+     */
+    std::vector<ElementType*> points_;
+
+    /**
+     * The points removed from the index, they are skipped by the search
+     */
+    DynamicBitset removed_points_;
+    size_t removed_count_;
+
+    /**
+     * Number of points when the tree was built
      */
-    const Matrix<ElementType> dataset_;
+    size_t size_at_build_;
+
+    /**
+     * Indices of the leaves that got points after the tree was built
+     */
+    std::map<KMeansNodePtr, std::vector<int> > leaf_indices_;
 
     /** Index parameters */
     IndexParams index_params_;
@@ -1155,11 +1372,17 @@ private:
      * Pooled memory allocator.
      */
     PooledAllocator pool_;
+    cv::Mutex pool_mutex_;
 
     /**
      * Memory occupied by the index.
      */
     int memoryCounter_;
+
+    /**
+     * The children of a node with at least PARALLEL_CLUSTERING_MIN points are clustered in parallel.
+     */
+    enum { PARALLEL_CLUSTERING_MIN = 1 << 12 };
 };
 
 }
@@ -33,6 +33,8 @@
 
 #include "general.h"
 #include "nn_index.h"
+#include "dynamic_bitset.h"
+#include "saving.h"
 
 namespace cvflann
 {
@@ -58,6 +60,9 @@ public:
                 Distance d = Distance()) :
         dataset_(inputData), index_params_(params), distance_(d)
     {
+        removed_points_.resize(dataset_.rows);
+        removed_points_.reset();
+        removed_count_ = 0;
     }
 
     LinearIndex(const LinearIndex&);
@@ -71,7 +76,7 @@ public:
 
     size_t size() const
     {
-        return dataset_.rows;
+        return dataset_.rows + added_points_.size();
     }
 
     size_t veclen() const
@@ -90,15 +95,40 @@ public:
         /* nothing to do here for linear search */
     }
 
-    void saveIndex(FILE*)
+    void addPoints(const Matrix<ElementType>& points, float /*rebuild_threshold*/ = 2)
     {
-        /* nothing to do here for linear search */
+        assert(points.cols == dataset_.cols);
+        for (size_t i = 0; i < points.rows; ++i) {
+            added_points_.push_back(points[i]);
+        }
+        removed_points_.resize(size());
     }
 
+    void removePoint(size_t id)
+    {
+        if (id >= size()) {
+            throw FLANNException("Invalid id of the point to remove");
+        }
+        if (!removed_points_.test(id)) {
+            removed_points_.set(id);
+            removed_count_++;
+        }
+    }
 
-    void loadIndex(FILE*)
+    bool isRemoved(size_t id) const
     {
-        /* nothing to do here for linear search */
+        return id < removed_points_.size() && removed_points_.test(id);
+    }
+
+    void saveIndex(FILE* stream)
+    {
+        save_removed_points(stream, removed_points_, removed_count_);
+    }
+
+
+    void loadIndex(FILE* stream)
+    {
+        removed_count_ = load_removed_points(stream, removed_points_, size());
 
         index_params_["algorithm"] = getType();
     }
@@ -106,10 +136,17 @@ public:
     void findNeighbors(ResultSet<DistanceType>& resultSet, const ElementType* vec, const SearchParams& /*searchParams*/)
     {
         ElementType* data = dataset_.data;
-        for (size_t i = 0; i < dataset_.rows; ++i, data += dataset_.cols) {
+        for (size_t i = 0; i < dataset_.rows; ++i, data += dataset_.stride) {
+            if (removed_count_ > 0 && removed_points_.test(i)) continue;
             DistanceType dist = distance_(data, vec, dataset_.cols);
             resultSet.addPoint(dist, (int)i);
         }
+        for (size_t i = 0; i < added_points_.size(); ++i) {
+            size_t id = dataset_.rows + i;
+            if (removed_count_ > 0 && removed_points_.test(id)) continue;
+            DistanceType dist = distance_(added_points_[i], vec, dataset_.cols);
+            resultSet.addPoint(dist, (int)id);
+        }
     }
 
     IndexParams getParameters() const
@@ -120,6 +157,11 @@ public:
 private:
     /** The dataset */
     const Matrix<ElementType> dataset_;
+    /** Points added after the index was created */
+    std::vector<ElementType*> added_points_;
+    /** The points removed from the index, they are skipped by the search */
+    DynamicBitset removed_points_;
+    size_t removed_count_;
     /** Index parameters */
     IndexParams index_params_;
     /** Index distance */
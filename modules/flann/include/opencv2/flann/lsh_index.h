@@ -50,6 +50,7 @@
 #include "allocator.h"
 #include "random.h"
 #include "saving.h"
+#include "dynamic_bitset.h"
 
 namespace cvflann
 {
@@ -98,6 +99,7 @@ public:
 
         feature_size_ = (unsigned)dataset_.cols;
         fill_xor_mask(0, key_size_, multi_probe_level_, xor_masks_);
+        setDataset(dataset_);
     }
 
 
@@ -116,9 +118,48 @@ public:
 
             // Add the features to the table
             table.add(dataset_);
+            for (size_t j = dataset_.rows; j < points_.size(); ++j) {
+                table.add((unsigned int)j, points_[j]);
+            }
         }
     }
 
+    /**
+     * Hashes the points into the existing tables. The tables do not degrade
+     * with the insertions, so rebuild_threshold is not used.
+     */
+    void addPoints(const Matrix<ElementType>& points, float /*rebuild_threshold*/ = 2)
+    {
+        assert(points.cols == feature_size_);
+        size_t old_size = points_.size();
+        for (size_t i = 0; i < points.rows; ++i) {
+            points_.push_back(points[i]);
+        }
+        removed_points_.resize(points_.size());
+
+        for (size_t i = 0; i < tables_.size(); ++i) {
+            for (size_t j = old_size; j < points_.size(); ++j) {
+                tables_[i].add((unsigned int)j, points_[j]);
+            }
+        }
+    }
+
+    void removePoint(size_t id)
+    {
+        if (id >= points_.size()) {
+            throw FLANNException("Invalid id of the point to remove");
+        }
+        if (!removed_points_.test(id)) {
+            removed_points_.set(id);
+            removed_count_++;
+        }
+    }
+
+    bool isRemoved(size_t id) const
+    {
+        return id < removed_points_.size() && removed_points_.test(id);
+    }
+
     flann_algorithm_t getType() const
     {
         return FLANN_INDEX_LSH;
@@ -130,7 +171,14 @@ public:
         save_value(stream,table_number_);
         save_value(stream,key_size_);
         save_value(stream,multi_probe_level_);
-        save_value(stream, dataset_);
+
+        // the added points are saved together with the dataset
+        Matrix<ElementType> points((ElementType*)NULL, points_.size(), feature_size_);
+        fwrite(&points, sizeof(points), 1, stream);
+        for (size_t i = 0; i < points_.size(); ++i) {
+            fwrite(points_[i], sizeof(ElementType), feature_size_, stream);
+        }
+        save_removed_points(stream, removed_points_, removed_count_);
     }
 
     void loadIndex(FILE* stream)
@@ -139,6 +187,11 @@ public:
         load_value(stream, key_size_);
         load_value(stream, multi_probe_level_);
         load_value(stream, dataset_);
+        setDataset(dataset_);
+        // the masks were computed from the constructor parameters, not the loaded ones
+        xor_masks_.clear();
+        fill_xor_mask(0, key_size_, multi_probe_level_, xor_masks_);
+        removed_count_ = load_removed_points(stream, removed_points_, points_.size());
         // Building the index is so fast we can afford not storing it
         buildIndex();
 
@@ -153,7 +206,7 @@ public:
      */
     size_t size() const
     {
-        return dataset_.rows;
+        return points_.size();
     }
 
     /**
@@ -170,7 +223,7 @@ public:
      */
     int usedMemory() const
     {
-        return (int)(dataset_.rows * sizeof(int));
+        return (int)(points_.size() * sizeof(int));
     }
 
 
@@ -179,35 +232,6 @@ public:
         return index_params_;
     }
 
-    /**
-     * \brief Perform k-nearest neighbor search
-     * \param[in] queries The query points for which to find the nearest neighbors
-     * \param[out] indices The indices of the nearest neighbors found
-     * \param[out] dists Distances to the nearest neighbors found
-     * \param[in] knn Number of nearest neighbors to return
-     * \param[in] params Search parameters
-     */
-    virtual void knnSearch(const Matrix<ElementType>& queries, Matrix<int>& indices, Matrix<DistanceType>& dists, int knn, const SearchParams& params)
-    {
-        assert(queries.cols == veclen());
-        assert(indices.rows >= queries.rows);
-        assert(dists.rows >= queries.rows);
-        assert(int(indices.cols) >= knn);
-        assert(int(dists.cols) >= knn);
-
-
-        KNNUniqueResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.clear();
-            std::fill_n(indices[i], knn, -1);
-            std::fill_n(dists[i], knn, std::numeric_limits<DistanceType>::max());
-            findNeighbors(resultSet, queries[i], params);
-            if (get_param(params,"sorted",true)) resultSet.sortAndCopy(indices[i], dists[i], knn);
-            else resultSet.copy(indices[i], dists[i], knn);
-        }
-    }
-
-
     /**
      * Find set of nearest neighbors to vec. Their indices are stored inside
      * the result object.
@@ -223,6 +247,17 @@ public:
     }
 
 private:
+    void setDataset(const Matrix<ElementType>& dataset)
+    {
+        points_.resize(dataset.rows);
+        for (size_t i = 0; i < dataset.rows; ++i) {
+            points_[i] = dataset[i];
+        }
+        removed_points_.resize(points_.size());
+        removed_points_.reset();
+        removed_count_ = 0;
+    }
+
     /** Defines the comparator on score and index
      */
     typedef std::pair<float, unsigned int> ScoreIndexPair;
@@ -285,7 +320,8 @@ private:
 
                     // Process the rest of the candidates
                     for (; training_index < last_training_index; ++training_index) {
-                        hamming_distance = distance_(vec, dataset_[*training_index], dataset_.cols);
+                        if (removed_count_ > 0 && removed_points_.test(*training_index)) continue;
+                        hamming_distance = distance_(vec, points_[*training_index], feature_size_);
 
                         if (hamming_distance < worst_score) {
                             // Insert the new element
@@ -324,7 +360,8 @@ private:
                     // Process the rest of the candidates
                     for (; training_index < last_training_index; ++training_index) {
                         // Compute the Hamming distance
-                        hamming_distance = distance_(vec, dataset_[*training_index], dataset_.cols);
+                        if (removed_count_ > 0 && removed_points_.test(*training_index)) continue;
+                        hamming_distance = distance_(vec, points_[*training_index], feature_size_);
                         if (hamming_distance < radius) score_index_heap.push_back(ScoreIndexPair(hamming_distance, training_index));
                     }
                 }
@@ -357,7 +394,8 @@ private:
                 // Process the rest of the candidates
                 for (; training_index < last_training_index; ++training_index) {
                     // Compute the Hamming distance
-                    hamming_distance = distance_(vec, dataset_[*training_index], (int)dataset_.cols);
+                    if (removed_count_ > 0 && removed_points_.test(*training_index)) continue;
+                    hamming_distance = distance_(vec, points_[*training_index], (int)feature_size_);
                     result.addPoint(hamming_distance, *training_index);
                 }
             }
@@ -370,6 +408,13 @@ private:
     /** The data the LSH tables where built from */
     Matrix<ElementType> dataset_;
 
+    /** The rows of the dataset followed by the added points */
+    std::vector<ElementType*> points_;
+
+    /** The points removed from the index, they are skipped by the search */
+    DynamicBitset removed_points_;
+    size_t removed_count_;
+
     /** The size of the features (as ElementType[]) */
     unsigned int feature_size_;
 
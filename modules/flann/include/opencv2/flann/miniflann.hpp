@@ -115,6 +115,16 @@ struct CV_EXPORTS LshIndexParams : public IndexParams
     LshIndexParams(int table_number, int key_size, int multi_probe_level);
 };
 
+struct CV_EXPORTS IVFPQIndexParams : public IndexParams
+{
+    IVFPQIndexParams(int lists = 256, int subquantizers = 16, int iterations = 11);
+};
+
+struct CV_EXPORTS HNSWIndexParams : public IndexParams
+{
+    HNSWIndexParams(int neighbors = 16, int ef_construction = 100);
+};
+
 struct CV_EXPORTS SavedIndexParams : public IndexParams
 {
     SavedIndexParams(const String& filename);
@@ -140,8 +150,41 @@ public:
                              OutputArray dists, double radius, int maxResults,
                              const SearchParams& params=SearchParams());
 
+    /** Adds the rows of features to the index without rebuilding it. Supported by the KDTree,
+        KMeans, Composite, LSH, IVF-PQ, HNSW and Linear indices. As with build(), the data is not
+        copied and must stay valid while the index is used. The new points get the indices following
+        the existing ones. The index is rebuilt from scratch once it has grown rebuildThreshold times
+        since it was last built. The IVF-PQ index only stores the codes of the new points: it does
+        not keep the data and is never rebuilt. The HNSW index inserts the new points into its graph
+        and is never rebuilt either. With rebuildInBackground the KDTree, KMeans and Composite
+        indices are not rebuilt in the call, rebuildAsync() is started instead. */
+    CV_WRAP virtual void addPoints(InputArray features, float rebuildThreshold=2.f,
+                                   bool rebuildInBackground=false);
+    /** Removes a point from the index; the indices of the other points do not change. */
+    CV_WRAP virtual void removePoint(int idx);
+
     CV_WRAP virtual void save(const String& filename) const;
+    /** Loads an index saved for the features. An IVF-PQ index does not use the features, they can be
+        empty. */
     CV_WRAP virtual bool load(InputArray features, const String& filename);
+    /** Saves the index together with its points, the added ones included, into a binary
+        FileStorage file (FileStorage::FORMAT_BINARY). */
+    CV_WRAP virtual void saveWithFeatures(const String& filename) const;
+    /** Loads an index saved with saveWithFeatures(). The file is mapped into memory
+        (FileStorage::MMAP): the points are neither parsed nor copied, the index searches them in
+        the mapping, and the processes loading the same file share its pages. The points are
+        returned in features; the mapping stays alive while the index or features use it. */
+    CV_WRAP virtual bool loadWithFeatures(const String& filename, OutputArray features=noArray());
+
+    /** Starts rebuilding the index from all its points in a background thread. The points are
+        copied into one matrix owned by the new index. Searches, addPoints() and removePoint() keep
+        using the current index meanwhile; the new index replaces it, with the points added and
+        removed since then, in the first addPoints(), removePoint() or waitRebuild() call after it
+        is ready. Does nothing if a rebuild is already running. */
+    CV_WRAP virtual void rebuildAsync();
+    /** Waits for the rebuild started by rebuildAsync() and swaps the new index in. Returns false if
+        no rebuild was running. */
+    CV_WRAP virtual bool waitRebuild();
     CV_WRAP virtual void release();
     CV_WRAP cvflann::flann_distance_t getDistance() const;
     CV_WRAP cvflann::flann_algorithm_t getAlgorithm() const;
@@ -151,6 +194,13 @@ protected:
     cvflann::flann_algorithm_t algo;
     int featureType;
     void* index;
+    Mat data;                   //!< the points the index was built on or loaded with
+    std::vector<Mat> addedData; //!< the points passed to addPoints() since
+    void* rebuild;              //!< the rebuild started by rebuildAsync(), 0 if none
+
+    void saveTo(FILE* fout) const;
+    bool loadFrom(const Mat& features, FILE* fin);
+    bool finishRebuild(bool wait);
 };
 
 } } // namespace cv::flann
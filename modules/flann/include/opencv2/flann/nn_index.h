@@ -57,6 +57,40 @@ public:
      */
     virtual void buildIndex() = 0;
 
+    /**
+     * \brief Incrementally adds points to the index
+     * \param points The points to add. As with the dataset the index was created for, the data
+     *        is not copied and must stay valid while the index is used. The points get the ids
+     *        size(), size()+1, ...
+     * \param rebuild_threshold The index is rebuilt from scratch once it has grown by this factor
+     *        since it was last built; the incremental insertions degrade the search quality slowly.
+     */
+    virtual void addPoints(const Matrix<ElementType>& points, float rebuild_threshold = 2)
+    {
+        (void)points;
+        (void)rebuild_threshold;
+        throw FLANNException("The index does not support adding points");
+    }
+
+    /**
+     * \brief Removes a point from the index. The ids of the other points do not change.
+     * \param id The id of the point to remove
+     */
+    virtual void removePoint(size_t id)
+    {
+        (void)id;
+        throw FLANNException("The index does not support removing points");
+    }
+
+    /**
+     * \returns Whether the point was removed with removePoint()
+     */
+    virtual bool isRemoved(size_t id) const
+    {
+        (void)id;
+        return false;
+    }
+
     /**
      * \brief Perform k-nearest neighbor search
      * \param[in] queries The query points for which to find the nearest neighbors
@@ -73,59 +107,36 @@ public:
         assert(int(indices.cols) >= knn);
         assert(int(dists.cols) >= knn);
 
-#if 0
-        KNNResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.init(indices[i], dists[i]);
-            findNeighbors(resultSet, queries[i], params);
-        }
-#else
-        KNNUniqueResultSet<DistanceType> resultSet(knn);
-        for (size_t i = 0; i < queries.rows; i++) {
-            resultSet.clear();
-            findNeighbors(resultSet, queries[i], params);
-            if (get_param(params,"sorted",true)) resultSet.sortAndCopy(indices[i], dists[i], knn);
-            else resultSet.copy(indices[i], dists[i], knn);
-        }
-#endif
+        // the queries are searched in parallel, findNeighbors() keeps its state on the stack
+        cv::parallel_for_(cv::Range(0, (int)queries.rows),
+                          SearchInvoker(this, queries, indices, dists, knn, -1.f, params, NULL));
     }
 
     /**
      * \brief Perform radius search
-     * \param[in] query The query point
-     * \param[out] indices The indinces of the neighbors found within the given radius
-     * \param[out] dists The distances to the nearest neighbors found
+     * \param[in] query The query points
+     * \param[out] indices The indinces of the neighbors found within the given radius,
+     *             one row per query
+     * \param[out] dists The distances to the nearest neighbors found, one row per query
      * \param[in] radius The radius used for search
      * \param[in] params Search parameters
-     * \returns Number of neighbors found
+     * \returns Number of neighbors found, summed over the queries
      */
     virtual int radiusSearch(const Matrix<ElementType>& query, Matrix<int>& indices, Matrix<DistanceType>& dists, float radius, const SearchParams& params)
     {
-        if (query.rows != 1) {
-            fprintf(stderr, "I can only search one feature at a time for range search\n");
-            return -1;
-        }
         assert(query.cols == veclen());
         assert(indices.cols == dists.cols);
+        assert(query.rows == 1 || (indices.rows >= query.rows && dists.rows >= query.rows));
 
-        int n = 0;
-        int* indices_ptr = NULL;
-        DistanceType* dists_ptr = NULL;
-        if (indices.cols > 0) {
-            n = (int)indices.cols;
-            indices_ptr = indices[0];
-            dists_ptr = dists[0];
-        }
+        std::vector<int> counts(query.rows);
+        cv::parallel_for_(cv::Range(0, (int)query.rows),
+                          SearchInvoker(this, query, indices, dists, (int)indices.cols, radius, params, &counts[0]));
 
-        RadiusUniqueResultSet<DistanceType> resultSet((DistanceType)radius);
-        resultSet.clear();
-        findNeighbors(resultSet, query[0], params);
-        if (n>0) {
-            if (get_param(params,"sorted",true)) resultSet.sortAndCopy(indices_ptr, dists_ptr, n);
-            else resultSet.copy(indices_ptr, dists_ptr, n);
+        int count = 0;
+        for (size_t i = 0; i < query.rows; i++) {
+            count += counts[i];
         }
-
-        return (int)resultSet.size();
+        return count;
     }
 
     /**
@@ -170,6 +181,56 @@ public:
      * \brief Method that searches for nearest-neighbours
      */
     virtual void findNeighbors(ResultSet<DistanceType>& result, const ElementType* vec, const SearchParams& searchParams) = 0;
+
+private:
+    /**
+     * Searches a range of queries with a result set of its own: the k nearest neighbours when
+     * counts is NULL, the neighbours within the radius otherwise. The rows of the queries
+     * with fewer neighbours than the row size are padded with -1.
+     */
+    class SearchInvoker : public cv::ParallelLoopBody
+    {
+    public:
+        SearchInvoker(NNIndex* _index, const Matrix<ElementType>& _queries, Matrix<int>& _indices,
+                      Matrix<DistanceType>& _dists, int _n, float _radius, const SearchParams& _params, int* _counts)
+            : index(_index), queries(_queries), indices(_indices), dists(_dists), n(_n), radius(_radius),
+              params(_params), counts(_counts), sorted(get_param(_params,"sorted",true))
+        {
+        }
+
+        void operator()(const cv::Range& range) const
+        {
+            KNNUniqueResultSet<DistanceType> knnResultSet(counts ? 1 : n);
+            RadiusUniqueResultSet<DistanceType> radiusResultSet((DistanceType)radius);
+            UniqueResultSet<DistanceType>& resultSet = counts ? (UniqueResultSet<DistanceType>&)radiusResultSet
+                                                              : (UniqueResultSet<DistanceType>&)knnResultSet;
+
+            for (int i = range.start; i < range.end; i++) {
+                resultSet.clear();
+                index->findNeighbors(resultSet, queries[i], params);
+                if (counts) counts[i] = (int)resultSet.size();
+                if (n > 0) {
+                    std::fill_n(indices[i], n, -1);
+                    std::fill_n(dists[i], n, std::numeric_limits<DistanceType>::max());
+                    if (sorted) resultSet.sortAndCopy(indices[i], dists[i], n);
+                    else resultSet.copy(indices[i], dists[i], n);
+                }
+            }
+        }
+
+    private:
+        NNIndex* index;
+        const Matrix<ElementType>& queries;
+        Matrix<int>& indices;
+        Matrix<DistanceType>& dists;
+        int n;
+        float radius;
+        const SearchParams& params;
+        int* counts;
+        bool sorted;
+
+        SearchInvoker& operator=(const SearchInvoker&);
+    };
 };
 
 }
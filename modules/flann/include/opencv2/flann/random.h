@@ -74,6 +74,32 @@ inline int rand_int(int high = RAND_MAX, int low = 0)
     return low + (int) ( double(high-low) * (std::rand() / (RAND_MAX + 1.0)));
 }
 
+/**
+ * Generates a random double value with the given generator. The parallel index builds
+ * give each tree (and subtree) a generator of its own, seeded from its parent's one,
+ * so the result does not depend on the order the threads run in.
+ * @param rng Random number generator
+ * @param high Upper limit
+ * @param low Lower limit
+ * @return Random double value
+ */
+inline double rand_double(cv::RNG& rng, double high = 1.0, double low = 0)
+{
+    return low + (high-low) * (double)rng;
+}
+
+/**
+ * Generates a random integer value with the given generator.
+ * @param rng Random number generator
+ * @param high Upper limit
+ * @param low Lower limit
+ * @return Random integer value
+ */
+inline int rand_int(cv::RNG& rng, int high, int low = 0)
+{
+    return low + (int) ( double(high-low) * (double)rng );
+}
+
 /**
  * Random number generator that returns a distinct number from
  * the [0,n) interval each time.
@@ -95,6 +121,16 @@ public:
         init(n);
     }
 
+    /**
+     * Constructor, the interval is shuffled with the given generator.
+     * @param n Size of the interval from which to generate
+     * @param rng Random number generator
+     */
+    UniqueRandom(int n, cv::RNG& rng)
+    {
+        init(n, rng);
+    }
+
     /**
      * Initializes the number generator.
      * @param n the size of the interval from which to generate random numbers.
@@ -112,6 +148,21 @@ public:
         counter_ = 0;
     }
 
+    /**
+     * Initializes the number generator, shuffling the interval with the given generator.
+     * @param n the size of the interval from which to generate random numbers.
+     * @param rng Random number generator
+     */
+    void init(int n, cv::RNG& rng)
+    {
+        vals_.resize(n);
+        size_ = n;
+        for (int i = 0; i < size_; ++i) vals_[i] = i;
+        for (int i = size_ - 1; i > 0; --i) std::swap(vals_[i], vals_[rng.uniform(0, i + 1)]);
+
+        counter_ = 0;
+    }
+
     /**
      * Return a distinct random integer in greater or equal to 0 and less
      * than 'n' on each call. It should be called maximum 'n' times.
@@ -34,12 +34,18 @@
 
 #include "general.h"
 #include "nn_index.h"
+#include "dynamic_bitset.h"
 
 #ifdef FLANN_SIGNATURE_
 #undef FLANN_SIGNATURE_
 #endif
 #define FLANN_SIGNATURE_ "FLANN_INDEX"
 
+#ifdef FLANN_REMOVED_POINTS_TAG_
+#undef FLANN_REMOVED_POINTS_TAG_
+#endif
+#define FLANN_REMOVED_POINTS_TAG_ 0x4d455246u /* "FREM" */
+
 namespace cvflann
 {
 
@@ -182,6 +188,54 @@ void load_value(FILE* stream, std::vector<T>& value)
     }
 }
 
+
+/**
+ * Saves the ids of the points removed from an index. The block starts with a tag,
+ * so that the indices saved before the point removal was supported can still be loaded.
+ */
+inline void save_removed_points(FILE* stream, const DynamicBitset& removed, size_t removed_count)
+{
+    const unsigned int tag = FLANN_REMOVED_POINTS_TAG_;
+    fwrite(&tag, sizeof(tag), 1, stream);
+    fwrite(&removed_count, sizeof(removed_count), 1, stream);
+    for (size_t i = 0, n = 0; n < removed_count && i < removed.size(); ++i) {
+        if (removed.test(i)) {
+            int id = (int)i;
+            fwrite(&id, sizeof(id), 1, stream);
+            ++n;
+        }
+    }
+}
+
+/**
+ * Loads the ids written by save_removed_points into a bitset of the given size.
+ * Returns the number of removed points; if there is no such block at the current
+ * position of the stream, the stream is left unchanged and 0 is returned.
+ */
+inline size_t load_removed_points(FILE* stream, DynamicBitset& removed, size_t size)
+{
+    removed.resize(size);
+    removed.reset();
+
+    long pos = ftell(stream);
+    unsigned int tag = 0;
+    if (fread(&tag, sizeof(tag), 1, stream) != 1 || tag != FLANN_REMOVED_POINTS_TAG_) {
+        fseek(stream, pos, SEEK_SET);
+        return 0;
+    }
+    size_t removed_count = 0;
+    load_value(stream, removed_count);
+    for (size_t n = 0; n < removed_count; ++n) {
+        int id = 0;
+        load_value(stream, id);
+        if (id < 0 || (size_t)id >= size) {
+            throw FLANNException("Invalid index file, wrong id of a removed point");
+        }
+        removed.set(id);
+    }
+    return removed_count;
+}
+
 }
 
 #endif /* OPENCV_FLANN_SAVING_H_ */
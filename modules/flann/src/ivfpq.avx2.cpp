@@ -0,0 +1,157 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+#include "opencv2/hal/intrin.hpp"
+
+using namespace cv;
+
+/*
+ AVX2 versions of the product quantization kernels from ivfpq.cpp. The scan looks up
+ the tables of 8 sub-quantizers at once with gathers.
+ */
+
+namespace cvflann { namespace opt_AVX2 {
+
+void pq_l2_table(const float* query, const float* codebook_t, int dims, int count, float* table)
+{
+    int j = 0;
+    for( ; j <= count - 16; j += 16 )
+    {
+        v_float32x8 s0 = v256_setzero_f32(), s1 = v256_setzero_f32();
+        const float* c = codebook_t + j;
+        for( int d = 0; d < dims; d++, c += count )
+        {
+            v_float32x8 q = v256_setall_f32(query[d]);
+            v_float32x8 t0 = q - v256_load(c), t1 = q - v256_load(c + 8);
+            s0 = v_muladd(t0, t0, s0);
+            s1 = v_muladd(t1, t1, s1);
+        }
+        v_store(table + j, s0);
+        v_store(table + j + 8, s1);
+    }
+    for( ; j < count; j++ )
+    {
+        float s = 0.f;
+        for( int d = 0; d < dims; d++ )
+        {
+            float t = query[d] - codebook_t[d*count + j];
+            s += t*t;
+        }
+        table[j] = s;
+    }
+}
+
+void pq_l1_table(const float* query, const float* codebook_t, int dims, int count, float* table)
+{
+    int j = 0;
+    for( ; j <= count - 16; j += 16 )
+    {
+        v_float32x8 s0 = v256_setzero_f32(), s1 = v256_setzero_f32();
+        const float* c = codebook_t + j;
+        for( int d = 0; d < dims; d++, c += count )
+        {
+            v_float32x8 q = v256_setall_f32(query[d]);
+            s0 += v_absdiff(q, v256_load(c));
+            s1 += v_absdiff(q, v256_load(c + 8));
+        }
+        v_store(table + j, s0);
+        v_store(table + j + 8, s1);
+    }
+    for( ; j < count; j++ )
+    {
+        float s = 0.f;
+        for( int d = 0; d < dims; d++ )
+            s += std::abs(query[d] - codebook_t[d*count + j]);
+        table[j] = s;
+    }
+}
+
+// Sums the table entries of 8 sub-quantizers at a time: the codes are widened to 32 bits
+// and offset to their tables, the entries are gathered.
+static inline __m256 scanCode(const float* tables, const unsigned char* code, int m8, __m256i offsets)
+{
+    __m256 s = _mm256_setzero_ps();
+    for( int j = 0; j < m8; j += 8 )
+    {
+        __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(code + j)));
+        s = _mm256_add_ps(s, _mm256_i32gather_ps(tables + j*PQ_CODEWORDS, _mm256_add_epi32(idx, offsets), 4));
+    }
+    return s;
+}
+
+void pq_scan(const float* tables, const unsigned char* codes, int m, int count, float* dists)
+{
+    const __m256i offsets = _mm256_setr_epi32(0, PQ_CODEWORDS, PQ_CODEWORDS*2, PQ_CODEWORDS*3,
+                                              PQ_CODEWORDS*4, PQ_CODEWORDS*5, PQ_CODEWORDS*6, PQ_CODEWORDS*7);
+    const int m8 = m & -8;
+    int i = 0;
+
+    // 4 points at once, their 8 partial sums are reduced together
+    for( ; i <= count - 4; i += 4, codes += m*4 )
+    {
+        __m256 s0 = scanCode(tables, codes, m8, offsets);
+        __m256 s1 = scanCode(tables, codes + m, m8, offsets);
+        __m256 s2 = scanCode(tables, codes + m*2, m8, offsets);
+        __m256 s3 = scanCode(tables, codes + m*3, m8, offsets);
+        __m256 h = _mm256_hadd_ps(_mm256_hadd_ps(s0, s1), _mm256_hadd_ps(s2, s3));
+        _mm_storeu_ps(dists + i, _mm_add_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1)));
+
+        for( int j = m8; j < m; j++ )
+        {
+            const float* t = tables + j*PQ_CODEWORDS;
+            dists[i] += t[codes[j]];
+            dists[i+1] += t[codes[j + m]];
+            dists[i+2] += t[codes[j + m*2]];
+            dists[i+3] += t[codes[j + m*3]];
+        }
+    }
+    for( ; i < count; i++, codes += m )
+    {
+        float s = 0.f;
+        for( int j = 0; j < m; j++ )
+            s += tables[j*PQ_CODEWORDS + codes[j]];
+        dists[i] = s;
+    }
+}
+
+}} // cvflann::opt_AVX2
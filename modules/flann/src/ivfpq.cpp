@@ -0,0 +1,166 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+#include "opencv2/hal/intrin.hpp"
+
+using namespace cv;
+
+/*
+ Kernels of the product quantization in IVFPQIndex: the tables of the distances between
+ the query sub-vectors and the codewords, and the sums of the table entries selected by
+ the codes of the points.
+ */
+
+namespace cvflann
+{
+
+void pq_l2_table(const float* query, const float* codebook_t, int dims, int count, float* table)
+{
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::pq_l2_table(query, codebook_t, dims, count, table);
+        return;
+    }
+#endif
+
+    int j = 0;
+#if CV_SIMD128
+    for( ; j <= count - 8; j += 8 )
+    {
+        v_float32x4 s0 = v_setzero_f32(), s1 = v_setzero_f32();
+        const float* c = codebook_t + j;
+        for( int d = 0; d < dims; d++, c += count )
+        {
+            v_float32x4 q = v_setall_f32(query[d]);
+            v_float32x4 t0 = q - v_load(c), t1 = q - v_load(c + 4);
+            s0 = v_muladd(t0, t0, s0);
+            s1 = v_muladd(t1, t1, s1);
+        }
+        v_store(table + j, s0);
+        v_store(table + j + 4, s1);
+    }
+#endif
+    for( ; j < count; j++ )
+    {
+        float s = 0.f;
+        for( int d = 0; d < dims; d++ )
+        {
+            float t = query[d] - codebook_t[d*count + j];
+            s += t*t;
+        }
+        table[j] = s;
+    }
+}
+
+void pq_l1_table(const float* query, const float* codebook_t, int dims, int count, float* table)
+{
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::pq_l1_table(query, codebook_t, dims, count, table);
+        return;
+    }
+#endif
+
+    int j = 0;
+#if CV_SIMD128
+    for( ; j <= count - 8; j += 8 )
+    {
+        v_float32x4 s0 = v_setzero_f32(), s1 = v_setzero_f32();
+        const float* c = codebook_t + j;
+        for( int d = 0; d < dims; d++, c += count )
+        {
+            v_float32x4 q = v_setall_f32(query[d]);
+            s0 += v_absdiff(q, v_load(c));
+            s1 += v_absdiff(q, v_load(c + 4));
+        }
+        v_store(table + j, s0);
+        v_store(table + j + 4, s1);
+    }
+#endif
+    for( ; j < count; j++ )
+    {
+        float s = 0.f;
+        for( int d = 0; d < dims; d++ )
+            s += std::abs(query[d] - codebook_t[d*count + j]);
+        table[j] = s;
+    }
+}
+
+void pq_scan(const float* tables, const unsigned char* codes, int m, int count, float* dists)
+{
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::pq_scan(tables, codes, m, count, dists);
+        return;
+    }
+#endif
+
+    // 4 points at once, for independent chains of additions
+    int i = 0;
+    for( ; i <= count - 4; i += 4, codes += m*4 )
+    {
+        float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+        const float* t = tables;
+        for( int j = 0; j < m; j++, t += PQ_CODEWORDS )
+        {
+            s0 += t[codes[j]];
+            s1 += t[codes[j + m]];
+            s2 += t[codes[j + m*2]];
+            s3 += t[codes[j + m*3]];
+        }
+        dists[i] = s0; dists[i+1] = s1;
+        dists[i+2] = s2; dists[i+3] = s3;
+    }
+    for( ; i < count; i++, codes += m )
+    {
+        float s = 0.f;
+        for( int j = 0; j < m; j++ )
+            s += tables[j*PQ_CODEWORDS + codes[j]];
+        dists[i] = s;
+    }
+}
+
+}
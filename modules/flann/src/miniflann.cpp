@@ -1,5 +1,13 @@
 #include "precomp.hpp"
 
+#if defined WIN32 || defined _WIN32 || defined WINCE
+#  include <windows.h>
+#  undef min
+#  undef max
+#else
+#  include <pthread.h>
+#endif
+
 #define MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES 0
 
 static cvflann::IndexParams& get_params(const cv::flann::IndexParams& p)
@@ -285,6 +293,28 @@ LshIndexParams::LshIndexParams(int table_number, int key_size, int multi_probe_l
     p["multi_probe_level"] = multi_probe_level;
 }
 
+IVFPQIndexParams::IVFPQIndexParams(int lists, int subquantizers, int iterations)
+{
+    ::cvflann::IndexParams& p = get_params(*this);
+    p["algorithm"] = FLANN_INDEX_IVFPQ;
+    // number of inverted lists, i.e. of centers of the coarse quantizer
+    p["lists"] = lists;
+    // number of sub-vectors a point is split into, each one is encoded in a byte
+    p["subquantizers"] = subquantizers;
+    // max iterations of the kmeans clusterings training the quantizers
+    p["iterations"] = iterations;
+}
+
+HNSWIndexParams::HNSWIndexParams(int neighbors, int ef_construction)
+{
+    ::cvflann::IndexParams& p = get_params(*this);
+    p["algorithm"] = FLANN_INDEX_HNSW;
+    // number of links of a point in the upper layers of the graph, twice as many in the bottom layer
+    p["neighbors"] = neighbors;
+    // size of the candidate list of the search for the neighbours of an inserted point
+    p["ef_construction"] = ef_construction;
+}
+
 SavedIndexParams::SavedIndexParams(const String& _filename)
 {
     String filename = _filename;
@@ -334,43 +364,8 @@ typedef ::cvflann::Hamming<uchar> HammingDistance;
 typedef ::cvflann::HammingLUT HammingDistance;
 #endif
 
-Index::Index()
-{
-    index = 0;
-    featureType = CV_32F;
-    algo = FLANN_INDEX_LINEAR;
-    distType = FLANN_DIST_L2;
-}
-
-Index::Index(InputArray _data, const IndexParams& params, flann_distance_t _distType)
-{
-    index = 0;
-    featureType = CV_32F;
-    algo = FLANN_INDEX_LINEAR;
-    distType = FLANN_DIST_L2;
-    build(_data, params, _distType);
-}
-
-void Index::build(InputArray _data, const IndexParams& params, flann_distance_t _distType)
+static void buildIndexOf(flann_distance_t distType, void*& index, const Mat& data, const IndexParams& params)
 {
-    release();
-    algo = getParam<flann_algorithm_t>(params, "algorithm", FLANN_INDEX_LINEAR);
-    if( algo == FLANN_INDEX_SAVED )
-    {
-        load(_data, getParam<String>(params, "filename", String()));
-        return;
-    }
-
-    Mat data = _data.getMat();
-    index = 0;
-    featureType = data.type();
-    distType = _distType;
-
-    if ( algo == FLANN_INDEX_LSH)
-    {
-        distType = FLANN_DIST_HAMMING;
-    }
-
     switch( distType )
     {
     case FLANN_DIST_HAMMING:
@@ -414,16 +409,8 @@ template<typename Distance> void deleteIndex(void* index)
     deleteIndex_< ::cvflann::Index<Distance> >(index);
 }
 
-Index::~Index()
+static void deleteIndexOf(flann_distance_t distType, void* index)
 {
-    release();
-}
-
-void Index::release()
-{
-    if( !index )
-        return;
-
     switch( distType )
     {
         case FLANN_DIST_HAMMING:
@@ -455,6 +442,165 @@ void Index::release()
         default:
             CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
     }
+}
+
+// A rebuild started by Index::rebuildAsync(). The worker thread only touches data, params and
+// index; the points removed since the start are applied by the caller when it swaps the index in.
+struct RebuildJob
+{
+    std::vector<Mat> blocks;    // the points to index, concatenated by the worker into data
+    Mat data;
+    ::cvflann::IndexParams params;
+    flann_distance_t distType;
+    std::vector<int> removed;   // removed before the start, or since then
+    size_t addedCount;          // the number of Index::addedData blocks the new index includes
+    void* index;
+    String error;
+    int done;
+#if defined WIN32 || defined _WIN32 || defined WINCE
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+};
+
+static void runRebuild(RebuildJob* job)
+{
+    try
+    {
+        if( job->blocks.size() == 1 )
+            job->data = job->blocks[0];
+        else
+            vconcat(job->blocks, job->data);
+        job->blocks.clear();
+
+        IndexParams params;
+        get_params(params) = job->params;
+        buildIndexOf(job->distType, job->index, job->data, params);
+    }
+    catch( const cv::Exception& e )
+    {
+        job->error = e.err;
+    }
+    catch( const std::exception& e )
+    {
+        job->error = e.what();
+    }
+    catch( ... )
+    {
+        job->error = "Unknown exception";
+    }
+    CV_XADD(&job->done, 1);
+}
+
+#if defined WIN32 || defined _WIN32 || defined WINCE
+static DWORD WINAPI rebuildThread(LPVOID arg)
+{
+    runRebuild((RebuildJob*)arg);
+    return 0;
+}
+
+static void startRebuild(RebuildJob* job)
+{
+    job->thread = CreateThread(0, 0, rebuildThread, job, 0, 0);
+    if( !job->thread )
+        CV_Error(Error::StsError, "Can not start the thread rebuilding the FLANN index");
+}
+
+static void joinRebuild(RebuildJob* job)
+{
+    WaitForSingleObject(job->thread, INFINITE);
+    CloseHandle(job->thread);
+}
+#else
+static void* rebuildThread(void* arg)
+{
+    runRebuild((RebuildJob*)arg);
+    return 0;
+}
+
+static void startRebuild(RebuildJob* job)
+{
+    if( pthread_create(&job->thread, 0, rebuildThread, job) != 0 )
+        CV_Error(Error::StsError, "Can not start the thread rebuilding the FLANN index");
+}
+
+static void joinRebuild(RebuildJob* job)
+{
+    pthread_join(job->thread, 0);
+}
+#endif
+
+// Waits for the rebuild and throws its result away
+static void discardRebuild(void*& rebuild)
+{
+    RebuildJob* job = (RebuildJob*)rebuild;
+    if( !job )
+        return;
+    rebuild = 0;
+    joinRebuild(job);
+    if( job->index )
+        deleteIndexOf(job->distType, job->index);
+    delete job;
+}
+
+Index::Index()
+{
+    index = 0;
+    rebuild = 0;
+    featureType = CV_32F;
+    algo = FLANN_INDEX_LINEAR;
+    distType = FLANN_DIST_L2;
+}
+
+Index::Index(InputArray _data, const IndexParams& params, flann_distance_t _distType)
+{
+    index = 0;
+    rebuild = 0;
+    featureType = CV_32F;
+    algo = FLANN_INDEX_LINEAR;
+    distType = FLANN_DIST_L2;
+    build(_data, params, _distType);
+}
+
+void Index::build(InputArray _data, const IndexParams& params, flann_distance_t _distType)
+{
+    release();
+    algo = getParam<flann_algorithm_t>(params, "algorithm", FLANN_INDEX_LINEAR);
+    if( algo == FLANN_INDEX_SAVED )
+    {
+        load(_data, getParam<String>(params, "filename", String()));
+        return;
+    }
+
+    Mat features = _data.getMat();
+    index = 0;
+    featureType = features.type();
+    distType = _distType;
+
+    if ( algo == FLANN_INDEX_LSH)
+    {
+        distType = FLANN_DIST_HAMMING;
+    }
+
+    buildIndexOf(distType, index, features, params);
+    data = features;
+}
+
+Index::~Index()
+{
+    release();
+}
+
+void Index::release()
+{
+    discardRebuild(rebuild);
+    data.release();
+    addedData.clear();
+    if( !index )
+        return;
+
+    deleteIndexOf(distType, index);
     index = 0;
 }
 
@@ -628,6 +774,251 @@ int Index::radiusSearch(InputArray _query, OutputArray _indices,
     return -1;
 }
 
+template<typename Distance, typename IndexType>
+void runAddPoints_(void* index, const Mat& data, float rebuildThreshold)
+{
+    typedef typename Distance::ElementType ElementType;
+    if(DataType<ElementType>::type != data.type())
+        CV_Error_(Error::StsUnsupportedFormat, ("type=%d\n", data.type()));
+    if(!data.isContinuous())
+        CV_Error(Error::StsBadArg, "Only continuous arrays are supported");
+
+    ::cvflann::Matrix<ElementType> points((ElementType*)data.data, data.rows, data.cols);
+    ((IndexType*)index)->addPoints(points, rebuildThreshold);
+}
+
+template<typename Distance>
+void runAddPoints(void* index, const Mat& data, float rebuildThreshold)
+{
+    runAddPoints_<Distance, ::cvflann::Index<Distance> >(index, data, rebuildThreshold);
+}
+
+static void addPointsTo(flann_distance_t distType, void* index, const Mat& data, float rebuildThreshold)
+{
+    switch( distType )
+    {
+    case FLANN_DIST_HAMMING:
+        runAddPoints< HammingDistance >(index, data, rebuildThreshold);
+        break;
+    case FLANN_DIST_L2:
+        runAddPoints< ::cvflann::L2<float> >(index, data, rebuildThreshold);
+        break;
+    case FLANN_DIST_L1:
+        runAddPoints< ::cvflann::L1<float> >(index, data, rebuildThreshold);
+        break;
+#if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
+    case FLANN_DIST_MAX:
+        runAddPoints< ::cvflann::MaxDistance<float> >(index, data, rebuildThreshold);
+        break;
+    case FLANN_DIST_HIST_INTERSECT:
+        runAddPoints< ::cvflann::HistIntersectionDistance<float> >(index, data, rebuildThreshold);
+        break;
+    case FLANN_DIST_HELLINGER:
+        runAddPoints< ::cvflann::HellingerDistance<float> >(index, data, rebuildThreshold);
+        break;
+    case FLANN_DIST_CHI_SQUARE:
+        runAddPoints< ::cvflann::ChiSquareDistance<float> >(index, data, rebuildThreshold);
+        break;
+    case FLANN_DIST_KL:
+        runAddPoints< ::cvflann::KL_Divergence<float> >(index, data, rebuildThreshold);
+        break;
+#endif
+    default:
+        CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
+    }
+}
+
+void Index::addPoints(InputArray _data, float rebuildThreshold, bool rebuildInBackground)
+{
+    CV_Assert( index != 0 );
+    Mat points = _data.getMat();
+    if( points.empty() )
+        return;
+    CV_Assert( points.type() == featureType );
+
+    finishRebuild(false);
+    // the index being replaced by a rebuild is not rebuilt itself
+    bool background = rebuild != 0 ||
+        (rebuildInBackground && (algo == FLANN_INDEX_KDTREE || algo == FLANN_INDEX_KMEANS ||
+                                 algo == FLANN_INDEX_COMPOSITE));
+    addPointsTo(distType, index, points, background ? 0.f : rebuildThreshold);
+    addedData.push_back(points);
+
+    if( background && !rebuild && rebuildThreshold > 1 )
+    {
+        size_t count = data.rows;
+        for( size_t i = 0; i < addedData.size(); i++ )
+            count += addedData[i].rows;
+        if( data.rows*rebuildThreshold < count )
+            rebuildAsync();
+    }
+}
+
+template<typename Distance>
+void runRemovePoint(void* index, int idx)
+{
+    ((::cvflann::Index<Distance>*)index)->removePoint((size_t)idx);
+}
+
+static void removePointFrom(flann_distance_t distType, void* index, int idx)
+{
+    switch( distType )
+    {
+    case FLANN_DIST_HAMMING:
+        runRemovePoint< HammingDistance >(index, idx);
+        break;
+    case FLANN_DIST_L2:
+        runRemovePoint< ::cvflann::L2<float> >(index, idx);
+        break;
+    case FLANN_DIST_L1:
+        runRemovePoint< ::cvflann::L1<float> >(index, idx);
+        break;
+#if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
+    case FLANN_DIST_MAX:
+        runRemovePoint< ::cvflann::MaxDistance<float> >(index, idx);
+        break;
+    case FLANN_DIST_HIST_INTERSECT:
+        runRemovePoint< ::cvflann::HistIntersectionDistance<float> >(index, idx);
+        break;
+    case FLANN_DIST_HELLINGER:
+        runRemovePoint< ::cvflann::HellingerDistance<float> >(index, idx);
+        break;
+    case FLANN_DIST_CHI_SQUARE:
+        runRemovePoint< ::cvflann::ChiSquareDistance<float> >(index, idx);
+        break;
+    case FLANN_DIST_KL:
+        runRemovePoint< ::cvflann::KL_Divergence<float> >(index, idx);
+        break;
+#endif
+    default:
+        CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
+    }
+}
+
+void Index::removePoint(int idx)
+{
+    CV_Assert( index != 0 && idx >= 0 );
+
+    finishRebuild(false);
+    removePointFrom(distType, index, idx);
+    if( rebuild )
+        ((RebuildJob*)rebuild)->removed.push_back(idx);
+}
+
+template<typename Distance>
+void getRebuildParams(void* index, ::cvflann::IndexParams& params, std::vector<int>& removed)
+{
+    ::cvflann::Index<Distance>* _index = (::cvflann::Index<Distance>*)index;
+    params = _index->getParameters();
+    for( size_t i = 0; i < _index->size(); i++ )
+    {
+        if( _index->isRemoved(i) )
+            removed.push_back((int)i);
+    }
+}
+
+void Index::rebuildAsync()
+{
+    CV_Assert( index != 0 );
+    if( rebuild )
+        return;
+    if( data.empty() )
+        CV_Error(Error::StsBadArg, "The index was loaded without its points, it can not be rebuilt");
+
+    RebuildJob* job = new RebuildJob;
+    job->blocks.push_back(data);
+    job->blocks.insert(job->blocks.end(), addedData.begin(), addedData.end());
+    job->distType = distType;
+    job->addedCount = addedData.size();
+    job->index = 0;
+    job->done = 0;
+
+    try
+    {
+        switch( distType )
+        {
+        case FLANN_DIST_HAMMING:
+            getRebuildParams< HammingDistance >(index, job->params, job->removed);
+            break;
+        case FLANN_DIST_L2:
+            getRebuildParams< ::cvflann::L2<float> >(index, job->params, job->removed);
+            break;
+        case FLANN_DIST_L1:
+            getRebuildParams< ::cvflann::L1<float> >(index, job->params, job->removed);
+            break;
+#if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
+        case FLANN_DIST_MAX:
+            getRebuildParams< ::cvflann::MaxDistance<float> >(index, job->params, job->removed);
+            break;
+        case FLANN_DIST_HIST_INTERSECT:
+            getRebuildParams< ::cvflann::HistIntersectionDistance<float> >(index, job->params, job->removed);
+            break;
+        case FLANN_DIST_HELLINGER:
+            getRebuildParams< ::cvflann::HellingerDistance<float> >(index, job->params, job->removed);
+            break;
+        case FLANN_DIST_CHI_SQUARE:
+            getRebuildParams< ::cvflann::ChiSquareDistance<float> >(index, job->params, job->removed);
+            break;
+        case FLANN_DIST_KL:
+            getRebuildParams< ::cvflann::KL_Divergence<float> >(index, job->params, job->removed);
+            break;
+#endif
+        default:
+            CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
+        }
+        startRebuild(job);
+    }
+    catch( ... )
+    {
+        delete job;
+        throw;
+    }
+    rebuild = job;
+}
+
+bool Index::waitRebuild()
+{
+    return finishRebuild(true);
+}
+
+// Swaps in the index built by rebuildAsync() once it is ready, or waits for it with wait
+bool Index::finishRebuild(bool wait)
+{
+    RebuildJob* job = (RebuildJob*)rebuild;
+    if( !job || (!wait && CV_XADD(&job->done, 0) == 0) )
+        return false;
+    rebuild = 0;
+    joinRebuild(job);
+
+    if( !job->error.empty() )
+    {
+        String error = job->error;
+        delete job;
+        CV_Error_(Error::StsError, ("Rebuilding the FLANN index failed: %s", error.c_str()));
+    }
+
+    try
+    {
+        for( size_t i = job->addedCount; i < addedData.size(); i++ )
+            addPointsTo(distType, job->index, addedData[i], 0.f);
+        for( size_t i = 0; i < job->removed.size(); i++ )
+            removePointFrom(distType, job->index, job->removed[i]);
+    }
+    catch( ... )
+    {
+        deleteIndexOf(distType, job->index);
+        delete job;
+        throw;
+    }
+
+    deleteIndexOf(distType, index);
+    index = job->index;
+    data = job->data;
+    addedData.erase(addedData.begin(), addedData.begin() + job->addedCount);
+    delete job;
+    return true;
+}
+
 flann_distance_t Index::getDistance() const
 {
     return distType;
@@ -654,12 +1045,8 @@ template<typename Distance> void saveIndex(const Index* index0, const void* inde
     saveIndex_< ::cvflann::Index<Distance> >(index0, index, fout);
 }
 
-void Index::save(const String& filename) const
+void Index::saveTo(FILE* fout) const
 {
-    FILE* fout = fopen(filename.c_str(), "wb");
-    if (fout == NULL)
-        CV_Error_( Error::StsError, ("Can not open file %s for writing FLANN index\n", filename.c_str()) );
-
     switch( distType )
     {
     case FLANN_DIST_HAMMING:
@@ -689,22 +1076,75 @@ void Index::save(const String& filename) const
         break;
 #endif
     default:
-        fclose(fout);
-        fout = 0;
         CV_Error(Error::StsBadArg, "Unknown/unsupported distance type");
     }
-    if( fout )
+}
+
+void Index::save(const String& filename) const
+{
+    FILE* fout = fopen(filename.c_str(), "wb");
+    if (fout == NULL)
+        CV_Error_( Error::StsError, ("Can not open file %s for writing FLANN index\n", filename.c_str()) );
+
+    try
+    {
+        saveTo(fout);
+    }
+    catch( ... )
+    {
+        fclose(fout);
+        throw;
+    }
+    fclose(fout);
+}
+
+void Index::saveWithFeatures(const String& filename) const
+{
+    CV_Assert( index != 0 );
+
+    // the index is written by the FILE-based savers, so it goes through a temporary file
+    FILE* fout = tmpfile();
+    if (fout == NULL)
+        CV_Error( Error::StsError, "Can not create a temporary file for writing FLANN index" );
+    std::vector<uchar> buf;
+    try
+    {
+        saveTo(fout);
+        buf.resize((size_t)ftell(fout));
+        if( buf.empty() || fseek(fout, 0, SEEK_SET) != 0 || fread(&buf[0], 1, buf.size(), fout) != buf.size() )
+            CV_Error( Error::StsError, "Can not read the FLANN index back from the temporary file" );
+    }
+    catch( ... )
+    {
         fclose(fout);
+        throw;
+    }
+    fclose(fout);
+
+    Mat features = data;
+    if( !addedData.empty() )
+    {
+        std::vector<Mat> blocks(1, data);
+        blocks.insert(blocks.end(), addedData.begin(), addedData.end());
+        vconcat(blocks, features);
+    }
+
+    FileStorage fs(filename, FileStorage::WRITE + FileStorage::FORMAT_BINARY);
+    if( !fs.isOpened() )
+        CV_Error_( Error::StsError, ("Can not open file %s for writing FLANN index\n", filename.c_str()) );
+    fs << "features" << features;
+    fs << "index" << Mat(1, (int)buf.size(), CV_8U, &buf[0]);
 }
 
 
 template<typename Distance, typename IndexType>
-bool loadIndex_(Index* index0, void*& index, const Mat& data, FILE* fin, const Distance& dist=Distance())
+bool loadIndex_(Index* index0, void*& index, const Mat& data, const ::cvflann::IndexHeader& header,
+                FILE* fin, const Distance& dist=Distance())
 {
     typedef typename Distance::ElementType ElementType;
-    CV_Assert(DataType<ElementType>::type == data.type() && data.isContinuous());
+    CV_Assert(data.empty() || (DataType<ElementType>::type == data.type() && data.isContinuous()));
 
-    ::cvflann::Matrix<ElementType> dataset((ElementType*)data.data, data.rows, data.cols);
+    ::cvflann::Matrix<ElementType> dataset((ElementType*)data.data, header.rows, header.cols);
 
     ::cvflann::IndexParams params;
     params["algorithm"] = index0->getAlgorithm();
@@ -715,19 +1155,15 @@ bool loadIndex_(Index* index0, void*& index, const Mat& data, FILE* fin, const D
 }
 
 template<typename Distance>
-bool loadIndex(Index* index0, void*& index, const Mat& data, FILE* fin, const Distance& dist=Distance())
+bool loadIndex(Index* index0, void*& index, const Mat& data, const ::cvflann::IndexHeader& header,
+               FILE* fin, const Distance& dist=Distance())
 {
-    return loadIndex_<Distance, ::cvflann::Index<Distance> >(index0, index, data, fin, dist);
+    return loadIndex_<Distance, ::cvflann::Index<Distance> >(index0, index, data, header, fin, dist);
 }
 
-bool Index::load(InputArray _data, const String& filename)
+bool Index::loadFrom(const Mat& features, FILE* fin)
 {
-    Mat data = _data.getMat();
     bool ok = true;
-    release();
-    FILE* fin = fopen(filename.c_str(), "rb");
-    if (fin == NULL)
-        return false;
 
     ::cvflann::IndexHeader header = ::cvflann::load_header(fin);
     algo = header.index_type;
@@ -739,12 +1175,13 @@ bool Index::load(InputArray _data, const String& filename)
                   header.data_type == FLANN_FLOAT32 ? CV_32F :
                   header.data_type == FLANN_FLOAT64 ? CV_64F : -1;
 
-    if( (int)header.rows != data.rows || (int)header.cols != data.cols ||
-        featureType != data.type() )
+    // the IVF-PQ index keeps the codes of the points, it can be loaded without them
+    if( !(features.empty() && algo == FLANN_INDEX_IVFPQ) &&
+        ((int)header.rows != features.rows || (int)header.cols != features.cols ||
+         featureType != features.type()) )
     {
         fprintf(stderr, "Reading FLANN index error: the saved data size (%d, %d) or type (%d) is different from the passed one (%d, %d), %d\n",
-                (int)header.rows, (int)header.cols, featureType, data.rows, data.cols, data.type());
-        fclose(fin);
+                (int)header.rows, (int)header.cols, featureType, features.rows, features.cols, features.type());
         return false;
     }
 
@@ -756,36 +1193,35 @@ bool Index::load(InputArray _data, const String& filename)
           (distType != FLANN_DIST_HAMMING && featureType == CV_32F)) )
     {
         fprintf(stderr, "Reading FLANN index error: unsupported feature type %d for the index type %d\n", featureType, algo);
-        fclose(fin);
         return false;
     }
 
     switch( distType )
     {
     case FLANN_DIST_HAMMING:
-        loadIndex< HammingDistance >(this, index, data, fin);
+        loadIndex< HammingDistance >(this, index, features, header, fin);
         break;
     case FLANN_DIST_L2:
-        loadIndex< ::cvflann::L2<float> >(this, index, data, fin);
+        loadIndex< ::cvflann::L2<float> >(this, index, features, header, fin);
         break;
     case FLANN_DIST_L1:
-        loadIndex< ::cvflann::L1<float> >(this, index, data, fin);
+        loadIndex< ::cvflann::L1<float> >(this, index, features, header, fin);
         break;
 #if MINIFLANN_SUPPORT_EXOTIC_DISTANCE_TYPES
     case FLANN_DIST_MAX:
-        loadIndex< ::cvflann::MaxDistance<float> >(this, index, data, fin);
+        loadIndex< ::cvflann::MaxDistance<float> >(this, index, features, header, fin);
         break;
     case FLANN_DIST_HIST_INTERSECT:
-        loadIndex< ::cvflann::HistIntersectionDistance<float> >(index, data, fin);
+        loadIndex< ::cvflann::HistIntersectionDistance<float> >(this, index, features, header, fin);
         break;
     case FLANN_DIST_HELLINGER:
-        loadIndex< ::cvflann::HellingerDistance<float> >(this, index, data, fin);
+        loadIndex< ::cvflann::HellingerDistance<float> >(this, index, features, header, fin);
         break;
     case FLANN_DIST_CHI_SQUARE:
-        loadIndex< ::cvflann::ChiSquareDistance<float> >(this, index, data, fin);
+        loadIndex< ::cvflann::ChiSquareDistance<float> >(this, index, features, header, fin);
         break;
     case FLANN_DIST_KL:
-        loadIndex< ::cvflann::KL_Divergence<float> >(this, index, data, fin);
+        loadIndex< ::cvflann::KL_Divergence<float> >(this, index, features, header, fin);
         break;
 #endif
     default:
@@ -793,8 +1229,64 @@ bool Index::load(InputArray _data, const String& filename)
         ok = false;
     }
 
-    if( fin )
-        fclose(fin);
+    if( ok )
+        data = features;
+    return ok;
+}
+
+bool Index::load(InputArray _data, const String& filename)
+{
+    Mat features = _data.getMat();
+    release();
+    FILE* fin = fopen(filename.c_str(), "rb");
+    if (fin == NULL)
+        return false;
+
+    bool ok = loadFrom(features, fin);
+    fclose(fin);
+    return ok;
+}
+
+// Opens a stream reading the bytes of buf, which must outlive it. Where fmemopen is not available
+// the bytes are copied to a temporary file.
+static FILE* openMemoryStream(const Mat& buf)
+{
+    size_t size = buf.total()*buf.elemSize();
+#ifdef __GLIBC__
+    return fmemopen(buf.data, size, "rb");
+#else
+    FILE* f = tmpfile();
+    if( f && (fwrite(buf.data, 1, size, f) != size || fseek(f, 0, SEEK_SET) != 0) )
+    {
+        fclose(f);
+        f = 0;
+    }
+    return f;
+#endif
+}
+
+bool Index::loadWithFeatures(const String& filename, OutputArray _features)
+{
+    release();
+    Mat features, buf;
+    {
+        FileStorage fs(filename, FileStorage::READ + FileStorage::MMAP);
+        if( !fs.isOpened() )
+            return false;
+        fs["features"] >> features;
+        fs["index"] >> buf;
+    }
+    if( buf.empty() || !buf.isContinuous() )
+        return false;
+
+    FILE* fin = openMemoryStream(buf);
+    if (fin == NULL)
+        return false;
+
+    bool ok = loadFrom(features, fin);
+    fclose(fin);
+    if( ok && _features.needed() )
+        _features.assign(features);
     return ok;
 }
 
@@ -22,4 +22,24 @@
 
 #include "opencv2/core/private.hpp"
 
+namespace cvflann
+{
+
+#if CV_TRY_AVX2
+// kernels from *.avx2.cpp, compiled with -mavx2 -mfma and selected at runtime
+namespace opt_AVX2
+{
+void pq_l2_table(const float* query, const float* codebook_t, int dims, int count, float* table);
+void pq_l1_table(const float* query, const float* codebook_t, int dims, int count, float* table);
+void pq_scan(const float* tables, const unsigned char* codes, int m, int count, float* dists);
+}
+
+static inline bool useAVX2()
+{
+    return cv::checkHardwareSupport(CV_CPU_AVX2) && cv::checkHardwareSupport(CV_CPU_FMA3);
+}
+#endif
+
+}
+
 #endif
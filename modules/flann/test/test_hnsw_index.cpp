@@ -0,0 +1,124 @@
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Points around 100 centers, of floats or of bytes with a few bits flipped from the center;
+// the queries are drawn the same way.
+static void makeData(Mat& data, Mat& queries, int type)
+{
+    RNG rng(0x9abc);
+    const int count = 20000, dims = 32, clusters = 100;
+
+    Mat centers(clusters, dims, type);
+    data.create(count, dims, type);
+    queries.create(200, dims, type);
+    if (type == CV_8U)
+    {
+        rng.fill(centers, RNG::UNIFORM, 0, 256);
+        for (int i = 0; i < count + queries.rows; i++)
+        {
+            uchar* row = i < count ? data.ptr(i) : queries.ptr(i - count);
+            centers.row(rng.uniform(0, clusters)).copyTo(Mat(1, dims, CV_8U, row));
+            for (int k = 0; k < 24; k++)
+                row[rng.uniform(0, dims)] ^= (uchar)(1 << rng.uniform(0, 8));
+        }
+    }
+    else
+    {
+        rng.fill(centers, RNG::UNIFORM, 0.f, 10.f);
+        for (int i = 0; i < count + queries.rows; i++)
+        {
+            Mat row = i < count ? data.row(i) : queries.row(i - count);
+            rng.fill(row, RNG::NORMAL, 0.f, 1.f);
+            row += centers.row(rng.uniform(0, clusters));
+        }
+    }
+}
+
+// Share of the neighbours found that are as close as the exact ones (from the linear index);
+// the distances are compared rather than the indices because of the ties of the Hamming distance,
+// with a tolerance since the index and the linear search sum the float distances in different orders
+static double recall(const Mat& dists, const Mat& exactDists)
+{
+    Mat found, exact;
+    dists.convertTo(found, CV_32F);
+    exactDists.convertTo(exact, CV_32F);
+    int count = 0;
+    for (int i = 0; i < exact.rows; i++)
+        for (int j = 0; j < exact.cols; j++)
+            if (found.at<float>(i, j) <= exact.at<float>(i, exact.cols - 1) * (1 + 1e-5f))
+                count++;
+    return (double)count / exact.total();
+}
+
+static void testAccuracy(int type, cvflann::flann_distance_t distType)
+{
+    Mat data, queries, indices, dists, exact, exactDists;
+    makeData(data, queries, type);
+
+    flann::Index linear(data, flann::LinearIndexParams(), distType);
+    linear.knnSearch(queries, exact, exactDists, 10);
+
+    flann::Index index(data, flann::HNSWIndexParams(), distType);
+    EXPECT_EQ(cvflann::FLANN_INDEX_HNSW, index.getAlgorithm());
+
+    index.knnSearch(queries, indices, dists, 10, flann::SearchParams(64));
+    EXPECT_GT(recall(dists, exactDists), 0.95);
+    Mat sortedDists;
+    dists.convertTo(sortedDists, CV_32F);
+    for (int i = 0; i < queries.rows; i++)
+        for (int j = 1; j < indices.cols; j++)
+            EXPECT_LE(sortedDists.at<float>(i, j - 1), sortedDists.at<float>(i, j));
+
+    // a larger candidate list finds more of the neighbours
+    index.knnSearch(queries, indices, dists, 10, flann::SearchParams(256));
+    EXPECT_GT(recall(dists, exactDists), 0.99);
+}
+
+}
+
+TEST(Flann_HNSWIndex, accuracy_L2)
+{
+    testAccuracy(CV_32F, cvflann::FLANN_DIST_L2);
+}
+
+TEST(Flann_HNSWIndex, accuracy_L1)
+{
+    testAccuracy(CV_32F, cvflann::FLANN_DIST_L1);
+}
+
+TEST(Flann_HNSWIndex, accuracy_Hamming)
+{
+    testAccuracy(CV_8U, cvflann::FLANN_DIST_HAMMING);
+}
+
+// The graph is serialized: the loaded index returns the same neighbours as the saved one.
+TEST(Flann_HNSWIndex, saveLoad)
+{
+    Mat data, queries, indices, dists;
+    makeData(data, queries, CV_32F);
+
+    flann::Index index(data, flann::HNSWIndexParams(8, 50));
+    index.removePoint(5);
+    flann::SearchParams searchParams(32);
+    index.knnSearch(queries, indices, dists, 5, searchParams);
+
+    string filename = tempfile(".flann");
+    index.save(filename);
+
+    flann::Index loaded;
+    ASSERT_TRUE(loaded.load(data, filename));
+    remove(filename.c_str());
+    EXPECT_EQ(cvflann::FLANN_INDEX_HNSW, loaded.getAlgorithm());
+
+    Mat loadedIndices, loadedDists;
+    loaded.knnSearch(queries, loadedIndices, loadedDists, 5, searchParams);
+    EXPECT_EQ(0, cvtest::norm(indices, loadedIndices, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(dists, loadedDists, NORM_INF));
+
+    loaded.knnSearch(data.row(5), loadedIndices, loadedDists, 1, searchParams);
+    EXPECT_NE(5, loadedIndices.at<int>(0, 0));
+}
@@ -0,0 +1,172 @@
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Every point of the dataset must be found as its own nearest neighbour; removed points
+// must not be returned at all (a removed query may get no neighbour, e.g. from LSH).
+static void checkSelfMatches(flann::Index& index, const Mat& data, const vector<bool>& removed,
+                             const flann::SearchParams& searchParams)
+{
+    Mat indices, dists;
+    index.knnSearch(data, indices, dists, 1, searchParams);
+    ASSERT_EQ(data.rows, indices.rows);
+
+    for (int i = 0; i < data.rows; i++)
+    {
+        int idx = indices.at<int>(i, 0);
+        if (idx < 0 && removed[i])
+            continue;
+        ASSERT_TRUE(idx >= 0 && idx < data.rows) << "query " << i;
+        EXPECT_FALSE(removed[idx]) << "query " << i << " returned removed point " << idx;
+        if (!removed[i])
+            EXPECT_EQ(i, idx) << "query " << i;
+    }
+}
+
+static void testIncrementalIndex(const flann::IndexParams& indexParams,
+                                 const flann::SearchParams& searchParams,
+                                 int type, cvflann::flann_distance_t distType,
+                                 float rebuildThreshold)
+{
+    RNG rng(0x1234);
+    const int count = 600, dims = type == CV_8U ? 32 : 8;
+
+    Mat data(count, dims, type);
+    if (type == CV_8U)
+        rng.fill(data, RNG::UNIFORM, 0, 256);
+    else
+        rng.fill(data, RNG::UNIFORM, 0.f, 1.f);
+
+    // the index references the data, so build and grow it on row ranges of one matrix
+    const int initial = count / 4;
+    flann::Index index(data.rowRange(0, initial), indexParams, distType);
+    for (int start = initial; start < count; start += 75)
+        index.addPoints(data.rowRange(start, std::min(start + 75, count)), rebuildThreshold);
+
+    vector<bool> removed(count, false);
+    checkSelfMatches(index, data, removed, searchParams);
+
+    for (int i = 0; i < count; i += 7)
+    {
+        index.removePoint(i);
+        removed[i] = true;
+    }
+    checkSelfMatches(index, data, removed, searchParams);
+
+    string filename = tempfile(".flann");
+    index.save(filename);
+
+    flann::Index loaded;
+    ASSERT_TRUE(loaded.load(data, filename));
+    remove(filename.c_str());
+    checkSelfMatches(loaded, data, removed, searchParams);
+}
+
+// The index is rebuilt by a worker while points are added and removed; the new one must
+// include all of them once swapped in, and be saved and mapped back with its points.
+static void testBackgroundRebuild(const flann::IndexParams& indexParams)
+{
+    RNG rng(0x4321);
+    const int count = 800, dims = 8;
+    Mat data(count, dims, CV_32F);
+    rng.fill(data, RNG::UNIFORM, 0.f, 1.f);
+    flann::SearchParams searchParams(10000);
+
+    const int initial = 100;
+    flann::Index index(data.rowRange(0, initial), indexParams, cvflann::FLANN_DIST_L2);
+    vector<bool> removed(count, false);
+    for (int start = initial; start < count; start += 50)
+    {
+        index.addPoints(data.rowRange(start, start + 50), 1.5f, true);
+        index.removePoint(start - 3);
+        removed[start - 3] = true;
+    }
+    index.waitRebuild();
+    checkSelfMatches(index, data, removed, searchParams);
+
+    index.rebuildAsync();
+    index.removePoint(count - 1);
+    removed[count - 1] = true;
+    EXPECT_TRUE(index.waitRebuild());
+    EXPECT_FALSE(index.waitRebuild());
+    checkSelfMatches(index, data, removed, searchParams);
+
+    string filename = tempfile(".bin");
+    index.saveWithFeatures(filename);
+    index.release();
+
+    flann::Index loaded;
+    Mat features;
+    ASSERT_TRUE(loaded.loadWithFeatures(filename, features));
+    EXPECT_EQ(0, cvtest::norm(features, data, NORM_INF));
+    // the points are not copied out of the mapped file
+    ASSERT_TRUE(features.u != 0);
+    EXPECT_NE(Mat::getStdAllocator(), features.u->currAllocator);
+    checkSelfMatches(loaded, data, removed, searchParams);
+    loaded.release();
+    features.release();
+    remove(filename.c_str());
+}
+
+}
+
+TEST(Flann_IncrementalIndex, kdtree)
+{
+    testIncrementalIndex(flann::KDTreeIndexParams(2), flann::SearchParams(10000),
+                         CV_32F, cvflann::FLANN_DIST_L2, 100.f);
+}
+
+TEST(Flann_IncrementalIndex, kdtree_rebuild)
+{
+    testIncrementalIndex(flann::KDTreeIndexParams(2), flann::SearchParams(10000),
+                         CV_32F, cvflann::FLANN_DIST_L2, 1.5f);
+}
+
+TEST(Flann_IncrementalIndex, kmeans)
+{
+    testIncrementalIndex(flann::KMeansIndexParams(8), flann::SearchParams(10000),
+                         CV_32F, cvflann::FLANN_DIST_L2, 100.f);
+}
+
+TEST(Flann_IncrementalIndex, kmeans_rebuild)
+{
+    testIncrementalIndex(flann::KMeansIndexParams(8), flann::SearchParams(10000),
+                         CV_32F, cvflann::FLANN_DIST_L1, 1.5f);
+}
+
+TEST(Flann_IncrementalIndex, linear)
+{
+    testIncrementalIndex(flann::LinearIndexParams(), flann::SearchParams(),
+                         CV_32F, cvflann::FLANN_DIST_L2, 2.f);
+}
+
+TEST(Flann_IncrementalIndex, lsh)
+{
+    testIncrementalIndex(flann::LshIndexParams(6, 12, 1), flann::SearchParams(),
+                         CV_8U, cvflann::FLANN_DIST_HAMMING, 2.f);
+}
+
+TEST(Flann_IncrementalIndex, hnsw)
+{
+    testIncrementalIndex(flann::HNSWIndexParams(8, 50), flann::SearchParams(64),
+                         CV_32F, cvflann::FLANN_DIST_L2, 2.f);
+}
+
+TEST(Flann_IncrementalIndex, hnsw_hamming)
+{
+    testIncrementalIndex(flann::HNSWIndexParams(8, 50), flann::SearchParams(64),
+                         CV_8U, cvflann::FLANN_DIST_HAMMING, 2.f);
+}
+
+TEST(Flann_IncrementalIndex, kdtree_background_rebuild)
+{
+    testBackgroundRebuild(flann::KDTreeIndexParams(2));
+}
+
+TEST(Flann_IncrementalIndex, kmeans_background_rebuild)
+{
+    testBackgroundRebuild(flann::KMeansIndexParams(8));
+}
@@ -0,0 +1,129 @@
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Points around 100 centers, the queries are noisy copies of some of them.
+static void makeData(Mat& data, Mat& queries, vector<int>& origins)
+{
+    RNG rng(0x5678);
+    const int count = 20000, dims = 32, clusters = 100;
+
+    Mat centers(clusters, dims, CV_32F);
+    rng.fill(centers, RNG::UNIFORM, 0.f, 10.f);
+    data.create(count, dims, CV_32F);
+    for (int i = 0; i < count; i++)
+    {
+        Mat row = data.row(i);
+        rng.fill(row, RNG::NORMAL, 0.f, 1.f);
+        row += centers.row(rng.uniform(0, clusters));
+    }
+
+    queries.create(200, dims, CV_32F);
+    origins.resize(queries.rows);
+    for (int i = 0; i < queries.rows; i++)
+    {
+        origins[i] = rng.uniform(0, count);
+        Mat row = queries.row(i);
+        rng.fill(row, RNG::NORMAL, 0.f, 0.05f);
+        row += data.row(origins[i]);
+    }
+}
+
+// Share of the queries whose origin is among the knn neighbours found
+static double recall(const Mat& indices, const vector<int>& origins)
+{
+    int found = 0;
+    for (int i = 0; i < indices.rows; i++)
+        for (int j = 0; j < indices.cols; j++)
+            if (indices.at<int>(i, j) == origins[i])
+            {
+                found++;
+                break;
+            }
+    return (double)found / indices.rows;
+}
+
+}
+
+TEST(Flann_IVFPQIndex, accuracy)
+{
+    Mat data, queries, indices, dists;
+    vector<int> origins;
+    makeData(data, queries, origins);
+
+    flann::Index index(data, flann::IVFPQIndexParams(64, 8));
+    EXPECT_EQ(cvflann::FLANN_INDEX_IVFPQ, index.getAlgorithm());
+
+    index.knnSearch(queries, indices, dists, 10, flann::SearchParams(2000));
+    EXPECT_GT(recall(indices, origins), 0.9);
+    for (int i = 0; i < queries.rows; i++)
+        for (int j = 1; j < indices.cols; j++)
+            EXPECT_LE(dists.at<float>(i, j - 1), dists.at<float>(i, j));
+
+    index.knnSearch(queries, indices, dists, 10, flann::SearchParams(-1));
+    EXPECT_GT(recall(indices, origins), 0.9);
+
+    Mat l1indices;
+    flann::Index l1index(data, flann::IVFPQIndexParams(64, 8), cvflann::FLANN_DIST_L1);
+    l1index.knnSearch(queries, l1indices, dists, 10, flann::SearchParams(2000));
+    EXPECT_GT(recall(l1indices, origins), 0.9);
+}
+
+TEST(Flann_IVFPQIndex, memory)
+{
+    Mat data, queries;
+    vector<int> origins;
+    makeData(data, queries, origins);
+
+    cvflann::Matrix<float> dataset((float*)data.data, data.rows, data.cols);
+    cvflann::IVFPQIndex< cvflann::L2<float> > index(dataset, cvflann::IVFPQIndexParams(64, 8));
+    index.buildIndex();
+
+    // 8 bytes of codes and an id per point, the quantizers take about 70KB
+    size_t dataSize = data.total() * data.elemSize();
+    EXPECT_LT((size_t)index.usedMemory(), dataSize / 6);
+}
+
+TEST(Flann_IVFPQIndex, saveLoadAddRemove)
+{
+    Mat data, queries, indices, dists;
+    vector<int> origins;
+    makeData(data, queries, origins);
+
+    const int initial = data.rows / 2;
+    flann::Index index(data.rowRange(0, initial), flann::IVFPQIndexParams(64, 8));
+    index.addPoints(data.rowRange(initial, data.rows));
+    for (int i = 0; i < queries.rows; i += 2)
+        index.removePoint(origins[i]);
+
+    flann::SearchParams searchParams(2000);
+    index.knnSearch(queries, indices, dists, 10, searchParams);
+    for (int i = 0; i < queries.rows; i++)
+        for (int j = 0; j < indices.cols; j++)
+            if (i % 2 == 0)
+                EXPECT_NE(origins[i], indices.at<int>(i, j)) << "query " << i;
+
+    string filename = tempfile(".flann");
+    index.save(filename);
+
+    // the codes are saved, so the data is not needed
+    flann::Index loaded;
+    ASSERT_TRUE(loaded.load(noArray(), filename));
+    remove(filename.c_str());
+
+    Mat loadedIndices, loadedDists;
+    loaded.knnSearch(queries, loadedIndices, loadedDists, 10, searchParams);
+    EXPECT_EQ(0, cvtest::norm(indices, loadedIndices, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(dists, loadedDists, NORM_INF));
+
+    // the codes of the added points do not reference them either
+    Mat more = data.rowRange(0, 100).clone();
+    loaded.addPoints(more);
+    more.release();
+    loaded.knnSearch(data.rowRange(1, 2), loadedIndices, loadedDists, 2, searchParams);
+    EXPECT_TRUE(loadedIndices.at<int>(0, 0) == 1 || loadedIndices.at<int>(0, 0) == data.rows + 1);
+    EXPECT_TRUE(loadedIndices.at<int>(0, 1) == 1 || loadedIndices.at<int>(0, 1) == data.rows + 1);
+}
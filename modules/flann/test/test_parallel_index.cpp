@@ -0,0 +1,109 @@
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// The dataset is large enough for the indices to build their subtrees in parallel;
+// the batch searches, which run in parallel, must return what the single queries return.
+static void testParallelIndex(const flann::IndexParams& indexParams)
+{
+    RNG rng(0x4321);
+    Mat data(30000, 8, CV_32F);
+    rng.fill(data, RNG::UNIFORM, 0.f, 1.f);
+
+    flann::Index index(data, indexParams);
+    flann::SearchParams searchParams(2000);
+
+    Mat queries = data.rowRange(0, 300).clone();
+    Mat indices, dists;
+    index.knnSearch(queries, indices, dists, 3, searchParams);
+    ASSERT_EQ(queries.rows, indices.rows);
+
+    const float radius = 0.05f;
+    Mat rindices, rdists;
+    int total = index.radiusSearch(queries, rindices, rdists, radius, 50, searchParams);
+
+    int expectedTotal = 0;
+    for (int i = 0; i < queries.rows; i++)
+    {
+        EXPECT_EQ(i, indices.at<int>(i, 0)) << "query " << i;
+
+        Mat qindices, qdists;
+        index.knnSearch(queries.row(i), qindices, qdists, 3, searchParams);
+        for (int j = 0; j < 3; j++)
+            EXPECT_EQ(qindices.at<int>(0, j), indices.at<int>(i, j)) << "query " << i;
+
+        int count = index.radiusSearch(queries.row(i), qindices, qdists, radius, 50, searchParams);
+        expectedTotal += count;
+        for (int j = 0; j < std::min(count, 50); j++)
+            EXPECT_EQ(qindices.at<int>(0, j), rindices.at<int>(i, j)) << "query " << i;
+        for (int j = count; j < 50; j++)
+            EXPECT_EQ(-1, rindices.at<int>(i, j)) << "query " << i;
+    }
+    EXPECT_EQ(expectedTotal, total);
+}
+
+// builds the index from the same seed with one and with several threads; the trees
+// are compared through the approximate search, which depends on their shape
+static void testParallelBuildRepeatable(const flann::IndexParams& indexParams)
+{
+    RNG rng(0x1234);
+    Mat data(20000, 8, CV_32F);
+    rng.fill(data, RNG::UNIFORM, 0.f, 1.f);
+    Mat queries(200, 8, CV_32F);
+    rng.fill(queries, RNG::UNIFORM, 0.f, 1.f);
+    flann::SearchParams searchParams(16);
+
+    int nthreads = getNumThreads();
+    Mat indices[2], dists[2];
+    for (int k = 0; k < 2; k++)
+    {
+        setNumThreads(k == 0 ? 1 : std::max(nthreads, 4));
+        cvflann::seed_random(77);
+        flann::Index index(data, indexParams);
+        setNumThreads(1);
+        index.knnSearch(queries, indices[k], dists[k], 5, searchParams);
+    }
+    setNumThreads(nthreads);
+
+    EXPECT_EQ(0, cvtest::norm(indices[0], indices[1], NORM_INF));
+}
+
+}
+
+TEST(Flann_ParallelIndex, kdtree)
+{
+    testParallelIndex(flann::KDTreeIndexParams(4));
+}
+
+TEST(Flann_ParallelIndex, kmeans)
+{
+    testParallelIndex(flann::KMeansIndexParams(16, 5));
+}
+
+TEST(Flann_ParallelIndex, hierarchical)
+{
+    testParallelIndex(flann::HierarchicalClusteringIndexParams(16));
+}
+
+TEST(Flann_ParallelIndex, hnsw)
+{
+    testParallelIndex(flann::HNSWIndexParams());
+}
+
+TEST(Flann_ParallelIndex, kdtree_repeatable)
+{
+    testParallelBuildRepeatable(flann::KDTreeIndexParams(4));
+}
+
+TEST(Flann_ParallelIndex, kmeans_repeatable)
+{
+    testParallelBuildRepeatable(flann::KMeansIndexParams(16, 5));
+}
+
+TEST(Flann_ParallelIndex, hierarchical_repeatable)
+{
+    testParallelBuildRepeatable(flann::HierarchicalClusteringIndexParams(16));
+}
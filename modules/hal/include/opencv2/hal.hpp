@@ -53,6 +53,11 @@
 
 namespace cv { namespace hal {
 
+// The HAL detects the instruction sets it dispatches to (AVX2) by itself; setUseOptimized(false)
+// restricts it to the baseline code. cv::setUseOptimized() forwards here.
+void setUseOptimized(bool onoff);
+bool useOptimized();
+
 namespace Error {
 
 enum
@@ -76,6 +81,29 @@ int LU(double* A, size_t astep, int m, double* b, size_t bstep, int n);
 bool Cholesky(float* A, size_t astep, int m, float* b, size_t bstep, int n);
 bool Cholesky(double* A, size_t astep, int m, double* b, size_t bstep, int n);
 
+// Batched versions of the decompositions for many small matrices of the same size, processing
+// several matrices at once with SIMD instructions. The matrices are stored as structure of arrays:
+// element (i, j) of the k-th matrix is ((_Tp*)((uchar*)A + (i*cols + j)*astep))[k], i.e. astep is
+// the distance in bytes between the planes holding the same element of all the count matrices.
+// The same layout is used for the right-hand sides and for the outputs.
+//
+// LUBatch and CholeskyBatch work like LU and Cholesky; info[k], if not NULL, receives the
+// result for the k-th matrix (the permutation sign or 0 for LU, 1 or 0 for Cholesky).
+// eigenBatch computes the eigenvalues in descending order and, if v is not NULL, the eigenvectors
+// (stored as rows) of symmetric m x m matrices. SVDBatch decomposes m x n matrices into u*diag(w)*vt
+// with n singular values in descending order; u (m x n) and vt (n x n) may be NULL.
+// eigenBatch and SVDBatch destroy A.
+void LUBatch(float* A, size_t astep, int m, float* b, size_t bstep, int n, int count, int* info);
+void LUBatch(double* A, size_t astep, int m, double* b, size_t bstep, int n, int count, int* info);
+void CholeskyBatch(float* A, size_t astep, int m, float* b, size_t bstep, int n, int count, int* info);
+void CholeskyBatch(double* A, size_t astep, int m, double* b, size_t bstep, int n, int count, int* info);
+void eigenBatch(float* A, size_t astep, int m, float* w, size_t wstep, float* v, size_t vstep, int count);
+void eigenBatch(double* A, size_t astep, int m, double* w, size_t wstep, double* v, size_t vstep, int count);
+void SVDBatch(float* A, size_t astep, int m, int n, float* w, size_t wstep,
+              float* u, size_t ustep, float* vt, size_t vtstep, int count);
+void SVDBatch(double* A, size_t astep, int m, int n, double* w, size_t wstep,
+              double* u, size_t ustep, double* vt, size_t vtstep, int count);
+
 int normL1_(const uchar* a, const uchar* b, int n);
 float normL1_(const float* a, const float* b, int n);
 float normL2Sqr_(const float* a, const float* b, int n);
@@ -54,6 +54,17 @@
 #define OPENCV_HAL_NOP(a) (a)
 #define OPENCV_HAL_1ST(a, b) (a)
 
+// The intrinsics are inline functions, so the same symbol may be emitted by a translation
+// unit compiled with the baseline instruction set and by one compiled for a wider dispatched
+// target (e.g. *.avx2.cpp). Each target gets its own nested namespace to keep them apart.
+#if CV_AVX2
+#  define CV_CPU_OPTIMIZATION_HAL_NAMESPACE hal_AVX2
+#else
+#  define CV_CPU_OPTIMIZATION_HAL_NAMESPACE hal_baseline
+#endif
+#define CV_CPU_OPTIMIZATION_HAL_NAMESPACE_BEGIN namespace CV_CPU_OPTIMIZATION_HAL_NAMESPACE {
+#define CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END }
+
 // unlike HAL API, which is in cv::hal,
 // we put intrinsics into cv namespace to make its
 // access from within opencv code more accessible
@@ -281,6 +292,18 @@ template<> struct V_TypeTraits<double>
 
 #endif
 
+// 256-bit registers are available only in the code compiled with AVX2 enabled,
+// either globally (ENABLE_AVX2) or in the dispatched *.avx2.cpp sources
+#if CV_AVX2
+
+#include "opencv2/hal/intrin_avx.hpp"
+
+#endif
+
+namespace cv {
+using namespace CV_CPU_OPTIMIZATION_HAL_NAMESPACE;
+}
+
 #ifndef CV_SIMD128
 #define CV_SIMD128 0
 #endif
@@ -289,4 +312,12 @@ template<> struct V_TypeTraits<double>
 #define CV_SIMD128_64F 0
 #endif
 
+#ifndef CV_SIMD256
+#define CV_SIMD256 0
+#endif
+
+#ifndef CV_SIMD256_64F
+#define CV_SIMD256_64F 0
+#endif
+
 #endif
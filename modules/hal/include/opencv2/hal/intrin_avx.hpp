@@ -0,0 +1,1296 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                          License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009, Willow Garage Inc., all rights reserved.
+// Copyright (C) 2013, OpenCV Foundation, all rights reserved.
+// Copyright (C) 2015, Itseez Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#ifndef __OPENCV_HAL_AVX_HPP__
+#define __OPENCV_HAL_AVX_HPP__
+
+#define CV_SIMD256 1
+#define CV_SIMD256_64F 1
+
+namespace cv
+{
+
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_BEGIN
+
+///////// Utils ////////////
+
+inline __m256i _v256_combine(const __m128i& lo, const __m128i& hi)
+{ return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1); }
+
+inline __m256 _v256_combine(const __m128& lo, const __m128& hi)
+{ return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1); }
+
+inline __m256d _v256_combine(const __m128d& lo, const __m128d& hi)
+{ return _mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1); }
+
+inline __m128i _v256_extract_low(const __m256i& v)
+{ return _mm256_castsi256_si128(v); }
+
+inline __m128 _v256_extract_low(const __m256& v)
+{ return _mm256_castps256_ps128(v); }
+
+inline __m128d _v256_extract_low(const __m256d& v)
+{ return _mm256_castpd256_pd128(v); }
+
+inline __m128i _v256_extract_high(const __m256i& v)
+{ return _mm256_extracti128_si256(v, 1); }
+
+inline __m128 _v256_extract_high(const __m256& v)
+{ return _mm256_extractf128_ps(v, 1); }
+
+inline __m128d _v256_extract_high(const __m256d& v)
+{ return _mm256_extractf128_pd(v, 1); }
+
+// AVX2 pack/unpack instructions operate on each 128-bit lane separately;
+// this restores the natural order of 64-bit blocks after a lane-wise pack
+inline __m256i _v256_shuffle_odd_64(const __m256i& v)
+{ return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)); }
+
+// concatenates b:a and shifts the result right by imm bytes, 0 <= imm <= 32
+template<int imm>
+inline __m256i _v256_alignr_b(const __m256i& a, const __m256i& b)
+{
+    if( imm >= 32 )
+        return b;
+    __m256i t = _mm256_permute2x128_si256(a, b, 0x21); // a_hi b_lo
+    if( imm < 16 )
+        return _mm256_alignr_epi8(t, a, imm & 15);
+    return _mm256_alignr_epi8(b, t, imm & 15);
+}
+
+struct v_uint8x32
+{
+    typedef uchar lane_type;
+    enum { nlanes = 32 };
+
+    v_uint8x32() {}
+    explicit v_uint8x32(__m256i v) : val(v) {}
+    v_uint8x32(uchar v0, uchar v1, uchar v2, uchar v3, uchar v4, uchar v5, uchar v6, uchar v7,
+               uchar v8, uchar v9, uchar v10, uchar v11, uchar v12, uchar v13, uchar v14, uchar v15,
+               uchar v16, uchar v17, uchar v18, uchar v19, uchar v20, uchar v21, uchar v22, uchar v23,
+               uchar v24, uchar v25, uchar v26, uchar v27, uchar v28, uchar v29, uchar v30, uchar v31)
+    {
+        val = _mm256_setr_epi8((char)v0, (char)v1, (char)v2, (char)v3,
+                               (char)v4, (char)v5, (char)v6, (char)v7,
+                               (char)v8, (char)v9, (char)v10, (char)v11,
+                               (char)v12, (char)v13, (char)v14, (char)v15,
+                               (char)v16, (char)v17, (char)v18, (char)v19,
+                               (char)v20, (char)v21, (char)v22, (char)v23,
+                               (char)v24, (char)v25, (char)v26, (char)v27,
+                               (char)v28, (char)v29, (char)v30, (char)v31);
+    }
+    uchar get0() const
+    {
+        return (uchar)_mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+    }
+
+    __m256i val;
+};
+
+struct v_int8x32
+{
+    typedef schar lane_type;
+    enum { nlanes = 32 };
+
+    v_int8x32() {}
+    explicit v_int8x32(__m256i v) : val(v) {}
+    v_int8x32(schar v0, schar v1, schar v2, schar v3, schar v4, schar v5, schar v6, schar v7,
+              schar v8, schar v9, schar v10, schar v11, schar v12, schar v13, schar v14, schar v15,
+              schar v16, schar v17, schar v18, schar v19, schar v20, schar v21, schar v22, schar v23,
+              schar v24, schar v25, schar v26, schar v27, schar v28, schar v29, schar v30, schar v31)
+    {
+        val = _mm256_setr_epi8((char)v0, (char)v1, (char)v2, (char)v3,
+                               (char)v4, (char)v5, (char)v6, (char)v7,
+                               (char)v8, (char)v9, (char)v10, (char)v11,
+                               (char)v12, (char)v13, (char)v14, (char)v15,
+                               (char)v16, (char)v17, (char)v18, (char)v19,
+                               (char)v20, (char)v21, (char)v22, (char)v23,
+                               (char)v24, (char)v25, (char)v26, (char)v27,
+                               (char)v28, (char)v29, (char)v30, (char)v31);
+    }
+    schar get0() const
+    {
+        return (schar)_mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+    }
+
+    __m256i val;
+};
+
+struct v_uint16x16
+{
+    typedef ushort lane_type;
+    enum { nlanes = 16 };
+
+    v_uint16x16() {}
+    explicit v_uint16x16(__m256i v) : val(v) {}
+    v_uint16x16(ushort v0, ushort v1, ushort v2, ushort v3, ushort v4, ushort v5, ushort v6, ushort v7,
+                ushort v8, ushort v9, ushort v10, ushort v11, ushort v12, ushort v13, ushort v14, ushort v15)
+    {
+        val = _mm256_setr_epi16((short)v0, (short)v1, (short)v2, (short)v3,
+                                (short)v4, (short)v5, (short)v6, (short)v7,
+                                (short)v8, (short)v9, (short)v10, (short)v11,
+                                (short)v12, (short)v13, (short)v14, (short)v15);
+    }
+    ushort get0() const
+    {
+        return (ushort)_mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+    }
+
+    __m256i val;
+};
+
+struct v_int16x16
+{
+    typedef short lane_type;
+    enum { nlanes = 16 };
+
+    v_int16x16() {}
+    explicit v_int16x16(__m256i v) : val(v) {}
+    v_int16x16(short v0, short v1, short v2, short v3, short v4, short v5, short v6, short v7,
+               short v8, short v9, short v10, short v11, short v12, short v13, short v14, short v15)
+    {
+        val = _mm256_setr_epi16(v0, v1, v2, v3, v4, v5, v6, v7,
+                                v8, v9, v10, v11, v12, v13, v14, v15);
+    }
+    short get0() const
+    {
+        return (short)_mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+    }
+    __m256i val;
+};
+
+struct v_uint32x8
+{
+    typedef unsigned lane_type;
+    enum { nlanes = 8 };
+
+    v_uint32x8() {}
+    explicit v_uint32x8(__m256i v) : val(v) {}
+    v_uint32x8(unsigned v0, unsigned v1, unsigned v2, unsigned v3,
+               unsigned v4, unsigned v5, unsigned v6, unsigned v7)
+    {
+        val = _mm256_setr_epi32((int)v0, (int)v1, (int)v2, (int)v3,
+                                (int)v4, (int)v5, (int)v6, (int)v7);
+    }
+    unsigned get0() const
+    {
+        return (unsigned)_mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+    }
+    __m256i val;
+};
+
+struct v_int32x8
+{
+    typedef int lane_type;
+    enum { nlanes = 8 };
+
+    v_int32x8() {}
+    explicit v_int32x8(__m256i v) : val(v) {}
+    v_int32x8(int v0, int v1, int v2, int v3, int v4, int v5, int v6, int v7)
+    {
+        val = _mm256_setr_epi32(v0, v1, v2, v3, v4, v5, v6, v7);
+    }
+    int get0() const
+    {
+        return _mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+    }
+    __m256i val;
+};
+
+struct v_float32x8
+{
+    typedef float lane_type;
+    enum { nlanes = 8 };
+
+    v_float32x8() {}
+    explicit v_float32x8(__m256 v) : val(v) {}
+    v_float32x8(float v0, float v1, float v2, float v3,
+                float v4, float v5, float v6, float v7)
+    {
+        val = _mm256_setr_ps(v0, v1, v2, v3, v4, v5, v6, v7);
+    }
+    float get0() const
+    {
+        return _mm_cvtss_f32(_mm256_castps256_ps128(val));
+    }
+    __m256 val;
+};
+
+struct v_uint64x4
+{
+    typedef uint64 lane_type;
+    enum { nlanes = 4 };
+
+    v_uint64x4() {}
+    explicit v_uint64x4(__m256i v) : val(v) {}
+    v_uint64x4(uint64 v0, uint64 v1, uint64 v2, uint64 v3)
+    {
+        val = _mm256_setr_epi32((int)v0, (int)(v0 >> 32), (int)v1, (int)(v1 >> 32),
+                                (int)v2, (int)(v2 >> 32), (int)v3, (int)(v3 >> 32));
+    }
+    uint64 get0() const
+    {
+        __m128i v = _mm256_castsi256_si128(val);
+        int a = _mm_cvtsi128_si32(v);
+        int b = _mm_cvtsi128_si32(_mm_srli_epi64(v, 32));
+        return (unsigned)a | ((uint64)(unsigned)b << 32);
+    }
+    __m256i val;
+};
+
+struct v_int64x4
+{
+    typedef int64 lane_type;
+    enum { nlanes = 4 };
+
+    v_int64x4() {}
+    explicit v_int64x4(__m256i v) : val(v) {}
+    v_int64x4(int64 v0, int64 v1, int64 v2, int64 v3)
+    {
+        val = _mm256_setr_epi32((int)v0, (int)(v0 >> 32), (int)v1, (int)(v1 >> 32),
+                                (int)v2, (int)(v2 >> 32), (int)v3, (int)(v3 >> 32));
+    }
+    int64 get0() const
+    {
+        __m128i v = _mm256_castsi256_si128(val);
+        int a = _mm_cvtsi128_si32(v);
+        int b = _mm_cvtsi128_si32(_mm_srli_epi64(v, 32));
+        return (int64)((unsigned)a | ((uint64)(unsigned)b << 32));
+    }
+    __m256i val;
+};
+
+struct v_float64x4
+{
+    typedef double lane_type;
+    enum { nlanes = 4 };
+
+    v_float64x4() {}
+    explicit v_float64x4(__m256d v) : val(v) {}
+    v_float64x4(double v0, double v1, double v2, double v3)
+    {
+        val = _mm256_setr_pd(v0, v1, v2, v3);
+    }
+    double get0() const
+    {
+        return _mm_cvtsd_f64(_mm256_castpd256_pd128(val));
+    }
+    __m256d val;
+};
+
+//////////////// Initialization and reinterpretation ///////////////
+
+#define OPENCV_HAL_IMPL_AVX_INITVEC(_Tpvec, _Tp, suffix, zsuffix, ssuffix, _Tps) \
+inline _Tpvec v256_setzero_##suffix() { return _Tpvec(_mm256_setzero_##zsuffix()); } \
+inline _Tpvec v256_setall_##suffix(_Tp v) { return _Tpvec(_mm256_set1_##ssuffix((_Tps)v)); }
+
+OPENCV_HAL_IMPL_AVX_INITVEC(v_uint8x32, uchar, u8, si256, epi8, char)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_int8x32, schar, s8, si256, epi8, char)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_uint16x16, ushort, u16, si256, epi16, short)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_int16x16, short, s16, si256, epi16, short)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_uint32x8, unsigned, u32, si256, epi32, int)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_int32x8, int, s32, si256, epi32, int)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_float32x8, float, f32, ps, ps, float)
+OPENCV_HAL_IMPL_AVX_INITVEC(v_float64x4, double, f64, pd, pd, double)
+
+inline v_uint64x4 v256_setzero_u64() { return v_uint64x4(_mm256_setzero_si256()); }
+inline v_int64x4 v256_setzero_s64() { return v_int64x4(_mm256_setzero_si256()); }
+inline v_uint64x4 v256_setall_u64(uint64 val) { return v_uint64x4(val, val, val, val); }
+inline v_int64x4 v256_setall_s64(int64 val) { return v_int64x4(val, val, val, val); }
+
+// the 128-bit backend defines v_reinterpret_as_* as templates over any source type,
+// so the 256-bit variants are spelled out as non-template overloads that take precedence
+#define OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, _Tpsvec, cast) \
+inline _Tpvec v_reinterpret_as_##suffix(const _Tpsvec& a) \
+{ return _Tpvec(cast(a.val)); }
+
+#define OPENCV_HAL_IMPL_AVX_CAST_INT(_Tpvec, suffix) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint8x32, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int8x32, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint16x16, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int16x16, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint32x8, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int32x8, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint64x4, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int64x4, OPENCV_HAL_NOP) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_float32x8, _mm256_castps_si256) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_float64x4, _mm256_castpd_si256)
+
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_uint8x32, u8)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_int8x32, s8)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_uint16x16, u16)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_int16x16, s16)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_uint32x8, u32)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_int32x8, s32)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_uint64x4, u64)
+OPENCV_HAL_IMPL_AVX_CAST_INT(v_int64x4, s64)
+
+#define OPENCV_HAL_IMPL_AVX_CAST_FLT(_Tpvec, suffix, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint8x32, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int8x32, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint16x16, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int16x16, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint32x8, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int32x8, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_uint64x4, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, v_int64x4, cast_from_int) \
+OPENCV_HAL_IMPL_AVX_CAST(_Tpvec, suffix, _Tpvec, OPENCV_HAL_NOP)
+
+OPENCV_HAL_IMPL_AVX_CAST_FLT(v_float32x8, f32, _mm256_castsi256_ps)
+OPENCV_HAL_IMPL_AVX_CAST(v_float32x8, f32, v_float64x4, _mm256_castpd_ps)
+OPENCV_HAL_IMPL_AVX_CAST_FLT(v_float64x4, f64, _mm256_castsi256_pd)
+OPENCV_HAL_IMPL_AVX_CAST(v_float64x4, f64, v_float32x8, _mm256_castps_pd)
+
+//////////////// Conversions between 128-bit and 256-bit registers ///////////////
+
+#define OPENCV_HAL_IMPL_AVX_HALVES(_Tpvec, _Tpvec128) \
+inline _Tpvec128 v_get_low(const _Tpvec& a) \
+{ return _Tpvec128(_v256_extract_low(a.val)); } \
+inline _Tpvec128 v_get_high(const _Tpvec& a) \
+{ return _Tpvec128(_v256_extract_high(a.val)); } \
+inline _Tpvec v256_combine(const _Tpvec128& a, const _Tpvec128& b) \
+{ return _Tpvec(_v256_combine(a.val, b.val)); }
+
+OPENCV_HAL_IMPL_AVX_HALVES(v_uint8x32, v_uint8x16)
+OPENCV_HAL_IMPL_AVX_HALVES(v_int8x32, v_int8x16)
+OPENCV_HAL_IMPL_AVX_HALVES(v_uint16x16, v_uint16x8)
+OPENCV_HAL_IMPL_AVX_HALVES(v_int16x16, v_int16x8)
+OPENCV_HAL_IMPL_AVX_HALVES(v_uint32x8, v_uint32x4)
+OPENCV_HAL_IMPL_AVX_HALVES(v_int32x8, v_int32x4)
+OPENCV_HAL_IMPL_AVX_HALVES(v_uint64x4, v_uint64x2)
+OPENCV_HAL_IMPL_AVX_HALVES(v_int64x4, v_int64x2)
+OPENCV_HAL_IMPL_AVX_HALVES(v_float32x8, v_float32x4)
+OPENCV_HAL_IMPL_AVX_HALVES(v_float64x4, v_float64x2)
+
+//////////////// PACK ///////////////
+
+inline v_uint8x32 v_pack(const v_uint16x16& a, const v_uint16x16& b)
+{
+    __m256i delta = _mm256_set1_epi16(255);
+    return v_uint8x32(_v256_shuffle_odd_64(_mm256_packus_epi16(_mm256_min_epu16(a.val, delta),
+                                                               _mm256_min_epu16(b.val, delta))));
+}
+
+inline void v_pack_store(uchar* ptr, const v_uint16x16& a)
+{
+    __m256i a1 = _mm256_min_epu16(a.val, _mm256_set1_epi16(255));
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi16(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+inline v_uint8x32 v_pack_u(const v_int16x16& a, const v_int16x16& b)
+{ return v_uint8x32(_v256_shuffle_odd_64(_mm256_packus_epi16(a.val, b.val))); }
+
+inline void v_pack_u_store(uchar* ptr, const v_int16x16& a)
+{
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi16(a.val, a.val));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+template<int n> inline
+v_uint8x32 v_rshr_pack(const v_uint16x16& a, const v_uint16x16& b)
+{
+    // we assume that n > 0, and so the shifted 16-bit values can be treated as signed numbers.
+    __m256i delta = _mm256_set1_epi16((short)(1 << (n-1)));
+    return v_uint8x32(_v256_shuffle_odd_64(
+        _mm256_packus_epi16(_mm256_srli_epi16(_mm256_adds_epu16(a.val, delta), n),
+                            _mm256_srli_epi16(_mm256_adds_epu16(b.val, delta), n))));
+}
+
+template<int n> inline
+void v_rshr_pack_store(uchar* ptr, const v_uint16x16& a)
+{
+    __m256i delta = _mm256_set1_epi16((short)(1 << (n-1)));
+    __m256i a1 = _mm256_srli_epi16(_mm256_adds_epu16(a.val, delta), n);
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi16(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+template<int n> inline
+v_uint8x32 v_rshr_pack_u(const v_int16x16& a, const v_int16x16& b)
+{
+    __m256i delta = _mm256_set1_epi16((short)(1 << (n-1)));
+    return v_uint8x32(_v256_shuffle_odd_64(
+        _mm256_packus_epi16(_mm256_srai_epi16(_mm256_adds_epi16(a.val, delta), n),
+                            _mm256_srai_epi16(_mm256_adds_epi16(b.val, delta), n))));
+}
+
+template<int n> inline
+void v_rshr_pack_u_store(uchar* ptr, const v_int16x16& a)
+{
+    __m256i delta = _mm256_set1_epi16((short)(1 << (n-1)));
+    __m256i a1 = _mm256_srai_epi16(_mm256_adds_epi16(a.val, delta), n);
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi16(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+inline v_int8x32 v_pack(const v_int16x16& a, const v_int16x16& b)
+{ return v_int8x32(_v256_shuffle_odd_64(_mm256_packs_epi16(a.val, b.val))); }
+
+inline void v_pack_store(schar* ptr, const v_int16x16& a)
+{
+    __m256i r = _v256_shuffle_odd_64(_mm256_packs_epi16(a.val, a.val));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+template<int n> inline
+v_int8x32 v_rshr_pack(const v_int16x16& a, const v_int16x16& b)
+{
+    // we assume that n > 0, and so the shifted 16-bit values can be treated as signed numbers.
+    __m256i delta = _mm256_set1_epi16((short)(1 << (n-1)));
+    return v_int8x32(_v256_shuffle_odd_64(
+        _mm256_packs_epi16(_mm256_srai_epi16(_mm256_adds_epi16(a.val, delta), n),
+                           _mm256_srai_epi16(_mm256_adds_epi16(b.val, delta), n))));
+}
+
+template<int n> inline
+void v_rshr_pack_store(schar* ptr, const v_int16x16& a)
+{
+    __m256i delta = _mm256_set1_epi16((short)(1 << (n-1)));
+    __m256i a1 = _mm256_srai_epi16(_mm256_adds_epi16(a.val, delta), n);
+    __m256i r = _v256_shuffle_odd_64(_mm256_packs_epi16(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+inline v_uint16x16 v_pack(const v_uint32x8& a, const v_uint32x8& b)
+{
+    __m256i delta = _mm256_set1_epi32(65535);
+    return v_uint16x16(_v256_shuffle_odd_64(_mm256_packus_epi32(_mm256_min_epu32(a.val, delta),
+                                                                _mm256_min_epu32(b.val, delta))));
+}
+
+inline void v_pack_store(ushort* ptr, const v_uint32x8& a)
+{
+    __m256i a1 = _mm256_min_epu32(a.val, _mm256_set1_epi32(65535));
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi32(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+template<int n> inline
+v_uint16x16 v_rshr_pack(const v_uint32x8& a, const v_uint32x8& b)
+{
+    __m256i delta = _mm256_set1_epi32(1 << (n-1)), maxval = _mm256_set1_epi32(65535);
+    __m256i a1 = _mm256_min_epu32(_mm256_srli_epi32(_mm256_add_epi32(a.val, delta), n), maxval);
+    __m256i b1 = _mm256_min_epu32(_mm256_srli_epi32(_mm256_add_epi32(b.val, delta), n), maxval);
+    return v_uint16x16(_v256_shuffle_odd_64(_mm256_packus_epi32(a1, b1)));
+}
+
+template<int n> inline
+void v_rshr_pack_store(ushort* ptr, const v_uint32x8& a)
+{
+    __m256i delta = _mm256_set1_epi32(1 << (n-1)), maxval = _mm256_set1_epi32(65535);
+    __m256i a1 = _mm256_min_epu32(_mm256_srli_epi32(_mm256_add_epi32(a.val, delta), n), maxval);
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi32(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+inline v_uint16x16 v_pack_u(const v_int32x8& a, const v_int32x8& b)
+{ return v_uint16x16(_v256_shuffle_odd_64(_mm256_packus_epi32(a.val, b.val))); }
+
+inline void v_pack_u_store(ushort* ptr, const v_int32x8& a)
+{
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi32(a.val, a.val));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+template<int n> inline
+v_uint16x16 v_rshr_pack_u(const v_int32x8& a, const v_int32x8& b)
+{
+    __m256i delta = _mm256_set1_epi32(1 << (n-1));
+    return v_uint16x16(_v256_shuffle_odd_64(
+        _mm256_packus_epi32(_mm256_srai_epi32(_mm256_add_epi32(a.val, delta), n),
+                            _mm256_srai_epi32(_mm256_add_epi32(b.val, delta), n))));
+}
+
+template<int n> inline
+void v_rshr_pack_u_store(ushort* ptr, const v_int32x8& a)
+{
+    __m256i delta = _mm256_set1_epi32(1 << (n-1));
+    __m256i a1 = _mm256_srai_epi32(_mm256_add_epi32(a.val, delta), n);
+    __m256i r = _v256_shuffle_odd_64(_mm256_packus_epi32(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+inline v_int16x16 v_pack(const v_int32x8& a, const v_int32x8& b)
+{ return v_int16x16(_v256_shuffle_odd_64(_mm256_packs_epi32(a.val, b.val))); }
+
+inline void v_pack_store(short* ptr, const v_int32x8& a)
+{
+    __m256i r = _v256_shuffle_odd_64(_mm256_packs_epi32(a.val, a.val));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+template<int n> inline
+v_int16x16 v_rshr_pack(const v_int32x8& a, const v_int32x8& b)
+{
+    __m256i delta = _mm256_set1_epi32(1 << (n-1));
+    return v_int16x16(_v256_shuffle_odd_64(
+        _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(a.val, delta), n),
+                           _mm256_srai_epi32(_mm256_add_epi32(b.val, delta), n))));
+}
+
+template<int n> inline
+void v_rshr_pack_store(short* ptr, const v_int32x8& a)
+{
+    __m256i delta = _mm256_set1_epi32(1 << (n-1));
+    __m256i a1 = _mm256_srai_epi32(_mm256_add_epi32(a.val, delta), n);
+    __m256i r = _v256_shuffle_odd_64(_mm256_packs_epi32(a1, a1));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(r));
+}
+
+// 64-bit lanes are narrowed by dropping the high 32 bits, as in the 128-bit version
+inline v_uint32x8 v_pack(const v_uint64x4& a, const v_uint64x4& b)
+{
+    __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    __m256i a1 = _mm256_permutevar8x32_epi32(a.val, idx); // a0 a1 a2 a3 x x x x
+    __m256i b1 = _mm256_permutevar8x32_epi32(b.val, idx); // b0 b1 b2 b3 x x x x
+    return v_uint32x8(_mm256_permute2x128_si256(a1, b1, 0x20));
+}
+
+inline void v_pack_store(unsigned* ptr, const v_uint64x4& a)
+{
+    __m256i a1 = _mm256_permutevar8x32_epi32(a.val, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    _mm_storeu_si128((__m128i*)ptr, _mm256_castsi256_si128(a1));
+}
+
+inline v_int32x8 v_pack(const v_int64x4& a, const v_int64x4& b)
+{ return v_reinterpret_as_s32(v_pack(v_reinterpret_as_u64(a), v_reinterpret_as_u64(b))); }
+
+inline void v_pack_store(int* ptr, const v_int64x4& a)
+{ v_pack_store((unsigned*)ptr, v_reinterpret_as_u64(a)); }
+
+#define OPENCV_HAL_IMPL_AVX_BIN_OP(bin_op, _Tpvec, intrin) \
+    inline _Tpvec operator bin_op (const _Tpvec& a, const _Tpvec& b) \
+    { \
+        return _Tpvec(intrin(a.val, b.val)); \
+    } \
+    inline _Tpvec& operator bin_op##= (_Tpvec& a, const _Tpvec& b) \
+    { \
+        a.val = intrin(a.val, b.val); \
+        return a; \
+    }
+
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_uint8x32, _mm256_adds_epu8)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_uint8x32, _mm256_subs_epu8)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_int8x32, _mm256_adds_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_int8x32, _mm256_subs_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_uint16x16, _mm256_adds_epu16)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_uint16x16, _mm256_subs_epu16)
+OPENCV_HAL_IMPL_AVX_BIN_OP(*, v_uint16x16, _mm256_mullo_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_int16x16, _mm256_adds_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_int16x16, _mm256_subs_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_OP(*, v_int16x16, _mm256_mullo_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_uint32x8, _mm256_add_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_uint32x8, _mm256_sub_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_OP(*, v_uint32x8, _mm256_mullo_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_int32x8, _mm256_add_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_int32x8, _mm256_sub_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_OP(*, v_int32x8, _mm256_mullo_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_float32x8, _mm256_add_ps)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_float32x8, _mm256_sub_ps)
+OPENCV_HAL_IMPL_AVX_BIN_OP(*, v_float32x8, _mm256_mul_ps)
+OPENCV_HAL_IMPL_AVX_BIN_OP(/, v_float32x8, _mm256_div_ps)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_float64x4, _mm256_add_pd)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_float64x4, _mm256_sub_pd)
+OPENCV_HAL_IMPL_AVX_BIN_OP(*, v_float64x4, _mm256_mul_pd)
+OPENCV_HAL_IMPL_AVX_BIN_OP(/, v_float64x4, _mm256_div_pd)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_uint64x4, _mm256_add_epi64)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_uint64x4, _mm256_sub_epi64)
+OPENCV_HAL_IMPL_AVX_BIN_OP(+, v_int64x4, _mm256_add_epi64)
+OPENCV_HAL_IMPL_AVX_BIN_OP(-, v_int64x4, _mm256_sub_epi64)
+
+inline void v_mul_expand(const v_int16x16& a, const v_int16x16& b,
+                         v_int32x8& c, v_int32x8& d)
+{
+    __m256i v0 = _mm256_mullo_epi16(a.val, b.val);
+    __m256i v1 = _mm256_mulhi_epi16(a.val, b.val);
+    __m256i t0 = _mm256_unpacklo_epi16(v0, v1);
+    __m256i t1 = _mm256_unpackhi_epi16(v0, v1);
+    c.val = _mm256_permute2x128_si256(t0, t1, 0x20);
+    d.val = _mm256_permute2x128_si256(t0, t1, 0x31);
+}
+
+inline void v_mul_expand(const v_uint16x16& a, const v_uint16x16& b,
+                         v_uint32x8& c, v_uint32x8& d)
+{
+    __m256i v0 = _mm256_mullo_epi16(a.val, b.val);
+    __m256i v1 = _mm256_mulhi_epu16(a.val, b.val);
+    __m256i t0 = _mm256_unpacklo_epi16(v0, v1);
+    __m256i t1 = _mm256_unpackhi_epi16(v0, v1);
+    c.val = _mm256_permute2x128_si256(t0, t1, 0x20);
+    d.val = _mm256_permute2x128_si256(t0, t1, 0x31);
+}
+
+inline void v_mul_expand(const v_uint32x8& a, const v_uint32x8& b,
+                         v_uint64x4& c, v_uint64x4& d)
+{
+    __m256i c0 = _mm256_mul_epu32(a.val, b.val);
+    __m256i c1 = _mm256_mul_epu32(_mm256_srli_epi64(a.val, 32), _mm256_srli_epi64(b.val, 32));
+    __m256i t0 = _mm256_unpacklo_epi64(c0, c1);
+    __m256i t1 = _mm256_unpackhi_epi64(c0, c1);
+    c.val = _mm256_permute2x128_si256(t0, t1, 0x20);
+    d.val = _mm256_permute2x128_si256(t0, t1, 0x31);
+}
+
+inline v_int32x8 v_dotprod(const v_int16x16& a, const v_int16x16& b)
+{
+    return v_int32x8(_mm256_madd_epi16(a.val, b.val));
+}
+
+#define OPENCV_HAL_IMPL_AVX_LOGIC_OP(_Tpvec, suffix, not_const) \
+    OPENCV_HAL_IMPL_AVX_BIN_OP(&, _Tpvec, _mm256_and_##suffix) \
+    OPENCV_HAL_IMPL_AVX_BIN_OP(|, _Tpvec, _mm256_or_##suffix) \
+    OPENCV_HAL_IMPL_AVX_BIN_OP(^, _Tpvec, _mm256_xor_##suffix) \
+    inline _Tpvec operator ~ (const _Tpvec& a) \
+    { \
+        return _Tpvec(_mm256_xor_##suffix(a.val, not_const)); \
+    }
+
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_uint8x32, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_int8x32, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_uint16x16, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_int16x16, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_uint32x8, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_int32x8, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_uint64x4, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_int64x4, si256, _mm256_set1_epi32(-1))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_float32x8, ps, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))
+OPENCV_HAL_IMPL_AVX_LOGIC_OP(v_float64x4, pd, _mm256_castsi256_pd(_mm256_set1_epi32(-1)))
+
+inline v_float32x8 v_sqrt(const v_float32x8& x)
+{ return v_float32x8(_mm256_sqrt_ps(x.val)); }
+
+inline v_float32x8 v_invsqrt(const v_float32x8& x)
+{
+    const __m256 _0_5 = _mm256_set1_ps(0.5f), _1_5 = _mm256_set1_ps(1.5f);
+    __m256 t = x.val;
+    __m256 h = _mm256_mul_ps(t, _0_5);
+    t = _mm256_rsqrt_ps(t);
+    t = _mm256_mul_ps(t, _mm256_sub_ps(_1_5, _mm256_mul_ps(_mm256_mul_ps(t, t), h)));
+    return v_float32x8(t);
+}
+
+inline v_float64x4 v_sqrt(const v_float64x4& x)
+{ return v_float64x4(_mm256_sqrt_pd(x.val)); }
+
+inline v_float64x4 v_invsqrt(const v_float64x4& x)
+{ return v_float64x4(_mm256_div_pd(_mm256_set1_pd(1.), _mm256_sqrt_pd(x.val))); }
+
+inline v_float32x8 v_abs(const v_float32x8& x)
+{ return v_float32x8(_mm256_and_ps(x.val, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)))); }
+inline v_float64x4 v_abs(const v_float64x4& x)
+{
+    return v_float64x4(_mm256_and_pd(x.val,
+        _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_set1_epi32(-1), 1))));
+}
+
+#define OPENCV_HAL_IMPL_AVX_BIN_FUNC(_Tpvec, func, intrin) \
+inline _Tpvec func(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    return _Tpvec(intrin(a.val, b.val)); \
+}
+
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint8x32, v_min, _mm256_min_epu8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint8x32, v_max, _mm256_max_epu8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int8x32, v_min, _mm256_min_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int8x32, v_max, _mm256_max_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint16x16, v_min, _mm256_min_epu16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint16x16, v_max, _mm256_max_epu16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int16x16, v_min, _mm256_min_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int16x16, v_max, _mm256_max_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint32x8, v_min, _mm256_min_epu32)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint32x8, v_max, _mm256_max_epu32)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int32x8, v_min, _mm256_min_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int32x8, v_max, _mm256_max_epi32)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_float32x8, v_min, _mm256_min_ps)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_float32x8, v_max, _mm256_max_ps)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_float64x4, v_min, _mm256_min_pd)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_float64x4, v_max, _mm256_max_pd)
+
+#define OPENCV_HAL_IMPL_AVX_INT_CMP_OP(_Tpuvec, _Tpsvec, suffix, sbit) \
+inline _Tpuvec operator == (const _Tpuvec& a, const _Tpuvec& b) \
+{ return _Tpuvec(_mm256_cmpeq_##suffix(a.val, b.val)); } \
+inline _Tpuvec operator != (const _Tpuvec& a, const _Tpuvec& b) \
+{ \
+    __m256i not_mask = _mm256_set1_epi32(-1); \
+    return _Tpuvec(_mm256_xor_si256(_mm256_cmpeq_##suffix(a.val, b.val), not_mask)); \
+} \
+inline _Tpsvec operator == (const _Tpsvec& a, const _Tpsvec& b) \
+{ return _Tpsvec(_mm256_cmpeq_##suffix(a.val, b.val)); } \
+inline _Tpsvec operator != (const _Tpsvec& a, const _Tpsvec& b) \
+{ \
+    __m256i not_mask = _mm256_set1_epi32(-1); \
+    return _Tpsvec(_mm256_xor_si256(_mm256_cmpeq_##suffix(a.val, b.val), not_mask)); \
+} \
+inline _Tpuvec operator < (const _Tpuvec& a, const _Tpuvec& b) \
+{ \
+    __m256i smask = _mm256_set1_##suffix(sbit); \
+    return _Tpuvec(_mm256_cmpgt_##suffix(_mm256_xor_si256(b.val, smask), _mm256_xor_si256(a.val, smask))); \
+} \
+inline _Tpuvec operator > (const _Tpuvec& a, const _Tpuvec& b) \
+{ \
+    __m256i smask = _mm256_set1_##suffix(sbit); \
+    return _Tpuvec(_mm256_cmpgt_##suffix(_mm256_xor_si256(a.val, smask), _mm256_xor_si256(b.val, smask))); \
+} \
+inline _Tpuvec operator <= (const _Tpuvec& a, const _Tpuvec& b) \
+{ \
+    __m256i smask = _mm256_set1_##suffix(sbit); \
+    __m256i not_mask = _mm256_set1_epi32(-1); \
+    __m256i res = _mm256_cmpgt_##suffix(_mm256_xor_si256(a.val, smask), _mm256_xor_si256(b.val, smask)); \
+    return _Tpuvec(_mm256_xor_si256(res, not_mask)); \
+} \
+inline _Tpuvec operator >= (const _Tpuvec& a, const _Tpuvec& b) \
+{ \
+    __m256i smask = _mm256_set1_##suffix(sbit); \
+    __m256i not_mask = _mm256_set1_epi32(-1); \
+    __m256i res = _mm256_cmpgt_##suffix(_mm256_xor_si256(b.val, smask), _mm256_xor_si256(a.val, smask)); \
+    return _Tpuvec(_mm256_xor_si256(res, not_mask)); \
+} \
+inline _Tpsvec operator < (const _Tpsvec& a, const _Tpsvec& b) \
+{ \
+    return _Tpsvec(_mm256_cmpgt_##suffix(b.val, a.val)); \
+} \
+inline _Tpsvec operator > (const _Tpsvec& a, const _Tpsvec& b) \
+{ \
+    return _Tpsvec(_mm256_cmpgt_##suffix(a.val, b.val)); \
+} \
+inline _Tpsvec operator <= (const _Tpsvec& a, const _Tpsvec& b) \
+{ \
+    __m256i not_mask = _mm256_set1_epi32(-1); \
+    return _Tpsvec(_mm256_xor_si256(_mm256_cmpgt_##suffix(a.val, b.val), not_mask)); \
+} \
+inline _Tpsvec operator >= (const _Tpsvec& a, const _Tpsvec& b) \
+{ \
+    __m256i not_mask = _mm256_set1_epi32(-1); \
+    return _Tpsvec(_mm256_xor_si256(_mm256_cmpgt_##suffix(b.val, a.val), not_mask)); \
+}
+
+OPENCV_HAL_IMPL_AVX_INT_CMP_OP(v_uint8x32, v_int8x32, epi8, (char)-128)
+OPENCV_HAL_IMPL_AVX_INT_CMP_OP(v_uint16x16, v_int16x16, epi16, (short)-32768)
+OPENCV_HAL_IMPL_AVX_INT_CMP_OP(v_uint32x8, v_int32x8, epi32, (int)0x80000000)
+
+#define OPENCV_HAL_IMPL_AVX_FLT_CMP_OP(_Tpvec, suffix) \
+inline _Tpvec operator == (const _Tpvec& a, const _Tpvec& b) \
+{ return _Tpvec(_mm256_cmp_##suffix(a.val, b.val, _CMP_EQ_OQ)); } \
+inline _Tpvec operator != (const _Tpvec& a, const _Tpvec& b) \
+{ return _Tpvec(_mm256_cmp_##suffix(a.val, b.val, _CMP_NEQ_UQ)); } \
+inline _Tpvec operator < (const _Tpvec& a, const _Tpvec& b) \
+{ return _Tpvec(_mm256_cmp_##suffix(a.val, b.val, _CMP_LT_OQ)); } \
+inline _Tpvec operator > (const _Tpvec& a, const _Tpvec& b) \
+{ return _Tpvec(_mm256_cmp_##suffix(a.val, b.val, _CMP_GT_OQ)); } \
+inline _Tpvec operator <= (const _Tpvec& a, const _Tpvec& b) \
+{ return _Tpvec(_mm256_cmp_##suffix(a.val, b.val, _CMP_LE_OQ)); } \
+inline _Tpvec operator >= (const _Tpvec& a, const _Tpvec& b) \
+{ return _Tpvec(_mm256_cmp_##suffix(a.val, b.val, _CMP_GE_OQ)); }
+
+OPENCV_HAL_IMPL_AVX_FLT_CMP_OP(v_float32x8, ps)
+OPENCV_HAL_IMPL_AVX_FLT_CMP_OP(v_float64x4, pd)
+
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint8x32, v_add_wrap, _mm256_add_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int8x32, v_add_wrap, _mm256_add_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint16x16, v_add_wrap, _mm256_add_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int16x16, v_add_wrap, _mm256_add_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint8x32, v_sub_wrap, _mm256_sub_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int8x32, v_sub_wrap, _mm256_sub_epi8)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_uint16x16, v_sub_wrap, _mm256_sub_epi16)
+OPENCV_HAL_IMPL_AVX_BIN_FUNC(v_int16x16, v_sub_wrap, _mm256_sub_epi16)
+
+#define OPENCV_HAL_IMPL_AVX_ABSDIFF_8_16(_Tpuvec, _Tpsvec, bits, smask32) \
+inline _Tpuvec v_absdiff(const _Tpuvec& a, const _Tpuvec& b) \
+{ \
+    return _Tpuvec(_mm256_add_epi##bits(_mm256_subs_epu##bits(a.val, b.val), _mm256_subs_epu##bits(b.val, a.val))); \
+} \
+inline _Tpuvec v_absdiff(const _Tpsvec& a, const _Tpsvec& b) \
+{ \
+    __m256i smask = _mm256_set1_epi32(smask32); \
+    __m256i a1 = _mm256_xor_si256(a.val, smask); \
+    __m256i b1 = _mm256_xor_si256(b.val, smask); \
+    return _Tpuvec(_mm256_add_epi##bits(_mm256_subs_epu##bits(a1, b1), _mm256_subs_epu##bits(b1, a1))); \
+}
+
+OPENCV_HAL_IMPL_AVX_ABSDIFF_8_16(v_uint8x32, v_int8x32, 8, (int)0x80808080)
+OPENCV_HAL_IMPL_AVX_ABSDIFF_8_16(v_uint16x16, v_int16x16, 16, (int)0x80008000)
+
+#if CV_FMA3
+#define OPENCV_HAL_AVX_MULADD(suffix, a, b, c) _mm256_fmadd_##suffix(a, b, c)
+#else
+#define OPENCV_HAL_AVX_MULADD(suffix, a, b, c) _mm256_add_##suffix(_mm256_mul_##suffix(a, b), c)
+#endif
+
+#define OPENCV_HAL_IMPL_AVX_MISC_FLT_OP(_Tpvec, _Tp, _Tpreg, suffix, absmask_vec) \
+inline _Tpvec v_absdiff(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    _Tpreg absmask = _mm256_castsi256_##suffix(absmask_vec); \
+    return _Tpvec(_mm256_and_##suffix(_mm256_sub_##suffix(a.val, b.val), absmask)); \
+} \
+inline _Tpvec v_magnitude(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    _Tpreg res = OPENCV_HAL_AVX_MULADD(suffix, a.val, a.val, _mm256_mul_##suffix(b.val, b.val)); \
+    return _Tpvec(_mm256_sqrt_##suffix(res)); \
+} \
+inline _Tpvec v_sqr_magnitude(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    _Tpreg res = OPENCV_HAL_AVX_MULADD(suffix, a.val, a.val, _mm256_mul_##suffix(b.val, b.val)); \
+    return _Tpvec(res); \
+} \
+inline _Tpvec v_muladd(const _Tpvec& a, const _Tpvec& b, const _Tpvec& c) \
+{ \
+    return _Tpvec(OPENCV_HAL_AVX_MULADD(suffix, a.val, b.val, c.val)); \
+}
+
+OPENCV_HAL_IMPL_AVX_MISC_FLT_OP(v_float32x8, float, __m256, ps, _mm256_set1_epi32((int)0x7fffffff))
+OPENCV_HAL_IMPL_AVX_MISC_FLT_OP(v_float64x4, double, __m256d, pd, _mm256_srli_epi64(_mm256_set1_epi32(-1), 1))
+
+// there is no arithmetic 64-bit shift in AVX2, emulate it the same way as the 128-bit version
+inline __m256i v256_srai_epi64(__m256i a, int imm)
+{
+    __m256i smask = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+    return _mm256_xor_si256(_mm256_srli_epi64(_mm256_xor_si256(a, smask), imm), smask);
+}
+
+#define OPENCV_HAL_IMPL_AVX_SHIFT_OP(_Tpuvec, _Tpsvec, suffix, srai) \
+inline _Tpuvec operator << (const _Tpuvec& a, int imm) \
+{ \
+    return _Tpuvec(_mm256_slli_##suffix(a.val, imm)); \
+} \
+inline _Tpsvec operator << (const _Tpsvec& a, int imm) \
+{ \
+    return _Tpsvec(_mm256_slli_##suffix(a.val, imm)); \
+} \
+inline _Tpuvec operator >> (const _Tpuvec& a, int imm) \
+{ \
+    return _Tpuvec(_mm256_srli_##suffix(a.val, imm)); \
+} \
+inline _Tpsvec operator >> (const _Tpsvec& a, int imm) \
+{ \
+    return _Tpsvec(srai(a.val, imm)); \
+} \
+template<int imm> \
+inline _Tpuvec v_shl(const _Tpuvec& a) \
+{ \
+    return _Tpuvec(_mm256_slli_##suffix(a.val, imm)); \
+} \
+template<int imm> \
+inline _Tpsvec v_shl(const _Tpsvec& a) \
+{ \
+    return _Tpsvec(_mm256_slli_##suffix(a.val, imm)); \
+} \
+template<int imm> \
+inline _Tpuvec v_shr(const _Tpuvec& a) \
+{ \
+    return _Tpuvec(_mm256_srli_##suffix(a.val, imm)); \
+} \
+template<int imm> \
+inline _Tpsvec v_shr(const _Tpsvec& a) \
+{ \
+    return _Tpsvec(srai(a.val, imm)); \
+}
+
+OPENCV_HAL_IMPL_AVX_SHIFT_OP(v_uint16x16, v_int16x16, epi16, _mm256_srai_epi16)
+OPENCV_HAL_IMPL_AVX_SHIFT_OP(v_uint32x8, v_int32x8, epi32, _mm256_srai_epi32)
+OPENCV_HAL_IMPL_AVX_SHIFT_OP(v_uint64x4, v_int64x4, epi64, v256_srai_epi64)
+
+//////////////// Load and store ///////////////
+
+#define OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(_Tpvec, _Tp) \
+inline _Tpvec v256_load(const _Tp* ptr) \
+{ return _Tpvec(_mm256_loadu_si256((const __m256i*)ptr)); } \
+inline _Tpvec v256_load_aligned(const _Tp* ptr) \
+{ return _Tpvec(_mm256_load_si256((const __m256i*)ptr)); } \
+inline _Tpvec v256_load_halves(const _Tp* ptr0, const _Tp* ptr1) \
+{ \
+    return _Tpvec(_v256_combine(_mm_loadu_si128((const __m128i*)ptr0), \
+                                _mm_loadu_si128((const __m128i*)ptr1))); \
+} \
+inline void v_store(_Tp* ptr, const _Tpvec& a) \
+{ _mm256_storeu_si256((__m256i*)ptr, a.val); } \
+inline void v_store_aligned(_Tp* ptr, const _Tpvec& a) \
+{ _mm256_store_si256((__m256i*)ptr, a.val); } \
+inline void v_store_low(_Tp* ptr, const _Tpvec& a) \
+{ _mm_storeu_si128((__m128i*)ptr, _v256_extract_low(a.val)); } \
+inline void v_store_high(_Tp* ptr, const _Tpvec& a) \
+{ _mm_storeu_si128((__m128i*)ptr, _v256_extract_high(a.val)); }
+
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_uint8x32, uchar)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_int8x32, schar)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_uint16x16, ushort)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_int16x16, short)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_uint32x8, unsigned)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_int32x8, int)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_uint64x4, uint64)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_INT_OP(v_int64x4, int64)
+
+#define OPENCV_HAL_IMPL_AVX_LOADSTORE_FLT_OP(_Tpvec, _Tp, suffix) \
+inline _Tpvec v256_load(const _Tp* ptr) \
+{ return _Tpvec(_mm256_loadu_##suffix(ptr)); } \
+inline _Tpvec v256_load_aligned(const _Tp* ptr) \
+{ return _Tpvec(_mm256_load_##suffix(ptr)); } \
+inline _Tpvec v256_load_halves(const _Tp* ptr0, const _Tp* ptr1) \
+{ return _Tpvec(_v256_combine(_mm_loadu_##suffix(ptr0), _mm_loadu_##suffix(ptr1))); } \
+inline void v_store(_Tp* ptr, const _Tpvec& a) \
+{ _mm256_storeu_##suffix(ptr, a.val); } \
+inline void v_store_aligned(_Tp* ptr, const _Tpvec& a) \
+{ _mm256_store_##suffix(ptr, a.val); } \
+inline void v_store_low(_Tp* ptr, const _Tpvec& a) \
+{ _mm_storeu_##suffix(ptr, _v256_extract_low(a.val)); } \
+inline void v_store_high(_Tp* ptr, const _Tpvec& a) \
+{ _mm_storeu_##suffix(ptr, _v256_extract_high(a.val)); }
+
+OPENCV_HAL_IMPL_AVX_LOADSTORE_FLT_OP(v_float32x8, float, ps)
+OPENCV_HAL_IMPL_AVX_LOADSTORE_FLT_OP(v_float64x4, double, pd)
+
+//////////////// Reductions ///////////////
+
+inline int v_reduce_sum(const v_int32x8& a)
+{
+    __m128i s = _mm_add_epi32(_v256_extract_low(a.val), _v256_extract_high(a.val));
+    s = _mm_hadd_epi32(s, s);
+    s = _mm_hadd_epi32(s, s);
+    return _mm_cvtsi128_si32(s);
+}
+
+inline unsigned v_reduce_sum(const v_uint32x8& a)
+{ return (unsigned)v_reduce_sum(v_reinterpret_as_s32(a)); }
+
+inline float v_reduce_sum(const v_float32x8& a)
+{
+    __m128 s = _mm_add_ps(_v256_extract_low(a.val), _v256_extract_high(a.val));
+    s = _mm_hadd_ps(s, s);
+    s = _mm_hadd_ps(s, s);
+    return _mm_cvtss_f32(s);
+}
+
+#define OPENCV_HAL_IMPL_AVX_REDUCE_MINMAX(_Tpvec, scalartype, func, intrin) \
+inline scalartype v_reduce_##func(const _Tpvec& a) \
+{ \
+    __m128i s = intrin(_v256_extract_low(a.val), _v256_extract_high(a.val)); \
+    s = intrin(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2))); \
+    s = intrin(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1))); \
+    return (scalartype)_mm_cvtsi128_si32(s); \
+}
+
+OPENCV_HAL_IMPL_AVX_REDUCE_MINMAX(v_uint32x8, unsigned, max, _mm_max_epu32)
+OPENCV_HAL_IMPL_AVX_REDUCE_MINMAX(v_uint32x8, unsigned, min, _mm_min_epu32)
+OPENCV_HAL_IMPL_AVX_REDUCE_MINMAX(v_int32x8, int, max, _mm_max_epi32)
+OPENCV_HAL_IMPL_AVX_REDUCE_MINMAX(v_int32x8, int, min, _mm_min_epi32)
+
+inline float v_reduce_max(const v_float32x8& a)
+{
+    __m128 s = _mm_max_ps(_v256_extract_low(a.val), _v256_extract_high(a.val));
+    s = _mm_max_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_max_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(s);
+}
+
+inline float v_reduce_min(const v_float32x8& a)
+{
+    __m128 s = _mm_min_ps(_v256_extract_low(a.val), _v256_extract_high(a.val));
+    s = _mm_min_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_min_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(s);
+}
+
+inline double v_reduce_sum(const v_float64x4& a)
+{
+    __m128d s = _mm_add_pd(_v256_extract_low(a.val), _v256_extract_high(a.val));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+//////////////// Masks ///////////////
+
+inline int v_signmask(const v_uint8x32& a)
+{ return _mm256_movemask_epi8(a.val); }
+inline int v_signmask(const v_int8x32& a)
+{ return _mm256_movemask_epi8(a.val); }
+
+// packs saturate within each 128-bit lane: a0..a7 a0..a7 | a8..a15 a8..a15
+inline int v_signmask(const v_int16x16& a)
+{
+    int m = _mm256_movemask_epi8(_mm256_packs_epi16(a.val, a.val));
+    return (m & 255) | ((m >> 8) & 0xff00);
+}
+inline int v_signmask(const v_uint16x16& a)
+{ return v_signmask(v_reinterpret_as_s16(a)); }
+
+inline int v_signmask(const v_float32x8& a)
+{ return _mm256_movemask_ps(a.val); }
+inline int v_signmask(const v_int32x8& a)
+{ return _mm256_movemask_ps(_mm256_castsi256_ps(a.val)); }
+inline int v_signmask(const v_uint32x8& a)
+{ return _mm256_movemask_ps(_mm256_castsi256_ps(a.val)); }
+
+inline int v_signmask(const v_float64x4& a)
+{ return _mm256_movemask_pd(a.val); }
+
+#define OPENCV_HAL_IMPL_AVX_CHECK(_Tpvec, allmask) \
+inline bool v_check_all(const _Tpvec& a) \
+{ return (_mm256_movemask_epi8(v_reinterpret_as_u8(a).val) & (allmask)) == (allmask); } \
+inline bool v_check_any(const _Tpvec& a) \
+{ return (_mm256_movemask_epi8(v_reinterpret_as_u8(a).val) & (allmask)) != 0; }
+
+OPENCV_HAL_IMPL_AVX_CHECK(v_uint8x32, -1)
+OPENCV_HAL_IMPL_AVX_CHECK(v_int8x32, -1)
+OPENCV_HAL_IMPL_AVX_CHECK(v_uint16x16, (int)0xaaaaaaaa)
+OPENCV_HAL_IMPL_AVX_CHECK(v_int16x16, (int)0xaaaaaaaa)
+OPENCV_HAL_IMPL_AVX_CHECK(v_uint32x8, (int)0x88888888)
+OPENCV_HAL_IMPL_AVX_CHECK(v_int32x8, (int)0x88888888)
+OPENCV_HAL_IMPL_AVX_CHECK(v_float32x8, (int)0x88888888)
+OPENCV_HAL_IMPL_AVX_CHECK(v_float64x4, (int)0x80808080)
+
+#define OPENCV_HAL_IMPL_AVX_SELECT(_Tpvec, suffix) \
+inline _Tpvec v_select(const _Tpvec& mask, const _Tpvec& a, const _Tpvec& b) \
+{ \
+    return _Tpvec(_mm256_blendv_##suffix(b.val, a.val, mask.val)); \
+}
+
+OPENCV_HAL_IMPL_AVX_SELECT(v_uint8x32, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_int8x32, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_uint16x16, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_int16x16, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_uint32x8, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_int32x8, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_uint64x4, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_int64x4, epi8)
+OPENCV_HAL_IMPL_AVX_SELECT(v_float32x8, ps)
+OPENCV_HAL_IMPL_AVX_SELECT(v_float64x4, pd)
+
+//////////////// Expand ///////////////
+
+#define OPENCV_HAL_IMPL_AVX_EXPAND(_Tpvec, _Tpwvec, _Tp, intrin) \
+inline void v_expand(const _Tpvec& a, _Tpwvec& b0, _Tpwvec& b1) \
+{ \
+    b0.val = intrin(_v256_extract_low(a.val)); \
+    b1.val = intrin(_v256_extract_high(a.val)); \
+} \
+inline _Tpwvec v256_load_expand(const _Tp* ptr) \
+{ \
+    return _Tpwvec(intrin(_mm_loadu_si128((const __m128i*)ptr))); \
+}
+
+OPENCV_HAL_IMPL_AVX_EXPAND(v_uint8x32, v_uint16x16, uchar, _mm256_cvtepu8_epi16)
+OPENCV_HAL_IMPL_AVX_EXPAND(v_int8x32, v_int16x16, schar, _mm256_cvtepi8_epi16)
+OPENCV_HAL_IMPL_AVX_EXPAND(v_uint16x16, v_uint32x8, ushort, _mm256_cvtepu16_epi32)
+OPENCV_HAL_IMPL_AVX_EXPAND(v_int16x16, v_int32x8, short, _mm256_cvtepi16_epi32)
+OPENCV_HAL_IMPL_AVX_EXPAND(v_uint32x8, v_uint64x4, unsigned, _mm256_cvtepu32_epi64)
+OPENCV_HAL_IMPL_AVX_EXPAND(v_int32x8, v_int64x4, int, _mm256_cvtepi32_epi64)
+
+inline v_uint32x8 v256_load_expand_q(const uchar* ptr)
+{ return v_uint32x8(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)ptr))); }
+
+inline v_int32x8 v256_load_expand_q(const schar* ptr)
+{ return v_int32x8(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)ptr))); }
+
+//////////////// Unpacks and lane shuffles ///////////////
+
+#define OPENCV_HAL_IMPL_AVX_UNPACKS(_Tpvec, suffix, cast_from, cast_to) \
+inline void v_zip(const _Tpvec& a0, const _Tpvec& a1, _Tpvec& b0, _Tpvec& b1) \
+{ \
+    __m256i t0 = cast_from(_mm256_unpacklo_##suffix(a0.val, a1.val)); \
+    __m256i t1 = cast_from(_mm256_unpackhi_##suffix(a0.val, a1.val)); \
+    b0.val = cast_to(_mm256_permute2x128_si256(t0, t1, 0x20)); \
+    b1.val = cast_to(_mm256_permute2x128_si256(t0, t1, 0x31)); \
+} \
+inline _Tpvec v_combine_low(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    __m256i a1 = cast_from(a.val), b1 = cast_from(b.val); \
+    return _Tpvec(cast_to(_mm256_permute2x128_si256(a1, b1, 0x20))); \
+} \
+inline _Tpvec v_combine_high(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    __m256i a1 = cast_from(a.val), b1 = cast_from(b.val); \
+    return _Tpvec(cast_to(_mm256_permute2x128_si256(a1, b1, 0x31))); \
+} \
+inline void v_recombine(const _Tpvec& a, const _Tpvec& b, _Tpvec& c, _Tpvec& d) \
+{ \
+    __m256i a1 = cast_from(a.val), b1 = cast_from(b.val); \
+    c.val = cast_to(_mm256_permute2x128_si256(a1, b1, 0x20)); \
+    d.val = cast_to(_mm256_permute2x128_si256(a1, b1, 0x31)); \
+}
+
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_uint8x32, epi8, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_int8x32, epi8, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_uint16x16, epi16, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_int16x16, epi16, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_uint32x8, epi32, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_int32x8, epi32, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_float32x8, ps, _mm256_castps_si256, _mm256_castsi256_ps)
+OPENCV_HAL_IMPL_AVX_UNPACKS(v_float64x4, pd, _mm256_castpd_si256, _mm256_castsi256_pd)
+
+#define OPENCV_HAL_IMPL_AVX_EXTRACT(_Tpvec, cast_from, cast_to) \
+template<int s> \
+inline _Tpvec v_extract(const _Tpvec& a, const _Tpvec& b) \
+{ \
+    const int w = sizeof(_Tpvec::lane_type); \
+    return _Tpvec(cast_to(_v256_alignr_b<s*w>(cast_from(a.val), cast_from(b.val)))); \
+}
+
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_uint8x32, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_int8x32, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_uint16x16, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_int16x16, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_uint32x8, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_int32x8, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_uint64x4, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_int64x4, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_float32x8, _mm256_castps_si256, _mm256_castsi256_ps)
+OPENCV_HAL_IMPL_AVX_EXTRACT(v_float64x4, _mm256_castpd_si256, _mm256_castsi256_pd)
+
+//////////////// Rounding and conversions ///////////////
+
+inline v_int32x8 v_round(const v_float32x8& a)
+{ return v_int32x8(_mm256_cvtps_epi32(a.val)); }
+
+inline v_int32x8 v_floor(const v_float32x8& a)
+{ return v_int32x8(_mm256_cvtps_epi32(_mm256_floor_ps(a.val))); }
+
+inline v_int32x8 v_ceil(const v_float32x8& a)
+{ return v_int32x8(_mm256_cvtps_epi32(_mm256_ceil_ps(a.val))); }
+
+inline v_int32x8 v_trunc(const v_float32x8& a)
+{ return v_int32x8(_mm256_cvttps_epi32(a.val)); }
+
+inline v_int32x4 v_round(const v_float64x4& a)
+{ return v_int32x4(_mm256_cvtpd_epi32(a.val)); }
+
+inline v_int32x4 v_floor(const v_float64x4& a)
+{ return v_int32x4(_mm256_cvtpd_epi32(_mm256_floor_pd(a.val))); }
+
+inline v_int32x4 v_ceil(const v_float64x4& a)
+{ return v_int32x4(_mm256_cvtpd_epi32(_mm256_ceil_pd(a.val))); }
+
+inline v_int32x4 v_trunc(const v_float64x4& a)
+{ return v_int32x4(_mm256_cvttpd_epi32(a.val)); }
+
+inline v_float32x8 v_cvt_f32(const v_int32x8& a)
+{ return v_float32x8(_mm256_cvtepi32_ps(a.val)); }
+
+inline v_float32x4 v_cvt_f32(const v_float64x4& a)
+{ return v_float32x4(_mm256_cvtpd_ps(a.val)); }
+
+inline v_float32x8 v_cvt_f32(const v_float64x4& a, const v_float64x4& b)
+{ return v_float32x8(_v256_combine(_mm256_cvtpd_ps(a.val), _mm256_cvtpd_ps(b.val))); }
+
+inline v_float64x4 v_cvt_f64(const v_int32x8& a)
+{ return v_float64x4(_mm256_cvtepi32_pd(_v256_extract_low(a.val))); }
+
+inline v_float64x4 v_cvt_f64_high(const v_int32x8& a)
+{ return v_float64x4(_mm256_cvtepi32_pd(_v256_extract_high(a.val))); }
+
+inline v_float64x4 v_cvt_f64(const v_float32x8& a)
+{ return v_float64x4(_mm256_cvtps_pd(_v256_extract_low(a.val))); }
+
+inline v_float64x4 v_cvt_f64_high(const v_float32x8& a)
+{ return v_float64x4(_mm256_cvtps_pd(_v256_extract_high(a.val))); }
+
+// transposes each of the two 4x4 blocks held in the low and the high 128-bit halves
+#define OPENCV_HAL_IMPL_AVX_TRANSPOSE4x4(_Tpvec, suffix, cast_from, cast_to) \
+inline void v_transpose4x4(const _Tpvec& a0, const _Tpvec& a1, \
+                           const _Tpvec& a2, const _Tpvec& a3, \
+                           _Tpvec& b0, _Tpvec& b1, \
+                           _Tpvec& b2, _Tpvec& b3) \
+{ \
+    __m256i t0 = cast_from(_mm256_unpacklo_##suffix(a0.val, a1.val)); \
+    __m256i t1 = cast_from(_mm256_unpacklo_##suffix(a2.val, a3.val)); \
+    __m256i t2 = cast_from(_mm256_unpackhi_##suffix(a0.val, a1.val)); \
+    __m256i t3 = cast_from(_mm256_unpackhi_##suffix(a2.val, a3.val)); \
+\
+    b0.val = cast_to(_mm256_unpacklo_epi64(t0, t1)); \
+    b1.val = cast_to(_mm256_unpackhi_epi64(t0, t1)); \
+    b2.val = cast_to(_mm256_unpacklo_epi64(t2, t3)); \
+    b3.val = cast_to(_mm256_unpackhi_epi64(t2, t3)); \
+}
+
+OPENCV_HAL_IMPL_AVX_TRANSPOSE4x4(v_uint32x8, epi32, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_TRANSPOSE4x4(v_int32x8, epi32, OPENCV_HAL_NOP, OPENCV_HAL_NOP)
+OPENCV_HAL_IMPL_AVX_TRANSPOSE4x4(v_float32x8, ps, _mm256_castps_si256, _mm256_castsi256_ps)
+
+//////////////// Interleaved load and store ///////////////
+
+// the channel shuffles are done by the 128-bit implementation on each half of the block
+#define OPENCV_HAL_IMPL_AVX_INTERLEAVE(_Tpvec, _Tp, _Tpvec128) \
+inline void v_load_deinterleave(const _Tp* ptr, _Tpvec& a, _Tpvec& b, _Tpvec& c) \
+{ \
+    _Tpvec128 a0, b0, c0, a1, b1, c1; \
+    v_load_deinterleave(ptr, a0, b0, c0); \
+    v_load_deinterleave(ptr + _Tpvec128::nlanes*3, a1, b1, c1); \
+    a = v256_combine(a0, a1); \
+    b = v256_combine(b0, b1); \
+    c = v256_combine(c0, c1); \
+} \
+inline void v_load_deinterleave(const _Tp* ptr, _Tpvec& a, _Tpvec& b, _Tpvec& c, _Tpvec& d) \
+{ \
+    _Tpvec128 a0, b0, c0, d0, a1, b1, c1, d1; \
+    v_load_deinterleave(ptr, a0, b0, c0, d0); \
+    v_load_deinterleave(ptr + _Tpvec128::nlanes*4, a1, b1, c1, d1); \
+    a = v256_combine(a0, a1); \
+    b = v256_combine(b0, b1); \
+    c = v256_combine(c0, c1); \
+    d = v256_combine(d0, d1); \
+} \
+inline void v_store_interleave(_Tp* ptr, const _Tpvec& a, const _Tpvec& b, const _Tpvec& c) \
+{ \
+    v_store_interleave(ptr, v_get_low(a), v_get_low(b), v_get_low(c)); \
+    v_store_interleave(ptr + _Tpvec128::nlanes*3, v_get_high(a), v_get_high(b), v_get_high(c)); \
+} \
+inline void v_store_interleave(_Tp* ptr, const _Tpvec& a, const _Tpvec& b, \
+                               const _Tpvec& c, const _Tpvec& d) \
+{ \
+    v_store_interleave(ptr, v_get_low(a), v_get_low(b), v_get_low(c), v_get_low(d)); \
+    v_store_interleave(ptr + _Tpvec128::nlanes*4, v_get_high(a), v_get_high(b), \
+                       v_get_high(c), v_get_high(d)); \
+}
+
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_uint8x32, uchar, v_uint8x16)
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_int8x32, schar, v_int8x16)
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_uint16x16, ushort, v_uint16x8)
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_int16x16, short, v_int16x8)
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_uint32x8, unsigned, v_uint32x4)
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_int32x8, int, v_int32x4)
+OPENCV_HAL_IMPL_AVX_INTERLEAVE(v_float32x8, float, v_float32x4)
+
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END
+
+}
+
+#endif
@@ -48,6 +48,8 @@
 namespace cv
 {
 
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_BEGIN
+
 template<typename _Tp, int n> struct v_reg
 {
     typedef _Tp lane_type;
@@ -820,6 +822,8 @@ inline v_float32x4 v_matmul(const v_float32x4& v, const v_float32x4& m0,
                        v.s[0]*m0.s[3] + v.s[1]*m1.s[3] + v.s[2]*m2.s[3] + v.s[3]*m3.s[3]);
 }
 
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END
+
 }
 
 #endif
@@ -48,6 +48,8 @@
 namespace cv
 {
 
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_BEGIN
+
 #define CV_SIMD128 1
 
 struct v_uint8x16
@@ -840,6 +842,8 @@ inline v_float32x4 v_cvt_f32(const v_int32x4& a)
     return v_float32x4(vcvtq_f32_s32(a.val));
 }
 
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END
+
 }
 
 #endif
@@ -51,6 +51,8 @@
 namespace cv
 {
 
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_BEGIN
+
 struct v_uint8x16
 {
     typedef uchar lane_type;
@@ -1560,6 +1562,8 @@ inline v_float64x2 v_cvt_f64(const v_float32x4& a)
     return v_float64x2(_mm_cvtps_pd(a.val));
 }
 
+CV_CPU_OPTIMIZATION_HAL_NAMESPACE_END
+
 }
 
 #endif
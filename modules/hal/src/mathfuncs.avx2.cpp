@@ -0,0 +1,137 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+
+namespace cv { namespace hal { namespace opt_AVX2 {
+
+void magnitude(const float* x, const float* y, float* mag, int len)
+{
+    int i = 0;
+
+    for( ; i <= len - 16; i += 16 )
+    {
+        v_float32x8 x0 = v256_load(x + i), x1 = v256_load(x + i + 8);
+        v_float32x8 y0 = v256_load(y + i), y1 = v256_load(y + i + 8);
+        x0 = v_sqrt(v_muladd(x0, x0, y0*y0));
+        x1 = v_sqrt(v_muladd(x1, x1, y1*y1));
+        v_store(mag + i, x0);
+        v_store(mag + i + 8, x1);
+    }
+
+    for( ; i < len; i++ )
+    {
+        float x0 = x[i], y0 = y[i];
+        mag[i] = std::sqrt(x0*x0 + y0*y0);
+    }
+}
+
+void magnitude(const double* x, const double* y, double* mag, int len)
+{
+    int i = 0;
+
+    for( ; i <= len - 8; i += 8 )
+    {
+        v_float64x4 x0 = v256_load(x + i), x1 = v256_load(x + i + 4);
+        v_float64x4 y0 = v256_load(y + i), y1 = v256_load(y + i + 4);
+        x0 = v_sqrt(v_muladd(x0, x0, y0*y0));
+        x1 = v_sqrt(v_muladd(x1, x1, y1*y1));
+        v_store(mag + i, x0);
+        v_store(mag + i + 4, x1);
+    }
+
+    for( ; i < len; i++ )
+    {
+        double x0 = x[i], y0 = y[i];
+        mag[i] = std::sqrt(x0*x0 + y0*y0);
+    }
+}
+
+void invSqrt(const float* src, float* dst, int len)
+{
+    int i = 0;
+
+    for( ; i <= len - 16; i += 16 )
+    {
+        v_float32x8 t0 = v256_load(src + i), t1 = v256_load(src + i + 8);
+        t0 = v_invsqrt(t0);
+        t1 = v_invsqrt(t1);
+        v_store(dst + i, t0); v_store(dst + i + 8, t1);
+    }
+
+    for( ; i < len; i++ )
+        dst[i] = 1/std::sqrt(src[i]);
+}
+
+void sqrt(const float* src, float* dst, int len)
+{
+    int i = 0;
+
+    for( ; i <= len - 16; i += 16 )
+    {
+        v_float32x8 t0 = v256_load(src + i), t1 = v256_load(src + i + 8);
+        t0 = v_sqrt(t0);
+        t1 = v_sqrt(t1);
+        v_store(dst + i, t0); v_store(dst + i + 8, t1);
+    }
+
+    for( ; i < len; i++ )
+        dst[i] = std::sqrt(src[i]);
+}
+
+void sqrt(const double* src, double* dst, int len)
+{
+    int i = 0;
+
+    for( ; i <= len - 8; i += 8 )
+    {
+        v_float64x4 t0 = v256_load(src + i), t1 = v256_load(src + i + 4);
+        t0 = v_sqrt(t0);
+        t1 = v_sqrt(t1);
+        v_store(dst + i, t0); v_store(dst + i + 4, t1);
+    }
+
+    for( ; i < len; i++ )
+        dst[i] = std::sqrt(src[i]);
+}
+
+}}} // cv::hal::opt_AVX2
@@ -175,6 +175,14 @@ void magnitude(const float* x, const float* y, float* mag, int len)
     }
 #endif
 
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::magnitude(x, y, mag, len);
+        return;
+    }
+#endif
+
     int i = 0;
 
 #if CV_SIMD128
@@ -211,6 +219,14 @@ void magnitude(const double* x, const double* y, double* mag, int len)
     }
 #endif
 
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::magnitude(x, y, mag, len);
+        return;
+    }
+#endif
+
     int i = 0;
 
 #if CV_SIMD128_64F
@@ -247,6 +263,14 @@ void invSqrt(const float* src, float* dst, int len)
     }
 #endif
 
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::invSqrt(src, dst, len);
+        return;
+    }
+#endif
+
     int i = 0;
 
 #if CV_SIMD128
@@ -293,6 +317,14 @@ void sqrt(const float* src, float* dst, int len)
     }
 #endif
 
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::sqrt(src, dst, len);
+        return;
+    }
+#endif
+
     int i = 0;
 
 #if CV_SIMD128
@@ -324,6 +356,14 @@ void sqrt(const double* src, double* dst, int len)
     }
 #endif
 
+#if CV_TRY_AVX2
+    if( useAVX2() )
+    {
+        opt_AVX2::sqrt(src, dst, len);
+        return;
+    }
+#endif
+
     int i = 0;
 
 #if CV_SIMD128_64F
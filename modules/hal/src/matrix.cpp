@@ -205,4 +205,607 @@ bool Cholesky(double* A, size_t astep, int m, double* b, size_t bstep, int n)
     return CholImpl(A, astep, m, b, bstep, n);
 }
 
+/****************************************************************************************\
+*                 Batched decompositions of small matrices (structure of arrays)         *
+\****************************************************************************************/
+
+// The kernels below process as many matrices at once as there are lanes in a SIMD register:
+// every arithmetic operation is applied to the same element of all the matrices, and the
+// data-dependent decisions (pivoting, rotations, sorting) are made per lane with masks.
+
+// without SIMD instructions the kernels process one matrix at a time
+template<typename _Tp> struct BatchScalar
+{
+    BatchScalar() : val(0) {}
+    explicit BatchScalar(_Tp v) : val(v) {}
+    _Tp val;
+};
+
+#define OPENCV_HAL_IMPL_BATCH_SCALAR_OP(op) \
+template<typename _Tp> inline BatchScalar<_Tp> operator op (const BatchScalar<_Tp>& a, const BatchScalar<_Tp>& b) \
+{ return BatchScalar<_Tp>(a.val op b.val); }
+
+#define OPENCV_HAL_IMPL_BATCH_SCALAR_CMP(op) \
+template<typename _Tp> inline BatchScalar<_Tp> operator op (const BatchScalar<_Tp>& a, const BatchScalar<_Tp>& b) \
+{ return BatchScalar<_Tp>(a.val op b.val ? (_Tp)-1 : (_Tp)0); }
+
+OPENCV_HAL_IMPL_BATCH_SCALAR_OP(+)
+OPENCV_HAL_IMPL_BATCH_SCALAR_OP(-)
+OPENCV_HAL_IMPL_BATCH_SCALAR_OP(*)
+OPENCV_HAL_IMPL_BATCH_SCALAR_OP(/)
+OPENCV_HAL_IMPL_BATCH_SCALAR_CMP(<)
+OPENCV_HAL_IMPL_BATCH_SCALAR_CMP(>)
+
+template<typename _Tp> struct BatchVec
+{
+    typedef BatchScalar<_Tp> vec;
+    enum { nlanes = 1 };
+    static inline vec load(const _Tp* ptr) { return vec(*ptr); }
+    static inline void store(_Tp* ptr, const vec& a) { *ptr = a.val; }
+    static inline vec all(_Tp a) { return vec(a); }
+    static inline vec abs(const vec& a) { return vec(std::abs(a.val)); }
+    static inline vec sqrt(const vec& a) { return vec(std::sqrt(a.val)); }
+    static inline vec select(const vec& mask, const vec& a, const vec& b) { return mask.val < 0 ? a : b; }
+    static inline bool any(const vec& mask) { return mask.val < 0; }
+};
+
+#if CV_SIMD128
+template<> struct BatchVec<float>
+{
+    typedef v_float32x4 vec;
+    enum { nlanes = 4 };
+    static inline vec load(const float* ptr) { return v_load(ptr); }
+    static inline void store(float* ptr, const vec& a) { v_store(ptr, a); }
+    static inline vec all(float a) { return v_setall_f32(a); }
+    static inline vec abs(const vec& a) { return v_abs(a); }
+    static inline vec sqrt(const vec& a) { return v_sqrt(a); }
+    static inline vec select(const vec& mask, const vec& a, const vec& b) { return v_select(mask, a, b); }
+    static inline bool any(const vec& mask) { return v_check_any(mask); }
+};
+#endif
+
+#if CV_SIMD128_64F
+template<> struct BatchVec<double>
+{
+    typedef v_float64x2 vec;
+    enum { nlanes = 2 };
+    static inline vec load(const double* ptr) { return v_load(ptr); }
+    static inline void store(double* ptr, const vec& a) { v_store(ptr, a); }
+    static inline vec all(double a) { return v_setall_f64(a); }
+    static inline vec abs(const vec& a) { return v_abs(a); }
+    static inline vec sqrt(const vec& a) { return v_sqrt(a); }
+    static inline vec select(const vec& mask, const vec& a, const vec& b) { return v_select(mask, a, b); }
+    static inline bool any(const vec& mask) { return v_check_any(mask); }
+};
+#endif
+
+// exchanges a and b in the lanes selected by the mask
+template<typename _Tp> static inline void
+batchSwap(_Tp* a, _Tp* b, const typename BatchVec<_Tp>::vec& mask)
+{
+    typedef BatchVec<_Tp> BV;
+    typename BV::vec va = BV::load(a), vb = BV::load(b);
+    BV::store(a, BV::select(mask, vb, va));
+    BV::store(b, BV::select(mask, va, vb));
+}
+
+// copies the last, incomplete group of matrices into a buffer with one plane per element and
+// pads the unused lanes with identity matrices (identity = matrix size) or zeros (identity = 0)
+template<typename _Tp> static void
+loadBatchTail(const _Tp* src, size_t step, int nplanes, int rem, int identity, _Tp* buf)
+{
+    const int nlanes = BatchVec<_Tp>::nlanes;
+    for( int e = 0; e < nplanes; e++ )
+    {
+        _Tp pad = identity > 0 && e / identity == e % identity ? (_Tp)1 : (_Tp)0;
+        for( int l = 0; l < nlanes; l++ )
+            buf[e*nlanes + l] = l < rem && src ? src[e*step + l] : pad;
+    }
+}
+
+template<typename _Tp> static void
+storeBatchTail(const _Tp* buf, int nplanes, int rem, _Tp* dst, size_t step)
+{
+    const int nlanes = BatchVec<_Tp>::nlanes;
+    if( !dst )
+        return;
+    for( int e = 0; e < nplanes; e++ )
+        for( int l = 0; l < rem; l++ )
+            dst[e*step + l] = buf[e*nlanes + l];
+}
+
+template<typename _Tp> static inline void
+storeBatchInfo(const typename BatchVec<_Tp>::vec& v, int* info, int n)
+{
+    _Tp buf[BatchVec<_Tp>::nlanes];
+    BatchVec<_Tp>::store(buf, v);
+    for( int l = 0; l < n; l++ )
+        info[l] = (int)buf[l];
+}
+
+// M > 0 fixes the matrix size at compile time, so that the loops over the elements are unrolled
+
+template<typename _Tp, int M> static void
+LUBatchBlock(_Tp* A, size_t astep, int m, _Tp* b, size_t bstep, int n, _Tp eps, int* info, int ninfo)
+{
+    typedef BatchVec<_Tp> BV;
+    typedef typename BV::vec V;
+    if( M > 0 )
+        m = M;
+    int i, j, k;
+    V one = BV::all(1), zero = BV::all(0), veps = BV::all(eps);
+    V sign = one, minpivot = BV::all(std::numeric_limits<_Tp>::max());
+
+    for( i = 0; i < m; i++ )
+    {
+        // bring the row with the largest element of the column to the diagonal, lane by lane
+        for( j = i+1; j < m; j++ )
+        {
+            V mask = BV::abs(BV::load(A + (j*m + i)*astep)) > BV::abs(BV::load(A + (i*m + i)*astep));
+            if( !BV::any(mask) )
+                continue;
+            for( k = i; k < m; k++ )
+                batchSwap(A + (i*m + k)*astep, A + (j*m + k)*astep, mask);
+            if( b )
+                for( k = 0; k < n; k++ )
+                    batchSwap(b + (i*n + k)*bstep, b + (j*n + k)*bstep, mask);
+            sign = BV::select(mask, zero - sign, sign);
+        }
+
+        V p = BV::load(A + (i*m + i)*astep), ap = BV::abs(p);
+        minpivot = BV::select(ap < minpivot, ap, minpivot);
+        // singular matrices are detected at the end, meanwhile their lanes are kept finite
+        V d = (zero - one)/BV::select(ap < veps, one, p);
+
+        for( j = i+1; j < m; j++ )
+        {
+            V alpha = BV::load(A + (j*m + i)*astep)*d;
+
+            for( k = i+1; k < m; k++ )
+                BV::store(A + (j*m + k)*astep, BV::load(A + (j*m + k)*astep) + alpha*BV::load(A + (i*m + k)*astep));
+
+            if( b )
+                for( k = 0; k < n; k++ )
+                    BV::store(b + (j*n + k)*bstep, BV::load(b + (j*n + k)*bstep) + alpha*BV::load(b + (i*n + k)*bstep));
+        }
+
+        BV::store(A + (i*m + i)*astep, zero - d);
+    }
+
+    if( b )
+    {
+        for( i = m-1; i >= 0; i-- )
+            for( j = 0; j < n; j++ )
+            {
+                V s = BV::load(b + (i*n + j)*bstep);
+                for( k = i+1; k < m; k++ )
+                    s = s - BV::load(A + (i*m + k)*astep)*BV::load(b + (k*n + j)*bstep);
+                BV::store(b + (i*n + j)*bstep, s*BV::load(A + (i*m + i)*astep));
+            }
+    }
+
+    if( info )
+        storeBatchInfo<_Tp>(BV::select(minpivot < veps, zero, sign), info, ninfo);
+}
+
+template<typename _Tp, int M> static void
+CholBatchBlock(_Tp* A, size_t astep, int m, _Tp* b, size_t bstep, int n, int* info, int ninfo)
+{
+    typedef BatchVec<_Tp> BV;
+    typedef typename BV::vec V;
+    if( M > 0 )
+        m = M;
+    _Tp* L = A;
+    int i, j, k;
+    V one = BV::all(1), zero = BV::all(0), veps = BV::all(std::numeric_limits<_Tp>::epsilon());
+    V failed = zero;
+
+    for( i = 0; i < m; i++ )
+    {
+        for( j = 0; j < i; j++ )
+        {
+            V s = BV::load(A + (i*m + j)*astep);
+            for( k = 0; k < j; k++ )
+                s = s - BV::load(L + (i*m + k)*astep)*BV::load(L + (j*m + k)*astep);
+            BV::store(L + (i*m + j)*astep, s*BV::load(L + (j*m + j)*astep));
+        }
+        V s = BV::load(A + (i*m + i)*astep);
+        for( k = 0; k < i; k++ )
+        {
+            V t = BV::load(L + (i*m + k)*astep);
+            s = s - t*t;
+        }
+        V bad = s < veps;
+        failed = BV::select(bad, bad, failed);
+        BV::store(L + (i*m + i)*astep, one/BV::sqrt(BV::select(bad, one, s)));
+    }
+
+    if( b )
+    {
+        for( i = 0; i < m; i++ )
+            for( j = 0; j < n; j++ )
+            {
+                V s = BV::load(b + (i*n + j)*bstep);
+                for( k = 0; k < i; k++ )
+                    s = s - BV::load(L + (i*m + k)*astep)*BV::load(b + (k*n + j)*bstep);
+                BV::store(b + (i*n + j)*bstep, s*BV::load(L + (i*m + i)*astep));
+            }
+
+        for( i = m-1; i >= 0; i-- )
+            for( j = 0; j < n; j++ )
+            {
+                V s = BV::load(b + (i*n + j)*bstep);
+                for( k = m-1; k > i; k-- )
+                    s = s - BV::load(L + (k*m + i)*astep)*BV::load(b + (k*n + j)*bstep);
+                BV::store(b + (i*n + j)*bstep, s*BV::load(L + (i*m + i)*astep));
+            }
+    }
+
+    if( info )
+        storeBatchInfo<_Tp>(BV::select(failed, zero, one), info, ninfo);
+}
+
+// returns tan of the Jacobi rotation angle for cot(2*angle) = zeta, 0 in the masked lanes
+template<typename _Tp> static inline typename BatchVec<_Tp>::vec
+jacobiTan(const typename BatchVec<_Tp>::vec& zeta, const typename BatchVec<_Tp>::vec& skip)
+{
+    typedef BatchVec<_Tp> BV;
+    typedef typename BV::vec V;
+    V one = BV::all(1), zero = BV::all(0), az = BV::abs(zeta);
+    V t = one/(az + BV::sqrt(one + zeta*zeta));
+    t = BV::select(zeta < zero, zero - t, t);
+    return BV::select(skip, zero, t);
+}
+
+// cyclic Jacobi method for symmetric matrices; the eigenvalues are sorted in descending order,
+// the eigenvectors are stored as rows
+template<typename _Tp, int M> static void
+eigenBatchBlock(_Tp* A, size_t astep, int m, _Tp* w, size_t wstep, _Tp* v, size_t vstep)
+{
+    typedef BatchVec<_Tp> BV;
+    typedef typename BV::vec V;
+    if( M > 0 )
+        m = M;
+    int i, j, k, p, q, iter, maxIters = 30;
+    V one = BV::all(1), zero = BV::all(0), two = BV::all(2);
+    V tiny = BV::all(std::numeric_limits<_Tp>::min());
+    _Tp eps = std::numeric_limits<_Tp>::epsilon();
+
+    if( v )
+        for( i = 0; i < m; i++ )
+            for( j = 0; j < m; j++ )
+                BV::store(v + (i*m + j)*vstep, i == j ? one : zero);
+
+    V fro = zero;
+    for( i = 0; i < m*m; i++ )
+    {
+        V a = BV::load(A + i*astep);
+        fro = fro + a*a;
+    }
+    V thresh = fro*BV::all(eps*eps);
+
+    for( iter = 0; iter < maxIters; iter++ )
+    {
+        V off = zero;
+        for( p = 0; p < m; p++ )
+            for( q = p+1; q < m; q++ )
+            {
+                V a = BV::load(A + (p*m + q)*astep);
+                off = off + a*a;
+            }
+        if( !BV::any(off > thresh) )
+            break;
+
+        for( p = 0; p < m; p++ )
+            for( q = p+1; q < m; q++ )
+            {
+                V apq = BV::load(A + (p*m + q)*astep);
+                V skip = BV::abs(apq) < tiny;
+                if( !BV::any(skip < one) )
+                    continue;
+                V app = BV::load(A + (p*m + p)*astep), aqq = BV::load(A + (q*m + q)*astep);
+                V t = jacobiTan<_Tp>((aqq - app)/(two*BV::select(skip, one, apq)), skip);
+                V c = one/BV::sqrt(one + t*t), s = t*c;
+
+                for( k = 0; k < m; k++ )
+                {
+                    V akp = BV::load(A + (k*m + p)*astep), akq = BV::load(A + (k*m + q)*astep);
+                    BV::store(A + (k*m + p)*astep, c*akp - s*akq);
+                    BV::store(A + (k*m + q)*astep, s*akp + c*akq);
+                }
+                for( k = 0; k < m; k++ )
+                {
+                    V apk = BV::load(A + (p*m + k)*astep), aqk = BV::load(A + (q*m + k)*astep);
+                    BV::store(A + (p*m + k)*astep, c*apk - s*aqk);
+                    BV::store(A + (q*m + k)*astep, s*apk + c*aqk);
+                }
+                if( v )
+                    for( k = 0; k < m; k++ )
+                    {
+                        V vpk = BV::load(v + (p*m + k)*vstep), vqk = BV::load(v + (q*m + k)*vstep);
+                        BV::store(v + (p*m + k)*vstep, c*vpk - s*vqk);
+                        BV::store(v + (q*m + k)*vstep, s*vpk + c*vqk);
+                    }
+            }
+    }
+
+    for( i = 0; i < m; i++ )
+        BV::store(w + i*wstep, BV::load(A + (i*m + i)*astep));
+
+    for( i = 0; i < m; i++ )
+        for( j = i+1; j < m; j++ )
+        {
+            V mask = BV::load(w + j*wstep) > BV::load(w + i*wstep);
+            if( !BV::any(mask) )
+                continue;
+            batchSwap(w + i*wstep, w + j*wstep, mask);
+            if( v )
+                for( k = 0; k < m; k++ )
+                    batchSwap(v + (i*m + k)*vstep, v + (j*m + k)*vstep, mask);
+        }
+}
+
+// one-sided Jacobi method, the columns of A are orthogonalized in place;
+// the singular values are sorted in descending order
+template<typename _Tp, int N> static void
+SVDBatchBlock(_Tp* A, size_t astep, int m, int n, _Tp* w, size_t wstep,
+              _Tp* u, size_t ustep, _Tp* vt, size_t vtstep)
+{
+    typedef BatchVec<_Tp> BV;
+    typedef typename BV::vec V;
+    if( N > 0 )
+        n = N;
+    int i, j, k, p, q, iter, maxIters = 30;
+    V one = BV::all(1), zero = BV::all(0), two = BV::all(2);
+    V tiny = BV::all(std::numeric_limits<_Tp>::min());
+    V veps = BV::all(std::numeric_limits<_Tp>::epsilon());
+
+    if( vt )
+        for( i = 0; i < n; i++ )
+            for( j = 0; j < n; j++ )
+                BV::store(vt + (i*n + j)*vtstep, i == j ? one : zero);
+
+    for( iter = 0; iter < maxIters; iter++ )
+    {
+        bool changed = false;
+
+        for( p = 0; p < n; p++ )
+            for( q = p+1; q < n; q++ )
+            {
+                V alpha = zero, beta = zero, gamma = zero;
+                for( k = 0; k < m; k++ )
+                {
+                    V akp = BV::load(A + (k*n + p)*astep), akq = BV::load(A + (k*n + q)*astep);
+                    alpha = alpha + akp*akp;
+                    beta = beta + akq*akq;
+                    gamma = gamma + akp*akq;
+                }
+                V skip = BV::abs(gamma) < BV::select(tiny > veps*BV::sqrt(alpha*beta), tiny,
+                                                     veps*BV::sqrt(alpha*beta));
+                if( !BV::any(skip < one) )
+                    continue;
+                changed = true;
+                V t = jacobiTan<_Tp>((beta - alpha)/(two*BV::select(skip, one, gamma)), skip);
+                V c = one/BV::sqrt(one + t*t), s = t*c;
+
+                for( k = 0; k < m; k++ )
+                {
+                    V akp = BV::load(A + (k*n + p)*astep), akq = BV::load(A + (k*n + q)*astep);
+                    BV::store(A + (k*n + p)*astep, c*akp - s*akq);
+                    BV::store(A + (k*n + q)*astep, s*akp + c*akq);
+                }
+                if( vt )
+                    for( k = 0; k < n; k++ )
+                    {
+                        V vpk = BV::load(vt + (p*n + k)*vtstep), vqk = BV::load(vt + (q*n + k)*vtstep);
+                        BV::store(vt + (p*n + k)*vtstep, c*vpk - s*vqk);
+                        BV::store(vt + (q*n + k)*vtstep, s*vpk + c*vqk);
+                    }
+            }
+
+        if( !changed )
+            break;
+    }
+
+    for( j = 0; j < n; j++ )
+    {
+        V s = zero;
+        for( k = 0; k < m; k++ )
+        {
+            V a = BV::load(A + (k*n + j)*astep);
+            s = s + a*a;
+        }
+        s = BV::sqrt(s);
+        BV::store(w + j*wstep, s);
+        if( u )
+        {
+            V scale = BV::select(s > tiny, one/BV::select(s > tiny, s, one), zero);
+            for( k = 0; k < m; k++ )
+                BV::store(u + (k*n + j)*ustep, BV::load(A + (k*n + j)*astep)*scale);
+        }
+    }
+
+    for( i = 0; i < n; i++ )
+        for( j = i+1; j < n; j++ )
+        {
+            V mask = BV::load(w + j*wstep) > BV::load(w + i*wstep);
+            if( !BV::any(mask) )
+                continue;
+            batchSwap(w + i*wstep, w + j*wstep, mask);
+            if( u )
+                for( k = 0; k < m; k++ )
+                    batchSwap(u + (k*n + i)*ustep, u + (k*n + j)*ustep, mask);
+            if( vt )
+                for( k = 0; k < n; k++ )
+                    batchSwap(vt + (i*n + k)*vtstep, vt + (j*n + k)*vtstep, mask);
+        }
+}
+
+template<typename _Tp, int M> static void
+LUBatch_(_Tp* A, size_t astep, int m, _Tp* b, size_t bstep, int n, int count, int* info, _Tp eps)
+{
+    const int nlanes = BatchVec<_Tp>::nlanes;
+    int k = 0;
+    astep /= sizeof(A[0]);
+    bstep /= sizeof(A[0]);
+
+    for( ; k <= count - nlanes; k += nlanes )
+        LUBatchBlock<_Tp, M>(A + k, astep, m, b ? b + k : 0, bstep, n, eps, info ? info + k : 0, nlanes);
+
+    if( k < count )
+    {
+        int rem = count - k;
+        std::vector<_Tp> buf((m*m + (b ? m*n : 0))*nlanes);
+        _Tp *abuf = &buf[0], *bbuf = b ? abuf + m*m*nlanes : 0;
+        loadBatchTail(A + k, astep, m*m, rem, m, abuf);
+        if( b )
+            loadBatchTail(b + k, bstep, m*n, rem, 0, bbuf);
+        LUBatchBlock<_Tp, M>(abuf, nlanes, m, bbuf, nlanes, n, eps, info ? info + k : 0, rem);
+        storeBatchTail(abuf, m*m, rem, A + k, astep);
+        if( b )
+            storeBatchTail(bbuf, m*n, rem, b + k, bstep);
+    }
+}
+
+template<typename _Tp, int M> static void
+CholBatch_(_Tp* A, size_t astep, int m, _Tp* b, size_t bstep, int n, int count, int* info)
+{
+    const int nlanes = BatchVec<_Tp>::nlanes;
+    int k = 0;
+    astep /= sizeof(A[0]);
+    bstep /= sizeof(A[0]);
+
+    for( ; k <= count - nlanes; k += nlanes )
+        CholBatchBlock<_Tp, M>(A + k, astep, m, b ? b + k : 0, bstep, n, info ? info + k : 0, nlanes);
+
+    if( k < count )
+    {
+        int rem = count - k;
+        std::vector<_Tp> buf((m*m + (b ? m*n : 0))*nlanes);
+        _Tp *abuf = &buf[0], *bbuf = b ? abuf + m*m*nlanes : 0;
+        loadBatchTail(A + k, astep, m*m, rem, m, abuf);
+        if( b )
+            loadBatchTail(b + k, bstep, m*n, rem, 0, bbuf);
+        CholBatchBlock<_Tp, M>(abuf, nlanes, m, bbuf, nlanes, n, info ? info + k : 0, rem);
+        storeBatchTail(abuf, m*m, rem, A + k, astep);
+        if( b )
+            storeBatchTail(bbuf, m*n, rem, b + k, bstep);
+    }
+}
+
+template<typename _Tp, int M> static void
+eigenBatch_(_Tp* A, size_t astep, int m, _Tp* w, size_t wstep, _Tp* v, size_t vstep, int count)
+{
+    const int nlanes = BatchVec<_Tp>::nlanes;
+    int k = 0;
+    astep /= sizeof(A[0]);
+    wstep /= sizeof(A[0]);
+    vstep /= sizeof(A[0]);
+
+    for( ; k <= count - nlanes; k += nlanes )
+        eigenBatchBlock<_Tp, M>(A + k, astep, m, w + k, wstep, v ? v + k : 0, vstep);
+
+    if( k < count )
+    {
+        int rem = count - k;
+        std::vector<_Tp> buf((m*m*2 + m)*nlanes);
+        _Tp *abuf = &buf[0], *wbuf = abuf + m*m*nlanes, *vbuf = v ? wbuf + m*nlanes : 0;
+        loadBatchTail(A + k, astep, m*m, rem, m, abuf);
+        eigenBatchBlock<_Tp, M>(abuf, nlanes, m, wbuf, nlanes, vbuf, nlanes);
+        storeBatchTail(abuf, m*m, rem, A + k, astep);
+        storeBatchTail(wbuf, m, rem, w + k, wstep);
+        if( v )
+            storeBatchTail(vbuf, m*m, rem, v + k, vstep);
+    }
+}
+
+template<typename _Tp, int N> static void
+SVDBatch_(_Tp* A, size_t astep, int m, int n, _Tp* w, size_t wstep,
+          _Tp* u, size_t ustep, _Tp* vt, size_t vtstep, int count)
+{
+    const int nlanes = BatchVec<_Tp>::nlanes;
+    int k = 0;
+    astep /= sizeof(A[0]);
+    wstep /= sizeof(A[0]);
+    ustep /= sizeof(A[0]);
+    vtstep /= sizeof(A[0]);
+
+    for( ; k <= count - nlanes; k += nlanes )
+        SVDBatchBlock<_Tp, N>(A + k, astep, m, n, w + k, wstep, u ? u + k : 0, ustep, vt ? vt + k : 0, vtstep);
+
+    if( k < count )
+    {
+        int rem = count - k;
+        std::vector<_Tp> buf((m*n*2 + n + n*n)*nlanes);
+        _Tp *abuf = &buf[0], *wbuf = abuf + m*n*nlanes;
+        _Tp *ubuf = u ? wbuf + n*nlanes : 0, *vtbuf = vt ? wbuf + (n + m*n)*nlanes : 0;
+        loadBatchTail(A + k, astep, m*n, rem, 0, abuf);
+        SVDBatchBlock<_Tp, N>(abuf, nlanes, m, n, wbuf, nlanes, ubuf, nlanes, vtbuf, nlanes);
+        storeBatchTail(abuf, m*n, rem, A + k, astep);
+        storeBatchTail(wbuf, n, rem, w + k, wstep);
+        if( u )
+            storeBatchTail(ubuf, m*n, rem, u + k, ustep);
+        if( vt )
+            storeBatchTail(vtbuf, n*n, rem, vt + k, vtstep);
+    }
+}
+
+// instantiates the kernel for the sizes 2..9 (3x3 rotations and homographies up to 9x9 normal
+// equations), larger matrices use the generic version
+#define OPENCV_HAL_BATCH_DISPATCH(func, _Tp, size, args) \
+    switch( size ) \
+    { \
+    case 2: func<_Tp, 2> args; break; \
+    case 3: func<_Tp, 3> args; break; \
+    case 4: func<_Tp, 4> args; break; \
+    case 5: func<_Tp, 5> args; break; \
+    case 6: func<_Tp, 6> args; break; \
+    case 7: func<_Tp, 7> args; break; \
+    case 8: func<_Tp, 8> args; break; \
+    case 9: func<_Tp, 9> args; break; \
+    default: func<_Tp, 0> args; \
+    }
+
+void LUBatch(float* A, size_t astep, int m, float* b, size_t bstep, int n, int count, int* info)
+{
+    OPENCV_HAL_BATCH_DISPATCH(LUBatch_, float, m, (A, astep, m, b, bstep, n, count, info, FLT_EPSILON*10))
+}
+
+void LUBatch(double* A, size_t astep, int m, double* b, size_t bstep, int n, int count, int* info)
+{
+    OPENCV_HAL_BATCH_DISPATCH(LUBatch_, double, m, (A, astep, m, b, bstep, n, count, info, DBL_EPSILON*100))
+}
+
+void CholeskyBatch(float* A, size_t astep, int m, float* b, size_t bstep, int n, int count, int* info)
+{
+    OPENCV_HAL_BATCH_DISPATCH(CholBatch_, float, m, (A, astep, m, b, bstep, n, count, info))
+}
+
+void CholeskyBatch(double* A, size_t astep, int m, double* b, size_t bstep, int n, int count, int* info)
+{
+    OPENCV_HAL_BATCH_DISPATCH(CholBatch_, double, m, (A, astep, m, b, bstep, n, count, info))
+}
+
+void eigenBatch(float* A, size_t astep, int m, float* w, size_t wstep, float* v, size_t vstep, int count)
+{
+    OPENCV_HAL_BATCH_DISPATCH(eigenBatch_, float, m, (A, astep, m, w, wstep, v, vstep, count))
+}
+
+void eigenBatch(double* A, size_t astep, int m, double* w, size_t wstep, double* v, size_t vstep, int count)
+{
+    OPENCV_HAL_BATCH_DISPATCH(eigenBatch_, double, m, (A, astep, m, w, wstep, v, vstep, count))
+}
+
+void SVDBatch(float* A, size_t astep, int m, int n, float* w, size_t wstep,
+              float* u, size_t ustep, float* vt, size_t vtstep, int count)
+{
+    OPENCV_HAL_BATCH_DISPATCH(SVDBatch_, float, n, (A, astep, m, n, w, wstep, u, ustep, vt, vtstep, count))
+}
+
+void SVDBatch(double* A, size_t astep, int m, int n, double* w, size_t wstep,
+              double* u, size_t ustep, double* vt, size_t vtstep, int count)
+{
+    OPENCV_HAL_BATCH_DISPATCH(SVDBatch_, double, n, (A, astep, m, n, w, wstep, u, ustep, vt, vtstep, count))
+}
+
 }}
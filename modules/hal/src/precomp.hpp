@@ -46,4 +46,35 @@
 #include <cmath>
 #include <cstdlib>
 #include <limits>
+#include <vector>
 #include <float.h>
+
+namespace cv
+{
+namespace hal
+{
+
+#if CV_TRY_AVX2
+// kernels from *.avx2.cpp, compiled with -mavx2 -mfma and selected at runtime
+namespace opt_AVX2
+{
+void magnitude(const float* x, const float* y, float* mag, int len);
+void magnitude(const double* x, const double* y, double* mag, int len);
+void invSqrt(const float* src, float* dst, int len);
+void sqrt(const float* src, float* dst, int len);
+void sqrt(const double* src, double* dst, int len);
+float normL2Sqr_(const float* a, const float* b, int n);
+float normL1_(const float* a, const float* b, int n);
+int normHamming(const uchar* a, const uchar* b, int n);
+}
+
+// set once from cpuid (AVX2, FMA3 and the OS saving the ymm registers), cleared by setUseOptimized(false)
+extern bool useAVX2Flag;
+
+static inline bool useAVX2()
+{
+    return useAVX2Flag;
+}
+#endif
+
+}}
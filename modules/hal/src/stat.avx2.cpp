@@ -0,0 +1,117 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+
+namespace cv { namespace hal { namespace opt_AVX2 {
+
+float normL2Sqr_(const float* a, const float* b, int n)
+{
+    int j = 0;
+    v_float32x8 d0 = v256_setzero_f32(), d1 = v256_setzero_f32();
+
+    for( ; j <= n - 16; j += 16 )
+    {
+        v_float32x8 t0 = v256_load(a + j) - v256_load(b + j);
+        v_float32x8 t1 = v256_load(a + j + 8) - v256_load(b + j + 8);
+        d0 = v_muladd(t0, t0, d0);
+        d1 = v_muladd(t1, t1, d1);
+    }
+    float d = v_reduce_sum(d0 + d1);
+
+    for( ; j < n; j++ )
+    {
+        float t = a[j] - b[j];
+        d += t*t;
+    }
+    return d;
+}
+
+float normL1_(const float* a, const float* b, int n)
+{
+    int j = 0;
+    v_float32x8 d0 = v256_setzero_f32(), d1 = v256_setzero_f32();
+
+    for( ; j <= n - 16; j += 16 )
+    {
+        d0 += v_absdiff(v256_load(a + j), v256_load(b + j));
+        d1 += v_absdiff(v256_load(a + j + 8), v256_load(b + j + 8));
+    }
+    float d = v_reduce_sum(d0 + d1);
+
+    for( ; j < n; j++ )
+        d += std::abs(a[j] - b[j]);
+    return d;
+}
+
+// Per-byte popcount via a 4-bit lookup table (vpshufb); the byte counts are
+// summed into 64-bit lanes with vpsadbw once per 32 bytes.
+int normHamming(const uchar* a, const uchar* b, int n)
+{
+    int i = 0;
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i mask4 = _mm256_set1_epi8(0x0f), z = _mm256_setzero_si256();
+    __m256i s = z;
+
+    for( ; i <= n - 32; i += 32 )
+    {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                     _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask4)),
+                                    _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask4)));
+        s = _mm256_add_epi64(s, _mm256_sad_epu8(c, z));
+    }
+    __m128i s2 = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    int result = _mm_cvtsi128_si32(s2) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(s2, s2));
+
+    for( ; i < n; i++ )
+    {
+        unsigned v = a[i] ^ b[i];
+        v = v - ((v >> 1) & 0x55);
+        v = (v & 0x33) + ((v >> 2) & 0x33);
+        result += (int)((v + (v >> 4)) & 0x0f);
+    }
+    return result;
+}
+
+}}} // cv::hal::opt_AVX2
@@ -109,6 +109,11 @@ int normHamming(const uchar* a, int n)
 
 int normHamming(const uchar* a, const uchar* b, int n)
 {
+#if CV_TRY_AVX2
+    if( n >= 32 && useAVX2() )
+        return opt_AVX2::normHamming(a, b, n);
+#endif
+
     int i = 0;
     int result = 0;
 #if CV_NEON
@@ -183,6 +188,11 @@ int normHamming(const uchar* a, const uchar* b, int n, int cellSize)
 
 float normL2Sqr_(const float* a, const float* b, int n)
 {
+#if CV_TRY_AVX2
+    if( useAVX2() )
+        return opt_AVX2::normL2Sqr_(a, b, n);
+#endif
+
     int j = 0; float d = 0.f;
 #if CV_SSE
     float CV_DECL_ALIGNED(16) buf[4];
@@ -217,6 +227,11 @@ float normL2Sqr_(const float* a, const float* b, int n)
 
 float normL1_(const float* a, const float* b, int n)
 {
+#if CV_TRY_AVX2
+    if( useAVX2() )
+        return opt_AVX2::normL1_(a, b, n);
+#endif
+
     int j = 0; float d = 0.f;
 #if CV_SSE
     float CV_DECL_ALIGNED(16) buf[4];
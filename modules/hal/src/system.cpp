@@ -0,0 +1,116 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+
+#if defined _MSC_VER && (defined _M_IX86 || defined _M_X64) && _MSC_VER >= 1600
+#  include <intrin.h>
+#  include <immintrin.h>
+#  define CV_HAL_CPUID_MSVC 1
+#elif defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+#  include <cpuid.h>
+#  define CV_HAL_CPUID_GCC 1
+#endif
+
+namespace cv { namespace hal {
+
+// The HAL is a standalone library, so it reads the CPU features itself rather than
+// through cv::checkHardwareSupport().
+static bool detectAVX2()
+{
+    unsigned regs[4] = { 0, 0, 0, 0 };
+#if defined CV_HAL_CPUID_MSVC
+    int r[4];
+    __cpuid(r, 0);
+    if( r[0] < 7 )
+        return false;
+    __cpuid(r, 1);
+    regs[2] = (unsigned)r[2];
+#elif defined CV_HAL_CPUID_GCC
+    if( __get_cpuid_max(0, 0) < 7 )
+        return false;
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#else
+    return false;
+#endif
+
+    // FMA3, AVX and OSXSAVE, then the OS must save the xmm and ymm state (XCR0 bits 1 and 2)
+    const unsigned fma_avx_osxsave = (1u << 12) | (1u << 28) | (1u << 27);
+    if( (regs[2] & fma_avx_osxsave) != fma_avx_osxsave )
+        return false;
+#if defined CV_HAL_CPUID_MSVC
+    if( (_xgetbv(0) & 6) != 6 )
+        return false;
+    __cpuidex(r, 7, 0);
+    regs[1] = (unsigned)r[1];
+#elif defined CV_HAL_CPUID_GCC
+    unsigned xcr0_lo, xcr0_hi;
+    __asm__ __volatile__ ( "xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0) );
+    (void)xcr0_hi;
+    if( (xcr0_lo & 6) != 6 )
+        return false;
+    __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    return (regs[1] & (1u << 5)) != 0;
+}
+
+static const bool haveAVX2 = detectAVX2();
+static bool useOptimizedFlag = true;
+
+#if CV_TRY_AVX2
+bool useAVX2Flag = haveAVX2;
+#endif
+
+void setUseOptimized(bool onoff)
+{
+    useOptimizedFlag = onoff;
+#if CV_TRY_AVX2
+    useAVX2Flag = onoff && haveAVX2;
+#endif
+}
+
+bool useOptimized()
+{
+    return useOptimizedFlag;
+}
+
+}}
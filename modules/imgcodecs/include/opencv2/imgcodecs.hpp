@@ -141,6 +141,23 @@ CV_EXPORTS_W Mat imread( const String& filename, int flags = IMREAD_COLOR );
  */
 CV_EXPORTS_W Mat imread_reduced( const String& filename, int flags = IMREAD_COLOR, int scale_denom=1 );
 
+/** @brief Loads a rectangular region of an image from a file, optionally at a reduced resolution.
+
+@param filename Name of file to be loaded.
+@param roi The region of the image to load, in the coordinates of the full-resolution image. It is
+clipped to the image; an empty rectangle stands for the whole image.
+@param flags Flag that can take values of @ref cv::ImreadModes.
+@param scale_denom The resolution of the result is reduced by this factor, e.g. 2, 4 or 8.
+
+The result has the size of roi divided by scale_denom and rounded up. The JPEG, PNG, TIFF and WebP
+decoders skip the data outside of the region where the format allows it (the rows below the
+region, the strips and tiles not crossing it, the columns of the cropped JPEG and WebP scanlines),
+and JPEG and WebP images are scaled down while decoding. The other formats are decoded fully, then
+the region is cropped and resized with INTER_AREA interpolation.
+ */
+CV_EXPORTS_W Mat imread_region( const String& filename, const Rect& roi, int flags = IMREAD_COLOR,
+                                int scale_denom = 1 );
+
 /** @brief Loads a multi-page image from a file. (see imread for details.)
 
 @param filename Name of file to be loaded.
@@ -150,6 +167,20 @@ CV_EXPORTS_W Mat imread_reduced( const String& filename, int flags = IMREAD_COLO
 */
 CV_EXPORTS_W bool imreadmulti(const String& filename, std::vector<Mat>& mats, int flags = IMREAD_ANYCOLOR);
 
+/** @brief Reads a batch of images from files in parallel.
+
+@param filenames Names of the files to be loaded.
+@param images Output images. images[i] is empty if filenames[i] could not be read. The matrices
+already stored in the vector are reused for the images of the same size and type.
+@param flags Flag that can take values of @ref cv::ImreadModes.
+@return The number of images read successfully.
+
+The images are read by the threads of the library, each reusing its decoders for the images of
+the same format, which saves the per-image overhead when many small images are loaded.
+ */
+CV_EXPORTS int imreadBatch(const std::vector<String>& filenames, std::vector<Mat>& images,
+                           int flags = IMREAD_COLOR);
+
 /** @brief Saves an image to a specified file.
 
 @param filename Name of the file.
@@ -236,6 +267,251 @@ See imread for the list of supported formats and flags description.
  */
 CV_EXPORTS Mat imdecode( InputArray buf, int flags, Mat* dst);
 
+/** @brief Reads a rectangular region of an image from a buffer in memory. (see imread_region for details.)
+
+@param buf Input array or vector of bytes.
+@param roi The region of the image to decode, an empty rectangle stands for the whole image.
+@param flags The same flags as in imread, see @ref cv::ImreadModes.
+@param scale_denom The resolution of the result is reduced by this factor.
+ */
+CV_EXPORTS_W Mat imdecode_region( InputArray buf, const Rect& roi, int flags = IMREAD_COLOR,
+                                  int scale_denom = 1 );
+
+/** @brief Reads a batch of images from buffers in memory in parallel. (see imreadBatch for details.)
+
+@param bufs Vector of the input arrays or vectors of bytes.
+@param images Output images. images[i] is empty if bufs[i] could not be decoded.
+@param flags The same flags as in imread, see @ref cv::ImreadModes.
+@return The number of images decoded successfully.
+ */
+CV_EXPORTS int imdecodeBatch(InputArrayOfArrays bufs, std::vector<Mat>& images,
+                             int flags = IMREAD_COLOR);
+
+/** @brief Decodes an image that is received in parts, for example from a network connection.
+
+The parts of the encoded image are passed to feed() as they arrive, and the decoder decodes as
+much of the image as they allow, so that decoding overlaps with receiving the data:
+@code
+    Ptr<ImageStreamDecoder> decoder = createImageStreamDecoder(IMREAD_COLOR);
+    int rows = 0;
+    while( receive(socket, chunk) )
+    {
+        if( !decoder->feed(chunk) )
+            break; // invalid data
+        if( decoder->decodedRows() > rows )
+        {
+            process(decoder->image().rowRange(rows, decoder->decodedRows()));
+            rows = decoder->decodedRows();
+        }
+    }
+    decoder->finish();
+@endcode
+JPEG, PNG and WebP images are decoded incrementally. Progressive JPEG images are decoded once all
+of their scans have been received, and the rows of interlaced PNG images are reported during the
+last pass. The images of the other formats are decoded by finish().
+ */
+class CV_EXPORTS ImageStreamDecoder
+{
+public:
+    virtual ~ImageStreamDecoder();
+
+    /** @brief Appends the next part of the encoded image and decodes as much of it as possible.
+
+    @param data Vector of bytes.
+    @return false if the data are invalid or the image format is not supported.
+     */
+    virtual bool feed(InputArray data) = 0;
+
+    /** @brief Tells the decoder that the stream is complete.
+
+    Decodes the images of the formats that are not decoded incrementally, and the images too short
+    to have their format recognized.
+    @return true if the whole image has been decoded.
+     */
+    virtual bool finish() = 0;
+
+    //! true once the header has been decoded and image() is allocated
+    virtual bool headerDecoded() const = 0;
+
+    //! the image being decoded, of the type selected by the flags; it is empty until the header is decoded
+    virtual Mat image() const = 0;
+
+    //! number of the top rows of image() that have been decoded completely
+    virtual int decodedRows() const = 0;
+};
+
+/** @brief Creates the decoder of an image received in parts.
+
+@param flags The same flags as in imread, see @ref cv::ImreadModes.
+ */
+CV_EXPORTS Ptr<ImageStreamDecoder> createImageStreamDecoder(int flags = IMREAD_COLOR);
+
+/** @brief Reads the regions of an image file that does not have to fit into memory.
+
+Every region is decoded separately (see imread_region), so that only the strips or tiles of the
+file crossing it are decoded for TIFF images and the rasters read by GDAL. read() may be called
+from several threads at once.
+ */
+class CV_EXPORTS ImageTileReader
+{
+public:
+    virtual ~ImageTileReader();
+
+    //! size of the image
+    virtual Size size() const = 0;
+
+    //! type of the regions read, selected by the flags
+    virtual int type() const = 0;
+
+    //! size of the blocks the image is stored in; reading a region decodes the blocks crossing it
+    virtual Size tileSize() const = 0;
+
+    /** @brief Reads a region of the image.
+
+    @param roi The region of the image, clipped to it; an empty rectangle stands for the whole image.
+    @param dst The region read, reduced by scale_denom.
+    @param scale_denom The resolution of the region is reduced by this factor.
+     */
+    virtual bool read(const Rect& roi, Mat& dst, int scale_denom = 1) const = 0;
+};
+
+/** @brief Opens an image file for reading by regions.
+
+@param filename Name of the file.
+@param flags The same flags as in imread, see @ref cv::ImreadModes.
+@return The reader, or an empty pointer if the image header cannot be read.
+ */
+CV_EXPORTS Ptr<ImageTileReader> createImageTileReader(const String& filename,
+                                                      int flags = IMREAD_UNCHANGED);
+
+/** @brief Writes an image file that does not have to fit into memory by regions.
+
+TIFF images are written as tiled TIFF files, the size of the tiles can be set with the
+TIFFTAG_TILEWIDTH (322) and TIFFTAG_TILELENGTH (323) parameters, and they are stored in the BigTIFF
+format when they may exceed 4Gb. For the other formats the image is assembled in memory and saved
+by close().
+ */
+class CV_EXPORTS ImageTileWriter
+{
+public:
+    virtual ~ImageTileWriter();
+
+    //! size of the image
+    virtual Size size() const = 0;
+
+    //! type of the image
+    virtual int type() const = 0;
+
+    //! the regions written must start at the multiples of the tile size
+    virtual Size tileSize() const = 0;
+
+    /** @brief Writes a region of the image.
+
+    The regions may be written in any order and from several threads, every pixel of the image
+    once. Their top-left corners must be aligned to tileSize(), and so must be their sizes, except
+    at the right and bottom borders of the image.
+     */
+    virtual bool write(const Rect& roi, InputArray tile) = 0;
+
+    //! completes the file, it is called by the destructor too
+    virtual bool close() = 0;
+};
+
+/** @brief Creates a file to be written by regions.
+
+@param filename Name of the file, the format is chosen by its extension as in imwrite.
+@param size Size of the image.
+@param type Type of the image.
+@param params Format-specific parameters, see imwrite.
+@return The writer, or an empty pointer if the format is not recognized.
+ */
+CV_EXPORTS Ptr<ImageTileWriter> createImageTileWriter(const String& filename, Size size, int type,
+                                                      const std::vector<int>& params = std::vector<int>());
+
+/** @brief An operation on an image that can be computed region by region by processTiles.
+ */
+class CV_EXPORTS TileFilter
+{
+public:
+    virtual ~TileFilter();
+
+    //! size of the output image for the input image of the given size
+    virtual Size dstSize(Size srcSize) const;
+
+    //! type of the output image for the input image of the given type
+    virtual int dstType(int srcType) const;
+
+    /** @brief The region of the input image needed to compute a region of the output.
+
+    It may extend beyond the input image, processTiles clips it.
+     */
+    virtual Rect srcRegion(const Rect& dstRoi, Size srcSize) const = 0;
+
+    /** @brief Computes a region of the output image.
+
+    @param src The input region srcRoi, which is srcRegion(dstRoi, srcSize) clipped to the image.
+    @param srcRoi The position of src in the input image.
+    @param dst The output region, allocated by the caller.
+    @param dstRoi The position of dst in the output image.
+    @param srcSize Size of the input image.
+     */
+    virtual void apply(const Mat& src, const Rect& srcRoi, Mat& dst, const Rect& dstRoi,
+                       Size srcSize) const = 0;
+};
+
+//! an operation on the pixel neighborhoods of a region, see createNeighborhoodTileFilter
+typedef void (*TileFilterFunc)(const Mat& src, Mat& dst, void* userdata);
+
+/** @brief Creates a tile filter from a function computing a neighborhood operation.
+
+@param func The function. It is given the region of the input image with the borders of the halo
+size around it (they are clipped at the image borders) as the ROI of a bigger matrix, like
+GaussianBlur, filter2D, morphologyEx, Sobel and the other filters use them, and computes the output
+region of the same size.
+@param halo The size of the neighborhoods around the pixels, e.g. ksize/2 for a filter.
+@param dtype The output type, or -1 for the input one.
+@param userdata Passed to func.
+ */
+CV_EXPORTS Ptr<TileFilter> createNeighborhoodTileFilter(TileFilterFunc func, Size halo,
+                                                        int dtype = -1, void* userdata = 0);
+
+/** @brief Creates a tile filter resizing the image, see resize.
+
+The nearest-neighbor, bilinear, bicubic and Lanczos interpolation is computed as remapping, so the
+results are seamless across the tiles and close to resize. INTER_AREA gives the results of resize
+when the scale factors are integer.
+ */
+CV_EXPORTS Ptr<TileFilter> createResizeTileFilter(Size dsize, int interpolation);
+
+/** @brief Creates a tile filter applying an affine transformation to the image, see warpAffine.
+
+Only the needed parts of the input image are read for BORDER_CONSTANT, BORDER_REPLICATE and
+BORDER_TRANSPARENT, the other border modes read the whole image for every tile.
+ */
+CV_EXPORTS Ptr<TileFilter> createWarpAffineTileFilter(InputArray M, Size dsize, int flags,
+                                                      int borderMode = BORDER_CONSTANT,
+                                                      const Scalar& borderValue = Scalar());
+
+/** @brief Processes an image that does not have to fit into memory tile by tile.
+
+The output image is divided into tiles, computed in parallel: the input region needed for every
+tile is read with ImageTileReader, passed to the filter, and the result is written with
+ImageTileWriter, so only the tiles being processed are kept in memory when the files are in TIFF
+format (or are read by GDAL).
+
+@param src Name of the input file.
+@param dst Name of the output file.
+@param filter The operation.
+@param tileSize Size of the output tiles, aligned to the tiles of the output file. By default the
+tiles cover about a megapixel, they are full-width bands when the input image is stored by strips.
+@param params Format-specific parameters of the output file, see imwrite.
+@param flags The flags of reading the input image, see @ref cv::ImreadModes.
+@return false if the input cannot be read or the output cannot be written.
+ */
+CV_EXPORTS bool processTiles(const String& src, const String& dst, const Ptr<TileFilter>& filter,
+                             Size tileSize = Size(), const std::vector<int>& params = std::vector<int>(),
+                             int flags = IMREAD_UNCHANGED);
+
 /** @brief Encodes an image into a memory buffer.
 
 @param ext File extension that defines the output format.
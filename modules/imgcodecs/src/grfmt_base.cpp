@@ -52,7 +52,10 @@ BaseImageDecoder::BaseImageDecoder()
     m_width = m_height = 0;
     m_type = -1;
     m_buf_supported = false;
+    m_reusable = false;
     m_scale_denom = 1;
+    m_incr_flags = IMREAD_COLOR;
+    m_incr_rows = 0;
 }
 
 bool BaseImageDecoder::setSource( const String& filename )
@@ -94,6 +97,56 @@ ImageDecoder BaseImageDecoder::newDecoder() const
     return ImageDecoder();
 }
 
+int BaseImageDecoder::setRegion( const Rect&, int )
+{
+    m_roi = Rect();
+    return 0;
+}
+
+Size BaseImageDecoder::tileSize() const
+{
+    return Size( m_width, m_height );
+}
+
+bool BaseImageDecoder::startIncremental( int )
+{
+    return false;
+}
+
+bool BaseImageDecoder::feed( const uchar*, size_t )
+{
+    return false;
+}
+
+void BaseImageDecoder::createIncrementalImage()
+{
+    m_incr_img.create( m_height, m_width, calcImageType( m_type, m_incr_flags ) );
+    m_incr_rows = 0;
+}
+
+int calcImageType( int type, int flags )
+{
+    if( flags != IMREAD_UNCHANGED )
+    {
+        if( (flags & IMREAD_ANYDEPTH) == 0 )
+            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
+
+        if( (flags & IMREAD_COLOR) != 0 ||
+           ((flags & IMREAD_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1) )
+            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
+        else
+            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
+    }
+    return type;
+}
+
+Rect reduceRect( const Rect& r, int scale_denom )
+{
+    return Rect( r.x/scale_denom, r.y/scale_denom,
+                 (r.x + r.width + scale_denom - 1)/scale_denom - r.x/scale_denom,
+                 (r.y + r.height + scale_denom - 1)/scale_denom - r.y/scale_denom );
+}
+
 BaseImageEncoder::BaseImageEncoder()
 {
     m_buf_supported = false;
@@ -131,6 +184,26 @@ ImageEncoder BaseImageEncoder::newEncoder() const
     return ImageEncoder();
 }
 
+bool BaseImageEncoder::startTiles( Size, int, const std::vector<int>& )
+{
+    return false;
+}
+
+Size BaseImageEncoder::tileSize() const
+{
+    return Size();
+}
+
+bool BaseImageEncoder::writeTile( const Rect&, const Mat& )
+{
+    return false;
+}
+
+bool BaseImageEncoder::finishTiles()
+{
+    return false;
+}
+
 void BaseImageEncoder::throwOnEror() const
 {
     if(!m_last_error.empty())
@@ -78,7 +78,35 @@ public:
     virtual bool checkSignature( const String& signature ) const;
     virtual ImageDecoder newDecoder() const;
 
+    /// Restricts the following readData() to a region of the image, in the coordinates of the
+    /// full image, reduced by scale_denom. Returns the reduction the decoder applies itself
+    /// (the caller resizes by the rest), or 0 if it cannot decode regions. readData() is then given
+    /// the image of the size of reduceRect(roi, returned value).
+    virtual int setRegion( const Rect& roi, int scale_denom );
+
+    /// The size of the blocks (tiles or strips) the image is stored in. Reading a region decodes
+    /// the blocks crossing it, the whole image by default.
+    virtual Size tileSize() const;
+
+    /// true if the decoder can be given another source after decoding an image
+    bool isReusable() const { return m_reusable; }
+
+    /// Closes the file or the buffer stream opened by readHeader(), if the decoder keeps it open.
+    virtual void close() {}
+
+    /// Incremental decoding. startIncremental() returns false if the decoder does not support it.
+    /// Otherwise the encoded stream is passed by parts to feed(), which decodes as much of it as
+    /// possible: the header, after which the image of the type selected by the imread flags is
+    /// allocated, and then the rows. feed() returns false if the stream is invalid.
+    virtual bool startIncremental( int flags );
+    virtual bool feed( const uchar* data, size_t size );
+    const Mat& incrementalImage() const { return m_incr_img; }
+    int decodedRows() const { return m_incr_rows; }
+
 protected:
+    // allocates the incremental output once m_width, m_height and m_type are known
+    void createIncrementalImage();
+
     int  m_width;  // width  of the image ( filled by readHeader )
     int  m_height; // height of the image ( filled by readHeader )
     int  m_type;
@@ -87,8 +115,19 @@ protected:
     String m_signature;
     Mat m_buf;
     bool m_buf_supported;
+    bool m_reusable;
+    Rect m_roi; // region to decode, empty for the whole image
+    int m_incr_flags;
+    Mat m_incr_img;
+    int m_incr_rows;
 };
 
+/// the type of the image returned by imread for the decoded type and the imread flags
+int calcImageType( int type, int flags );
+
+/// the rectangle of the image reduced by scale_denom that covers the given rectangle of the full image
+Rect reduceRect( const Rect& r, int scale_denom );
+
 
 ///////////////////////////// base class for encoders ////////////////////////////
 class BaseImageEncoder
@@ -105,6 +144,15 @@ public:
     virtual String getDescription() const;
     virtual ImageEncoder newEncoder() const;
 
+    /// Writing by tiles, for images that are not kept in memory as a whole. startTiles() returns
+    /// false if the encoder does not support it. Otherwise writeTile() is called with the regions
+    /// aligned to tileSize() (they may end at the right and bottom borders of the image) in any
+    /// order, but not concurrently, and finishTiles() completes the file.
+    virtual bool startTiles( Size size, int type, const std::vector<int>& params );
+    virtual Size tileSize() const;
+    virtual bool writeTile( const Rect& roi, const Mat& tile );
+    virtual bool finishTiles();
+
     virtual void throwOnEror() const;
 
 protected:
@@ -339,14 +339,41 @@ void write_ctable_pixel( const double& pixelValue,
 /**
  * read data
 */
+/**
+ * Restrict the reading to a region of the raster
+*/
+int GdalDecoder::setRegion( const Rect& roi, int scale_denom ){
+
+    if( m_dataset == NULL ){
+        return 0;
+    }
+
+    // RasterIO reads a window of the raster into a buffer of any size
+    m_roi = roi;
+    return scale_denom;
+}
+
+/**
+ * Get the size of the blocks of the raster
+*/
+Size GdalDecoder::tileSize() const{
+
+    if( m_dataset == NULL ){
+        return Size(m_width, m_height);
+    }
+
+    int blockWidth = m_width, blockHeight = m_height;
+    m_dataset->GetRasterBand(1)->GetBlockSize( &blockWidth, &blockHeight );
+    return Size(blockWidth, blockHeight);
+}
+
 bool GdalDecoder::readData( Mat& img ){
 
+    // the window of the raster to read, into the whole image
+    Rect roi = m_roi.area() > 0 ? m_roi : Rect(0, 0, m_width, m_height);
 
     // make sure the image is the proper size
-    if( img.size().height != m_height ){
-        return false;
-    }
-    if( img.size().width != m_width ){
+    if( m_roi.area() == 0 && img.size() != roi.size() ){
         return false;
     }
 
@@ -382,9 +409,9 @@ bool GdalDecoder::readData( Mat& img ){
         // make sure the image band has the same dimensions as the image
         if( band->GetXSize() != m_width || band->GetYSize() != m_height ){ return false; }
 
-        // grab the raster size
-        nRows = band->GetYSize();
-        nCols = band->GetXSize();
+        // grab the size of the image to fill
+        nRows = img.rows;
+        nCols = img.cols;
 
         // create a temporary scanline pointer to store data
         double* scanline = new double[nCols];
@@ -392,8 +419,9 @@ bool GdalDecoder::readData( Mat& img ){
         // iterate over each row and column
         for( int y=0; y<nRows; y++ ){
 
-            // get the entire row
-            band->RasterIO( GF_Read, 0, y, nCols, 1, scanline, nCols, 1, GDT_Float64, 0, 0);
+            // get the entire row, from the rows of the window it covers
+            int y0 = roi.y + y*roi.height/nRows, y1 = roi.y + (y + 1)*roi.height/nRows;
+            band->RasterIO( GF_Read, roi.x, y0, roi.width, std::max(y1 - y0, 1), scanline, nCols, 1, GDT_Float64, 0, 0);
 
             // set inside the image
             for( int x=0; x<nCols; x++ ){
@@ -424,6 +452,9 @@ bool GdalDecoder::readData( Mat& img ){
 */
 bool GdalDecoder::readHeader(){
 
+    // read the whole raster unless a region is set
+    m_roi = Rect();
+
     // load the dataset
     m_dataset = (GDALDataset*) GDALOpen( m_filename.c_str(), GA_ReadOnly);
 
@@ -137,6 +137,16 @@ class GdalDecoder : public BaseImageDecoder{
         */
         ImageDecoder newDecoder() const;
 
+        /**
+         * Restrict the reading to a region, GDAL reduces the resolution too
+        */
+        int setRegion( const Rect& roi, int scale_denom );
+
+        /**
+         * Get the size of the blocks of the raster
+        */
+        Size tileSize() const;
+
         /**
          * Test the file signature
          *
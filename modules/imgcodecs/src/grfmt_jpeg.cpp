@@ -102,6 +102,7 @@ struct JpegState
     jpeg_decompress_struct cinfo; // IJG JPEG codec structure
     JpegErrorMgr jerr; // error processing manager state
     JpegSource source; // memory buffer source
+    JSAMPARRAY scanline; // row buffer of the incremental decoding
 };
 
 /////////////////////// Error processing /////////////////////
@@ -176,7 +177,9 @@ JpegDecoder::JpegDecoder()
     m_signature = "\xFF\xD8\xFF";
     m_state = 0;
     m_f = 0;
+    m_incr_stage = 0;
     m_buf_supported = true;
+    m_reusable = true;
 }
 
 
@@ -204,6 +207,7 @@ void  JpegDecoder::close()
 
     m_width = m_height = 0;
     m_type = -1;
+    m_roi = Rect();
 }
 
 ImageDecoder JpegDecoder::newDecoder() const
@@ -393,6 +397,96 @@ int my_jpeg_load_dht (struct jpeg_decompress_struct *info, unsigned char *dht,
  * based on a message of Laurent Pinchart on the video4linux mailing list
  ***************************************************************************/
 
+// selects the color space of the output of the decompressor for the image with the given channels
+static void setOutputColorSpace( jpeg_decompress_struct* cinfo, bool color )
+{
+    /* check if this is a mjpeg image format */
+    if ( cinfo->ac_huff_tbl_ptrs[0] == NULL &&
+        cinfo->ac_huff_tbl_ptrs[1] == NULL &&
+        cinfo->dc_huff_tbl_ptrs[0] == NULL &&
+        cinfo->dc_huff_tbl_ptrs[1] == NULL )
+    {
+        /* yes, this is a mjpeg image format, so load the correct
+        huffman table */
+        my_jpeg_load_dht( cinfo,
+            my_jpeg_odml_dht,
+            cinfo->ac_huff_tbl_ptrs,
+            cinfo->dc_huff_tbl_ptrs );
+    }
+
+    if( color )
+    {
+        if( cinfo->num_components != 4 )
+        {
+            cinfo->out_color_space = JCS_RGB;
+            cinfo->out_color_components = 3;
+        }
+        else
+        {
+            cinfo->out_color_space = JCS_CMYK;
+            cinfo->out_color_components = 4;
+        }
+    }
+    else
+    {
+        if( cinfo->num_components != 4 )
+        {
+            cinfo->out_color_space = JCS_GRAYSCALE;
+            cinfo->out_color_components = 1;
+        }
+        else
+        {
+            cinfo->out_color_space = JCS_CMYK;
+            cinfo->out_color_components = 4;
+        }
+    }
+}
+
+// converts a decompressed scanline to the output row
+static void convertScanline( const jpeg_decompress_struct* cinfo, const uchar* src,
+                             uchar* data, int width, bool color )
+{
+    if( color )
+    {
+        if( cinfo->out_color_components == 3 )
+            icvCvt_RGB2BGR_8u_C3R( src, 0, data, 0, cvSize(width,1) );
+        else
+            icvCvt_CMYK2BGR_8u_C4C3R( src, 0, data, 0, cvSize(width,1) );
+    }
+    else
+    {
+        if( cinfo->out_color_components == 1 )
+            memcpy( data, src, width );
+        else
+            icvCvt_CMYK2Gray_8u_C4C1R( src, 0, data, 0, cvSize(width,1) );
+    }
+}
+
+int  JpegDecoder::setRegion( const Rect& roi, int scale_denom )
+{
+    if( !m_state )
+        return 0;
+
+    jpeg_decompress_struct* cinfo = &((JpegState*)m_state)->cinfo;
+    JpegErrorMgr* jerr = &((JpegState*)m_state)->jerr;
+
+    // the decompressor scales by 1/2, 1/4 and 1/8, the caller resizes by the rest
+    int denom = 1;
+    while( denom < 8 && denom*2 <= scale_denom )
+        denom *= 2;
+
+    if( setjmp( jerr->setjmp_buffer ) != 0 )
+        return 0;
+
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = denom;
+    jpeg_calc_output_dimensions( cinfo );
+    m_width = cinfo->output_width;
+    m_height = cinfo->output_height;
+    m_roi = reduceRect( roi, denom ) & Rect( 0, 0, m_width, m_height );
+    return denom;
+}
+
 bool  JpegDecoder::readData( Mat& img )
 {
     volatile bool result = false;
@@ -404,76 +498,45 @@ bool  JpegDecoder::readData( Mat& img )
         jpeg_decompress_struct* cinfo = &((JpegState*)m_state)->cinfo;
         JpegErrorMgr* jerr = &((JpegState*)m_state)->jerr;
         JSAMPARRAY buffer = 0;
+        Rect roi = m_roi.area() > 0 ? m_roi : Rect( 0, 0, m_width, m_height );
 
         if( setjmp( jerr->setjmp_buffer ) == 0 )
         {
-            /* check if this is a mjpeg image format */
-            if ( cinfo->ac_huff_tbl_ptrs[0] == NULL &&
-                cinfo->ac_huff_tbl_ptrs[1] == NULL &&
-                cinfo->dc_huff_tbl_ptrs[0] == NULL &&
-                cinfo->dc_huff_tbl_ptrs[1] == NULL )
-            {
-                /* yes, this is a mjpeg image format, so load the correct
-                huffman table */
-                my_jpeg_load_dht( cinfo,
-                    my_jpeg_odml_dht,
-                    cinfo->ac_huff_tbl_ptrs,
-                    cinfo->dc_huff_tbl_ptrs );
-            }
-
-            if( color )
-            {
-                if( cinfo->num_components != 4 )
-                {
-                    cinfo->out_color_space = JCS_RGB;
-                    cinfo->out_color_components = 3;
-                }
-                else
-                {
-                    cinfo->out_color_space = JCS_CMYK;
-                    cinfo->out_color_components = 4;
-                }
-            }
-            else
-            {
-                if( cinfo->num_components != 4 )
-                {
-                    cinfo->out_color_space = JCS_GRAYSCALE;
-                    cinfo->out_color_components = 1;
-                }
-                else
-                {
-                    cinfo->out_color_space = JCS_CMYK;
-                    cinfo->out_color_components = 4;
-                }
-            }
+            setOutputColorSpace( cinfo, color );
 
             jpeg_start_decompress( cinfo );
 
             buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
                                               JPOOL_IMAGE, m_width*4, 1 );
 
+            // the columns and rows outside of the region are not decoded where libjpeg can skip them
+            int x0 = roi.x;
+#if defined LIBJPEG_TURBO_VERSION_NUMBER && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+            if( roi.width < m_width )
+            {
+                JDIMENSION xoffset = roi.x, width = roi.width;
+                jpeg_crop_scanline( cinfo, &xoffset, &width );
+                x0 = roi.x - (int)xoffset;
+            }
+            if( roi.y > 0 )
+                jpeg_skip_scanlines( cinfo, roi.y );
+#else
+            for( int y = 0; y < roi.y; y++ )
+                jpeg_read_scanlines( cinfo, buffer, 1 );
+#endif
+            x0 *= cinfo->out_color_components;
+
             uchar* data = img.ptr();
-            for( ; m_height--; data += step )
+            for( int y = 0; y < roi.height; y++, data += step )
             {
                 jpeg_read_scanlines( cinfo, buffer, 1 );
-                if( color )
-                {
-                    if( cinfo->out_color_components == 3 )
-                        icvCvt_RGB2BGR_8u_C3R( buffer[0], 0, data, 0, cvSize(m_width,1) );
-                    else
-                        icvCvt_CMYK2BGR_8u_C4C3R( buffer[0], 0, data, 0, cvSize(m_width,1) );
-                }
-                else
-                {
-                    if( cinfo->out_color_components == 1 )
-                        memcpy( data, buffer[0], m_width );
-                    else
-                        icvCvt_CMYK2Gray_8u_C4C1R( buffer[0], 0, data, 0, cvSize(m_width,1) );
-                }
+                convertScanline( cinfo, buffer[0] + x0, data, roi.width, color );
             }
             result = true;
-            jpeg_finish_decompress( cinfo );
+
+            // the rows below the region are left undecoded
+            if( cinfo->output_scanline == cinfo->output_height )
+                jpeg_finish_decompress( cinfo );
         }
     }
 
@@ -481,6 +544,96 @@ bool  JpegDecoder::readData( Mat& img )
     return result;
 }
 
+bool  JpegDecoder::startIncremental( int flags )
+{
+    volatile bool result = false;
+    close();
+    m_incr_flags = flags;
+    m_incr_img.release();
+    m_incr_rows = 0;
+    m_incr_stage = 0;
+    m_incr_buf.clear();
+
+    JpegState* state = new JpegState;
+    m_state = state;
+    state->cinfo.err = jpeg_std_error(&state->jerr.pub);
+    state->jerr.pub.error_exit = error_exit;
+    state->scanline = 0;
+
+    if( setjmp( state->jerr.setjmp_buffer ) == 0 )
+    {
+        jpeg_create_decompress( &state->cinfo );
+        jpeg_buffer_src( &state->cinfo, &state->source );
+        result = true;
+    }
+
+    if( !result )
+        close();
+
+    return result;
+}
+
+bool  JpegDecoder::feed( const uchar* data, size_t size )
+{
+    JpegState* state = (JpegState*)m_state;
+    if( !state )
+        return false;
+
+    jpeg_decompress_struct* cinfo = &state->cinfo;
+    JpegSource* source = &state->source;
+
+    // keep the data the decompressor has not consumed yet, it resumes from there
+    m_incr_buf.erase( m_incr_buf.begin(), m_incr_buf.end() - source->pub.bytes_in_buffer );
+    if( source->skip > 0 )
+    {
+        size_t skip = std::min( size, (size_t)source->skip );
+        source->skip -= (int)skip;
+        data += skip;
+        size -= skip;
+    }
+    m_incr_buf.insert( m_incr_buf.end(), data, data + size );
+    source->pub.next_input_byte = m_incr_buf.empty() ? 0 : &m_incr_buf[0];
+    source->pub.bytes_in_buffer = m_incr_buf.size();
+
+    if( setjmp( state->jerr.setjmp_buffer ) == 0 )
+    {
+        if( m_incr_stage == 0 )
+        {
+            if( jpeg_read_header( cinfo, TRUE ) == JPEG_SUSPENDED )
+                return true;
+            m_width = cinfo->image_width;
+            m_height = cinfo->image_height;
+            m_type = cinfo->num_components > 1 ? CV_8UC3 : CV_8UC1;
+            createIncrementalImage();
+            setOutputColorSpace( cinfo, m_incr_img.channels() > 1 );
+            m_incr_stage = 1;
+        }
+
+        if( m_incr_stage == 1 )
+        {
+            // progressive images are buffered here until all the scans are received
+            if( !jpeg_start_decompress( cinfo ) )
+                return true;
+            state->scanline = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
+                                                    JPOOL_IMAGE, m_width*4, 1 );
+            m_incr_stage = 2;
+        }
+
+        bool color = m_incr_img.channels() > 1;
+        while( m_incr_rows < m_height )
+        {
+            if( jpeg_read_scanlines( cinfo, state->scanline, 1 ) == 0 )
+                return true;
+            convertScanline( cinfo, state->scanline[0], m_incr_img.ptr(m_incr_rows), m_width, color );
+            m_incr_rows++;
+        }
+        return true;
+    }
+
+    close();
+    return false;
+}
+
 
 /////////////////////// JpegEncoder ///////////////////
 
@@ -64,12 +64,19 @@ public:
     bool  readHeader();
     void  close();
 
+    int   setRegion( const Rect& roi, int scale_denom );
+
+    bool  startIncremental( int flags );
+    bool  feed( const uchar* data, size_t size );
+
     ImageDecoder newDecoder() const;
 
 protected:
 
     FILE* m_f;
     void* m_state;
+    int   m_incr_stage; // 0 - reading the header, 1 - starting the decompression, 2 - reading the rows
+    std::vector<uchar> m_incr_buf; // received data not consumed by the decompressor yet
 };
 
 
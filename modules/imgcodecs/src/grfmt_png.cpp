@@ -90,7 +90,9 @@ PngDecoder::PngDecoder()
     m_info_ptr = m_end_info = 0;
     m_f = 0;
     m_buf_supported = true;
+    m_reusable = true;
     m_buf_pos = 0;
+    m_incr_passes = 1;
 }
 
 
@@ -120,6 +122,7 @@ void  PngDecoder::close()
         png_destroy_read_struct( &png_ptr, &info_ptr, &end_info );
         m_png_ptr = m_info_ptr = m_end_info = 0;
     }
+    m_roi = Rect();
 }
 
 
@@ -170,46 +173,8 @@ bool  PngDecoder::readHeader()
 
                 if( !m_buf.empty() || m_f )
                 {
-                    png_uint_32 wdth, hght;
-                    int bit_depth, color_type, num_trans=0;
-                    png_bytep trans;
-                    png_color_16p trans_values;
-
                     png_read_info( png_ptr, info_ptr );
-
-                    png_get_IHDR( png_ptr, info_ptr, &wdth, &hght,
-                                  &bit_depth, &color_type, 0, 0, 0 );
-
-                    m_width = (int)wdth;
-                    m_height = (int)hght;
-                    m_color_type = color_type;
-                    m_bit_depth = bit_depth;
-
-                    if( bit_depth <= 8 || bit_depth == 16 )
-                    {
-                        switch(color_type)
-                        {
-                            case PNG_COLOR_TYPE_RGB:
-                                m_type = CV_8UC3;
-                                break;
-                            case PNG_COLOR_TYPE_PALETTE:
-                                png_get_tRNS( png_ptr, info_ptr, &trans, &num_trans, &trans_values);
-                                //Check if there is a transparency value in the palette
-                                if ( num_trans > 0 )
-                                    m_type = CV_8UC4;
-                                else
-                                    m_type = CV_8UC3;
-                                break;
-                            case PNG_COLOR_TYPE_RGB_ALPHA:
-                                m_type = CV_8UC4;
-                                break;
-                            default:
-                                m_type = CV_8UC1;
-                        }
-                        if( bit_depth == 16 )
-                            m_type = CV_MAKETYPE(CV_16U, CV_MAT_CN(m_type));
-                        result = true;
-                    }
+                    result = processInfo();
                 }
             }
         }
@@ -222,76 +187,243 @@ bool  PngDecoder::readHeader()
 }
 
 
+bool  PngDecoder::processInfo()
+{
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    png_infop info_ptr = (png_infop)m_info_ptr;
+    png_uint_32 wdth, hght;
+    int bit_depth, color_type, num_trans=0;
+    png_bytep trans;
+    png_color_16p trans_values;
+
+    png_get_IHDR( png_ptr, info_ptr, &wdth, &hght,
+                  &bit_depth, &color_type, 0, 0, 0 );
+
+    m_width = (int)wdth;
+    m_height = (int)hght;
+    m_color_type = color_type;
+    m_bit_depth = bit_depth;
+
+    if( bit_depth <= 8 || bit_depth == 16 )
+    {
+        switch(color_type)
+        {
+            case PNG_COLOR_TYPE_RGB:
+                m_type = CV_8UC3;
+                break;
+            case PNG_COLOR_TYPE_PALETTE:
+                png_get_tRNS( png_ptr, info_ptr, &trans, &num_trans, &trans_values);
+                //Check if there is a transparency value in the palette
+                if ( num_trans > 0 )
+                    m_type = CV_8UC4;
+                else
+                    m_type = CV_8UC3;
+                break;
+            case PNG_COLOR_TYPE_RGB_ALPHA:
+                m_type = CV_8UC4;
+                break;
+            default:
+                m_type = CV_8UC1;
+        }
+        if( bit_depth == 16 )
+            m_type = CV_MAKETYPE(CV_16U, CV_MAT_CN(m_type));
+        return true;
+    }
+    return false;
+}
+
+
+int  PngDecoder::setTransforms( int type )
+{
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    int color = CV_MAT_CN(type) > 1;
+
+    if( CV_MAT_DEPTH(type) == CV_8U && m_bit_depth == 16 )
+        png_set_strip_16( png_ptr );
+    else if( !isBigEndian() )
+        png_set_swap( png_ptr );
+
+    if( CV_MAT_CN(type) < 4 )
+    {
+        /* observation: png_read_image() writes 400 bytes beyond
+         * end of data when reading a 400x118 color png
+         * "mpplus_sand.png".  OpenCV crashes even with demo
+         * programs.  Looking at the loaded image I'd say we get 4
+         * bytes per pixel instead of 3 bytes per pixel.  Test
+         * indicate that it is a good idea to always ask for
+         * stripping alpha..  18.11.2004 Axel Walthelm
+         */
+         png_set_strip_alpha( png_ptr );
+    }
+
+    if( m_color_type == PNG_COLOR_TYPE_PALETTE )
+        png_set_palette_to_rgb( png_ptr );
+
+    if( m_color_type == PNG_COLOR_TYPE_GRAY && m_bit_depth < 8 )
+#if (PNG_LIBPNG_VER_MAJOR*10000 + PNG_LIBPNG_VER_MINOR*100 + PNG_LIBPNG_VER_RELEASE >= 10209) || \
+    (PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR == 0 && PNG_LIBPNG_VER_RELEASE >= 18)
+        png_set_expand_gray_1_2_4_to_8( png_ptr );
+#else
+        png_set_gray_1_2_4_to_8( png_ptr );
+#endif
+
+    if( CV_MAT_CN(m_type) > 1 && color )
+        png_set_bgr( png_ptr ); // convert RGB to BGR
+    else if( color )
+        png_set_gray_to_rgb( png_ptr ); // Gray->RGB
+    else
+        png_set_rgb_to_gray( png_ptr, 1, 0.299, 0.587 ); // RGB->Gray
+
+    int passes = png_set_interlace_handling( png_ptr );
+    png_read_update_info( png_ptr, (png_infop)m_info_ptr );
+    return passes;
+}
+
+
+int  PngDecoder::setRegion( const Rect& roi, int )
+{
+    // the rows of interlaced images are complete only after the last pass
+    if( !m_png_ptr || png_get_interlace_type( (png_structp)m_png_ptr, (png_infop)m_info_ptr ) != PNG_INTERLACE_NONE )
+        return 0;
+    m_roi = roi;
+    return 1;
+}
+
+
 bool  PngDecoder::readData( Mat& img )
 {
     volatile bool result = false;
     AutoBuffer<uchar*> _buffer(m_height);
     uchar** buffer = _buffer;
-    int color = img.channels() > 1;
     uchar* data = img.ptr();
     int step = (int)img.step;
 
     if( m_png_ptr && m_info_ptr && m_end_info && m_width && m_height )
     {
         png_structp png_ptr = (png_structp)m_png_ptr;
-        png_infop info_ptr = (png_infop)m_info_ptr;
         png_infop end_info = (png_infop)m_end_info;
 
         if( setjmp( png_jmpbuf ( png_ptr ) ) == 0 )
         {
             int y;
 
-            if( img.depth() == CV_8U && m_bit_depth == 16 )
-                png_set_strip_16( png_ptr );
-            else if( !isBigEndian() )
-                png_set_swap( png_ptr );
+            setTransforms( img.type() );
 
-            if(img.channels() < 4)
+            if( m_roi.area() > 0 )
             {
-                /* observation: png_read_image() writes 400 bytes beyond
-                 * end of data when reading a 400x118 color png
-                 * "mpplus_sand.png".  OpenCV crashes even with demo
-                 * programs.  Looking at the loaded image I'd say we get 4
-                 * bytes per pixel instead of 3 bytes per pixel.  Test
-                 * indicate that it is a good idea to always ask for
-                 * stripping alpha..  18.11.2004 Axel Walthelm
-                 */
-                 png_set_strip_alpha( png_ptr );
+                // the rows are decompressed one by one up to the bottom of the region,
+                // the rest of the image is not read
+                std::vector<uchar> row( png_get_rowbytes( png_ptr, (png_infop)m_info_ptr ) );
+                size_t offset = m_roi.x*img.elemSize(), size = m_roi.width*img.elemSize();
+                for( y = 0; y < m_roi.y + m_roi.height; y++ )
+                {
+                    png_read_row( png_ptr, &row[0], 0 );
+                    if( y >= m_roi.y )
+                        memcpy( data + (y - m_roi.y)*step, &row[offset], size );
+                }
+                if( y == m_height )
+                    png_read_end( png_ptr, end_info );
             }
+            else
+            {
+                for( y = 0; y < m_height; y++ )
+                    buffer[y] = data + y*step;
 
-            if( m_color_type == PNG_COLOR_TYPE_PALETTE )
-                png_set_palette_to_rgb( png_ptr );
+                png_read_image( png_ptr, buffer );
+                png_read_end( png_ptr, end_info );
+            }
 
-            if( m_color_type == PNG_COLOR_TYPE_GRAY && m_bit_depth < 8 )
-#if (PNG_LIBPNG_VER_MAJOR*10000 + PNG_LIBPNG_VER_MINOR*100 + PNG_LIBPNG_VER_RELEASE >= 10209) || \
-    (PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR == 0 && PNG_LIBPNG_VER_RELEASE >= 18)
-                png_set_expand_gray_1_2_4_to_8( png_ptr );
-#else
-                png_set_gray_1_2_4_to_8( png_ptr );
-#endif
+            result = true;
+        }
+    }
 
-            if( CV_MAT_CN(m_type) > 1 && color )
-                png_set_bgr( png_ptr ); // convert RGB to BGR
-            else if( color )
-                png_set_gray_to_rgb( png_ptr ); // Gray->RGB
-            else
-                png_set_rgb_to_gray( png_ptr, 1, 0.299, 0.587 ); // RGB->Gray
+    close();
+    return result;
+}
 
-            png_set_interlace_handling( png_ptr );
-            png_read_update_info( png_ptr, info_ptr );
 
-            for( y = 0; y < m_height; y++ )
-                buffer[y] = data + y*step;
+bool  PngDecoder::startIncremental( int flags )
+{
+    close();
+    m_incr_flags = flags;
+    m_incr_img.release();
+    m_incr_rows = 0;
+    m_incr_passes = 1;
 
-            png_read_image( png_ptr, buffer );
-            png_read_end( png_ptr, end_info );
+    png_structp png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, 0, 0, 0 );
+    if( !png_ptr )
+        return false;
 
-            result = true;
-        }
+    png_infop info_ptr = png_create_info_struct( png_ptr );
+    png_infop end_info = png_create_info_struct( png_ptr );
+    m_png_ptr = png_ptr;
+    m_info_ptr = info_ptr;
+    m_end_info = end_info;
+
+    if( !info_ptr || !end_info )
+    {
+        close();
+        return false;
+    }
+
+    png_set_progressive_read_fn( png_ptr, this, (png_progressive_info_ptr)infoCallback,
+                                 (png_progressive_row_ptr)rowCallback,
+                                 (png_progressive_end_ptr)endCallback );
+    return true;
+}
+
+
+bool  PngDecoder::feed( const uchar* data, size_t size )
+{
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    if( !png_ptr )
+        return false;
+
+    if( setjmp( png_jmpbuf( png_ptr ) ) == 0 )
+    {
+        if( size > 0 )
+            png_process_data( png_ptr, (png_infop)m_info_ptr, (png_bytep)data, size );
+        return true;
     }
 
     close();
-    return result;
+    return false;
+}
+
+
+void  PngDecoder::infoCallback( void* _png_ptr, void* )
+{
+    png_structp png_ptr = (png_structp)_png_ptr;
+    PngDecoder* decoder = (PngDecoder*)png_get_progressive_ptr( png_ptr );
+    CV_Assert( decoder );
+
+    if( !decoder->processInfo() )
+        png_error( png_ptr, "Unsupported PNG bit depth" );
+    decoder->createIncrementalImage();
+    decoder->m_incr_passes = decoder->setTransforms( decoder->m_incr_img.type() );
+}
+
+
+void  PngDecoder::rowCallback( void* _png_ptr, uchar* row, unsigned row_num, int pass )
+{
+    png_structp png_ptr = (png_structp)_png_ptr;
+    PngDecoder* decoder = (PngDecoder*)png_get_progressive_ptr( png_ptr );
+    CV_Assert( decoder && row_num < (unsigned)decoder->m_height );
+
+    if( row )
+        png_progressive_combine_row( png_ptr, decoder->m_incr_img.ptr(row_num), row );
+
+    // the rows of an interlaced image are complete by the last pass, which goes from top to bottom
+    if( pass == decoder->m_incr_passes - 1 )
+        decoder->m_incr_rows = std::max( decoder->m_incr_rows, (int)row_num + 1 );
+}
+
+
+void  PngDecoder::endCallback( void* _png_ptr, void* )
+{
+    PngDecoder* decoder = (PngDecoder*)png_get_progressive_ptr( (png_structp)_png_ptr );
+    CV_Assert( decoder );
+    decoder->m_incr_rows = decoder->m_height;
 }
 
 
@@ -62,11 +62,22 @@ public:
     bool  readHeader();
     void  close();
 
+    int   setRegion( const Rect& roi, int scale_denom );
+
+    bool  startIncremental( int flags );
+    bool  feed( const uchar* data, size_t size );
+
     ImageDecoder newDecoder() const;
 
 protected:
 
     static void readDataFromBuf(void* png_ptr, uchar* dst, size_t size);
+    static void infoCallback(void* png_ptr, void* info_ptr);
+    static void rowCallback(void* png_ptr, uchar* row, unsigned row_num, int pass);
+    static void endCallback(void* png_ptr, void* info_ptr);
+
+    bool  processInfo();
+    int   setTransforms( int type );
 
     int   m_bit_depth;
     void* m_png_ptr;  // pointer to decompression structure
@@ -75,6 +86,7 @@ protected:
     FILE* m_f;
     int   m_color_type;
     size_t m_buf_pos;
+    int   m_incr_passes; // number of the interlace passes of the incremental decoding
 };
 
 
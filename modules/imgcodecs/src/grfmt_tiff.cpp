@@ -118,6 +118,7 @@ ImageDecoder TiffDecoder::newDecoder() const
 bool TiffDecoder::readHeader()
 {
     bool result = false;
+    m_roi = Rect();
 
     TIFF* tif = static_cast<TIFF*>(m_tif);
     if (!m_tif)
@@ -194,6 +195,31 @@ bool TiffDecoder::nextPage()
            readHeader();
 }
 
+int  TiffDecoder::setRegion( const Rect& roi, int )
+{
+    if( !m_tif || m_hdr )
+        return 0;
+    m_roi = roi;
+    return 1;
+}
+
+Size  TiffDecoder::tileSize() const
+{
+    TIFF* tif = (TIFF*)m_tif;
+    uint32 tile_width0 = m_width, tile_height0 = m_height;
+    if( tif && !m_hdr )
+    {
+        if( TIFFIsTiled(tif) )
+        {
+            TIFFGetField( tif, TIFFTAG_TILEWIDTH, &tile_width0 );
+            TIFFGetField( tif, TIFFTAG_TILELENGTH, &tile_height0 );
+        }
+        else
+            TIFFGetField( tif, TIFFTAG_ROWSPERSTRIP, &tile_height0 );
+    }
+    return Size( std::min( (int)tile_width0, m_width ), std::min( (int)tile_height0, m_height ) );
+}
+
 bool  TiffDecoder::readData( Mat& img )
 {
     if(m_hdr && img.type() == CV_32FC3)
@@ -203,6 +229,7 @@ bool  TiffDecoder::readData( Mat& img )
     bool result = false;
     bool color = img.channels() > 1;
     uchar* data = img.ptr();
+    size_t step = img.step;
 
     if( img.depth() != CV_8U && img.depth() != CV_16U && img.depth() != CV_32F && img.depth() != CV_64F )
         return false;
@@ -255,13 +282,33 @@ bool  TiffDecoder::readData( Mat& img )
             double* buffer64 = (double*)buffer;
             int tileidx = 0;
 
-            for( y = 0; y < m_height; y += tile_height0, data += img.step*tile_height0 )
+            // with a region, the strips and tiles crossing it are decoded into a band
+            // of the image and only the region is copied from there
+            Mat band;
+            if( m_roi.area() > 0 )
+            {
+                band.create( tile_height0, m_width, img.type() );
+                data = band.ptr();
+                step = band.step;
+            }
+
+            for( y = 0; y < m_height; y += tile_height0 )
             {
                 int tile_height = tile_height0;
 
                 if( y + tile_height > m_height )
                     tile_height = m_height - y;
 
+                if( band.empty() )
+                    data = img.ptr(y);
+                else if( y >= m_roi.y + m_roi.height )
+                    break;
+                else if( y + tile_height <= m_roi.y )
+                {
+                    tileidx += (m_width + tile_width0 - 1)/tile_width0;
+                    continue;
+                }
+
                 for( x = 0; x < m_width; x += tile_width0, tileidx++ )
                 {
                     int tile_width = tile_width0, ok;
@@ -269,6 +316,9 @@ bool  TiffDecoder::readData( Mat& img )
                     if( x + tile_width > m_width )
                         tile_width = m_width - x;
 
+                    if( !band.empty() && (x >= m_roi.x + m_roi.width || x + tile_width <= m_roi.x) )
+                        continue;
+
                     switch(dst_bpp)
                     {
                         case 8:
@@ -294,19 +344,19 @@ bool  TiffDecoder::readData( Mat& img )
                                     if (wanted_channels == 4)
                                     {
                                         icvCvt_BGRA2RGBA_8u_C4R( bstart + i*tile_width0*4, 0,
-                                                             data + x*4 + img.step*(tile_height - i - 1), 0,
+                                                             data + x*4 + step*(tile_height - i - 1), 0,
                                                              cvSize(tile_width,1) );
                                     }
                                     else
                                     {
                                         icvCvt_BGRA2BGR_8u_C4C3R( bstart + i*tile_width0*4, 0,
-                                                             data + x*3 + img.step*(tile_height - i - 1), 0,
+                                                             data + x*3 + step*(tile_height - i - 1), 0,
                                                              cvSize(tile_width,1), 2 );
                                     }
                                 }
                                 else
                                     icvCvt_BGRA2Gray_8u_C4C1R( bstart + i*tile_width0*4, 0,
-                                                              data + x + img.step*(tile_height - i - 1), 0,
+                                                              data + x + step*(tile_height - i - 1), 0,
                                                               cvSize(tile_width,1), 2 );
                             break;
                         }
@@ -331,13 +381,13 @@ bool  TiffDecoder::readData( Mat& img )
                                     if( ncn == 1 )
                                     {
                                         icvCvt_Gray2BGR_16u_C1C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                                  (ushort*)(data + img.step*i) + x*3, 0,
+                                                                  (ushort*)(data + step*i) + x*3, 0,
                                                                   cvSize(tile_width,1) );
                                     }
                                     else if( ncn == 3 )
                                     {
                                         icvCvt_RGB2BGR_16u_C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                               (ushort*)(data + img.step*i) + x*3, 0,
+                                                               (ushort*)(data + step*i) + x*3, 0,
                                                                cvSize(tile_width,1) );
                                     }
                                     else if (ncn == 4)
@@ -345,20 +395,20 @@ bool  TiffDecoder::readData( Mat& img )
                                         if (wanted_channels == 4)
                                         {
                                             icvCvt_BGRA2RGBA_16u_C4R(buffer16 + i*tile_width0*ncn, 0,
-                                                (ushort*)(data + img.step*i) + x * 4, 0,
+                                                (ushort*)(data + step*i) + x * 4, 0,
                                                 cvSize(tile_width, 1));
                                         }
                                         else
                                         {
                                             icvCvt_BGRA2BGR_16u_C4C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                (ushort*)(data + img.step*i) + x * 3, 0,
+                                                (ushort*)(data + step*i) + x * 3, 0,
                                                 cvSize(tile_width, 1), 2);
                                         }
                                     }
                                     else
                                     {
                                         icvCvt_BGRA2BGR_16u_C4C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                               (ushort*)(data + img.step*i) + x*3, 0,
+                                                               (ushort*)(data + step*i) + x*3, 0,
                                                                cvSize(tile_width,1), 2 );
                                     }
                                 }
@@ -366,14 +416,14 @@ bool  TiffDecoder::readData( Mat& img )
                                 {
                                     if( ncn == 1 )
                                     {
-                                        memcpy((ushort*)(data + img.step*i)+x,
+                                        memcpy((ushort*)(data + step*i)+x,
                                                buffer16 + i*tile_width0*ncn,
                                                tile_width*sizeof(buffer16[0]));
                                     }
                                     else
                                     {
                                         icvCvt_BGRA2Gray_16u_CnC1R(buffer16 + i*tile_width0*ncn, 0,
-                                                               (ushort*)(data + img.step*i) + x, 0,
+                                                               (ushort*)(data + step*i) + x, 0,
                                                                cvSize(tile_width,1), ncn, 2 );
                                     }
                                 }
@@ -399,13 +449,13 @@ bool  TiffDecoder::readData( Mat& img )
                             {
                                 if(dst_bpp == 32)
                                 {
-                                    memcpy((float*)(data + img.step*i)+x,
+                                    memcpy((float*)(data + step*i)+x,
                                            buffer32 + i*tile_width0*ncn,
                                            tile_width*sizeof(buffer32[0]));
                                 }
                                 else
                                 {
-                                    memcpy((double*)(data + img.step*i)+x,
+                                    memcpy((double*)(data + step*i)+x,
                                          buffer64 + i*tile_width0*ncn,
                                          tile_width*sizeof(buffer64[0]));
                                 }
@@ -420,6 +470,13 @@ bool  TiffDecoder::readData( Mat& img )
                         }
                     }
                 }
+
+                if( !band.empty() )
+                {
+                    Rect r = Rect( 0, y, m_width, tile_height ) & m_roi;
+                    band( Rect( r.x, r.y - y, r.width, r.height ) ).copyTo(
+                        img( Rect( r.x - m_roi.x, r.y - m_roi.y, r.width, r.height ) ) );
+                }
             }
 
             result = true;
@@ -469,6 +526,8 @@ TiffEncoder::TiffEncoder()
     m_description = "TIFF Files (*.tiff;*.tif)";
 #ifdef HAVE_TIFF
     m_buf_supported = false;
+    m_tiles_tif = 0;
+    m_tiles_type = -1;
 #else
     m_buf_supported = true;
 #endif
@@ -476,6 +535,10 @@ TiffEncoder::TiffEncoder()
 
 TiffEncoder::~TiffEncoder()
 {
+#ifdef HAVE_TIFF
+    if( m_tiles_tif )
+        TIFFClose( (TIFF*)m_tiles_tif );
+#endif
 }
 
 ImageEncoder TiffEncoder::newEncoder() const
@@ -514,6 +577,54 @@ static void readParam(const std::vector<int>& params, int key, int& value)
         }
 }
 
+static bool setTiffFields( TIFF* tif, int width, int height, int bitsPerChannel, int channels,
+                           const std::vector<int>& params )
+{
+    // defaults for now, maybe base them on params in the future
+    int   compression  = COMPRESSION_LZW;
+    int   predictor    = PREDICTOR_HORIZONTAL;
+
+    readParam(params, TIFFTAG_COMPRESSION, compression);
+    readParam(params, TIFFTAG_PREDICTOR, predictor);
+
+    int   colorspace = channels > 1 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK;
+
+    return TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width)
+        && TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height)
+        && TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bitsPerChannel)
+        && TIFFSetField(tif, TIFFTAG_COMPRESSION, compression)
+        && TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, colorspace)
+        && TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, channels)
+        && TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG)
+        && (compression == COMPRESSION_NONE || TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor));
+}
+
+// converts a row of the image to the TIFF channel order
+static bool convertTiffRow( const uchar* src, uchar* dst, int width, int channels, int depth )
+{
+    switch(channels)
+    {
+        case 1:
+            memcpy(dst, src, width*(depth == CV_8U ? 1 : 2));
+            return true;
+
+        case 3:
+            if (depth == CV_8U)
+                icvCvt_BGR2RGB_8u_C3R( src, 0, dst, 0, cvSize(width,1) );
+            else
+                icvCvt_BGR2RGB_16u_C3R( (const ushort*)src, 0, (ushort*)dst, 0, cvSize(width,1) );
+            return true;
+
+        case 4:
+            if (depth == CV_8U)
+                icvCvt_BGRA2RGBA_8u_C4R( src, 0, dst, 0, cvSize(width,1) );
+            else
+                icvCvt_BGRA2RGBA_16u_C4R( (const ushort*)src, 0, (ushort*)dst, 0, cvSize(width,1) );
+            return true;
+    }
+    return false;
+}
+
 bool  TiffEncoder::writeLibTiff( const Mat& img, const std::vector<int>& params)
 {
     int channels = img.channels();
@@ -560,22 +671,7 @@ bool  TiffEncoder::writeLibTiff( const Mat& img, const std::vector<int>& params)
         return false;
     }
 
-    // defaults for now, maybe base them on params in the future
-    int   compression  = COMPRESSION_LZW;
-    int   predictor    = PREDICTOR_HORIZONTAL;
-
-    readParam(params, TIFFTAG_COMPRESSION, compression);
-    readParam(params, TIFFTAG_PREDICTOR, predictor);
-
-    int   colorspace = channels > 1 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK;
-
-    if ( !TIFFSetField(pTiffHandle, TIFFTAG_IMAGEWIDTH, width)
-      || !TIFFSetField(pTiffHandle, TIFFTAG_IMAGELENGTH, height)
-      || !TIFFSetField(pTiffHandle, TIFFTAG_BITSPERSAMPLE, bitsPerChannel)
-      || !TIFFSetField(pTiffHandle, TIFFTAG_COMPRESSION, compression)
-      || !TIFFSetField(pTiffHandle, TIFFTAG_PHOTOMETRIC, colorspace)
-      || !TIFFSetField(pTiffHandle, TIFFTAG_SAMPLESPERPIXEL, channels)
-      || !TIFFSetField(pTiffHandle, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG)
+    if ( !setTiffFields(pTiffHandle, width, height, bitsPerChannel, channels, params)
       || !TIFFSetField(pTiffHandle, TIFFTAG_ROWSPERSTRIP, rowsPerStrip)
        )
     {
@@ -583,12 +679,6 @@ bool  TiffEncoder::writeLibTiff( const Mat& img, const std::vector<int>& params)
         return false;
     }
 
-    if (compression != COMPRESSION_NONE && !TIFFSetField(pTiffHandle, TIFFTAG_PREDICTOR, predictor) )
-    {
-        TIFFClose(pTiffHandle);
-        return false;
-    }
-
     // row buffer, because TIFFWriteScanline modifies the original data!
     size_t scanlineSize = TIFFScanlineSize(pTiffHandle);
     AutoBuffer<uchar> _buffer(scanlineSize+32);
@@ -601,37 +691,10 @@ bool  TiffEncoder::writeLibTiff( const Mat& img, const std::vector<int>& params)
 
     for (int y = 0; y < height; ++y)
     {
-        switch(channels)
+        if (!convertTiffRow(img.ptr(y), buffer, width, channels, depth))
         {
-            case 1:
-            {
-                memcpy(buffer, img.ptr(y), scanlineSize);
-                break;
-            }
-
-            case 3:
-            {
-                if (depth == CV_8U)
-                    icvCvt_BGR2RGB_8u_C3R( img.ptr(y), 0, buffer, 0, cvSize(width,1) );
-                else
-                    icvCvt_BGR2RGB_16u_C3R( img.ptr<ushort>(y), 0, (ushort*)buffer, 0, cvSize(width,1) );
-                break;
-            }
-
-            case 4:
-            {
-                if (depth == CV_8U)
-                    icvCvt_BGRA2RGBA_8u_C4R( img.ptr(y), 0, buffer, 0, cvSize(width,1) );
-                else
-                    icvCvt_BGRA2RGBA_16u_C4R( img.ptr<ushort>(y), 0, (ushort*)buffer, 0, cvSize(width,1) );
-                break;
-            }
-
-            default:
-            {
-                TIFFClose(pTiffHandle);
-                return false;
-            }
+            TIFFClose(pTiffHandle);
+            return false;
         }
 
         int writeResult = TIFFWriteScanline(pTiffHandle, buffer, y, 0);
@@ -646,6 +709,91 @@ bool  TiffEncoder::writeLibTiff( const Mat& img, const std::vector<int>& params)
     return true;
 }
 
+bool TiffEncoder::startTiles( Size size, int type, const std::vector<int>& params )
+{
+    int depth = CV_MAT_DEPTH(type), channels = CV_MAT_CN(type);
+    if( m_tiles_tif || (depth != CV_8U && depth != CV_16U) ||
+        (channels != 1 && channels != 3 && channels != 4) || size.area() <= 0 )
+        return false;
+
+    // the tile sizes must be multiples of 16
+    int tileWidth = 256, tileHeight = 256;
+    readParam(params, TIFFTAG_TILEWIDTH, tileWidth);
+    readParam(params, TIFFTAG_TILELENGTH, tileHeight);
+    tileWidth = std::max((tileWidth + 15) & -16, 16);
+    tileHeight = std::max((tileHeight + 15) & -16, 16);
+
+    // BigTIFF is needed for files above 4Gb, which the images written by tiles easily exceed,
+    // the uncompressed size of the image tells when it may be the case
+    const char* mode = "w";
+#if TIFFLIB_VERSION >= 20111221
+    if( (double)size.area()*CV_ELEM_SIZE(type) >= (double)(1u << 31) )
+        mode = "w8";
+#endif
+    TIFF* tif = TIFFOpen(m_filename.c_str(), mode);
+    if( !tif )
+        return false;
+
+    if( !setTiffFields(tif, size.width, size.height, depth == CV_8U ? 8 : 16, channels, params) ||
+        !TIFFSetField(tif, TIFFTAG_TILEWIDTH, tileWidth) ||
+        !TIFFSetField(tif, TIFFTAG_TILELENGTH, tileHeight) )
+    {
+        TIFFClose(tif);
+        return false;
+    }
+
+    m_tiles_tif = tif;
+    m_tiles_size = size;
+    m_tiles_type = type;
+    m_tile_size = Size(tileWidth, tileHeight);
+    return true;
+}
+
+Size TiffEncoder::tileSize() const
+{
+    return m_tile_size;
+}
+
+bool TiffEncoder::writeTile( const Rect& roi, const Mat& tile )
+{
+    TIFF* tif = (TIFF*)m_tiles_tif;
+    if( !tif || tile.type() != m_tiles_type || tile.size() != roi.size() ||
+        roi.x % m_tile_size.width != 0 || roi.y % m_tile_size.height != 0 ||
+        (roi & Rect(Point(), m_tiles_size)) != roi )
+        return false;
+
+    int channels = tile.channels(), depth = tile.depth();
+    size_t esz = tile.elemSize();
+    AutoBuffer<uchar> _buffer(m_tile_size.area()*esz);
+    uchar* buffer = _buffer;
+
+    for( int y = 0; y < roi.height; y += m_tile_size.height )
+        for( int x = 0; x < roi.width; x += m_tile_size.width )
+        {
+            // the tiles at the right and bottom borders are padded
+            int width = std::min(m_tile_size.width, roi.width - x);
+            int height = std::min(m_tile_size.height, roi.height - y);
+            if( width < m_tile_size.width || height < m_tile_size.height )
+                memset(buffer, 0, m_tile_size.area()*esz);
+
+            for( int i = 0; i < height; i++ )
+                convertTiffRow(tile.ptr(y + i) + x*esz, buffer + i*m_tile_size.width*esz, width, channels, depth);
+
+            if( TIFFWriteTile(tif, buffer, roi.x + x, roi.y + y, 0, 0) < 0 )
+                return false;
+        }
+    return true;
+}
+
+bool TiffEncoder::finishTiles()
+{
+    if( !m_tiles_tif )
+        return false;
+    TIFFClose((TIFF*)m_tiles_tif);
+    m_tiles_tif = 0;
+    return true;
+}
+
 bool TiffEncoder::writeHdr(const Mat& _img)
 {
     Mat img;
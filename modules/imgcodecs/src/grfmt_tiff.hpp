@@ -102,6 +102,9 @@ public:
     void  close();
     bool  nextPage();
 
+    int   setRegion( const Rect& roi, int scale_denom );
+    Size  tileSize() const;
+
     size_t signatureLength() const;
     bool checkSignature( const String& signature ) const;
     ImageDecoder newDecoder() const;
@@ -127,6 +130,13 @@ public:
     bool  write( const Mat& img, const std::vector<int>& params );
     ImageEncoder newEncoder() const;
 
+#ifdef HAVE_TIFF
+    bool  startTiles( Size size, int type, const std::vector<int>& params );
+    Size  tileSize() const;
+    bool  writeTile( const Rect& roi, const Mat& tile );
+    bool  finishTiles();
+#endif
+
 protected:
     void  writeTag( WLByteStream& strm, TiffTag tag,
                     TiffFieldType fieldType,
@@ -134,6 +144,13 @@ protected:
 
     bool writeLibTiff( const Mat& img, const std::vector<int>& params );
     bool writeHdr( const Mat& img );
+
+#ifdef HAVE_TIFF
+    void* m_tiles_tif; // the file written by tiles
+    Size  m_tiles_size;
+    int   m_tiles_type;
+    Size  m_tile_size;
+#endif
 };
 
 }
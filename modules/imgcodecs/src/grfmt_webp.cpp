@@ -62,9 +62,24 @@ namespace cv
 WebPDecoder::WebPDecoder()
 {
     m_buf_supported = true;
+    m_reusable = true;
+    channels = 0;
+    m_idec = 0;
 }
 
-WebPDecoder::~WebPDecoder() {}
+WebPDecoder::~WebPDecoder()
+{
+    close();
+}
+
+void WebPDecoder::close()
+{
+    if (m_idec)
+    {
+        WebPIDelete((WebPIDecoder*)m_idec);
+        m_idec = 0;
+    }
+}
 
 size_t WebPDecoder::signatureLength() const
 {
@@ -95,6 +110,8 @@ ImageDecoder WebPDecoder::newDecoder() const
 
 bool WebPDecoder::readHeader()
 {
+    m_roi = Rect();
+
     if (m_buf.empty())
     {
         FILE * wfile = NULL;
@@ -158,8 +175,72 @@ bool WebPDecoder::readHeader()
     return false;
 }
 
+int WebPDecoder::setRegion(const Rect& roi, int scale_denom)
+{
+    if (m_width <= 0 || m_height <= 0)
+        return 0;
+
+    // libwebp snaps the crop origin to even coordinates, the region is then taken from the
+    // cropped image, which is possible only when it is not rescaled
+    m_roi = roi;
+    return (roi.x & 1) == 0 && (roi.y & 1) == 0 ? scale_denom : 1;
+}
+
+bool WebPDecoder::readRegion(Mat &img)
+{
+    WebPDecoderConfig config;
+    if (!WebPInitDecoderConfig(&config))
+        return false;
+
+    Rect crop(m_roi.x & ~1, m_roi.y & ~1, 0, 0);
+    crop.width = m_roi.x + m_roi.width - crop.x;
+    crop.height = m_roi.y + m_roi.height - crop.y;
+    config.options.use_cropping = 1;
+    config.options.crop_left = crop.x;
+    config.options.crop_top = crop.y;
+    config.options.crop_width = crop.width;
+    config.options.crop_height = crop.height;
+
+    Size size = crop.size();
+    if (img.size() != m_roi.size())
+    {
+        size = img.size();
+        config.options.use_scaling = 1;
+        config.options.scaled_width = size.width;
+        config.options.scaled_height = size.height;
+    }
+
+    Mat dst = img.type() == m_type && crop == m_roi ? img : Mat(size, m_type);
+    config.output.colorspace = channels == 3 ? MODE_BGR : MODE_BGRA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = dst.ptr();
+    config.output.u.RGBA.stride = (int)dst.step;
+    config.output.u.RGBA.size = dst.step*dst.rows;
+
+    VP8StatusCode status = WebPDecode(data.ptr(), data.total(), &config);
+    WebPFreeDecBuffer(&config.output);
+    if (status != VP8_STATUS_OK)
+        return false;
+
+    if (dst.data != img.data)
+    {
+        Mat src = dst(Rect(m_roi.x - crop.x, m_roi.y - crop.y, img.cols, img.rows));
+        if (img.channels() == channels)
+            src.copyTo(img);
+        else
+        {
+            static const int codes[] = { COLOR_BGR2GRAY, COLOR_BGRA2GRAY, COLOR_BGRA2BGR };
+            cvtColor(src, img, img.channels() == 1 ? codes[channels == 4] : codes[2]);
+        }
+    }
+    return true;
+}
+
 bool WebPDecoder::readData(Mat &img)
 {
+    if (m_roi.area() > 0)
+        return readRegion(img);
+
     if( m_width > 0 && m_height > 0 )
     {
         if (img.cols != m_width || img.rows != m_height || img.type() != m_type)
@@ -191,6 +272,72 @@ bool WebPDecoder::readData(Mat &img)
     return false;
 }
 
+bool WebPDecoder::startIncremental(int flags)
+{
+    close();
+    m_incr_flags = flags;
+    m_incr_img.release();
+    m_incr_rows = 0;
+    data.release();
+    m_incr_head.clear();
+    return true;
+}
+
+bool WebPDecoder::feed(const uchar* ptr, size_t size)
+{
+    if (!m_idec)
+    {
+        // collect the data until the features of the bitstream are known
+        m_incr_head.insert(m_incr_head.end(), ptr, ptr + size);
+        if (m_incr_head.empty())
+            return true;
+
+        WebPBitstreamFeatures features;
+        VP8StatusCode status = WebPGetFeatures(&m_incr_head[0], m_incr_head.size(), &features);
+        if (status == VP8_STATUS_NOT_ENOUGH_DATA)
+            return true;
+        if (status != VP8_STATUS_OK)
+            return false;
+
+        m_width = features.width;
+        m_height = features.height;
+        channels = features.has_alpha ? 4 : 3;
+        m_type = CV_MAKETYPE(CV_8U, channels);
+        createIncrementalImage();
+
+        // the rows are decoded straight into the image, unless it needs another number of channels
+        if (m_incr_img.channels() != channels)
+            data.create(m_height, m_width, m_type);
+        Mat& dst = data.empty() ? m_incr_img : data;
+        m_idec = WebPINewRGB(channels == 3 ? MODE_BGR : MODE_BGRA, dst.ptr(),
+                             dst.total() * dst.elemSize(), (int)dst.step);
+        if (!m_idec)
+            return false;
+
+        std::vector<uchar> head;
+        head.swap(m_incr_head);
+        return feed(&head[0], head.size());
+    }
+
+    VP8StatusCode status = WebPIAppend((WebPIDecoder*)m_idec, ptr, size);
+    if (status != VP8_STATUS_OK && status != VP8_STATUS_SUSPENDED)
+        return false;
+
+    int last_y = 0;
+    if (WebPIDecGetRGB((WebPIDecoder*)m_idec, &last_y, 0, 0, 0) && last_y > m_incr_rows)
+    {
+        if (!data.empty())
+        {
+            static const int codes[] = { COLOR_BGR2GRAY, COLOR_BGRA2GRAY, COLOR_BGRA2BGR };
+            int code = m_incr_img.channels() == 1 ? codes[channels == 4] : codes[2];
+            Mat dst = m_incr_img.rowRange(m_incr_rows, last_y);
+            cvtColor(data.rowRange(m_incr_rows, last_y), dst, code);
+        }
+        m_incr_rows = last_y;
+    }
+    return true;
+}
+
 WebPEncoder::WebPEncoder()
 {
     m_description = "WebP files (*.webp)";
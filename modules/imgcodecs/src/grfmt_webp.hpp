@@ -63,14 +63,23 @@ public:
     bool readHeader();
     void close();
 
+    int setRegion( const Rect& roi, int scale_denom );
+
+    bool startIncremental( int flags );
+    bool feed( const uchar* data, size_t size );
+
     size_t signatureLength() const;
     bool checkSignature( const String& signature) const;
 
     ImageDecoder newDecoder() const;
 
 protected:
+    bool readRegion( Mat& img );
+
     Mat data;
     int channels;
+    void* m_idec; // incremental decoder
+    std::vector<uchar> m_incr_head; // incremental data received before the bitstream features
 };
 
 class WebPEncoder : public BaseImageEncoder
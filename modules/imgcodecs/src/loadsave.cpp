@@ -114,14 +114,78 @@ struct ImageCodecInitializer
 
 static ImageCodecInitializer codecs;
 
+/**
+ * The decoders created for the previous images of a thread, reused for the following images of
+ * the same formats by the batch functions
+*/
+struct DecoderCache
+{
+    std::vector<ImageDecoder> decoders; ///< indexed as codecs.decoders
+};
+
+static TLSData<DecoderCache> decoderCaches;
+
+/**
+ * Closes the stream of a cached decoder and drops its source, so that no file stays open
+ * and no buffer stays referenced until the decoder of the thread is used again
+*/
+static void releaseSource( const ImageDecoder& decoder )
+{
+    decoder->close();
+    decoder->setSource( String() );
+}
+
+/// Releases the source of a cached decoder when the decoding ends, an exception included
+struct CachedSourceGuard
+{
+    CachedSourceGuard( const ImageDecoder& _decoder, DecoderCache* cache )
+        : decoder( cache ? _decoder : ImageDecoder() ) {}
+    ~CachedSourceGuard() { if( decoder ) releaseSource( decoder ); }
+
+    ImageDecoder decoder;
+};
+
+/**
+ * Select the decoder of the image by its signature
+ *
+ * @param[in] signature The first bytes of the image
+ * @param[in] cache The decoders to reuse, or NULL to create a new one
+*/
+static ImageDecoder selectDecoder( const String& signature, DecoderCache* cache )
+{
+    for( size_t i = 0; i < codecs.decoders.size(); i++ )
+    {
+        if( codecs.decoders[i]->checkSignature(signature) )
+        {
+            if( !cache )
+                return codecs.decoders[i]->newDecoder();
+
+            cache->decoders.resize( codecs.decoders.size() );
+            ImageDecoder& decoder = cache->decoders[i];
+            if( decoder )
+                return decoder;
+
+            ImageDecoder newdecoder = codecs.decoders[i]->newDecoder();
+            if( newdecoder && newdecoder->isReusable() )
+                decoder = newdecoder;
+            return newdecoder;
+        }
+    }
+
+    /// If no decoder was found, return base type
+    return ImageDecoder();
+}
+
 /**
  * Find the decoders
  *
  * @param[in] filename File to search
  *
+ * @param[in] cache The decoders to reuse, or NULL
+ *
  * @return Image decoder to parse image file.
 */
-static ImageDecoder findDecoder( const String& filename ) {
+static ImageDecoder findDecoder( const String& filename, DecoderCache* cache=0 ) {
 
     size_t i, maxlen = 0;
 
@@ -146,17 +210,10 @@ static ImageDecoder findDecoder( const String& filename ) {
     signature = signature.substr(0, maxlen);
 
     /// compare signature against all decoders
-    for( i = 0; i < codecs.decoders.size(); i++ )
-    {
-        if( codecs.decoders[i]->checkSignature(signature) )
-            return codecs.decoders[i]->newDecoder();
-    }
-
-    /// If no decoder was found, return base type
-    return ImageDecoder();
+    return selectDecoder( signature, cache );
 }
 
-static ImageDecoder findDecoder( const Mat& buf )
+static ImageDecoder findDecoder( const Mat& buf, DecoderCache* cache=0 )
 {
     size_t i, maxlen = 0;
 
@@ -174,13 +231,7 @@ static ImageDecoder findDecoder( const Mat& buf )
     maxlen = std::min(maxlen, bufSize);
     memcpy( (void*)signature.c_str(), buf.data, maxlen );
 
-    for( i = 0; i < codecs.decoders.size(); i++ )
-    {
-        if( codecs.decoders[i]->checkSignature(signature) )
-            return codecs.decoders[i]->newDecoder();
-    }
-
-    return ImageDecoder();
+    return selectDecoder( signature, cache );
 }
 
 static ImageEncoder findEncoder( const String& _ext )
@@ -235,10 +286,12 @@ enum { LOAD_CVMAT=0, LOAD_IMAGE=1, LOAD_MAT=2 };
  *                    }
  * @param[in] mat Reference to C++ Mat object (If LOAD_MAT)
  * @param[in] scale_denom Scale value
+ * @param[in] cache The decoders to reuse, or NULL
  *
 */
 static void*
-imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, int scale_denom=1 )
+imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, int scale_denom=1,
+         DecoderCache* cache=0 )
 {
     IplImage* image = 0;
     CvMat *matrix = 0;
@@ -252,7 +305,7 @@ imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, int scale_d
         decoder = GdalDecoder().newDecoder();
     }else{
 #endif
-        decoder = findDecoder(filename);
+        decoder = findDecoder(filename, cache);
 #ifdef HAVE_GDAL
     }
 #endif
@@ -267,6 +320,7 @@ imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, int scale_d
 
     /// set the filename in the driver
     decoder->setSource(filename);
+    CachedSourceGuard sourceGuard( decoder, cache );
 
    // read the header to make sure it succeeds
    if( !decoder->readHeader() )
@@ -278,18 +332,7 @@ imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, int scale_d
     size.height = decoder->height();
 
     // grab the decoded type
-    int type = decoder->type();
-    if( flags != IMREAD_UNCHANGED )
-    {
-        if( (flags & CV_LOAD_IMAGE_ANYDEPTH) == 0 )
-            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
-
-        if( (flags & CV_LOAD_IMAGE_COLOR) != 0 ||
-           ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1) )
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
-        else
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
-    }
+    int type = calcImageType( decoder->type(), flags );
 
     if( hdrtype == LOAD_CVMAT || hdrtype == LOAD_MAT )
     {
@@ -331,6 +374,95 @@ imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, int scale_d
 }
 
 
+/**
+ * Find the decoder of a file, GDAL if the flags request it
+ *
+ * @param[in] filename File to load
+ * @param[in] flags Flags
+ * @param[in] cache The decoders to reuse, or NULL
+*/
+static ImageDecoder findFileDecoder( const String& filename, int flags, DecoderCache* cache=0 )
+{
+#ifdef HAVE_GDAL
+    if(flags != IMREAD_UNCHANGED && (flags & IMREAD_LOAD_GDAL) == IMREAD_LOAD_GDAL ){
+        return GdalDecoder().newDecoder();
+    }
+#else
+    (void)flags;
+#endif
+    return findDecoder(filename, cache);
+}
+
+/**
+ * Read a region of an image whose header has been read by the decoder
+ *
+ * @param[in] decoder The decoder
+ * @param[in] roi The region in the coordinates of the full image, empty for the whole image
+ * @param[in] flags Flags
+ * @param[in] scale_denom Scale value
+ * @param[out] img The image of the region reduced by scale_denom
+ *
+*/
+static bool
+readRegion_( const ImageDecoder& decoder, Rect roi, int flags, int scale_denom, Mat& img )
+{
+    Rect full( 0, 0, decoder->width(), decoder->height() );
+    roi = roi.area() > 0 ? roi & full : full;
+    scale_denom = std::max( scale_denom, 1 );
+    if( roi.area() <= 0 )
+        return false;
+
+    int type = calcImageType( decoder->type(), flags );
+
+    // the decoder reads only the region and reduces it by the returned factor,
+    // or it cannot do it and the whole image is read
+    int reduced = decoder->setRegion( roi, scale_denom );
+    Mat data;
+    if( reduced > 0 )
+    {
+        data.create( reduceRect( roi, reduced ).size(), type );
+        if( !decoder->readData( data ) )
+            return false;
+    }
+    else
+    {
+        Mat whole( full.size(), type );
+        if( !decoder->readData( whole ) )
+            return false;
+        data = whole( roi );
+    }
+
+    Size size = reduceRect( roi, scale_denom ).size();
+    if( data.size() != size )
+        resize( data, img, size, 0, 0, INTER_AREA );
+    else if( reduced > 0 )
+        img = data;
+    else
+        data.copyTo( img );
+    return true;
+}
+
+/**
+ * Read a region of an image
+ *
+ * @param[in] filename File to load
+ * @param[in] roi The region to load
+ * @param[in] flags Flags you wish to set.
+ * @param[in] scale_denom Scale value
+*/
+Mat imread_region( const String& filename, const Rect& roi, int flags, int scale_denom )
+{
+    Mat img;
+    ImageDecoder decoder = findFileDecoder( filename, flags );
+    if( !decoder )
+        return img;
+
+    decoder->setSource(filename);
+    if( !decoder->readHeader() || !readRegion_( decoder, roi, flags, scale_denom, img ) )
+        img.release();
+    return img;
+}
+
 /**
 * Read an image into memory and return the information
 *
@@ -371,18 +503,7 @@ imreadmulti_(const String& filename, int flags, std::vector<Mat>& mats)
     for (;;)
     {
         // grab the decoded type
-        int type = decoder->type();
-        if (flags != IMREAD_UNCHANGED)
-        {
-            if ((flags & CV_LOAD_IMAGE_ANYDEPTH) == 0)
-                type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
-
-            if ((flags & CV_LOAD_IMAGE_COLOR) != 0 ||
-                ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1))
-                type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
-            else
-                type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
-        }
+        int type = calcImageType(decoder->type(), flags);
 
         // read the image data
         Mat mat(decoder->height(), decoder->width(), type);
@@ -496,7 +617,7 @@ bool imwrite( const String& filename, InputArray _img,
 }
 
 static void*
-imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0 )
+imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0, DecoderCache* cache=0 )
 {
     CV_Assert(!buf.empty() && buf.isContinuous());
     IplImage* image = 0;
@@ -504,7 +625,7 @@ imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0 )
     Mat temp, *data = &temp;
     String filename;
 
-    ImageDecoder decoder = findDecoder(buf);
+    ImageDecoder decoder = findDecoder(buf, cache);
     if( !decoder )
         return 0;
 
@@ -522,6 +643,8 @@ imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0 )
 
     if( !decoder->readHeader() )
     {
+        if( cache )
+            releaseSource( decoder );
         if( !filename.empty() )
             remove(filename.c_str());
         return 0;
@@ -531,18 +654,7 @@ imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0 )
     size.width = decoder->width();
     size.height = decoder->height();
 
-    int type = decoder->type();
-    if( flags != IMREAD_UNCHANGED )
-    {
-        if( (flags & CV_LOAD_IMAGE_ANYDEPTH) == 0 )
-            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
-
-        if( (flags & CV_LOAD_IMAGE_COLOR) != 0 ||
-           ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1) )
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
-        else
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
-    }
+    int type = calcImageType( decoder->type(), flags );
 
     if( hdrtype == LOAD_CVMAT || hdrtype == LOAD_MAT )
     {
@@ -564,6 +676,8 @@ imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0 )
     }
 
     bool code = decoder->readData( *data );
+    if( cache )
+        releaseSource( decoder ); // do not keep the buffer in the cached decoder
     if( !filename.empty() )
         remove(filename.c_str());
 
@@ -596,6 +710,346 @@ Mat imdecode( InputArray _buf, int flags, Mat* dst )
     return *dst;
 }
 
+Mat imdecode_region( InputArray _buf, const Rect& roi, int flags, int scale_denom )
+{
+    Mat buf = _buf.getMat(), img;
+    CV_Assert(!buf.empty() && buf.isContinuous());
+    String filename;
+
+    ImageDecoder decoder = findDecoder(buf);
+    if( !decoder )
+        return img;
+
+    if( !decoder->setSource(buf) )
+    {
+        filename = tempfile();
+        FILE* f = fopen( filename.c_str(), "wb" );
+        if( !f )
+            return img;
+        fwrite( buf.ptr(), 1, buf.cols*buf.rows*buf.elemSize(), f );
+        fclose(f);
+        decoder->setSource(filename);
+    }
+
+    if( !decoder->readHeader() || !readRegion_( decoder, roi, flags, scale_denom, img ) )
+        img.release();
+
+    if( !filename.empty() )
+        remove(filename.c_str());
+    return img;
+}
+
+/**
+ * Decodes a range of the images of a batch, reusing the decoders of the thread
+*/
+class ImageBatchDecoder : public ParallelLoopBody
+{
+public:
+    ImageBatchDecoder( const std::vector<String>* _filenames, const std::vector<Mat>* _bufs,
+                       std::vector<Mat>& _images, int _flags )
+        : filenames(_filenames), bufs(_bufs), images(&_images), flags(_flags)
+    {
+    }
+
+    void operator()( const Range& range ) const
+    {
+        DecoderCache* cache = decoderCaches.get();
+        for( int i = range.start; i < range.end; i++ )
+        {
+            Mat& img = (*images)[i];
+            void* result = 0;
+            try
+            {
+                if( filenames )
+                    result = imread_( (*filenames)[i], flags, LOAD_MAT, &img, 1, cache );
+                else if( !(*bufs)[i].empty() )
+                    result = imdecode_( (*bufs)[i], flags, LOAD_MAT, &img, cache );
+            }
+            catch( const cv::Exception& )
+            {
+                result = 0;
+            }
+            if( !result )
+                img.release();
+        }
+    }
+
+protected:
+    const std::vector<String>* filenames;
+    const std::vector<Mat>* bufs;
+    std::vector<Mat>* images;
+    int flags;
+};
+
+static int countDecoded( const std::vector<Mat>& images )
+{
+    int count = 0;
+    for( size_t i = 0; i < images.size(); i++ )
+        count += !images[i].empty();
+    return count;
+}
+
+int imreadBatch( const std::vector<String>& filenames, std::vector<Mat>& images, int flags )
+{
+    images.resize( filenames.size() );
+    parallel_for_( Range(0, (int)filenames.size()),
+                   ImageBatchDecoder(&filenames, 0, images, flags) );
+    return countDecoded( images );
+}
+
+int imdecodeBatch( InputArrayOfArrays _bufs, std::vector<Mat>& images, int flags )
+{
+    int i, n = (int)_bufs.total();
+    std::vector<Mat> bufs(n);
+    for( i = 0; i < n; i++ )
+    {
+        bufs[i] = _bufs.getMat(i);
+        CV_Assert( bufs[i].empty() || bufs[i].isContinuous() );
+    }
+
+    images.resize( n );
+    parallel_for_( Range(0, n), ImageBatchDecoder(0, &bufs, images, flags) );
+    return countDecoded( images );
+}
+
+ImageStreamDecoder::~ImageStreamDecoder() {}
+
+class ImageStreamDecoderImpl : public ImageStreamDecoder
+{
+public:
+    ImageStreamDecoderImpl( int _flags )
+        : flags(_flags), maxlen(0), incremental(false), failed(false), finished(false)
+    {
+        for( size_t i = 0; i < codecs.decoders.size(); i++ )
+            maxlen = std::max(maxlen, codecs.decoders[i]->signatureLength());
+    }
+
+    bool feed( InputArray _data )
+    {
+        Mat data = _data.getMat();
+        CV_Assert( data.empty() || (data.isContinuous() && data.depth() == CV_8U) );
+        if( failed || finished )
+            return !failed;
+
+        const uchar* ptr = data.ptr();
+        size_t size = data.total()*data.elemSize();
+
+        if( incremental )
+            return check( decoder->feed(ptr, size) );
+
+        buf.insert( buf.end(), ptr, ptr + size );
+        return decoder || buf.size() < maxlen || selectDecoder();
+    }
+
+    bool finish()
+    {
+        if( !failed && !finished )
+        {
+            finished = true;
+            if( !decoder && (buf.empty() || !selectDecoder()) )
+                failed = true;
+            else if( !incremental )
+            {
+                imdecode_( Mat(buf), flags, LOAD_MAT, &img );
+                failed = img.empty();
+            }
+            std::vector<uchar>().swap(buf);
+        }
+        return !failed && headerDecoded() && decodedRows() == image().rows;
+    }
+
+    bool headerDecoded() const
+    {
+        return !image().empty();
+    }
+
+    Mat image() const
+    {
+        return incremental ? decoder->incrementalImage() : img;
+    }
+
+    int decodedRows() const
+    {
+        return incremental ? decoder->decodedRows() : img.rows;
+    }
+
+protected:
+    // selects the decoder by the signature and passes it the data received so far
+    bool selectDecoder()
+    {
+        decoder = findDecoder( Mat(buf) );
+        if( !decoder )
+            return check( false );
+
+        incremental = decoder->startIncremental( flags );
+        if( !incremental )
+            return true;
+
+        std::vector<uchar> head;
+        head.swap(buf);
+        return check( decoder->feed(&head[0], head.size()) );
+    }
+
+    bool check( bool ok )
+    {
+        failed = failed || !ok;
+        return ok;
+    }
+
+    int flags;
+    size_t maxlen;
+    ImageDecoder decoder;
+    bool incremental, failed, finished;
+    std::vector<uchar> buf; // data received before the format is known, or all data of a format
+                            // that is not decoded incrementally
+    Mat img;
+};
+
+Ptr<ImageStreamDecoder> createImageStreamDecoder( int flags )
+{
+    return makePtr<ImageStreamDecoderImpl>(flags);
+}
+
+ImageTileReader::~ImageTileReader() {}
+
+class ImageTileReaderImpl : public ImageTileReader
+{
+public:
+    ImageTileReaderImpl( const String& _filename, int _flags )
+        : filename(_filename), flags(_flags), type_(-1) {}
+
+    bool open()
+    {
+        ImageDecoder decoder = findFileDecoder( filename, flags );
+        if( !decoder )
+            return false;
+        decoder->setSource( filename );
+        if( !decoder->readHeader() )
+            return false;
+        size_ = Size( decoder->width(), decoder->height() );
+        type_ = calcImageType( decoder->type(), flags );
+        tileSize_ = decoder->tileSize();
+        return size_.area() > 0;
+    }
+
+    Size size() const { return size_; }
+    int type() const { return type_; }
+    Size tileSize() const { return tileSize_; }
+
+    bool read( const Rect& roi, Mat& dst, int scale_denom ) const
+    {
+        // every call reads the header again, with a decoder of the calling thread
+        DecoderCache* cache = decoderCaches.get();
+        ImageDecoder decoder = findFileDecoder( filename, flags, cache );
+        bool ok = false;
+        if( decoder )
+        {
+            decoder->setSource( filename );
+            CachedSourceGuard sourceGuard( decoder, cache );
+            ok = decoder->readHeader() &&
+                 Size( decoder->width(), decoder->height() ) == size_ &&
+                 readRegion_( decoder, roi, flags, scale_denom, dst );
+        }
+        if( !ok )
+            dst.release();
+        return ok;
+    }
+
+protected:
+    String filename;
+    int flags;
+    Size size_;
+    int type_;
+    Size tileSize_;
+};
+
+Ptr<ImageTileReader> createImageTileReader( const String& filename, int flags )
+{
+    Ptr<ImageTileReaderImpl> reader = makePtr<ImageTileReaderImpl>(filename, flags);
+    if( !reader->open() )
+        return Ptr<ImageTileReader>();
+    return reader;
+}
+
+ImageTileWriter::~ImageTileWriter() {}
+
+class ImageTileWriterImpl : public ImageTileWriter
+{
+public:
+    ImageTileWriterImpl( const String& _filename, Size _size, int _type, const std::vector<int>& _params )
+        : filename(_filename), size_(_size), type_(_type), params(_params), tiled(false), closed(false) {}
+
+    ~ImageTileWriterImpl()
+    {
+        close();
+    }
+
+    bool open()
+    {
+        encoder = findEncoder( filename );
+        if( !encoder )
+            return false;
+
+        // the encoders that cannot write by tiles get the whole image from close()
+        encoder->setDestination( filename );
+        tiled = encoder->startTiles( size_, type_, params );
+        if( !tiled )
+            image.create( size_, type_ );
+        return true;
+    }
+
+    Size size() const { return size_; }
+    int type() const { return type_; }
+    Size tileSize() const { return tiled ? encoder->tileSize() : Size(1, 1); }
+
+    bool write( const Rect& roi, InputArray _tile )
+    {
+        Mat tile = _tile.getMat();
+        CV_Assert( tile.type() == type_ && tile.size() == roi.size() &&
+                   (roi & Rect(Point(), size_)) == roi );
+
+        AutoLock lock(mutex);
+        if( closed )
+            return false;
+        if( !tiled )
+        {
+            tile.copyTo( image(roi) );
+            return true;
+        }
+        return encoder->writeTile( roi, tile );
+    }
+
+    bool close()
+    {
+        AutoLock lock(mutex);
+        if( closed )
+            return false;
+        closed = true;
+        bool ok = tiled ? encoder->finishTiles() : imwrite_( filename, image, params, false );
+        image.release();
+        return ok;
+    }
+
+protected:
+    String filename;
+    Size size_;
+    int type_;
+    std::vector<int> params;
+    ImageEncoder encoder;
+    bool tiled, closed;
+    Mat image;
+    Mutex mutex;
+};
+
+Ptr<ImageTileWriter> createImageTileWriter( const String& filename, Size size, int type,
+                                            const std::vector<int>& params )
+{
+    Ptr<ImageTileWriterImpl> writer = makePtr<ImageTileWriterImpl>(filename, size, type, params);
+    if( !writer->open() )
+        return Ptr<ImageTileWriter>();
+    return writer;
+}
+
 bool imencode( const String& ext, InputArray _image,
                std::vector<uchar>& buf, const std::vector<int>& params )
 {
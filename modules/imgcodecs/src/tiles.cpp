@@ -0,0 +1,316 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+//
+//  Processing of the images that do not fit into memory tile by tile.
+//
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+TileFilter::~TileFilter() {}
+
+Size TileFilter::dstSize( Size srcSize ) const
+{
+    return srcSize;
+}
+
+int TileFilter::dstType( int srcType ) const
+{
+    return srcType;
+}
+
+// the number of the pixels around the sample point used by the interpolation
+static int interpolationHalo( int interpolation )
+{
+    return interpolation == INTER_CUBIC ? 2 : interpolation == INTER_LANCZOS4 ? 4 : 1;
+}
+
+class NeighborhoodTileFilter : public TileFilter
+{
+public:
+    NeighborhoodTileFilter( TileFilterFunc _func, Size _halo, int _dtype, void* _userdata )
+        : func(_func), halo(_halo), dtype(_dtype), userdata(_userdata) {}
+
+    int dstType( int srcType ) const
+    {
+        return dtype < 0 ? srcType : dtype;
+    }
+
+    Rect srcRegion( const Rect& dstRoi, Size ) const
+    {
+        return Rect( dstRoi.x - halo.width, dstRoi.y - halo.height,
+                     dstRoi.width + halo.width*2, dstRoi.height + halo.height*2 );
+    }
+
+    void apply( const Mat& src, const Rect& srcRoi, Mat& dst, const Rect& dstRoi, Size ) const
+    {
+        // the filters take the halo from the parent matrix of the ROI, and extrapolate
+        // the pixels only beyond it, that is, beyond the borders of the image
+        Mat roi = src( Rect( dstRoi.x - srcRoi.x, dstRoi.y - srcRoi.y, dstRoi.width, dstRoi.height ) );
+        Mat out = dst;
+        func( roi, out, userdata );
+        if( out.data != dst.data )
+        {
+            CV_Assert( out.size() == dst.size() && out.type() == dst.type() );
+            out.copyTo( dst );
+        }
+    }
+
+protected:
+    TileFilterFunc func;
+    Size halo;
+    int dtype;
+    void* userdata;
+};
+
+Ptr<TileFilter> createNeighborhoodTileFilter( TileFilterFunc func, Size halo, int dtype, void* userdata )
+{
+    CV_Assert( func && halo.width >= 0 && halo.height >= 0 );
+    return makePtr<NeighborhoodTileFilter>(func, halo, dtype, userdata);
+}
+
+class ResizeTileFilter : public TileFilter
+{
+public:
+    ResizeTileFilter( Size _dsize, int _interpolation )
+        : dsize(_dsize), interpolation(_interpolation) {}
+
+    Size dstSize( Size ) const
+    {
+        return dsize;
+    }
+
+    Rect srcRegion( const Rect& dstRoi, Size srcSize ) const
+    {
+        double sx = (double)srcSize.width/dsize.width, sy = (double)srcSize.height/dsize.height;
+        if( isArea( sx, sy ) )
+            return Rect( Point( cvFloor(dstRoi.x*sx), cvFloor(dstRoi.y*sy) ),
+                         Point( cvCeil(dstRoi.br().x*sx), cvCeil(dstRoi.br().y*sy) ) );
+
+        int halo = interpolationHalo( interpolation );
+        return Rect( Point( cvFloor((dstRoi.x + 0.5)*sx - 0.5) - halo, cvFloor((dstRoi.y + 0.5)*sy - 0.5) - halo ),
+                     Point( cvFloor((dstRoi.br().x - 0.5)*sx - 0.5) + halo + 2,
+                            cvFloor((dstRoi.br().y - 0.5)*sy - 0.5) + halo + 2 ) );
+    }
+
+    void apply( const Mat& src, const Rect& srcRoi, Mat& dst, const Rect& dstRoi, Size srcSize ) const
+    {
+        double sx = (double)srcSize.width/dsize.width, sy = (double)srcSize.height/dsize.height;
+        if( isArea( sx, sy ) )
+        {
+            resize( src, dst, dst.size(), 0, 0, INTER_AREA );
+            return;
+        }
+
+        // the pixel centers of the tile mapped to the region read, as resize maps them
+        double ox = 0.5*sx - 0.5, oy = 0.5*sy - 0.5;
+        if( interpolation == INTER_NEAREST )
+            ox = oy = 0;
+        Matx23d M( sx, 0, dstRoi.x*sx + ox - srcRoi.x,
+                   0, sy, dstRoi.y*sy + oy - srcRoi.y );
+        warpAffine( src, dst, M, dst.size(), interpolation | WARP_INVERSE_MAP, BORDER_REPLICATE );
+    }
+
+protected:
+    bool isArea( double sx, double sy ) const
+    {
+        return interpolation == INTER_AREA && sx >= 1 && sy >= 1;
+    }
+
+    Size dsize;
+    int interpolation;
+};
+
+Ptr<TileFilter> createResizeTileFilter( Size dsize, int interpolation )
+{
+    CV_Assert( dsize.area() > 0 );
+    CV_Assert( interpolation == INTER_NEAREST || interpolation == INTER_LINEAR || interpolation == INTER_CUBIC ||
+               interpolation == INTER_AREA || interpolation == INTER_LANCZOS4 );
+    return makePtr<ResizeTileFilter>(dsize, interpolation);
+}
+
+class WarpAffineTileFilter : public TileFilter
+{
+public:
+    WarpAffineTileFilter( const Matx23d& _iM, Size _dsize, int _interpolation,
+                          int _borderMode, const Scalar& _borderValue )
+        : iM(_iM), dsize(_dsize), interpolation(_interpolation),
+          borderMode(_borderMode), borderValue(_borderValue) {}
+
+    Size dstSize( Size ) const
+    {
+        return dsize;
+    }
+
+    Rect srcRegion( const Rect& dstRoi, Size srcSize ) const
+    {
+        // the other border modes may take the pixels from anywhere in the image
+        if( borderMode != BORDER_CONSTANT && borderMode != BORDER_REPLICATE && borderMode != BORDER_TRANSPARENT )
+            return Rect( Point(), srcSize );
+
+        double xmin = DBL_MAX, ymin = DBL_MAX, xmax = -DBL_MAX, ymax = -DBL_MAX;
+        for( int i = 0; i < 4; i++ )
+        {
+            double x = dstRoi.x + (i & 1 ? dstRoi.width - 1 : 0), y = dstRoi.y + (i & 2 ? dstRoi.height - 1 : 0);
+            double u = iM(0, 0)*x + iM(0, 1)*y + iM(0, 2), v = iM(1, 0)*x + iM(1, 1)*y + iM(1, 2);
+            xmin = std::min( xmin, u ); xmax = std::max( xmax, u );
+            ymin = std::min( ymin, v ); ymax = std::max( ymax, v );
+        }
+
+        // the region is kept inside the image, but not empty, so that the pixels
+        // at the borders are there to be replicated or interpolated with the border value
+        int halo = interpolationHalo( interpolation );
+        int x0 = std::min( std::max( cvFloor(xmin) - halo, 0 ), srcSize.width - 1 );
+        int y0 = std::min( std::max( cvFloor(ymin) - halo, 0 ), srcSize.height - 1 );
+        int x1 = std::min( std::max( cvFloor(xmax) + halo + 2, x0 + 1 ), srcSize.width );
+        int y1 = std::min( std::max( cvFloor(ymax) + halo + 2, y0 + 1 ), srcSize.height );
+        return Rect( Point(x0, y0), Point(x1, y1) );
+    }
+
+    void apply( const Mat& src, const Rect& srcRoi, Mat& dst, const Rect& dstRoi, Size ) const
+    {
+        Matx23d M = iM;
+        M(0, 2) += M(0, 0)*dstRoi.x + M(0, 1)*dstRoi.y - srcRoi.x;
+        M(1, 2) += M(1, 0)*dstRoi.x + M(1, 1)*dstRoi.y - srcRoi.y;
+        warpAffine( src, dst, M, dst.size(), interpolation | WARP_INVERSE_MAP, borderMode, borderValue );
+    }
+
+protected:
+    Matx23d iM; // maps the output pixels to the input ones
+    Size dsize;
+    int interpolation;
+    int borderMode;
+    Scalar borderValue;
+};
+
+Ptr<TileFilter> createWarpAffineTileFilter( InputArray _M, Size dsize, int flags,
+                                            int borderMode, const Scalar& borderValue )
+{
+    Mat M0 = _M.getMat();
+    CV_Assert( M0.rows == 2 && M0.cols == 3 && dsize.area() > 0 );
+    Mat M1;
+    M0.convertTo( M1, CV_64F );
+    Matx23d M = M1;
+    if( !(flags & WARP_INVERSE_MAP) )
+        invertAffineTransform( Matx23d(M), M );
+    return makePtr<WarpAffineTileFilter>(M, dsize, flags & INTER_MAX, borderMode, borderValue);
+}
+
+class TileProcessor : public ParallelLoopBody
+{
+public:
+    TileProcessor( const ImageTileReader* _reader, ImageTileWriter* _writer, const TileFilter* _filter,
+                   Size _tileSize, volatile bool* _ok )
+        : reader(_reader), writer(_writer), filter(_filter), tileSize(_tileSize), ok(_ok) {}
+
+    void operator()( const Range& range ) const
+    {
+        Size srcSize = reader->size(), dstSize = writer->size();
+        int ntilesx = (dstSize.width + tileSize.width - 1)/tileSize.width;
+
+        for( int i = range.start; i < range.end && *ok; i++ )
+        {
+            Rect dstRoi = Rect( Point( (i % ntilesx)*tileSize.width, (i / ntilesx)*tileSize.height ), tileSize ) &
+                          Rect( Point(), dstSize );
+            Rect srcRoi = filter->srcRegion( dstRoi, srcSize ) & Rect( Point(), srcSize );
+            Mat src, dst( dstRoi.size(), writer->type(), Scalar::all(0) );
+            if( srcRoi.area() > 0 && !reader->read( srcRoi, src ) )
+            {
+                *ok = false;
+                break;
+            }
+            filter->apply( src, srcRoi, dst, dstRoi, srcSize );
+            if( !writer->write( dstRoi, dst ) )
+                *ok = false;
+        }
+    }
+
+protected:
+    const ImageTileReader* reader;
+    ImageTileWriter* writer;
+    const TileFilter* filter;
+    Size tileSize;
+    volatile bool* ok;
+};
+
+static int alignUp( int size, int n )
+{
+    return (size + n - 1)/n*n;
+}
+
+bool processTiles( const String& src, const String& dst, const Ptr<TileFilter>& filter,
+                   Size tileSize, const std::vector<int>& params, int flags )
+{
+    CV_Assert( filter );
+    Ptr<ImageTileReader> reader = createImageTileReader( src, flags );
+    if( !reader )
+        return false;
+
+    Size srcSize = reader->size(), dstSize = filter->dstSize( srcSize );
+    CV_Assert( dstSize.area() > 0 );
+    Ptr<ImageTileWriter> writer = createImageTileWriter( dst, dstSize, filter->dstType( reader->type() ), params );
+    if( !writer )
+        return false;
+
+    // the tiles of about a megapixel, or full-width bands when the strips of the input
+    // would be decoded for every tile crossing them otherwise
+    if( tileSize.area() <= 0 )
+    {
+        if( reader->tileSize().width >= srcSize.width )
+            tileSize = Size( dstSize.width, std::max( (1 << 20)/dstSize.width, 1 ) );
+        else
+            tileSize = Size( 1024, 1024 );
+    }
+    Size writerTile = writer->tileSize();
+    tileSize.width = std::min( alignUp( tileSize.width, writerTile.width ), alignUp( dstSize.width, writerTile.width ) );
+    tileSize.height = std::min( alignUp( tileSize.height, writerTile.height ), alignUp( dstSize.height, writerTile.height ) );
+
+    int ntiles = ((dstSize.width + tileSize.width - 1)/tileSize.width)*
+                 ((dstSize.height + tileSize.height - 1)/tileSize.height);
+    volatile bool ok = true;
+    parallel_for_( Range(0, ntiles), TileProcessor(reader.get(), writer.get(), filter.get(), tileSize, &ok) );
+    return writer->close() && ok;
+}
+
+}
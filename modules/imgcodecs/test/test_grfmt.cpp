@@ -848,6 +848,316 @@ TEST(Imgcodecs_WebP, encode_decode_with_alpha_webp)
 
 #endif
 
+// feeds the encoded image to the stream decoder by parts and checks the result against imdecode;
+// returns true if a part of the rows has been decoded before the whole stream was received
+static bool decodeByParts(const string& ext, const Mat& img, int flags,
+                          const vector<int>& params = vector<int>())
+{
+    vector<uchar> buf;
+    EXPECT_TRUE(imencode(ext, img, buf, params));
+    Mat expected = imdecode(buf, flags);
+    EXPECT_FALSE(expected.empty());
+
+    Ptr<ImageStreamDecoder> decoder = createImageStreamDecoder(flags);
+    const size_t part = 1000;
+    int rows = 0;
+    bool partial = false;
+    for( size_t pos = 0; pos < buf.size(); pos += part )
+    {
+        vector<uchar> chunk(buf.begin() + pos, buf.begin() + std::min(pos + part, buf.size()));
+        EXPECT_TRUE(decoder->feed(chunk)) << ext;
+        EXPECT_LE(rows, decoder->decodedRows()) << ext;
+        rows = decoder->decodedRows();
+        partial = partial || (rows > 0 && rows < img.rows);
+    }
+    EXPECT_TRUE(decoder->finish()) << ext;
+    EXPECT_EQ(0, cvtest::norm(expected, decoder->image(), NORM_INF)) << ext;
+    return partial;
+}
+
+TEST(Imgcodecs_ImageStreamDecoder, decode_by_parts)
+{
+    Mat img(300, 200, CV_8UC3), img16(100, 120, CV_16UC1);
+    randu(img, Scalar::all(0), Scalar::all(256));
+    randu(img16, Scalar::all(0), Scalar::all(65536));
+
+#ifdef HAVE_JPEG
+    EXPECT_TRUE(decodeByParts(".jpg", img, IMREAD_COLOR));
+    EXPECT_TRUE(decodeByParts(".jpg", img, IMREAD_GRAYSCALE));
+    vector<int> params;
+    params.push_back(IMWRITE_JPEG_PROGRESSIVE);
+    params.push_back(1);
+    // progressive images are buffered until all the scans are received
+    EXPECT_FALSE(decodeByParts(".jpg", img, IMREAD_COLOR, params));
+#endif
+#ifdef HAVE_PNG
+    EXPECT_TRUE(decodeByParts(".png", img, IMREAD_COLOR));
+    EXPECT_TRUE(decodeByParts(".png", img, IMREAD_GRAYSCALE));
+    EXPECT_TRUE(decodeByParts(".png", img16, IMREAD_UNCHANGED));
+#endif
+#ifdef HAVE_WEBP
+    vector<int> webp_params;
+    webp_params.push_back(IMWRITE_WEBP_QUALITY);
+    webp_params.push_back(90);
+    EXPECT_TRUE(decodeByParts(".webp", img, IMREAD_COLOR, webp_params));
+    // lossless images, written by default, are decoded once all their data is received
+    EXPECT_FALSE(decodeByParts(".webp", img, IMREAD_COLOR));
+#endif
+    // formats without incremental decoding are decoded by finish()
+    EXPECT_FALSE(decodeByParts(".bmp", img, IMREAD_COLOR));
+}
+
+TEST(Imgcodecs_ImageStreamDecoder, invalid_data)
+{
+    vector<uchar> buf(100, 'x');
+    Ptr<ImageStreamDecoder> decoder = createImageStreamDecoder();
+    EXPECT_FALSE(decoder->feed(buf));
+    EXPECT_FALSE(decoder->finish());
+    EXPECT_FALSE(decoder->headerDecoded());
+
+    decoder = createImageStreamDecoder();
+    EXPECT_TRUE(decoder->feed(vector<uchar>(10, 'x')));
+    EXPECT_FALSE(decoder->finish());
+}
+
+TEST(Imgcodecs_Batch, decode_and_read)
+{
+    const char* exts[] = { ".bmp", ".pgm",
+#ifdef HAVE_JPEG
+        ".jpg",
+#endif
+#ifdef HAVE_PNG
+        ".png",
+#endif
+    };
+    const int n = 24, next = (int)(sizeof(exts)/sizeof(exts[0]));
+    vector<vector<uchar> > bufs(n);
+    vector<String> filenames(n);
+    vector<Mat> expected(n);
+    RNG& rng = theRNG();
+    for( int i = 0; i < n; i++ )
+    {
+        Mat img(rng.uniform(16, 100), rng.uniform(16, 100), i % 3 ? CV_8UC3 : CV_8UC1);
+        randu(img, Scalar::all(0), Scalar::all(256));
+        string ext = exts[i % next];
+        if( ext == ".pgm" && img.channels() == 3 )
+            cvtColor(img, img, COLOR_BGR2GRAY, 1);
+        ASSERT_TRUE(imencode(ext, img, bufs[i]));
+        filenames[i] = tempfile(ext.c_str());
+        ASSERT_TRUE(imwrite(filenames[i], img));
+        expected[i] = imdecode(bufs[i], IMREAD_COLOR);
+    }
+    bufs[5].assign(100, 'x');
+    filenames[7] = "not_existing_file.png";
+
+    vector<Mat> images;
+    EXPECT_EQ(n - 1, imdecodeBatch(bufs, images, IMREAD_COLOR));
+    ASSERT_EQ((size_t)n, images.size());
+    const uchar* data0 = images[0].data;
+    for( int i = 0; i < n; i++ )
+    {
+        if( i == 5 )
+            EXPECT_TRUE(images[i].empty());
+        else
+            EXPECT_EQ(0, cvtest::norm(expected[i], images[i], NORM_INF)) << "i=" << i;
+    }
+
+    // the output matrices are reused
+    EXPECT_EQ(n - 1, imdecodeBatch(bufs, images, IMREAD_COLOR));
+    EXPECT_EQ(data0, images[0].data);
+
+    EXPECT_EQ(n - 1, imreadBatch(filenames, images, IMREAD_COLOR));
+    for( int i = 0; i < n; i++ )
+    {
+        if( i == 7 )
+            EXPECT_TRUE(images[i].empty());
+        else
+        {
+            EXPECT_EQ(0, cvtest::norm(expected[i], images[i], NORM_INF)) << "i=" << i;
+            // the cached decoders must not keep the files open
+            EXPECT_EQ(0, remove(filenames[i].c_str())) << "i=" << i;
+        }
+    }
+}
+
+TEST(Imgcodecs_Region, decode)
+{
+    const char* exts[] = { ".bmp",
+#ifdef HAVE_JPEG
+        ".jpg",
+#endif
+#ifdef HAVE_PNG
+        ".png",
+#endif
+#ifdef HAVE_TIFF
+        ".tiff",
+#endif
+#ifdef HAVE_WEBP
+        ".webp",
+#endif
+    };
+    const int next = (int)(sizeof(exts)/sizeof(exts[0]));
+    const Rect rois[] = { Rect(13, 21, 100, 77), Rect(), Rect(150, 100, 100, 100), Rect(0, 7, 203, 1) };
+    const int denoms[] = { 1, 2, 3, 8 };
+
+    // a smooth image, so that the lossy formats decode the region close to the full image
+    Mat img(157, 203, CV_8UC3);
+    for( int y = 0; y < img.rows; y++ )
+        for( int x = 0; x < img.cols; x++ )
+            img.at<Vec3b>(y, x) = Vec3b(saturate_cast<uchar>(x + y/2),
+                                        saturate_cast<uchar>(128 + 100*sin(x*0.05)*cos(y*0.07)),
+                                        saturate_cast<uchar>(2*y));
+
+    for( int i = 0; i < next; i++ )
+    {
+        string ext = exts[i];
+        bool lossy = ext == ".jpg" || ext == ".webp";
+        vector<uchar> buf;
+        ASSERT_TRUE(imencode(ext, img, buf));
+
+        for( int flags = IMREAD_GRAYSCALE; flags <= IMREAD_COLOR; flags++ )
+        {
+            Mat full = imdecode(buf, flags);
+            if( full.channels() != (flags == IMREAD_COLOR ? 3 : 1) )
+                cvtColor(full, full, COLOR_BGR2GRAY); // imdecode of WebP returns color images
+            for( size_t j = 0; j < sizeof(rois)/sizeof(rois[0]); j++ )
+                for( size_t k = 0; k < sizeof(denoms)/sizeof(denoms[0]); k++ )
+                {
+                    Rect roi = rois[j].area() > 0 ? rois[j] & Rect(0, 0, full.cols, full.rows) :
+                                                    Rect(0, 0, full.cols, full.rows);
+                    int d = denoms[k];
+                    Size size((roi.x + roi.width + d - 1)/d - roi.x/d, (roi.y + roi.height + d - 1)/d - roi.y/d);
+                    Mat expected;
+                    resize(full(roi), expected, size, 0, 0, INTER_AREA);
+
+                    Mat region = imdecode_region(buf, rois[j], flags, d);
+                    ASSERT_EQ(expected.size(), region.size()) << ext << " roi=" << rois[j] << " d=" << d;
+                    ASSERT_EQ(expected.type(), region.type()) << ext << " roi=" << rois[j] << " d=" << d;
+                    // the decoders scaling while decoding average over a grid aligned to the whole image
+                    double err = cvtest::norm(expected, region, NORM_L1) / (double)expected.total() / expected.channels();
+                    if( !lossy && d == 1 )
+                        EXPECT_EQ(0, err) << ext << " roi=" << rois[j];
+                    else
+                        EXPECT_LT(err, !lossy ? 1 : d < 8 ? 4 : 8) << ext << " roi=" << rois[j] << " d=" << d;
+                }
+        }
+
+        string filename = tempfile(ext.c_str());
+        ASSERT_TRUE(imwrite(filename, img));
+        Mat region = imread_region(filename, Rect(40, 30, 64, 64), IMREAD_COLOR, 2);
+        Mat expected;
+        resize(imread(filename)(Rect(40, 30, 64, 64)), expected, Size(32, 32), 0, 0, INTER_AREA);
+        ASSERT_EQ(expected.size(), region.size()) << ext;
+        EXPECT_LT(cvtest::norm(expected, region, NORM_L1) / expected.total() / 3, lossy ? 4 : 1) << ext;
+        EXPECT_TRUE(imread_region(filename, Rect(300, 300, 10, 10)).empty()) << ext;
+        remove(filename.c_str());
+    }
+}
+
+#ifdef HAVE_TIFF
+
+TEST(Imgcodecs_Tiles, read_write)
+{
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC1, CV_16UC4 };
+    string filename = tempfile(".tiff");
+    for( size_t i = 0; i < sizeof(types)/sizeof(types[0]); i++ )
+    {
+        Mat img(301, 517, types[i]);
+        randu(img, Scalar::all(0), Scalar::all(img.depth() == CV_8U ? 256 : 65536));
+
+        vector<int> params;
+        params.push_back(322); // TIFFTAG_TILEWIDTH
+        params.push_back(64);
+        params.push_back(323); // TIFFTAG_TILELENGTH
+        params.push_back(48);
+        Ptr<ImageTileWriter> writer = createImageTileWriter(filename, img.size(), img.type(), params);
+        ASSERT_FALSE(writer.empty());
+        ASSERT_EQ(Size(64, 48), writer->tileSize());
+        // the tiles are written in any order
+        for( int y = img.rows/96*96; y >= 0; y -= 96 )
+            for( int x = 0; x < img.cols; x += 128 )
+            {
+                Rect roi = Rect(x, y, 128, 96) & Rect(0, 0, img.cols, img.rows);
+                ASSERT_TRUE(writer->write(roi, img(roi)));
+            }
+        EXPECT_FALSE(writer->write(Rect(10, 0, 64, 48), img(Rect(10, 0, 64, 48))));
+        ASSERT_TRUE(writer->close());
+
+        EXPECT_EQ(0, cvtest::norm(img, imread(filename, IMREAD_UNCHANGED), NORM_INF)) << "type=" << types[i];
+
+        Ptr<ImageTileReader> reader = createImageTileReader(filename);
+        ASSERT_FALSE(reader.empty());
+        EXPECT_EQ(img.size(), reader->size());
+        EXPECT_EQ(img.type(), reader->type());
+        EXPECT_EQ(Size(64, 48), reader->tileSize());
+        Rect roi(100, 37, 211, 150);
+        Mat region;
+        ASSERT_TRUE(reader->read(roi, region));
+        EXPECT_EQ(0, cvtest::norm(img(roi), region, NORM_INF)) << "type=" << types[i];
+        EXPECT_FALSE(reader->read(Rect(600, 0, 10, 10), region));
+    }
+    remove(filename.c_str());
+}
+
+static void gaussianBlur7x7(const Mat& src, Mat& dst, void*)
+{
+    GaussianBlur(src, dst, Size(7, 7), 0);
+}
+
+TEST(Imgcodecs_Tiles, process)
+{
+    // the interpolation of remapping is not as precise as the one of resize, a smooth image
+    // keeps the difference small
+    Mat img(404, 612, CV_8UC3);
+    for( int y = 0; y < img.rows; y++ )
+        for( int x = 0; x < img.cols; x++ )
+            img.at<Vec3b>(y, x) = Vec3b(saturate_cast<uchar>(x/3 + y/4),
+                                        saturate_cast<uchar>(128 + 100*sin(x*0.05)*cos(y*0.07)),
+                                        saturate_cast<uchar>(255 - x/3));
+    string src = tempfile(".tiff"), dst_tiff = tempfile(".tiff"), dst_png = tempfile(".png");
+    ASSERT_TRUE(imwrite(src, img));
+
+    Mat rot = getRotationMatrix2D(Point2f(300, 200), 30, 0.8);
+    Mat blurred, resized, resized_area, warped;
+    GaussianBlur(img, blurred, Size(7, 7), 0);
+    resize(img, resized, Size(1000, 500), 0, 0, INTER_LINEAR);
+    resize(img, resized_area, Size(img.cols/2, img.rows/2), 0, 0, INTER_AREA);
+    warpAffine(img, warped, rot, Size(700, 450), INTER_LINEAR, BORDER_CONSTANT, Scalar(1, 2, 3));
+
+    Ptr<TileFilter> filters[] =
+    {
+        createNeighborhoodTileFilter(gaussianBlur7x7, Size(3, 3)),
+        createResizeTileFilter(resized.size(), INTER_LINEAR),
+        createResizeTileFilter(Size(img.cols/2, img.rows/2), INTER_AREA),
+        createWarpAffineTileFilter(rot, warped.size(), INTER_LINEAR, BORDER_CONSTANT, Scalar(1, 2, 3))
+    };
+    Mat expected[] = { blurred, resized, resized_area, warped };
+    // the pixels at the borders of the warped image are interpolated with the border value,
+    // where the rounding of the coordinates in the tiles makes a visible difference
+    double maxerr[] = { 0, 1, 0, 10 };
+
+    for( int i = 0; i < 4; i++ )
+    {
+        // the tiles of the PNG file are not aligned, the TIFF ones are aligned to 256x256
+        const char* dsts[] = { dst_png.c_str(), dst_tiff.c_str() };
+        for( int j = 0; j < 2; j++ )
+        {
+            ASSERT_TRUE(processTiles(src, dsts[j], filters[i], j == 0 ? Size(100, 70) : Size())) << "i=" << i;
+            Mat result = imread(dsts[j], IMREAD_UNCHANGED);
+            ASSERT_EQ(expected[i].size(), result.size()) << "i=" << i;
+            EXPECT_LE(cvtest::norm(expected[i], result, NORM_INF), maxerr[i]) << "i=" << i << " j=" << j;
+            EXPECT_LE(cvtest::norm(expected[i], result, NORM_L1)/result.total(), 0.5) << "i=" << i << " j=" << j;
+        }
+    }
+
+    EXPECT_FALSE(processTiles("not_existing_file.tiff", dst_png, filters[0]));
+    remove(src.c_str());
+    remove(dst_tiff.c_str());
+    remove(dst_png.c_str());
+}
+
+#endif
+
 TEST(Imgcodecs_Hdr, regression)
 {
     string folder = string(cvtest::TS::ptr()->get_data_path()) + "/readwrite/";
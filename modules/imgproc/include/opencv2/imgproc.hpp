@@ -872,6 +872,61 @@ public:
 };
 
 
+/** @brief Chain of row-local image operations executed tile by tile.
+
+The operations added to the pipeline are not run immediately. apply() splits the image into
+horizontal tiles small enough to stay in the CPU cache and passes every tile through the whole
+chain before the next one, processing the tiles in parallel. The intermediate images are never
+written to memory as a whole, so a chain of several operations reads and writes the frame once:
+
+@code
+    Ptr<FusedPipeline> p = createFusedPipeline();
+    p->cvtColor(COLOR_BGR2GRAY).GaussianBlur(Size(5, 5), 1.5).convertTo(CV_32F, 1./255);
+    p->apply(frame, dst);
+@endcode
+
+The result is the same as the one of the corresponding functions called one after another. Only
+operations computing an output row from a bounded number of neighbouring input rows can be fused,
+so the operations changing the image size or using global image statistics (resize, normalize,
+Otsu thresholding) have to be called separately. Filtering operations recompute the rows shared
+by the neighbouring tiles.
+ */
+class CV_EXPORTS FusedPipeline
+{
+public:
+    virtual ~FusedPipeline() {}
+
+    //! appends cv::cvtColor; Bayer demosaicing and YUV 4:2:0 conversions are not supported
+    virtual FusedPipeline& cvtColor(int code, int dstCn = 0) = 0;
+    //! appends cv::LUT
+    virtual FusedPipeline& LUT(InputArray lut) = 0;
+    //! appends Mat::convertTo
+    virtual FusedPipeline& convertTo(int rtype, double alpha = 1, double beta = 0) = 0;
+    //! appends cv::threshold; THRESH_OTSU and THRESH_TRIANGLE are not supported
+    virtual FusedPipeline& threshold(double thresh, double maxval, int type) = 0;
+    //! appends cv::sepFilter2D
+    virtual FusedPipeline& sepFilter2D(int ddepth, InputArray kernelX, InputArray kernelY,
+                                       Point anchor = Point(-1,-1), double delta = 0,
+                                       int borderType = BORDER_DEFAULT) = 0;
+    //! appends cv::GaussianBlur
+    virtual FusedPipeline& GaussianBlur(Size ksize, double sigmaX, double sigmaY = 0,
+                                        int borderType = BORDER_DEFAULT) = 0;
+
+    /** @brief Runs the operations on the image.
+
+    @param src input image; its type must be accepted by the first operation.
+    @param dst output image of the same size as src and the type produced by the last operation.
+    It may be the same as src.
+     */
+    virtual void apply(InputArray src, OutputArray dst) = 0;
+
+    //! removes all the operations
+    virtual void clear() = 0;
+    //! returns true if the pipeline has no operations
+    virtual bool empty() const = 0;
+};
+
+
 class CV_EXPORTS_W Subdiv2D
 {
 public:
@@ -3379,6 +3434,57 @@ not set by default.
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Matches an image against a set of templates, reusing the template spectra between calls.
+
+The results are the same as the ones of matchTemplate called for every template. The matcher keeps
+the Fourier spectra of the templates, so matching a sequence of images against the same templates
+transforms every template once. The templates of the same size share the decomposition of the image
+into blocks and the spectra of the blocks, so the image is transformed once per template size; the
+image window sums needed by the normalized methods are computed once for all the templates. The
+blocks and the templates are processed in parallel. Masks are not supported.
+
+@code
+    Ptr<TemplateMatcher> matcher = createTemplateMatcher(TM_CCOEFF_NORMED, templs);
+    std::vector<Mat> results;
+    matcher->match(frame, results);
+@endcode
+ */
+class CV_EXPORTS_W TemplateMatcher : public Algorithm
+{
+public:
+    /** @brief Replaces the templates and drops the cached spectra.
+
+    @param templs The templates, of the same type (CV_8U or CV_32F with any number of channels).
+     */
+    CV_WRAP virtual void setTemplates(InputArrayOfArrays templs) = 0;
+    CV_WRAP virtual int getTemplatesCount() const = 0;
+
+    /** @brief Matches the image against all the templates.
+
+    @param image Image to search, of the template type and not smaller than any template.
+    @param results The comparison maps, the i-th one of size \f$(W-w_i+1) \times (H-h_i+1)\f$ and type CV_32F.
+     */
+    CV_WRAP virtual void match(InputArray image, OutputArrayOfArrays results) = 0;
+
+    //! matches the image against the template templIdx only
+    CV_WRAP virtual void match(InputArray image, int templIdx, OutputArray result) = 0;
+
+    //! one of cv::TemplateMatchModes
+    CV_WRAP virtual void setMethod(int method) = 0;
+    CV_WRAP virtual int getMethod() const = 0;
+
+    //! releases the cached template spectra
+    CV_WRAP virtual void clearCache() = 0;
+};
+
+/** @brief Creates a TemplateMatcher.
+
+@param method Comparison method, see cv::TemplateMatchModes.
+@param templs Optional templates, see TemplateMatcher::setTemplates.
+ */
+CV_EXPORTS_W Ptr<TemplateMatcher> createTemplateMatcher(int method = TM_CCOEFF_NORMED,
+                                                        InputArrayOfArrays templs = noArray());
+
 //! @}
 
 //! @addtogroup imgproc_shape
@@ -3739,6 +3845,9 @@ CV_EXPORTS_W int rotatedRectangleIntersection( const RotatedRect& rect1, const R
 
 CV_EXPORTS_W Ptr<CLAHE> createCLAHE(double clipLimit = 40.0, Size tileGridSize = Size(8, 8));
 
+//! Creates an empty FusedPipeline
+CV_EXPORTS Ptr<FusedPipeline> createFusedPipeline();
+
 //! Ballard, D.H. (1981). Generalizing the Hough transform to detect arbitrary shapes. Pattern Recognition 13 (2): 111-122.
 //! Detects position only without traslation and rotation
 CV_EXPORTS Ptr<GeneralizedHoughBallard> createGeneralizedHoughBallard();
@@ -687,6 +687,8 @@ static bool ipp_cornerHarris( InputArray _src, OutputArray _dst, int blockSize,
 
 void cv::cornerHarris( InputArray _src, OutputArray _dst, int blockSize, int ksize, double k, int borderType )
 {
+    CV_TRACE_FUNCTION();
+
     CV_OCL_RUN(_src.dims() <= 2 && _dst.isUMat(),
                ocl_cornerMinEigenValVecs(_src, _dst, blockSize, ksize, k, borderType, HARRIS))
 
@@ -710,6 +710,8 @@ static void distanceTransform_L1_8U(InputArray _src, OutputArray _dst)
 void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labels,
                             int distType, int maskSize, int labelType )
 {
+    CV_TRACE_FUNCTION();
+
     Mat src = _src.getMat(), labels;
     bool need_labels = _labels.needed();
 
@@ -318,6 +318,10 @@ Ptr<FilterEngine> createGaussianFilter( int type, Size ksize,
                                     double sigma1, double sigma2 = 0,
                                     int borderType = BORDER_DEFAULT);
 
+//! computes the kernels used by createGaussianFilter and GaussianBlur
+void createGaussianKernels( Mat & kx, Mat & ky, int type, Size ksize,
+                            double sigma1, double sigma2 );
+
 //! returns filter engine for the generalized Sobel operator
 Ptr<FilterEngine> createDerivFilter( int srcType, int dstType,
                                         int dx, int dy, int ksize,
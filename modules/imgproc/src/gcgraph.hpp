@@ -54,6 +54,7 @@ public:
     void addTermWeights( int i, TWeight sourceW, TWeight sinkW );
     TWeight maxFlow();
     bool inSourceSegment( int i );
+    bool inSourceTree( int i );
 private:
     class Vtx
     {
@@ -382,4 +383,13 @@ bool GCGraph<TWeight>::inSourceSegment( int i )
     return vtcs[i].t == 0;
 }
 
+// Unlike inSourceSegment, vertices left free by maxFlow() (reachable from neither terminal)
+// go to the sink, so the segments always form a minimum cut
+template <class TWeight>
+bool GCGraph<TWeight>::inSourceTree( int i )
+{
+    CV_Assert( i>=0 && i<(int)vtcs.size() );
+    return vtcs[i].t == 0 && vtcs[i].parent != 0;
+}
+
 #endif
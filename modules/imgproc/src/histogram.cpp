@@ -1270,6 +1270,7 @@ void cv::calcHist( const Mat* images, int nimages, const int* channels,
                    InputArray _mask, OutputArray _hist, int dims, const int* histSize,
                    const float** ranges, bool uniform, bool accumulate )
 {
+    CV_TRACE_FUNCTION();
 
     CV_IPP_RUN(nimages == 1 && images[0].type() == CV_8UC1 && dims == 1 && channels &&
                 channels[0] == 0 && _mask.getMat().empty() && images[0].dims <= 2 &&
@@ -3644,6 +3645,8 @@ static bool ocl_equalizeHist(InputArray _src, OutputArray _dst)
 
 void cv::equalizeHist( InputArray _src, OutputArray _dst )
 {
+    CV_TRACE_FUNCTION();
+
     CV_Assert( _src.type() == CV_8UC1 );
 
     if (_src.empty())
@@ -0,0 +1,319 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+// One operation of FusedPipeline. run() computes dst from the rows `rows` of src;
+// filters also read up to `top` rows above and `bottom` rows below them.
+class PipelineStage
+{
+public:
+    PipelineStage() : top(0), bottom(0) {}
+    virtual ~PipelineStage() {}
+
+    // checks the input type and returns the type of the output
+    virtual int prepare(int srcType) = 0;
+    virtual void run(const Mat& src, const Range& rows, Mat& dst) const = 0;
+
+    int top, bottom;
+};
+
+// operations computing each pixel from the pixel at the same position
+class PixelStage : public PipelineStage
+{
+public:
+    // the operations keep the image size, so running one on a tiny image validates
+    // the parameters and tells the output type before the tiles are processed
+    int prepare(int srcType)
+    {
+        Mat probe(2, 2, srcType, Scalar::all(0)), out;
+        run(probe, Range(0, probe.rows), out);
+        return out.type();
+    }
+};
+
+class CvtColorStage : public PixelStage
+{
+public:
+    CvtColorStage(int _code, int _dcn) : code(_code), dcn(_dcn)
+    {
+        // the conversions involving Bayer patterns or vertically subsampled chroma use
+        // the neighbouring rows or change the image size
+        CV_Assert( !(code >= COLOR_BayerBG2BGR && code <= COLOR_BayerGR2BGR) &&
+                   !(code >= COLOR_BayerBG2BGR_VNG && code <= COLOR_BayerGR2BGR_VNG) &&
+                   !(code >= COLOR_BayerBG2GRAY && code <= COLOR_YUV2GRAY_420) &&
+                   !(code >= COLOR_RGB2YUV_I420 && code <= COLOR_BGRA2YUV_YV12) &&
+                   !(code >= COLOR_BayerBG2BGR_EA && code <= COLOR_BayerGR2BGR_EA) );
+    }
+
+    void run(const Mat& src, const Range& rows, Mat& dst) const
+    {
+        cv::cvtColor(src.rowRange(rows), dst, code, dcn);
+    }
+
+    int code, dcn;
+};
+
+class LUTStage : public PixelStage
+{
+public:
+    LUTStage(const Mat& _lut) : lut(_lut.clone()) {}
+
+    void run(const Mat& src, const Range& rows, Mat& dst) const
+    {
+        cv::LUT(src.rowRange(rows), lut, dst);
+    }
+
+    Mat lut;
+};
+
+class ConvertStage : public PixelStage
+{
+public:
+    ConvertStage(int _rtype, double _alpha, double _beta) : rtype(_rtype), alpha(_alpha), beta(_beta) {}
+
+    void run(const Mat& src, const Range& rows, Mat& dst) const
+    {
+        src.rowRange(rows).convertTo(dst, rtype, alpha, beta);
+    }
+
+    int rtype;
+    double alpha, beta;
+};
+
+class ThresholdStage : public PixelStage
+{
+public:
+    ThresholdStage(double _thresh, double _maxval, int _type)
+        : thresh(_thresh), maxval(_maxval), type(_type)
+    {
+        CV_Assert( (type & (THRESH_OTSU | THRESH_TRIANGLE)) == 0 );
+    }
+
+    void run(const Mat& src, const Range& rows, Mat& dst) const
+    {
+        cv::threshold(src.rowRange(rows), dst, thresh, maxval, type);
+    }
+
+    double thresh, maxval;
+    int type;
+};
+
+class SepFilterStage : public PipelineStage
+{
+public:
+    SepFilterStage(int _ddepth, const Mat& _kx, const Mat& _ky, Point _anchor, double _delta, int _borderType)
+        : ddepth(_ddepth), kx(_kx.clone()), ky(_ky.clone()), anchor(_anchor), delta(_delta),
+          borderType(_borderType), kernelVersion(0)
+    {
+        // the tiles are filtered with the neighbouring rows of the image
+        CV_Assert( (borderType & BORDER_ISOLATED) == 0 );
+    }
+
+    int prepare(int srcType)
+    {
+        int ksize = (int)ky.total();
+        top = anchor.y >= 0 ? anchor.y : ksize/2;
+        bottom = ksize - 1 - top;
+        CV_Assert( 0 <= top && top < ksize );
+        // the kernels may have changed, the engines built for the previous images are outdated
+        kernelVersion++;
+        return CV_MAKETYPE(ddepth >= 0 ? ddepth : CV_MAT_DEPTH(srcType), CV_MAT_CN(srcType));
+    }
+
+    void run(const Mat& src, const Range& rows, Mat& dst) const
+    {
+        // a filter engine keeps its buffers between the calls, so each thread builds its own
+        // and reuses it for the following tiles
+        EngineCache* cache = engines.get();
+        if( !cache->engine || cache->version != kernelVersion ||
+            cache->srcType != src.type() || cache->dstType != dst.type() )
+        {
+            cache->engine = createSeparableLinearFilter(src.type(), dst.type(), kx, ky,
+                                                        anchor, delta, borderType);
+            cache->version = kernelVersion;
+            cache->srcType = src.type();
+            cache->dstType = dst.type();
+        }
+        // src holds the rows around the tile, so only the image boundaries are extrapolated
+        cache->engine->apply(src, dst, Rect(0, rows.start, src.cols, rows.size()));
+    }
+
+    struct EngineCache
+    {
+        EngineCache() : version(-1), srcType(-1), dstType(-1) {}
+
+        Ptr<FilterEngine> engine;
+        int version, srcType, dstType;
+    };
+
+    int ddepth;
+    Mat kx, ky;
+    Point anchor;
+    double delta;
+    int borderType;
+    int kernelVersion;
+    TLSData<EngineCache> engines;
+};
+
+class GaussianStage : public SepFilterStage
+{
+public:
+    GaussianStage(Size _ksize, double _sigma1, double _sigma2, int _borderType)
+        : SepFilterStage(-1, Mat(), Mat(), Point(-1,-1), 0, _borderType),
+          ksize(_ksize), sigma1(_sigma1), sigma2(_sigma2) {}
+
+    int prepare(int srcType)
+    {
+        // the kernel size derived from sigma depends on the image depth
+        createGaussianKernels(kx, ky, srcType, ksize, sigma1, sigma2);
+        return SepFilterStage::prepare(srcType);
+    }
+
+    Size ksize;
+    double sigma1, sigma2;
+};
+
+class FusedPipelineBody : public ParallelLoopBody
+{
+public:
+    FusedPipelineBody(const std::vector<Ptr<PipelineStage> >& _stages, const std::vector<int>& _types,
+                      const Mat& _src, Mat& _dst, int _tileRows)
+        : stages(_stages), types(_types), src(_src), dst(&_dst), tileRows(_tileRows) {}
+
+    void operator()(const Range& range) const
+    {
+        // the buffers of the intermediate images are reused by the next tiles of the thread
+        ScopedArena arena;
+        int n = (int)stages.size(), height = src.rows;
+        std::vector<Range> rows(n + 1);
+
+        for( int t = range.start; t < range.end; t++ )
+        {
+            // rows of the intermediate images needed to compute the output rows of the tile
+            rows[n] = Range(t*tileRows, std::min((t + 1)*tileRows, height));
+            for( int k = n - 1; k >= 0; k-- )
+                rows[k] = Range(std::max(rows[k+1].start - stages[k]->top, 0),
+                                std::min(rows[k+1].end + stages[k]->bottom, height));
+
+            Mat input = src.rowRange(rows[0]);
+            for( int k = 0; k < n; k++ )
+            {
+                Mat output = k == n - 1 ? dst->rowRange(rows[n]) :
+                                          Mat(rows[k+1].size(), src.cols, types[k+1]);
+                stages[k]->run(input, Range(rows[k+1].start - rows[k].start,
+                                            rows[k+1].end - rows[k].start), output);
+                CV_DbgAssert( k < n - 1 || output.data == dst->ptr(rows[n].start) );
+                input = output;
+            }
+        }
+    }
+
+private:
+    const std::vector<Ptr<PipelineStage> >& stages;
+    const std::vector<int>& types;
+    Mat src;
+    Mat* dst;
+    int tileRows;
+};
+
+class FusedPipelineImpl : public FusedPipeline
+{
+public:
+    // target size of the rows of all the intermediate images of a tile, about the L2 cache size
+    enum { TILE_SIZE = 1 << 18, MIN_TILE_ROWS = 8 };
+
+    FusedPipeline& cvtColor(int code, int dstCn)
+    {
+        stages.push_back(makePtr<CvtColorStage>(code, dstCn));
+        return *this;
+    }
+
+    FusedPipeline& LUT(InputArray lut)
+    {
+        stages.push_back(makePtr<LUTStage>(lut.getMat()));
+        return *this;
+    }
+
+    FusedPipeline& convertTo(int rtype, double alpha, double beta)
+    {
+        stages.push_back(makePtr<ConvertStage>(rtype, alpha, beta));
+        return *this;
+    }
+
+    FusedPipeline& threshold(double thresh, double maxval, int type)
+    {
+        stages.push_back(makePtr<ThresholdStage>(thresh, maxval, type));
+        return *this;
+    }
+
+    FusedPipeline& sepFilter2D(int ddepth, InputArray kernelX, InputArray kernelY,
+                               Point anchor, double delta, int borderType)
+    {
+        stages.push_back(makePtr<SepFilterStage>(ddepth, kernelX.getMat(), kernelY.getMat(),
+                                                 anchor, delta, borderType));
+        return *this;
+    }
+
+    FusedPipeline& GaussianBlur(Size ksize, double sigmaX, double sigmaY, int borderType)
+    {
+        stages.push_back(makePtr<GaussianStage>(ksize, sigmaX, sigmaY, borderType));
+        return *this;
+    }
+
+    void apply(InputArray _src, OutputArray _dst)
+    {
+        CV_TRACE_FUNCTION();
+        CV_Assert( !stages.empty() && _src.dims() <= 2 );
+
+        Mat src = _src.getMat();
+        int n = (int)stages.size(), halo = 0;
+        std::vector<int> types(n + 1);
+        types[0] = src.type();
+        size_t rowSize = src.cols*src.elemSize();
+        for( int k = 0; k < n; k++ )
+        {
+            types[k+1] = stages[k]->prepare(types[k]);
+            rowSize += src.cols*CV_ELEM_SIZE(types[k+1]);
+            halo += stages[k]->top + stages[k]->bottom;
+        }
+
+        _dst.create(src.size(), types[n]);
+        Mat dst = _dst.getMat();
+        if( src.empty() )
+            return;
+        // the neighbouring tiles read the source rows being overwritten
+        if( halo > 0 && src.data == dst.data )
+            src = src.clone();
+
+        int tileRows = (int)std::min(TILE_SIZE/rowSize, (size_t)src.rows);
+        tileRows = std::max(tileRows, std::max(4*halo, (int)MIN_TILE_ROWS));
+        int ntiles = (src.rows + tileRows - 1)/tileRows;
+
+        parallel_for_(Range(0, ntiles), FusedPipelineBody(stages, types, src, dst, tileRows));
+    }
+
+    void clear()
+    {
+        stages.clear();
+    }
+
+    bool empty() const
+    {
+        return stages.empty();
+    }
+
+private:
+    std::vector<Ptr<PipelineStage> > stages;
+};
+
+}
+
+cv::Ptr<cv::FusedPipeline> cv::createFusedPipeline()
+{
+    return makePtr<FusedPipelineImpl>();
+}
@@ -632,12 +632,35 @@ static bool ipp_sqrDistance(const Mat& src, const Mat& tpl, Mat& dst)
 
 #endif
 
+// the size of the blocks of the correlation computed by one DFT, and of the DFT
+static void calcCorrBlocks( Size templsize, Size corrsize, Size& blocksize, Size& dftsize )
+{
+    const double blockScale = 4.5;
+    const int minBlockSize = 256;
+
+    blocksize.width = cvRound(templsize.width*blockScale);
+    blocksize.width = std::max( blocksize.width, minBlockSize - templsize.width + 1 );
+    blocksize.width = std::min( blocksize.width, corrsize.width );
+    blocksize.height = cvRound(templsize.height*blockScale);
+    blocksize.height = std::max( blocksize.height, minBlockSize - templsize.height + 1 );
+    blocksize.height = std::min( blocksize.height, corrsize.height );
+
+    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templsize.width - 1), 2);
+    dftsize.height = getOptimalDFTSize(blocksize.height + templsize.height - 1);
+    if( dftsize.width <= 0 || dftsize.height <= 0 )
+        CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
+
+    // recompute block size
+    blocksize.width = dftsize.width - templsize.width + 1;
+    blocksize.width = MIN( blocksize.width, corrsize.width );
+    blocksize.height = dftsize.height - templsize.height + 1;
+    blocksize.height = MIN( blocksize.height, corrsize.height );
+}
+
 void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
                 Size corrsize, int ctype,
                 Point anchor, double delta, int borderType )
 {
-    const double blockScale = 4.5;
-    const int minBlockSize = 256;
     std::vector<uchar> buf;
 
     Mat templ = _templ;
@@ -663,24 +686,7 @@ void crossCorr( const Mat& img, const Mat& _templ, Mat& corr,
 
     int maxDepth = depth > CV_8S ? CV_64F : std::max(std::max(CV_32F, tdepth), cdepth);
     Size blocksize, dftsize;
-
-    blocksize.width = cvRound(templ.cols*blockScale);
-    blocksize.width = std::max( blocksize.width, minBlockSize - templ.cols + 1 );
-    blocksize.width = std::min( blocksize.width, corr.cols );
-    blocksize.height = cvRound(templ.rows*blockScale);
-    blocksize.height = std::max( blocksize.height, minBlockSize - templ.rows + 1 );
-    blocksize.height = std::min( blocksize.height, corr.rows );
-
-    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + templ.cols - 1), 2);
-    dftsize.height = getOptimalDFTSize(blocksize.height + templ.rows - 1);
-    if( dftsize.width <= 0 || dftsize.height <= 0 )
-        CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
-
-    // recompute block size
-    blocksize.width = dftsize.width - templ.cols + 1;
-    blocksize.width = MIN( blocksize.width, corr.cols );
-    blocksize.height = dftsize.height - templ.rows + 1;
-    blocksize.height = MIN( blocksize.height, corr.rows );
+    calcCorrBlocks( templ.size(), corr.size(), blocksize, dftsize );
 
     Mat dftTempl( dftsize.height*tcn, dftsize.width, maxDepth );
     Mat dftImg( dftsize, maxDepth );
@@ -898,7 +904,9 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
 
 namespace cv
 {
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+// normalizes the cross-correlation in result by the sums over the image windows,
+// computed from the integral images of the image (sqsum is not needed by CV_TM_CCOEFF)
+static void common_matchTemplate( const Mat& sum, const Mat& sqsum, const Mat& templ, Mat& result, int method, int cn )
 {
     if( method == CV_TM_CCORR )
         return;
@@ -911,19 +919,16 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
 
     double invArea = 1./((double)templ.rows * templ.cols);
 
-    Mat sum, sqsum;
     Scalar templMean, templSdv;
     double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
     double templNorm = 0, templSum2 = 0;
 
     if( method == CV_TM_CCOEFF )
     {
-        integral(img, sum, CV_64F);
         templMean = mean(templ);
     }
     else
     {
-        integral(img, sum, sqsum, CV_64F);
         meanStdDev( templ, templMean, templSdv );
 
         templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
@@ -1015,6 +1020,19 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         }
     }
 }
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+{
+    if( method == CV_TM_CCORR )
+        return;
+
+    Mat sum, sqsum;
+    if( method == CV_TM_CCOEFF )
+        integral(img, sum, CV_64F);
+    else
+        integral(img, sum, sqsum, CV_64F);
+    common_matchTemplate( sum, sqsum, templ, result, method, cn );
+}
 }
 
 
@@ -1051,6 +1069,8 @@ static bool ipp_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, in
 
 void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result, int method, InputArray _mask )
 {
+    CV_TRACE_FUNCTION();
+
     if (!_mask.empty())
     {
         cv::matchTemplateMask(_img, _templ, _result, method, _mask);
@@ -1090,6 +1110,318 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
     common_matchTemplate(img, templ, result, method, cn);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cv
+{
+
+// computes the spectra of the channels of the image blocks, for all the templates of one size
+class ImageBlockSpectra : public ParallelLoopBody
+{
+public:
+    ImageBlockSpectra( const Mat& _img, Size _blocksize, Size _dftsize, Size _templsize, int _wdepth,
+                       std::vector<Mat>& _spectra )
+        : img(_img), blocksize(_blocksize), dftsize(_dftsize), templsize(_templsize), wdepth(_wdepth),
+          spectra(&_spectra) {}
+
+    void operator()( const Range& range ) const
+    {
+        int cn = img.channels();
+        int tileCountX = (img.cols - templsize.width + blocksize.width)/blocksize.width;
+        Mat plane;
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int x = (i%tileCountX)*blocksize.width, y = (i/tileCountX)*blocksize.height;
+            Size dsz(std::min(blocksize.width + templsize.width - 1, img.cols - x),
+                     std::min(blocksize.height + templsize.height - 1, img.rows - y));
+            Mat src(img, Rect(Point(x, y), dsz));
+            Mat& spectrum = (*spectra)[i];
+            spectrum.create(dftsize.height*cn, dftsize.width, wdepth);
+            spectrum = Scalar::all(0);
+
+            for( int k = 0; k < cn; k++ )
+            {
+                Mat dst(spectrum, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                Mat dst1(dst, Rect(Point(), dsz));
+                if( cn > 1 )
+                {
+                    int pairs[] = {k, 0};
+                    plane.create(dsz, img.depth());
+                    mixChannels(&src, 1, &plane, 1, pairs, 1);
+                    plane.convertTo(dst1, wdepth);
+                }
+                else
+                    src.convertTo(dst1, wdepth);
+                dft(dst, dst, 0, dsz.height);
+            }
+        }
+    }
+
+protected:
+    Mat img;
+    Size blocksize, dftsize, templsize;
+    int wdepth;
+    std::vector<Mat>* spectra;
+};
+
+// correlates the image blocks with the templates of one size, every pair of a block and a template
+// is multiplied in the frequency domain and transformed back separately
+class BlockCorrelation : public ParallelLoopBody
+{
+public:
+    BlockCorrelation( const std::vector<Mat>& _imgSpectra, const std::vector<const Mat*>& _templSpectra,
+                      std::vector<Mat>& _results, Size _blocksize, Size _dftsize, int _cn )
+        : imgSpectra(&_imgSpectra), templSpectra(&_templSpectra), results(&_results),
+          blocksize(_blocksize), dftsize(_dftsize), cn(_cn) {}
+
+    void operator()( const Range& range ) const
+    {
+        int nblocks = (int)imgSpectra->size();
+        Mat acc, prod;
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int t = i / nblocks, b = i % nblocks;
+            Mat& result = (*results)[t];
+            int tileCountX = (result.cols + blocksize.width - 1)/blocksize.width;
+            int x = (b%tileCountX)*blocksize.width, y = (b/tileCountX)*blocksize.height;
+            Size bsz(std::min(blocksize.width, result.cols - x), std::min(blocksize.height, result.rows - y));
+
+            // the products of the channels are summed before the single inverse transform
+            for( int k = 0; k < cn; k++ )
+            {
+                Rect plane(0, k*dftsize.height, dftsize.width, dftsize.height);
+                mulSpectrums((*imgSpectra)[b](plane), (*templSpectra)[t][0](plane), k == 0 ? acc : prod, 0, true);
+                if( k > 0 )
+                    acc += prod;
+            }
+            dft(acc, acc, DFT_INVERSE + DFT_SCALE, bsz.height);
+            acc(Rect(Point(), bsz)).convertTo(result(Rect(Point(x, y), bsz)), CV_32F);
+        }
+    }
+
+protected:
+    const std::vector<Mat>* imgSpectra;
+    const std::vector<const Mat*>* templSpectra;
+    std::vector<Mat>* results;
+    Size blocksize, dftsize;
+    int cn;
+};
+
+class TemplateMatcherImpl : public TemplateMatcher
+{
+public:
+    TemplateMatcherImpl( int _method ) : method(_method) {}
+
+    void setTemplates( InputArrayOfArrays _templs )
+    {
+        int n = _templs.empty() ? 0 : (int)_templs.total();
+        templs.resize(n);
+        spectra.assign(n, std::vector<TemplSpectrum>());
+        for( int i = 0; i < n; i++ )
+        {
+            templs[i] = _templs.getMat(i).clone();
+            CV_Assert( templs[i].type() == templs[0].type() && templs[i].dims <= 2 && !templs[i].empty() );
+        }
+        CV_Assert( n == 0 || templs[0].depth() == CV_8U || templs[0].depth() == CV_32F );
+    }
+
+    int getTemplatesCount() const { return (int)templs.size(); }
+
+    void setMethod( int _method )
+    {
+        CV_Assert( CV_TM_SQDIFF <= _method && _method <= CV_TM_CCOEFF_NORMED );
+        method = _method;
+    }
+
+    int getMethod() const { return method; }
+
+    void match( InputArray _img, OutputArrayOfArrays _results )
+    {
+        int n = (int)templs.size();
+        Mat img = _img.getMat();
+        CV_Assert( n > 0 && img.type() == templs[0].type() && img.dims <= 2 );
+
+        std::vector<int> idx(n);
+        std::vector<Mat> results(n);
+        _results.create(n, 1, CV_32F);
+        for( int i = 0; i < n; i++ )
+        {
+            CV_Assert( templs[i].rows <= img.rows && templs[i].cols <= img.cols );
+            _results.create(img.rows - templs[i].rows + 1, img.cols - templs[i].cols + 1, CV_32F, i);
+            results[i] = _results.getMat(i);
+            idx[i] = i;
+        }
+        matchImpl(img, idx, results);
+    }
+
+    void match( InputArray _img, int templIdx, OutputArray _result )
+    {
+        CV_Assert( 0 <= templIdx && templIdx < (int)templs.size() );
+        Mat img = _img.getMat();
+        const Mat& templ = templs[templIdx];
+        CV_Assert( img.type() == templ.type() && img.dims <= 2 &&
+                   templ.rows <= img.rows && templ.cols <= img.cols );
+
+        _result.create(img.rows - templ.rows + 1, img.cols - templ.cols + 1, CV_32F);
+        std::vector<int> idx(1, templIdx);
+        std::vector<Mat> results(1, _result.getMat());
+        matchImpl(img, idx, results);
+    }
+
+    void clearCache()
+    {
+        spectra.assign(templs.size(), std::vector<TemplSpectrum>());
+    }
+
+protected:
+    struct TemplSpectrum
+    {
+        Size dftsize;
+        Mat spectrum; // the spectra of the channels one below another
+    };
+
+    struct TemplSizeLess
+    {
+        TemplSizeLess( const std::vector<Mat>& _templs, const std::vector<int>& _idx )
+            : templs(&_templs), idx(&_idx) {}
+        bool operator()( int a, int b ) const
+        {
+            Size sa = (*templs)[(*idx)[a]].size(), sb = (*templs)[(*idx)[b]].size();
+            return sa.width < sb.width || (sa.width == sb.width && (sa.height < sb.height ||
+                   (sa.height == sb.height && a < b)));
+        }
+        const std::vector<Mat>* templs;
+        const std::vector<int>* idx;
+    };
+
+    class Normalization : public ParallelLoopBody
+    {
+    public:
+        Normalization( const Mat& _sum, const Mat& _sqsum, const std::vector<Mat>& _templs,
+                       const std::vector<Mat>& _results, int _method )
+            : sum(_sum), sqsum(_sqsum), templs(&_templs), results(&_results), method(_method) {}
+
+        void operator()( const Range& range ) const
+        {
+            for( int i = range.start; i < range.end; i++ )
+            {
+                Mat result = (*results)[i];
+                common_matchTemplate(sum, sqsum, (*templs)[i], result, method, (*templs)[i].channels());
+            }
+        }
+
+    protected:
+        Mat sum, sqsum;
+        const std::vector<Mat>* templs;
+        const std::vector<Mat>* results;
+        int method;
+    };
+
+    // matches the image against the selected templates, results[i] is the preallocated output for idx[i]
+    void matchImpl( const Mat& img, const std::vector<int>& idx, std::vector<Mat>& results )
+    {
+        int n = (int)idx.size(), cn = img.channels();
+        int wdepth = img.depth() > CV_8S ? CV_64F : CV_32F;
+
+        // the templates of one size share the decomposition of the image into blocks and their spectra
+        std::vector<int> order(n);
+        for( int i = 0; i < n; i++ )
+            order[i] = i;
+        std::sort(order.begin(), order.end(), TemplSizeLess(templs, idx));
+
+        std::vector<Mat> imgSpectra, groupResults;
+        std::vector<const Mat*> groupSpectra;
+        for( int i0 = 0, i1; i0 < n; i0 = i1 )
+        {
+            Size templsize = templs[idx[order[i0]]].size();
+            for( i1 = i0 + 1; i1 < n && templs[idx[order[i1]]].size() == templsize; i1++ )
+                ;
+
+            Size corrsize(img.cols - templsize.width + 1, img.rows - templsize.height + 1);
+            Size blocksize, dftsize;
+            calcCorrBlocks(templsize, corrsize, blocksize, dftsize);
+            int nblocks = ((corrsize.width + blocksize.width - 1)/blocksize.width)*
+                          ((corrsize.height + blocksize.height - 1)/blocksize.height);
+
+            groupSpectra.resize(i1 - i0);
+            groupResults.resize(i1 - i0);
+            for( int i = i0; i < i1; i++ )
+            {
+                groupSpectra[i - i0] = &templSpectrum(idx[order[i]], dftsize, wdepth);
+                groupResults[i - i0] = results[order[i]];
+            }
+
+            imgSpectra.resize(nblocks);
+            parallel_for_(Range(0, nblocks), ImageBlockSpectra(img, blocksize, dftsize, templsize, wdepth, imgSpectra));
+            parallel_for_(Range(0, nblocks*(i1 - i0)),
+                          BlockCorrelation(imgSpectra, groupSpectra, groupResults, blocksize, dftsize, cn));
+        }
+
+        // the sums over the image windows are computed once for all the templates
+        if( method != CV_TM_CCORR )
+        {
+            Mat sum, sqsum;
+            if( method == CV_TM_CCOEFF )
+                integral(img, sum, CV_64F);
+            else
+                integral(img, sum, sqsum, CV_64F);
+            std::vector<Mat> selected(n);
+            for( int i = 0; i < n; i++ )
+                selected[i] = templs[idx[i]];
+            parallel_for_(Range(0, n), Normalization(sum, sqsum, selected, results, method));
+        }
+    }
+
+    // returns the cached spectrum of the template for the DFT size, computing it on the first use
+    const Mat& templSpectrum( int idx, Size dftsize, int wdepth )
+    {
+        std::vector<TemplSpectrum>& cache = spectra[idx];
+        for( size_t i = 0; i < cache.size(); i++ )
+            if( cache[i].dftsize == dftsize && cache[i].spectrum.depth() == wdepth )
+                return cache[i].spectrum;
+
+        const Mat& templ = templs[idx];
+        int cn = templ.channels();
+        TemplSpectrum entry;
+        entry.dftsize = dftsize;
+        entry.spectrum = Mat::zeros(dftsize.height*cn, dftsize.width, wdepth);
+        for( int k = 0; k < cn; k++ )
+        {
+            Mat dst(entry.spectrum, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+            Mat dst1(dst, Rect(Point(), templ.size()));
+            if( cn > 1 )
+            {
+                Mat plane(templ.size(), templ.depth());
+                int pairs[] = {k, 0};
+                mixChannels(&templ, 1, &plane, 1, pairs, 1);
+                plane.convertTo(dst1, wdepth);
+            }
+            else
+                templ.convertTo(dst1, wdepth);
+            dft(dst, dst, 0, templ.rows);
+        }
+        cache.push_back(entry);
+        return cache.back().spectrum;
+    }
+
+    int method;
+    std::vector<Mat> templs;
+    std::vector<std::vector<TemplSpectrum> > spectra; // per template, for every DFT size used
+};
+
+Ptr<TemplateMatcher> createTemplateMatcher( int method, InputArrayOfArrays templs )
+{
+    Ptr<TemplateMatcherImpl> matcher = makePtr<TemplateMatcherImpl>(CV_TM_CCORR);
+    matcher->setMethod(method);
+    if( !templs.empty() )
+        matcher->setTemplates(templs);
+    return matcher;
+}
+
+}
+
 CV_IMPL void
 cvMatchTemplate( const CvArr* _img, const CvArr* _templ, CvArr* _result, int method )
 {
@@ -0,0 +1,94 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+TEST(Imgproc_FusedPipeline, pixelwise)
+{
+    RNG& rng = theRNG();
+    Mat src(1080, 1920, CV_8UC3), lut(1, 256, CV_8U);
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+    rng.fill(lut, RNG::UNIFORM, 0, 256);
+
+    Ptr<FusedPipeline> p = createFusedPipeline();
+    EXPECT_TRUE(p->empty());
+    p->cvtColor(COLOR_BGR2GRAY).LUT(lut).threshold(100, 200, THRESH_TRUNC).convertTo(CV_32F, 1./255, 0.5);
+
+    Mat dst;
+    p->apply(src, dst);
+
+    Mat gray, mapped, thresh, ref;
+    cvtColor(src, gray, COLOR_BGR2GRAY);
+    LUT(gray, lut, mapped);
+    threshold(mapped, thresh, 100, 200, THRESH_TRUNC);
+    thresh.convertTo(ref, CV_32F, 1./255, 0.5);
+
+    ASSERT_EQ(CV_32FC1, dst.type());
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+TEST(Imgproc_FusedPipeline, filters)
+{
+    RNG& rng = theRNG();
+    int borders[] = { BORDER_REFLECT_101, BORDER_REPLICATE, BORDER_CONSTANT };
+
+    for( int i = 0; i < 3; i++ )
+    {
+        Mat src(777, 501, CV_8UC3);
+        rng.fill(src, RNG::UNIFORM, 0, 256);
+        Mat kx = (Mat_<float>(1, 3) << -1, 0, 1), ky = (Mat_<float>(5, 1) << 1, 2, 3, 2, 1);
+
+        Ptr<FusedPipeline> p = createFusedPipeline();
+        p->GaussianBlur(Size(7, 7), 2, 0, borders[i])
+          .cvtColor(COLOR_BGR2HSV)
+          .sepFilter2D(CV_16S, kx, ky, Point(1, 1), 3, borders[i])
+          .GaussianBlur(Size(), 1.5, 0, borders[i]);
+
+        Mat dst;
+        p->apply(src, dst);
+
+        Mat blurred, hsv, filtered, ref;
+        GaussianBlur(src, blurred, Size(7, 7), 2, 0, borders[i]);
+        cvtColor(blurred, hsv, COLOR_BGR2HSV);
+        sepFilter2D(hsv, filtered, CV_16S, kx, ky, Point(1, 1), 3, borders[i]);
+        GaussianBlur(filtered, ref, Size(), 1.5, 0, borders[i]);
+
+        ASSERT_EQ(ref.type(), dst.type());
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF)) << "border=" << borders[i];
+    }
+}
+
+TEST(Imgproc_FusedPipeline, inplace)
+{
+    Mat src(300, 200, CV_32FC1);
+    theRNG().fill(src, RNG::UNIFORM, -1, 1);
+
+    Mat ref;
+    GaussianBlur(src, ref, Size(5, 5), 0);
+
+    Ptr<FusedPipeline> p = createFusedPipeline();
+    p->GaussianBlur(Size(5, 5), 0);
+    p->apply(src, src);
+
+    EXPECT_EQ(0, cvtest::norm(ref, src, NORM_INF));
+}
+
+TEST(Imgproc_FusedPipeline, unsupported)
+{
+    Ptr<FusedPipeline> p = createFusedPipeline();
+    EXPECT_THROW(p->cvtColor(COLOR_BayerBG2BGR), cv::Exception);
+    EXPECT_THROW(p->cvtColor(COLOR_YUV2BGR_NV12), cv::Exception);
+    EXPECT_THROW(p->threshold(0, 255, THRESH_BINARY | THRESH_OTSU), cv::Exception);
+    EXPECT_TRUE(p->empty());
+
+    Mat src(10, 10, CV_32F, Scalar::all(0)), dst;
+    p->LUT(Mat(1, 256, CV_8U, Scalar::all(0)));
+    EXPECT_THROW(p->apply(src, dst), cv::Exception);
+
+    p->clear();
+    EXPECT_TRUE(p->empty());
+}
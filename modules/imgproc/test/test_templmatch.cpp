@@ -334,3 +334,56 @@ void CV_TemplMatchTest::prepare_to_validation( int /*test_case_idx*/ )
 }
 
 TEST(Imgproc_MatchTemplate, accuracy) { CV_TemplMatchTest test; test.safe_run(); }
+
+TEST(Imgproc_TemplateMatcher, accuracy)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1 };
+
+    for( int t = 0; t < 3; t++ )
+    {
+        Mat img(143, 211, types[t]), frame(img.size(), types[t]);
+        rng.fill(img, RNG::UNIFORM, 0, 256);
+        rng.fill(frame, RNG::UNIFORM, 0, 256);
+
+        // two templates of every size, to check the shared block spectra
+        std::vector<Mat> templs;
+        const Size sizes[] = { Size(5, 5), Size(17, 9), Size(40, 33) };
+        for( int i = 0; i < 6; i++ )
+        {
+            Size sz = sizes[i % 3];
+            Rect r(rng.uniform(0, img.cols - sz.width), rng.uniform(0, img.rows - sz.height), sz.width, sz.height);
+            templs.push_back(img(r).clone());
+        }
+
+        Ptr<TemplateMatcher> matcher = createTemplateMatcher(TM_SQDIFF, templs);
+        ASSERT_EQ(6, matcher->getTemplatesCount());
+
+        for( int method = TM_SQDIFF; method <= TM_CCOEFF_NORMED; method++ )
+        {
+            matcher->setMethod(method);
+            // the second image is matched with the cached template spectra
+            for( int k = 0; k < 2; k++ )
+            {
+                const Mat& src = k == 0 ? img : frame;
+                std::vector<Mat> results;
+                matcher->match(src, results);
+                ASSERT_EQ(templs.size(), results.size());
+
+                for( size_t i = 0; i < templs.size(); i++ )
+                {
+                    Mat ref, single;
+                    matchTemplate(src, templs[i], ref, method);
+                    ASSERT_EQ(ref.size(), results[i].size());
+                    ASSERT_EQ(CV_32F, results[i].type());
+                    double scale = std::max(norm(ref, NORM_INF), 1.);
+                    EXPECT_LE(norm(ref, results[i], NORM_INF)/scale, 1e-4)
+                        << "type " << types[t] << ", method " << method << ", template " << i;
+
+                    matcher->match(src, (int)i, single);
+                    EXPECT_EQ(0, norm(single, results[i], NORM_INF));
+                }
+            }
+        }
+    }
+}
@@ -412,7 +412,9 @@ public:
     /** @copybrief getIsClassifier @see getIsClassifier */
     CV_WRAP virtual void setIsClassifier(bool val) = 0;
 
-    /** Parameter for KDTree implementation. */
+    /** Parameter for KDTree implementation, the max number of leaves to visit. For the HNSW
+    implementation, the size of the candidate list of the search: 64 (or k, if larger) when left
+    to the default INT_MAX. */
     /** @see setEmax */
     CV_WRAP virtual int getEmax() const = 0;
     /** @copybrief getEmax @see getEmax */
@@ -460,7 +462,8 @@ public:
     enum Types
     {
         BRUTE_FORCE=1,
-        KDTREE=2
+        KDTREE=2,
+        HNSW=3 //!< approximate search in a graph index, see cv::flann::HNSWIndexParams
     };
 
     /** @brief Creates the empty model
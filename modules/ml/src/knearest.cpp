@@ -42,6 +42,7 @@
 
 #include "precomp.hpp"
 #include "kdtree.hpp"
+#include "opencv2/flann.hpp"
 
 /****************************************************************************************\
 *                              K-Nearest Neighbors Classifier                            *
@@ -52,6 +53,7 @@ namespace ml {
 
 const String NAME_BRUTE_FORCE = "opencv_ml_knn";
 const String NAME_KDTREE = "opencv_ml_knn_kd";
+const String NAME_HNSW = "opencv_ml_knn_hnsw";
 
 class Impl
 {
@@ -100,6 +102,56 @@ public:
 
     virtual void doTrain(InputArray points) { (void)points; }
 
+    // The mean of the responses of the k neighbors for a regression, the most frequent one
+    // for a classification; rp is sorted by the vote.
+    float predictResponse( float* rp, int k ) const
+    {
+        int i, j;
+        float result;
+        if( !isclassifier || k == 1 )
+        {
+            float s = 0.f;
+            for( j = 0; j < k; j++ )
+                s += rp[j];
+            result = (float)(s*(1.f/k));
+        }
+        else
+        {
+            for( j = k-1; j > 0; j-- )
+            {
+                bool swap_fl = false;
+                for( i = 0; i < j; i++ )
+                {
+                    if( rp[i] > rp[i+1] )
+                    {
+                        std::swap(rp[i], rp[i+1]);
+                        swap_fl = true;
+                    }
+                }
+                if( !swap_fl )
+                    break;
+            }
+
+            result = rp[0];
+            int prev_start = 0;
+            int best_count = 0;
+            for( j = 1; j <= k; j++ )
+            {
+                if( j == k || rp[j] != rp[j-1] )
+                {
+                    int count = j - prev_start;
+                    if( best_count < count )
+                    {
+                        best_count = count;
+                        result = rp[j-1];
+                    }
+                    prev_start = j;
+                }
+            }
+        }
+        return result;
+    }
+
     void clear()
     {
         samples.release();
@@ -114,6 +166,10 @@ public:
 
         fn["samples"] >> samples;
         fn["responses"] >> responses;
+
+        // the search structures are not stored, they are rebuilt from the samples
+        if( !samples.empty() )
+            doTrain(samples);
     }
 
     void write( FileStorage& fs ) const
@@ -206,7 +262,6 @@ public:
         }
 
         float result = 0.f;
-        float inv_scale = 1.f/k;
 
         for( testidx = 0; testidx < testcount; testidx++ )
         {
@@ -230,48 +285,7 @@ public:
 
             if( results || testidx+range.start == 0 )
             {
-                if( !isclassifier || k == 1 )
-                {
-                    float s = 0.f;
-                    for( j = 0; j < k; j++ )
-                        s += rbuf[testidx*k + j];
-                    result = (float)(s*inv_scale);
-                }
-                else
-                {
-                    float* rp = rbuf + testidx*k;
-                    for( j = k-1; j > 0; j-- )
-                    {
-                        bool swap_fl = false;
-                        for( i = 0; i < j; i++ )
-                        {
-                            if( rp[i] > rp[i+1] )
-                            {
-                                std::swap(rp[i], rp[i+1]);
-                                swap_fl = true;
-                            }
-                        }
-                        if( !swap_fl )
-                            break;
-                    }
-
-                    result = rp[0];
-                    int prev_start = 0;
-                    int best_count = 0;
-                    for( j = 1; j <= k; j++ )
-                    {
-                        if( j == k || rp[j] != rp[j-1] )
-                        {
-                            int count = j - prev_start;
-                            if( best_count < count )
-                            {
-                                best_count = count;
-                                result = rp[j-1];
-                            }
-                            prev_start = j;
-                        }
-                    }
-                }
+                result = predictResponse(rbuf + testidx*k, k);
                 if( results )
                     results->at<float>(testidx + range.start) = result;
                 if( presult && testidx+range.start == 0 )
@@ -430,6 +444,93 @@ public:
     KDTree tr;
 };
 
+
+// Approximate search in a FLANN graph index, for large training sets.
+class HNSWImpl : public Impl
+{
+public:
+    String getModelName() const { return NAME_HNSW; }
+    int getType() const { return ml::KNearest::HNSW; }
+
+    void doTrain(InputArray points)
+    {
+        index.build(points, flann::HNSWIndexParams());
+    }
+
+    float findNearest( InputArray _samples, int k0,
+                       OutputArray _results,
+                       OutputArray _neighborResponses,
+                       OutputArray _dists ) const
+    {
+        float result = 0.f;
+        CV_Assert( 0 < k0 );
+
+        Mat test_samples = _samples.getMat();
+        CV_Assert( test_samples.type() == CV_32F && test_samples.cols == samples.cols );
+        int testcount = test_samples.rows;
+        int k = std::min(k0, samples.rows);
+
+        if( testcount == 0 )
+        {
+            _results.release();
+            _neighborResponses.release();
+            _dists.release();
+            return 0.f;
+        }
+
+        Mat res, nr, d;
+        if( _results.needed() )
+        {
+            _results.create(testcount, 1, CV_32F);
+            res = _results.getMat();
+        }
+        if( _neighborResponses.needed() )
+        {
+            _neighborResponses.create(testcount, k0, CV_32F);
+            nr = _neighborResponses.getMat();
+            nr.setTo(Scalar::all(0));
+        }
+        if( _dists.needed() )
+        {
+            _dists.create(testcount, k0, CV_32F);
+            d = _dists.getMat();
+            d.setTo(Scalar::all(0));
+        }
+
+        // the batch is searched in parallel by the index
+        int checks = Emax == INT_MAX ? std::max(k, 64) : std::max(k, Emax);
+        Mat indices, dists;
+        index.knnSearch(test_samples, indices, dists, k, flann::SearchParams(checks));
+
+        AutoBuffer<float> buf(k);
+        float* rp = buf;
+        const float* rptr = responses.ptr<float>();
+        for( int i = 0; i < testcount; i++ )
+        {
+            const int* idx = indices.ptr<int>(i);
+            int count = 0;
+            while( count < k && idx[count] >= 0 )
+            {
+                rp[count] = rptr[idx[count]];
+                count++;
+            }
+            if( !nr.empty() )
+                std::copy(rp, rp + count, nr.ptr<float>(i));
+            if( !d.empty() )
+                std::copy(dists.ptr<float>(i), dists.ptr<float>(i) + count, d.ptr<float>(i));
+
+            float r = count > 0 ? predictResponse(rp, count) : 0.f;
+            if( !res.empty() )
+                res.at<float>(i) = r;
+            if( i == 0 )
+                result = r;
+        }
+        return result;
+    }
+
+    mutable flann::Index index;
+};
+
 //================================================================
 
 class KNearestImpl : public KNearest
@@ -445,7 +546,7 @@ public:
     }
     void setAlgorithmType(int val)
     {
-        if (val != BRUTE_FORCE && val != KDTREE)
+        if (val != BRUTE_FORCE && val != KDTREE && val != HNSW)
             val = BRUTE_FORCE;
         initImpl(val);
     }
@@ -474,6 +575,8 @@ public:
         int algorithmType = BRUTE_FORCE;
         if (fn.name() == NAME_KDTREE)
             algorithmType = KDTREE;
+        else if (fn.name() == NAME_HNSW)
+            algorithmType = HNSW;
         initImpl(algorithmType);
         impl->read(fn);
     }
@@ -501,10 +604,12 @@ public:
 protected:
     void initImpl(int algorithmType)
     {
-        if (algorithmType != KDTREE)
-            impl = makePtr<BruteForceImpl>();
-        else
+        if (algorithmType == KDTREE)
             impl = makePtr<KDTreeImpl>();
+        else if (algorithmType == HNSW)
+            impl = makePtr<HNSWImpl>();
+        else
+            impl = makePtr<BruteForceImpl>();
     }
     Ptr<Impl> impl;
 };
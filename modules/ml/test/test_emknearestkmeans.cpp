@@ -345,6 +345,22 @@ void CV_KNearestTest::run( int /*start_from*/ )
         code = cvtest::TS::FAIL_BAD_ACCURACY;
     }
 
+    // KNearest HNSW implementation
+    Ptr<KNearest> knearestHnsw = KNearest::create();
+    knearestHnsw->setAlgorithmType(KNearest::HNSW);
+    knearestHnsw->train(trainData, ml::ROW_SAMPLE, trainLabels);
+    knearestHnsw->findNearest(testData, 4, bestLabels);
+    if( !calcErr( bestLabels, testLabels, sizes, err, true ) )
+    {
+        ts->printf( cvtest::TS::LOG, "Bad output labels.\n" );
+        code = cvtest::TS::FAIL_INVALID_OUTPUT;
+    }
+    else if( err > 0.01f )
+    {
+        ts->printf( cvtest::TS::LOG, "Bad accuracy (%f) on test data.\n", err );
+        code = cvtest::TS::FAIL_BAD_ACCURACY;
+    }
+
     ts->set_failed_test_info( code );
 }
 
@@ -44,6 +44,7 @@
 #define __OPENCV_STITCHING_STITCHER_HPP__
 
 #include "opencv2/core.hpp"
+#include "opencv2/core/utility.hpp"
 #include "opencv2/features2d.hpp"
 #include "opencv2/stitching/warpers.hpp"
 #include "opencv2/stitching/detail/matchers.hpp"
@@ -209,6 +210,41 @@ public:
      */
     Status stitch(InputArrayOfArrays images, const std::vector<std::vector<Rect> > &rois, OutputArray pano);
 
+    /** @overload */
+    CV_WRAP Status prepareStreaming();
+    /** @brief Prepares composing of frame sets from a fixed camera rig.
+
+    Estimates the seams and the exposure compensation and precomputes, for each camera, the
+    fixed-point remap tables and the blending mask at the compositing resolution. After that
+    composeFrame composes new frame sets using only these data, without warping the masks or
+    estimating the seams again.
+
+    The prepared data are replaced at once, when they are ready. So the calibration may be refreshed
+    (with estimateTransform and prepareStreaming) in a background thread while another thread keeps
+    calling composeFrame. With an exposure compensator not supporting
+    detail::ExposureCompensator::getMatGains (all the built-in compensators support it), composeFrame
+    uses the compensator itself, so it waits while prepareStreaming feeds the compensator.
+    composeFrame calls must not run concurrently with each other, they share the blender.
+
+    @note Call estimateTransform first.
+
+    @param images Frame set to estimate the seams and the exposure compensation on, in the same
+    order as passed to estimateTransform. If it's empty, the images passed to estimateTransform are
+    used.
+    @return Status code.
+     */
+    Status prepareStreaming(InputArrayOfArrays images);
+
+    /** @brief Composes a frame set into the pano using the data precomputed by prepareStreaming.
+
+    If prepareStreaming hasn't been called yet, it's called for the given images first.
+
+    @param images Frame set, in the same order and of the same sizes as passed to estimateTransform.
+    @param pano Final pano.
+    @return Status code.
+     */
+    CV_WRAP Status composeFrame(InputArrayOfArrays images, OutputArray pano);
+
     std::vector<int> component() const { return indices_; }
     std::vector<detail::CameraParams> cameras() const { return cameras_; }
     CV_WRAP double workScale() const { return work_scale_; }
@@ -219,6 +255,8 @@ private:
     Status matchImages();
     Status estimateCameraParams();
 
+    struct StreamingData;
+
     double registr_resol_;
     double seam_est_resol_;
     double compose_resol_;
@@ -246,6 +284,10 @@ private:
     double seam_scale_;
     double seam_work_aspect_;
     double warped_image_scale_;
+
+    Ptr<StreamingData> streaming_data_;
+    Mutex streaming_mutex_;
+    Mutex exposure_mutex_; // exposure_comp_ while it's fed by prepareStreaming or applied by composeFrame
 };
 
 CV_EXPORTS_W Ptr<Stitcher> createStitcher(bool try_use_gpu = false);
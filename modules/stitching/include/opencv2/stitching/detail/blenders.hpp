@@ -127,17 +127,31 @@ public:
     int numBands() const { return actual_num_bands_; }
     void setNumBands(int val) { actual_num_bands_ = val; }
 
+    /** @brief Size of the pano tiles blended at once, 0 to blend the whole pano at once (default).
+
+    In the tiled mode feed only keeps a copy of the sources (in 8 bits, if they fit) and blend builds
+    the pyramids tile by tile, in parallel. So the memory needed besides the pano and the sources is
+    bounded by the tile size and the number of threads instead of growing with the pano size.
+     */
+    int tileSize() const { return tile_size_; }
+    void setTileSize(int val) { tile_size_ = val; }
+
     void prepare(Rect dst_roi);
     void feed(InputArray img, InputArray mask, Point tl);
     void blend(InputOutputArray dst, InputOutputArray dst_mask);
 
 private:
+    void blendTiles();
+
     int actual_num_bands_, num_bands_;
     std::vector<UMat> dst_pyr_laplace_;
     std::vector<UMat> dst_band_weights_;
     Rect dst_roi_final_;
     bool can_use_gpu_;
     int weight_type_; //CV_32F or CV_16S
+    int tile_size_;
+    std::vector<UMat> src_imgs_, src_masks_;
+    std::vector<Point> src_corners_;
 };
 
 
@@ -80,6 +80,15 @@ public:
     @param mask Image mask
      */
     virtual void apply(int index, Point corner, InputOutputArray image, InputArray mask) = 0;
+
+    /** @brief Returns the estimated gains, so they can be applied without the compensator.
+
+    @param gains One CV_32F map per image: either 1x1 (a single gain for the whole image) or a coarse
+    gain map that is stretched over the image with bilinear interpolation. Empty, if no compensation
+    is needed.
+    @return false if the compensator doesn't support it.
+     */
+    virtual bool getMatGains(std::vector<Mat> &gains) const { gains.clear(); return false; }
 };
 
 /** @brief Stub exposure compensator which does nothing.
@@ -90,6 +99,7 @@ public:
     void feed(const std::vector<Point> &/*corners*/, const std::vector<UMat> &/*images*/,
               const std::vector<std::pair<UMat,uchar> > &/*masks*/) { }
     void apply(int /*index*/, Point /*corner*/, InputOutputArray /*image*/, InputArray /*mask*/) { }
+    bool getMatGains(std::vector<Mat> &gains) const { gains.clear(); return true; }
 };
 
 /** @brief Exposure compensator which tries to remove exposure related artifacts by adjusting image
@@ -101,6 +111,7 @@ public:
     void feed(const std::vector<Point> &corners, const std::vector<UMat> &images,
               const std::vector<std::pair<UMat,uchar> > &masks);
     void apply(int index, Point corner, InputOutputArray image, InputArray mask);
+    bool getMatGains(std::vector<Mat> &gains) const;
     std::vector<double> gains() const;
 
 private:
@@ -118,6 +129,7 @@ public:
     void feed(const std::vector<Point> &corners, const std::vector<UMat> &images,
               const std::vector<std::pair<UMat,uchar> > &masks);
     void apply(int index, Point corner, InputOutputArray image, InputArray mask);
+    bool getMatGains(std::vector<Mat> &gains) const;
 
 private:
     int bl_width_, bl_height_;
@@ -81,6 +81,27 @@ public:
      */
     virtual Rect buildMaps(Size src_size, InputArray K, InputArray R, OutputArray xmap, OutputArray ymap) = 0;
 
+    /** @brief Builds the projection maps in the compact fixed-point format.
+
+    The maps are the same as the ones built by buildMaps and converted by convertMaps to CV_16SC2,
+    but they take half the memory and remap doesn't need to convert them again. Build them once per
+    camera and pass them to remap for every frame.
+
+    @param src_size Source image size
+    @param K Camera intrinsic parameters
+    @param R Camera rotation matrix
+    @param map1 Integer part of the source coordinates, CV_16SC2
+    @param map2 Interpolation table indices, CV_16UC1
+    @return Projected image minimum bounding box
+     */
+    virtual Rect buildFixedPointMaps(Size src_size, InputArray K, InputArray R, OutputArray map1, OutputArray map2)
+    {
+        Mat xmap, ymap;
+        Rect dst_roi = buildMaps(src_size, K, R, xmap, ymap);
+        convertMaps(xmap, ymap, map1, map2, CV_16SC2);
+        return dst_roi;
+    }
+
     /** @brief Projects the image.
 
     @param src Source image
@@ -145,6 +166,8 @@ public:
 
     Rect buildMaps(Size src_size, InputArray K, InputArray R, OutputArray xmap, OutputArray ymap);
 
+    Rect buildFixedPointMaps(Size src_size, InputArray K, InputArray R, OutputArray map1, OutputArray map2);
+
     Point warp(InputArray src, InputArray K, InputArray R, int interp_mode, int border_mode,
                OutputArray dst);
 
@@ -165,6 +188,11 @@ protected:
     // Correctness for any projection isn't guaranteed.
     void detectResultRoiByBorder(Size src_size, Point &dst_tl, Point &dst_br);
 
+    // Fills the float maps with the backward projection of the destination pixels starting at
+    // (u0, v0). Projector parameters must be set. Derived warpers may override it with a vectorized
+    // version.
+    virtual void mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap);
+
     P projector_;
 };
 
@@ -202,6 +230,7 @@ public:
 
 protected:
     void detectResultRoi(Size src_size, Point &dst_tl, Point &dst_br);
+    void mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap);
 };
 
 
@@ -230,6 +259,7 @@ public:
     Point warp(InputArray src, InputArray K, InputArray R, int interp_mode, int border_mode, OutputArray dst);
 protected:
     void detectResultRoi(Size src_size, Point &dst_tl, Point &dst_br);
+    void mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap);
 };
 
 
@@ -258,6 +288,7 @@ protected:
     {
         RotationWarperBase<CylindricalProjector>::detectResultRoiByBorder(src_size, dst_tl, dst_br);
     }
+    void mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap);
 };
 
 
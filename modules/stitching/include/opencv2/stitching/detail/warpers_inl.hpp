@@ -74,19 +74,57 @@ Rect RotationWarperBase<P>::buildMaps(Size src_size, InputArray K, InputArray R,
     _ymap.create(dst_br.y - dst_tl.y + 1, dst_br.x - dst_tl.x + 1, CV_32F);
 
     Mat xmap = _xmap.getMat(), ymap = _ymap.getMat();
+    mapBackwardRows(dst_tl.x, dst_tl.y, xmap, ymap);
 
+    return Rect(dst_tl, dst_br);
+}
+
+
+template <class P>
+Rect RotationWarperBase<P>::buildFixedPointMaps(Size src_size, InputArray K, InputArray R,
+                                                OutputArray _map1, OutputArray _map2)
+{
+    projector_.setCameraParams(K, R);
+
+    Point dst_tl, dst_br;
+    detectResultRoi(src_size, dst_tl, dst_br);
+
+    _map1.create(dst_br.y - dst_tl.y + 1, dst_br.x - dst_tl.x + 1, CV_16SC2);
+    _map2.create(dst_br.y - dst_tl.y + 1, dst_br.x - dst_tl.x + 1, CV_16UC1);
+
+    Mat map1 = _map1.getMat(), map2 = _map2.getMat();
+
+    // Float maps are built for a few rows at once only, so they stay in cache
+    const int block_rows = 16;
+    Mat xmap(block_rows, map1.cols, CV_32F), ymap(block_rows, map1.cols, CV_32F);
+    for (int y = 0; y < map1.rows; y += block_rows)
+    {
+        Range rows(y, std::min(y + block_rows, map1.rows));
+        Mat xblock = xmap.rowRange(0, rows.size()), yblock = ymap.rowRange(0, rows.size());
+        mapBackwardRows(dst_tl.x, dst_tl.y + y, xblock, yblock);
+
+        Mat map1_block = map1.rowRange(rows), map2_block = map2.rowRange(rows);
+        convertMaps(xblock, yblock, map1_block, map2_block, CV_16SC2);
+    }
+
+    return Rect(dst_tl, dst_br);
+}
+
+
+template <class P>
+void RotationWarperBase<P>::mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap)
+{
     float x, y;
-    for (int v = dst_tl.y; v <= dst_br.y; ++v)
+    for (int i = 0; i < xmap.rows; ++i)
     {
-        for (int u = dst_tl.x; u <= dst_br.x; ++u)
+        float *xrow = xmap.ptr<float>(i), *yrow = ymap.ptr<float>(i);
+        for (int j = 0; j < xmap.cols; ++j)
         {
-            projector_.mapBackward(static_cast<float>(u), static_cast<float>(v), x, y);
-            xmap.at<float>(v - dst_tl.y, u - dst_tl.x) = x;
-            ymap.at<float>(v - dst_tl.y, u - dst_tl.x) = y;
+            projector_.mapBackward(static_cast<float>(u0 + j), static_cast<float>(v0 + i), x, y);
+            xrow[j] = x;
+            yrow[j] = y;
         }
     }
-
-    return Rect(dst_tl, dst_br);
 }
 
 
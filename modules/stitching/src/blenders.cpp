@@ -211,6 +211,7 @@ MultiBandBlender::MultiBandBlender(int try_gpu, int num_bands, int weight_type)
 
     CV_Assert(weight_type == CV_32F || weight_type == CV_16S);
     weight_type_ = weight_type;
+    tile_size_ = 0;
 }
 
 
@@ -228,6 +229,12 @@ void MultiBandBlender::prepare(Rect dst_roi)
 
     Blender::prepare(dst_roi);
 
+    src_imgs_.clear();
+    src_masks_.clear();
+    src_corners_.clear();
+    if (tile_size_ > 0)
+        return;
+
     dst_pyr_laplace_.resize(num_bands_ + 1);
     dst_pyr_laplace_[0] = dst_;
 
@@ -272,38 +279,39 @@ static bool ocl_MultiBandBlender_feed(InputArray _src, InputArray _weight,
 }
 #endif
 
-void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
+// Adds the weighted Laplacian pyramid of the image to the destination pyramid of dst_roi
+static void feedPyramids(InputArray _img, InputArray mask, Point tl, Rect dst_roi, int num_bands,
+                         int weight_type, bool can_use_gpu, std::vector<UMat> &dst_pyr_laplace,
+                         std::vector<UMat> &dst_band_weights)
 {
 #if ENABLE_LOG
     int64 t = getTickCount();
 #endif
 
     UMat img = _img.getUMat();
-    CV_Assert(img.type() == CV_16SC3 || img.type() == CV_8UC3);
-    CV_Assert(mask.type() == CV_8U);
 
     // Keep source image in memory with small border
-    int gap = 3 * (1 << num_bands_);
-    Point tl_new(std::max(dst_roi_.x, tl.x - gap),
-                 std::max(dst_roi_.y, tl.y - gap));
-    Point br_new(std::min(dst_roi_.br().x, tl.x + img.cols + gap),
-                 std::min(dst_roi_.br().y, tl.y + img.rows + gap));
+    int gap = 3 * (1 << num_bands);
+    Point tl_new(std::max(dst_roi.x, tl.x - gap),
+                 std::max(dst_roi.y, tl.y - gap));
+    Point br_new(std::min(dst_roi.br().x, tl.x + img.cols + gap),
+                 std::min(dst_roi.br().y, tl.y + img.rows + gap));
 
-    // Ensure coordinates of top-left, bottom-right corners are divided by (1 << num_bands_).
+    // Ensure coordinates of top-left, bottom-right corners are divided by (1 << num_bands).
     // After that scale between layers is exactly 2.
     //
     // We do it to avoid interpolation problems when keeping sub-images only. There is no such problem when
     // image is bordered to have size equal to the final image size, but this is too memory hungry approach.
-    tl_new.x = dst_roi_.x + (((tl_new.x - dst_roi_.x) >> num_bands_) << num_bands_);
-    tl_new.y = dst_roi_.y + (((tl_new.y - dst_roi_.y) >> num_bands_) << num_bands_);
+    tl_new.x = dst_roi.x + (((tl_new.x - dst_roi.x) >> num_bands) << num_bands);
+    tl_new.y = dst_roi.y + (((tl_new.y - dst_roi.y) >> num_bands) << num_bands);
     int width = br_new.x - tl_new.x;
     int height = br_new.y - tl_new.y;
-    width += ((1 << num_bands_) - width % (1 << num_bands_)) % (1 << num_bands_);
-    height += ((1 << num_bands_) - height % (1 << num_bands_)) % (1 << num_bands_);
+    width += ((1 << num_bands) - width % (1 << num_bands)) % (1 << num_bands);
+    height += ((1 << num_bands) - height % (1 << num_bands)) % (1 << num_bands);
     br_new.x = tl_new.x + width;
     br_new.y = tl_new.y + height;
-    int dy = std::max(br_new.y - dst_roi_.br().y, 0);
-    int dx = std::max(br_new.x - dst_roi_.br().x, 0);
+    int dy = std::max(br_new.y - dst_roi.br().y, 0);
+    int dx = std::max(br_new.x - dst_roi.br().x, 0);
     tl_new.x -= dx; br_new.x -= dx;
     tl_new.y -= dy; br_new.y -= dy;
 
@@ -322,10 +330,10 @@ void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
 #endif
 
     std::vector<UMat> src_pyr_laplace;
-    if (can_use_gpu_ && img_with_border.depth() == CV_16S)
-        createLaplacePyrGpu(img_with_border, num_bands_, src_pyr_laplace);
+    if (can_use_gpu && img_with_border.depth() == CV_16S)
+        createLaplacePyrGpu(img_with_border, num_bands, src_pyr_laplace);
     else
-        createLaplacePyr(img_with_border, num_bands_, src_pyr_laplace);
+        createLaplacePyr(img_with_border, num_bands, src_pyr_laplace);
 
     LOGLN("  Create the source image Laplacian pyramid, time: " << ((getTickCount() - t) / getTickFrequency()) << " sec");
 #if ENABLE_LOG
@@ -334,13 +342,13 @@ void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
 
     // Create the weight map Gaussian pyramid
     UMat weight_map;
-    std::vector<UMat> weight_pyr_gauss(num_bands_ + 1);
+    std::vector<UMat> weight_pyr_gauss(num_bands + 1);
 
-    if(weight_type_ == CV_32F)
+    if(weight_type == CV_32F)
     {
         mask.getUMat().convertTo(weight_map, CV_32F, 1./255.);
     }
-    else // weight_type_ == CV_16S
+    else // weight_type == CV_16S
     {
         mask.getUMat().convertTo(weight_map, CV_16S);
         UMat add_mask;
@@ -350,7 +358,7 @@ void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
 
     copyMakeBorder(weight_map, weight_pyr_gauss[0], top, bottom, left, right, BORDER_CONSTANT);
 
-    for (int i = 0; i < num_bands_; ++i)
+    for (int i = 0; i < num_bands; ++i)
         pyrDown(weight_pyr_gauss[i], weight_pyr_gauss[i + 1]);
 
     LOGLN("  Create the weight map Gaussian pyramid, time: " << ((getTickCount() - t) / getTickFrequency()) << " sec");
@@ -358,26 +366,26 @@ void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
     t = getTickCount();
 #endif
 
-    int y_tl = tl_new.y - dst_roi_.y;
-    int y_br = br_new.y - dst_roi_.y;
-    int x_tl = tl_new.x - dst_roi_.x;
-    int x_br = br_new.x - dst_roi_.x;
+    int y_tl = tl_new.y - dst_roi.y;
+    int y_br = br_new.y - dst_roi.y;
+    int x_tl = tl_new.x - dst_roi.x;
+    int x_br = br_new.x - dst_roi.x;
 
     // Add weighted layer of the source image to the final Laplacian pyramid layer
-    for (int i = 0; i <= num_bands_; ++i)
+    for (int i = 0; i <= num_bands; ++i)
     {
         Rect rc(x_tl, y_tl, x_br - x_tl, y_br - y_tl);
 #ifdef HAVE_OPENCL
         if ( !cv::ocl::useOpenCL() ||
              !ocl_MultiBandBlender_feed(src_pyr_laplace[i], weight_pyr_gauss[i],
-                    dst_pyr_laplace_[i](rc), dst_band_weights_[i](rc)) )
+                    dst_pyr_laplace[i](rc), dst_band_weights[i](rc)) )
 #endif
         {
             Mat _src_pyr_laplace = src_pyr_laplace[i].getMat(ACCESS_READ);
-            Mat _dst_pyr_laplace = dst_pyr_laplace_[i](rc).getMat(ACCESS_RW);
+            Mat _dst_pyr_laplace = dst_pyr_laplace[i](rc).getMat(ACCESS_RW);
             Mat _weight_pyr_gauss = weight_pyr_gauss[i].getMat(ACCESS_READ);
-            Mat _dst_band_weights = dst_band_weights_[i](rc).getMat(ACCESS_RW);
-            if(weight_type_ == CV_32F)
+            Mat _dst_band_weights = dst_band_weights[i](rc).getMat(ACCESS_RW);
+            if(weight_type == CV_32F)
             {
                 for (int y = 0; y < rc.height; ++y)
                 {
@@ -395,7 +403,7 @@ void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
                     }
                 }
             }
-            else // weight_type_ == CV_16S
+            else // weight_type == CV_16S
             {
                 for (int y = 0; y < y_br - y_tl; ++y)
                 {
@@ -429,8 +437,150 @@ void MultiBandBlender::feed(InputArray _img, InputArray mask, Point tl)
 }
 
 
+void MultiBandBlender::feed(InputArray img, InputArray mask, Point tl)
+{
+    CV_Assert(img.type() == CV_16SC3 || img.type() == CV_8UC3);
+    CV_Assert(mask.type() == CV_8U);
+
+    if (tile_size_ > 0)
+    {
+        // Only keep the source, the pyramids are built tile by tile in blend(). Exposure compensated
+        // images usually fit 8 bits, so keep them in 8 bits then.
+        UMat src = img.getUMat(), src_copy;
+        double min_val = 0, max_val = 0;
+        if (src.depth() == CV_16S)
+            minMaxLoc(src.reshape(1), &min_val, &max_val);
+        if (src.depth() == CV_16S && min_val >= 0 && max_val <= 255)
+            src.convertTo(src_copy, CV_8U);
+        else
+            src.copyTo(src_copy);
+
+        src_imgs_.push_back(src_copy);
+        src_masks_.push_back(mask.getUMat().clone());
+        src_corners_.push_back(tl);
+        return;
+    }
+
+    feedPyramids(img, mask, tl, dst_roi_, num_bands_, weight_type_, can_use_gpu_,
+                 dst_pyr_laplace_, dst_band_weights_);
+}
+
+
+class MultiBandBlendTilesInvoker : public ParallelLoopBody
+{
+public:
+    MultiBandBlendTilesInvoker(const std::vector<Rect> &tiles, int margin, Rect dst_roi, int num_bands,
+                               int weight_type, const std::vector<UMat> &src_imgs,
+                               const std::vector<UMat> &src_masks, const std::vector<Point> &src_corners,
+                               Mat &dst, Mat &dst_mask)
+        : tiles_(tiles), margin_(margin), dst_roi_(dst_roi), num_bands_(num_bands), weight_type_(weight_type),
+          src_imgs_(src_imgs), src_masks_(src_masks), src_corners_(src_corners), dst_(dst), dst_mask_(dst_mask) {}
+
+    void operator ()(const Range &r) const
+    {
+        // Pyramid buffers are allocated for the largest tile once and reused for all tiles of the range
+        Size max_size(std::min(dst_roi_.width, tiles_[0].width + 2 * margin_),
+                      std::min(dst_roi_.height, tiles_[0].height + 2 * margin_));
+        std::vector<UMat> pyr_buf(num_bands_ + 1), weights_buf(num_bands_ + 1);
+        for (int i = 0; i <= num_bands_; ++i)
+        {
+            pyr_buf[i].create(max_size.height >> i, max_size.width >> i, CV_16SC3);
+            weights_buf[i].create(max_size.height >> i, max_size.width >> i, weight_type_);
+        }
+
+        std::vector<UMat> pyr(num_bands_ + 1), weights(num_bands_ + 1);
+        UMat src, tile_mask;
+        for (int t = r.start; t < r.end; ++t)
+        {
+            const Rect &tile = tiles_[t];
+            Rect region(tile.x - margin_, tile.y - margin_, tile.width + 2 * margin_, tile.height + 2 * margin_);
+            region &= Rect(Point(), dst_roi_.size());
+            region += dst_roi_.tl();
+
+            for (int i = 0; i <= num_bands_; ++i)
+            {
+                Rect level_rc(0, 0, region.width >> i, region.height >> i);
+                pyr[i] = pyr_buf[i](level_rc);
+                weights[i] = weights_buf[i](level_rc);
+                pyr[i].setTo(Scalar::all(0));
+                weights[i].setTo(0);
+            }
+
+            bool empty = true;
+            for (size_t k = 0; k < src_imgs_.size(); ++k)
+            {
+                Rect src_rc = Rect(src_corners_[k], src_imgs_[k].size()) & region;
+                if (src_rc.area() == 0)
+                    continue;
+                src_imgs_[k](src_rc - src_corners_[k]).convertTo(src, CV_16S);
+                feedPyramids(src, src_masks_[k](src_rc - src_corners_[k]), src_rc.tl(), region, num_bands_,
+                             weight_type_, false, pyr, weights);
+                empty = false;
+            }
+            if (empty)
+                continue;
+
+            for (int i = 0; i <= num_bands_; ++i)
+                normalizeUsingWeightMap(weights[i], pyr[i]);
+            restoreImageFromLaplacePyr(pyr);
+
+            Rect core(tile.tl() + dst_roi_.tl() - region.tl(), tile.size());
+            pyr[0](core).copyTo(dst_(tile));
+            compare(weights[0](core), WEIGHT_EPS, tile_mask, CMP_GT);
+            tile_mask.copyTo(dst_mask_(tile));
+        }
+    }
+
+private:
+    const std::vector<Rect> &tiles_;
+    int margin_;
+    Rect dst_roi_;
+    int num_bands_, weight_type_;
+    const std::vector<UMat> &src_imgs_, &src_masks_;
+    const std::vector<Point> &src_corners_;
+    Mat &dst_, &dst_mask_;
+};
+
+
+void MultiBandBlender::blendTiles()
+{
+    // Tiles and their margins are aligned to the coarsest level, so the tile pyramids are exactly
+    // the corresponding parts of the whole pano pyramid. The margin covers the support of the
+    // pyramid filters, so the tile borders don't show up in the result.
+    int cell = 1 << num_bands_;
+    int tile_size = std::max(cell, (tile_size_ + cell - 1) / cell * cell);
+    int margin = 4 * cell;
+
+    std::vector<Rect> tiles;
+    for (int y = 0; y < dst_roi_.height; y += tile_size)
+        for (int x = 0; x < dst_roi_.width; x += tile_size)
+            tiles.push_back(Rect(x, y, tile_size, tile_size) & Rect(Point(), dst_roi_.size()));
+
+    {
+        Mat dst = dst_.getMat(ACCESS_RW), dst_mask = dst_mask_.getMat(ACCESS_RW);
+        parallel_for_(Range(0, (int)tiles.size()),
+                      MultiBandBlendTilesInvoker(tiles, margin, dst_roi_, num_bands_, weight_type_,
+                                                 src_imgs_, src_masks_, src_corners_, dst, dst_mask),
+                      getNumThreads());
+    }
+
+    src_imgs_.clear();
+    src_masks_.clear();
+    src_corners_.clear();
+}
+
+
 void MultiBandBlender::blend(InputOutputArray dst, InputOutputArray dst_mask)
 {
+    if (tile_size_ > 0)
+    {
+        blendTiles();
+        dst_ = dst_(Rect(0, 0, dst_roi_final_.width, dst_roi_final_.height));
+        dst_mask_ = dst_mask_(Rect(0, 0, dst_roi_final_.width, dst_roi_final_.height));
+        Blender::blend(dst, dst_mask);
+        return;
+    }
+
     for (int i = 0; i <= num_bands_; ++i)
         normalizeUsingWeightMap(dst_band_weights_[i], dst_pyr_laplace_[i]);
 
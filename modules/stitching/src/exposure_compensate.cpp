@@ -151,6 +151,15 @@ void GainCompensator::apply(int index, Point /*corner*/, InputOutputArray image,
 }
 
 
+bool GainCompensator::getMatGains(std::vector<Mat> &gains) const
+{
+    gains.resize(gains_.rows);
+    for (int i = 0; i < gains_.rows; ++i)
+        gains[i] = Mat(1, 1, CV_32F, Scalar::all(gains_(i, 0)));
+    return true;
+}
+
+
 std::vector<double> GainCompensator::gains() const
 {
     std::vector<double> gains_vec(gains_.rows);
@@ -248,5 +257,14 @@ void BlocksGainCompensator::apply(int index, Point /*corner*/, InputOutputArray
     }
 }
 
+
+bool BlocksGainCompensator::getMatGains(std::vector<Mat> &gains) const
+{
+    gains.resize(gain_maps_.size());
+    for (size_t i = 0; i < gain_maps_.size(); ++i)
+        gain_maps_[i].copyTo(gains[i]);
+    return true;
+}
+
 } // namespace detail
 } // namespace cv
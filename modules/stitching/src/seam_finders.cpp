@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/hal/intrin.hpp"
 #include <map>
 
 namespace cv {
@@ -1069,11 +1070,15 @@ public:
     void findInPair(size_t first, size_t second, Rect roi);
 
 private:
-    void setGraphWeightsColor(const Mat &img1, const Mat &img2,
-                              const Mat &mask1, const Mat &mask2, GCGraph<float> &graph);
-    void setGraphWeightsColorGrad(const Mat &img1, const Mat &img2, const Mat &dx1, const Mat &dx2,
-                                  const Mat &dy1, const Mat &dy2, const Mat &mask1, const Mat &mask2,
-                                  GCGraph<float> &graph);
+    // Computes the weights of the edges between (x, y) and (x + 1, y), and between (x, y) and (x, y + 1)
+    void computeEdgeWeights(const Mat &img1, const Mat &img2, const Mat &dx1, const Mat &dx2,
+                            const Mat &dy1, const Mat &dy2, const Mat &mask1, const Mat &mask2,
+                            Mat &weights_x, Mat &weights_y) const;
+
+    // Finds the minimum cut, labels are 255 for the pixels taken from the first image and 0 otherwise.
+    // If the band isn't empty, only the labels within the band are found, the others are kept.
+    void solve(const Mat &mask1, const Mat &mask2, const Mat &weights_x, const Mat &weights_y,
+               const Mat &band, Mat &labels) const;
 
     std::vector<Mat> dx_, dy_;
     int cost_type_;
@@ -1113,105 +1118,169 @@ void GraphCutSeamFinder::Impl::find(const std::vector<UMat> &src, const std::vec
 }
 
 
-void GraphCutSeamFinder::Impl::setGraphWeightsColor(const Mat &img1, const Mat &img2,
-                                                    const Mat &mask1, const Mat &mask2, GCGraph<float> &graph)
+void GraphCutSeamFinder::Impl::computeEdgeWeights(const Mat &img1, const Mat &img2, const Mat &dx1,
+                                                  const Mat &dx2, const Mat &dy1, const Mat &dy2,
+                                                  const Mat &mask1, const Mat &mask2,
+                                                  Mat &weights_x, Mat &weights_y) const
 {
+    if (cost_type_ != GraphCutSeamFinder::COST_COLOR && cost_type_ != GraphCutSeamFinder::COST_COLOR_GRAD)
+        CV_Error(Error::StsBadArg, "unsupported pixel similarity measure");
+    const bool use_grad = cost_type_ == GraphCutSeamFinder::COST_COLOR_GRAD;
     const Size img_size = img1.size();
+    const float weight_eps = 1.f;
 
-    // Set terminal weights
+    // Squared color difference of the images, it's needed twice for every pixel
+    Mat diff(img_size.height, img_size.width, CV_32F);
     for (int y = 0; y < img_size.height; ++y)
     {
-        for (int x = 0; x < img_size.width; ++x)
+        const float *row1 = img1.ptr<float>(y), *row2 = img2.ptr<float>(y);
+        float *diff_row = diff.ptr<float>(y);
+        int x = 0;
+#if CV_SIMD128
+        for (; x <= img_size.width - 4; x += 4)
         {
-            int v = graph.addVtx();
-            graph.addTermWeights(v, mask1.at<uchar>(y, x) ? terminal_cost_ : 0.f,
-                                    mask2.at<uchar>(y, x) ? terminal_cost_ : 0.f);
+            v_float32x4 r1, g1, b1, r2, g2, b2;
+            v_load_deinterleave(row1 + x * 3, r1, g1, b1);
+            v_load_deinterleave(row2 + x * 3, r2, g2, b2);
+            v_float32x4 dr = r1 - r2, dg = g1 - g2, db = b1 - b2;
+            v_store(diff_row + x, dr * dr + dg * dg + db * db);
         }
+#endif
+        for (; x < img_size.width; ++x)
+            diff_row[x] = normL2(Point3f(row1[x * 3], row1[x * 3 + 1], row1[x * 3 + 2]),
+                                 Point3f(row2[x * 3], row2[x * 3 + 1], row2[x * 3 + 2]));
     }
 
-    // Set regular edge weights
-    const float weight_eps = 1.f;
+    weights_x.create(img_size, CV_32F);
+    weights_y.create(img_size, CV_32F);
     for (int y = 0; y < img_size.height; ++y)
     {
-        for (int x = 0; x < img_size.width; ++x)
+        const float *diff_row = diff.ptr<float>(y);
+        const uchar *m1 = mask1.ptr<uchar>(y), *m2 = mask2.ptr<uchar>(y);
+        const float *dx1_row = dx1.ptr<float>(y), *dx2_row = dx2.ptr<float>(y);
+        float *wx_row = weights_x.ptr<float>(y);
+        for (int x = 0; x < img_size.width - 1; ++x)
         {
-            int v = y * img_size.width + x;
-            if (x < img_size.width - 1)
+            float weight = diff_row[x] + diff_row[x + 1];
+            if (use_grad)
             {
-                float weight = normL2(img1.at<Point3f>(y, x), img2.at<Point3f>(y, x)) +
-                               normL2(img1.at<Point3f>(y, x + 1), img2.at<Point3f>(y, x + 1)) +
-                               weight_eps;
-                if (!mask1.at<uchar>(y, x) || !mask1.at<uchar>(y, x + 1) ||
-                    !mask2.at<uchar>(y, x) || !mask2.at<uchar>(y, x + 1))
-                    weight += bad_region_penalty_;
-                graph.addEdges(v, v + 1, weight, weight);
+                float grad = dx1_row[x] + dx1_row[x + 1] + dx2_row[x] + dx2_row[x + 1] + weight_eps;
+                weight = weight / grad + weight_eps;
             }
-            if (y < img_size.height - 1)
+            else
+                weight += weight_eps;
+            if (!m1[x] || !m1[x + 1] || !m2[x] || !m2[x + 1])
+                weight += bad_region_penalty_;
+            wx_row[x] = weight;
+        }
+        wx_row[img_size.width - 1] = 0.f;
+
+        float *wy_row = weights_y.ptr<float>(y);
+        if (y == img_size.height - 1)
+        {
+            std::fill(wy_row, wy_row + img_size.width, 0.f);
+            continue;
+        }
+        const float *diff_next = diff.ptr<float>(y + 1);
+        const uchar *m1_next = mask1.ptr<uchar>(y + 1), *m2_next = mask2.ptr<uchar>(y + 1);
+        const float *dy1_row = dy1.ptr<float>(y), *dy2_row = dy2.ptr<float>(y);
+        const float *dy1_next = dy1.ptr<float>(y + 1), *dy2_next = dy2.ptr<float>(y + 1);
+        for (int x = 0; x < img_size.width; ++x)
+        {
+            float weight = diff_row[x] + diff_next[x];
+            if (use_grad)
             {
-                float weight = normL2(img1.at<Point3f>(y, x), img2.at<Point3f>(y, x)) +
-                               normL2(img1.at<Point3f>(y + 1, x), img2.at<Point3f>(y + 1, x)) +
-                               weight_eps;
-                if (!mask1.at<uchar>(y, x) || !mask1.at<uchar>(y + 1, x) ||
-                    !mask2.at<uchar>(y, x) || !mask2.at<uchar>(y + 1, x))
-                    weight += bad_region_penalty_;
-                graph.addEdges(v, v + img_size.width, weight, weight);
+                float grad = dy1_row[x] + dy1_next[x] + dy2_row[x] + dy2_next[x] + weight_eps;
+                weight = weight / grad + weight_eps;
             }
+            else
+                weight += weight_eps;
+            if (!m1[x] || !m1_next[x] || !m2[x] || !m2_next[x])
+                weight += bad_region_penalty_;
+            wy_row[x] = weight;
         }
     }
 }
 
 
-void GraphCutSeamFinder::Impl::setGraphWeightsColorGrad(
-        const Mat &img1, const Mat &img2, const Mat &dx1, const Mat &dx2,
-        const Mat &dy1, const Mat &dy2, const Mat &mask1, const Mat &mask2,
-        GCGraph<float> &graph)
+void GraphCutSeamFinder::Impl::solve(const Mat &mask1, const Mat &mask2, const Mat &weights_x,
+                                     const Mat &weights_y, const Mat &band, Mat &labels) const
 {
-    const Size img_size = img1.size();
+    const Size size = mask1.size();
+
+    // Vertices are the band pixels in row-major order
+    Mat_<int> vtx_idx(size, -1);
+    int vertex_count = 0;
+    for (int y = 0; y < size.height; ++y)
+        for (int x = 0; x < size.width; ++x)
+            if (band.empty() || band.at<uchar>(y, x))
+                vtx_idx(y, x) = vertex_count++;
+    if (vertex_count == 0)
+        return;
 
-    // Set terminal weights
-    for (int y = 0; y < img_size.height; ++y)
+    // Edges to the pixels outside of the band go to the terminal of their label
+    Mat_<Vec2f> term_weights(size, Vec2f(0.f, 0.f));
+    for (int y = 0; y < size.height; ++y)
     {
-        for (int x = 0; x < img_size.width; ++x)
+        for (int x = 0; x < size.width; ++x)
         {
-            int v = graph.addVtx();
-            graph.addTermWeights(v, mask1.at<uchar>(y, x) ? terminal_cost_ : 0.f,
-                                    mask2.at<uchar>(y, x) ? terminal_cost_ : 0.f);
+            if (vtx_idx(y, x) < 0)
+                continue;
+            Vec2f &w = term_weights(y, x);
+            w[0] = mask1.at<uchar>(y, x) ? terminal_cost_ : 0.f;
+            w[1] = mask2.at<uchar>(y, x) ? terminal_cost_ : 0.f;
+            if (band.empty())
+                continue;
+
+            const int dx[] = { -1, 1, 0, 0 }, dy[] = { 0, 0, -1, 1 };
+            for (int k = 0; k < 4; ++k)
+            {
+                int x2 = x + dx[k], y2 = y + dy[k];
+                if (x2 < 0 || y2 < 0 || x2 >= size.width || y2 >= size.height || vtx_idx(y2, x2) >= 0)
+                    continue;
+                float weight = dx[k] ? weights_x.at<float>(y, std::min(x, x2))
+                                     : weights_y.at<float>(std::min(y, y2), x);
+                w[labels.at<uchar>(y2, x2) ? 0 : 1] += weight;
+            }
         }
     }
 
-    // Set regular edge weights
-    const float weight_eps = 1.f;
-    for (int y = 0; y < img_size.height; ++y)
+    GCGraph<float> graph(vertex_count, 4 * vertex_count);
+    for (int y = 0; y < size.height; ++y)
+        for (int x = 0; x < size.width; ++x)
+            if (vtx_idx(y, x) >= 0)
+            {
+                graph.addVtx();
+                graph.addTermWeights(vtx_idx(y, x), term_weights(y, x)[0], term_weights(y, x)[1]);
+            }
+
+    for (int y = 0; y < size.height; ++y)
     {
-        for (int x = 0; x < img_size.width; ++x)
+        for (int x = 0; x < size.width; ++x)
         {
-            int v = y * img_size.width + x;
-            if (x < img_size.width - 1)
+            int v = vtx_idx(y, x);
+            if (v < 0)
+                continue;
+            if (x < size.width - 1 && vtx_idx(y, x + 1) >= 0)
             {
-                float grad = dx1.at<float>(y, x) + dx1.at<float>(y, x + 1) +
-                             dx2.at<float>(y, x) + dx2.at<float>(y, x + 1) + weight_eps;
-                float weight = (normL2(img1.at<Point3f>(y, x), img2.at<Point3f>(y, x)) +
-                                normL2(img1.at<Point3f>(y, x + 1), img2.at<Point3f>(y, x + 1))) / grad +
-                               weight_eps;
-                if (!mask1.at<uchar>(y, x) || !mask1.at<uchar>(y, x + 1) ||
-                    !mask2.at<uchar>(y, x) || !mask2.at<uchar>(y, x + 1))
-                    weight += bad_region_penalty_;
-                graph.addEdges(v, v + 1, weight, weight);
+                float weight = weights_x.at<float>(y, x);
+                graph.addEdges(v, vtx_idx(y, x + 1), weight, weight);
             }
-            if (y < img_size.height - 1)
+            if (y < size.height - 1 && vtx_idx(y + 1, x) >= 0)
             {
-                float grad = dy1.at<float>(y, x) + dy1.at<float>(y + 1, x) +
-                             dy2.at<float>(y, x) + dy2.at<float>(y + 1, x) + weight_eps;
-                float weight = (normL2(img1.at<Point3f>(y, x), img2.at<Point3f>(y, x)) +
-                                normL2(img1.at<Point3f>(y + 1, x), img2.at<Point3f>(y + 1, x))) / grad +
-                               weight_eps;
-                if (!mask1.at<uchar>(y, x) || !mask1.at<uchar>(y + 1, x) ||
-                    !mask2.at<uchar>(y, x) || !mask2.at<uchar>(y + 1, x))
-                    weight += bad_region_penalty_;
-                graph.addEdges(v, v + img_size.width, weight, weight);
+                float weight = weights_y.at<float>(y, x);
+                graph.addEdges(v, vtx_idx(y + 1, x), weight, weight);
             }
         }
     }
+
+    graph.maxFlow();
+
+    labels.create(size, CV_8U);
+    for (int y = 0; y < size.height; ++y)
+        for (int x = 0; x < size.width; ++x)
+            if (vtx_idx(y, x) >= 0)
+                labels.at<uchar>(y, x) = graph.inSourceTree(vtx_idx(y, x)) ? 255 : 0;
 }
 
 
@@ -1274,31 +1343,49 @@ void GraphCutSeamFinder::Impl::findInPair(size_t first, size_t second, Rect roi)
         }
     }
 
-    const int vertex_count = (roi.height + 2 * gap) * (roi.width + 2 * gap);
-    const int edge_count = (roi.height - 1 + 2 * gap) * (roi.width + 2 * gap) +
-                           (roi.width - 1 + 2 * gap) * (roi.height + 2 * gap);
-    GCGraph<float> graph(vertex_count, edge_count);
+    // Large overlaps are solved on a downscaled copy first, then the seam is refined at the full
+    // resolution within a narrow band around the coarse seam only
+    const int max_full_res_area = 256 * 256;
+    const Size size = subimg1.size();
+    int scale = 1;
+    while ((double)(size.width / scale) * (size.height / scale) > max_full_res_area)
+        scale *= 2;
 
-    switch (cost_type_)
+    Mat weights_x, weights_y, labels, band;
+    if (scale > 1)
     {
-    case GraphCutSeamFinder::COST_COLOR:
-        setGraphWeightsColor(subimg1, subimg2, submask1, submask2, graph);
-        break;
-    case GraphCutSeamFinder::COST_COLOR_GRAD:
-        setGraphWeightsColorGrad(subimg1, subimg2, subdx1, subdx2, subdy1, subdy2,
-                                 submask1, submask2, graph);
-        break;
-    default:
-        CV_Error(Error::StsBadArg, "unsupported pixel similarity measure");
+        Size coarse_size((size.width + scale - 1) / scale, (size.height + scale - 1) / scale);
+        Mat cimg1, cimg2, cdx1, cdx2, cdy1, cdy2, cmask1, cmask2, coarse_labels;
+        resize(subimg1, cimg1, coarse_size, 0, 0, INTER_AREA);
+        resize(subimg2, cimg2, coarse_size, 0, 0, INTER_AREA);
+        resize(subdx1, cdx1, coarse_size, 0, 0, INTER_AREA);
+        resize(subdx2, cdx2, coarse_size, 0, 0, INTER_AREA);
+        resize(subdy1, cdy1, coarse_size, 0, 0, INTER_AREA);
+        resize(subdy2, cdy2, coarse_size, 0, 0, INTER_AREA);
+        resize(submask1, cmask1, coarse_size, 0, 0, INTER_NEAREST);
+        resize(submask2, cmask2, coarse_size, 0, 0, INTER_NEAREST);
+
+        computeEdgeWeights(cimg1, cimg2, cdx1, cdx2, cdy1, cdy2, cmask1, cmask2, weights_x, weights_y);
+        solve(cmask1, cmask2, weights_x, weights_y, Mat(), coarse_labels);
+        resize(coarse_labels, labels, size, 0, 0, INTER_NEAREST);
+
+        // The band is the coarse seam dilated by a couple of coarse pixels
+        Mat eroded, dilated;
+        erode(labels, eroded, Mat());
+        dilate(labels, dilated, Mat());
+        compare(dilated, eroded, band, CMP_NE);
+        dilate(band, band, getStructuringElement(MORPH_RECT, Size(4 * scale + 1, 4 * scale + 1)));
     }
 
-    graph.maxFlow();
+    computeEdgeWeights(subimg1, subimg2, subdx1, subdx2, subdy1, subdy2, submask1, submask2,
+                       weights_x, weights_y);
+    solve(submask1, submask2, weights_x, weights_y, band, labels);
 
     for (int y = 0; y < roi.height; ++y)
     {
         for (int x = 0; x < roi.width; ++x)
         {
-            if (graph.inSourceSegment((y + gap) * (roi.width + 2 * gap) + x + gap))
+            if (labels.at<uchar>(y + gap, x + gap))
             {
                 if (mask1.at<uchar>(roi.y - tl1.y + y, roi.x - tl1.x + x))
                     mask2.at<uchar>(roi.y - tl2.y + y, roi.x - tl2.x + x) = 0;
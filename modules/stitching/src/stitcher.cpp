@@ -44,6 +44,93 @@
 
 namespace cv {
 
+namespace {
+
+// dst = saturate_cast<uchar>(src*gain) converted to CV_16S, the same as
+// ExposureCompensator::apply() followed by convertTo(CV_16S) does
+void applyGains(const Mat &src, const Mat &gain, Mat &dst)
+{
+    CV_Assert(src.depth() == CV_8U && gain.type() == CV_32F);
+    dst.create(src.size(), CV_MAKETYPE(CV_16S, src.channels()));
+
+    const int cn = src.channels();
+    const bool single_gain = gain.total() == 1;
+    const float g0 = gain.at<float>(0, 0);
+    for (int y = 0; y < src.rows; ++y)
+    {
+        const uchar *src_row = src.ptr<uchar>(y);
+        const float *gain_row = single_gain ? 0 : gain.ptr<float>(y);
+        short *dst_row = dst.ptr<short>(y);
+        for (int x = 0; x < src.cols; ++x)
+        {
+            float g = single_gain ? g0 : gain_row[x];
+            for (int c = 0; c < cn; ++c)
+                dst_row[x*cn + c] = saturate_cast<uchar>(src_row[x*cn + c] * g);
+        }
+    }
+}
+
+} // namespace
+
+
+struct Stitcher::StreamingData
+{
+    std::vector<int> indices;
+    std::vector<Size> full_img_sizes;
+    double compose_scale;
+    bool do_resize;
+
+    std::vector<Point> corners;
+    std::vector<Size> sizes;
+    std::vector<Mat> map1, map2;    // fixed-point remap tables (CV_16SC2 and CV_16UC1)
+    std::vector<Mat> masks;         // warped masks with the seams applied
+    bool has_gains;
+    std::vector<Mat> gains;         // exposure gains, empty, 1x1 or of the warped image size
+
+    // warps the images of a frame set and, if the gains are known, compensates the exposure
+    struct WarpBody : ParallelLoopBody
+    {
+        WarpBody(const StreamingData &_data, const std::vector<Mat> &_imgs, std::vector<Mat> &_warped)
+                : data(_data), imgs(_imgs), warped(_warped) {}
+
+        void operator ()(const Range &r) const
+        {
+            Mat img_resized, img_warped;
+            for (int i = r.start; i < r.end; ++i)
+            {
+                const Mat *img = &imgs[data.indices[i]];
+                CV_Assert(img->size() == data.full_img_sizes[i]);
+
+                if (data.do_resize)
+                {
+                    resize(*img, img_resized, Size(), data.compose_scale, data.compose_scale);
+                    img = &img_resized;
+                }
+
+                if (!data.has_gains)
+                {
+                    remap(*img, warped[i], data.map1[i], data.map2[i], INTER_LINEAR, BORDER_CONSTANT);
+                    continue;
+                }
+
+                remap(*img, img_warped, data.map1[i], data.map2[i], INTER_LINEAR, BORDER_CONSTANT);
+                if (data.gains.empty())
+                    img_warped.convertTo(warped[i], CV_16S);
+                else
+                    applyGains(img_warped, data.gains[i], warped[i]);
+            }
+        }
+
+        const StreamingData &data;
+        const std::vector<Mat> &imgs;
+        std::vector<Mat> &warped;
+
+    private:
+        void operator =(const WarpBody&);
+    };
+};
+
+
 Stitcher Stitcher::createDefault(bool try_use_gpu)
 {
     Stitcher stitcher;
@@ -376,6 +463,207 @@ Stitcher::Status Stitcher::stitch(InputArrayOfArrays images, const std::vector<s
 }
 
 
+Stitcher::Status Stitcher::prepareStreaming()
+{
+    return prepareStreaming(std::vector<UMat>());
+}
+
+
+Stitcher::Status Stitcher::prepareStreaming(InputArrayOfArrays images)
+{
+    CV_Assert(!cameras_.empty() && cameras_.size() == indices_.size());
+
+    std::vector<UMat> imgs;
+    images.getUMatVector(imgs);
+
+    const size_t num_imgs = indices_.size();
+    std::vector<UMat> full_imgs(num_imgs);
+    for (size_t i = 0; i < num_imgs; ++i)
+    {
+        if (imgs.empty())
+            full_imgs[i] = imgs_[i];
+        else
+        {
+            CV_Assert(indices_[i] < (int)imgs.size());
+            full_imgs[i] = imgs[indices_[i]];
+        }
+        CV_Assert(full_imgs[i].size() == full_img_sizes_[i]);
+    }
+
+    LOGLN("Preparing streaming... ");
+#if ENABLE_LOG
+    int64 t = getTickCount();
+#endif
+
+    // Estimate the seams and the exposure compensation at the seam estimation resolution,
+    // the same way as composePanorama does
+    std::vector<Point> corners(num_imgs);
+    std::vector<UMat> masks_warped(num_imgs);
+    std::vector<UMat> images_warped(num_imgs);
+    std::vector<UMat> images_warped_f(num_imgs);
+
+    Ptr<detail::RotationWarper> w = warper_->create(float(warped_image_scale_ * seam_work_aspect_));
+    for (size_t i = 0; i < num_imgs; ++i)
+    {
+        UMat img, mask;
+        resize(full_imgs[i], img, Size(), seam_scale_, seam_scale_);
+
+        Mat_<float> K;
+        cameras_[i].K().convertTo(K, CV_32F);
+        K(0,0) *= (float)seam_work_aspect_;
+        K(0,2) *= (float)seam_work_aspect_;
+        K(1,1) *= (float)seam_work_aspect_;
+        K(1,2) *= (float)seam_work_aspect_;
+
+        corners[i] = w->warp(img, K, cameras_[i].R, INTER_LINEAR, BORDER_CONSTANT, images_warped[i]);
+
+        mask.create(img.size(), CV_8U);
+        mask.setTo(Scalar::all(255));
+        w->warp(mask, K, cameras_[i].R, INTER_NEAREST, BORDER_CONSTANT, masks_warped[i]);
+
+        images_warped[i].convertTo(images_warped_f[i], CV_32F);
+    }
+
+    std::vector<Mat> gains;
+    bool has_gains;
+    {
+        // composeFrame may be applying the compensator of the previous calibration
+        AutoLock lock(exposure_mutex_);
+        exposure_comp_->feed(corners, images_warped, masks_warped);
+        has_gains = exposure_comp_->getMatGains(gains);
+    }
+    seam_finder_->find(images_warped_f, corners, masks_warped);
+
+    images_warped.clear();
+    images_warped_f.clear();
+
+    // Precompute the remap tables and the blending masks at the compositing resolution
+    Ptr<StreamingData> data = makePtr<StreamingData>();
+    data->indices = indices_;
+    data->full_img_sizes = full_img_sizes_;
+    data->compose_scale = 1;
+    if (compose_resol_ > 0)
+        data->compose_scale = std::min(1.0, std::sqrt(compose_resol_ * 1e6 / full_img_sizes_[0].area()));
+    data->do_resize = std::abs(data->compose_scale - 1) > 1e-1;
+
+    double compose_work_aspect = data->compose_scale / work_scale_;
+    w = warper_->create(float(warped_image_scale_ * compose_work_aspect));
+
+    data->has_gains = has_gains;
+    CV_Assert(gains.empty() || gains.size() == num_imgs);
+
+    data->corners.resize(num_imgs);
+    data->sizes.resize(num_imgs);
+    data->map1.resize(num_imgs);
+    data->map2.resize(num_imgs);
+    data->masks.resize(num_imgs);
+    if (!gains.empty())
+        data->gains.resize(num_imgs);
+
+    Mat xmap, ymap, mask, dilated_mask, seam_mask;
+    for (size_t i = 0; i < num_imgs; ++i)
+    {
+        detail::CameraParams camera = cameras_[i];
+        camera.focal *= compose_work_aspect;
+        camera.ppx *= compose_work_aspect;
+        camera.ppy *= compose_work_aspect;
+
+        Size sz = full_img_sizes_[i];
+        if (data->do_resize)
+        {
+            sz.width = cvRound(full_img_sizes_[i].width * data->compose_scale);
+            sz.height = cvRound(full_img_sizes_[i].height * data->compose_scale);
+        }
+
+        Mat K;
+        camera.K().convertTo(K, CV_32F);
+        Rect roi = w->buildMaps(sz, K, camera.R, xmap, ymap);
+        data->corners[i] = roi.tl();
+        data->sizes[i] = xmap.size();
+
+        mask.create(sz, CV_8U);
+        mask.setTo(Scalar::all(255));
+        Mat &mask_warped = data->masks[i];
+        remap(mask, mask_warped, xmap, ymap, INTER_NEAREST, BORDER_CONSTANT);
+
+        dilate(masks_warped[i], dilated_mask, Mat());
+        resize(dilated_mask, seam_mask, mask_warped.size());
+        bitwise_and(seam_mask, mask_warped, mask_warped);
+
+        convertMaps(xmap, ymap, data->map1[i], data->map2[i], CV_16SC2);
+
+        if (!gains.empty())
+        {
+            CV_Assert(gains[i].type() == CV_32F);
+            if (gains[i].total() == 1)
+                data->gains[i] = gains[i];
+            else
+                resize(gains[i], data->gains[i], mask_warped.size(), 0, 0, INTER_LINEAR);
+        }
+    }
+
+    {
+        AutoLock lock(streaming_mutex_);
+        streaming_data_ = data;
+    }
+
+    LOGLN("Preparing streaming, time: " << ((getTickCount() - t) / getTickFrequency()) << " sec");
+    return OK;
+}
+
+
+Stitcher::Status Stitcher::composeFrame(InputArrayOfArrays images, OutputArray pano)
+{
+    Ptr<StreamingData> data;
+    {
+        AutoLock lock(streaming_mutex_);
+        data = streaming_data_;
+    }
+    if (!data)
+    {
+        Status status = prepareStreaming(images);
+        if (status != OK)
+            return status;
+        AutoLock lock(streaming_mutex_);
+        data = streaming_data_;
+    }
+
+    std::vector<Mat> imgs;
+    images.getMatVector(imgs);
+    const int num_imgs = static_cast<int>(data->indices.size());
+    for (int i = 0; i < num_imgs; ++i)
+        CV_Assert(data->indices[i] < (int)imgs.size());
+
+    // Warp all the images at once, the blender is fed sequentially
+    std::vector<Mat> images_warped(num_imgs);
+    parallel_for_(Range(0, num_imgs), StreamingData::WarpBody(*data, imgs, images_warped));
+
+    // The compensator can't give its gains, so it's used directly
+    if (!data->has_gains)
+    {
+        AutoLock lock(exposure_mutex_);
+        for (int i = 0; i < num_imgs; ++i)
+        {
+            exposure_comp_->apply(i, data->corners[i], images_warped[i], data->masks[i]);
+            images_warped[i].convertTo(images_warped[i], CV_16S);
+        }
+    }
+
+    blender_->prepare(data->corners, data->sizes);
+    for (int i = 0; i < num_imgs; ++i)
+        blender_->feed(images_warped[i], data->masks[i], data->corners[i]);
+
+    UMat result, result_mask;
+    blender_->blend(result, result_mask);
+
+    // Preliminary result is in CV_16SC3 format, but all values are in [0,255] range,
+    // so convert it to avoid user confusing
+    result.convertTo(pano, CV_8U);
+
+    return OK;
+}
+
+
 Stitcher::Status Stitcher::matchImages()
 {
     if ((int)imgs_.size() < 2)
@@ -42,10 +42,65 @@
 
 #include "precomp.hpp"
 #include "opencl_kernels_stitching.hpp"
+#include "opencv2/hal/intrin.hpp"
 
 namespace cv {
 namespace detail {
 
+namespace {
+
+// Maps a row of points (x_, y_, z_) back to the source image: x = (k_rinv * p).x / (k_rinv * p).z
+// and the same for y. Here x_ = s * xs[j], z_ = s * zs[j] (or z0 when zs is null) and y_ is
+// constant along the row. If check_z is set, points behind the camera are mapped to (-1, -1).
+void mapBackwardRow(const float *k_rinv, const float *xs, const float *zs, float s, float y_, float z0,
+                    bool check_z, int n, float *x, float *y)
+{
+    int j = 0;
+#if CV_SIMD128
+    v_float32x4 k0 = v_setall_f32(k_rinv[0]), k2 = v_setall_f32(k_rinv[2]);
+    v_float32x4 k3 = v_setall_f32(k_rinv[3]), k5 = v_setall_f32(k_rinv[5]);
+    v_float32x4 k6 = v_setall_f32(k_rinv[6]), k8 = v_setall_f32(k_rinv[8]);
+    v_float32x4 ky1 = v_setall_f32(k_rinv[1] * y_), ky4 = v_setall_f32(k_rinv[4] * y_);
+    v_float32x4 ky7 = v_setall_f32(k_rinv[7] * y_);
+    v_float32x4 vs = v_setall_f32(s), vz0 = v_setall_f32(z0);
+    v_float32x4 zero = v_setzero_f32(), minus_one = v_setall_f32(-1.f);
+    for (; j <= n - 4; j += 4)
+    {
+        v_float32x4 x_ = vs * v_load(xs + j);
+        v_float32x4 z_ = zs ? vs * v_load(zs + j) : vz0;
+
+        v_float32x4 vx = k0 * x_ + ky1 + k2 * z_;
+        v_float32x4 vy = k3 * x_ + ky4 + k5 * z_;
+        v_float32x4 vz = k6 * x_ + ky7 + k8 * z_;
+        vx = vx / vz;
+        vy = vy / vz;
+
+        if (check_z)
+        {
+            v_float32x4 mask = vz > zero;
+            vx = v_select(mask, vx, minus_one);
+            vy = v_select(mask, vy, minus_one);
+        }
+        v_store(x + j, vx);
+        v_store(y + j, vy);
+    }
+#endif
+    for (; j < n; ++j)
+    {
+        float x_ = s * xs[j];
+        float z_ = zs ? s * zs[j] : z0;
+
+        float vx = k_rinv[0] * x_ + k_rinv[1] * y_ + k_rinv[2] * z_;
+        float vy = k_rinv[3] * x_ + k_rinv[4] * y_ + k_rinv[5] * z_;
+        float vz = k_rinv[6] * x_ + k_rinv[7] * y_ + k_rinv[8] * z_;
+
+        if (!check_z || vz > 0) { x[j] = vx / vz; y[j] = vy / vz; }
+        else x[j] = y[j] = -1;
+    }
+}
+
+} // namespace
+
 void ProjectorBase::setCameraParams(InputArray _K, InputArray _R, InputArray _T)
 {
     Mat K = _K.getMat(), R = _R.getMat(), T = _T.getMat();
@@ -134,19 +189,26 @@ Rect PlaneWarper::buildMaps(Size src_size, InputArray K, InputArray R, InputArra
     }
 
     Mat xmap = _xmap.getMat(), ymap = _ymap.getMat();
+    mapBackwardRows(dst_tl.x, dst_tl.y, xmap, ymap);
 
-    float x, y;
-    for (int v = dst_tl.y; v <= dst_br.y; ++v)
+    return Rect(dst_tl, dst_br);
+}
+
+void PlaneWarper::mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap)
+{
+    const PlaneProjector &p = projector_;
+
+    AutoBuffer<float> _xs(xmap.cols);
+    float *xs = _xs;
+    for (int j = 0; j < xmap.cols; ++j)
+        xs[j] = static_cast<float>(u0 + j) / p.scale - p.t[0];
+
+    for (int i = 0; i < xmap.rows; ++i)
     {
-        for (int u = dst_tl.x; u <= dst_br.x; ++u)
-        {
-            projector_.mapBackward(static_cast<float>(u), static_cast<float>(v), x, y);
-            xmap.at<float>(v - dst_tl.y, u - dst_tl.x) = x;
-            ymap.at<float>(v - dst_tl.y, u - dst_tl.x) = y;
-        }
+        float y_ = static_cast<float>(v0 + i) / p.scale - p.t[1];
+        mapBackwardRow(p.k_rinv, xs, 0, 1.f, y_, 1 - p.t[2], false, xmap.cols,
+                       xmap.ptr<float>(i), ymap.ptr<float>(i));
     }
-
-    return Rect(dst_tl, dst_br);
 }
 
 
@@ -343,6 +405,29 @@ Rect SphericalWarper::buildMaps(Size src_size, InputArray K, InputArray R, Outpu
     return RotationWarperBase<SphericalProjector>::buildMaps(src_size, K, R, xmap, ymap);
 }
 
+void SphericalWarper::mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap)
+{
+    const SphericalProjector &p = projector_;
+
+    AutoBuffer<float> _sincos(xmap.cols * 2);
+    float *sin_u = _sincos, *cos_u = sin_u + xmap.cols;
+    for (int j = 0; j < xmap.cols; ++j)
+    {
+        float u = static_cast<float>(u0 + j) / p.scale;
+        sin_u[j] = sinf(u);
+        cos_u[j] = cosf(u);
+    }
+
+    for (int i = 0; i < xmap.rows; ++i)
+    {
+        float v = static_cast<float>(v0 + i) / p.scale;
+        float sinv = sinf(static_cast<float>(CV_PI) - v);
+        float cosv = cosf(static_cast<float>(CV_PI) - v);
+        mapBackwardRow(p.k_rinv, sin_u, cos_u, sinv, cosv, 0.f, true, xmap.cols,
+                       xmap.ptr<float>(i), ymap.ptr<float>(i));
+    }
+}
+
 Point SphericalWarper::warp(InputArray src, InputArray K, InputArray R, int interp_mode, int border_mode, OutputArray dst)
 {
     UMat uxmap, uymap;
@@ -392,6 +477,27 @@ Rect CylindricalWarper::buildMaps(Size src_size, InputArray K, InputArray R, Out
     return RotationWarperBase<CylindricalProjector>::buildMaps(src_size, K, R, xmap, ymap);
 }
 
+void CylindricalWarper::mapBackwardRows(int u0, int v0, Mat &xmap, Mat &ymap)
+{
+    const CylindricalProjector &p = projector_;
+
+    AutoBuffer<float> _sincos(xmap.cols * 2);
+    float *sin_u = _sincos, *cos_u = sin_u + xmap.cols;
+    for (int j = 0; j < xmap.cols; ++j)
+    {
+        float u = static_cast<float>(u0 + j) / p.scale;
+        sin_u[j] = sinf(u);
+        cos_u[j] = cosf(u);
+    }
+
+    for (int i = 0; i < xmap.rows; ++i)
+    {
+        float y_ = static_cast<float>(v0 + i) / p.scale;
+        mapBackwardRow(p.k_rinv, sin_u, cos_u, 1.f, y_, 0.f, true, xmap.cols,
+                       xmap.ptr<float>(i), ymap.ptr<float>(i));
+    }
+}
+
 Point CylindricalWarper::warp(InputArray src, InputArray K, InputArray R, int interp_mode, int border_mode, OutputArray dst)
 {
     UMat uxmap, uymap;
@@ -76,3 +76,53 @@ TEST(MultiBandBlender, CanBlendTwoImages)
     double psnr = cvtest::PSNR(expected, result);
     EXPECT_GE(psnr, 50);
 }
+
+TEST(MultiBandBlender, tiledBlendMatchesWholePano)
+{
+    RNG rng(0);
+    Mat scene(300, 500, CV_8UC3);
+    rng.fill(scene, RNG::UNIFORM, 0, 256);
+    GaussianBlur(scene, scene, Size(0, 0), 3);
+
+    std::vector<Point> corners;
+    std::vector<Size> sizes;
+    std::vector<Mat> images, masks;
+    Rect rects[] = { Rect(0, 0, 220, 300), Rect(150, 20, 200, 250), Rect(280, 0, 220, 300) };
+    for (int i = 0; i < 3; ++i)
+    {
+        Mat img;
+        scene(rects[i]).convertTo(img, CV_16S, 1, 20 * i);
+        Mat mask(rects[i].size(), CV_8U, Scalar::all(255));
+        circle(mask, Point(mask.cols / 2, mask.rows / 2), 30, Scalar::all(0), -1);
+        corners.push_back(rects[i].tl());
+        sizes.push_back(rects[i].size());
+        images.push_back(img);
+        masks.push_back(mask);
+    }
+
+    int weight_types[] = { CV_32F, CV_16S };
+    for (int w = 0; w < 2; ++w)
+    {
+        detail::MultiBandBlender blender(false, 5, weight_types[w]);
+        detail::MultiBandBlender tiled_blender(false, 5, weight_types[w]);
+        tiled_blender.setTileSize(100);
+
+        Rect dst_roi = detail::resultRoi(corners, sizes);
+        blender.prepare(dst_roi);
+        tiled_blender.prepare(dst_roi);
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            blender.feed(images[i], masks[i], corners[i]);
+            tiled_blender.feed(images[i], masks[i], corners[i]);
+        }
+
+        Mat result, result_mask, tiled_result, tiled_result_mask;
+        blender.blend(result, result_mask);
+        tiled_blender.blend(tiled_result, tiled_result_mask);
+
+        ASSERT_EQ(result.size(), tiled_result.size());
+        ASSERT_EQ(result.type(), tiled_result.type());
+        EXPECT_EQ(0, cvtest::norm(result_mask, tiled_result_mask, NORM_INF));
+        EXPECT_LE(cvtest::norm(result, tiled_result, NORM_INF), 1);
+    }
+}
@@ -0,0 +1,96 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "test_precomp.hpp"
+
+#include "test_precomp.hpp"
+#include "opencv2/stitching/detail/seam_finders.hpp"
+
+using namespace cv;
+using namespace std;
+
+// The overlap is large enough to be solved coarse-to-fine
+TEST(GraphCutSeamFinder, largeOverlapSeamAvoidsObject)
+{
+    RNG rng(0);
+    Mat scene(600, 1200, CV_8UC3);
+    rng.fill(scene, RNG::UNIFORM, 0, 256);
+    GaussianBlur(scene, scene, Size(0, 0), 4);
+
+    Mat img1 = scene(Rect(0, 0, 800, 600)).clone();
+    Mat img2 = scene(Rect(400, 0, 800, 600)).clone();
+    // Object seen by the second camera only, in the middle of the overlap
+    Rect object(150, 200, 100, 200);
+    rectangle(img2, object, Scalar(0, 0, 255), -1);
+
+    vector<UMat> src(2), masks(2);
+    img1.convertTo(src[0], CV_32F);
+    img2.convertTo(src[1], CV_32F);
+    vector<Point> corners;
+    corners.push_back(Point(0, 0));
+    corners.push_back(Point(400, 0));
+    for (int i = 0; i < 2; ++i)
+    {
+        masks[i].create(src[i].size(), CV_8U);
+        masks[i].setTo(Scalar::all(255));
+    }
+
+    int cost_types[] = { detail::GraphCutSeamFinderBase::COST_COLOR, detail::GraphCutSeamFinderBase::COST_COLOR_GRAD };
+    for (int k = 0; k < 2; ++k)
+    {
+        vector<UMat> result_masks(2);
+        masks[0].copyTo(result_masks[0]);
+        masks[1].copyTo(result_masks[1]);
+        detail::GraphCutSeamFinder(cost_types[k]).find(src, corners, result_masks);
+
+        Mat mask1 = result_masks[0].getMat(ACCESS_READ), mask2 = result_masks[1].getMat(ACCESS_READ);
+        Mat overlap1 = mask1(Rect(400, 0, 400, 600)), overlap2 = mask2(Rect(0, 0, 400, 600));
+
+        // Every overlap pixel is taken from exactly one image
+        EXPECT_EQ(0, countNonZero(overlap1 & overlap2));
+        EXPECT_EQ(400 * 600, countNonZero(overlap1 | overlap2));
+
+        // The seam doesn't cut the object
+        Mat object_mask2 = overlap2(object);
+        int taken = countNonZero(object_mask2);
+        EXPECT_TRUE(taken == 0 || taken == object.area()) << taken;
+    }
+}
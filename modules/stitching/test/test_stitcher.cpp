@@ -0,0 +1,115 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "test_precomp.hpp"
+
+#include "test_precomp.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+void makeOverlappingViews(vector<Mat> &views)
+{
+    RNG rng(12345);
+    Mat scene(360, 720, CV_8UC3);
+    rng.fill(scene, RNG::UNIFORM, 0, 256);
+    GaussianBlur(scene, scene, Size(0, 0), 2.0);
+    for (int i = 0; i < 300; ++i)
+    {
+        Point c(rng.uniform(0, scene.cols), rng.uniform(0, scene.rows));
+        Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        if (i % 2)
+            circle(scene, c, rng.uniform(3, 20), color, -1);
+        else
+            rectangle(scene, c, c + Point(rng.uniform(4, 30), rng.uniform(4, 30)), color, -1);
+    }
+
+    views.clear();
+    views.push_back(scene(Rect(0, 0, 440, 360)).clone());
+    views.push_back(scene(Rect(280, 0, 440, 360)).clone());
+}
+
+} // namespace
+
+TEST(Stitcher, composeFrameIsRepeatableAndMatchesComposePanorama)
+{
+    vector<Mat> views;
+    makeOverlappingViews(views);
+
+    Stitcher stitcher = Stitcher::createDefault(false);
+    ASSERT_EQ(Stitcher::OK, stitcher.estimateTransform(views));
+    ASSERT_EQ(Stitcher::OK, stitcher.prepareStreaming());
+
+    Mat pano1, pano2;
+    ASSERT_EQ(Stitcher::OK, stitcher.composeFrame(views, pano1));
+    ASSERT_EQ(Stitcher::OK, stitcher.composeFrame(views, pano2));
+    ASSERT_FALSE(pano1.empty());
+    EXPECT_EQ(0, cvtest::norm(pano1, pano2, NORM_INF));
+
+    // New frames of the same rig reuse the precomputed maps and seams
+    vector<Mat> frames(views.size());
+    for (size_t i = 0; i < views.size(); ++i)
+        frames[i] = views[i] + Scalar::all(10);
+    Mat pano3;
+    ASSERT_EQ(Stitcher::OK, stitcher.composeFrame(frames, pano3));
+    EXPECT_EQ(pano1.size(), pano3.size());
+
+    Mat reference;
+    ASSERT_EQ(Stitcher::OK, stitcher.composePanorama(views, reference));
+    ASSERT_EQ(reference.size(), pano1.size());
+    EXPECT_GE(cvtest::PSNR(reference, pano1), 30);
+}
+
+TEST(Stitcher, composeFrameRejectsWrongFrameCount)
+{
+    vector<Mat> views;
+    makeOverlappingViews(views);
+
+    Stitcher stitcher = Stitcher::createDefault(false);
+    ASSERT_EQ(Stitcher::OK, stitcher.estimateTransform(views));
+    ASSERT_EQ(Stitcher::OK, stitcher.prepareStreaming());
+
+    vector<Mat> frames(1, views[0]);
+    Mat pano;
+    EXPECT_THROW(stitcher.composeFrame(frames, pano), cv::Exception);
+}
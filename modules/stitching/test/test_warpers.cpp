@@ -0,0 +1,113 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "test_precomp.hpp"
+#include "opencv2/stitching/warpers.hpp"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+void makeCamera(Size size, Mat &K, Mat &R)
+{
+    float focal = 300.f;
+    float k_data[9] = { focal, 0, size.width * 0.5f, 0, focal, size.height * 0.5f, 0, 0, 1 };
+    Mat(3, 3, CV_32F, k_data).copyTo(K);
+
+    float a = 0.4f, b = 0.1f;
+    Mat Ry = (Mat_<float>(3, 3) << cosf(a), 0, sinf(a), 0, 1, 0, -sinf(a), 0, cosf(a));
+    Mat Rx = (Mat_<float>(3, 3) << 1, 0, 0, 0, cosf(b), -sinf(b), 0, sinf(b), cosf(b));
+    R = Ry * Rx;
+}
+
+template <class P>
+void checkMaps(const Ptr<WarperCreator> &creator)
+{
+    Size size(320, 240);
+    Mat K, R;
+    makeCamera(size, K, R);
+    const float scale = 300.f;
+    Ptr<detail::RotationWarper> warper = creator->create(scale);
+
+    Mat xmap, ymap;
+    Rect roi = warper->buildMaps(size, K, R, xmap, ymap);
+    ASSERT_FALSE(xmap.empty());
+
+    // Float maps must match the projector applied pixel by pixel
+    P projector;
+    projector.scale = scale;
+    projector.setCameraParams(K, R);
+    double max_err = 0;
+    for (int v = 0; v < xmap.rows; ++v)
+        for (int u = 0; u < xmap.cols; ++u)
+        {
+            float x, y;
+            projector.mapBackward(static_cast<float>(roi.x + u), static_cast<float>(roi.y + v), x, y);
+            max_err = std::max(max_err, (double)std::abs(x - xmap.at<float>(v, u)));
+            max_err = std::max(max_err, (double)std::abs(y - ymap.at<float>(v, u)));
+        }
+    EXPECT_LE(max_err, 1e-3);
+
+    // Fixed-point maps must match the converted float ones
+    Mat map1, map2, ref_map1, ref_map2;
+    Rect fixed_roi = warper->buildFixedPointMaps(size, K, R, map1, map2);
+    EXPECT_EQ(roi, fixed_roi);
+    ASSERT_EQ(CV_16SC2, map1.type());
+    ASSERT_EQ(CV_16UC1, map2.type());
+    convertMaps(xmap, ymap, ref_map1, ref_map2, CV_16SC2);
+    EXPECT_EQ(0, cvtest::norm(map1, ref_map1, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(map2, ref_map2, NORM_INF));
+
+    Mat src(size, CV_8UC3), dst, ref_dst;
+    randu(src, Scalar::all(0), Scalar::all(256));
+    warper->warp(src, K, R, INTER_LINEAR, BORDER_REFLECT, ref_dst);
+    remap(src, dst, map1, map2, INTER_LINEAR, BORDER_REFLECT);
+    ASSERT_EQ(ref_dst.size(), dst.size());
+    EXPECT_LE(cvtest::norm(dst, ref_dst, NORM_INF), 1);
+}
+
+} // namespace
+
+TEST(PlaneWarper, fixedPointMaps) { checkMaps<detail::PlaneProjector>(makePtr<PlaneWarper>()); }
+TEST(SphericalWarper, fixedPointMaps) { checkMaps<detail::SphericalProjector>(makePtr<SphericalWarper>()); }
+TEST(CylindricalWarper, fixedPointMaps) { checkMaps<detail::CylindricalProjector>(makePtr<CylindricalWarper>()); }
+TEST(FisheyeWarper, fixedPointMaps) { checkMaps<detail::FisheyeProjector>(makePtr<FisheyeWarper>()); }